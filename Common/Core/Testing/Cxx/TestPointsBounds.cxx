@@ -0,0 +1,158 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPointsBounds.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks the (threaded) range computation used for point bounds, and that
+// computing or invalidating the bounds leaves the data array, which other
+// objects may share, untouched.
+
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkInformation.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+
+static int CheckBounds(vtkPoints *points, const char *msg)
+{
+  double expected[6] =
+    { VTK_DOUBLE_MAX, VTK_DOUBLE_MIN, VTK_DOUBLE_MAX, VTK_DOUBLE_MIN,
+      VTK_DOUBLE_MAX, VTK_DOUBLE_MIN };
+  double x[3];
+  for (vtkIdType i = 0; i < points->GetNumberOfPoints(); ++i)
+    {
+    points->GetPoint(i, x);
+    for (int j = 0; j < 3; ++j)
+      {
+      if (vtkMath::IsNan(x[j]))
+        {
+        continue;
+        }
+      expected[2*j] = x[j] < expected[2*j] ? x[j] : expected[2*j];
+      expected[2*j+1] = x[j] > expected[2*j+1] ? x[j] : expected[2*j+1];
+      }
+    }
+
+  double *bounds = points->GetBounds();
+  for (int j = 0; j < 6; ++j)
+    {
+    if (bounds[j] != expected[j])
+      {
+      cerr << msg << ": bounds[" << j << "] is " << bounds[j]
+           << ", expected " << expected[j] << endl;
+      return 1;
+      }
+    }
+  return 0;
+}
+
+static int CheckRange(vtkDataArray *array, const char *msg)
+{
+  int numComp = array->GetNumberOfComponents();
+  for (int j = 0; j < numComp; ++j)
+    {
+    double expected[2] = { VTK_DOUBLE_MAX, VTK_DOUBLE_MIN };
+    for (vtkIdType i = 0; i < array->GetNumberOfTuples(); ++i)
+      {
+      double v = array->GetComponent(i, j);
+      expected[0] = v < expected[0] ? v : expected[0];
+      expected[1] = v > expected[1] ? v : expected[1];
+      }
+    double range[2];
+    array->GetRange(range, j);
+    if (range[0] != expected[0] || range[1] != expected[1])
+      {
+      cerr << msg << ": range of component " << j << " is [" << range[0]
+           << ", " << range[1] << "], expected [" << expected[0] << ", "
+           << expected[1] << "]" << endl;
+      return 1;
+      }
+    }
+  return 0;
+}
+
+int TestPointsBounds(int, char *[])
+{
+  const vtkIdType numPts = 100000;
+  int status = 0;
+  vtkMath::RandomSeed(1177);
+
+  vtkNew<vtkPoints> fPoints;
+  vtkNew<vtkPoints> dPoints;
+  dPoints->SetDataTypeToDouble();
+  fPoints->SetNumberOfPoints(numPts);
+  dPoints->SetNumberOfPoints(numPts);
+  for (vtkIdType i = 0; i < numPts; ++i)
+    {
+    double x[3] = { vtkMath::Random(-1.0, 1.0), vtkMath::Random(-2.0, 0.0),
+                    vtkMath::Random(10.0, 20.0) };
+    fPoints->SetPoint(i, x);
+    dPoints->SetPoint(i, x);
+    }
+  status += CheckBounds(fPoints.GetPointer(), "float points");
+  status += CheckBounds(dPoints.GetPointer(), "double points");
+
+  // Modifying the points invalidates their bounds only.
+  unsigned long dataMTime = dPoints->GetData()->GetMTime();
+  unsigned long infoMTime = dPoints->GetData()->GetInformation()->GetMTime();
+  dPoints->SetPoint(numPts / 2, 5.0, -5.0, 50.0);
+  dPoints->Modified();
+  status += CheckBounds(dPoints.GetPointer(), "modified points");
+  if (dPoints->GetData()->GetMTime() != dataMTime ||
+      dPoints->GetData()->GetInformation()->GetMTime() != infoMTime)
+    {
+    cerr << "Bounds computation modified the data array" << endl;
+    status++;
+    }
+
+  // Points sharing the array have their own bounds.
+  vtkNew<vtkPoints> shallow;
+  shallow->ShallowCopy(dPoints.GetPointer());
+  if (dPoints->GetData()->GetMTime() != dataMTime)
+    {
+    cerr << "ShallowCopy modified the shared data array" << endl;
+    status++;
+    }
+  status += CheckBounds(shallow.GetPointer(), "shallow copy");
+
+  vtkNew<vtkPoints> deep;
+  deep->SetDataTypeToDouble();
+  deep->DeepCopy(dPoints.GetPointer());
+  status += CheckBounds(deep.GetPointer(), "deep copy");
+  deep->SetPoint(0, -7.0, 7.0, 0.0);
+  deep->Modified();
+  status += CheckBounds(deep.GetPointer(), "modified deep copy");
+
+  // NaN coordinates are ignored.
+  fPoints->SetPoint(3, vtkMath::Nan(), 100.0, vtkMath::Nan());
+  fPoints->Modified();
+  status += CheckBounds(fPoints.GetPointer(), "points with NaN");
+
+  // Empty points.
+  vtkNew<vtkPoints> empty;
+  status += CheckBounds(empty.GetPointer(), "empty points");
+
+  // One and two component arrays also use the threaded range.
+  vtkNew<vtkFloatArray> scalars;
+  vtkNew<vtkDoubleArray> tcoords;
+  tcoords->SetNumberOfComponents(2);
+  for (vtkIdType i = 0; i < numPts; ++i)
+    {
+    scalars->InsertNextValue(static_cast<float>(vtkMath::Random(-3.0, 3.0)));
+    tcoords->InsertNextTuple2(vtkMath::Random(), vtkMath::Random(1.0, 2.0));
+    }
+  status += CheckRange(scalars.GetPointer(), "float scalars");
+  status += CheckRange(tcoords.GetPointer(), "double tcoords");
+
+  return status == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
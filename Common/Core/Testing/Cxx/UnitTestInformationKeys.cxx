@@ -1,6 +1,8 @@
 #include "vtkInformation.h"
 #include "vtkInformationDoubleKey.h"
 #include "vtkInformationDoubleVectorKey.h"
+#include "vtkInformationIntegerKey.h"
+#include "vtkInformationIterator.h"
 #include "vtkInformationStringKey.h"
 #include "vtkInformationStringVectorKey.h"
 #include "vtkInformationVariantKey.h"
@@ -9,6 +11,8 @@
 #include "vtkStdString.h"
 #include "vtkVariant.h"
 
+#include <vector>
+
 template<typename T, typename V>
 int UnitTestScalarValueKey(vtkInformation* info, T* key, const V& val)
 {
@@ -129,6 +133,107 @@ int UnitTestVectorValueKey(
   return ok_setgetcomp && ok_copyget && ok_length && ok_appendedlength;
 }
 
+// === Storage of many keys ===
+
+static int CountKeys(vtkInformation* info)
+{
+  vtkNew<vtkInformationIterator> it;
+  it->SetInformation(info);
+  int count = 0;
+  for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextItem())
+    {
+    ++count;
+    }
+  return count;
+}
+
+static int CheckKeys(vtkInformation* info,
+                     const std::vector<vtkInformationIntegerKey*>& keys,
+                     int removedModulo, const char* msg)
+{
+  int expected = 0;
+  for (size_t i = 0; i < keys.size(); ++i)
+    {
+    bool removed = removedModulo > 0 && i % removedModulo == 0;
+    if (removed ? info->Has(keys[i]) :
+        (!info->Has(keys[i]) || info->Get(keys[i]) != static_cast<int>(i)))
+      {
+      cerr << msg << ": wrong entry for key " << i << ".\n";
+      return 0;
+      }
+    expected += removed ? 0 : 1;
+    }
+  if (info->GetNumberOfKeys() != expected || CountKeys(info) != expected)
+    {
+    cerr << msg << ": " << info->GetNumberOfKeys() << " keys, "
+         << CountKeys(info) << " iterated, expected " << expected << ".\n";
+    return 0;
+    }
+  return 1;
+}
+
+// Fill an information object past its inline storage, remove and re-add
+// entries and copy it.
+int UnitTestManyKeys()
+{
+  std::vector<vtkInformationIntegerKey*> keys;
+  for (int i = 0; i < 200; ++i)
+    {
+    keys.push_back(new vtkInformationIntegerKey("Many", "vtkTest"));
+    }
+
+  int ok = 1;
+  vtkNew<vtkInformation> info;
+  for (size_t n = 0; n < keys.size(); ++n)
+    {
+    keys[n]->Set(info.GetPointer(), static_cast<int>(n));
+    if (info->GetNumberOfKeys() != static_cast<int>(n + 1))
+      {
+      cerr << "Wrong number of keys after inserting " << n + 1 << ".\n";
+      ok = 0;
+      }
+    }
+  ok &= CheckKeys(info.GetPointer(), keys, 0, "Insert");
+
+  for (size_t i = 0; i < keys.size(); i += 3)
+    {
+    info->Remove(keys[i]);
+    }
+  ok &= CheckKeys(info.GetPointer(), keys, 3, "Remove");
+
+  vtkNew<vtkInformation> copy;
+  copy->Copy(info.GetPointer());
+  ok &= CheckKeys(copy.GetPointer(), keys, 3, "Copy");
+
+  // Removing and adding entries over and over must not grow the table.
+  for (int pass = 0; pass < 100; ++pass)
+    {
+    for (size_t i = 0; i < keys.size(); i += 3)
+      {
+      keys[i]->Set(copy.GetPointer(), static_cast<int>(i));
+      }
+    for (size_t i = 0; i < keys.size(); i += 3)
+      {
+      copy->Remove(keys[i]);
+      }
+    }
+  ok &= CheckKeys(copy.GetPointer(), keys, 3, "Remove + Set");
+
+  for (size_t i = 0; i < keys.size(); i += 3)
+    {
+    keys[i]->Set(info.GetPointer(), static_cast<int>(i));
+    }
+  ok &= CheckKeys(info.GetPointer(), keys, 0, "Set after Remove");
+
+  info->Clear();
+  if (info->GetNumberOfKeys() != 0 || CountKeys(info.GetPointer()) != 0)
+    {
+    cerr << "Clear left keys behind.\n";
+    ok = 0;
+    }
+  return ok;
+}
+
 int UnitTestInformationKeys(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
 {
   int ok = 1;
@@ -161,5 +266,7 @@ int UnitTestInformationKeys(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
     new vtkInformationStringVectorKey("Test", "vtkTest");
   ok &= UnitTestVectorValueKey(info.GetPointer(), tsvkey, tsval);
 
+  ok &= UnitTestManyKeys();
+
   return ! ok;
 }
@@ -29,6 +29,8 @@
 #include "vtkLookupTable.h"
 #include "vtkLongArray.h"
 #include "vtkMath.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkShortArray.h"
 #include "vtkSignedCharArray.h"
 #include "vtkTypedDataArrayIterator.h"
@@ -181,6 +183,107 @@ void vtkCopyTuples1(IT* input, vtkDataArray* output,
     }
 }
 
+//----------------------------------------------------------------------------
+// Threaded per component range of a contiguous array with a small, fixed
+// number of components (e.g. points). Each thread reduces its chunks into a
+// local range; the local ranges are combined in Reduce(). Same NaN handling
+// as vtkDataArrayPrivate::ComputeScalarRange.
+template <class ValueType, int NumComps>
+class vtkParallelScalarRange
+{
+public:
+  struct RangeType
+  {
+    ValueType R[2*NumComps];
+  };
+
+  const ValueType *Data;
+  double *Ranges;
+  vtkSMPThreadLocal<RangeType> TLRange;
+
+  vtkParallelScalarRange(const ValueType *data, double *ranges) :
+    Data(data), Ranges(ranges) {}
+
+  void Initialize()
+  {
+    RangeType &range = this->TLRange.Local();
+    for (int i = 0, j = 0; i < NumComps; ++i, j+=2)
+      {
+      range.R[j] = vtkTypeTraits<ValueType>::Max();
+      range.R[j+1] = vtkTypeTraits<ValueType>::Min();
+      }
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    RangeType &local = this->TLRange.Local();
+    ValueType range[2*NumComps];
+    std::copy(local.R, local.R + 2*NumComps, range);
+    const ValueType *last = this->Data + end*NumComps;
+    for (const ValueType *value = this->Data + begin*NumComps; value != last;
+         value += NumComps)
+      {
+      for (int i = 0, j = 0; i < NumComps; ++i, j+=2)
+        {
+        range[j] = vtkDataArrayPrivate::detail::min(range[j], value[i]);
+        range[j+1] = vtkDataArrayPrivate::detail::max(range[j+1], value[i]);
+        }
+      }
+    std::copy(range, range + 2*NumComps, local.R);
+  }
+
+  void Reduce()
+  {
+    ValueType range[2*NumComps];
+    for (int i = 0, j = 0; i < NumComps; ++i, j+=2)
+      {
+      range[j] = vtkTypeTraits<ValueType>::Max();
+      range[j+1] = vtkTypeTraits<ValueType>::Min();
+      }
+    typename vtkSMPThreadLocal<RangeType>::iterator itr;
+    for (itr = this->TLRange.begin(); itr != this->TLRange.end(); ++itr)
+      {
+      for (int i = 0, j = 0; i < NumComps; ++i, j+=2)
+        {
+        range[j] = vtkDataArrayPrivate::detail::min(range[j], (*itr).R[j]);
+        range[j+1] =
+          vtkDataArrayPrivate::detail::max(range[j+1], (*itr).R[j+1]);
+        }
+      }
+    for (int i = 0, j = 0; i < NumComps; ++i, j+=2)
+      {
+      this->Ranges[j] = static_cast<double>(range[j]);
+      this->Ranges[j+1] = static_cast<double>(range[j+1]);
+      }
+  }
+};
+
+template <class ValueType, int NumComps>
+bool vtkComputeParallelScalarRange(const ValueType *data, vtkIdType numTuples,
+                                   double *ranges)
+{
+  vtkParallelScalarRange<ValueType,NumComps> range(data, ranges);
+  vtkSMPTools::For(0, numTuples, range);
+  return true;
+}
+
+template <class ValueType>
+bool vtkComputeParallelScalarRange(const ValueType *data, vtkIdType numTuples,
+                                   int numComp, double *ranges)
+{
+  switch (numComp)
+    {
+    case 1:
+      return vtkComputeParallelScalarRange<ValueType,1>(data, numTuples, ranges);
+    case 2:
+      return vtkComputeParallelScalarRange<ValueType,2>(data, numTuples, ranges);
+    case 3:
+      return vtkComputeParallelScalarRange<ValueType,3>(data, numTuples, ranges);
+    default:
+      return false;
+    }
+}
+
 template<typename InfoType, typename KeyType>
 bool hasValidKey(InfoType info, KeyType key,
                    unsigned long mtime, double range[2] )
@@ -1184,6 +1287,28 @@ void vtkDataArray::ComputeRange(double range[2], int comp)
 //----------------------------------------------------------------------------
 bool vtkDataArray::ComputeScalarRange(double* ranges)
 {
+  // Float and double arrays with up to three components (points, scalars,
+  // texture coordinates) stored contiguously are scanned in parallel.
+  int numComp = this->GetNumberOfComponents();
+  vtkIdType numTuples = this->GetNumberOfTuples();
+  if (numTuples > 0 && numComp <= 3 && this->HasStandardMemoryLayout())
+    {
+    if (this->GetDataType() == VTK_FLOAT &&
+        vtkComputeParallelScalarRange(
+          static_cast<const float*>(this->GetVoidPointer(0)),
+          numTuples, numComp, ranges))
+      {
+      return true;
+      }
+    if (this->GetDataType() == VTK_DOUBLE &&
+        vtkComputeParallelScalarRange(
+          static_cast<const double*>(this->GetVoidPointer(0)),
+          numTuples, numComp, ranges))
+      {
+      return true;
+      }
+    }
+
   bool computed = false;
   switch (this->GetDataType())
       {
@@ -25,7 +25,6 @@
 #include "vtkInformationIntegerKey.h"
 #include "vtkInformationIntegerPointerKey.h"
 #include "vtkInformationIntegerVectorKey.h"
-#include "vtkInformationIterator.h"
 #include "vtkInformationKeyVectorKey.h"
 #include "vtkInformationObjectBaseKey.h"
 #include "vtkInformationRequestKey.h"
@@ -35,7 +34,6 @@
 #include "vtkInformationVariantKey.h"
 #include "vtkInformationVariantVectorKey.h"
 #include "vtkObjectFactory.h"
-#include "vtkSmartPointer.h"
 #include "vtkVariant.h"
 
 #include <algorithm>
@@ -79,12 +77,12 @@ void vtkInformation::PrintSelf(ostream& os, vtkIndent indent)
 //----------------------------------------------------------------------------
 void vtkInformation::PrintKeys(ostream& os, vtkIndent indent)
 {
-  typedef vtkInformationInternals::MapType MapType;
-  for(MapType::const_iterator i = this->Internal->Map.begin();
-      i != this->Internal->Map.end(); ++i)
+  vtkInformationInternals* internal = this->Internal;
+  for(int i = internal->First(); i < internal->GetCapacity();
+      i = internal->Next(i))
     {
     // Print the key name first.
-    vtkInformationKey* key = i->first;
+    vtkInformationKey* key = internal->GetKey(i);
     os << indent << key->GetName() << ": ";
 
     // Ask the key to print its value.
@@ -111,20 +109,10 @@ void vtkInformation::Modified(vtkInformationKey* key)
 }
 
 //----------------------------------------------------------------------------
-// Return the number of keys as a result of iteration.
+// Return the number of keys.
 int vtkInformation::GetNumberOfKeys()
 {
-  vtkSmartPointer<vtkInformationIterator> infoIterator =
-    vtkSmartPointer<vtkInformationIterator>::New();
-  infoIterator->SetInformation( this );
-
-  int numberOfKeys = 0;
-  for (infoIterator->InitTraversal(); !infoIterator->IsDoneWithTraversal();
-    infoIterator->GoToNextItem())
-    {
-    numberOfKeys++;
-    }
-  return numberOfKeys;
+  return this->Internal->GetNumberOfEntries();
 }
 
 //----------------------------------------------------------------------------
@@ -135,26 +123,24 @@ void vtkInformation::SetAsObjectBase(vtkInformationKey* key,
     {
     return;
     }
-  typedef vtkInformationInternals::MapType MapType;
-  MapType::iterator i = this->Internal->Map.find(key);
-  if(i != this->Internal->Map.end())
+  vtkObjectBase** value = this->Internal->Find(key);
+  if(value)
     {
-    vtkObjectBase* oldvalue = i->second;
+    vtkObjectBase* oldvalue = *value;
     if(newvalue)
       {
-      i->second = newvalue;
+      *value = newvalue;
       newvalue->Register(0);
       }
     else
       {
-      this->Internal->Map.erase(i);
+      this->Internal->Remove(key);
       }
     oldvalue->UnRegister(0);
     }
   else if(newvalue)
     {
-    MapType::value_type entry(key, newvalue);
-    this->Internal->Map.insert(entry);
+    this->Internal->Insert(key, newvalue);
     newvalue->Register(0);
     }
   this->Modified(key);
@@ -164,31 +150,14 @@ void vtkInformation::SetAsObjectBase(vtkInformationKey* key,
 const vtkObjectBase* vtkInformation::GetAsObjectBase(
   const vtkInformationKey* key) const
 {
-  if(key)
-    {
-    typedef vtkInformationInternals::MapType MapType;
-    MapType::const_iterator i = this->Internal->Map.find(const_cast<vtkInformationKey*>(key));
-    if(i != this->Internal->Map.end())
-      {
-      return i->second;
-      }
-    }
-  return 0;
+  return key ?
+    this->Internal->Get(const_cast<vtkInformationKey*>(key)) : 0;
 }
 
 //----------------------------------------------------------------------------
 vtkObjectBase* vtkInformation::GetAsObjectBase(vtkInformationKey* key)
 {
-  if(key)
-    {
-    typedef vtkInformationInternals::MapType MapType;
-    MapType::const_iterator i = this->Internal->Map.find(key);
-    if(i != this->Internal->Map.end())
-      {
-      return i->second;
-      }
-    }
-  return 0;
+  return key ? this->Internal->Get(key) : 0;
 }
 
 //----------------------------------------------------------------------------
@@ -204,11 +173,11 @@ void vtkInformation::Copy(vtkInformation* from, int deep)
   this->Internal = new vtkInformationInternals;
   if(from)
     {
-    typedef vtkInformationInternals::MapType MapType;
-    for(MapType::const_iterator i = from->Internal->Map.begin();
-        i != from->Internal->Map.end(); ++i)
+    vtkInformationInternals* fromInternal = from->Internal;
+    for(int i = fromInternal->First(); i < fromInternal->GetCapacity();
+        i = fromInternal->Next(i))
       {
-      this->CopyEntry(from, i->first, deep);
+      this->CopyEntry(from, fromInternal->GetKey(i), deep);
       }
     }
   delete oldInternal;
@@ -906,11 +875,11 @@ void vtkInformation::ReportReferences(vtkGarbageCollector* collector)
 {
   this->Superclass::ReportReferences(collector);
   // Ask each key/value pair to report any references it holds.
-  typedef vtkInformationInternals::MapType MapType;
-  for(MapType::const_iterator i = this->Internal->Map.begin();
-      i != this->Internal->Map.end(); ++i)
+  vtkInformationInternals* internal = this->Internal;
+  for(int i = internal->First(); i < internal->GetCapacity();
+      i = internal->Next(i))
     {
-    i->first->Report(this, collector);
+    internal->GetKey(i)->Report(this, collector);
     }
 }
 
@@ -920,11 +889,9 @@ void vtkInformation::ReportAsObjectBase(vtkInformationKey* key,
 {
   if(key)
     {
-    typedef vtkInformationInternals::MapType MapType;
-    MapType::iterator i = this->Internal->Map.find(key);
-    if(i != this->Internal->Map.end())
+    if(vtkObjectBase** value = this->Internal->Find(key))
       {
-      vtkGarbageCollectorReport(collector, i->second, key->GetName());
+      vtkGarbageCollectorReport(collector, *value, key->GetName());
       }
     }
 }
@@ -17,6 +17,12 @@
 // vtkInformationInternals is used in internal implementation of
 // vtkInformation. This should only be accessed by friends
 // and sub-classes of that class.
+//
+// Entries are kept in an open addressing table with linear probing. Most
+// information objects only hold a handful of keys, so the first table is
+// stored inline and no allocation is needed until it fills up. Removing an
+// entry only clears its value, so slots never move while the table is
+// traversed; cleared slots are dropped the next time the table grows.
 
 #ifndef vtkInformationInternals_h
 #define vtkInformationInternals_h
@@ -24,50 +30,224 @@
 #include "vtkInformationKey.h"
 #include "vtkObjectBase.h"
 
-#define VTK_INFORMATION_USE_HASH_MAP
-#ifdef VTK_INFORMATION_USE_HASH_MAP
-# include <vtksys/hash_map.hxx>
-#else
-# include <map>
-#endif
-
 //----------------------------------------------------------------------------
 class vtkInformationInternals
 {
 public:
   typedef vtkInformationKey* KeyType;
   typedef vtkObjectBase* DataType;
-#ifdef VTK_INFORMATION_USE_HASH_MAP
-  struct HashFun
+
+  // A slot is empty when its Key is null, and holds a removed entry when
+  // its Key is set but its Value is null.
+  struct Slot
   {
-    size_t operator()(KeyType key) const
-      {
-      return static_cast<size_t>(key - KeyType(0));
-      }
+    KeyType Key;
+    DataType Value;
   };
-  typedef vtksys::hash_map<KeyType, DataType, HashFun> MapType;
-#else
-  typedef std::map<KeyType, DataType> MapType;
-#endif
-  MapType Map;
 
-#ifdef VTK_INFORMATION_USE_HASH_MAP
-  vtkInformationInternals(): Map(33) {}
-#endif
+  enum { InlineCapacity = 16 };
+
+  vtkInformationInternals()
+    {
+    this->Slots = this->InlineSlots;
+    this->Capacity = InlineCapacity;
+    this->Size = 0;
+    this->Used = 0;
+    this->ClearSlots(this->Slots, this->Capacity);
+    }
 
   ~vtkInformationInternals()
     {
-    for(MapType::iterator i = this->Map.begin(); i != this->Map.end(); ++i)
+    for(int i = 0; i < this->Capacity; ++i)
       {
-      if(vtkObjectBase* value = i->second)
+      if(vtkObjectBase* value = this->Slots[i].Value)
         {
         value->UnRegister(0);
         }
       }
+    if(this->Slots != this->InlineSlots)
+      {
+      delete [] this->Slots;
+      }
     }
-};
 
-#undef VTK_INFORMATION_USE_HASH_MAP
+  // Description:
+  // Return the value stored for key, or null.
+  DataType Get(KeyType key) const
+    {
+    int i = this->FindSlot(key);
+    return i < 0 ? 0 : this->Slots[i].Value;
+    }
+
+  // Description:
+  // Return the address of the value stored for key, or null if there is
+  // none. The address is valid until the next call to Insert().
+  DataType* Find(KeyType key)
+    {
+    int i = this->FindSlot(key);
+    return (i < 0 || !this->Slots[i].Value) ? 0 : &this->Slots[i].Value;
+    }
+
+  // Description:
+  // Store value for key, which must not have a value yet. Reference
+  // counting is left to the caller.
+  void Insert(KeyType key, DataType value)
+    {
+    if((this->Used + 1) * 4 > this->Capacity * 3)
+      {
+      this->Rehash();
+      }
+    int mask = this->Capacity - 1;
+    int removed = -1;
+    int i = Hash(key, mask);
+    for(; this->Slots[i].Key; i = (i + 1) & mask)
+      {
+      if(this->Slots[i].Key == key)
+        {
+        break;
+        }
+      if(removed < 0 && !this->Slots[i].Value)
+        {
+        removed = i;
+        }
+      }
+    if(!this->Slots[i].Key)
+      {
+      if(removed >= 0)
+        {
+        i = removed;
+        }
+      else
+        {
+        ++this->Used;
+        }
+      }
+    this->Slots[i].Key = key;
+    this->Slots[i].Value = value;
+    ++this->Size;
+    }
+
+  // Description:
+  // Forget the value stored for key. Reference counting is left to the
+  // caller.
+  void Remove(KeyType key)
+    {
+    int i = this->FindSlot(key);
+    if(i >= 0 && this->Slots[i].Value)
+      {
+      this->Slots[i].Value = 0;
+      --this->Size;
+      }
+    }
+
+  // Description:
+  // Traversal over the stored entries: start with First(), and stop when
+  // the slot index reaches GetCapacity().
+  int First() const
+    {
+    return this->Next(-1);
+    }
+  int Next(int i) const
+    {
+    for(++i; i < this->Capacity && !this->Slots[i].Value; ++i)
+      {
+      }
+    return i;
+    }
+  int GetCapacity() const
+    {
+    return this->Capacity;
+    }
+  KeyType GetKey(int i) const
+    {
+    return this->Slots[i].Key;
+    }
+  int GetNumberOfEntries() const
+    {
+    return this->Size;
+    }
+
+private:
+  Slot InlineSlots[InlineCapacity];
+  Slot* Slots;
+  int Capacity;
+  int Size;
+  int Used;
+
+  // Index of the first slot to probe for key.
+  static int Hash(KeyType key, int mask)
+    {
+    // Keys are heap allocated objects: drop the alignment bits.
+    size_t h = reinterpret_cast<size_t>(key);
+    return static_cast<int>(((h >> 4) ^ (h >> 12)) & static_cast<size_t>(mask));
+    }
+
+  static void ClearSlots(Slot* slots, int n)
+    {
+    for(int i = 0; i < n; ++i)
+      {
+      slots[i].Key = 0;
+      slots[i].Value = 0;
+      }
+    }
+
+  int FindSlot(KeyType key) const
+    {
+    int mask = this->Capacity - 1;
+    for(int i = Hash(key, mask); this->Slots[i].Key; i = (i + 1) & mask)
+      {
+      if(this->Slots[i].Key == key)
+        {
+        return i;
+        }
+      }
+    return -1;
+    }
+
+  // Rebuild the table without its removed entries, growing it so that it
+  // is at most half full.
+  void Rehash()
+    {
+    int capacity = InlineCapacity;
+    while((this->Size + 1) * 2 > capacity)
+      {
+      capacity *= 2;
+      }
+
+    Slot* oldSlots = this->Slots;
+    int oldCapacity = this->Capacity;
+    Slot inlineCopy[InlineCapacity];
+    if(oldSlots == this->InlineSlots)
+      {
+      for(int i = 0; i < InlineCapacity; ++i)
+        {
+        inlineCopy[i] = this->InlineSlots[i];
+        }
+      oldSlots = inlineCopy;
+      }
+
+    this->Slots = capacity == InlineCapacity ?
+      this->InlineSlots : new Slot[capacity];
+    this->Capacity = capacity;
+    this->Size = 0;
+    this->Used = 0;
+    this->ClearSlots(this->Slots, capacity);
+    for(int i = 0; i < oldCapacity; ++i)
+      {
+      if(oldSlots[i].Value)
+        {
+        this->Insert(oldSlots[i].Key, oldSlots[i].Value);
+        }
+      }
+    if(oldSlots != inlineCopy)
+      {
+      delete [] oldSlots;
+      }
+    }
+
+  vtkInformationInternals(const vtkInformationInternals&);  // Not implemented.
+  void operator=(const vtkInformationInternals&);  // Not implemented.
+};
 
 #endif
 // VTK-HeaderTest-Exclude: vtkInformationInternals.h
@@ -24,7 +24,7 @@ vtkStandardNewMacro(vtkInformationIterator);
 class vtkInformationIteratorInternals
 {
 public:
-  vtkInformationInternals::MapType::iterator Iterator;
+  int Slot;
 };
 
 //----------------------------------------------------------------------------
@@ -86,7 +86,7 @@ void vtkInformationIterator::GoToFirstItem()
     vtkErrorMacro("No information has been set.");
     return;
     }
-  this->Internal->Iterator = this->Information->Internal->Map.begin();
+  this->Internal->Slot = this->Information->Internal->First();
 }
 
 //----------------------------------------------------------------------------
@@ -98,7 +98,8 @@ void vtkInformationIterator::GoToNextItem()
     return;
     }
 
-  ++this->Internal->Iterator;
+  this->Internal->Slot =
+    this->Information->Internal->Next(this->Internal->Slot);
 }
 
 //----------------------------------------------------------------------------
@@ -110,7 +111,7 @@ int vtkInformationIterator::IsDoneWithTraversal()
     return 1;
     }
 
-  if(this->Internal->Iterator == this->Information->Internal->Map.end())
+  if(this->Internal->Slot >= this->Information->Internal->GetCapacity())
     {
     return 1;
     }
@@ -125,7 +126,7 @@ vtkInformationKey* vtkInformationIterator::GetCurrentKey()
     return 0;
     }
 
-  return this->Internal->Iterator->first;
+  return this->Information->Internal->GetKey(this->Internal->Slot);
 }
 
 //----------------------------------------------------------------------------
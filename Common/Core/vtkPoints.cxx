@@ -84,6 +84,8 @@ void vtkPoints::ComputeBounds()
 {
   if (this->GetMTime() > this->ComputeTime)
     {
+    // Computed in parallel for float and double points. The range cache of
+    // the data array, which other vtkPoints may share, is left untouched.
     this->Data->ComputeScalarRange(this->Bounds);
     this->ComputeTime.Modified();
     }
@@ -184,6 +186,12 @@ void vtkPoints::DeepCopy(vtkPoints *da)
       }
     this->Data->DeepCopy(da->Data);
     this->Modified();
+    // The points are identical, so are the bounds if they are up to date.
+    if (da->ComputeTime > da->GetMTime())
+      {
+      memcpy(this->Bounds, da->Bounds, 6 * sizeof(double));
+      this->ComputeTime.Modified();
+      }
     }
 }
 
@@ -0,0 +1,117 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestArrayListTemplate.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkArrayListTemplate.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+
+// Check that vtkArrayList pairs the arrays as CopyAllocate() made them,
+// including unnamed arrays that are not attributes, and that it honors
+// nearest neighbor interpolation of attributes.
+int TestArrayListTemplate(int, char *[])
+{
+  const vtkIdType numTuples = 10;
+  vtkNew<vtkPointData> in;
+
+  vtkNew<vtkFloatArray> unnamed;
+  vtkNew<vtkDoubleArray> first;
+  vtkNew<vtkDoubleArray> second;
+  vtkNew<vtkIntArray> scalars;
+  scalars->SetName("Scalars");
+  for (vtkIdType i = 0; i < numTuples; ++i)
+    {
+    unnamed->InsertNextValue(i);
+    first->InsertNextValue(10 * i);
+    second->InsertNextValue(100 * i);
+    scalars->InsertNextValue(1000 * i);
+    }
+  in->AddArray(unnamed.GetPointer());
+  in->AddArray(first.GetPointer());
+  in->AddArray(second.GetPointer());
+  in->SetScalars(scalars.GetPointer());
+
+  vtkNew<vtkPointData> out;
+  out->SetCopyAttribute(vtkDataSetAttributes::SCALARS, 2,
+                        vtkDataSetAttributes::INTERPOLATE);
+  out->InterpolateAllocate(in.GetPointer(), numTuples);
+
+  vtkArrayList arrays;
+  arrays.AddArrays(numTuples, in.GetPointer(), out.GetPointer());
+  if (arrays.GetNumberOfArrays() != 4)
+    {
+    cerr << "Expected 4 pairs of arrays, got "
+         << arrays.GetNumberOfArrays() << endl;
+    return EXIT_FAILURE;
+    }
+
+  // Tuple i of the output is interpolated between tuples i and
+  // (i + 1) % numTuples, closer to the second one.
+  for (vtkIdType i = 0; i < numTuples; ++i)
+    {
+    vtkIdType ids[2] = { i, (i + 1) % numTuples };
+    double weights[2] = { 0.25, 0.75 };
+    arrays.Interpolate(2, ids, weights, i);
+    }
+
+  for (vtkIdType i = 0; i < numTuples; ++i)
+    {
+    vtkIdType j = (i + 1) % numTuples;
+    double value = 0.25 * i + 0.75 * j;
+    for (int k = 0; k < 3; ++k)
+      {
+      vtkDataArray *array = out->GetArray(k);
+      double expected = k == 0 ? value : (k == 1 ? 10 : 100) * value;
+      if (!array || array->GetNumberOfTuples() != numTuples ||
+          array->GetTuple1(i) != expected)
+        {
+        cerr << "Array " << k << " not interpolated at tuple " << i << endl;
+        return EXIT_FAILURE;
+        }
+      }
+    vtkDataArray *outScalars = out->GetScalars();
+    if (!outScalars || outScalars->GetTuple1(i) != 1000 * j)
+      {
+      cerr << "Scalars not copied from the nearest tuple at tuple " << i
+           << endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Copying fills every array too.
+  vtkNew<vtkPointData> copy;
+  copy->CopyAllocate(in.GetPointer(), numTuples);
+  vtkArrayList copyArrays;
+  copyArrays.AddArrays(numTuples, in.GetPointer(), copy.GetPointer());
+  for (vtkIdType i = 0; i < numTuples; ++i)
+    {
+    copyArrays.Copy(numTuples - 1 - i, i);
+    }
+  for (vtkIdType i = 0; i < numTuples; ++i)
+    {
+    for (int k = 0; k < copy->GetNumberOfArrays(); ++k)
+      {
+      if (copy->GetArray(k)->GetTuple1(i) !=
+          in->GetArray(k)->GetTuple1(numTuples - 1 - i))
+        {
+        cerr << "Array " << k << " not copied at tuple " << i << endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -14,10 +14,12 @@
 =========================================================================*/
 #include "vtkCompositeDataIterator.h"
 #include "vtkDataObjectTree.h"
+#include "vtkDataObjectTreeInternals.h"
 #include "vtkDataObjectTreeIterator.h"
 #include "vtkInformation.h"
 #include "vtkMultiBlockDataSet.h"
 #include "vtkNew.h"
+#include "vtkObjectFactory.h"
 #include "vtkSmartPointer.h"
 #include "vtkStdString.h"
 #include "vtkUniformGrid.h"
@@ -112,6 +114,108 @@ bool TestDataObjectTreeIterator()
   return ok;
 }
 
+// Test flat index lookups against a full (non leaf-only) traversal
+// Multiblock dataset giving access to its flat table.
+class vtkFlatTableMultiBlockDataSet : public vtkMultiBlockDataSet
+{
+public:
+  static vtkFlatTableMultiBlockDataSet* New();
+  vtkTypeMacro(vtkFlatTableMultiBlockDataSet, vtkMultiBlockDataSet);
+
+  vtkSmartPointer<vtkDataObjectTreeFlatTable> GetTable()
+    {
+    return this->GetFlatTable();
+    }
+};
+
+vtkStandardNewMacro(vtkFlatTableMultiBlockDataSet);
+
+bool TestDataObjectTreeFlatIndex()
+{
+  bool ok = true;
+  vtkNew<vtkMultiBlockDataSet> data;
+  vtkNew<vtkMultiBlockDataSet> nested;
+  vtkNew<vtkUniformGrid> grid0;
+  vtkNew<vtkUniformGrid> grid1;
+  data->SetNumberOfBlocks(3);
+  data->SetBlock(0, grid0.GetPointer());
+  data->SetBlock(1, nested.GetPointer());
+  nested->SetNumberOfBlocks(3);
+  nested->SetBlock(2, grid1.GetPointer());
+
+  vtkSmartPointer<vtkDataObjectTreeIterator> it;
+  it.TakeReference(data->NewTreeIterator());
+  it->VisitOnlyLeavesOff();
+  it->SkipEmptyNodesOff();
+  unsigned int numNodes = 1;
+  for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextItem())
+    {
+    ++numNodes;
+    if (data->GetDataObjectByFlatIndex(it->GetCurrentFlatIndex()) !=
+        it->GetCurrentDataObject())
+      {
+      cerr << "Wrong object at flat index " << it->GetCurrentFlatIndex() << endl;
+      ok = false;
+      }
+    }
+  if (data->GetNumberOfFlatIndices() != numNodes || numNodes != 7)
+    {
+    cerr << "Expecting 7 flat indices got " << data->GetNumberOfFlatIndices() << endl;
+    ok = false;
+    }
+
+  // Leaf-only traversal over the flat table.
+  it->VisitOnlyLeavesOn();
+  it->SkipEmptyNodesOn();
+  unsigned int expected[2] = {1, 5};
+  unsigned int counter = 0;
+  for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextItem())
+    {
+    if (counter >= 2 || it->GetCurrentFlatIndex() != expected[counter])
+      {
+      cerr << "Unexpected leaf at flat index " << it->GetCurrentFlatIndex() << endl;
+      ok = false;
+      }
+    ++counter;
+    }
+  ok &= counter == 2;
+
+  // Changing a nested block must invalidate the table.
+  nested->SetBlock(0, grid0.GetPointer());
+  if (data->GetDataObjectByFlatIndex(3) != grid0.GetPointer())
+    {
+    cerr << "Flat index lookup not updated after structure change." << endl;
+    ok = false;
+    }
+  counter = 0;
+  for (it->InitTraversal(); !it->IsDoneWithTraversal(); it->GoToNextItem())
+    {
+    ++counter;
+    }
+  ok &= counter == 3;
+
+  // The table is rebuilt when a tree of the hierarchy is modified, and only
+  // then.
+  vtkNew<vtkFlatTableMultiBlockDataSet> tree;
+  tree->SetNumberOfBlocks(2);
+  tree->SetBlock(1, data.GetPointer());
+  vtkSmartPointer<vtkDataObjectTreeFlatTable> table = tree->GetTable();
+  vtkNew<vtkMultiBlockDataSet> other;
+  other->SetNumberOfBlocks(4);
+  if (tree->GetTable() != table)
+    {
+    cerr << "Flat table rebuilt after modifying another tree." << endl;
+    ok = false;
+    }
+  nested->SetNumberOfBlocks(4);
+  if (tree->GetTable() == table || tree->GetNumberOfFlatIndices() != 10)
+    {
+    cerr << "Flat table not rebuilt after modifying a nested tree." << endl;
+    ok = false;
+    }
+  return ok;
+}
+
 bool TestEmptyAMRIterator()
 {
   for(int init=0; init<2; init++)
@@ -196,6 +300,7 @@ int TestCompositeDataSets(int , char *[])
 {
   int errors = 0;
   errors+= !TestDataObjectTreeIterator();
+  errors+= !TestDataObjectTreeFlatIndex();
   errors+= !TestAMRToMultiBlock();
   errors+= !TestEmptyAMRIterator();
   return( errors );
@@ -335,6 +335,33 @@ void TestGraphDeletion(int & errors)
     cerr << "ERROR: Remove edges properties did not work properly." << endl;
     ++errors;
     }
+
+  // v0 -e0-> v1 -e1-> v2 -e2-> v3, v3 -e3-> v0, v1 -e4-> v3
+  VTK_CREATE(vtkMutableDirectedGraph, frozen);
+  for (int i = 0; i < 4; ++i)
+    {
+    frozen->AddVertex();
+    }
+  frozen->AddEdge(0, 1);
+  frozen->AddEdge(1, 2);
+  frozen->AddEdge(2, 3);
+  frozen->AddEdge(3, 0);
+  frozen->AddEdge(1, 3);
+  frozen->Freeze();
+
+  // v1 -e0-> v0
+  VTK_CREATE(vtkIdTypeArray, removeFrozen);
+  removeFrozen->InsertNextValue(2);
+  removeFrozen->InsertNextValue(0);
+  frozen->RemoveVertices(removeFrozen);
+  frozen->Dump();
+  if (frozen->IsFrozen() || frozen->GetNumberOfVertices() != 2 ||
+      frozen->GetNumberOfEdges() != 1 || frozen->GetSourceVertex(0) != 1 ||
+      frozen->GetTargetVertex(0) != 0)
+    {
+    cerr << "ERROR: Remove vertices did not work on a frozen graph." << endl;
+    ++errors;
+    }
 }
 
 int TestGraph(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
@@ -462,6 +489,53 @@ int TestGraph(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
   TestGraphIterators(t, errors);
   cerr << "... done." << endl;
 
+  cerr << "Testing frozen graph structure ..." << endl;
+  VTK_CREATE(vtkOutEdgeIterator, treeEdges);
+  t->GetOutEdges(0, treeEdges);
+  dg->Freeze();
+  ug->Freeze();
+  if (!dg->IsFrozen() || !ug->IsFrozen())
+    {
+    cerr << "ERROR: Graphs should be frozen." << endl;
+    ++errors;
+    }
+  if (t->IsFrozen() || mdgTree->IsFrozen() || mug->IsFrozen() ||
+      dg->IsSameStructure(t) || ug->IsSameStructure(mug))
+    {
+    cerr << "ERROR: Freezing changed the structure of other graphs." << endl;
+    ++errors;
+    }
+  vtkIdType target = 1;
+  while (treeEdges->HasNext() && treeEdges->Next().Target == target)
+    {
+    ++target;
+    }
+  if (target != 4 || treeEdges->HasNext())
+    {
+    cerr << "ERROR: Freezing invalidated the edges of other graphs." << endl;
+    ++errors;
+    }
+  TestGraphIterators(dg, errors);
+  TestGraphIterators(ug, errors);
+  TestGraphIterators(t, errors);
+  if (ug->GetInDegree(1) != 4 || ug->GetOutEdge(1, 0).Target != 0)
+    {
+    cerr << "ERROR: Frozen structure does not match the original." << endl;
+    ++errors;
+    }
+  mug->AddEdge(8, 9);
+  if (mug->GetNumberOfEdges() != 10)
+    {
+    cerr << "ERROR: Cannot modify the copy of a frozen graph." << endl;
+    ++errors;
+    }
+  if (!ug->IsFrozen() || ug->GetNumberOfEdges() != 9)
+    {
+    cerr << "ERROR: Frozen graph changed when modifying its copy." << endl;
+    ++errors;
+    }
+  cerr << "... done." << endl;
+
   cerr << "Testing copy on write ..." << endl;
   if (!t->IsSameStructure(mdgTree))
     {
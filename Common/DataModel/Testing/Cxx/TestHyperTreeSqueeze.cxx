@@ -0,0 +1,198 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestHyperTreeSqueeze.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that squeezing a hyper tree keeps its structure, for trees built
+// depth-first and breadth-first, and that a squeezed tree can still be
+// subdivided.
+
+#include "vtkHyperTree.h"
+#include "vtkHyperTreeCursor.h"
+#include "vtkMath.h"
+#include "vtkSmartPointer.h"
+
+#include <deque>
+#include <vector>
+
+// Subdivide leaves at random, depth-first.
+static void RefineDepthFirst(vtkHyperTree *tree, vtkHyperTreeCursor *cursor,
+                             int level, int maxLevel)
+{
+  if (level == 0 || (level < maxLevel && vtkMath::Random() < 0.4))
+    {
+    tree->SubdivideLeaf(cursor);
+    for (int c = 0; c < cursor->GetNumberOfChildren(); ++c)
+      {
+      cursor->ToChild(c);
+      RefineDepthFirst(tree, cursor, level + 1, maxLevel);
+      cursor->ToParent();
+      }
+    }
+}
+
+// Subdivide leaves at random, level by level.
+static void RefineBreadthFirst(vtkHyperTree *tree, vtkHyperTreeCursor *cursor,
+                               int maxLevel)
+{
+  std::deque<std::vector<int> > paths(1);
+  while (!paths.empty())
+    {
+    std::vector<int> path = paths.front();
+    paths.pop_front();
+    cursor->ToRoot();
+    for (size_t i = 0; i < path.size(); ++i)
+      {
+      cursor->ToChild(path[i]);
+      }
+    if (path.empty() ||
+        (static_cast<int>(path.size()) < maxLevel && vtkMath::Random() < 0.6))
+      {
+      tree->SubdivideLeaf(cursor);
+      for (int c = 0; c < cursor->GetNumberOfChildren(); ++c)
+        {
+        paths.push_back(path);
+        paths.back().push_back(c);
+        }
+      }
+    }
+}
+
+// Record the index and leaf flag of every node in depth-first order, using
+// both the virtual cursor and the non-virtual child lookup of the tree.
+static void Walk(vtkHyperTree *tree, vtkHyperTreeCursor *cursor,
+                 std::vector<vtkIdType> &out, int &status)
+{
+  vtkIdType index = cursor->GetNodeId();
+  out.push_back(cursor->IsLeaf() ? -index - 1 : index);
+  if (cursor->IsLeaf() != tree->IsLeafIndex(index))
+    {
+    cerr << "Leaf flag mismatch at index " << index << endl;
+    ++status;
+    }
+  if (cursor->IsLeaf())
+    {
+    return;
+    }
+  for (int c = 0; c < cursor->GetNumberOfChildren(); ++c)
+    {
+    vtkIdType childIndex = index;
+    bool isLeaf;
+    tree->FindChildParameters(c, childIndex, isLeaf);
+    cursor->ToChild(c);
+    if (cursor->GetNodeId() != childIndex || cursor->IsLeaf() != isLeaf)
+      {
+      cerr << "Child " << c << " of index " << index << " mismatch" << endl;
+      ++status;
+      }
+    Walk(tree, cursor, out, status);
+    cursor->ToParent();
+    if (cursor->GetNodeId() != index)
+      {
+      cerr << "ToParent did not come back to index " << index << endl;
+      ++status;
+      }
+    }
+}
+
+static std::vector<vtkIdType> Walk(vtkHyperTree *tree, int &status)
+{
+  std::vector<vtkIdType> out;
+  vtkHyperTreeCursor *cursor = tree->NewCursor();
+  cursor->ToRoot();
+  Walk(tree, cursor, out, status);
+  cursor->Delete();
+  return out;
+}
+
+static int CheckSqueeze(vtkHyperTree *tree, const char *name)
+{
+  int status = 0;
+  std::vector<vtkIdType> before = Walk(tree, status);
+  vtkIdType numberOfIndex = tree->GetNumberOfIndex();
+  unsigned int memoryBefore = tree->GetActualMemorySize();
+
+  tree->Squeeze();
+  std::vector<vtkIdType> after = Walk(tree, status);
+  if (before != after || tree->GetNumberOfIndex() != numberOfIndex)
+    {
+    cerr << name << ": structure changed by Squeeze" << endl;
+    ++status;
+    }
+  if (tree->GetActualMemorySize() >= memoryBefore)
+    {
+    cerr << name << ": Squeeze did not reduce memory ("
+         << tree->GetActualMemorySize() << " KiB, was " << memoryBefore
+         << " KiB)" << endl;
+    ++status;
+    }
+
+  // Subdividing the last leaf expands the tree again.
+  vtkHyperTreeCursor *cursor = tree->NewCursor();
+  cursor->ToRoot();
+  while (!cursor->IsLeaf())
+    {
+    cursor->ToChild(cursor->GetNumberOfChildren() - 1);
+    }
+  vtkIdType leaf = cursor->GetNodeId();
+  int numChildren = cursor->GetNumberOfChildren();
+  tree->SubdivideLeaf(cursor);
+  cursor->Delete();
+  if (tree->IsLeafIndex(leaf) ||
+      tree->GetFirstChildIndex(leaf) != numberOfIndex ||
+      tree->GetNumberOfIndex() != numberOfIndex + numChildren)
+    {
+    cerr << name << ": bad subdivision after Squeeze" << endl;
+    ++status;
+    }
+  std::vector<vtkIdType> expanded = Walk(tree, status);
+  if (expanded.size() != before.size() + tree->GetNumberOfIndex() -
+      numberOfIndex)
+    {
+    cerr << name << ": wrong number of nodes after subdivision" << endl;
+    ++status;
+    }
+  return status;
+}
+
+int TestHyperTreeSqueeze(int, char *[])
+{
+  int status = 0;
+  vtkMath::RandomSeed(4242);
+
+  vtkSmartPointer<vtkHyperTree> depthFirst;
+  depthFirst.TakeReference(vtkHyperTree::CreateInstance(2, 3));
+  vtkHyperTreeCursor *cursor = depthFirst->NewCursor();
+  cursor->ToRoot();
+  RefineDepthFirst(depthFirst, cursor, 0, 7);
+  cursor->Delete();
+  status += CheckSqueeze(depthFirst, "depth-first octree");
+
+  vtkSmartPointer<vtkHyperTree> breadthFirst;
+  breadthFirst.TakeReference(vtkHyperTree::CreateInstance(3, 2));
+  cursor = breadthFirst->NewCursor();
+  RefineBreadthFirst(breadthFirst, cursor, 5);
+  cursor->Delete();
+  status += CheckSqueeze(breadthFirst, "breadth-first ternary quadtree");
+
+  // A single leaf.
+  vtkSmartPointer<vtkHyperTree> root;
+  root.TakeReference(vtkHyperTree::CreateInstance(2, 2));
+  root->Squeeze();
+  if (!root->IsLeafIndex(0) || root->GetNumberOfIndex() != 1)
+    {
+    cerr << "Squeezed root is not a single leaf" << endl;
+    ++status;
+    }
+
+  return status == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,167 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImplicitFunctionBatch.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the array version of FunctionValue() gives the same values as
+// the per point version.
+
+#include "vtkBox.h"
+#include "vtkCylinder.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkImplicitBoolean.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPlane.h"
+#include "vtkPlanes.h"
+#include "vtkQuadric.h"
+#include "vtkSphere.h"
+#include "vtkTransform.h"
+
+#include <cmath>
+
+static int CompareFunction(vtkImplicitFunction *f, vtkDataArray *points,
+                           vtkDataArray *values, const char *name)
+{
+  f->FunctionValue(points, values);
+  if ( values->GetNumberOfComponents() != 1 ||
+       values->GetNumberOfTuples() != points->GetNumberOfTuples() )
+    {
+    std::cerr << name << ": wrong output size" << std::endl;
+    return 1;
+    }
+
+  // Float output is rounded.
+  double tol = values->GetDataType() == VTK_FLOAT ? 1.0e-5 : 1.0e-12;
+  double x[3];
+  for ( vtkIdType i=0; i < points->GetNumberOfTuples(); i++ )
+    {
+    points->GetTuple(i, x);
+    double expected = f->FunctionValue(x);
+    double value = values->GetComponent(i, 0);
+    if ( fabs(value - expected) > tol*(1.0 + fabs(expected)) )
+      {
+      std::cerr << name << ": point " << i << " expected " << expected
+                << " got " << value << std::endl;
+      return 1;
+      }
+    }
+  return 0;
+}
+
+static int CompareAll(vtkImplicitFunction *f, const char *name,
+                      vtkDataArray *dPoints, vtkDataArray *fPoints)
+{
+  int status = 0;
+  vtkNew<vtkDoubleArray> dValues;
+  vtkNew<vtkFloatArray> fValues;
+  status += CompareFunction(f, dPoints, dValues.GetPointer(), name);
+  status += CompareFunction(f, fPoints, dValues.GetPointer(), name);
+  status += CompareFunction(f, dPoints, fValues.GetPointer(), name);
+  status += CompareFunction(f, fPoints, fValues.GetPointer(), name);
+  return status;
+}
+
+int TestImplicitFunctionBatch(int, char *[])
+{
+  const vtkIdType numPts = 10000;
+  vtkMath::RandomSeed(8775070);
+  vtkNew<vtkDoubleArray> dPoints;
+  dPoints->SetNumberOfComponents(3);
+  dPoints->SetNumberOfTuples(numPts);
+  vtkNew<vtkFloatArray> fPoints;
+  fPoints->SetNumberOfComponents(3);
+  fPoints->SetNumberOfTuples(numPts);
+  for ( vtkIdType i=0; i < numPts; i++ )
+    {
+    for ( int j=0; j < 3; j++ )
+      {
+      // Store values exactly representable as float in both arrays.
+      float v = static_cast<float>(vtkMath::Random(-2.0, 2.0));
+      dPoints->SetComponent(i, j, v);
+      fPoints->SetComponent(i, j, v);
+      }
+    }
+  int status = 0;
+
+  vtkNew<vtkPlane> plane;
+  plane->SetOrigin(0.1, 0.2, 0.3);
+  plane->SetNormal(1.0, 2.0, -1.0);
+  status += CompareAll(plane.GetPointer(), "vtkPlane",
+                       dPoints.GetPointer(), fPoints.GetPointer());
+
+  vtkNew<vtkSphere> sphere;
+  sphere->SetCenter(0.5, 0.0, -0.5);
+  sphere->SetRadius(0.75);
+  status += CompareAll(sphere.GetPointer(), "vtkSphere",
+                       dPoints.GetPointer(), fPoints.GetPointer());
+
+  vtkNew<vtkBox> box;
+  box->SetBounds(-1.0, 0.5, -0.5, 1.0, -1.0, 1.0);
+  status += CompareAll(box.GetPointer(), "vtkBox",
+                       dPoints.GetPointer(), fPoints.GetPointer());
+
+  vtkNew<vtkCylinder> cylinder;
+  cylinder->SetCenter(0.0, 0.5, 0.0);
+  cylinder->SetRadius(0.5);
+  status += CompareAll(cylinder.GetPointer(), "vtkCylinder",
+                       dPoints.GetPointer(), fPoints.GetPointer());
+
+  vtkNew<vtkPlanes> planes;
+  planes->SetBounds(-1.0, 1.0, -1.5, 1.5, -0.5, 0.5);
+  status += CompareAll(planes.GetPointer(), "vtkPlanes",
+                       dPoints.GetPointer(), fPoints.GetPointer());
+
+  // Generic path through the per point virtual call.
+  vtkNew<vtkQuadric> quadric;
+  quadric->SetCoefficients(0.5, 1.0, 0.2, 0.0, 0.1, 0.0, 0.0, 0.2, 0.0, 0.0);
+  status += CompareAll(quadric.GetPointer(), "vtkQuadric",
+                       dPoints.GetPointer(), fPoints.GetPointer());
+
+  // Transformed function.
+  vtkNew<vtkTransform> transform;
+  transform->RotateZ(30.0);
+  transform->Translate(0.2, 0.0, -0.1);
+  transform->Scale(1.0, 2.0, 1.0);
+  sphere->SetTransform(transform.GetPointer());
+  status += CompareAll(sphere.GetPointer(), "transformed vtkSphere",
+                       dPoints.GetPointer(), fPoints.GetPointer());
+
+  // Boolean trees, with a nested boolean and a duplicated function.
+  vtkNew<vtkImplicitBoolean> inner;
+  inner->AddFunction(plane.GetPointer());
+  inner->AddFunction(cylinder.GetPointer());
+  inner->SetOperationTypeToIntersection();
+
+  vtkNew<vtkImplicitBoolean> tree;
+  tree->AddFunction(box.GetPointer());
+  tree->AddFunction(sphere.GetPointer());
+  tree->AddFunction(inner.GetPointer());
+  tree->AddFunction(quadric.GetPointer());
+  tree->AddFunction(box.GetPointer());
+  const char *names[4] =
+    { "union", "intersection", "difference", "union of magnitudes" };
+  for ( int op=vtkImplicitBoolean::VTK_UNION;
+        op <= vtkImplicitBoolean::VTK_UNION_OF_MAGNITUDES; op++ )
+    {
+    tree->SetOperationType(op);
+    status += CompareAll(tree.GetPointer(), names[op],
+                         dPoints.GetPointer(), fPoints.GetPointer());
+    }
+
+  vtkNew<vtkImplicitBoolean> empty;
+  status += CompareAll(empty.GetPointer(), "empty boolean",
+                       dPoints.GetPointer(), fPoints.GetPointer());
+
+  return status == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -15,6 +15,7 @@
 #include "vtkStaticCellLinks.h"
 #include "vtkStaticCellLinksTemplate.h"
 #include "vtkSmartPointer.h"
+#include "vtkCellArray.h"
 #include "vtkImageData.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkPolyData.h"
@@ -195,5 +196,44 @@ int TestStaticCellLinks( int, char *[] )
     return EXIT_FAILURE;
     }
 
+  // Verts and lines come before the polygons
+  vtkSmartPointer<vtkPolyData> mixed =
+    vtkSmartPointer<vtkPolyData>::New();
+  mixed->SetPoints(pdata->GetPoints());
+  mixed->SetPolys(pdata->GetPolys());
+  vtkSmartPointer<vtkCellArray> verts =
+    vtkSmartPointer<vtkCellArray>::New();
+  vtkIdType vert = 5;
+  verts->InsertNextCell(1, &vert);
+  mixed->SetVerts(verts);
+  vtkSmartPointer<vtkCellArray> lines =
+    vtkSmartPointer<vtkCellArray>::New();
+  vtkIdType line[2] = {0, 5};
+  lines->InsertNextCell(2, line);
+  mixed->SetLines(lines);
+
+  slinks.Initialize(); //reuse
+  slinks.BuildLinks(mixed);
+  numCells = slinks.GetNumberOfCells(0);
+  cout << "   Mixed pole: numCells: " << numCells << "\n";
+  if ( numCells != 13 )
+    {
+    return EXIT_FAILURE;
+    }
+  numCells = slinks.GetNumberOfCells(5);
+  cells = slinks.GetCells(5);
+  cout << "   Mixed equator: numCells: " << numCells << "\n";
+  if ( numCells != 8 )
+    {
+    return EXIT_FAILURE;
+    }
+  for (int i=0; i<numCells; ++i)
+    {
+    if ( cells[i] < 0 || cells[i] >= mixed->GetNumberOfCells() )
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
   return EXIT_SUCCESS;
 }
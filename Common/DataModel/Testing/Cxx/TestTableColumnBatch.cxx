@@ -0,0 +1,167 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestTableColumnBatch.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkTableColumnBatchForEach() visits every value of a column
+// once, in order, for raw and converted columns.
+
+#include "vtkDoubleArray.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkStringArray.h"
+#include "vtkTable.h"
+#include "vtkTableColumnBatch.h"
+#include "vtkVariantArray.h"
+
+#include <vector>
+
+class CollectValues
+{
+public:
+  std::vector<double> Values;
+  std::vector<int> Valid;
+  int RawChunks;
+  int ConvertedChunks;
+  int Status;
+
+  CollectValues() : RawChunks(0), ConvertedChunks(0), Status(0) {}
+
+  template <class T>
+  void operator()(const T* values, const unsigned char* valid,
+                  vtkIdType first, vtkIdType count)
+  {
+    if (first != static_cast<vtkIdType>(this->Values.size()))
+      {
+      cerr << "Chunk starts at row " << first << ", expected "
+           << this->Values.size() << endl;
+      ++this->Status;
+      }
+    valid ? ++this->ConvertedChunks : ++this->RawChunks;
+    for (vtkIdType i = 0; i < count; ++i)
+      {
+      this->Values.push_back(static_cast<double>(values[i]));
+      this->Valid.push_back(valid ? valid[i] : 1);
+      }
+  }
+};
+
+static int Check(vtkAbstractArray* column, vtkIdType chunkSize,
+                 const double* expected, const int* valid, vtkIdType n,
+                 bool raw, const char* name)
+{
+  CollectValues collect;
+  vtkTableColumnBatchForEach(column, collect, chunkSize);
+  int status = collect.Status;
+  if (static_cast<vtkIdType>(collect.Values.size()) != n)
+    {
+    cerr << name << ": got " << collect.Values.size() << " values, expected "
+         << n << endl;
+    return status + 1;
+    }
+  for (vtkIdType i = 0; i < n; ++i)
+    {
+    if (collect.Values[i] != expected[i] || collect.Valid[i] != valid[i])
+      {
+      cerr << name << ": row " << i << " is " << collect.Values[i] << " ("
+           << collect.Valid[i] << "), expected " << expected[i] << " ("
+           << valid[i] << ")" << endl;
+      ++status;
+      }
+    }
+  vtkIdType chunks = (n + chunkSize - 1) / chunkSize;
+  if ((raw ? collect.RawChunks : collect.ConvertedChunks) != chunks ||
+      (raw ? collect.ConvertedChunks : collect.RawChunks) != 0)
+    {
+    cerr << name << ": unexpected chunks (" << collect.RawChunks << " raw, "
+         << collect.ConvertedChunks << " converted)" << endl;
+    ++status;
+    }
+  return status;
+}
+
+int TestTableColumnBatch(int, char *[])
+{
+  const vtkIdType n = 10;
+  double expected[n];
+  int allValid[n];
+  int someValid[n];
+
+  vtkNew<vtkTable> table;
+  vtkNew<vtkIntArray> ints;
+  ints->SetName("Int");
+  vtkNew<vtkDoubleArray> doubles;
+  doubles->SetName("Double");
+  vtkNew<vtkStringArray> strings;
+  strings->SetName("String");
+  vtkNew<vtkVariantArray> variants;
+  variants->SetName("Variant");
+  for (vtkIdType i = 0; i < n; ++i)
+    {
+    expected[i] = static_cast<double>(i * 3 - 7);
+    allValid[i] = 1;
+    someValid[i] = (i % 4 != 1);
+    ints->InsertNextValue(static_cast<int>(expected[i]));
+    doubles->InsertNextValue(expected[i]);
+    strings->InsertNextValue(someValid[i] ?
+      vtkVariant(expected[i]).ToString() : vtkStdString("n/a"));
+    variants->InsertNextValue(someValid[i] ?
+      vtkVariant(expected[i]) : vtkVariant());
+    }
+  table->AddColumn(ints.GetPointer());
+  table->AddColumn(doubles.GetPointer());
+  table->AddColumn(strings.GetPointer());
+  table->AddColumn(variants.GetPointer());
+
+  // Null entries are converted to 0.
+  double converted[n];
+  for (vtkIdType i = 0; i < n; ++i)
+    {
+    converted[i] = someValid[i] ? expected[i] : 0.0;
+    }
+
+  int status = 0;
+  for (vtkIdType chunkSize = 1; chunkSize <= n + 1; chunkSize += 3)
+    {
+    status += Check(table->GetColumnByName("Int"), chunkSize,
+                    expected, allValid, n, true, "int");
+    status += Check(table->GetColumnByName("Double"), chunkSize,
+                    expected, allValid, n, true, "double");
+    status += Check(table->GetColumnByName("String"), chunkSize,
+                    converted, someValid, n, false, "string");
+    status += Check(table->GetColumnByName("Variant"), chunkSize,
+                    converted, someValid, n, false, "variant");
+    }
+
+  // Multi-component columns are not split into values.
+  vtkNew<vtkDoubleArray> vectors;
+  vectors->SetNumberOfComponents(3);
+  vectors->SetNumberOfTuples(n);
+  vectors->FillComponent(0, 1.0);
+  vectors->FillComponent(1, 2.0);
+  vectors->FillComponent(2, 3.0);
+  int noneValid[n];
+  double zeros[n];
+  for (vtkIdType i = 0; i < n; ++i)
+    {
+    noneValid[i] = 0;
+    zeros[i] = 0.0;
+    }
+  status += Check(vectors.GetPointer(), 4, zeros, noneValid, n, false,
+                  "vectors");
+
+  // Empty columns are never visited.
+  vtkNew<vtkDoubleArray> empty;
+  status += Check(empty.GetPointer(), 4, zeros, noneValid, 0, true, "empty");
+
+  return status == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -21,13 +21,157 @@
 #include "vtkBoundingBox.h"
 #include "vtkAMRBox.h"
 #include "vtkDoubleArray.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include <algorithm>
 #include <cassert>
-#include <set>
+#include <cmath>
 
 vtkStandardNewMacro(vtkAMRInformation);
 
 #define ReturnFalseIfMacro(b,msg) { if(b) { std::cerr<<msg<<std::endl; return false;}}
 
+//----------------------------------------------------------------------------
+// Spatial index of the boxes of one level, in the index space of the level.
+// The bounding extent of the valid boxes is split into bins of the average
+// box size, and every box is added to the bins it overlaps.
+class vtkAMRInformationLevelIndex
+{
+public:
+  vtkAMRInformationLevelIndex(const vtkAMRBoxList& boxes,
+                              unsigned int offset, unsigned int numBoxes)
+  {
+    int extents[6] = { VTK_INT_MAX, -VTK_INT_MAX,
+                       VTK_INT_MAX, -VTK_INT_MAX,
+                       VTK_INT_MAX, -VTK_INT_MAX};
+    double totalSize[3] = {0, 0, 0};
+    unsigned int numValid = 0;
+    for (unsigned int i=0; i<numBoxes; i++)
+      {
+      const vtkAMRBox& box = boxes[offset + i];
+      if (box.IsInvalid())
+        {
+        continue;
+        }
+      const int* loCorner = box.GetLoCorner();
+      int hiCorner[3];
+      box.GetValidHiCorner(hiCorner);
+      for (int j=0; j<3; j++)
+        {
+        extents[2*j] = std::min(extents[2*j], loCorner[j]);
+        extents[2*j+1] = std::max(extents[2*j+1], hiCorner[j]);
+        totalSize[j] += hiCorner[j] - loCorner[j] + 1;
+        }
+      numValid++;
+      }
+
+    this->TotalNumBins = 0;
+    if (numValid == 0)
+      {
+      return;
+      }
+    for (int j=0; j<3; j++)
+      {
+      this->LoCorner[j] = extents[2*j];
+      this->BinSize[j] = std::max(1, vtkMath::Round(totalSize[j] / numValid));
+      this->NBins[j] = (extents[2*j+1] - extents[2*j]) / this->BinSize[j] + 1;
+      }
+    this->TotalNumBins = static_cast<size_t>(this->NBins[0]) *
+      this->NBins[1] * this->NBins[2];
+    this->Bins.resize(this->TotalNumBins);
+
+    for (unsigned int i=0; i<numBoxes; i++)
+      {
+      const vtkAMRBox& box = boxes[offset + i];
+      if (box.IsInvalid())
+        {
+        continue;
+        }
+      int hiCorner[3];
+      box.GetValidHiCorner(hiCorner);
+      int minBin[3], maxBin[3];
+      this->GetBinRange(box.GetLoCorner(), hiCorner, minBin, maxBin);
+      int bin[3];
+      for (bin[0]=minBin[0]; bin[0]<=maxBin[0]; bin[0]++)
+        {
+        for (bin[1]=minBin[1]; bin[1]<=maxBin[1]; bin[1]++)
+          {
+          for (bin[2]=minBin[2]; bin[2]<=maxBin[2]; bin[2]++)
+            {
+            this->Bins[this->GetBinIndex(bin)].push_back(i);
+            }
+          }
+        }
+      }
+  }
+
+  // Return the ids, within the level, of the boxes in the bins overlapping
+  // the cells from loCorner to hiCorner, sorted and without duplicates.
+  // Safe to call from several threads.
+  void FindBoxes(const int loCorner[3], const int hiCorner[3],
+                 std::vector<unsigned int>& boxes) const
+  {
+    boxes.clear();
+    if (this->TotalNumBins == 0)
+      {
+      return;
+      }
+    for (int j=0; j<3; j++)
+      {
+      if (hiCorner[j] < this->LoCorner[j] ||
+          loCorner[j] >= this->LoCorner[j] + this->NBins[j]*this->BinSize[j])
+        {
+        return;
+        }
+      }
+    int minBin[3], maxBin[3];
+    this->GetBinRange(loCorner, hiCorner, minBin, maxBin);
+    int bin[3];
+    for (bin[0]=minBin[0]; bin[0]<=maxBin[0]; bin[0]++)
+      {
+      for (bin[1]=minBin[1]; bin[1]<=maxBin[1]; bin[1]++)
+        {
+        for (bin[2]=minBin[2]; bin[2]<=maxBin[2]; bin[2]++)
+          {
+          const std::vector<unsigned int>& b = this->Bins[this->GetBinIndex(bin)];
+          boxes.insert(boxes.end(), b.begin(), b.end());
+          }
+        }
+      }
+    std::sort(boxes.begin(), boxes.end());
+    boxes.erase(std::unique(boxes.begin(), boxes.end()), boxes.end());
+  }
+
+private:
+  std::vector<std::vector<unsigned int> > Bins;
+  int NBins[3];
+  int LoCorner[3];
+  // Bin size in "extent coordinates"
+  int BinSize[3];
+  size_t TotalNumBins;
+
+  // Bins overlapping the cells from loCorner to hiCorner, clamped to the
+  // binned extent.
+  void GetBinRange(const int loCorner[3], const int hiCorner[3],
+                   int minBin[3], int maxBin[3]) const
+  {
+    for (int j=0; j<3; j++)
+      {
+      int lo = std::max(loCorner[j] - this->LoCorner[j], 0);
+      int hi = std::max(hiCorner[j] - this->LoCorner[j], 0);
+      minBin[j] = std::min(lo / this->BinSize[j], this->NBins[j] - 1);
+      maxBin[j] = std::min(hi / this->BinSize[j], this->NBins[j] - 1);
+      }
+  }
+
+  size_t GetBinIndex(const int bin[3]) const
+  {
+    return bin[2] + static_cast<size_t>(bin[1])*this->NBins[2] +
+      static_cast<size_t>(bin[0])*this->NBins[2]*this->NBins[1];
+  }
+};
+
+
 namespace
 {
   inline bool Inside(double q[3], double gbounds[6])
@@ -44,92 +188,74 @@ namespace
       }
   }
 
-// Utility class used to store bin properties
-// and contents
-  class DataSetBinner
+  // Index of the cell of the coarser level containing the cell x.
+  inline int Coarsen(int x, int refinementRatio)
   {
-    std::vector<std::vector<unsigned int> > Bins;
-    unsigned int NBins[3];
-    unsigned int LoCorner[3];
-    // Binsize in "extent coordinates"
-    unsigned int BinSize[3];
-    size_t TotalNumBins;
-
-  public:
-
-    // Create a set of bins given:
-    // - number of bins in x, y, z
-    // - lower extent of the binned space
-    // - the size of bins in "extent coordinates"
-    DataSetBinner(unsigned int nbins[3],
-                  unsigned int locorner[3],
-                  unsigned int binsize[3])
-    {
-      memcpy(this->NBins, nbins, 3*sizeof(unsigned int));
-      memcpy(this->LoCorner, locorner, 3*sizeof(unsigned int));
-      memcpy(this->BinSize, binsize, 3*sizeof(unsigned int));
-      this->TotalNumBins = nbins[0]*nbins[1]*nbins[2];
-      this->Bins.resize(this->TotalNumBins);
-      for (size_t i=0; i<this->TotalNumBins; i++)
-        {
-        this->Bins[i].reserve(5);
-        }
-    }
+    return x >= 0 ? x / refinementRatio : -((-x - 1) / refinementRatio) - 1;
+  }
 
-    // Note that this does not check if the bin already
-    // contains the blockId. This works fine for what this
-    // class is used for.
-    void AddToBin(unsigned int binIndex[3], int blockId)
-    {
-      size_t idx = binIndex[2] +
-        binIndex[1]*this->NBins[2] +
-        binIndex[0]*this->NBins[2]*this->NBins[1];
-      std::vector<unsigned int>& bin = this->Bins[idx];
-      bin.push_back(blockId);
-    }
+// Functor finding, in parallel, the parents at level-1 of each box at level.
+// Each box only writes its own list of parents.
+  class ParentFinder
+  {
+    const vtkAMRBoxList& Boxes;
+    const vtkAMRInformationLevelIndex& ParentIndex;
+    unsigned int ParentOffset;
+    unsigned int ChildOffset;
+    int RefinementRatio;
+    std::vector<std::vector<unsigned int> >& Parents;
+    vtkSMPThreadLocal<std::vector<unsigned int> > Candidates;
 
-    const std::vector<unsigned int>& GetBin(unsigned int binIndex[3]) const
+  public:
+    ParentFinder(const vtkAMRBoxList& boxes,
+                 const vtkAMRInformationLevelIndex& parentIndex,
+                 unsigned int parentOffset, unsigned int childOffset,
+                 int refinementRatio,
+                 std::vector<std::vector<unsigned int> >& parents)
+      : Boxes(boxes), ParentIndex(parentIndex), ParentOffset(parentOffset),
+        ChildOffset(childOffset), RefinementRatio(refinementRatio),
+        Parents(parents)
     {
-      size_t idx = binIndex[2] +
-        binIndex[1]*this->NBins[2] +
-        binIndex[0]*this->NBins[2]*this->NBins[1];
-      return this->Bins[idx];
     }
 
-    // Given an input AMR box, return all boxes in the bins that intersect it
-    void GetBoxesInIntersectingBins(const vtkAMRBox& box, std::set<unsigned int>& boxes)
+    void operator()(vtkIdType begin, vtkIdType end)
     {
-      boxes.clear();
-
-      unsigned int minbin[3];
-      unsigned int maxbin[3];
-
-      const int* loCorner = box.GetLoCorner();
-      int hiCorner[3];
-      box.GetValidHiCorner(hiCorner);
-
-      for (int j=0; j<3; j++)
+      std::vector<unsigned int>& candidates = this->Candidates.Local();
+      for (vtkIdType i=begin; i<end; i++)
         {
-        minbin[j] = (loCorner[j] - this->LoCorner[j]) / this->BinSize[j];
-        maxbin[j] = (hiCorner[j] - this->LoCorner[j]) / this->BinSize[j];
-        }
+        const vtkAMRBox& box = this->Boxes[this->ChildOffset + i];
+        if (box.IsInvalid())
+          {
+          continue;
+          }
 
-      unsigned int idx[3];
-      for (idx[0]=minbin[0]; idx[0]<=maxbin[0]; idx[0]++)
-        for (idx[1]=minbin[1]; idx[1]<=maxbin[1]; idx[1]++)
-          for (idx[2]=minbin[2]; idx[2]<=maxbin[2]; idx[2]++)
+        // The parents are among the boxes of the coarser level overlapping
+        // the cells that this box refines.
+        int loCorner[3], hiCorner[3];
+        box.GetValidHiCorner(hiCorner);
+        for (int j=0; j<3; j++)
+          {
+          loCorner[j] = box.GetLoCorner()[j];
+          if (!box.EmptyDimension(j))
             {
-            const std::vector<unsigned int>& bin =
-              this->GetBin(idx);
-            std::vector<unsigned int>::const_iterator iter;
-            for(iter=bin.begin(); iter!=bin.end(); iter++)
-              {
-              boxes.insert(*iter);
-              }
+            loCorner[j] = Coarsen(loCorner[j], this->RefinementRatio);
+            hiCorner[j] = Coarsen(hiCorner[j], this->RefinementRatio);
             }
-    }
-
+          }
+        this->ParentIndex.FindBoxes(loCorner, hiCorner, candidates);
 
+        std::vector<unsigned int>::const_iterator iter;
+        for (iter=candidates.begin(); iter!=candidates.end(); iter++)
+          {
+          vtkAMRBox potentialParent = this->Boxes[this->ParentOffset + *iter];
+          potentialParent.Refine(this->RefinementRatio);
+          if (box.DoesIntersect(potentialParent))
+            {
+            this->Parents[i].push_back(*iter);
+            }
+          }
+        }
+    }
   };
 };
 
@@ -155,6 +281,7 @@ vtkAMRInformation::vtkAMRInformation(): NumBlocks(1,0)
 
 vtkAMRInformation::~vtkAMRInformation()
 {
+  this->ClearParentChildInformation();
 }
 
 void vtkAMRInformation::PrintSelf(ostream& os, vtkIndent indent)
@@ -319,6 +446,7 @@ unsigned int vtkAMRInformation::GetNumberOfDataSets(unsigned int level) const
 
 void vtkAMRInformation::AllocateBoxes(unsigned int n)
 {
+  this->ClearParentChildInformation();
   this->Boxes.clear();
   for(unsigned int i=0; i<n;i++)
     {
@@ -337,6 +465,7 @@ void vtkAMRInformation::SetAMRBox(unsigned int level, unsigned int id, const vtk
 {
   unsigned int index = this->GetIndex(level,id);
   this->Boxes[index] = box;
+  this->ClearParentChildInformation();
   if(this->HasSpacing(level)) //has valid spacing
     {
     this->UpdateBounds(level,id);
@@ -406,6 +535,7 @@ void vtkAMRInformation::SetRefinementRatio(unsigned int level, int refRatio)
     this->Refinement->SetNumberOfTuples(this->GetNumberOfLevels());
     }
   this->Refinement->SetValue(level,refRatio);
+  this->ClearParentChildInformation();
 }
 
 bool vtkAMRInformation::HasRefinementRatio()
@@ -415,6 +545,7 @@ bool vtkAMRInformation::HasRefinementRatio()
 
 void vtkAMRInformation::GenerateRefinementRatio()
 {
+  this->ClearParentChildInformation();
   this->Refinement->SetNumberOfTuples(this->GetNumberOfLevels());
 
   // sanity check
@@ -486,6 +617,36 @@ bool vtkAMRInformation::HasChildrenInformation()
   return !this->AllChildren.empty();
 }
 
+void vtkAMRInformation::ClearParentChildInformation()
+{
+  this->AllChildren.clear();
+  this->AllParents.clear();
+  for(size_t i=0; i<this->LevelIndices.size(); i++)
+    {
+    delete this->LevelIndices[i];
+    }
+  this->LevelIndices.clear();
+}
+
+void vtkAMRInformation::BuildLevelIndices()
+{
+  unsigned int numLevels = this->GetNumberOfLevels();
+  if(this->LevelIndices.size() == numLevels)
+    {
+    return;
+    }
+  for(size_t i=0; i<this->LevelIndices.size(); i++)
+    {
+    delete this->LevelIndices[i];
+    }
+  this->LevelIndices.resize(numLevels);
+  for(unsigned int level=0; level<numLevels; level++)
+    {
+    this->LevelIndices[level] = new vtkAMRInformationLevelIndex(
+      this->Boxes, this->GetIndex(level, 0), this->GetNumberOfDataSets(level));
+    }
+}
+
 
 unsigned int *vtkAMRInformation::GetParents(unsigned int level, unsigned int index, unsigned int& num)
 {
@@ -548,10 +709,18 @@ void vtkAMRInformation::GenerateParentChildInformation()
     {
     this->GenerateRefinementRatio();
     }
-  AllChildren.resize(this->GetNumberOfLevels());
-  AllParents.resize(this->GetNumberOfLevels());
+  this->BuildLevelIndices();
+
+  // The relationships are cleared whenever the boxes or the refinement
+  // ratios change, so existing ones are up to date.
+  if(this->HasChildrenInformation())
+    {
+    return;
+    }
 
   unsigned int numLevels = this->GetNumberOfLevels();
+  AllChildren.resize(numLevels);
+  AllParents.resize(numLevels);
   for(unsigned int i=1; i<numLevels; i++)
     {
     this->CalculateParentChildRelationShip(i, AllChildren[i-1], AllParents[i]);
@@ -642,135 +811,28 @@ void vtkAMRInformation::CalculateParentChildRelationShip(
     return;
     }
 
-  // 1. Find the bounds of all boxes at level n-1
-  // 2. Find the average block size
-  int extents[6] = { VTK_INT_MAX, -VTK_INT_MAX,
-                     VTK_INT_MAX, -VTK_INT_MAX,
-                     VTK_INT_MAX, -VTK_INT_MAX};
-  float totalsize[3] = {0, 0, 0};
-  unsigned int numParentDataSets = this->GetNumberOfDataSets(level - 1);
   int refinementRatio = this->GetRefinementRatio(level - 1);
-  for (unsigned int id=0; id<numParentDataSets; id++)
-    {
-    vtkAMRBox box = this->GetAMRBox(level - 1, id);
-    if (!box.IsInvalid())
-      {
-      box.Refine(refinementRatio);
-      const int* loCorner = box.GetLoCorner();
-      int hiCorner[3];
-      box.GetValidHiCorner(hiCorner);
-      for (int i = 0; i<3; i++)
-        {
-        if (loCorner[i] < extents[2*i])
-          {
-          extents[2*i] = loCorner[i];
-          }
-        if (hiCorner[i] > extents[2*i+1])
-          {
-          extents[2*i+1] = hiCorner[i];
-          }
-        totalsize[i] += (hiCorner[i] - loCorner[i] + 1);
-        }
-      }
-    }
-
-  // Calculate number of bins and binsize. Note that bins
-  // are cell aligned and we use AMRBox indices to represent
-  // them
-  unsigned int nbins[3];
-  unsigned int binsize[3];
-  for (int i=0; i<3; i++)
-    {
-    binsize[i] = vtkMath::Round(totalsize[i] / numParentDataSets);
-    nbins[i] = (extents[2*i+1] - extents[2*i]) / binsize[i] + 1;
-    }
-
-  double origin[3];
-  double spacing[3];
-
-  this->GetOrigin(origin);
-  this->GetSpacing(0,spacing);
-  for (unsigned int i=0; i<level; i++)
-    {
-    for (int j=0; j<3; j++)
-      spacing[j] /= this->GetRefinementRatio(i);
-    }
-
-  unsigned int loExtent[3];
-  loExtent[0] = extents[0];
-  loExtent[1] = extents[2];
-  loExtent[2] = extents[4];
-  DataSetBinner binner(nbins, loExtent, binsize);
-  // for(int i=0; i<3; i++)
-  //   {
-  //   cout<<nbins[i]<<" "<<loExtent[i]<<" "<<binsize[i]<<endl;
-  //   }
-
-  // Bin the blocks
-  for (unsigned int i=0; i<numParentDataSets; i++)
-    {
-    vtkAMRBox box = this->GetAMRBox(level - 1, i);
-    if (!box.IsInvalid())
-      {
-      unsigned int minbin[3];
-      unsigned int maxbin[3];
-
-      box.Refine(refinementRatio);
-
-      const int* loCorner = box.GetLoCorner();
-      int hiCorner[3];
-      box.GetValidHiCorner(hiCorner);
-
-      for (int j=0; j<3; j++)
-        {
-        minbin[j] = (loCorner[j] - extents[2*j]) / binsize[j];
-        maxbin[j] = (hiCorner[j] - extents[2*j]) / binsize[j];
-        }
-
-      unsigned int idx[3];
-      for (idx[0]=minbin[0]; idx[0]<=maxbin[0]; idx[0]++)
-        {
-        for (idx[1]=minbin[1]; idx[1]<=maxbin[1]; idx[1]++)
-          {
-          for (idx[2]=minbin[2]; idx[2]<=maxbin[2]; idx[2]++)
-            {
-            binner.AddToBin(idx, i);
-            }
-          }
-        }
-      }
-    }
-
-  // Write bins for debugging
-  // WriteBins(origin, spacing, extents, binsize, nbins, binner);
 
   // Actually find parent-children relationship
   // between blocks in level and level-1
   children.resize(this->GetNumberOfDataSets(level-1));
   parents.resize(this->GetNumberOfDataSets(level));
 
+  // The parents of the boxes at this level are found in parallel, then
+  // inverted serially into the children lists. Both end up sorted by
+  // increasing index.
   unsigned int numDataSets = this->GetNumberOfDataSets(level);
+  ParentFinder finder(this->Boxes, *this->LevelIndices[level - 1],
+                      this->GetIndex(level - 1, 0),
+                      this->GetIndex(level, 0), refinementRatio, parents);
+  vtkSMPTools::For(0, numDataSets, finder);
+
   for (unsigned int i=0; i<numDataSets; i++)
     {
-    const vtkAMRBox& box = this->GetAMRBox(level, i);
-    if (!box.IsInvalid())
+    std::vector<unsigned int>::const_iterator iter;
+    for (iter=parents[i].begin(); iter!=parents[i].end(); iter++)
       {
-      std::set<unsigned int> boxes;
-      binner.GetBoxesInIntersectingBins(box, boxes);
-      std::set<unsigned int>::iterator iter;
-      for (iter=boxes.begin(); iter!=boxes.end(); iter++)
-        {
-        vtkAMRBox potentialParent = this->GetAMRBox(level - 1, *iter);
-        if (!potentialParent.IsInvalid())
-          {
-          potentialParent.Refine(refinementRatio);
-          if (box.DoesIntersect(potentialParent))
-            {
-            children[*iter].push_back(i);
-            parents[i].push_back(*iter);
-            }
-          }
-        }
+      children[*iter].push_back(i);
       }
     }
 }
@@ -911,6 +973,9 @@ void vtkAMRInformation::DeepCopy(vtkAMRInformation *other)
     this->Spacing->DeepCopy(other->Spacing);
     }
   memcpy(this->Bounds, other->Bounds, sizeof(double)*6);
+  this->ClearParentChildInformation();
+  this->AllChildren = other->AllChildren;
+  this->AllParents = other->AllParents;
 
 }
 
@@ -978,6 +1043,48 @@ bool vtkAMRInformation::FindGrid(double q[3], unsigned int& level, unsigned int&
 
 bool vtkAMRInformation::FindGrid(double q[3], int level, unsigned int& gridId)
 {
+  if(level >= 0 && level < static_cast<int>(this->LevelIndices.size()) &&
+     this->Spacing && this->HasValidOrigin())
+    {
+    // Look for the box among the ones binned around the cell containing q,
+    // or touching it, in increasing order as the linear search below does.
+    // Dimensions without a spacing are not narrowed down.
+    double h[3];
+    this->GetSpacing(level, h);
+    const int maxIndex = VTK_INT_MAX / 4;
+    int loCorner[3], hiCorner[3];
+    for(int j=0; j<3; j++)
+      {
+      if(h[j] > 0)
+        {
+        double x = std::floor((q[j] - this->Origin[j]) / h[j]);
+        int ijk = static_cast<int>(
+          std::max(std::min(x, static_cast<double>(maxIndex)),
+                   static_cast<double>(-maxIndex)));
+        loCorner[j] = ijk - 1;
+        hiCorner[j] = ijk + 1;
+        }
+      else
+        {
+        loCorner[j] = -maxIndex;
+        hiCorner[j] = maxIndex;
+        }
+      }
+    std::vector<unsigned int> boxes;
+    this->LevelIndices[level]->FindBoxes(loCorner, hiCorner, boxes);
+    for(size_t i = 0; i < boxes.size(); i++)
+      {
+      double gbounds[6];
+      this->GetBounds(level, boxes[i], gbounds);
+      if(Inside(q, gbounds))
+        {
+        gridId = boxes[i];
+        return true;
+        }
+      }
+    return false;
+    }
+
   for(unsigned int i = 0; i < this->GetNumberOfDataSets(level); i++ )
     {
     double gbounds[6];
@@ -41,6 +41,7 @@ class vtkUnsignedIntArray;
 class vtkIntArray;
 class vtkDoubleArray;
 class vtkAMRIndexIterator;
+class vtkAMRInformationLevelIndex;
 
 class VTKCOMMONDATAMODEL_EXPORT vtkAMRInformation : public vtkObject
 {
@@ -178,6 +179,10 @@ public:
   //Description:
   // Generate the parent/child relationships - needed to be called
   // before GetParents or GetChildren can be used!
+  // The boxes of each level are binned in a spatial index, which the boxes
+  // of the next level query in parallel. The relationships and the indices
+  // are kept until the boxes or the refinement ratios change, so calling
+  // this again is cheap; DeepCopy() copies the relationships.
   void GenerateParentChildInformation();
 
   // Description:
@@ -192,6 +197,8 @@ public:
 
   // Description:
   //find the grid that contains the point q at the specified level
+  //Once GenerateParentChildInformation() has been called, only the grids
+  //that the spatial index of the level finds near q are tested.
   bool FindGrid(double q[3], int level, unsigned int& gridId);
 
   //Description
@@ -219,6 +226,8 @@ public:
   void UpdateBounds(const int level, const int id);
   void AllocateBoxes(unsigned int n);
   void GenerateBlockLevel();
+  void ClearParentChildInformation();
+  void BuildLevelIndices();
   void CalculateParentChildRelationShip( unsigned int level,
                                         std::vector<std::vector<unsigned int> >& children,
                                         std::vector<std::vector<unsigned int> >& parents );
@@ -244,6 +253,9 @@ public:
   //parent child information
   std::vector<std::vector<std::vector<unsigned int> > > AllChildren;
   std::vector<std::vector<std::vector<unsigned int> > > AllParents;
+
+  //spatial index of the boxes of each level
+  std::vector<vtkAMRInformationLevelIndex*> LevelIndices;
 };
 
 #endif
@@ -21,6 +21,7 @@
 #include "vtkFieldData.h"
 #include "vtkOverlappingAMR.h"
 #include "vtkPointData.h"
+#include "vtkSMPTools.h"
 #include "vtkStructuredData.h"
 #include "vtkUniformGrid.h"
 #include "vtkUnsignedCharArray.h"
@@ -392,65 +393,96 @@ void vtkAMRUtilities::BlankCells(vtkOverlappingAMR* amr)
 }
 
 //------------------------------------------------------------------------------
-void vtkAMRUtilities::BlankGridsAtLevel(vtkOverlappingAMR* amr, int levelIdx,
-                        std::vector<std::vector<unsigned int> >& children,
-                        const std::vector<int>& processMap)
+namespace
 {
-  unsigned int numDataSets = amr->GetNumberOfDataSets(levelIdx);
-  int N;
-
-  for( unsigned int dataSetIdx=0; dataSetIdx<numDataSets; dataSetIdx++)
-    {
-    const vtkAMRBox& box = amr->GetAMRBox(levelIdx, dataSetIdx);
-    vtkUniformGrid* grid = amr->GetDataSet(levelIdx, dataSetIdx);
-    if (grid == NULL )
+// Blanks the refined cells of each grid of a level. Grids are independent:
+// each one gets its own ghost array, so they are processed in parallel.
+class vtkAMRBlankGridsAtLevel
+{
+public:
+  vtkAMRBlankGridsAtLevel(vtkOverlappingAMR* amr, int levelIdx,
+                          std::vector<std::vector<unsigned int> >& children,
+                          const std::vector<int>& processMap)
+    : AMR(amr), LevelIdx(levelIdx), Children(children), ProcessMap(processMap)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkAMRInformation* info = this->AMR->GetAMRInfo();
+    for (vtkIdType dataSetIdx = begin; dataSetIdx < end; dataSetIdx++)
       {
-      continue;
-      }
-    N = grid->GetNumberOfCells();
-
-    vtkUnsignedCharArray *ghosts = vtkUnsignedCharArray::New();
-    ghosts->SetNumberOfTuples(N);
-    ghosts->FillComponent(0, 0);
-    ghosts->SetName(vtkDataSetAttributes::GhostArrayName());
+      unsigned int idx = static_cast<unsigned int>(dataSetIdx);
+      const vtkAMRBox& box = this->AMR->GetAMRBox(this->LevelIdx, idx);
+      vtkUniformGrid* grid = this->AMR->GetDataSet(this->LevelIdx, idx);
+      if (grid == NULL)
+        {
+        continue;
+        }
+      vtkIdType N = grid->GetNumberOfCells();
+      int dims[3];
+      grid->GetDimensions(dims);
 
-    if (children.size() > dataSetIdx)
-      {
-      std::vector<unsigned int>& dsChildren = children[dataSetIdx];
-      std::vector<unsigned int>::iterator iter;
+      vtkUnsignedCharArray *ghosts = vtkUnsignedCharArray::New();
+      ghosts->SetNumberOfTuples(N);
+      ghosts->FillComponent(0, 0);
+      ghosts->SetName(vtkDataSetAttributes::GhostArrayName());
+      unsigned char* ghostPtr = ghosts->GetPointer(0);
 
-      // For each higher res box fill in the cells that
-      // it covers
-      for (iter=dsChildren.begin(); iter!=dsChildren.end(); iter++)
+      if (this->Children.size() > idx)
         {
-        vtkAMRBox ibox;;
-        int childGridIndex  = amr->GetCompositeIndex(levelIdx+1, *iter);
-        if(processMap[childGridIndex]<0)
-          {
-          continue;
-          }
-        if (amr->GetAMRInfo()->GetCoarsenedAMRBox(levelIdx+1, *iter, ibox))
+        std::vector<unsigned int>& dsChildren = this->Children[idx];
+        std::vector<unsigned int>::iterator iter;
+
+        // For each higher res box fill in the cells that
+        // it covers
+        for (iter=dsChildren.begin(); iter!=dsChildren.end(); iter++)
           {
-          ibox.Intersect(box);
-          const int *loCorner=ibox.GetLoCorner();
-          int hi[3];
-          ibox.GetValidHiCorner(hi);
-          for( int iz=loCorner[2]; iz<=hi[2]; iz++ )
+          vtkAMRBox ibox;
+          int childGridIndex  = this->AMR->GetCompositeIndex(this->LevelIdx+1, *iter);
+          if(this->ProcessMap[childGridIndex]<0)
             {
-            for( int iy=loCorner[1]; iy<=hi[1]; iy++ )
+            continue;
+            }
+          if (info->GetCoarsenedAMRBox(this->LevelIdx+1, *iter, ibox))
+            {
+            ibox.Intersect(box);
+            const int *loCorner=ibox.GetLoCorner();
+            int hi[3];
+            ibox.GetValidHiCorner(hi);
+            for( int iz=loCorner[2]; iz<=hi[2]; iz++ )
               {
-              for( int ix=loCorner[0]; ix<=hi[0]; ix++ )
+              for( int iy=loCorner[1]; iy<=hi[1]; iy++ )
                 {
-                vtkIdType id =  vtkAMRBox::GetCellLinearIndex(box,ix, iy, iz, grid->GetDimensions());
-                ghosts->SetValue(id, ghosts->GetValue(id) | vtkDataSetAttributes::REFINEDCELL);
-                } // END for x
-              } // END for y
-            } // END for z
-          }
-        } // Processing all higher boxes for a specific coarse grid
+                for( int ix=loCorner[0]; ix<=hi[0]; ix++ )
+                  {
+                  vtkIdType id = vtkAMRBox::GetCellLinearIndex(box, ix, iy, iz, dims);
+                  ghostPtr[id] |= vtkDataSetAttributes::REFINEDCELL;
+                  } // END for x
+                } // END for y
+              } // END for z
+            }
+          } // Processing all higher boxes for a specific coarse grid
+        }
+
+      grid->GetCellData()->AddArray(ghosts);
+      ghosts->Delete();
       }
+  }
+
+private:
+  vtkOverlappingAMR* AMR;
+  int LevelIdx;
+  std::vector<std::vector<unsigned int> >& Children;
+  const std::vector<int>& ProcessMap;
+};
+}
 
-    grid->GetCellData()->AddArray(ghosts);
-    ghosts->Delete();
-    }
+//------------------------------------------------------------------------------
+void vtkAMRUtilities::BlankGridsAtLevel(vtkOverlappingAMR* amr, int levelIdx,
+                        std::vector<std::vector<unsigned int> >& children,
+                        const std::vector<int>& processMap)
+{
+  vtkAMRBlankGridsAtLevel blanker(amr, levelIdx, children, processMap);
+  vtkSMPTools::For(0, amr->GetNumberOfDataSets(levelIdx), blanker);
 }
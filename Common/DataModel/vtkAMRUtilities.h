@@ -60,7 +60,8 @@ public:
   static bool HasPartiallyOverlappingGhostCells(vtkOverlappingAMR *amr);
 
   // Description:
-  // Blank cells in overlapping AMR
+  // Blank cells in overlapping AMR. The grids of each level are blanked
+  // in parallel.
   static void BlankCells(vtkOverlappingAMR* amr);
 
 protected:
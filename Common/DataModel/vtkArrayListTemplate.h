@@ -0,0 +1,195 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkArrayListTemplate.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkArrayListTemplate - copy and interpolate attribute data from
+// several threads
+//
+// .SECTION Description
+// vtkArrayList pairs the arrays of input attribute data with the arrays
+// that vtkDataSetAttributes::CopyAllocate() or InterpolateAllocate() made
+// for them in output attribute data, and copies or interpolates tuples
+// between them. vtkDataSetAttributes::CopyData() and InterpolatePoint()
+// walk the arrays with an iterator stored in the attributes, so they
+// cannot be called concurrently. The methods of vtkArrayList can, as long
+// as the threads write different output tuples.
+//
+// Numeric arrays are accessed through pointers of their value type. Other
+// arrays are copied with SetTuple() and interpolated with
+// InterpolateTuple(). So are bit arrays and arrays without the standard
+// memory layout. None of these can be written concurrently: algorithms
+// check IsThreadSafe() before using several threads, and work from one
+// thread otherwise.
+//
+// .SECTION See Also
+// vtkDataSetAttributes vtkSMPTools
+
+#ifndef vtkArrayListTemplate_h
+#define vtkArrayListTemplate_h
+
+#include "vtkSystemIncludes.h"
+
+#include <vector>
+
+class vtkAbstractArray;
+class vtkDataSetAttributes;
+class vtkIdList;
+
+// Description:
+// An input array and the output array its tuples go to.
+class vtkArrayListPair
+{
+public:
+  vtkArrayListPair(vtkAbstractArray *in, vtkAbstractArray *out);
+  virtual ~vtkArrayListPair() {}
+
+  virtual void Copy(vtkIdType inId, vtkIdType outId) = 0;
+  virtual void Interpolate(int numWeights, const vtkIdType *ids,
+                           const double *weights, vtkIdType outId) = 0;
+
+  vtkAbstractArray *Input;
+  vtkAbstractArray *Output;
+  int NumberOfComponents;
+
+  // Whether interpolating copies the tuple with the largest weight, as
+  // for attributes set to nearest neighbor interpolation (copy flag 2).
+  bool NearestNeighbor;
+};
+
+// Description:
+// Pair of numeric arrays with values of type T.
+template <class T>
+class vtkArrayListTypedPair : public vtkArrayListPair
+{
+public:
+  vtkArrayListTypedPair(vtkAbstractArray *in, vtkAbstractArray *out);
+
+  virtual void Copy(vtkIdType inId, vtkIdType outId);
+  virtual void Interpolate(int numWeights, const vtkIdType *ids,
+                           const double *weights, vtkIdType outId);
+
+  T *InputValues;
+  T *OutputValues;
+};
+
+// Description:
+// Pair of non numeric arrays, such as string arrays. It can be used from
+// one thread only.
+class vtkArrayListAbstractPair : public vtkArrayListPair
+{
+public:
+  vtkArrayListAbstractPair(vtkAbstractArray *in, vtkAbstractArray *out);
+  virtual ~vtkArrayListAbstractPair();
+
+  virtual void Copy(vtkIdType inId, vtkIdType outId);
+  virtual void Interpolate(int numWeights, const vtkIdType *ids,
+                           const double *weights, vtkIdType outId);
+
+  vtkIdList *Ids;
+};
+
+class vtkArrayList
+{
+public:
+  vtkArrayList() {}
+  ~vtkArrayList();
+
+  // Description:
+  // Pair the arrays of out, allocated by CopyAllocate() or
+  // InterpolateAllocate() from in, with the arrays of in they were made
+  // for, as CopyData() and InterpolatePoint() pair them, and give them
+  // numOutTuples tuples. Attributes set to nearest neighbor interpolation
+  // are interpolated so. Other output arrays, which the caller fills, are
+  // only resized.
+  void AddArrays(vtkIdType numOutTuples, vtkDataSetAttributes *in,
+                 vtkDataSetAttributes *out);
+
+  // Description:
+  // Pair in with out, and give out numOutTuples tuples. Both arrays must
+  // have the same type and number of components.
+  void AddArray(vtkIdType numOutTuples, vtkAbstractArray *in,
+                vtkAbstractArray *out);
+
+  // Description:
+  // Copy tuple inId of every input array to tuple outId of its output
+  // array.
+  void Copy(vtkIdType inId, vtkIdType outId)
+    {
+    for (size_t i = 0; i < this->Pairs.size(); ++i)
+      {
+      this->Pairs[i]->Copy(inId, outId);
+      }
+    }
+
+  // Description:
+  // Set tuple outId of every output array to the weighted sum of the
+  // tuples ids of its input array. Integer values are rounded. Nearest
+  // neighbor pairs copy the tuple with the largest weight (the last one
+  // among equal weights) instead.
+  void Interpolate(int numWeights, const vtkIdType *ids,
+                   const double *weights, vtkIdType outId)
+    {
+    int nearest = -1;
+    for (size_t i = 0; i < this->Pairs.size(); ++i)
+      {
+      vtkArrayListPair *pair = this->Pairs[i];
+      if (pair->NearestNeighbor && numWeights > 0)
+        {
+        if (nearest < 0)
+          {
+          nearest = 0;
+          for (int j = 1; j < numWeights; ++j)
+            {
+            nearest = weights[j] >= weights[nearest] ? j : nearest;
+            }
+          }
+        pair->Copy(ids[nearest], outId);
+        }
+      else
+        {
+        pair->Interpolate(numWeights, ids, weights, outId);
+        }
+      }
+    }
+
+  // Description:
+  // Interpolate at parametric coordinate t along the edge (v0,v1).
+  void InterpolateEdge(vtkIdType v0, vtkIdType v1, double t, vtkIdType outId)
+    {
+    vtkIdType ids[2] = { v0, v1 };
+    double weights[2] = { 1.0 - t, t };
+    this->Interpolate(2, ids, weights, outId);
+    }
+
+  int GetNumberOfArrays()
+    {
+    return static_cast<int>(this->Pairs.size());
+    }
+
+  // Description:
+  // Whether the tuples of array, or of all arrays of attributes, can be
+  // written by several threads at once.
+  static bool IsThreadSafe(vtkAbstractArray *array);
+  static bool IsThreadSafe(vtkDataSetAttributes *attributes);
+
+  std::vector<vtkArrayListPair*> Pairs;
+
+private:
+  vtkArrayList(const vtkArrayList&);  // Not implemented.
+  void operator=(const vtkArrayList&);  // Not implemented.
+};
+
+#include "vtkArrayListTemplate.txx"
+
+#endif
+// VTK-HeaderTest-Exclude: vtkArrayListTemplate.h
@@ -0,0 +1,223 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkArrayListTemplate.txx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkArrayListTemplate.h"
+
+#ifndef vtkArrayListTemplate_txx
+#define vtkArrayListTemplate_txx
+
+#include "vtkAbstractArray.h"
+#include "vtkDataSetAttributes.h"
+#include "vtkFieldData.h"
+#include "vtkIdList.h"
+#include "vtkTypeTraits.h"
+
+#include <algorithm>
+
+//----------------------------------------------------------------------------
+// Store an interpolated value, rounding and clamping it for integer types
+// as vtkDataArray::InterpolateTuple() does.
+template <class T>
+inline void vtkArrayListRound(double val, T *retVal)
+{
+  val = std::max(val, static_cast<double>(vtkTypeTraits<T>::Min()));
+  val = std::min(val, static_cast<double>(vtkTypeTraits<T>::Max()));
+  *retVal = static_cast<T>((val >= 0.0) ? (val + 0.5) : (val - 0.5));
+}
+
+template <>
+inline void vtkArrayListRound(double val, double *retVal)
+{
+  *retVal = val;
+}
+
+template <>
+inline void vtkArrayListRound(double val, float *retVal)
+{
+  *retVal = static_cast<float>(val);
+}
+
+//----------------------------------------------------------------------------
+inline vtkArrayListPair::vtkArrayListPair(vtkAbstractArray *in,
+                                          vtkAbstractArray *out) :
+  Input(in), Output(out), NumberOfComponents(out->GetNumberOfComponents()),
+  NearestNeighbor(false)
+{
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+vtkArrayListTypedPair<T>::vtkArrayListTypedPair(vtkAbstractArray *in,
+                                                vtkAbstractArray *out) :
+  vtkArrayListPair(in, out)
+{
+  this->InputValues = static_cast<T*>(in->GetVoidPointer(0));
+  this->OutputValues = static_cast<T*>(out->GetVoidPointer(0));
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkArrayListTypedPair<T>::Copy(vtkIdType inId, vtkIdType outId)
+{
+  const T *in = this->InputValues + inId * this->NumberOfComponents;
+  T *out = this->OutputValues + outId * this->NumberOfComponents;
+  for (int j = 0; j < this->NumberOfComponents; ++j)
+    {
+    out[j] = in[j];
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkArrayListTypedPair<T>::Interpolate(int numWeights,
+                                           const vtkIdType *ids,
+                                           const double *weights,
+                                           vtkIdType outId)
+{
+  int numComp = this->NumberOfComponents;
+  T *out = this->OutputValues + outId * numComp;
+  for (int j = 0; j < numComp; ++j)
+    {
+    double v = 0.0;
+    for (int i = 0; i < numWeights; ++i)
+      {
+      v += weights[i] *
+        static_cast<double>(this->InputValues[ids[i] * numComp + j]);
+      }
+    vtkArrayListRound(v, out + j);
+    }
+}
+
+//----------------------------------------------------------------------------
+inline vtkArrayListAbstractPair::vtkArrayListAbstractPair(
+  vtkAbstractArray *in, vtkAbstractArray *out) :
+  vtkArrayListPair(in, out)
+{
+  this->Ids = vtkIdList::New();
+}
+
+//----------------------------------------------------------------------------
+inline vtkArrayListAbstractPair::~vtkArrayListAbstractPair()
+{
+  this->Ids->Delete();
+}
+
+//----------------------------------------------------------------------------
+inline void vtkArrayListAbstractPair::Copy(vtkIdType inId, vtkIdType outId)
+{
+  this->Output->SetTuple(outId, inId, this->Input);
+}
+
+//----------------------------------------------------------------------------
+inline void vtkArrayListAbstractPair::Interpolate(int numWeights,
+                                                  const vtkIdType *ids,
+                                                  const double *weights,
+                                                  vtkIdType outId)
+{
+  this->Ids->SetNumberOfIds(numWeights);
+  std::copy(ids, ids + numWeights, this->Ids->GetPointer(0));
+  this->Output->InterpolateTuple(outId, this->Ids, this->Input,
+                                 const_cast<double*>(weights));
+}
+
+//----------------------------------------------------------------------------
+inline vtkArrayList::~vtkArrayList()
+{
+  for (size_t i = 0; i < this->Pairs.size(); ++i)
+    {
+    delete this->Pairs[i];
+    }
+}
+
+//----------------------------------------------------------------------------
+inline void vtkArrayList::AddArray(vtkIdType numOutTuples,
+                                   vtkAbstractArray *in,
+                                   vtkAbstractArray *out)
+{
+  out->SetNumberOfTuples(numOutTuples);
+  vtkArrayListPair *pair = 0;
+  if (vtkArrayList::IsThreadSafe(in) && vtkArrayList::IsThreadSafe(out))
+    {
+    switch (in->GetDataType())
+      {
+      vtkTemplateMacro(pair = new vtkArrayListTypedPair<VTK_TT>(in, out));
+      }
+    }
+  if (!pair)
+    {
+    pair = new vtkArrayListAbstractPair(in, out);
+    }
+  this->Pairs.push_back(pair);
+}
+
+//----------------------------------------------------------------------------
+inline void vtkArrayList::AddArrays(vtkIdType numOutTuples,
+                                    vtkDataSetAttributes *in,
+                                    vtkDataSetAttributes *out)
+{
+  // Pair the arrays through the index mapping recorded by CopyAllocate() or
+  // InterpolateAllocate(), which CopyData() and InterpolatePoint() use too.
+  std::vector<bool> paired(out->GetNumberOfArrays(), false);
+  vtkFieldData::BasicIterator required = out->RequiredArrays;
+  if (out->TargetIndices)
+    {
+    for (int i = required.BeginIndex(); !required.End();
+         i = required.NextIndex())
+      {
+      int target = out->TargetIndices[i];
+      vtkAbstractArray *inArray = in->GetAbstractArray(i);
+      vtkAbstractArray *outArray = out->GetAbstractArray(target);
+      if (!inArray || !outArray || inArray == outArray || paired[target])
+        {
+        continue;
+        }
+      this->AddArray(numOutTuples, inArray, outArray);
+      int attribute = out->IsArrayAnAttribute(target);
+      this->Pairs.back()->NearestNeighbor = attribute >= 0 &&
+        out->CopyAttributeFlags[vtkDataSetAttributes::INTERPOLATE][attribute]
+        == 2;
+      paired[target] = true;
+      }
+    }
+
+  for (int i = 0; i < out->GetNumberOfArrays(); ++i)
+    {
+    if (!paired[i])
+      {
+      out->GetAbstractArray(i)->SetNumberOfTuples(numOutTuples);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+inline bool vtkArrayList::IsThreadSafe(vtkAbstractArray *array)
+{
+  return array->IsNumeric() && array->HasStandardMemoryLayout() &&
+    array->GetDataType() != VTK_BIT;
+}
+
+//----------------------------------------------------------------------------
+inline bool vtkArrayList::IsThreadSafe(vtkDataSetAttributes *attributes)
+{
+  for (int i = 0; i < attributes->GetNumberOfArrays(); ++i)
+    {
+    if (!vtkArrayList::IsThreadSafe(attributes->GetAbstractArray(i)))
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+#endif
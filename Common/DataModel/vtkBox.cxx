@@ -16,6 +16,7 @@
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
 #include "vtkBoundingBox.h"
+#include "vtkImplicitFunctionBatch.h"
 #include <cassert>
 
 vtkStandardNewMacro(vtkBox);
@@ -193,6 +194,32 @@ double vtkBox::EvaluateFunction(double x[3])
     }
 }
 
+//----------------------------------------------------------------------------
+namespace {
+// The box equation only reads the bounding box, so it is safe to evaluate
+// it concurrently. The qualified call avoids the virtual dispatch.
+class vtkBoxEvaluator
+{
+public:
+  vtkBox *Box;
+  double operator()(const double x[3]) const
+    {
+    double pt[3] = {x[0], x[1], x[2]};
+    return this->Box->vtkBox::EvaluateFunction(pt);
+    }
+};
+}
+
+//----------------------------------------------------------------------------
+// Evaluate box equation for all the points of input.
+void vtkBox::EvaluateFunctionBatch(vtkDataArray* input,
+                                   vtkDataArray* output)
+{
+  vtkBoxEvaluator f;
+  f.Box = this;
+  vtkImplicitFunctionBatchEvaluate(f, input, output, true);
+}
+
 //----------------------------------------------------------------------------
 // Evaluate box gradient.
 void vtkBox::EvaluateGradient(double x[3], double n[3])
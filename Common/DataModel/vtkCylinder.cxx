@@ -15,6 +15,7 @@
 #include "vtkCylinder.h"
 #include "vtkObjectFactory.h"
 #include "vtkMath.h"
+#include "vtkImplicitFunctionBatch.h"
 
 vtkStandardNewMacro(vtkCylinder);
 
@@ -48,6 +49,41 @@ double vtkCylinder::EvaluateFunction(double x[3])
   return ( (vtkMath::Dot(x2C,x2C) - proj*proj) - this->Radius*this->Radius );
 }
 
+//----------------------------------------------------------------------------
+namespace {
+class vtkCylinderEvaluator
+{
+public:
+  double Center[3];
+  double Axis[3];
+  double Radius2;
+  double operator()(const double x[3]) const
+    {
+    double x2C[3];
+    x2C[0] = x[0] - this->Center[0];
+    x2C[1] = x[1] - this->Center[1];
+    x2C[2] = x[2] - this->Center[2];
+    double proj = vtkMath::Dot(this->Axis,x2C);
+    return ( (vtkMath::Dot(x2C,x2C) - proj*proj) - this->Radius2 );
+    }
+};
+}
+
+//----------------------------------------------------------------------------
+// Evaluate cylinder equation for all the points of input.
+void vtkCylinder::EvaluateFunctionBatch(vtkDataArray* input,
+                                        vtkDataArray* output)
+{
+  vtkCylinderEvaluator f;
+  for (int i=0; i<3; i++)
+    {
+    f.Center[i] = this->Center[i];
+    f.Axis[i] = this->Axis[i];
+    }
+  f.Radius2 = this->Radius*this->Radius;
+  vtkImplicitFunctionBatchEvaluate(f, input, output, true);
+}
+
 //----------------------------------------------------------------------------
 // Evaluate cylinder function gradient (along potentially oriented axis). The
 // gradient is always in the radial direction, and thus must be projected
@@ -53,6 +53,11 @@ public:
   double EvaluateFunction(double x, double y, double z)
     {return this->vtkImplicitFunction::EvaluateFunction(x, y, z); } ;
 
+  // Description:
+  // Evaluate the function at all the points of input in one multithreaded
+  // pass, see vtkImplicitFunction::FunctionValue(vtkDataArray*, vtkDataArray*).
+  void EvaluateFunctionBatch(vtkDataArray* input, vtkDataArray* output);
+
   // Description
   // Evaluate cylinder function gradient.
   void EvaluateGradient(double x[3], double g[3]);
@@ -551,6 +551,95 @@ void vtkDataObjectTree::Initialize()
   this->Superclass::Initialize();
 }
 
+//----------------------------------------------------------------------------
+// Whether no tree of the hierarchy of table was modified since it was built.
+// The trees are checked in preorder, so a tree removed from its parent is not
+// reached: the parent was modified when it was removed.
+static bool vtkDataObjectTreeIsCurrent(vtkDataObjectTreeFlatTable* table)
+{
+  size_t numTrees = table->Trees.size();
+  for (size_t i = 0; i < numTrees; ++i)
+    {
+    if (table->Trees[i].first->vtkObject::GetMTime() != table->Trees[i].second)
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkDataObjectTreeFlatTable> vtkDataObjectTree::GetFlatTable()
+{
+  this->Internals->FlatTableLock.Lock();
+  vtkSmartPointer<vtkDataObjectTreeFlatTable> table =
+    this->Internals->FlatTable;
+  if (!table || !vtkDataObjectTreeIsCurrent(table))
+    {
+    // Iterators and other readers may still hold the stale table, so build
+    // a new one rather than refilling it.
+    table.TakeReference(vtkDataObjectTreeFlatTable::New());
+    vtkDataObjectTreeFlatTable::Item root = { NULL, 0, 0 };
+    table->Items.push_back(root);
+    this->BuildFlatTable(0, table);
+    this->Internals->FlatTable = table;
+    }
+  this->Internals->FlatTableLock.Unlock();
+  return table;
+}
+
+//----------------------------------------------------------------------------
+void vtkDataObjectTree::BuildFlatTable(unsigned int flatIndex,
+  vtkDataObjectTreeFlatTable* table)
+{
+  table->Trees.push_back(std::make_pair(this, this->vtkObject::GetMTime()));
+  unsigned int numChildren = this->GetNumberOfChildren();
+  for (unsigned int cc = 0; cc < numChildren; cc++)
+    {
+    unsigned int childFlatIndex = static_cast<unsigned int>(table->Items.size());
+    vtkDataObjectTreeFlatTable::Item item = { this, cc, flatIndex };
+    table->Items.push_back(item);
+
+    vtkDataObject* child = this->Internals->Children[cc].DataObject;
+    vtkDataObjectTree* childTree = vtkDataObjectTree::SafeDownCast(child);
+    if (childTree)
+      {
+      childTree->BuildFlatTable(childFlatIndex, table);
+      }
+    else
+      {
+      table->Leaves.push_back(childFlatIndex);
+      if (child)
+        {
+        table->NonEmptyLeaves.push_back(childFlatIndex);
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkDataObject* vtkDataObjectTree::GetDataObjectByFlatIndex(
+  unsigned int flatIndex)
+{
+  if (flatIndex == 0)
+    {
+    return this;
+    }
+  vtkSmartPointer<vtkDataObjectTreeFlatTable> table = this->GetFlatTable();
+  if (flatIndex >= table->Items.size())
+    {
+    return 0;
+    }
+  const vtkDataObjectTreeFlatTable::Item& item = table->Items[flatIndex];
+  return item.Parent->GetChild(item.ChildIndex);
+}
+
+//----------------------------------------------------------------------------
+unsigned int vtkDataObjectTree::GetNumberOfFlatIndices()
+{
+  return static_cast<unsigned int>(this->GetFlatTable()->Items.size());
+}
+
 //----------------------------------------------------------------------------
 vtkIdType vtkDataObjectTree::GetNumberOfPoints()
 {
@@ -32,10 +32,12 @@
 
 #include "vtkCommonDataModelModule.h" // For export macro
 #include "vtkCompositeDataSet.h"
+#include "vtkSmartPointer.h" // For vtkSmartPointer
 
 class vtkCompositeDataIterator;
 class vtkDataObjectTreeIterator;
 class vtkDataObjectTreeInternals;
+class vtkDataObjectTreeFlatTable;
 class vtkInformation;
 class vtkInformationStringKey;
 class vtkDataObject;
@@ -98,6 +100,23 @@ public:
   // using CopyStructure).
   virtual int HasMetaData(vtkCompositeDataIterator* iter);
 
+  // Description:
+  // Returns the data object at the given flat index, i.e. the index assigned
+  // to it by a vtkDataObjectTreeIterator traversing the whole tree in
+  // preorder (see vtkCompositeDataIterator::GetCurrentFlatIndex()). Flat
+  // index 0 is this tree itself. Returns NULL for an empty node or an out of
+  // range index. The lookup uses a flat table of the tree that is built on
+  // first use and rebuilt when this tree or a nested tree is modified, so
+  // it takes time proportional to the number of nested trees rather than to
+  // the number of leaves. The table is built under a lock, so concurrent
+  // readers may call this on a tree that is not being modified.
+  vtkDataObject* GetDataObjectByFlatIndex(unsigned int flatIndex);
+
+  // Description:
+  // Returns the number of flat indices, i.e. the number of nodes in the
+  // tree including this tree itself and empty nodes.
+  unsigned int GetNumberOfFlatIndices();
+
   // Description:
   // Return the actual size of the data in kibibytes (1024 bytes). This number
   // is valid only after the pipeline has updated.
@@ -166,6 +185,16 @@ protected:
   // Returns 1 is present, 0 otherwise.
   int HasChildMetaData(unsigned int index);
 
+  // Description:
+  // Returns the flat table of this tree, (re)building it if a tree of the
+  // hierarchy was modified since it was built. The table stays valid as
+  // long as the caller holds it.
+  vtkSmartPointer<vtkDataObjectTreeFlatTable> GetFlatTable();
+
+  // Description:
+  // Appends this subtree, whose own flat index is flatIndex, to the table.
+  void BuildFlatTable(unsigned int flatIndex, vtkDataObjectTreeFlatTable* table);
+
   // The internal datastructure. Subclasses need not access this directly.
   vtkDataObjectTreeInternals* Internals;
 
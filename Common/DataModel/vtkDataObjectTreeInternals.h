@@ -20,8 +20,10 @@
 
 #include "vtkDataObject.h"
 #include "vtkInformation.h"
+#include "vtkSimpleCriticalSection.h"
 #include "vtkSmartPointer.h"
 
+#include <utility>
 #include <vector>
 
 //-----------------------------------------------------------------------------
@@ -38,6 +40,47 @@ struct vtkDataObjectTreeItem
     }
 };
 
+class vtkDataObjectTree;
+
+//-----------------------------------------------------------------------------
+// Flat (preorder) view of a whole tree. Items is indexed by flat index, with
+// item 0 being the tree itself. Each item records the tree holding it and its
+// index among that tree's children so that it can be resolved in constant
+// time. Trees holds the trees of the hierarchy in preorder, with their
+// modification time when the table was built; a later modification of any
+// of them makes the table stale.
+class vtkDataObjectTreeFlatTable : public vtkObjectBase
+{
+public:
+  static vtkDataObjectTreeFlatTable* New()
+    {
+    return new vtkDataObjectTreeFlatTable;
+    }
+
+  struct Item
+    {
+    vtkDataObjectTree* Parent;
+    unsigned int ChildIndex;
+    unsigned int ParentFlatIndex;
+    };
+
+  std::vector<Item> Items;
+
+  // Flat indices of all non-tree items, and of those that are not NULL.
+  std::vector<unsigned int> Leaves;
+  std::vector<unsigned int> NonEmptyLeaves;
+
+  std::vector<std::pair<vtkDataObjectTree*, unsigned long> > Trees;
+
+protected:
+  vtkDataObjectTreeFlatTable() {}
+  ~vtkDataObjectTreeFlatTable() {}
+
+private:
+  vtkDataObjectTreeFlatTable(const vtkDataObjectTreeFlatTable&); // Not implemented.
+  void operator=(const vtkDataObjectTreeFlatTable&); // Not implemented.
+};
+
 //-----------------------------------------------------------------------------
 class vtkDataObjectTreeInternals
 {
@@ -47,6 +90,10 @@ public:
   typedef VectorOfDataObjects::reverse_iterator ReverseIterator;
 
   VectorOfDataObjects Children;
+
+  // Lazily built by vtkDataObjectTree::GetFlatTable(), under FlatTableLock.
+  vtkSmartPointer<vtkDataObjectTreeFlatTable> FlatTable;
+  vtkSimpleCriticalSection FlatTableLock;
 };
 
 
@@ -18,6 +18,8 @@
 #include "vtkDataObjectTreeInternals.h"
 #include "vtkObjectFactory.h"
 
+#include <algorithm>
+
 
 class vtkDataObjectTreeIterator::vtkInternals
 {
@@ -270,6 +272,22 @@ public:
 
   vtkIterator *Iterator;
   vtkDataObjectTreeIterator* CompositeDataIterator;
+
+  // Leaf-only traversal over the flat table of the tree. Used instead of
+  // Iterator when FlatTable is set.
+  vtkSmartPointer<vtkDataObjectTreeFlatTable> FlatTable;
+  const std::vector<unsigned int>* FlatLeaves;
+  size_t FlatPosition;
+
+  bool IsFlatDone()
+    {
+    return this->FlatPosition >= this->FlatLeaves->size();
+    }
+
+  const vtkDataObjectTreeFlatTable::Item& GetFlatItem()
+    {
+    return this->FlatTable->Items[(*this->FlatLeaves)[this->FlatPosition]];
+    }
 };
 
 vtkStandardNewMacro(vtkDataObjectTreeIterator);
@@ -281,6 +299,8 @@ vtkDataObjectTreeIterator::vtkDataObjectTreeIterator()
   this->CurrentFlatIndex = 0;
   this->Internals = new vtkInternals();
   this->Internals->CompositeDataIterator = this;
+  this->Internals->FlatLeaves = 0;
+  this->Internals->FlatPosition = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -292,6 +312,10 @@ vtkDataObjectTreeIterator::~vtkDataObjectTreeIterator()
 //----------------------------------------------------------------------------
 int vtkDataObjectTreeIterator::IsDoneWithTraversal()
 {
+  if (this->Internals->FlatTable)
+    {
+    return this->Internals->IsFlatDone();
+    }
   return this->Internals->Iterator->IsDoneWithTraversal();
 }
 
@@ -299,6 +323,24 @@ int vtkDataObjectTreeIterator::IsDoneWithTraversal()
 void vtkDataObjectTreeIterator::GoToFirstItem()
 {
   this->CurrentFlatIndex = 0;
+
+  // Visiting all leaves of the tree in order is the common case (e.g.
+  // vtkCompositeDataPipeline executing a simple filter per block). It is
+  // done over the flat table, which avoids walking the nested vectors and
+  // lets empty leaves be skipped without visiting them.
+  this->Internals->FlatTable = 0;
+  vtkDataObjectTree* tree = vtkDataObjectTree::SafeDownCast(this->DataSet);
+  if (tree && this->VisitOnlyLeaves && this->TraverseSubTree && !this->Reverse)
+    {
+    this->Internals->FlatTable = tree->GetFlatTable();
+    this->Internals->FlatLeaves = this->SkipEmptyNodes ?
+      &this->Internals->FlatTable->NonEmptyLeaves :
+      &this->Internals->FlatTable->Leaves;
+    this->Internals->FlatPosition = 0;
+    this->UpdateFlatLocation();
+    return;
+    }
+
   this->Internals->Iterator->Initialize(this->Reverse !=0, this->DataSet);
   this->NextInternal();
 
@@ -320,6 +362,16 @@ void vtkDataObjectTreeIterator::GoToFirstItem()
 //----------------------------------------------------------------------------
 void vtkDataObjectTreeIterator::GoToNextItem()
 {
+  if (this->Internals->FlatTable)
+    {
+    if (!this->Internals->IsFlatDone())
+      {
+      this->Internals->FlatPosition++;
+      this->UpdateFlatLocation();
+      }
+    return;
+    }
+
   if (!this->Internals->Iterator->IsDoneWithTraversal())
     {
     this->NextInternal();
@@ -340,6 +392,24 @@ void vtkDataObjectTreeIterator::GoToNextItem()
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkDataObjectTreeIterator::UpdateFlatLocation()
+{
+  // The table lists the leaves that were non-empty when it was built; skip
+  // any that have been emptied since.
+  while (!this->Internals->IsFlatDone())
+    {
+    const vtkDataObjectTreeFlatTable::Item& item = this->Internals->GetFlatItem();
+    if (!this->SkipEmptyNodes || item.Parent->GetChild(item.ChildIndex))
+      {
+      this->CurrentFlatIndex =
+        (*this->Internals->FlatLeaves)[this->Internals->FlatPosition];
+      return;
+      }
+    this->Internals->FlatPosition++;
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkDataObjectTreeIterator::NextInternal()
 {
@@ -354,6 +424,15 @@ void vtkDataObjectTreeIterator::NextInternal()
 //----------------------------------------------------------------------------
 vtkDataObject* vtkDataObjectTreeIterator::GetCurrentDataObject()
 {
+  if (this->Internals->FlatTable)
+    {
+    if (this->Internals->IsFlatDone())
+      {
+      return 0;
+      }
+    const vtkDataObjectTreeFlatTable::Item& item = this->Internals->GetFlatItem();
+    return item.Parent->GetChild(item.ChildIndex);
+    }
   if (!this->IsDoneWithTraversal())
     {
     return this->Internals->Iterator->GetCurrentDataObject();
@@ -365,6 +444,15 @@ vtkDataObject* vtkDataObjectTreeIterator::GetCurrentDataObject()
 //----------------------------------------------------------------------------
 vtkInformation* vtkDataObjectTreeIterator::GetCurrentMetaData()
 {
+  if (this->Internals->FlatTable)
+    {
+    if (this->Internals->IsFlatDone())
+      {
+      return 0;
+      }
+    const vtkDataObjectTreeFlatTable::Item& item = this->Internals->GetFlatItem();
+    return item.Parent->GetChildMetaData(item.ChildIndex);
+    }
   if (!this->IsDoneWithTraversal())
     {
     return this->Internals->Iterator->GetCurrentMetaData();
@@ -376,6 +464,15 @@ vtkInformation* vtkDataObjectTreeIterator::GetCurrentMetaData()
 //----------------------------------------------------------------------------
 int vtkDataObjectTreeIterator::HasCurrentMetaData()
 {
+  if (this->Internals->FlatTable)
+    {
+    if (this->Internals->IsFlatDone())
+      {
+      return 0;
+      }
+    const vtkDataObjectTreeFlatTable::Item& item = this->Internals->GetFlatItem();
+    return item.Parent->HasChildMetaData(item.ChildIndex);
+    }
   if (!this->IsDoneWithTraversal())
     {
     return this->Internals->Iterator->HasCurrentMetaData();
@@ -387,6 +484,24 @@ int vtkDataObjectTreeIterator::HasCurrentMetaData()
 //----------------------------------------------------------------------------
 vtkDataObjectTreeIndex vtkDataObjectTreeIterator::GetCurrentIndex()
 {
+  if (this->Internals->FlatTable)
+    {
+    vtkDataObjectTreeIndex index;
+    if (this->Internals->IsFlatDone())
+      {
+      return index;
+      }
+    // Walk up to the root, then put the child indices in top-down order.
+    const std::vector<vtkDataObjectTreeFlatTable::Item>& items =
+      this->Internals->FlatTable->Items;
+    for (unsigned int flatIndex = this->CurrentFlatIndex; flatIndex != 0;
+      flatIndex = items[flatIndex].ParentFlatIndex)
+      {
+      index.push_back(items[flatIndex].ChildIndex);
+      }
+    std::reverse(index.begin(), index.end());
+    return index;
+    }
   return this->Internals->Iterator->GetCurrentIndex();
 }
 
@@ -135,6 +135,11 @@ private:
 
   // Cannot be called when this->IsDoneWithTraversal() return 1.
   void UpdateLocation();
+
+  // Description:
+  // Moves a flat table traversal to the first valid leaf at or after the
+  // current position and updates CurrentFlatIndex.
+  void UpdateFlatLocation();
 //ETX
 };
 
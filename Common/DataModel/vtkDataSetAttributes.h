@@ -616,6 +616,9 @@ public:
     vtkIdList *ids, double *weights);
 
   friend class vtkDataSetAttributes::FieldList;
+
+  // vtkArrayList pairs arrays as CopyData() and InterpolatePoint() do.
+  friend class vtkArrayList;
 //ETX
 
 //BTX
@@ -26,6 +26,7 @@
 #include "vtkInformation.h"
 #include "vtkGraph.h"
 #include "vtkGraphEdge.h"
+#include "vtkGraphInternals.h"
 
 vtkStandardNewMacro(vtkEdgeListIterator);
 //----------------------------------------------------------------------------
@@ -37,6 +38,7 @@ vtkEdgeListIterator::vtkEdgeListIterator()
   this->Graph = 0;
   this->Directed = false;
   this->GraphEdge = 0;
+  this->FrozenInternals = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -58,6 +60,7 @@ void vtkEdgeListIterator::SetGraph(vtkGraph *graph)
   vtkSetObjectBodyMacro(Graph, vtkGraph, graph);
   this->Current = 0;
   this->End = 0;
+  this->FrozenInternals = 0;
   if (this->Graph && this->Graph->GetNumberOfEdges() > 0)
     {
     this->Directed = (vtkDirectedGraph::SafeDownCast(this->Graph) != 0);
@@ -73,6 +76,10 @@ void vtkEdgeListIterator::SetGraph(vtkGraph *graph)
       this->Vertex = helper->MakeDistributedId(myRank, this->Vertex);
       lastVertex = helper->MakeDistributedId(myRank, lastVertex);
       }
+    else if (this->Graph->IsFrozen())
+      {
+      this->FrozenInternals = this->Graph->GetGraphInternals(false);
+      }
 
     // Find a vertex with nonzero out degree.
     while (this->Vertex < lastVertex &&
@@ -165,6 +172,31 @@ void vtkEdgeListIterator::Increment()
     return;
     }
 
+  if (this->FrozenInternals)
+    {
+    // The out edges of consecutive vertices are adjacent in memory, so
+    // only the vertex needs to be advanced past the empty ranges.
+    ++this->Current;
+    if (this->Current == this->End)
+      {
+      const std::vector<vtkIdType>& offsets = this->FrozenInternals->OutOffsets;
+      const vtkOutEdgeType *edges = &this->FrozenInternals->OutEdgesCSR[0];
+      vtkIdType pos = static_cast<vtkIdType>(this->Current - edges);
+      vtkIdType lastVertex = static_cast<vtkIdType>(offsets.size()) - 1;
+      if (pos == offsets[lastVertex])
+        {
+        this->Current = 0;
+        return;
+        }
+      while (offsets[this->Vertex + 1] <= pos)
+        {
+        ++this->Vertex;
+        }
+      this->End = edges + offsets[this->Vertex + 1];
+      }
+    return;
+    }
+
   vtkIdType lastVertex = this->Graph->GetNumberOfVertices();
 
   vtkDistributedGraphHelper *helper = this->Graph->GetDistributedGraphHelper();
@@ -40,6 +40,7 @@
 
 class vtkGraph;
 class vtkGraphEdge;
+class vtkGraphInternals;
 //BTX
 struct vtkEdgeType;
 struct vtkOutEdgeType;
@@ -85,6 +86,12 @@ protected:
   bool                  Directed;
   vtkGraphEdge        *GraphEdge;
 
+  // Description:
+  // Set to the graph structure when it is frozen and not distributed.
+  // All out edges are then contiguous and Increment() walks them
+  // directly instead of querying the graph vertex by vertex.
+  vtkGraphInternals   *FrozenInternals;
+
 private:
   vtkEdgeListIterator(const vtkEdgeListIterator&);  // Not implemented.
   void operator=(const vtkEdgeListIterator&);  // Not implemented.
@@ -290,7 +290,10 @@ vtkOutEdgeType vtkGraph::GetOutEdge(vtkIdType v, vtkIdType i)
 
   if (i < this->GetOutDegree(v))
     {
-    return this->Internals->Adjacency[index].OutEdges[i];
+    const vtkOutEdgeType *edges;
+    vtkIdType nedges;
+    this->Internals->GetOutEdges(index, edges, nedges);
+    return edges[i];
     }
   vtkErrorMacro("Out edge index out of bounds");
   return vtkOutEdgeType();
@@ -321,15 +324,7 @@ void vtkGraph::GetOutEdges(vtkIdType v, const vtkOutEdgeType *& edges, vtkIdType
     index = helper->GetVertexIndex(v);
     }
 
-  nedges = this->Internals->Adjacency[index].OutEdges.size();
-  if (nedges > 0)
-    {
-    edges = &(this->Internals->Adjacency[index].OutEdges[0]);
-    }
-  else
-    {
-    edges = 0;
-    }
+  this->Internals->GetOutEdges(index, edges, nedges);
 }
 
 //----------------------------------------------------------------------------
@@ -347,6 +342,11 @@ vtkIdType vtkGraph::GetOutDegree(vtkIdType v)
 
     index = helper->GetVertexIndex(v);
     }
+  if (this->Internals->Frozen)
+    {
+    return this->Internals->OutOffsets[index + 1] -
+           this->Internals->OutOffsets[index];
+    }
   return this->Internals->Adjacency[index].OutEdges.size();
 }
 
@@ -367,6 +367,13 @@ vtkIdType vtkGraph::GetDegree(vtkIdType v)
     index = helper->GetVertexIndex(v);
     }
 
+  if (this->Internals->Frozen)
+    {
+    return this->Internals->InOffsets[index + 1] -
+           this->Internals->InOffsets[index] +
+           this->Internals->OutOffsets[index + 1] -
+           this->Internals->OutOffsets[index];
+    }
   return this->Internals->Adjacency[index].InEdges.size() +
          this->Internals->Adjacency[index].OutEdges.size();
 }
@@ -407,7 +414,10 @@ vtkInEdgeType vtkGraph::GetInEdge(vtkIdType v, vtkIdType i)
 
   if (i < this->GetInDegree(v))
     {
-    return this->Internals->Adjacency[index].InEdges[i];
+    const vtkInEdgeType *edges;
+    vtkIdType nedges;
+    this->Internals->GetInEdges(index, edges, nedges);
+    return edges[i];
     }
   vtkErrorMacro("In edge index out of bounds");
   return vtkInEdgeType();
@@ -439,15 +449,7 @@ void vtkGraph::GetInEdges(vtkIdType v, const vtkInEdgeType *& edges, vtkIdType &
     index = helper->GetVertexIndex(v);
     }
 
-  nedges = this->Internals->Adjacency[index].InEdges.size();
-  if (nedges > 0)
-    {
-    edges = &(this->Internals->Adjacency[index].InEdges[0]);
-    }
-  else
-    {
-    edges = 0;
-    }
+  this->Internals->GetInEdges(index, edges, nedges);
 }
 
 //----------------------------------------------------------------------------
@@ -467,6 +469,11 @@ vtkIdType vtkGraph::GetInDegree(vtkIdType v)
     index = helper->GetVertexIndex(v);
     }
 
+  if (this->Internals->Frozen)
+    {
+    return this->Internals->InOffsets[index + 1] -
+           this->Internals->InOffsets[index];
+    }
   return this->Internals->Adjacency[index].InEdges.size();
 }
 
@@ -516,7 +523,33 @@ void vtkGraph::GetVertices(vtkVertexListIterator *it)
 //----------------------------------------------------------------------------
 vtkIdType vtkGraph::GetNumberOfVertices()
 {
-  return this->Internals->Adjacency.size();
+  return this->Internals->GetNumberOfVertices();
+}
+
+//----------------------------------------------------------------------------
+void vtkGraph::Freeze()
+{
+  if (this->DistributedHelper)
+    {
+    vtkErrorMacro("Cannot freeze a distributed graph.");
+    return;
+    }
+  if (this->Internals->Frozen)
+    {
+    return;
+    }
+  // Freezing releases the adjacency lists that edge iterators and
+  // GetOutEdges() pointers of other graphs sharing the structure may use,
+  // so freeze a structure of our own.
+  this->ForceOwnership();
+  this->Internals->Freeze();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+bool vtkGraph::IsFrozen()
+{
+  return this->Internals->Frozen;
 }
 
 //----------------------------------------------------------------------------
@@ -1645,6 +1678,9 @@ void vtkGraph::RemoveVerticesInternal(vtkIdTypeArray* arr, bool directed)
   vtkIdType numVert = arr->GetNumberOfTuples();
   std::sort(p, p + numVert);
 
+  // Thaw a frozen structure before reading its adjacency lists.
+  this->ForceOwnership();
+
   // Collect all edges to be removed
   std::set<vtkIdType> edges;
   for (vtkIdType vind = 0; vind < numVert; ++vind)
@@ -1772,9 +1808,17 @@ void vtkGraph::ForceOwnership()
     vtkGraphInternals *internals = vtkGraphInternals::New();
     internals->Adjacency = this->Internals->Adjacency;
     internals->NumberOfEdges = this->Internals->NumberOfEdges;
+    internals->Frozen = this->Internals->Frozen;
+    internals->OutOffsets = this->Internals->OutOffsets;
+    internals->InOffsets = this->Internals->InOffsets;
+    internals->OutEdgesCSR = this->Internals->OutEdgesCSR;
+    internals->InEdgesCSR = this->Internals->InEdgesCSR;
     this->SetInternals(internals);
     internals->Delete();
     }
+  // Every caller is about to modify the structure, which requires the
+  // per-vertex adjacency lists.
+  this->Internals->Thaw();
   if (this->EdgePoints && this->EdgePoints->GetReferenceCount() > 1)
     {
     vtkGraphEdgePoints *oldEdgePoints = this->EdgePoints;
@@ -1815,19 +1859,25 @@ vtkIdType vtkGraph::GetNumberOfElements(int type)
 void vtkGraph::Dump()
 {
   cout << "vertex adjacency:" << endl;
-  for (size_t v = 0; v < this->Internals->Adjacency.size(); ++v)
+  vtkIdType numVerts = this->Internals->GetNumberOfVertices();
+  for (vtkIdType v = 0; v < numVerts; ++v)
     {
+    const vtkOutEdgeType *outEdges;
+    const vtkInEdgeType *inEdges;
+    vtkIdType nedges;
     cout << v << " (out): ";
-    for (size_t eind = 0; eind < this->Internals->Adjacency[v].OutEdges.size(); ++eind)
+    this->Internals->GetOutEdges(v, outEdges, nedges);
+    for (vtkIdType eind = 0; eind < nedges; ++eind)
       {
-      cout << "[" << this->Internals->Adjacency[v].OutEdges[eind].Id
-           << "," << this->Internals->Adjacency[v].OutEdges[eind].Target << "]";
+      cout << "[" << outEdges[eind].Id
+           << "," << outEdges[eind].Target << "]";
       }
     cout << " (in): ";
-    for (size_t eind = 0; eind < this->Internals->Adjacency[v].InEdges.size(); ++eind)
+    this->Internals->GetInEdges(v, inEdges, nedges);
+    for (vtkIdType eind = 0; eind < nedges; ++eind)
       {
-      cout << "[" << this->Internals->Adjacency[v].InEdges[eind].Id
-           << "," << this->Internals->Adjacency[v].InEdges[eind].Source << "]";
+      cout << "[" << inEdges[eind].Id
+           << "," << inEdges[eind].Source << "]";
       }
     cout << endl;
     }
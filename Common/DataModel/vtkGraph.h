@@ -480,6 +480,21 @@ public:
   // In a distributed graph, the vertex v must be local.
   void ReorderOutVertices(vtkIdType v, vtkIdTypeArray *vertices);
 
+  // Description:
+  // Pack the adjacency structure into an immutable compressed sparse row
+  // representation. This greatly reduces the memory used by large graphs
+  // and makes edge traversal contiguous. The vertices, edges, edge ids and
+  // edge ordering are unchanged. A structure shared with other graphs is
+  // copied first, so they are not affected. Any subsequent structural
+  // modification (through a mutable graph or GetGraphInternals(true))
+  // transparently restores the modifiable representation. Distributed
+  // graphs cannot be frozen.
+  void Freeze();
+
+  // Description:
+  // Returns true if the adjacency structure is currently frozen.
+  bool IsFrozen();
+
   // Description:
   // Returns true if both graphs point to the same adjacency structure.
   // Can be used to test the copy-on-write feature of the graph.
@@ -21,6 +21,8 @@
 #include "vtkDistributedGraphHelper.h"
 #include "vtkObjectFactory.h"
 
+#include <algorithm>
+
 vtkStandardNewMacro(vtkGraphInternals);
 
 //----------------------------------------------------------------------------
@@ -29,6 +31,7 @@ vtkGraphInternals::vtkGraphInternals()
   this->NumberOfEdges = 0;
   this->LastRemoteEdgeId = -1;
   this->UsingPedigreeIds = false;
+  this->Frozen = false;
 }
 
 //----------------------------------------------------------------------------
@@ -103,3 +106,98 @@ void vtkGraphInternals::ReplaceEdgeFromInList(vtkIdType from, vtkIdType to, std:
       }
     }
 }
+
+//----------------------------------------------------------------------------
+void vtkGraphInternals::Freeze()
+{
+  if (this->Frozen)
+    {
+    return;
+    }
+
+  size_t numVerts = this->Adjacency.size();
+  this->OutOffsets.resize(numVerts + 1);
+  this->InOffsets.resize(numVerts + 1);
+  this->OutOffsets[0] = 0;
+  this->InOffsets[0] = 0;
+  for (size_t v = 0; v < numVerts; ++v)
+    {
+    this->OutOffsets[v + 1] = this->OutOffsets[v] +
+      static_cast<vtkIdType>(this->Adjacency[v].OutEdges.size());
+    this->InOffsets[v + 1] = this->InOffsets[v] +
+      static_cast<vtkIdType>(this->Adjacency[v].InEdges.size());
+    }
+
+  this->OutEdgesCSR.resize(this->OutOffsets[numVerts]);
+  this->InEdgesCSR.resize(this->InOffsets[numVerts]);
+  for (size_t v = 0; v < numVerts; ++v)
+    {
+    std::copy(this->Adjacency[v].OutEdges.begin(),
+              this->Adjacency[v].OutEdges.end(),
+              this->OutEdgesCSR.begin() + this->OutOffsets[v]);
+    std::copy(this->Adjacency[v].InEdges.begin(),
+              this->Adjacency[v].InEdges.end(),
+              this->InEdgesCSR.begin() + this->InOffsets[v]);
+    }
+
+  // Swap with an empty vector to actually release the lists.
+  std::vector<vtkVertexAdjacencyList>().swap(this->Adjacency);
+  this->Frozen = true;
+}
+
+//----------------------------------------------------------------------------
+void vtkGraphInternals::Thaw()
+{
+  if (!this->Frozen)
+    {
+    return;
+    }
+
+  vtkIdType numVerts = this->GetNumberOfVertices();
+  this->Adjacency.resize(numVerts);
+  for (vtkIdType v = 0; v < numVerts; ++v)
+    {
+    this->Adjacency[v].OutEdges.assign(
+      this->OutEdgesCSR.begin() + this->OutOffsets[v],
+      this->OutEdgesCSR.begin() + this->OutOffsets[v + 1]);
+    this->Adjacency[v].InEdges.assign(
+      this->InEdgesCSR.begin() + this->InOffsets[v],
+      this->InEdgesCSR.begin() + this->InOffsets[v + 1]);
+    }
+
+  std::vector<vtkIdType>().swap(this->OutOffsets);
+  std::vector<vtkIdType>().swap(this->InOffsets);
+  std::vector<vtkOutEdgeType>().swap(this->OutEdgesCSR);
+  std::vector<vtkInEdgeType>().swap(this->InEdgesCSR);
+  this->Frozen = false;
+}
+
+//----------------------------------------------------------------------------
+void vtkGraphInternals::GetOutEdges(vtkIdType index,
+  const vtkOutEdgeType *& edges, vtkIdType& nedges)
+{
+  if (this->Frozen)
+    {
+    vtkIdType begin = this->OutOffsets[index];
+    nedges = this->OutOffsets[index + 1] - begin;
+    edges = nedges > 0 ? &this->OutEdgesCSR[begin] : 0;
+    return;
+    }
+  nedges = static_cast<vtkIdType>(this->Adjacency[index].OutEdges.size());
+  edges = nedges > 0 ? &this->Adjacency[index].OutEdges[0] : 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkGraphInternals::GetInEdges(vtkIdType index,
+  const vtkInEdgeType *& edges, vtkIdType& nedges)
+{
+  if (this->Frozen)
+    {
+    vtkIdType begin = this->InOffsets[index];
+    nedges = this->InOffsets[index + 1] - begin;
+    edges = nedges > 0 ? &this->InEdgesCSR[begin] : 0;
+    return;
+    }
+  nedges = static_cast<vtkIdType>(this->Adjacency[index].InEdges.size());
+  edges = nedges > 0 ? &this->Adjacency[index].InEdges[0] : 0;
+}
@@ -21,6 +21,13 @@
 // .SECTION Description
 // This is the internal representation of vtkGraph, used only in rare cases
 // where one must modify that representation.
+//
+// The adjacency is normally stored as one vtkVertexAdjacencyList per vertex.
+// After construction, the graph may be frozen with Freeze(), which packs
+// all in and out edges into compressed sparse row (CSR) arrays and releases
+// the per-vertex lists. While frozen, Adjacency is empty and the out (in)
+// edges of vertex v are the contiguous range
+// [OutOffsets[v], OutOffsets[v+1]) of OutEdgesCSR (InEdgesCSR).
 
 #ifndef vtkGraphInternals_h
 #define vtkGraphInternals_h
@@ -68,6 +75,41 @@ public:
   bool UsingPedigreeIds;
 
   //BTX
+  // Description:
+  // Compressed sparse row adjacency, valid only when Frozen is true.
+  bool Frozen;
+  std::vector<vtkIdType> OutOffsets;
+  std::vector<vtkIdType> InOffsets;
+  std::vector<vtkOutEdgeType> OutEdgesCSR;
+  std::vector<vtkInEdgeType> InEdgesCSR;
+
+  // Description:
+  // Pack the per-vertex adjacency lists into the CSR arrays and release
+  // the lists. The order of the edges of each vertex is preserved.
+  void Freeze();
+
+  // Description:
+  // Rebuild the per-vertex adjacency lists from the CSR arrays so that
+  // the structure may be modified again.
+  void Thaw();
+
+  // Description:
+  // The number of (local) vertices, for either representation.
+  vtkIdType GetNumberOfVertices()
+    {
+    return this->Frozen ?
+      static_cast<vtkIdType>(this->OutOffsets.size()) - 1 :
+      static_cast<vtkIdType>(this->Adjacency.size());
+    }
+
+  // Description:
+  // Contiguous out and in edge ranges for a local vertex index, for
+  // either representation. edges is set to 0 when nedges is 0.
+  void GetOutEdges(vtkIdType index, const vtkOutEdgeType *& edges,
+                   vtkIdType& nedges);
+  void GetInEdges(vtkIdType index, const vtkInEdgeType *& edges,
+                  vtkIdType& nedges);
+
   // Description:
   // Convenience method for removing an edge from an out edge list.
   void RemoveEdgeFromOutList(vtkIdType e, std::vector<vtkOutEdgeType>& outEdges);
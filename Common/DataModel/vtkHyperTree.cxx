@@ -27,7 +27,6 @@ PURPOSE.  See the above copyright notice for more information.
 // The template value N describes the number of children to binary and
 // ternary trees.
 template<int N> class vtkCompactHyperTree;
-template<int N> class vtkCompactHyperTreeNode;
 
 template<int N> class vtkCompactHyperTreeCursor : public vtkHyperTreeCursor
 {
@@ -82,8 +81,11 @@ public:
     bool result = ! this->Leaf;
     if( result )
       {
-      vtkCompactHyperTreeNode<N>* node = this->Tree->GetNode( this->Index );
-      result = node->IsTerminalNode();
+      vtkIdType firstChild = this->Tree->GetFirstChildIndex( this->Index );
+      for ( int i = 0; result && i < N; ++ i )
+        {
+        result = this->Tree->IsLeafIndex( firstChild + i );
+        }
       }
     // A=>B: notA or B
     assert( "post: compatible" && ( ! result || ! this->Leaf) );
@@ -93,8 +95,7 @@ public:
   //---------------------------------------------------------------------------
   virtual bool IsRoot()
   {
-    return ( ! this->Leaf && this->Index == 0 )
-      || ( this->Leaf && ! this->Index && this->Tree->GetLeafParentSize() == 1 );
+    return this->Index == 0;
   }
 
   //---------------------------------------------------------------------------
@@ -124,8 +125,9 @@ public:
   virtual void ToRoot()
   {
     this->ChildHistory.clear();
-    this->Leaf = ( this->Tree->GetLeafParentSize() == 1 );
-    this->Index = this->Leaf ? 0 : 1;
+    this->IndexHistory.clear();
+    this->Index = 0;
+    this->Leaf = this->Tree->IsLeafIndex( 0 );
     this->ChildIndex = 0;
     memset( this->Indices, 0, 3 * sizeof(int) );
   }
@@ -135,9 +137,8 @@ public:
   virtual void ToParent()
   {
     assert( "pre: not_root" && !IsRoot() );
-    this->Index = this->Leaf ?
-      this->Tree->GetLeafParent( this->Index ) :
-      this->Tree->GetNode( this->Index )->GetParent();
+    this->Index = this->IndexHistory.back();
+    this->IndexHistory.pop_back();
 
     this->Leaf = false;
     this->ChildIndex = this->ChildHistory.back(); // top()
@@ -158,11 +159,11 @@ public:
     assert( "pre: valid_child" && child >= 0
       && child < this->GetNumberOfChildren() );
 
-    vtkCompactHyperTreeNode<N>* node = this->Tree->GetNode( this->Index );
     this->ChildHistory.push_back( this->ChildIndex );
+    this->IndexHistory.push_back( this->Index );
     this->ChildIndex = child;
-    this->Index = node->GetChild( child );
-    this->Leaf = node->IsChildLeaf( child );
+    this->Index = this->Tree->GetFirstChildIndex( this->Index ) + child;
+    this->Leaf = this->Tree->IsLeafIndex( this->Index );
 
     int tmpChild = child;
     int branchFactor = this->Tree->GetBranchFactor();
@@ -195,6 +196,7 @@ public:
     this->ChildIndex = o->ChildIndex;
     this->Leaf = o->Leaf;
     this->ChildHistory = o->ChildHistory; // use assignment operator
+    this->IndexHistory = o->IndexHistory;
     memcpy( this->Indices, o->Indices, 3 * sizeof(int) );
 
     assert( "post: equal" && this->IsEqual(other) );
@@ -396,7 +398,7 @@ protected:
   vtkCompactHyperTree<N> *Tree;
   unsigned char Dimension;
 
-  // Index either in the Nodes or Parents (if leaf)
+  // Index of the current node or leaf in the tree
   vtkIdType Index;
 
   // Number of current node as a child
@@ -408,6 +410,9 @@ protected:
   // A stack, but stack does not have clear()
   std::deque<int> ChildHistory;
 
+  // Indices of the ancestors of the current node
+  std::deque<vtkIdType> IndexHistory;
+
   // Index in each dimension of the current node, as if the tree at the current
   // level were a uniform grid. Default to 3 dimensions, use only those needed
   int Indices[3];
@@ -417,176 +422,6 @@ private:
   void operator=(const vtkCompactHyperTreeCursor<N> &);    // Not implemented.
 };
 
-// We could use a 4 byte int, but the internals are completely hidden.
-class vtkHyperTreeLeafFlags
-{
-public:
-  vtkHyperTreeLeafFlags()
-  { // Unused bits are set to 1.
-    for ( int i = 0; i < 4; ++ i )
-      {
-      this->Flags[i] = 0xFF;
-      }
-  }
-
-  // True if all chilren are leaves.
-  bool IsTerminal()
-  {
-    // Unused bits are set to 1.
-    return this->Flags[0] == 0xFF
-      && this->Flags[1] == 0xFF
-      && this->Flags[2] == 0xFF;
-  }
-
-  void SetLeafFlag(int idx, bool val)
-  {
-    assert( "Valid child idx" && idx >= 0 && idx < 32);
-    int i = 0;
-    while ( idx >= 8 )
-      {
-      ++ i;
-      idx -= 8;
-      }
-    unsigned char mask = 1 << idx;
-    this->Flags[i] = val ?
-      ( this->Flags[i] | mask ) : ( this->Flags[i] & (mask ^ 0xFF) );
-  }
-
-  bool GetLeafFlag(int idx)
-  {
-    assert( "Valid child idx" && idx >= 0 && idx < 32);
-    int i = 0;
-    while ( idx >= 8 )
-      {
-      ++ i;
-      idx -= 8;
-      }
-    unsigned char mask = 1 << idx;
-    return ( mask & this->Flags[i] ) == mask;
-  }
-
-  void PrintSelf(ostream& os, int numChildren)
-  {
-    assert( "Number of children" && numChildren >= 0 && numChildren < 32);
-    int childIdx = 0;
-    int byteIdx = 0;
-    unsigned char mask = 1;
-    while ( childIdx < numChildren )
-      {
-      os << ( ( this->Flags[byteIdx] & mask ) == mask );
-      ++childIdx;
-      if ( mask == 128 )
-        {
-        mask = 1;
-        ++byteIdx;
-        }
-      else
-        {
-        mask <<= 1;
-        }
-      }
-    os << endl;
-  }
-
-private:
-  unsigned char Flags[4];
-};
-
-// Description:
-// A node of the Tree which is not a leaf.
-// Expected template values: 4, 8, 9, 27.
-template<int N> class vtkCompactHyperTreeNode
-{
-public:
-  //---------------------------------------------------------------------------
-  // Description:
-  // See GetParent().
-  void SetParent(vtkIdType parent)
-  {
-    assert( "pre: positive_parent" && parent >= 0 );
-    this->Parent = parent;
-    assert( "post: is_set" && parent == this->GetParent() );
-  }
-
-  //---------------------------------------------------------------------------
-  // Description:
-  // Return the index of the parent node of the current node in the
-  // nodes array of the hyperTree.
-  int GetParent()
-  {
-    assert( "post: positive_result" && this->Parent >= 0 );
-    return this->Parent;
-  }
-
-  //---------------------------------------------------------------------------
-  // Description:
-  // See GetLeafFlags()
-  void SetLeafFlag( vtkIdType childIdx, bool flag )
-  {
-    this->LeafFlags.SetLeafFlag( childIdx, flag );
-  }
-
-  //---------------------------------------------------------------------------
-  // Description
-  // Are children all leaves?
-  bool IsTerminalNode()
-  {
-    return this->LeafFlags.IsTerminal();
-  }
-
-  //---------------------------------------------------------------------------
-  // Description:
-  // Is the `i'-th child of the node a leaf ?
-  bool IsChildLeaf( int i )
-  {
-    assert( "pre: valid_range" && i >= 0 && i < N );
-    return this->LeafFlags.GetLeafFlag( i );
-  }
-
-  //---------------------------------------------------------------------------
-  // Description:
-  // See GetChild().
-  void SetChild( int i, int child )
-  {
-    assert( "pre: valid_range" && i >= 0 && i < N);
-    assert( "pre: positive_child" && child >= 0 );
-    this->Children[i] = child;
-    assert( "post: is_set" && child == this->GetChild( i ) );
-  }
-
-  //---------------------------------------------------------------------------
-  // Description:
-  // Return the index of of the 'i'-th child. If the result of
-  // IsChildLeaf( i ) is true, the index points to an element in the LeafParent
-  // and Attribute arrays of the hyperTree class. If not, the index points to
-  // an element in the Nodes array of the hyperTree class.
-  int GetChild( int i )
-  {
-    assert( "pre: valid_range" && i >= 0 && i < N);
-    assert( "post: positive_result" && this->Children[i] >= 0 );
-    return this->Children[i];
-  }
-
-  //---------------------------------------------------------------------------
-  void PrintSelf( ostream& os, vtkIndent indent )
-  {
-    os << indent << "Parent=" << this->Parent << endl;
-    os << indent << "LeafFlags= ";
-    this->LeafFlags.PrintSelf( os, N );
-
-    for( int i = 0; i < N; ++ i )
-      {
-      os << indent << this->Children[i] << endl;
-      }
-  }
-
-protected:
-  //---------------------------------------------------------------------------
-  int Parent; // index
-  vtkHyperTreeLeafFlags LeafFlags;
-  int Children[N];
-};
-
 template<int N> class vtkCompactHyperTree : public vtkHyperTree
 {
 public:
@@ -605,20 +440,8 @@ public:
   // Restore the initial state: only one node and one leaf: the root.
   virtual void Initialize()
   {
-    this->Nodes.resize( 1 );
-    this->Nodes[0].SetParent( 0 );
-    for ( int i = 0; i < N; ++ i )
-      {
-      // It is assumed that the root is a special node with only one child.
-      // The other children flags are irrelevant, but set them as nodes for
-      // no good reason.
-      this->Nodes[0].SetLeafFlag( i, i == 0 ); // First child is a leaf
-      this->Nodes[0].SetChild( i, 0 );
-      }
-    this->LeafParent.resize( 1 );
-    this->LeafParent[0] = 0;
+    this->InitializeRefinement();
     this->NumberOfLevels = 1;
-    this->NumberOfNodes = 1;
     this->GlobalIndexTable.clear();
     this->GlobalIndexStart = 0;
   }
@@ -639,13 +462,13 @@ public:
   //---------------------------------------------------------------------------
   virtual vtkIdType GetNumberOfLeaves()
   {
-    return this->NumberOfNodes;
+    return this->GetNumberOfIndex();
   }
 
   //---------------------------------------------------------------------------
   virtual vtkIdType GetNumberOfIndex()
   {
-    return static_cast<vtkIdType>( this->LeafParent.size() );
+    return 1 + this->NumberOfBlocks * N;
   }
 
   //---------------------------------------------------------------------------
@@ -662,7 +485,7 @@ public:
       this->GlobalIndexTable.resize( local + 1 );
       }
     this->GlobalIndexTable[ local ] = global;
-    if ( local == 0 && this->LeafParent.size() == 1 )
+    if ( local == 0 && this->NumberOfBlocks == 0 )
       {
       SetGlobalIndexFromLocal( 1, global );
       }
@@ -688,36 +511,10 @@ public:
 
   //---------------------------------------------------------------------------
   // Description:
-  // Public only for the vtkCompactHyperTreeCursor.
-  vtkCompactHyperTreeNode<N>* GetNode( int nodeIdx )
-  {
-    assert( "pre: valid_range" && nodeIdx >= 0
-      && nodeIdx < this->GetNumberOfNodes() );
-    return &this->Nodes[nodeIdx];
-  }
-
-  //---------------------------------------------------------------------------
-  // Description:
-  // Public only for the vtkCompactHyperTreeCursor.
-  // NB: Cursor (index ) appears to be different between nodes and leaves.
-  // Different arrays => overlapping indexes.
-  // I am changing the name for clarity.
-  // This really returns the nodeIdx of the leafs parent.
-  int GetLeafParent( int leafIdx )
-  {
-    assert( "pre: valid_range" && leafIdx >= 0
-      && leafIdx < this->GetNumberOfIndex() );
-    assert( "post: valid_result" && this->LeafParent[leafIdx] >= 0
-      && this->LeafParent[leafIdx] < this->GetNumberOfNodes() );
-    return this->LeafParent[leafIdx];
-  }
-
-  //---------------------------------------------------------------------------
-  // NB: Public only for the vtkCompactHyperTreeCursor.
+  // Return the number of nodes which are not leaves.
   virtual vtkIdType GetNumberOfNodes()
   {
-    assert( "post: not_empty" && this->Nodes.size() > 0 );
-    return static_cast<vtkIdType>( this->Nodes.size() );
+    return this->NumberOfBlocks;
   }
 
   //---------------------------------------------------------------------------
@@ -732,37 +529,10 @@ public:
 
     // The leaf becomes a node and is not anymore a leaf
     cursor->SetIsLeaf( false ); // let the cursor know about that change.
-    vtkIdType nodeIndex = cursor->GetNodeId();
 
-    // Nodes get constructed with leaf flags set to 1.
-    if ( this->GetNumberOfNodes() <= nodeIndex )
-      {
-      this->Nodes.resize( nodeIndex + 1 );
-      }
-    vtkIdType parentNodeIdx = this->LeafParent[nodeIndex];
-    this->Nodes[nodeIndex].SetParent( parentNodeIdx );
-
-    // Change the parent: it has one less child as a leaf
-    vtkCompactHyperTreeNode<N>& parent = this->Nodes[parentNodeIdx];
-
-    // New nodes index in parents children array.
-    int idx = cursor->GetChildIndex();
-    parent.SetLeafFlag( idx, false );
-    parent.SetChild( idx, static_cast<int>( nodeIndex ) );
-
-    // The first new child
-    // Recycle the leaf index we are deleting because it became a node.
-    // This avoids messy leaf parent array issues.
-    this->NumberOfNodes += N;
-    // The other (N) new children.
-    size_t nextLeaf = this->LeafParent.size();
-    this->LeafParent.resize( nextLeaf + N );
-    for ( int i = 0; i < N; ++ i, ++ nextLeaf )
-      {
-      this->Nodes[nodeIndex].SetChild( i, static_cast<int>( nextLeaf ) );
-      this->LeafParent[nextLeaf] = nodeIndex;
-      this->Nodes[nodeIndex].SetLeafFlag( i, true );
-      }
+    // The node keeps the index of the leaf, its children are appended
+    // as a new block of N leaves.
+    this->RefineIndex( cursor->GetNodeId() );
 
     // Update the number of leaves per level.
     vtkIdType level = cursor->GetChildHistorySize();
@@ -775,13 +545,6 @@ public:
       }
   }
 
-  //---------------------------------------------------------------------------
-  // NB: Bad interface: This is really GetNumberOfLeaves.
-  vtkIdType GetLeafParentSize()
-  {
-    return static_cast<int>( this->LeafParent.size() );
-  }
-
   //---------------------------------------------------------------------------
   void PrintSelf( ostream& os, vtkIndent indent )
   {
@@ -790,19 +553,9 @@ public:
     os << indent << "Dimension=" << this->Dimension << endl;
     os << indent << "BranchFactor=" << this->BranchFactor << endl;
 
-    os << indent << "Nodes=" << this->Nodes.size() << endl;
-    for ( unsigned int i = 0; i < this->Nodes.size(); ++ i )
-      {
-      this->Nodes[i].PrintSelf( os, indent );
-      }
-    os << endl;
-
-    os << indent << "LeafParent="<<this->LeafParent.size() << endl;
-    for ( unsigned int i = 0; i < this->LeafParent.size(); ++ i )
-      {
-      os << this->LeafParent[i] << " ";
-      }
-    os << endl;
+    os << indent << "NumberOfIndex=" << this->GetNumberOfIndex() << endl;
+    os << indent << "NumberOfNodes=" << this->NumberOfBlocks << endl;
+    os << indent << "Squeezed=" << this->Squeezed << endl;
   }
 
   //---------------------------------------------------------------------------
@@ -811,12 +564,41 @@ public:
   // Ignore the attribute array because its size is added by the data set.
   unsigned int GetActualMemorySize()
   {
-    size_t size = sizeof(vtkIdType) * this->LeafParent.size() +
-      sizeof(vtkCompactHyperTreeNode<N>) * this->Nodes.size() +
+    size_t size = this->GetRefinementMemorySize() +
       sizeof(vtkIdType) * this->GlobalIndexTable.size();
     return static_cast<unsigned int>( size / 1024 );
   }
 
+  //---------------------------------------------------------------------------
+  // Description:
+  // Squeeze the refinement and drop the local to global index table when
+  // it only holds consecutive indices.
+  virtual void Squeeze()
+  {
+    vtkIdType size = static_cast<vtkIdType>( this->GlobalIndexTable.size() );
+    if ( size > 0 )
+      {
+      vtkIdType start = this->GlobalIndexTable[0];
+      bool consecutive = size >= this->GetNumberOfIndex()
+        || start == this->GlobalIndexStart;
+      for ( vtkIdType i = 1; consecutive && i < size; ++ i )
+        {
+        consecutive = ( this->GlobalIndexTable[i] == start + i );
+        }
+      if ( consecutive )
+        {
+        this->GlobalIndexStart = start;
+        std::vector<vtkIdType>().swap( this->GlobalIndexTable );
+        }
+      else
+        {
+        std::vector<vtkIdType>( this->GlobalIndexTable ).swap(
+          this->GlobalIndexTable );
+        }
+      }
+    this->Superclass::Squeeze();
+  }
+
   int GetBranchFactor()
   {
     return this->BranchFactor;
@@ -847,6 +629,8 @@ protected:
   // The tree as only one node and one leaf: the root.
   vtkCompactHyperTree()
   {
+    this->NumberOfChildren = N;
+
     // Set tree parameters depending on template parameter value
     switch ( N )
       {
@@ -889,16 +673,9 @@ protected:
   int Dimension;
   double Scale[3];
   vtkIdType NumberOfLevels;
-  vtkIdType NumberOfNodes;
 
   vtkIdType GlobalIndexStart;
 
-  // Storage for non-leaf tree nodes
-  std::vector<vtkCompactHyperTreeNode<N> > Nodes;
-
-  // Storage to record the parent of each leaf
-  std::vector<vtkIdType> LeafParent;
-
   // Storage to record the local to global id mapping
   std::vector<vtkIdType> GlobalIndexTable;
 
@@ -947,43 +724,110 @@ vtkHyperTree* vtkHyperTree::CreateInstance( unsigned int factor,
 }
 
 //-----------------------------------------------------------------------------
-void vtkHyperTree::FindChildParameters( int child, vtkIdType& index, bool& isLeaf )
+void vtkHyperTree::InitializeRefinement()
 {
-#define GetNodeParametersMacro( _N_ )                                              \
-  {                                                                                \
-  vtkCompactHyperTree<_N_>* tree = static_cast<vtkCompactHyperTree<_N_>*>( this ); \
-  vtkCompactHyperTreeNode<_N_>* node = tree->GetNode( static_cast<int>(index) );   \
-  index = static_cast<vtkIdType>(node->GetChild( child ));                         \
-  isLeaf = node->IsChildLeaf( child );                                             \
-  return;                                                                          \
-  }
+  this->NumberOfBlocks = 0;
+  this->Squeezed = false;
+  this->ChildBlock.assign( 1, -1 );
+  std::vector<vtkTypeUInt64>().swap( this->RefinedBits );
+  std::vector<vtkIdType>().swap( this->RefinedRank );
+  std::vector<int>().swap( this->RankToBlock );
+}
 
-  switch ( this->GetDimension() )
+//-----------------------------------------------------------------------------
+vtkIdType vtkHyperTree::RefineIndex( vtkIdType index )
+{
+  if ( this->Squeezed )
     {
-    case 3:
-      switch ( this->GetBranchFactor() )
-        {
-        case 2: GetNodeParametersMacro( 8 );
-        case 3: GetNodeParametersMacro( 27 );
-        } // case 3
-      break;
-    case 2:
-      switch ( this->GetBranchFactor() )
-        {
-        case 2: GetNodeParametersMacro( 4 );
-        case 3: GetNodeParametersMacro( 9 );
-        } // case 2
-      break;
-    case 1:
-      switch ( this->GetBranchFactor() )
+    this->ExpandRefinement();
+    }
+  assert( "pre: is_a_leaf" && this->ChildBlock[index] < 0 );
+
+  int block = static_cast<int>( this->NumberOfBlocks ++ );
+  this->ChildBlock[index] = block;
+  this->ChildBlock.resize( this->ChildBlock.size() + this->NumberOfChildren,
+                           -1 );
+  return 1 + static_cast<vtkIdType>( block ) * this->NumberOfChildren;
+}
+
+//-----------------------------------------------------------------------------
+void vtkHyperTree::Squeeze()
+{
+  if ( this->Squeezed )
+    {
+    return;
+    }
+
+  vtkIdType numberOfIndex = static_cast<vtkIdType>( this->ChildBlock.size() );
+  vtkIdType numberOfWords = ( numberOfIndex + 63 ) >> 6;
+  std::vector<vtkTypeUInt64> bits( numberOfWords, 0 );
+  std::vector<vtkIdType> ranks( numberOfWords );
+  std::vector<int> rankToBlock;
+  rankToBlock.reserve( this->NumberOfBlocks );
+
+  // Blocks allocated in index order need no table
+  bool breadthFirst = true;
+  vtkIdType rank = 0;
+  for ( vtkIdType w = 0; w < numberOfWords; ++ w )
+    {
+    ranks[w] = rank;
+    vtkIdType end = ( w + 1 ) << 6;
+    if ( end > numberOfIndex )
+      {
+      end = numberOfIndex;
+      }
+    for ( vtkIdType i = w << 6; i < end; ++ i )
+      {
+      int block = this->ChildBlock[i];
+      if ( block >= 0 )
         {
-        case 2: GetNodeParametersMacro( 2 );
-        case 3: GetNodeParametersMacro( 3 );
-        } // case 1
-      break;
+        bits[w] |= static_cast<vtkTypeUInt64>( 1 ) << ( i & 63 );
+        breadthFirst = breadthFirst && block == rank;
+        rankToBlock.push_back( block );
+        ++ rank;
+        }
+      }
     }
 
-#undef GetNodeParametersMacro
+  this->RefinedBits.swap( bits );
+  this->RefinedRank.swap( ranks );
+  if ( ! breadthFirst )
+    {
+    this->RankToBlock.swap( rankToBlock );
+    }
+  std::vector<int>().swap( this->ChildBlock );
+  this->Squeezed = true;
+}
 
-  vtkGenericWarningMacro( "Bad branching factor " << this->GetBranchFactor() );
+//-----------------------------------------------------------------------------
+void vtkHyperTree::ExpandRefinement()
+{
+  vtkIdType numberOfIndex = 1 + this->NumberOfBlocks * this->NumberOfChildren;
+  std::vector<int> childBlock( numberOfIndex, -1 );
+  vtkIdType rank = 0;
+  for ( vtkIdType i = 0; i < numberOfIndex; ++ i )
+    {
+    if ( this->RefinedBits[i >> 6]
+         & ( static_cast<vtkTypeUInt64>( 1 ) << ( i & 63 ) ) )
+      {
+      childBlock[i] = this->RankToBlock.empty() ?
+        static_cast<int>( rank ) : this->RankToBlock[rank];
+      ++ rank;
+      }
+    }
+
+  this->ChildBlock.swap( childBlock );
+  std::vector<vtkTypeUInt64>().swap( this->RefinedBits );
+  std::vector<vtkIdType>().swap( this->RefinedRank );
+  std::vector<int>().swap( this->RankToBlock );
+  this->Squeezed = false;
+}
+
+//-----------------------------------------------------------------------------
+size_t vtkHyperTree::GetRefinementMemorySize()
+{
+  return sizeof(int) * this->ChildBlock.capacity() +
+    sizeof(vtkTypeUInt64) * this->RefinedBits.capacity() +
+    sizeof(vtkIdType) * this->RefinedRank.capacity() +
+    sizeof(int) * this->RankToBlock.capacity();
 }
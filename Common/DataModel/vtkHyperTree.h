@@ -48,7 +48,17 @@
 // dataset.
 //
 // This is an abstract class used as a superclass by a templated compact class.
-// All methods are pure virtual. This is done to hide templates.
+// Most methods are pure virtual. This is done to hide templates.
+// The refinement of the tree does not depend on the template parameter and
+// is stored here, so that cursors can walk the tree without virtual calls.
+// Each subdivision appends a block of 2^n or 3^n consecutive indices: block
+// b holds the children of one node at indices 1+b*N to (b+1)*N, index 0
+// being the root. Nodes and leaves therefore share the same index space,
+// which is also the one used for the attributes.
+// While the tree is built, the block of each index is stored in a plain
+// array. Squeeze() packs it into one bit per index flagging refined nodes,
+// with a rank table per 64 indices and, unless blocks were allocated in
+// index (breadth-first) order, the block of each refined node.
 //
 // .SECTION Case with 2^n children
 // * 3D case (octree)
@@ -122,6 +132,8 @@
 #include "vtkCommonDataModelModule.h" // For export macro
 #include "vtkObject.h"
 
+#include <vector> // For the refinement storage
+
 class vtkHyperTreeCursor;
 
 class VTKCOMMONDATAMODEL_EXPORT vtkHyperTree : public vtkObject
@@ -164,9 +176,50 @@ public:
                                        unsigned int dimension );
 
   // Description:
-  // Find the Index, Parent Index and IsLeaf() parameters of a child for hypertree.
-  // This is done to hide templates.
-  virtual void FindChildParameters( int, vtkIdType&, bool& );
+  // Return the index of the first child of the node at `index', or -1 when
+  // it is a leaf. The other children follow consecutively.
+  vtkIdType GetFirstChildIndex( vtkIdType index )
+  {
+    vtkIdType block;
+    if ( ! this->Squeezed )
+      {
+      block = this->ChildBlock[index];
+      }
+    else
+      {
+      vtkTypeUInt64 word = this->RefinedBits[index >> 6];
+      vtkTypeUInt64 bit = static_cast<vtkTypeUInt64>( 1 ) << ( index & 63 );
+      if ( ! ( word & bit ) )
+        {
+        return -1;
+        }
+      vtkIdType rank = this->RefinedRank[index >> 6]
+        + vtkHyperTree::CountBits( word & ( bit - 1 ) );
+      block = this->RankToBlock.empty() ? rank : this->RankToBlock[rank];
+      }
+    return block < 0 ? -1 : 1 + block * this->NumberOfChildren;
+  }
+
+  // Description:
+  // Is the node at `index' a leaf?
+  bool IsLeafIndex( vtkIdType index )
+  {
+    return this->GetFirstChildIndex( index ) < 0;
+  }
+
+  // Description:
+  // Replace index, which must be a node, by the index of its child-th
+  // child and tell whether this child is a leaf.
+  void FindChildParameters( int child, vtkIdType& index, bool& isLeaf )
+  {
+    index = this->GetFirstChildIndex( index ) + child;
+    isLeaf = this->IsLeafIndex( index );
+  }
+
+  // Description:
+  // Switch to the compressed refinement storage and release unused memory.
+  // Subdividing a leaf of a squeezed tree first expands the storage again.
+  virtual void Squeeze();
 
   // Description:
   // Set the start global index for the current tree.
@@ -185,8 +238,55 @@ public:
 protected:
   vtkHyperTree()
   {
+    this->NumberOfChildren = 0;
+    this->NumberOfBlocks = 0;
+    this->Squeezed = false;
+  }
+
+  // Description:
+  // Reset the refinement to a single leaf, the root.
+  void InitializeRefinement();
+
+  // Description:
+  // Go back from the squeezed to the plain refinement storage.
+  void ExpandRefinement();
+
+  // Description:
+  // Record that the leaf at `index' is now a node and return the index of
+  // its first child.
+  vtkIdType RefineIndex( vtkIdType index );
+
+  // Description:
+  // Memory used by the refinement storage, in bytes.
+  size_t GetRefinementMemorySize();
+
+  static int CountBits( vtkTypeUInt64 w )
+  {
+    w = w - ( ( w >> 1 ) & 0x5555555555555555ULL );
+    w = ( w & 0x3333333333333333ULL ) + ( ( w >> 2 ) & 0x3333333333333333ULL );
+    w = ( w + ( w >> 4 ) ) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<int>( ( w * 0x0101010101010101ULL ) >> 56 );
   }
 
+  // Number of children of each node (2^n or 3^n).
+  int NumberOfChildren;
+
+  // Number of blocks of children, i.e. number of nodes that are not leaves.
+  vtkIdType NumberOfBlocks;
+
+  // True when the refinement uses the compressed storage.
+  bool Squeezed;
+
+  // Plain storage: block of the children of each index, -1 for leaves.
+  std::vector<int> ChildBlock;
+
+  // Squeezed storage: one bit per index set for nodes, number of bits set
+  // before each 64 bit word, and block of the children of each node in
+  // index order (empty when the i-th node owns the i-th block).
+  std::vector<vtkTypeUInt64> RefinedBits;
+  std::vector<vtkIdType> RefinedRank;
+  std::vector<int> RankToBlock;
+
 private:
   vtkHyperTree(const vtkHyperTree&);  // Not implemented.
   void operator=(const vtkHyperTree&);    // Not implemented.
@@ -56,10 +56,17 @@ vtkCxxSetObjectMacro( vtkHyperTreeGrid, YCoordinates, vtkDataArray );
 vtkCxxSetObjectMacro( vtkHyperTreeGrid, ZCoordinates, vtkDataArray );
 
 // Helpers to quickly fetch a HT at a given index or iterator
+// A single lookup which, unlike operator[], is safe to call from
+// several threads at once.
+static inline vtkHyperTree* vtkHyperTreeGridFindTree(
+  std::map<vtkIdType, vtkHyperTree*>& trees, vtkIdType index )
+{
+  std::map<vtkIdType, vtkHyperTree*>::iterator it = trees.find( index );
+  return it != trees.end() ? it->second : 0;
+}
+
 #define GetHTGHyperTreeAtIndexMacro( _obj_, _index_ )             \
-  ( static_cast<vtkHyperTree*>(                                   \
-  _obj_->HyperTrees.find( _index_ ) != _obj_->HyperTrees.end() ?  \
-  _obj_->HyperTrees[ _index_ ] : 0 ) )
+  ( vtkHyperTreeGridFindTree( _obj_->HyperTrees, _index_ ) )
 
 #define GetHyperTreeAtIndexMacro( _index_ ) \
   GetHTGHyperTreeAtIndexMacro( this, _index_ )
@@ -958,6 +965,19 @@ vtkIdType vtkHyperTreeGrid::FindCell( double x[3], vtkCell* cell,
   return this->FindCell( x, cell, NULL, cellId, tol2, subId, pcoords, weights );
 }
 
+//----------------------------------------------------------------------------
+void vtkHyperTreeGrid::Squeeze()
+{
+  this->Superclass::Squeeze();
+
+  vtkHyperTreeIterator it;
+  this->InitializeTreeIterator( it );
+  while ( vtkHyperTree* tree = it.GetNextTree() )
+    {
+    tree->Squeeze();
+    }
+}
+
 //----------------------------------------------------------------------------
 unsigned long vtkHyperTreeGrid::GetActualMemorySize()
 {
@@ -1923,7 +1943,7 @@ void vtkHyperTreeGrid::vtkHyperTreeSimpleCursor::ToRoot()
   this->Level = 0;
   this->Index = 0;
 
-  this->Leaf = ( this->Tree->GetNumberOfLeaves() == 1 );
+  this->Leaf = this->Tree->IsLeafIndex( 0 );
 }
 
 //-----------------------------------------------------------------------------
@@ -305,6 +305,11 @@ public:
   void ShallowCopy( vtkDataObject* );
   void DeepCopy( vtkDataObject* );
 
+  // Description:
+  // Reclaim memory: switch the trees to their compressed refinement
+  // storage. Subdividing a leaf afterwards expands the tree it belongs to.
+  virtual void Squeeze();
+
   // Description:
   // Structured extent. The extent type is a 3D extent
   int GetExtentType() { return VTK_3D_EXTENT; }
@@ -14,8 +14,10 @@
 =========================================================================*/
 #include "vtkImplicitBoolean.h"
 
+#include "vtkDoubleArray.h"
 #include "vtkImplicitFunctionCollection.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
 
 #include <math.h>
 
@@ -146,6 +148,149 @@ double vtkImplicitBoolean::EvaluateFunction(double x[3])
   return value;
 }
 
+namespace {
+// Folds the values of one function of the list into the combined values.
+class vtkImplicitBooleanCombine
+{
+public:
+  double *Result;
+  const double *Values;
+  int OperationType;
+  bool First;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    double *r = this->Result + begin;
+    const double *v = this->Values + begin;
+    vtkIdType i, num = end - begin;
+    if ( this->First )
+      {
+      if ( this->OperationType == vtkImplicitBoolean::VTK_UNION_OF_MAGNITUDES )
+        {
+        for (i=0; i < num; i++)
+          {
+          r[i] = fabs(v[i]);
+          }
+        }
+      else
+        {
+        for (i=0; i < num; i++)
+          {
+          r[i] = v[i];
+          }
+        }
+      return;
+      }
+
+    switch ( this->OperationType )
+      {
+      case vtkImplicitBoolean::VTK_UNION: //take minimum value
+        for (i=0; i < num; i++)
+          {
+          r[i] = ( v[i] < r[i] ? v[i] : r[i] );
+          }
+        break;
+      case vtkImplicitBoolean::VTK_INTERSECTION: //take maximum value
+        for (i=0; i < num; i++)
+          {
+          r[i] = ( v[i] > r[i] ? v[i] : r[i] );
+          }
+        break;
+      case vtkImplicitBoolean::VTK_UNION_OF_MAGNITUDES: //minimum absolute value
+        for (i=0; i < num; i++)
+          {
+          r[i] = ( fabs(v[i]) < r[i] ? fabs(v[i]) : r[i] );
+          }
+        break;
+      default: //difference
+        for (i=0; i < num; i++)
+          {
+          r[i] = ( -v[i] > r[i] ? -v[i] : r[i] );
+          }
+      }
+    }
+};
+}
+
+// Evaluate boolean combinations of functions for all the points of input.
+void vtkImplicitBoolean::EvaluateFunctionBatch(vtkDataArray* input,
+                                               vtkDataArray* output)
+{
+  vtkIdType i, numPts = input->GetNumberOfTuples();
+  output->SetNumberOfComponents(1);
+  output->SetNumberOfTuples(numPts);
+  if ( numPts < 1 )
+    {
+    return;
+    }
+
+  if (this->FunctionList->GetNumberOfItems() == 0)
+    {
+    output->FillComponent(0, 0.0);
+    return;
+    }
+
+  // Combine directly into the output when it is a plain double array.
+  vtkDoubleArray *result = NULL;
+  if ( output->GetDataType() == VTK_DOUBLE && output->HasStandardMemoryLayout() )
+    {
+    result = static_cast<vtkDoubleArray*>(output);
+    result->Register(this);
+    }
+  else
+    {
+    result = vtkDoubleArray::New();
+    result->SetNumberOfTuples(numPts);
+    }
+  vtkDoubleArray *values = vtkDoubleArray::New();
+
+  vtkImplicitBooleanCombine combine;
+  combine.Result = result->GetPointer(0);
+  combine.OperationType = this->OperationType;
+  combine.First = true;
+
+  vtkImplicitFunction *f, *firstF = NULL;
+  vtkCollectionSimpleIterator sit;
+  for (this->FunctionList->InitTraversal(sit);
+       (f=this->FunctionList->GetNextImplicitFunction(sit)); )
+    {
+    if ( firstF == NULL )
+      {
+      firstF = f;
+      }
+    else if ( f == firstF && this->OperationType == VTK_DIFFERENCE )
+      {
+      continue;
+      }
+    f->FunctionValue(input, values);
+    combine.Values = values->GetPointer(0);
+    vtkSMPTools::For(0, numPts, combine);
+    combine.First = false;
+    }
+  values->Delete();
+
+  if ( result != output )
+    {
+    const double *r = result->GetPointer(0);
+    if ( output->GetDataType() == VTK_FLOAT && output->HasStandardMemoryLayout() )
+      {
+      float *o = static_cast<float*>(output->GetVoidPointer(0));
+      for (i=0; i < numPts; i++)
+        {
+        o[i] = static_cast<float>(r[i]);
+        }
+      }
+    else
+      {
+      for (i=0; i < numPts; i++)
+        {
+        output->SetComponent(i, 0, r[i]);
+        }
+      }
+    }
+  result->UnRegister(this);
+}
+
 // Evaluate gradient of boolean combination.
 void vtkImplicitBoolean::EvaluateGradient(double x[3], double g[3])
 {
@@ -61,6 +61,13 @@ public:
   double EvaluateFunction(double x, double y, double z)
     {return this->vtkImplicitFunction::EvaluateFunction(x, y, z); } ;
 
+  // Description:
+  // Evaluate the boolean combination at all the points of input. Each
+  // function of the list is evaluated over the whole array (using its own
+  // batch implementation, so nested booleans stay vectorized) and the
+  // results are combined in one multithreaded pass.
+  void EvaluateFunctionBatch(vtkDataArray* input, vtkDataArray* output);
+
   // Description:
   // Evaluate gradient of boolean combination.
   void EvaluateGradient(double x[3], double g[3]);
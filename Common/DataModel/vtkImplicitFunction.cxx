@@ -16,6 +16,9 @@
 
 #include "vtkMath.h"
 #include "vtkAbstractTransform.h"
+#include "vtkImplicitFunctionBatch.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
 #include "vtkTransform.h"
 
 vtkCxxSetObjectMacro(vtkImplicitFunction,Transform,vtkAbstractTransform);
@@ -72,6 +75,59 @@ double vtkImplicitFunction::FunctionValue(const double x[3])
   */
 }
 
+namespace {
+// Per point evaluation through the virtual EvaluateFunction(). Subclasses are
+// not required to be thread safe, so this is never run threaded.
+class vtkImplicitFunctionVirtualEvaluator
+{
+public:
+  vtkImplicitFunction *Function;
+  double operator()(const double x[3]) const
+    {
+    return this->Function->EvaluateFunction(const_cast<double *>(x));
+    }
+};
+}
+
+// Evaluate function at all the points of input. Points are transformed
+// through transform (if provided).
+void vtkImplicitFunction::FunctionValue(vtkDataArray* input,
+                                        vtkDataArray* output)
+{
+  if ( !input || !output )
+    {
+    return;
+    }
+  if ( input->GetNumberOfComponents() != 3 )
+    {
+    vtkErrorMacro(<<"Input array must have 3 components, not "
+                  << input->GetNumberOfComponents());
+    return;
+    }
+
+  if ( ! this->Transform )
+    {
+    this->EvaluateFunctionBatch(input, output);
+    }
+  else //pass all points through transform at once
+    {
+    vtkNew<vtkPoints> inPts;
+    inPts->SetData(input);
+    vtkNew<vtkPoints> outPts;
+    outPts->SetDataTypeToDouble();
+    this->Transform->TransformPoints(inPts.GetPointer(), outPts.GetPointer());
+    this->EvaluateFunctionBatch(outPts->GetData(), output);
+    }
+}
+
+void vtkImplicitFunction::EvaluateFunctionBatch(vtkDataArray* input,
+                                                vtkDataArray* output)
+{
+  vtkImplicitFunctionVirtualEvaluator f;
+  f.Function = this;
+  vtkImplicitFunctionBatchEvaluate(f, input, output, false);
+}
+
 // Evaluate function gradient at position x-y-z and pass back vector. Point
 // x[3] is transformed through transform (if provided).
 void vtkImplicitFunction::FunctionGradient(const double x[3], double g[3])
@@ -51,6 +51,7 @@
 #include "vtkObject.h"
 
 class vtkAbstractTransform;
+class vtkDataArray;
 
 class VTKCOMMONDATAMODEL_EXPORT vtkImplicitFunction : public vtkObject
 {
@@ -70,6 +71,13 @@ public:
   double FunctionValue(double x, double y, double z) {
     double xyz[3] = {x, y, z}; return this->FunctionValue(xyz); };
 
+  // Description:
+  // Evaluate function at all the points of input, a three component array,
+  // and store the values in output. Output is resized to a single component
+  // array with one tuple per input point. The points are transformed through
+  // transform (if provided) in one pass before evaluation.
+  void FunctionValue(vtkDataArray* input, vtkDataArray* output);
+
   // Description:
   // Evaluate function gradient at position x-y-z and pass back vector. Point
   // x[3] is transformed through transform (if provided).
@@ -96,6 +104,16 @@ public:
   double EvaluateFunction(double x, double y, double z) {
     double xyz[3] = {x, y, z}; return this->EvaluateFunction(xyz); };
 
+  // Description:
+  // Evaluate function at all the points of input and store the values in
+  // output, see FunctionValue(vtkDataArray*, vtkDataArray*). You should
+  // generally not call this method directly, you should use FunctionValue()
+  // instead. The default implementation calls EvaluateFunction() for each
+  // point; subclasses with a closed form override it with an inlined,
+  // multithreaded loop.
+  virtual void EvaluateFunctionBatch(vtkDataArray* input,
+                                     vtkDataArray* output);
+
   // Description:
   // Evaluate function gradient at position x-y-z and pass back vector.
   // You should generally not call this method directly, you should use
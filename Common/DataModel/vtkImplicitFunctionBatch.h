@@ -0,0 +1,171 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkImplicitFunctionBatch.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkImplicitFunctionBatch - evaluate an implicit function over an
+// array of points (template implementation)
+
+// .SECTION Description
+// vtkImplicitFunctionBatchEvaluate() is the helper used by vtkImplicitFunction
+// and its subclasses to implement EvaluateFunctionBatch(vtkDataArray*,
+// vtkDataArray*). It is templated over a functor providing
+// "double operator()(const double x[3]) const" which, for the analytic
+// functions, is a small inlined expression instead of a virtual call per
+// point. Float and double arrays with the standard memory layout are
+// accessed through raw pointers, other arrays through the generic
+// vtkDataArray tuple API. When threaded is true the evaluation is split
+// over the points with vtkSMPTools, the functor must then be safe to
+// call concurrently.
+
+// .SECTION See Also
+// vtkImplicitFunction
+
+#ifndef vtkImplicitFunctionBatch_h
+#define vtkImplicitFunctionBatch_h
+
+#include "vtkDataArray.h"
+#include "vtkSMPTools.h"
+
+// Evaluate the functor over raw input/output pointers.
+template <class TFunctor, class TIn, class TOut>
+class vtkImplicitFunctionBatchOp
+{
+public:
+  const TFunctor *Function;
+  const TIn *Points;
+  TOut *Values;
+
+  vtkImplicitFunctionBatchOp(const TFunctor *f, const TIn *pts, TOut *values) :
+    Function(f), Points(pts), Values(values) {}
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    const TIn *p = this->Points + 3*begin;
+    TOut *v = this->Values + begin;
+    double x[3];
+    for ( vtkIdType i=begin; i < end; ++i, p+=3 )
+      {
+      x[0] = static_cast<double>(p[0]);
+      x[1] = static_cast<double>(p[1]);
+      x[2] = static_cast<double>(p[2]);
+      *v++ = static_cast<TOut>((*this->Function)(x));
+      }
+    }
+};
+
+// Evaluate the functor through the vtkDataArray API.
+template <class TFunctor>
+class vtkImplicitFunctionBatchGenericOp
+{
+public:
+  const TFunctor *Function;
+  vtkDataArray *Points;
+  vtkDataArray *Values;
+
+  vtkImplicitFunctionBatchGenericOp(const TFunctor *f, vtkDataArray *pts,
+                                    vtkDataArray *values) :
+    Function(f), Points(pts), Values(values) {}
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    double x[3];
+    for ( vtkIdType i=begin; i < end; ++i )
+      {
+      this->Points->GetTuple(i, x);
+      this->Values->SetComponent(i, 0, (*this->Function)(x));
+      }
+    }
+};
+
+template <class TFunctor, class TIn, class TOut>
+void vtkImplicitFunctionBatchExecute(const TFunctor &f, const TIn *pts,
+                                     TOut *values, vtkIdType numPts,
+                                     bool threaded)
+{
+  vtkImplicitFunctionBatchOp<TFunctor,TIn,TOut> op(&f, pts, values);
+  if ( threaded )
+    {
+    vtkSMPTools::For(0, numPts, op);
+    }
+  else
+    {
+    op(0, numPts);
+    }
+}
+
+template <class TFunctor, class TIn>
+bool vtkImplicitFunctionBatchDispatchOutput(const TFunctor &f, const TIn *pts,
+                                            vtkDataArray *output,
+                                            vtkIdType numPts, bool threaded)
+{
+  switch ( output->GetDataType() )
+    {
+    case VTK_FLOAT:
+      vtkImplicitFunctionBatchExecute(f, pts,
+        static_cast<float*>(output->GetVoidPointer(0)), numPts, threaded);
+      return true;
+    case VTK_DOUBLE:
+      vtkImplicitFunctionBatchExecute(f, pts,
+        static_cast<double*>(output->GetVoidPointer(0)), numPts, threaded);
+      return true;
+    default:
+      return false;
+    }
+}
+
+// Description:
+// Evaluate f at every tuple of input (which must have three components)
+// and store the result in output, which is resized to a single component
+// array with as many tuples as input.
+template <class TFunctor>
+void vtkImplicitFunctionBatchEvaluate(const TFunctor &f, vtkDataArray *input,
+                                      vtkDataArray *output, bool threaded)
+{
+  vtkIdType numPts = input->GetNumberOfTuples();
+  output->SetNumberOfComponents(1);
+  output->SetNumberOfTuples(numPts);
+  if ( numPts < 1 )
+    {
+    return;
+    }
+
+  if ( input->HasStandardMemoryLayout() && output->HasStandardMemoryLayout() )
+    {
+    switch ( input->GetDataType() )
+      {
+      case VTK_FLOAT:
+        if ( vtkImplicitFunctionBatchDispatchOutput(f,
+               static_cast<const float*>(input->GetVoidPointer(0)),
+               output, numPts, threaded) )
+          {
+          return;
+          }
+        break;
+      case VTK_DOUBLE:
+        if ( vtkImplicitFunctionBatchDispatchOutput(f,
+               static_cast<const double*>(input->GetVoidPointer(0)),
+               output, numPts, threaded) )
+          {
+          return;
+          }
+        break;
+      }
+    }
+
+  // Writing through the generic API is not guaranteed to be thread safe.
+  vtkImplicitFunctionBatchGenericOp<TFunctor> op(&f, input, output);
+  op(0, numPts);
+}
+
+#endif
+// VTK-HeaderTest-Exclude: vtkImplicitFunctionBatch.h
@@ -52,6 +52,7 @@ vtkIdType vtkMutableDirectedGraph::SetNumberOfVertices( vtkIdType numVerts )
     return retval;
     }
 
+  this->ForceOwnership();
   retval = static_cast<vtkIdType>( this->Internals->Adjacency.size() );
   this->Internals->Adjacency.resize( numVerts );
   return retval;
@@ -14,6 +14,7 @@
 =========================================================================*/
 #include "vtkPlane.h"
 #include "vtkMath.h"
+#include "vtkImplicitFunctionBatch.h"
 #include "vtkObjectFactory.h"
 
 vtkStandardNewMacro(vtkPlane);
@@ -134,6 +135,34 @@ double vtkPlane::EvaluateFunction(double x[3])
            this->Normal[2]*(x[2]-this->Origin[2]) );
 }
 
+namespace {
+class vtkPlaneEvaluator
+{
+public:
+  double Normal[3];
+  double Origin[3];
+  double operator()(const double x[3]) const
+    {
+    return ( this->Normal[0]*(x[0]-this->Origin[0]) +
+             this->Normal[1]*(x[1]-this->Origin[1]) +
+             this->Normal[2]*(x[2]-this->Origin[2]) );
+    }
+};
+}
+
+// Evaluate plane equation for all the points of input.
+void vtkPlane::EvaluateFunctionBatch(vtkDataArray* input,
+                                     vtkDataArray* output)
+{
+  vtkPlaneEvaluator f;
+  for (int i=0; i<3; i++)
+    {
+    f.Normal[i] = this->Normal[i];
+    f.Origin[i] = this->Origin[i];
+    }
+  vtkImplicitFunctionBatchEvaluate(f, input, output, true);
+}
+
 // Evaluate function gradient at point x[3].
 void vtkPlane::EvaluateGradient(double vtkNotUsed(x)[3], double n[3])
 {
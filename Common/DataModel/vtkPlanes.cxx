@@ -15,11 +15,13 @@
 #include "vtkPlanes.h"
 
 #include "vtkDoubleArray.h"
+#include "vtkImplicitFunctionBatch.h"
 #include "vtkObjectFactory.h"
 #include "vtkPlane.h"
 #include "vtkPoints.h"
 
 #include <math.h>
+#include <vector>
 
 vtkStandardNewMacro(vtkPlanes);
 vtkCxxSetObjectMacro(vtkPlanes,Points,vtkPoints);
@@ -108,6 +110,68 @@ double vtkPlanes::EvaluateFunction(double x[3])
   return maxVal;
 }
 
+namespace {
+// Planes are gathered in a flat (normal, point) table before evaluation since
+// the vtkDataArray accessors are not safe to use concurrently.
+class vtkPlanesEvaluator
+{
+public:
+  const double *Planes;
+  vtkIdType NumberOfPlanes;
+  double operator()(const double x[3]) const
+    {
+    double val, maxVal = -VTK_DOUBLE_MAX;
+    const double *p = this->Planes;
+    for (vtkIdType i=0; i < this->NumberOfPlanes; i++, p+=6)
+      {
+      val = p[0]*(x[0]-p[3]) + p[1]*(x[1]-p[4]) + p[2]*(x[2]-p[5]);
+      if (val > maxVal )
+        {
+        maxVal = val;
+        }
+      }
+    return maxVal;
+    }
+};
+}
+
+// Evaluate plane equations for all the points of input.
+void vtkPlanes::EvaluateFunctionBatch(vtkDataArray* input,
+                                      vtkDataArray* output)
+{
+  vtkIdType numPlanes;
+
+  if ( !this->Points || ! this->Normals )
+    {
+    vtkErrorMacro(<<"Please define points and/or normals!");
+    output->SetNumberOfComponents(1);
+    output->SetNumberOfTuples(input->GetNumberOfTuples());
+    output->FillComponent(0, VTK_DOUBLE_MAX);
+    return;
+    }
+
+  if ( (numPlanes=this->Points->GetNumberOfPoints()) != this->Normals->GetNumberOfTuples() )
+    {
+    vtkErrorMacro(<<"Number of normals/points inconsistent!");
+    output->SetNumberOfComponents(1);
+    output->SetNumberOfTuples(input->GetNumberOfTuples());
+    output->FillComponent(0, VTK_DOUBLE_MAX);
+    return;
+    }
+
+  std::vector<double> planes(6*numPlanes);
+  for (vtkIdType i=0; i < numPlanes; i++)
+    {
+    this->Normals->GetTuple(i, &planes[6*i]);
+    this->Points->GetPoint(i, &planes[6*i+3]);
+    }
+
+  vtkPlanesEvaluator f;
+  f.Planes = planes.empty() ? NULL : &planes[0];
+  f.NumberOfPlanes = numPlanes;
+  vtkImplicitFunctionBatchEvaluate(f, input, output, true);
+}
+
 // Evaluate planes gradient.
 void vtkPlanes::EvaluateGradient(double x[3], double n[3])
 {
@@ -55,6 +55,11 @@ public:
   double EvaluateFunction(double x, double y, double z)
     {return this->vtkImplicitFunction::EvaluateFunction(x, y, z); } ;
 
+  // Description:
+  // Evaluate the function at all the points of input in one multithreaded
+  // pass, see vtkImplicitFunction::FunctionValue(vtkDataArray*, vtkDataArray*).
+  void EvaluateFunctionBatch(vtkDataArray* input, vtkDataArray* output);
+
   // Description
   // Evaluate planes gradient.
   void EvaluateGradient(double x[3], double n[3]);
@@ -14,6 +14,7 @@
 =========================================================================*/
 #include "vtkSphere.h"
 #include "vtkMath.h"
+#include "vtkImplicitFunctionBatch.h"
 #include "vtkObjectFactory.h"
 
 vtkStandardNewMacro(vtkSphere);
@@ -39,6 +40,36 @@ double vtkSphere::EvaluateFunction(double x[3])
            this->Radius*this->Radius );
 }
 
+//----------------------------------------------------------------------------
+namespace {
+class vtkSphereEvaluator
+{
+public:
+  double Center[3];
+  double Radius2;
+  double operator()(const double x[3]) const
+    {
+    return ( ((x[0] - this->Center[0]) * (x[0] - this->Center[0]) +
+              (x[1] - this->Center[1]) * (x[1] - this->Center[1]) +
+              (x[2] - this->Center[2]) * (x[2] - this->Center[2])) -
+             this->Radius2 );
+    }
+};
+}
+
+//----------------------------------------------------------------------------
+// Evaluate sphere equation for all the points of input.
+void vtkSphere::EvaluateFunctionBatch(vtkDataArray* input,
+                                      vtkDataArray* output)
+{
+  vtkSphereEvaluator f;
+  f.Center[0] = this->Center[0];
+  f.Center[1] = this->Center[1];
+  f.Center[2] = this->Center[2];
+  f.Radius2 = this->Radius*this->Radius;
+  vtkImplicitFunctionBatchEvaluate(f, input, output, true);
+}
+
 //----------------------------------------------------------------------------
 // Evaluate sphere gradient.
 void vtkSphere::EvaluateGradient(double x[3], double n[3])
@@ -227,19 +227,22 @@ BuildLinks(vtkPolyData *pd)
   const vtkIdType *cell;
 
   // Visit the four arrays
-  for ( CellId=0, j=0; j < 4; ++j )
+  for ( j=0; j < 4; ++j )
     {
     // Count number of point uses
+    if ( numCells[j] < 1 )
+      {
+      continue;
+      }
     cell = cellArrays[j]->GetPointer();
     for ( cellId=0; cellId < numCells[j]; ++cellId )
       {
       npts = *cell++;
       for (i=0; i<npts; ++i)
         {
-        this->Offsets[CellId+(*cell++)]++;
+        this->Offsets[*cell++]++;
         }
       }
-    CellId += numCells[j];
     } //for each of the four polydata cell arrays
 
   // Perform prefix sum
@@ -255,6 +258,10 @@ BuildLinks(vtkPolyData *pd)
   // points to the beginning of each cell run.
   for ( CellId=0, j=0; j < 4; ++j )
     {
+    if ( numCells[j] < 1 )
+      {
+      continue;
+      }
     cell = cellArrays[j]->GetPointer();
     for ( cellId=0; cellId < numCells[j]; ++cellId )
       {
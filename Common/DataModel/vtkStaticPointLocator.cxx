@@ -469,6 +469,7 @@ public:
   void FindClosestNPoints(int N, const double x[3], vtkIdList *result);
   void FindPointsWithinRadius(double R, const double x[3], vtkIdList *result);
   void GenerateRepresentation(int vtkNotUsed(level), vtkPolyData *pd);
+  void MergePoints(double tol, vtkIdType *mergeMap);
 
   // Internal methods
   void GetOverlappingBuckets(NeighborBuckets* buckets, const double x[3],
@@ -599,6 +600,65 @@ public:
         }//operator()
   };
 
+  // Merge exactly coincident points. Coincident points always fall in the
+  // same bucket, so each thread works on its own range of buckets and maps
+  // every run of coincident points to its lowest id.
+  template <typename T>
+  class MergeCoincident
+    {
+    public:
+      BucketList<T> *BList;
+      vtkIdType *MergeMap;
+
+      MergeCoincident(BucketList<T> *blist, vtkIdType *mergeMap) :
+        BList(blist), MergeMap(mergeMap)
+        {
+        }
+
+      void  operator()(vtkIdType bucket, vtkIdType end)
+        {
+        double p[3], q[3];
+        vtkIdType *mergeMap = this->MergeMap;
+        vtkDataSet *ds = this->BList->DataSet;
+        for ( ; bucket < end; ++bucket )
+          {
+          vtkIdType numIds = this->BList->GetNumberOfIds(bucket);
+          const LocatorTuple<T> *ids = this->BList->GetIds(bucket);
+          for (vtkIdType i=0; i < numIds; ++i)
+            {
+            vtkIdType ptId = ids[i].PtId;
+            if ( mergeMap[ptId] >= 0 )
+              {
+              continue; //already merged with an earlier point of the bucket
+              }
+            ds->GetPoint(ptId, p);
+            vtkIdType minId = ptId;
+            for (vtkIdType j=i+1; j < numIds; ++j)
+              {
+              vtkIdType id = ids[j].PtId;
+              ds->GetPoint(id, q);
+              if ( mergeMap[id] < 0 && p[0] == q[0] && p[1] == q[1] &&
+                   p[2] == q[2] )
+                {
+                minId = (id < minId ? id : minId);
+                }
+              }
+            mergeMap[ptId] = minId;
+            for (vtkIdType j=i+1; j < numIds; ++j)
+              {
+              vtkIdType id = ids[j].PtId;
+              ds->GetPoint(id, q);
+              if ( mergeMap[id] < 0 && p[0] == q[0] && p[1] == q[1] &&
+                   p[2] == q[2] )
+                {
+                mergeMap[id] = minId;
+                }
+              }
+            }//for all points in this bucket
+          }//for all buckets in this batch
+        }
+    };
+
   // Build the map and other structures to support locator operations
   virtual void BuildLocator()
     {
@@ -1082,6 +1142,43 @@ FindPointsWithinRadius(double R, const double x[3], vtkIdList *result)
     }
 }
 
+//-----------------------------------------------------------------------------
+// Merge points within tol of one another. Coincident points are found in
+// parallel; a non-zero tolerance requires visiting the points in order.
+template <typename TIds> void BucketList<TIds>::
+MergePoints(double tol, vtkIdType *mergeMap)
+{
+  std::fill_n(mergeMap, this->NumPts, -1);
+
+  if ( tol <= 0.0 )
+    {
+    MergeCoincident<TIds> merger(this, mergeMap);
+    vtkSMPTools::For(0,this->NumBuckets, merger);
+    return;
+    }
+
+  double p[3];
+  vtkIdList *nearby = vtkIdList::New();
+  for (vtkIdType ptId=0; ptId < this->NumPts; ++ptId)
+    {
+    if ( mergeMap[ptId] < 0 )
+      {
+      mergeMap[ptId] = ptId;
+      this->DataSet->GetPoint(ptId, p);
+      this->FindPointsWithinRadius(tol, p, nearby);
+      for (vtkIdType i=0; i < nearby->GetNumberOfIds(); ++i)
+        {
+        vtkIdType id = nearby->GetId(i);
+        if ( mergeMap[id] < 0 )
+          {
+          mergeMap[id] = ptId;
+          }
+        }
+      }
+    }
+  nearby->Delete();
+}
+
 //-----------------------------------------------------------------------------
 // Internal method to find those buckets that are within distance specified
 // only those buckets outside of level radiuses of ijk are returned
@@ -1547,6 +1644,26 @@ FindPointsWithinRadius(double R, const double x[3], vtkIdList *result)
     }
 }
 
+//-----------------------------------------------------------------------------
+void vtkStaticPointLocator::MergePoints(double tol, vtkIdType *mergeMap)
+{
+  this->BuildLocator(); // will subdivide if modified; otherwise returns
+  if ( !this->Buckets )
+    {
+    return;
+    }
+
+  if ( this->LargeIds )
+    {
+    static_cast<BucketList<vtkIdType>*>(this->Buckets)->
+      MergePoints(tol,mergeMap);
+    }
+  else
+    {
+    static_cast<BucketList<int>*>(this->Buckets)->MergePoints(tol,mergeMap);
+    }
+}
+
 //-----------------------------------------------------------------------------
 void vtkStaticPointLocator::
 GenerateRepresentation(int level, vtkPolyData *pd)
@@ -123,6 +123,17 @@ public:
   virtual void FindPointsWithinRadius(double R, const double x[3],
                                       vtkIdList *result);
 
+  // Description:
+  // Merge points that lie within the tolerance tol of one another. On
+  // return mergeMap[i] is the id of the point that point i is merged into;
+  // mergeMap must have room for one entry per point of the dataset. With a
+  // zero tolerance, exactly coincident points are merged into the one with
+  // the lowest id, and the buckets are processed in parallel. Otherwise the
+  // points are visited in order, and each point not merged yet absorbs the
+  // unmerged points within tol of it. This method calls BuildLocator() and
+  // is not thread safe.
+  void MergePoints(double tol, vtkIdType *mergeMap);
+
   // Description:
   // See vtkLocator and vtkAbstractPointLocator interface documentation.
   // These methods are not thread safe.
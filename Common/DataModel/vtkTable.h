@@ -40,6 +40,11 @@
 // Each column added with AddColumn <b>must</b> have its name set to a unique,
 // non-empty string in order for GetValue() to function properly.
 //
+// Row and single entry access go through vtkVariant conversions. Algorithms
+// looping over all the values of a column should rather use
+// vtkTableColumnBatchForEach() (see vtkTableColumnBatch.h), which hands out
+// typed chunks of the column.
+//
 // .SECTION Thanks
 // Thanks to Patricia Crossno, Ken Moreland, Andrew Wilson and Brian Wylie from
 // Sandia National Laboratories for their help in developing this class API.
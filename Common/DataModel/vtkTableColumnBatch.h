@@ -0,0 +1,107 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkTableColumnBatch.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkTableColumnBatch - typed access to a table column by chunks of
+// rows
+//
+// .SECTION Description
+// vtkTableColumnBatchForEach() hands the values of a column of a vtkTable
+// to a functor, one chunk of consecutive rows at a time, so that algorithms
+// can run tight loops instead of converting each entry to a vtkVariant.
+// The functor must provide
+// \verbatim
+// template <class T>
+// void operator()(const T* values, const unsigned char* valid,
+//                 vtkIdType firstRow, vtkIdType count);
+// \endverbatim
+// Single component numeric columns with the standard memory layout are not
+// copied: values points directly into the column and valid is NULL. Any
+// other column (strings, variants, several components) is converted to
+// double through vtkVariant::ToDouble() one chunk at a time. valid then
+// flags the entries that could be converted; the others (nulls) are 0.
+//
+// .SECTION See Also
+// vtkTable
+
+#ifndef vtkTableColumnBatch_h
+#define vtkTableColumnBatch_h
+
+#include "vtkAbstractArray.h"
+#include "vtkVariant.h"
+
+#include <vector>
+
+template <class T, class TFunctor>
+void vtkTableColumnBatchRaw(const T* values, vtkIdType numRows,
+                            vtkIdType chunkSize, TFunctor& f)
+{
+  for ( vtkIdType first = 0; first < numRows; first += chunkSize )
+    {
+    vtkIdType count = numRows - first < chunkSize ? numRows - first : chunkSize;
+    f(values + first, static_cast<const unsigned char*>(0), first, count);
+    }
+}
+
+template <class TFunctor>
+void vtkTableColumnBatchConverted(vtkAbstractArray* column, vtkIdType numRows,
+                                  vtkIdType chunkSize, TFunctor& f)
+{
+  bool single = column->GetNumberOfComponents() == 1;
+  std::vector<double> values( chunkSize );
+  std::vector<unsigned char> valid( chunkSize );
+  for ( vtkIdType first = 0; first < numRows; first += chunkSize )
+    {
+    vtkIdType count = numRows - first < chunkSize ? numRows - first : chunkSize;
+    for ( vtkIdType i = 0; i < count; ++ i )
+      {
+      bool ok = false;
+      values[i] = single ?
+        column->GetVariantValue( first + i ).ToDouble( &ok ) : 0.;
+      valid[i] = ok ? 1 : 0;
+      }
+    f(static_cast<const double*>(&values[0]),
+      static_cast<const unsigned char*>(&valid[0]), first, count);
+    }
+}
+
+// Description:
+// Call f for each chunk of at most chunkSize rows of column.
+template <class TFunctor>
+void vtkTableColumnBatchForEach(vtkAbstractArray* column, TFunctor& f,
+                                vtkIdType chunkSize = 4096)
+{
+  vtkIdType numRows = column->GetNumberOfTuples();
+  if ( numRows < 1 || chunkSize < 1 )
+    {
+    return;
+    }
+
+  if ( column->GetNumberOfComponents() == 1 &&
+       column->HasStandardMemoryLayout() )
+    {
+    switch ( column->GetDataType() )
+      {
+      vtkTemplateMacro(
+        vtkTableColumnBatchRaw(
+          static_cast<const VTK_TT*>(column->GetVoidPointer(0)),
+          numRows, chunkSize, f);
+        return);
+      }
+    }
+
+  vtkTableColumnBatchConverted(column, numRows, chunkSize, f);
+}
+
+#endif
+// VTK-HeaderTest-Exclude: vtkTableColumnBatch.h
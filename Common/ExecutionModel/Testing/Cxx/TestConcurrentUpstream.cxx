@@ -0,0 +1,181 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestConcurrentUpstream.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the concurrent upstream mode of vtkDemandDrivenPipeline and
+// vtkAlgorithm::UpdateAsync() give the same results as a plain update, and
+// that a pipeline shared by two inputs still executes once.
+
+#include "vtkDemandDrivenPipeline.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkUpdateFuture.h"
+
+//----------------------------------------------------------------------------
+// Produce NumberOfPoints points and count its executions.
+class vtkCountingSource : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkCountingSource* New();
+  vtkTypeMacro(vtkCountingSource, vtkPolyDataAlgorithm);
+  vtkSetMacro(NumberOfPoints, int);
+
+  int Executions;
+
+protected:
+  vtkCountingSource() : Executions(0), NumberOfPoints(1)
+    {
+    this->SetNumberOfInputPorts(0);
+    }
+
+  virtual int RequestData(vtkInformation*, vtkInformationVector**,
+                          vtkInformationVector* outputVector)
+    {
+    ++this->Executions;
+    vtkNew<vtkPoints> points;
+    points->SetNumberOfPoints(this->NumberOfPoints);
+    for (int i = 0; i < this->NumberOfPoints; ++i)
+      {
+      points->SetPoint(i, i, 0.0, 0.0);
+      }
+    vtkPolyData::GetData(outputVector)->SetPoints(points.GetPointer());
+    return 1;
+    }
+
+  int NumberOfPoints;
+
+private:
+  vtkCountingSource(const vtkCountingSource&);  // Not implemented.
+  void operator=(const vtkCountingSource&);  // Not implemented.
+};
+vtkStandardNewMacro(vtkCountingSource);
+
+//----------------------------------------------------------------------------
+// Output as many points as all the inputs together.
+class vtkCountingJoin : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkCountingJoin* New();
+  vtkTypeMacro(vtkCountingJoin, vtkPolyDataAlgorithm);
+
+protected:
+  vtkCountingJoin() {}
+
+  virtual int FillInputPortInformation(int, vtkInformation* info)
+    {
+    info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkPolyData");
+    info->Set(vtkAlgorithm::INPUT_IS_REPEATABLE(), 1);
+    return 1;
+    }
+
+  virtual int RequestData(vtkInformation*, vtkInformationVector** inputVector,
+                          vtkInformationVector* outputVector)
+    {
+    vtkIdType count = 0;
+    for (int i = 0; i < inputVector[0]->GetNumberOfInformationObjects(); ++i)
+      {
+      count += vtkPolyData::GetData(inputVector[0], i)->GetNumberOfPoints();
+      }
+    vtkNew<vtkPoints> points;
+    points->SetNumberOfPoints(count);
+    vtkPolyData::GetData(outputVector)->SetPoints(points.GetPointer());
+    return 1;
+    }
+
+private:
+  vtkCountingJoin(const vtkCountingJoin&);  // Not implemented.
+  void operator=(const vtkCountingJoin&);  // Not implemented.
+};
+vtkStandardNewMacro(vtkCountingJoin);
+
+//----------------------------------------------------------------------------
+static void SetConcurrent(vtkAlgorithm* algorithm)
+{
+  vtkDemandDrivenPipeline::SafeDownCast(
+    algorithm->GetExecutive())->ConcurrentUpstreamOn();
+}
+
+#define CHECK(cond)                                                    \
+  do                                                                   \
+    {                                                                  \
+    if (!(cond))                                                       \
+      {                                                                \
+      cerr << "Line " << __LINE__ << ": check failed: " #cond << endl; \
+      return EXIT_FAILURE;                                             \
+      }                                                                \
+    }                                                                  \
+  while (0)
+
+//----------------------------------------------------------------------------
+int TestConcurrentUpstream(int, char *[])
+{
+  // Independent sources.
+  vtkNew<vtkCountingSource> sources[3];
+  vtkNew<vtkCountingJoin> join;
+  for (int i = 0; i < 3; ++i)
+    {
+    sources[i]->SetNumberOfPoints(10 * (i + 1));
+    join->AddInputConnection(sources[i]->GetOutputPort());
+    }
+  SetConcurrent(join.GetPointer());
+  join->Update();
+  CHECK(join->GetOutput()->GetNumberOfPoints() == 60);
+  for (int i = 0; i < 3; ++i)
+    {
+    CHECK(sources[i]->Executions == 1);
+    }
+
+  // Only the modified source executes again.
+  sources[1]->SetNumberOfPoints(5);
+  join->Update();
+  CHECK(join->GetOutput()->GetNumberOfPoints() == 45);
+  CHECK(sources[0]->Executions == 1 && sources[1]->Executions == 2);
+
+  // A source feeding two inputs, through two filters, and an independent
+  // source: the shared source executes once.
+  vtkNew<vtkCountingSource> shared;
+  vtkNew<vtkCountingJoin> left;
+  vtkNew<vtkCountingJoin> right;
+  vtkNew<vtkCountingJoin> diamond;
+  left->AddInputConnection(shared->GetOutputPort());
+  right->AddInputConnection(shared->GetOutputPort());
+  diamond->AddInputConnection(left->GetOutputPort());
+  diamond->AddInputConnection(sources[2]->GetOutputPort());
+  diamond->AddInputConnection(right->GetOutputPort());
+  SetConcurrent(diamond.GetPointer());
+  diamond->Update();
+  CHECK(diamond->GetOutput()->GetNumberOfPoints() == 32);
+  CHECK(shared->Executions == 1);
+
+  // Asynchronous update.
+  shared->SetNumberOfPoints(7);
+  vtkUpdateFuture* future = diamond->UpdateAsync();
+  CHECK(future->Wait() == 1);
+  CHECK(future->IsDone());
+  CHECK(diamond->GetOutput()->GetNumberOfPoints() == 44);
+  CHECK(shared->Executions == 2);
+
+  // The handle can be reused once done.
+  sources[0]->SetNumberOfPoints(1);
+  CHECK(future->Start(join.GetPointer()));
+  CHECK(future->Wait() == 1);
+  CHECK(join->GetOutput()->GetNumberOfPoints() == 36);
+  future->Delete();
+
+  return EXIT_SUCCESS;
+}
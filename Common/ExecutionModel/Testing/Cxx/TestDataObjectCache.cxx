@@ -0,0 +1,165 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDataObjectCache.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks the memory budget, the eviction policies and the counters of
+// vtkDataObjectCache, with entries of several owners.
+
+#include "vtkDataObjectCache.h"
+#include "vtkDoubleArray.h"
+#include "vtkInformation.h"
+#include "vtkInformationIdTypeKey.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+
+// A data object of roughly kib kibibytes.
+static vtkSmartPointer<vtkPolyData> MakeData(int kib)
+{
+  vtkSmartPointer<vtkPolyData> data = vtkSmartPointer<vtkPolyData>::New();
+  vtkNew<vtkDoubleArray> array;
+  array->SetName("Payload");
+  array->SetNumberOfTuples(kib * 1024 / static_cast<int>(sizeof(double)));
+  array->FillComponent(0, 1.0);
+  data->GetPointData()->AddArray(array.GetPointer());
+  return data;
+}
+
+#define CHECK(cond)                                                    \
+  do                                                                   \
+    {                                                                  \
+    if (!(cond))                                                       \
+      {                                                                \
+      cerr << "Line " << __LINE__ << ": check failed: " #cond << endl; \
+      return EXIT_FAILURE;                                             \
+      }                                                                \
+    }                                                                  \
+  while (0)
+
+int TestDataObjectCache(int, char *[])
+{
+  vtkNew<vtkDataObjectCache> cache;
+  vtkNew<vtkObject> owner1;
+  vtkNew<vtkObject> owner2;
+  vtkObject* a = owner1.GetPointer();
+  vtkObject* b = owner2.GetPointer();
+
+  vtkSmartPointer<vtkPolyData> data = MakeData(100);
+  unsigned long size = data->GetActualMemorySize();
+
+  // Without budget everything is kept.
+  for (int i = 0; i < 10; ++i)
+    {
+    CHECK(cache->Insert(i % 2 ? b : a, i, MakeData(100), 1));
+    }
+  CHECK(cache->GetNumberOfEntries() == 10);
+  CHECK(cache->GetNumberOfEntries(a) == 5);
+  CHECK(cache->GetMemorySize() == 10 * size);
+  CHECK(cache->GetMemorySize(b) == 5 * size);
+
+  // Lowering the budget evicts the least recently used entries, of any
+  // owner. Finding an entry makes it recent.
+  CHECK(cache->Find(a, 0) != NULL);
+  CHECK(cache->Find(b, 1) != NULL);
+  CHECK(cache->Find(a, 1) == NULL);
+  cache->SetMemoryBudget(4 * size);
+  CHECK(cache->GetNumberOfEntries() == 4);
+  CHECK(cache->GetMemorySize() <= 4 * size);
+  CHECK(cache->Peek(a, 0) != NULL && cache->Peek(b, 1) != NULL);
+  CHECK(cache->Peek(b, 9) != NULL && cache->Peek(a, 8) != NULL);
+  CHECK(cache->GetNumberOfEvictions() == 6);
+  CHECK(cache->GetNumberOfEvictions(a) + cache->GetNumberOfEvictions(b) == 6);
+  CHECK(cache->GetNumberOfHits(a) == 1 && cache->GetNumberOfMisses(a) == 1);
+  CHECK(cache->GetNumberOfHits() == 2 && cache->GetNumberOfMisses() == 1);
+
+  // Inserting past the budget evicts; entries larger than the budget are
+  // not stored at all.
+  CHECK(cache->Insert(a, 20, data, 1));
+  CHECK(cache->GetNumberOfEntries() == 4);
+  CHECK(cache->Peek(a, 8) == NULL);
+  CHECK(!cache->Insert(a, 21, MakeData(500), 1));
+  CHECK(cache->Peek(a, 21) == NULL);
+
+  // Replacing an entry does not count it twice.
+  CHECK(cache->Insert(a, 20, data, 2));
+  CHECK(cache->GetNumberOfEntries() == 4);
+  CHECK(cache->GetMemorySize() <= 4 * size);
+
+  // Entries older than a time, or of an owner, are removed.
+  cache->RemoveOlderThan(a, 2);
+  CHECK(cache->Peek(a, 20) != NULL && cache->Peek(a, 0) == NULL);
+  cache->RemoveAll(b);
+  CHECK(cache->GetNumberOfEntries() == 1);
+  CHECK(cache->EvictOne(a));
+  CHECK(!cache->EvictOne(a));
+  CHECK(cache->GetNumberOfEntries() == 0 && cache->GetMemorySize() == 0);
+
+  // The cost aware policy keeps the entries that are expensive to
+  // recompute for their size.
+  cache->SetEvictionPolicyToCostAware();
+  cache->SetMemoryBudget(3 * size);
+  CHECK(cache->Insert(a, 0, MakeData(100), 1, 10.0));
+  CHECK(cache->Insert(a, 1, MakeData(100), 1, 1.0));
+  CHECK(cache->Insert(a, 2, MakeData(100), 1, 5.0));
+  CHECK(cache->Insert(b, 0, MakeData(100), 1, 2.0));
+  CHECK(cache->Peek(a, 1) == NULL);
+  CHECK(cache->Insert(b, 1, MakeData(100), 1, 2.0));
+  CHECK(cache->Peek(b, 0) == NULL);
+  CHECK(cache->Peek(a, 0) != NULL && cache->Peek(a, 2) != NULL);
+  // Entries that are not used age: cheap new entries eventually push out
+  // the expensive ones.
+  for (int i = 2; i < 40; ++i)
+    {
+    cache->Insert(b, i, MakeData(100), 1, 2.0);
+    }
+  CHECK(cache->Peek(a, 0) == NULL && cache->Peek(a, 2) == NULL);
+
+  // The counters of an owner are reported in an information object.
+  vtkNew<vtkInformation> info;
+  cache->Find(a, 0);
+  cache->ReportCounters(a, info.GetPointer());
+  CHECK(info->Get(vtkDataObjectCache::HITS()) == cache->GetNumberOfHits(a));
+  CHECK(info->Get(vtkDataObjectCache::MISSES()) == cache->GetNumberOfMisses(a));
+  CHECK(info->Get(vtkDataObjectCache::EVICTIONS()) ==
+        cache->GetNumberOfEvictions(a));
+  cache->RemoveOwner(a);
+  CHECK(cache->GetNumberOfMisses(a) == 0);
+
+  // Data stays alive while cached.
+  vtkSmartPointer<vtkPolyData> held = MakeData(10);
+  vtkPolyData* raw = held;
+  cache->SetMemoryBudget(0);
+  cache->Insert(b, 100, raw, 1);
+  held = NULL;
+  CHECK(cache->Find(b, 100).GetPointer() == raw);
+  CHECK(raw->GetPointData()->GetArray("Payload") != NULL);
+
+  // Found data stays alive when its entry is evicted afterwards.
+  vtkSmartPointer<vtkDataObject> found = cache->Find(b, 100);
+  cache->RemoveAll();
+  CHECK(found.GetPointer() == raw && found->GetReferenceCount() == 1);
+
+  // Switching the policy reorders the entries already stored.
+  cache->SetEvictionPolicyToCostAware();
+  CHECK(cache->Insert(a, 0, MakeData(10), 1, 5.0));
+  CHECK(cache->Insert(a, 1, MakeData(10), 1, 1.0));
+  CHECK(cache->Insert(b, 0, MakeData(10), 1, 0.5));
+  CHECK(cache->EvictOne(a) && cache->Peek(a, 1) == NULL);
+  CHECK(cache->Insert(a, 1, MakeData(10), 1, 1.0));
+  cache->SetEvictionPolicyToLeastRecentlyUsed();
+  CHECK(cache->EvictOne(a) && cache->Peek(a, 0) == NULL);
+  CHECK(cache->Peek(a, 1) != NULL && cache->Peek(b, 0) != NULL);
+
+  return EXIT_SUCCESS;
+}
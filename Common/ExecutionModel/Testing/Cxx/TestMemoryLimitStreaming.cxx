@@ -0,0 +1,160 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestMemoryLimitStreaming.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkMemoryLimitStreamingPipeline splits the input of filters
+// and sinks so that the pipeline upstream stays within its memory limit,
+// and that the streamed output matches the output of a single execution.
+
+#include "vtkAppendPolyData.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMemoryLimitStreamingPipeline.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkSphereSource.h"
+
+#define CHECK(cond)                                                    \
+  do                                                                   \
+    {                                                                  \
+    if (!(cond))                                                       \
+      {                                                                \
+      cerr << "Line " << __LINE__ << ": check failed: " #cond << endl; \
+      return EXIT_FAILURE;                                             \
+      }                                                                \
+    }                                                                  \
+  while (0)
+
+//------------------------------------------------------------------------------
+// Shallow copy the input polydata and count the executions. Without output
+// port, only count the executions and the cells of the input.
+class vtkCountingPolyDataFilter : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkCountingPolyDataFilter* New();
+  vtkTypeMacro(vtkCountingPolyDataFilter, vtkPolyDataAlgorithm);
+
+  void SetSink() { this->SetNumberOfOutputPorts(0); }
+
+  int NumberOfExecutions;
+  vtkIdType NumberOfCells;
+
+protected:
+  vtkCountingPolyDataFilter() : NumberOfExecutions(0), NumberOfCells(0) {}
+
+  virtual int RequestData(vtkInformation*, vtkInformationVector** inputVector,
+                          vtkInformationVector* outputVector)
+    {
+    vtkPolyData* input = vtkPolyData::GetData(inputVector[0]);
+    ++this->NumberOfExecutions;
+    this->NumberOfCells += input->GetNumberOfCells();
+    if (this->GetNumberOfOutputPorts() > 0)
+      {
+      vtkPolyData::GetData(outputVector)->ShallowCopy(input);
+      }
+    return 1;
+    }
+
+private:
+  vtkCountingPolyDataFilter(const vtkCountingPolyDataFilter&);  // Not implemented.
+  void operator=(const vtkCountingPolyDataFilter&);  // Not implemented.
+};
+vtkStandardNewMacro(vtkCountingPolyDataFilter);
+
+int TestMemoryLimitStreaming(int, char *[])
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(256);
+  sphere->SetPhiResolution(256);
+  sphere->Update();
+  vtkIdType numCells = sphere->GetOutput()->GetNumberOfCells();
+  unsigned long size = sphere->GetOutput()->GetActualMemorySize();
+  unsigned long limit = size / 5;
+
+  vtkNew<vtkCountingPolyDataFilter> filter;
+  vtkNew<vtkMemoryLimitStreamingPipeline> executive;
+  vtkNew<vtkAppendPolyData> append;
+  filter->SetExecutive(executive.GetPointer());
+  filter->SetInputConnection(sphere->GetOutputPort());
+
+  // Without a limit, the filter executes once.
+  filter->Update();
+  CHECK(filter->NumberOfExecutions == 1);
+  CHECK(filter->GetOutput()->GetNumberOfCells() == numCells);
+
+  // With a limit, the input is split until a piece fits. Starting with one
+  // piece, the number of pieces is found by probing the first one.
+  executive->SetMemoryLimit(limit);
+  executive->SetInitialNumberOfPieces(1);
+  executive->SetAppendAlgorithm(append.GetPointer());
+  filter->NumberOfExecutions = 0;
+  filter->Modified();
+  filter->Update();
+  int numPieces = executive->GetNumberOfPieces();
+  CHECK(numPieces >= 5);
+  CHECK(filter->NumberOfExecutions == numPieces);
+  CHECK(executive->GetPeakMemorySize() <= limit + limit / 10);
+  CHECK(filter->GetOutput()->GetNumberOfCells() == numCells);
+
+  // The inputs are left with the request of the filter: nothing executes
+  // again until something changes.
+  filter->Update();
+  CHECK(filter->NumberOfExecutions == numPieces);
+
+  // The next update starts with the number of pieces found.
+  filter->NumberOfExecutions = 0;
+  sphere->Modified();
+  filter->Update();
+  CHECK(filter->NumberOfExecutions == executive->GetNumberOfPieces());
+  CHECK(filter->GetOutput()->GetNumberOfCells() == numCells);
+
+  // Prefetching halves the memory of each piece, and gives the same
+  // output.
+  executive->PrefetchOn();
+  filter->NumberOfExecutions = 0;
+  filter->Modified();
+  filter->Update();
+  CHECK(executive->GetNumberOfPieces() >= 2 * 5);
+  CHECK(filter->NumberOfExecutions == executive->GetNumberOfPieces());
+  CHECK(filter->GetOutput()->GetNumberOfCells() == numCells);
+  executive->PrefetchOff();
+
+  // Pieces of a piece are requested when the filter gets a piece.
+  filter->NumberOfExecutions = 0;
+  filter->SetUpdateExtent(1, 2, 0);
+  filter->Update();
+  CHECK(filter->GetOutput()->GetNumberOfCells() < numCells);
+  CHECK(filter->GetOutput()->GetNumberOfCells() > 0);
+  filter->SetUpdateExtent(0, 2, 0);
+  filter->Update();
+  vtkIdType firstHalf = filter->GetOutput()->GetNumberOfCells();
+  sphere->SetUpdateExtent(0, 2, 0);
+  sphere->Update();
+  CHECK(firstHalf == sphere->GetOutput()->GetNumberOfCells());
+
+  // Sinks execute for each piece and need no append algorithm.
+  vtkNew<vtkCountingPolyDataFilter> sink;
+  vtkNew<vtkMemoryLimitStreamingPipeline> sinkExecutive;
+  sink->SetSink();
+  sink->SetExecutive(sinkExecutive.GetPointer());
+  sink->SetInputConnection(sphere->GetOutputPort());
+  sinkExecutive->SetMemoryLimit(limit);
+  sink->Update();
+  CHECK(sinkExecutive->GetNumberOfPieces() >= 5);
+  CHECK(sink->NumberOfExecutions == sinkExecutive->GetNumberOfPieces());
+  CHECK(sink->NumberOfCells == numCells);
+
+  return EXIT_SUCCESS;
+}
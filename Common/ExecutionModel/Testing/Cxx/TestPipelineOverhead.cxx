@@ -0,0 +1,222 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPipelineOverhead.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .SECTION Description
+// Measure the cost of the pipeline itself: Update() on filters that do no
+// work, over a multiblock input with many leaves. Most of the time goes
+// into the requests passed between executives and the information objects
+// that carry them.
+
+#include "vtkCompositeDataPipeline.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPassInputTypeAlgorithm.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
+
+#include <string>
+#include <vector>
+
+// Number of leaves of the input. Kept small enough for the regular test
+// run; raise it to 100000 to benchmark the pipeline.
+static const unsigned int NUMBER_OF_BLOCKS = 10000;
+
+// Length of the pipelines.
+static const int NUMBER_OF_FILTERS = 10;
+
+//------------------------------------------------------------------------------
+// Shallow copy a whole data object, composite or not.
+class vtkNoOpCompositeFilter : public vtkPassInputTypeAlgorithm
+{
+public:
+  static vtkNoOpCompositeFilter* New();
+  vtkTypeMacro(vtkNoOpCompositeFilter, vtkPassInputTypeAlgorithm);
+
+protected:
+  vtkNoOpCompositeFilter() {}
+
+  virtual int RequestData(vtkInformation*, vtkInformationVector** inputVector,
+                          vtkInformationVector* outputVector)
+    {
+    vtkDataObject* input = vtkDataObject::GetData(inputVector[0]);
+    vtkDataObject* output = vtkDataObject::GetData(outputVector);
+    output->ShallowCopy(input);
+    return 1;
+    }
+
+private:
+  vtkNoOpCompositeFilter(const vtkNoOpCompositeFilter&);  // Not implemented.
+  void operator=(const vtkNoOpCompositeFilter&);  // Not implemented.
+};
+vtkStandardNewMacro(vtkNoOpCompositeFilter);
+
+//------------------------------------------------------------------------------
+// Shallow copy a polydata; the composite pipeline runs it on every leaf.
+class vtkNoOpPolyDataFilter : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkNoOpPolyDataFilter* New();
+  vtkTypeMacro(vtkNoOpPolyDataFilter, vtkPolyDataAlgorithm);
+
+protected:
+  vtkNoOpPolyDataFilter() {}
+
+  virtual int RequestData(vtkInformation*, vtkInformationVector** inputVector,
+                          vtkInformationVector* outputVector)
+    {
+    vtkPolyData* input = vtkPolyData::GetData(inputVector[0]);
+    vtkPolyData* output = vtkPolyData::GetData(outputVector);
+    output->ShallowCopy(input);
+    return 1;
+    }
+
+private:
+  vtkNoOpPolyDataFilter(const vtkNoOpPolyDataFilter&);  // Not implemented.
+  void operator=(const vtkNoOpPolyDataFilter&);  // Not implemented.
+};
+vtkStandardNewMacro(vtkNoOpPolyDataFilter);
+
+//------------------------------------------------------------------------------
+static void ReportTime(const char* name, double seconds)
+{
+  std::cout << "<DartMeasurement name=\"" << name
+            << "\" type=\"numeric/double\">"
+            << seconds << "</DartMeasurement>" << std::endl;
+}
+
+//------------------------------------------------------------------------------
+static unsigned int CountLeaves(vtkDataObject* data)
+{
+  vtkCompositeDataSet* composite = vtkCompositeDataSet::SafeDownCast(data);
+  if (!composite)
+    {
+    return 0;
+    }
+  vtkSmartPointer<vtkCompositeDataIterator> iter;
+  iter.TakeReference(composite->NewIterator());
+  unsigned int count = 0;
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+    {
+    ++count;
+    }
+  return count;
+}
+
+//------------------------------------------------------------------------------
+// Time the first update of a chain of filters, a second update with
+// nothing to do, and an update after the head of the chain was modified.
+template <class TFilter>
+static int TimeChain(vtkMultiBlockDataSet* input, int length,
+                     const char* name)
+{
+  std::vector<vtkSmartPointer<TFilter> > filters;
+  for (int i = 0; i < length; ++i)
+    {
+    filters.push_back(vtkSmartPointer<TFilter>::New());
+    if (i == 0)
+      {
+      filters[i]->SetInputData(input);
+      }
+    else
+      {
+      filters[i]->SetInputConnection(filters[i - 1]->GetOutputPort());
+      }
+    }
+  TFilter* last = filters.back();
+
+  vtkNew<vtkTimerLog> timer;
+  std::string prefix = std::string("PipelineOverhead-") + name;
+
+  timer->StartTimer();
+  last->Update();
+  timer->StopTimer();
+  ReportTime((prefix + "-FirstUpdate").c_str(), timer->GetElapsedTime());
+
+  // Nothing is modified: only the requests travel up and down the chain.
+  const int repeat = 100;
+  timer->StartTimer();
+  for (int i = 0; i < repeat; ++i)
+    {
+    last->Update();
+    }
+  timer->StopTimer();
+  ReportTime((prefix + "-UpToDateUpdate").c_str(),
+             timer->GetElapsedTime() / repeat);
+
+  filters[0]->Modified();
+  timer->StartTimer();
+  last->Update();
+  timer->StopTimer();
+  ReportTime((prefix + "-ModifiedUpdate").c_str(), timer->GetElapsedTime());
+
+  unsigned int leaves = CountLeaves(last->GetOutputDataObject(0));
+  if (leaves != input->GetNumberOfBlocks())
+    {
+    cerr << name << ": output has " << leaves << " leaves, expected "
+         << input->GetNumberOfBlocks() << endl;
+    return 1;
+    }
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+int TestPipelineOverhead(int, char*[])
+{
+  vtkNew<vtkCompositeDataPipeline> prototype;
+  vtkAlgorithm::SetDefaultExecutivePrototype(prototype.GetPointer());
+
+  // All the leaves share the same empty polydata: only the pipeline
+  // overhead is measured.
+  vtkNew<vtkPolyData> leaf;
+  vtkNew<vtkMultiBlockDataSet> input;
+  input->SetNumberOfBlocks(NUMBER_OF_BLOCKS);
+  for (unsigned int i = 0; i < NUMBER_OF_BLOCKS; ++i)
+    {
+    input->SetBlock(i, leaf.GetPointer());
+    }
+
+  int status = 0;
+  status += TimeChain<vtkNoOpCompositeFilter>(
+    input.GetPointer(), NUMBER_OF_FILTERS, "Composite");
+  status += TimeChain<vtkNoOpPolyDataFilter>(
+    input.GetPointer(), 2, "PerBlock");
+
+  // Raw cost of the information objects that carry the requests.
+  vtkNew<vtkTimerLog> timer;
+  vtkNew<vtkInformation> info;
+  timer->StartTimer();
+  for (unsigned int i = 0; i < NUMBER_OF_BLOCKS; ++i)
+    {
+    info->Set(vtkCompositeDataPipeline::LOAD_REQUESTED_BLOCKS(), 1);
+    info->Set(vtkDataObject::DATA_PIECE_NUMBER(), 0);
+    info->Set(vtkDataObject::DATA_NUMBER_OF_PIECES(), 1);
+    info->Set(vtkDataObject::DATA_NUMBER_OF_GHOST_LEVELS(), 0);
+    info->Get(vtkCompositeDataPipeline::LOAD_REQUESTED_BLOCKS());
+    info->Get(vtkDataObject::DATA_PIECE_NUMBER());
+    info->Remove(vtkDataObject::DATA_NUMBER_OF_GHOST_LEVELS());
+    vtkNew<vtkInformation> copy;
+    copy->Copy(info.GetPointer());
+    }
+  timer->StopTimer();
+  ReportTime("PipelineOverhead-Information", timer->GetElapsedTime());
+
+  vtkAlgorithm::SetDefaultExecutivePrototype(0);
+  return status;
+}
@@ -0,0 +1,136 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPipelineStatistics.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that executives record the executions and cache hits of their
+// algorithms in vtkPipelineStatistics, and the reports.
+
+#include "vtkElevationFilter.h"
+#include "vtkExecutive.h"
+#include "vtkNew.h"
+#include "vtkPipelineStatistics.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+
+#include <sstream>
+#include <string>
+
+#define CHECK(cond)                                                    \
+  do                                                                   \
+    {                                                                  \
+    if (!(cond))                                                       \
+      {                                                                \
+      cerr << "Line " << __LINE__ << ": check failed: " #cond << endl; \
+      return EXIT_FAILURE;                                             \
+      }                                                                \
+    }                                                                  \
+  while (0)
+
+int TestPipelineStatistics(int, char *[])
+{
+  vtkNew<vtkPipelineStatistics> statistics;
+  vtkSmartPointer<vtkSphereSource> sphere =
+    vtkSmartPointer<vtkSphereSource>::New();
+  sphere->SetThetaResolution(64);
+  sphere->SetPhiResolution(64);
+  vtkNew<vtkElevationFilter> elevation;
+  elevation->SetInputConnection(sphere->GetOutputPort());
+
+  // Nothing is recorded without statistics.
+  elevation->Update();
+  CHECK(vtkExecutive::GetDefaultStatistics() == NULL);
+  CHECK(elevation->GetExecutive()->GetStatistics() == NULL);
+
+  // The default statistics are used by every executive.
+  vtkExecutive::SetDefaultStatistics(statistics.GetPointer());
+  sphere->Modified();
+  elevation->Update();
+  CHECK(statistics->GetNumberOfAlgorithms() == 2);
+  CHECK(statistics->GetAlgorithm(0) == sphere.GetPointer());
+  CHECK(statistics->GetAlgorithm(1) == elevation.GetPointer());
+  CHECK(statistics->GetNumberOfExecutions(sphere) == 1);
+  CHECK(statistics->GetNumberOfExecutions(elevation.GetPointer()) == 1);
+  CHECK(statistics->GetNumberOfCacheHits(elevation.GetPointer()) == 0);
+  CHECK(statistics->GetOutputMemorySize(sphere) ==
+        sphere->GetOutput()->GetActualMemorySize());
+  CHECK(statistics->GetOutputMemorySize(elevation.GetPointer()) ==
+        elevation->GetOutput()->GetActualMemorySize());
+  CHECK(statistics->GetOutputMemorySize() ==
+        statistics->GetOutputMemorySize(sphere) +
+        statistics->GetOutputMemorySize(elevation.GetPointer()));
+  CHECK(statistics->GetWallTime(sphere) >= 0.0);
+  CHECK(statistics->GetCPUTime(sphere) >= 0.0);
+  CHECK(statistics->GetWallTime() >= statistics->GetWallTime(sphere));
+
+  // Requests answered without executing count as cache hits. They do not
+  // reach the upstream algorithms.
+  elevation->Update();
+  elevation->Update();
+  CHECK(statistics->GetNumberOfExecutions(elevation.GetPointer()) == 1);
+  CHECK(statistics->GetNumberOfCacheHits(elevation.GetPointer()) == 2);
+  CHECK(statistics->GetNumberOfCacheHits(sphere) == 0);
+
+  // Up to date algorithms upstream of an executing one count a hit.
+  elevation->Modified();
+  elevation->Update();
+  CHECK(statistics->GetNumberOfExecutions(elevation.GetPointer()) == 2);
+  CHECK(statistics->GetNumberOfExecutions(sphere) == 1);
+  CHECK(statistics->GetNumberOfCacheHits(sphere) == 1);
+  CHECK(statistics->GetNumberOfExecutions() == 3);
+  CHECK(statistics->GetNumberOfCacheHits() == 3);
+
+  // Executives with statistics of their own do not use the default ones.
+  vtkExecutive::SetDefaultStatistics(NULL);
+  vtkNew<vtkPipelineStatistics> own;
+  own->MeasureProcessMemoryOff();
+  elevation->GetExecutive()->SetStatistics(own.GetPointer());
+  sphere->Modified();
+  elevation->Update();
+  CHECK(own->GetNumberOfAlgorithms() == 1);
+  CHECK(own->GetNumberOfExecutions(elevation.GetPointer()) == 1);
+  CHECK(own->GetPeakMemoryGrowth() == 0);
+  CHECK(statistics->GetNumberOfExecutions() == 3);
+  elevation->GetExecutive()->SetStatistics(NULL);
+
+  // Reports list every algorithm, even destroyed ones.
+  std::string sphereName = statistics->GetAlgorithmName(0);
+  CHECK(sphereName.find("vtkSphereSource(") == 0);
+  elevation->SetInputConnection(NULL);
+  sphere = NULL;
+  CHECK(statistics->GetNumberOfAlgorithms() == 2);
+  CHECK(statistics->GetAlgorithm(0) == NULL);
+  CHECK(sphereName == statistics->GetAlgorithmName(0));
+
+  std::ostringstream csv;
+  statistics->WriteCSV(csv);
+  CHECK(csv.str().find("Algorithm,Executions,CacheHits,WallTime,CPUTime,"
+                       "OutputMemorySize,PeakMemoryGrowth\n") == 0);
+  CHECK(csv.str().find("\n" + sphereName + ",1,1,") != std::string::npos);
+  CHECK(csv.str().find("vtkElevationFilter(") != std::string::npos);
+
+  std::ostringstream json;
+  statistics->WriteJSON(json);
+  CHECK(json.str()[0] == '[');
+  CHECK(json.str().find("{\"Algorithm\": \"" + sphereName +
+                        "\", \"Executions\": 1, \"CacheHits\": 1,") !=
+        std::string::npos);
+  CHECK(json.str().find("\"Executions\": 2, \"CacheHits\": 2,") !=
+        std::string::npos);
+
+  statistics->Reset();
+  CHECK(statistics->GetNumberOfAlgorithms() == 0);
+  CHECK(statistics->GetNumberOfExecutions(elevation.GetPointer()) == 0);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,214 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestScalarTreeCache.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that the scalar tree cached on a dataset is rebuilt only when its
+// scalars or the structure of the dataset change, that its batches hold
+// every cell spanning a value, and its statistics.
+
+#include "vtkDoubleArray.h"
+#include "vtkIdList.h"
+#include "vtkImageData.h"
+#include "vtkInformation.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkScalarTree.h"
+#include "vtkSimpleScalarTree.h"
+#include "vtkSpanSpace.h"
+
+#include <set>
+
+#define CHECK(cond)                                                    \
+  do                                                                   \
+    {                                                                  \
+    if (!(cond))                                                       \
+      {                                                                \
+      cerr << "Line " << __LINE__ << ": check failed: " #cond << endl; \
+      return EXIT_FAILURE;                                             \
+      }                                                                \
+    }                                                                  \
+  while (0)
+
+// Cells whose scalar range contains value, found by visiting all cells.
+static std::set<vtkIdType> SpanningCells(vtkDataSet* data,
+                                         vtkDataArray* scalars, double value)
+{
+  std::set<vtkIdType> cells;
+  vtkNew<vtkIdList> pts;
+  for (vtkIdType cellId = 0; cellId < data->GetNumberOfCells(); ++cellId)
+    {
+    data->GetCellPoints(cellId, pts.GetPointer());
+    double sMin = VTK_DOUBLE_MAX, sMax = -VTK_DOUBLE_MAX;
+    for (vtkIdType i = 0; i < pts->GetNumberOfIds(); ++i)
+      {
+      double s = scalars->GetTuple1(pts->GetId(i));
+      sMin = (s < sMin ? s : sMin);
+      sMax = (s > sMax ? s : sMax);
+      }
+    if (sMin <= value && value <= sMax)
+      {
+      cells.insert(cellId);
+      }
+    }
+  return cells;
+}
+
+// Candidate cells of the batches of tree for value.
+static std::set<vtkIdType> BatchCells(vtkScalarTree* tree, double value)
+{
+  std::set<vtkIdType> cells;
+  tree->InitTraversal(value);
+  vtkIdType numBatches = tree->GetNumberOfCellBatches();
+  for (vtkIdType batch = 0; batch < numBatches; ++batch)
+    {
+    vtkIdType numCells;
+    const vtkIdType* cellIds = tree->GetCellBatch(batch, numCells);
+    cells.insert(cellIds, cellIds + numCells);
+    }
+  return cells;
+}
+
+static bool Includes(const std::set<vtkIdType>& a,
+                     const std::set<vtkIdType>& b)
+{
+  for (std::set<vtkIdType>::const_iterator it = b.begin(); it != b.end(); ++it)
+    {
+    if (a.find(*it) == a.end())
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+int TestScalarTreeCache(int, char *[])
+{
+  const int dim = 20;
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(dim, dim, dim);
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("Scalars");
+  scalars->SetNumberOfTuples(dim * dim * dim);
+  for (int k = 0, id = 0; k < dim; ++k)
+    {
+    for (int j = 0; j < dim; ++j)
+      {
+      for (int i = 0; i < dim; ++i, ++id)
+        {
+        scalars->SetValue(id, (i - 10) * (i - 10) + (j - 10) * (j - 10) +
+                          (k - 10) * (k - 10));
+        }
+      }
+    }
+  image->GetPointData()->SetScalars(scalars.GetPointer());
+
+  // The tree is created on first use and cached on the dataset. It is
+  // handed out to one user at a time.
+  vtkScalarTree* tree =
+    vtkScalarTree::GetCachedTree(image.GetPointer(), scalars.GetPointer());
+  CHECK(tree != NULL && tree->IsA("vtkSpanSpace"));
+  CHECK(image->GetInformation()->Get(vtkScalarTree::CACHED_TREE()) == tree);
+  CHECK(vtkScalarTree::GetCachedTree(image.GetPointer(),
+                                     scalars.GetPointer()) == NULL);
+
+  // The batches hold every cell spanning the value, and only cells whose
+  // scalar range is close to it.
+  const double values[] = { 1.5, 25.0, 60.5, 150.0 };
+  for (int v = 0; v < 4; ++v)
+    {
+    std::set<vtkIdType> spanning =
+      SpanningCells(image.GetPointer(), scalars.GetPointer(), values[v]);
+    std::set<vtkIdType> candidates = BatchCells(tree, values[v]);
+    CHECK(!spanning.empty());
+    CHECK(Includes(candidates, spanning));
+    CHECK(candidates.size() < static_cast<size_t>(image->GetNumberOfCells()));
+
+    // Serial traversal returns the same cells.
+    vtkNew<vtkDoubleArray> cellScalars;
+    vtkIdList* cellPts;
+    vtkIdType cellId;
+    std::set<vtkIdType> serial;
+    for (tree->InitTraversal(values[v]);
+         tree->GetNextCell(cellId, cellPts, cellScalars.GetPointer()); )
+      {
+      serial.insert(cellId);
+      }
+    CHECK(serial == candidates);
+    }
+  CHECK(BatchCells(tree, -1.0).empty());
+  CHECK(BatchCells(tree, 1000.0).empty());
+
+  CHECK(tree->GetNumberOfBuilds() == 1);
+  CHECK(tree->GetNumberOfTraversals() == 10);
+  CHECK(tree->GetNumberOfBuildRequests() == 10);
+  CHECK(tree->GetHitRate() == 0.9);
+  CHECK(tree->GetLastBuildDuration() >= 0.0);
+  CHECK(tree->GetTotalBuildDuration() == tree->GetLastBuildDuration());
+  CHECK(tree->GetCandidateFraction() > 0.0 && tree->GetCandidateFraction() < 1.0);
+  vtkScalarTree::ReleaseCachedTree(tree);
+  CHECK(tree->GetDataSet() == NULL && tree->GetScalars() == NULL);
+
+  // Later users find the same tree, still built. Modifying other arrays of
+  // the dataset does not rebuild it.
+  vtkNew<vtkDoubleArray> other;
+  other->SetName("Other");
+  other->SetNumberOfTuples(dim * dim * dim);
+  image->GetPointData()->AddArray(other.GetPointer());
+  CHECK(vtkScalarTree::GetCachedTree(image.GetPointer(),
+                                     scalars.GetPointer()) == tree);
+  CHECK(tree->GetDataSet() == image.GetPointer());
+  BatchCells(tree, 25.0);
+  CHECK(tree->GetNumberOfBuilds() == 1);
+  vtkScalarTree::ReleaseCachedTree(tree);
+
+  // Modifying the structure of the dataset rebuilds it.
+  image->SetSpacing(2.0, 2.0, 2.0);
+  tree = vtkScalarTree::GetCachedTree(image.GetPointer(), scalars.GetPointer());
+  BatchCells(tree, 25.0);
+  CHECK(tree->GetNumberOfBuilds() == 2);
+  vtkScalarTree::ReleaseCachedTree(tree);
+
+  // Modifying the scalars, or using other scalars, rebuilds it.
+  scalars->SetValue(0, 500.0);
+  scalars->Modified();
+  tree = vtkScalarTree::GetCachedTree(image.GetPointer(), scalars.GetPointer());
+  CHECK(BatchCells(tree, 400.0).count(0) == 1);
+  CHECK(tree->GetNumberOfBuilds() == 3);
+  vtkScalarTree::ReleaseCachedTree(tree);
+
+  other->FillComponent(0, 1.0);
+  other->SetValue(1, 2.0);
+  tree = vtkScalarTree::GetCachedTree(image.GetPointer(), other.GetPointer());
+  CHECK(BatchCells(tree, 1.5).count(0) == 1);
+  CHECK(tree->GetNumberOfBuilds() == 4);
+  tree->ResetStatistics();
+  CHECK(tree->GetNumberOfBuilds() == 0 && tree->GetHitRate() == 0.0);
+  vtkScalarTree::ReleaseCachedTree(tree);
+
+  // Trees that are not cached follow the same rules.
+  vtkNew<vtkSimpleScalarTree> simple;
+  simple->SetDataSet(image.GetPointer());
+  simple->SetScalars(scalars.GetPointer());
+  std::set<vtkIdType> spanning =
+    SpanningCells(image.GetPointer(), scalars.GetPointer(), 25.0);
+  CHECK(Includes(BatchCells(simple.GetPointer(), 25.0), spanning));
+  image->GetPointData()->RemoveArray("Other");
+  CHECK(Includes(BatchCells(simple.GetPointer(), 25.0), spanning));
+  CHECK(simple->GetNumberOfBuilds() == 1);
+  CHECK(simple->GetHitRate() == 0.5);
+  simple->SetBranchingFactor(5);
+  BatchCells(simple.GetPointer(), 25.0);
+  CHECK(simple->GetNumberOfBuilds() == 2);
+
+  return EXIT_SUCCESS;
+}
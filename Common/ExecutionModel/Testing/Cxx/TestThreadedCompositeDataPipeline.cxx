@@ -0,0 +1,150 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestThreadedCompositeDataPipeline.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks the block execution order of vtkThreadedCompositeDataPipeline and
+// that its output does not depend on how the blocks are scheduled, nor on
+// whether the algorithm is declared re-entrant.
+
+#include "vtkInformation.h"
+#include "vtkInformationIntegerKey.h"
+#include "vtkInformationVector.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkThreadedCompositeDataPipeline.h"
+
+//----------------------------------------------------------------------------
+// Output twice the points of the input.
+class vtkDoublePointsFilter : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkDoublePointsFilter* New();
+  vtkTypeMacro(vtkDoublePointsFilter, vtkPolyDataAlgorithm);
+
+protected:
+  vtkDoublePointsFilter() {}
+
+  virtual int RequestData(vtkInformation*, vtkInformationVector** inputVector,
+                          vtkInformationVector* outputVector)
+    {
+    vtkPolyData* input = vtkPolyData::GetData(inputVector[0]);
+    vtkNew<vtkPoints> points;
+    points->SetNumberOfPoints(2 * input->GetNumberOfPoints());
+    vtkPolyData::GetData(outputVector)->SetPoints(points.GetPointer());
+    return 1;
+    }
+
+private:
+  vtkDoublePointsFilter(const vtkDoublePointsFilter&);  // Not implemented.
+  void operator=(const vtkDoublePointsFilter&);  // Not implemented.
+};
+vtkStandardNewMacro(vtkDoublePointsFilter);
+
+//----------------------------------------------------------------------------
+static const int NUMBER_OF_BLOCKS = 6;
+static const int BLOCK_SIZES[NUMBER_OF_BLOCKS] = { 5, 50, -1, 20, 1000, 20 };
+
+static int CheckOutput(vtkDoublePointsFilter* filter)
+{
+  filter->Modified();
+  filter->Update();
+  vtkMultiBlockDataSet* output =
+    vtkMultiBlockDataSet::SafeDownCast(filter->GetOutputDataObject(0));
+  if (!output || output->GetNumberOfBlocks() != NUMBER_OF_BLOCKS)
+    {
+    cerr << "Wrong output structure." << endl;
+    return 0;
+    }
+  for (int i = 0; i < NUMBER_OF_BLOCKS; ++i)
+    {
+    vtkPolyData* block = vtkPolyData::SafeDownCast(output->GetBlock(i));
+    vtkIdType expected = 2 * BLOCK_SIZES[i];
+    if ((BLOCK_SIZES[i] < 0 && block) ||
+        (BLOCK_SIZES[i] >= 0 &&
+         (!block || block->GetNumberOfPoints() != expected)))
+      {
+      cerr << "Wrong output block " << i << endl;
+      return 0;
+      }
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int TestThreadedCompositeDataPipeline(int, char *[])
+{
+  vtkNew<vtkMultiBlockDataSet> input;
+  vtkDataObject* blocks[NUMBER_OF_BLOCKS];
+  input->SetNumberOfBlocks(NUMBER_OF_BLOCKS);
+  for (int i = 0; i < NUMBER_OF_BLOCKS; ++i)
+    {
+    blocks[i] = 0;
+    if (BLOCK_SIZES[i] >= 0)
+      {
+      vtkNew<vtkPoints> points;
+      points->SetNumberOfPoints(BLOCK_SIZES[i]);
+      vtkNew<vtkPolyData> block;
+      block->SetPoints(points.GetPointer());
+      input->SetBlock(i, block.GetPointer());
+      blocks[i] = block.GetPointer();
+      }
+    }
+
+  // Largest first; equal costs keep their order; NULL blocks last.
+  vtkIdType order[NUMBER_OF_BLOCKS];
+  vtkThreadedCompositeDataPipeline::ComputeExecutionOrder(
+    blocks, NUMBER_OF_BLOCKS, order);
+  const vtkIdType expectedOrder[NUMBER_OF_BLOCKS] = { 4, 1, 3, 5, 0, 2 };
+  for (int i = 0; i < NUMBER_OF_BLOCKS; ++i)
+    {
+    if (order[i] != expectedOrder[i])
+      {
+      cerr << "Wrong execution order at " << i << ": " << order[i] << endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  vtkNew<vtkThreadedCompositeDataPipeline> executive;
+  vtkNew<vtkDoublePointsFilter> filter;
+  filter->SetExecutive(executive.GetPointer());
+  filter->SetInputData(input.GetPointer());
+
+  // Blocks executed in parallel.
+  if (!CheckOutput(filter.GetPointer()))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // An algorithm declared not re-entrant runs block by block.
+  filter->GetInformation()->Set(
+    vtkThreadedCompositeDataPipeline::ALGORITHM_IS_REENTRANT(), 0);
+  if (!CheckOutput(filter.GetPointer()))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // So does one that says nothing, when the executive assumes nothing.
+  filter->GetInformation()->Remove(
+    vtkThreadedCompositeDataPipeline::ALGORITHM_IS_REENTRANT());
+  executive->AssumeReentrantOff();
+  if (!CheckOutput(filter.GetPointer()))
+    {
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -3,6 +3,8 @@ vtk_module(vtkCommonExecutionModel
     StandAlone
   DEPENDS
     vtkCommonDataModel
+  PRIVATE_DEPENDS
+    vtksys
   COMPILE_DEPENDS
     vtkCommonMisc
   TEST_DEPENDS
@@ -41,6 +41,7 @@
 #include "vtkCompositeDataPipeline.h"
 #include "vtkTable.h"
 #include "vtkTrivialProducer.h"
+#include "vtkUpdateFuture.h"
 
 #include <set>
 #include <vector>
@@ -1455,6 +1456,25 @@ void vtkAlgorithm::Update(int port)
   this->GetExecutive()->Update(port);
 }
 
+//----------------------------------------------------------------------------
+vtkUpdateFuture* vtkAlgorithm::UpdateAsync()
+{
+  int port = -1;
+  if (this->GetNumberOfOutputPorts())
+    {
+    port = 0;
+    }
+  return this->UpdateAsync(port);
+}
+
+//----------------------------------------------------------------------------
+vtkUpdateFuture* vtkAlgorithm::UpdateAsync(int port)
+{
+  vtkUpdateFuture* future = vtkUpdateFuture::New();
+  future->Start(this, port);
+  return future;
+}
+
 //----------------------------------------------------------------------------
 void vtkAlgorithm::PropagateUpdateExtent()
 {
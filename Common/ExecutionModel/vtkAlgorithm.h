@@ -46,6 +46,7 @@ class vtkInformationStringKey;
 class vtkInformationStringVectorKey;
 class vtkInformationVector;
 class vtkProgressObserver;
+class vtkUpdateFuture;
 
 class VTKCOMMONEXECUTIONMODEL_EXPORT vtkAlgorithm : public vtkObject
 {
@@ -459,6 +460,13 @@ public:
   virtual void Update(int port);
   virtual void Update();
 
+  // Description:
+  // Start bringing this algorithm's outputs up-to-date on a separate
+  // thread and return at once. The returned handle tells when the update
+  // is done; see vtkUpdateFuture for what may be done meanwhile. The
+  // caller must Delete() the handle.
+  vtkUpdateFuture* UpdateAsync(int port);
+  vtkUpdateFuture* UpdateAsync();
 
   // Description:
   // Bring the algorithm's information up-to-date.
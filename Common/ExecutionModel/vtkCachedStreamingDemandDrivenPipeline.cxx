@@ -20,10 +20,13 @@
 
 #include "vtkAlgorithm.h"
 #include "vtkAlgorithmOutput.h"
+#include "vtkDataObjectCache.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
 
 vtkStandardNewMacro(vtkCachedStreamingDemandDrivenPipeline);
 
@@ -33,6 +36,7 @@ vtkCachedStreamingDemandDrivenPipeline
 ::vtkCachedStreamingDemandDrivenPipeline()
 {
   this->CacheSize = 0;
+  this->DataCache = vtkDataObjectCache::New();
   this->Data = NULL;
   this->Times = NULL;
 
@@ -44,6 +48,35 @@ vtkCachedStreamingDemandDrivenPipeline
 ::~vtkCachedStreamingDemandDrivenPipeline()
 {
   this->SetCacheSize(0);
+  this->DataCache->RemoveOwner(this);
+  this->DataCache->Delete();
+}
+
+//----------------------------------------------------------------------------
+void vtkCachedStreamingDemandDrivenPipeline
+::SetDataCache(vtkDataObjectCache* cache)
+{
+  if (cache == this->DataCache)
+    {
+    return;
+    }
+  this->DataCache->RemoveOwner(this);
+  this->DataCache->Delete();
+  if (cache)
+    {
+    cache->Register(this);
+    this->DataCache = cache;
+    }
+  else
+    {
+    this->DataCache = vtkDataObjectCache::New();
+    }
+  for (int idx = 0; idx < this->CacheSize; ++idx)
+    {
+    this->Data[idx] = NULL;
+    this->Times[idx] = 0;
+    }
+  this->Modified();
 }
 
 //----------------------------------------------------------------------------
@@ -59,14 +92,7 @@ void vtkCachedStreamingDemandDrivenPipeline::SetCacheSize(int size)
   this->Modified();
 
   // free the old data
-  for (idx = 0; idx < this->CacheSize; ++idx)
-    {
-    if (this->Data[idx])
-      {
-      this->Data[idx]->Delete();
-      this->Data[idx] = NULL;
-      }
-    }
+  this->DataCache->RemoveAll(this);
   delete [] this->Data;
   this->Data = NULL;
   delete [] this->Times;
@@ -94,6 +120,7 @@ void vtkCachedStreamingDemandDrivenPipeline
 {
   this->Superclass::PrintSelf(os, indent);
   os << indent << "CacheSize: " << this->CacheSize << "\n";
+  os << indent << "DataCache: " << this->DataCache << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -157,16 +184,17 @@ int vtkCachedStreamingDemandDrivenPipeline
     }
 
   // First look through the cached data to see if it is still valid.
+  // Images evicted from a shared cache are forgotten too.
   int i;
   unsigned long pmt = this->GetPipelineMTime();
   for (i = 0; i < this->CacheSize; ++i)
     {
-    if (this->Data[i] && this->Times[i] < pmt)
+    if (this->Times[i] < pmt)
       {
-      this->Data[i]->Delete();
-      this->Data[i] = NULL;
+      this->DataCache->Remove(this, i);
       this->Times[i] = 0;
       }
+    this->Data[i] = this->DataCache->Peek(this, i);
     }
 
   // We need to check the requested update extent.  Get the output
@@ -185,9 +213,10 @@ int vtkCachedStreamingDemandDrivenPipeline
     // check to see if any data in the cache fits this request
     for (i = 0; i < this->CacheSize; ++i)
       {
-      if (this->Data[i])
+      vtkSmartPointer<vtkDataObject> data = this->DataCache->Peek(this, i);
+      if (data)
         {
-        dataInfo = this->Data[i]->GetInformation();
+        dataInfo = data->GetInformation();
 
         // Check the unstructured extent.  If we do not have the requested
         // piece, we need to execute.
@@ -203,6 +232,7 @@ int vtkCachedStreamingDemandDrivenPipeline
           {
           // we have a matching data we must copy it to our output, but for
           // now we don't support polydata
+          this->DataCache->AddMiss(this);
           return 1;
           }
         }
@@ -219,9 +249,10 @@ int vtkCachedStreamingDemandDrivenPipeline
     // check to see if any data in the cache fits this request
     for (i = 0; i < this->CacheSize; ++i)
       {
-      if (this->Data[i])
+      vtkSmartPointer<vtkDataObject> data = this->DataCache->Peek(this, i);
+      if (data)
         {
-        dataInfo = this->Data[i]->GetInformation();
+        dataInfo = data->GetInformation();
         dataInfo->Get(vtkDataObject::DATA_EXTENT(), dataExtent);
         if(dataInfo->Get(vtkDataObject::DATA_EXTENT_TYPE()) ==
            VTK_3D_EXTENT &&
@@ -238,13 +269,15 @@ int vtkCachedStreamingDemandDrivenPipeline
           // we have a match
           // Pass this data to output.
           vtkImageData *id = vtkImageData::SafeDownCast(dataObject);
-          vtkImageData *id2 = vtkImageData::SafeDownCast(this->Data[i]);
+          vtkImageData *id2 = vtkImageData::SafeDownCast(data);
           if (id && id2)
             {
+            this->DataCache->Find(this, i);
             id->SetExtent(dataExtent);
             id->GetPointData()->PassData(id2->GetPointData());
             // not sure if we need this
             dataObject->DataHasBeenGenerated();
+            this->DataCache->ReportCounters(this, outInfo);
             return 0;
             }
           }
@@ -253,6 +286,7 @@ int vtkCachedStreamingDemandDrivenPipeline
     }
 
   // We do need to execute
+  this->DataCache->AddMiss(this);
   return 1;
 }
 
@@ -270,8 +304,15 @@ int vtkCachedStreamingDemandDrivenPipeline
     return 0;
     }
 
-  // first do the ususal thing
+  // first do the ususal thing; the time it takes is the cost of
+  // recomputing the data
+  double startTime = vtkTimerLog::GetUniversalTime();
   int result = this->Superclass::ExecuteData(request, inInfoVec, outInfoVec);
+  double cost = vtkTimerLog::GetUniversalTime() - startTime;
+  if (this->CacheSize == 0)
+    {
+    return result;
+    }
 
   // then save the newly generated data
   unsigned long bestTime = VTK_INT_MAX;
@@ -281,7 +322,8 @@ int vtkCachedStreamingDemandDrivenPipeline
   // Find a spot to put the data.
   for (int i = 0; i < this->CacheSize; ++i)
     {
-    if (this->Data[i] == NULL)
+    this->Data[i] = this->DataCache->Peek(this, i);
+    if (!this->Data[i])
       {
       bestIdx = i;
       break;
@@ -295,11 +337,7 @@ int vtkCachedStreamingDemandDrivenPipeline
 
   vtkInformation* outInfo = outInfoVec->GetInformationObject(0);
   vtkDataObject* dataObject = outInfo->Get(vtkDataObject::DATA_OBJECT());
-  if (this->Data[bestIdx] == NULL)
-    {
-    this->Data[bestIdx] = dataObject->NewInstance();
-    }
-  this->Data[bestIdx]->ReleaseData();
+  vtkDataObject* cached = dataObject->NewInstance();
 
   vtkImageData *id = vtkImageData::SafeDownCast(dataObject);
   if (id)
@@ -312,7 +350,7 @@ int vtkCachedStreamingDemandDrivenPipeline
     id->DataHasBeenGenerated();
     }
 
-  vtkImageData *id2 = vtkImageData::SafeDownCast(this->Data[bestIdx]);
+  vtkImageData *id2 = vtkImageData::SafeDownCast(cached);
   if (id && id2)
     {
     id2->SetExtent(id->GetExtent());
@@ -321,6 +359,11 @@ int vtkCachedStreamingDemandDrivenPipeline
     }
 
   this->Times[bestIdx] = dataObject->GetUpdateTime();
+  this->DataCache->Insert(this, bestIdx, cached, this->Times[bestIdx],
+                          cost > 0.0 ? cost : 0.0);
+  this->Data[bestIdx] = this->DataCache->Peek(this, bestIdx);
+  cached->Delete();
+  this->DataCache->ReportCounters(this, outInfo);
 
   return result;
 }
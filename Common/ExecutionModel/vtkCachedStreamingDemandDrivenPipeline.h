@@ -14,7 +14,12 @@
 =========================================================================*/
 // .NAME vtkCachedStreamingDemandDrivenPipeline -
 // .SECTION Description
-// vtkCachedStreamingDemandDrivenPipeline
+// vtkCachedStreamingDemandDrivenPipeline keeps the last CacheSize images
+// its algorithm produced and reuses them for update extents they cover.
+// The images are stored in a vtkDataObjectCache, which can be shared with
+// other caches to bound the memory they use together. Its hit, miss and
+// eviction counters for this executive are reported in the output
+// information.
 
 #ifndef vtkCachedStreamingDemandDrivenPipeline_h
 #define vtkCachedStreamingDemandDrivenPipeline_h
@@ -22,6 +27,7 @@
 #include "vtkCommonExecutionModelModule.h" // For export macro
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+class vtkDataObjectCache;
 class vtkInformationIntegerKey;
 class vtkInformationIntegerVectorKey;
 class vtkCachedStreamingDemandDrivenPipelineInternals;
@@ -46,6 +52,14 @@ public:
   void SetCacheSize(int size);
   vtkGetMacro(CacheSize, int);
 
+  // Description:
+  // Store for the cached images. Each executive creates its own by
+  // default, without memory budget. Setting the same cache on several
+  // executives or filters makes them share its memory budget. Setting NULL
+  // goes back to a private cache.
+  void SetDataCache(vtkDataObjectCache* cache);
+  vtkGetObjectMacro(DataCache, vtkDataObjectCache);
+
 protected:
   vtkCachedStreamingDemandDrivenPipeline();
   ~vtkCachedStreamingDemandDrivenPipeline();
@@ -59,8 +73,12 @@ protected:
 
   int CacheSize;
 
+  // The image of slot i is stored in DataCache with key i, which owns it.
+  // Data[i] points to it; it is refreshed at each request and is NULL once
+  // the image has been evicted.
   vtkDataObject **Data;
   unsigned long *Times;
+  vtkDataObjectCache* DataCache;
 
 private:
   vtkCachedStreamingDemandDrivenPipelineInternals* CachedStreamingDemandDrivenInternal;
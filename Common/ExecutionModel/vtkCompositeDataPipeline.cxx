@@ -686,35 +686,9 @@ int vtkCompositeDataPipeline::ForwardUpstream(vtkInformation* request)
     {
     return 0;
     }
-  int port = request->Get(FROM_OUTPUT_PORT());
 
   // Forward the request upstream through all input connections.
-  int result = 1;
-  for(int i=0; i < this->GetNumberOfInputPorts(); ++i)
-    {
-    int nic = this->Algorithm->GetNumberOfInputConnections(i);
-    vtkInformationVector* inVector = this->GetInputInformation()[i];
-    for(int j=0; j < nic; ++j)
-      {
-      vtkInformation* info = inVector->GetInformationObject(j);
-      // Get the executive producing this input.  If there is none, then
-      // it is a NULL input.
-      vtkExecutive* e;
-      int producerPort;
-      vtkExecutive::PRODUCER()->Get(info, e, producerPort);
-      if(e)
-        {
-        request->Set(FROM_OUTPUT_PORT(), producerPort);
-        if(!e->ProcessRequest(request,
-                              e->GetInputInformation(),
-                              e->GetOutputInformation()))
-          {
-          result = 0;
-          }
-        request->Set(FROM_OUTPUT_PORT(), port);
-        }
-      }
-    }
+  int result = this->ForwardUpstreamToProducers(request);
 
   if (!this->Algorithm->ModifyRequest(request, AfterForward))
     {
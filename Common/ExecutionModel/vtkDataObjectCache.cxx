@@ -0,0 +1,514 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkDataObjectCache.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkDataObjectCache.h"
+
+#include "vtkDataObject.h"
+#include "vtkInformation.h"
+#include "vtkInformationIdTypeKey.h"
+#include "vtkObjectFactory.h"
+#include "vtkSimpleCriticalSection.h"
+
+#include <map>
+#include <utility>
+
+vtkStandardNewMacro(vtkDataObjectCache);
+
+vtkInformationKeyMacro(vtkDataObjectCache, HITS, IdType);
+vtkInformationKeyMacro(vtkDataObjectCache, MISSES, IdType);
+vtkInformationKeyMacro(vtkDataObjectCache, EVICTIONS, IdType);
+
+//----------------------------------------------------------------------------
+class vtkDataObjectCacheInternals
+{
+public:
+  // Eviction order: GreedyDual-Size priority (0 for LEAST_RECENTLY_USED),
+  // then last use. Entries are evicted by increasing rank.
+  typedef std::pair<double, unsigned long> RankType;
+
+  struct Entry
+  {
+    vtkDataObject* Data;
+    unsigned long Size;
+    unsigned long Time;
+    double Cost;
+    // Value of Clock when the entry was last inserted or found.
+    unsigned long LastUse;
+    // GreedyDual-Size priority: Inflation at last use + Cost / Size.
+    double Priority;
+    // Key of the entry in Order and OwnerOrder.
+    RankType Rank;
+  };
+  typedef std::pair<vtkObject*, double> KeyType;
+  typedef std::map<KeyType, Entry> EntryMapType;
+
+  // Ordered indices of the entries, over all owners and per owner, so that
+  // the entry to evict is found without scanning.
+  typedef std::map<RankType, EntryMapType::iterator> OrderType;
+  typedef std::map<std::pair<vtkObject*, RankType>,
+                   EntryMapType::iterator> OwnerOrderType;
+
+  struct Counters
+  {
+    Counters() : Hits(0), Misses(0), Evictions(0) {}
+    vtkIdType Hits;
+    vtkIdType Misses;
+    vtkIdType Evictions;
+  };
+  typedef std::map<vtkObject*, Counters> CounterMapType;
+
+  EntryMapType Entries;
+  OrderType Order;
+  OwnerOrderType OwnerOrder;
+  CounterMapType OwnerCounters;
+  Counters Total;
+  unsigned long MemorySize;
+  unsigned long Clock;
+  double Inflation;
+  int Policy;
+  vtkSimpleCriticalSection Lock;
+
+  vtkDataObjectCacheInternals()
+    : MemorySize(0), Clock(0), Inflation(0.0),
+      Policy(vtkDataObjectCache::LEAST_RECENTLY_USED) {}
+
+  void Link(EntryMapType::iterator i)
+    {
+    Entry& entry = i->second;
+    entry.Rank = RankType(
+      this->Policy == vtkDataObjectCache::COST_AWARE ? entry.Priority : 0.0,
+      entry.LastUse);
+    this->Order[entry.Rank] = i;
+    this->OwnerOrder[std::make_pair(i->first.first, entry.Rank)] = i;
+    }
+
+  void Unlink(EntryMapType::iterator i)
+    {
+    this->Order.erase(i->second.Rank);
+    this->OwnerOrder.erase(std::make_pair(i->first.first, i->second.Rank));
+    }
+
+  // Mark a linked entry as used.
+  void Touch(EntryMapType::iterator i)
+    {
+    this->Unlink(i);
+    this->Use(i->second);
+    this->Link(i);
+    }
+
+  void Use(Entry& entry)
+    {
+    entry.LastUse = ++this->Clock;
+    entry.Priority = this->Inflation +
+      entry.Cost / static_cast<double>(entry.Size > 0 ? entry.Size : 1);
+    }
+
+  void SetPolicy(int policy)
+    {
+    this->Policy = policy;
+    this->Order.clear();
+    this->OwnerOrder.clear();
+    for (EntryMapType::iterator i = this->Entries.begin();
+         i != this->Entries.end(); ++i)
+      {
+      this->Link(i);
+      }
+    }
+
+  void Erase(EntryMapType::iterator i)
+    {
+    this->Unlink(i);
+    this->MemorySize -= i->second.Size;
+    i->second.Data->UnRegister(0);
+    this->Entries.erase(i);
+    }
+
+  void Evict(EntryMapType::iterator i)
+    {
+    this->Inflation = i->second.Priority;
+    ++this->OwnerCounters[i->first.first].Evictions;
+    ++this->Total.Evictions;
+    this->Erase(i);
+    }
+
+  // Entry the policy evicts first, among the entries of owner, or of all
+  // owners if owner is NULL.
+  EntryMapType::iterator FindVictim(vtkObject* owner)
+    {
+    if (!owner)
+      {
+      return this->Order.empty() ?
+        this->Entries.end() : this->Order.begin()->second;
+      }
+    OwnerOrderType::iterator i = this->OwnerOrder.lower_bound(
+      std::make_pair(owner, RankType(VTK_DOUBLE_MIN, 0)));
+    return i != this->OwnerOrder.end() && i->first.first == owner ?
+      i->second : this->Entries.end();
+    }
+
+  // Evict entries until their total size is at most size.
+  void EvictToSize(unsigned long size)
+    {
+    while (this->MemorySize > size && !this->Entries.empty())
+      {
+      this->Evict(this->FindVictim(0));
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+vtkDataObjectCache::vtkDataObjectCache()
+{
+  this->MemoryBudget = 0;
+  this->EvictionPolicy = LEAST_RECENTLY_USED;
+  this->Internals = new vtkDataObjectCacheInternals;
+}
+
+//----------------------------------------------------------------------------
+vtkDataObjectCache::~vtkDataObjectCache()
+{
+  this->RemoveAll();
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+void vtkDataObjectCache::SetMemoryBudget(unsigned long budget)
+{
+  if (budget == this->MemoryBudget)
+    {
+    return;
+    }
+  this->MemoryBudget = budget;
+  if (budget > 0)
+    {
+    this->Internals->Lock.Lock();
+    this->Internals->EvictToSize(budget);
+    this->Internals->Lock.Unlock();
+    }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkDataObjectCache::SetEvictionPolicy(int policy)
+{
+  policy = policy < LEAST_RECENTLY_USED ? LEAST_RECENTLY_USED :
+    (policy > COST_AWARE ? COST_AWARE : policy);
+  if (policy == this->EvictionPolicy)
+    {
+    return;
+    }
+  this->EvictionPolicy = policy;
+  this->Internals->Lock.Lock();
+  this->Internals->SetPolicy(policy);
+  this->Internals->Lock.Unlock();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+bool vtkDataObjectCache::Insert(vtkObject* owner, double key,
+                                vtkDataObject* data, unsigned long time,
+                                double cost)
+{
+  if (!data)
+    {
+    this->Remove(owner, key);
+    return false;
+    }
+
+  unsigned long size = data->GetActualMemorySize();
+  vtkDataObjectCacheInternals* internals = this->Internals;
+  internals->Lock.Lock();
+  vtkDataObjectCacheInternals::KeyType entryKey(owner, key);
+  vtkDataObjectCacheInternals::EntryMapType::iterator i =
+    internals->Entries.find(entryKey);
+  if (i != internals->Entries.end())
+    {
+    internals->Erase(i);
+    }
+  bool stored = this->MemoryBudget == 0 || size <= this->MemoryBudget;
+  if (stored)
+    {
+    if (this->MemoryBudget > 0)
+      {
+      internals->EvictToSize(this->MemoryBudget - size);
+      }
+    i = internals->Entries.insert(std::make_pair(
+      entryKey, vtkDataObjectCacheInternals::Entry())).first;
+    vtkDataObjectCacheInternals::Entry& entry = i->second;
+    entry.Data = data;
+    entry.Size = size;
+    entry.Time = time;
+    entry.Cost = cost;
+    internals->Use(entry);
+    internals->Link(i);
+    internals->MemorySize += size;
+    data->Register(0);
+    }
+  internals->Lock.Unlock();
+  return stored;
+}
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkDataObject> vtkDataObjectCache::Find(vtkObject* owner,
+                                                        double key)
+{
+  vtkDataObjectCacheInternals* internals = this->Internals;
+  internals->Lock.Lock();
+  vtkDataObjectCacheInternals::EntryMapType::iterator i =
+    internals->Entries.find(vtkDataObjectCacheInternals::KeyType(owner, key));
+  vtkSmartPointer<vtkDataObject> data;
+  vtkDataObjectCacheInternals::Counters& counters =
+    internals->OwnerCounters[owner];
+  if (i != internals->Entries.end())
+    {
+    internals->Touch(i);
+    data = i->second.Data;
+    ++counters.Hits;
+    ++internals->Total.Hits;
+    }
+  else
+    {
+    ++counters.Misses;
+    ++internals->Total.Misses;
+    }
+  internals->Lock.Unlock();
+  return data;
+}
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkDataObject> vtkDataObjectCache::Peek(vtkObject* owner,
+                                                        double key)
+{
+  vtkDataObjectCacheInternals* internals = this->Internals;
+  internals->Lock.Lock();
+  vtkDataObjectCacheInternals::EntryMapType::iterator i =
+    internals->Entries.find(vtkDataObjectCacheInternals::KeyType(owner, key));
+  vtkSmartPointer<vtkDataObject> data;
+  if (i != internals->Entries.end())
+    {
+    data = i->second.Data;
+    }
+  internals->Lock.Unlock();
+  return data;
+}
+
+//----------------------------------------------------------------------------
+void vtkDataObjectCache::AddMiss(vtkObject* owner)
+{
+  this->Internals->Lock.Lock();
+  ++this->Internals->OwnerCounters[owner].Misses;
+  ++this->Internals->Total.Misses;
+  this->Internals->Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkDataObjectCache::Remove(vtkObject* owner, double key)
+{
+  vtkDataObjectCacheInternals* internals = this->Internals;
+  internals->Lock.Lock();
+  vtkDataObjectCacheInternals::EntryMapType::iterator i =
+    internals->Entries.find(vtkDataObjectCacheInternals::KeyType(owner, key));
+  if (i != internals->Entries.end())
+    {
+    internals->Erase(i);
+    }
+  internals->Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkDataObjectCache::RemoveOlderThan(vtkObject* owner, unsigned long time)
+{
+  vtkDataObjectCacheInternals* internals = this->Internals;
+  internals->Lock.Lock();
+  vtkDataObjectCacheInternals::EntryMapType::iterator i =
+    internals->Entries.begin();
+  while (i != internals->Entries.end())
+    {
+    if (i->first.first == owner && i->second.Time < time)
+      {
+      internals->Erase(i++);
+      }
+    else
+      {
+      ++i;
+      }
+    }
+  internals->Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkDataObjectCache::RemoveAll(vtkObject* owner)
+{
+  vtkDataObjectCacheInternals* internals = this->Internals;
+  internals->Lock.Lock();
+  vtkDataObjectCacheInternals::EntryMapType::iterator i =
+    internals->Entries.begin();
+  while (i != internals->Entries.end())
+    {
+    if (i->first.first == owner)
+      {
+      internals->Erase(i++);
+      }
+    else
+      {
+      ++i;
+      }
+    }
+  internals->Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkDataObjectCache::RemoveAll()
+{
+  vtkDataObjectCacheInternals* internals = this->Internals;
+  internals->Lock.Lock();
+  while (!internals->Entries.empty())
+    {
+    internals->Erase(internals->Entries.begin());
+    }
+  internals->Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkDataObjectCache::RemoveOwner(vtkObject* owner)
+{
+  this->RemoveAll(owner);
+  this->Internals->Lock.Lock();
+  this->Internals->OwnerCounters.erase(owner);
+  this->Internals->Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+bool vtkDataObjectCache::EvictOne(vtkObject* owner)
+{
+  vtkDataObjectCacheInternals* internals = this->Internals;
+  internals->Lock.Lock();
+  vtkDataObjectCacheInternals::EntryMapType::iterator victim =
+    internals->FindVictim(owner);
+  bool found = victim != internals->Entries.end();
+  if (found)
+    {
+    internals->Evict(victim);
+    }
+  internals->Lock.Unlock();
+  return found;
+}
+
+//----------------------------------------------------------------------------
+int vtkDataObjectCache::GetNumberOfEntries(vtkObject* owner)
+{
+  vtkDataObjectCacheInternals* internals = this->Internals;
+  internals->Lock.Lock();
+  int count = 0;
+  for (vtkDataObjectCacheInternals::EntryMapType::iterator i =
+         internals->Entries.lower_bound(
+           vtkDataObjectCacheInternals::KeyType(owner, VTK_DOUBLE_MIN));
+       i != internals->Entries.end() && i->first.first == owner; ++i)
+    {
+    ++count;
+    }
+  internals->Lock.Unlock();
+  return count;
+}
+
+//----------------------------------------------------------------------------
+int vtkDataObjectCache::GetNumberOfEntries()
+{
+  this->Internals->Lock.Lock();
+  int count = static_cast<int>(this->Internals->Entries.size());
+  this->Internals->Lock.Unlock();
+  return count;
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkDataObjectCache::GetMemorySize(vtkObject* owner)
+{
+  vtkDataObjectCacheInternals* internals = this->Internals;
+  internals->Lock.Lock();
+  unsigned long size = 0;
+  for (vtkDataObjectCacheInternals::EntryMapType::iterator i =
+         internals->Entries.lower_bound(
+           vtkDataObjectCacheInternals::KeyType(owner, VTK_DOUBLE_MIN));
+       i != internals->Entries.end() && i->first.first == owner; ++i)
+    {
+    size += i->second.Size;
+    }
+  internals->Lock.Unlock();
+  return size;
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkDataObjectCache::GetMemorySize()
+{
+  this->Internals->Lock.Lock();
+  unsigned long size = this->Internals->MemorySize;
+  this->Internals->Lock.Unlock();
+  return size;
+}
+
+//----------------------------------------------------------------------------
+#define vtkDataObjectCacheCounterMacro(name)                            \
+vtkIdType vtkDataObjectCache::GetNumberOf##name(vtkObject* owner)       \
+{                                                                       \
+  this->Internals->Lock.Lock();                                         \
+  vtkDataObjectCacheInternals::CounterMapType::iterator i =             \
+    this->Internals->OwnerCounters.find(owner);                         \
+  vtkIdType count =                                                     \
+    i != this->Internals->OwnerCounters.end() ? i->second.name : 0;     \
+  this->Internals->Lock.Unlock();                                       \
+  return count;                                                         \
+}                                                                       \
+vtkIdType vtkDataObjectCache::GetNumberOf##name()                       \
+{                                                                       \
+  this->Internals->Lock.Lock();                                         \
+  vtkIdType count = this->Internals->Total.name;                        \
+  this->Internals->Lock.Unlock();                                       \
+  return count;                                                         \
+}
+vtkDataObjectCacheCounterMacro(Hits)
+vtkDataObjectCacheCounterMacro(Misses)
+vtkDataObjectCacheCounterMacro(Evictions)
+#undef vtkDataObjectCacheCounterMacro
+
+//----------------------------------------------------------------------------
+void vtkDataObjectCache::ReportCounters(vtkObject* owner, vtkInformation* info)
+{
+  if (!info)
+    {
+    return;
+    }
+  this->Internals->Lock.Lock();
+  vtkDataObjectCacheInternals::Counters counters =
+    this->Internals->OwnerCounters[owner];
+  this->Internals->Lock.Unlock();
+  info->Set(HITS(), counters.Hits);
+  info->Set(MISSES(), counters.Misses);
+  info->Set(EVICTIONS(), counters.Evictions);
+}
+
+//----------------------------------------------------------------------------
+void vtkDataObjectCache::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "MemoryBudget: " << this->MemoryBudget << "\n";
+  os << indent << "EvictionPolicy: "
+     << (this->EvictionPolicy == COST_AWARE ?
+         "COST_AWARE" : "LEAST_RECENTLY_USED") << "\n";
+  os << indent << "NumberOfEntries: " << this->GetNumberOfEntries() << "\n";
+  os << indent << "MemorySize: " << this->GetMemorySize() << "\n";
+  os << indent << "NumberOfHits: " << this->GetNumberOfHits() << "\n";
+  os << indent << "NumberOfMisses: " << this->GetNumberOfMisses() << "\n";
+  os << indent << "NumberOfEvictions: " << this->GetNumberOfEvictions()
+     << "\n";
+}
@@ -0,0 +1,182 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkDataObjectCache.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkDataObjectCache - memory budgeted store for cached pipeline results
+// .SECTION Description
+// vtkDataObjectCache holds data objects kept by caching algorithms and
+// executives (vtkTemporalDataSetCache, vtkCachedStreamingDemandDrivenPipeline)
+// and bounds the memory they use. Every entry belongs to an owner and is
+// identified by a key chosen by that owner, such as a time step. The size
+// of an entry is the GetActualMemorySize() of its data object when it is
+// inserted. When the total size exceeds MemoryBudget, entries of any owner
+// are evicted until it fits, so that a single cache shared by several
+// filters bounds the memory they use together.
+//
+// The LEAST_RECENTLY_USED policy evicts the entry that was inserted or found
+// the longest time ago. The COST_AWARE policy (GreedyDual-Size) evicts
+// first the entries whose cost to recompute, given at insertion, is low
+// relative to their size, while still aging entries that are not used.
+//
+// Entries are kept in ordered indices, so that the entry to evict is found
+// in logarithmic time.
+//
+// The hits, misses and evictions of each owner are counted; owners report
+// them in their output information with the HITS(), MISSES() and
+// EVICTIONS() keys. The cache can be used from several threads.
+//
+// .SECTION Caveats
+// Entries are usually shallow copies that share their arrays with other
+// data objects. Their size is counted in full for each entry.
+//
+// .SECTION See Also
+// vtkTemporalDataSetCache vtkCachedStreamingDemandDrivenPipeline
+
+#ifndef vtkDataObjectCache_h
+#define vtkDataObjectCache_h
+
+#include "vtkCommonExecutionModelModule.h" // For export macro
+#include "vtkObject.h"
+#include "vtkSmartPointer.h" // For Find() and Peek()
+
+class vtkDataObject;
+class vtkDataObjectCacheInternals;
+class vtkInformation;
+class vtkInformationIdTypeKey;
+
+class VTKCOMMONEXECUTIONMODEL_EXPORT vtkDataObjectCache : public vtkObject
+{
+public:
+  static vtkDataObjectCache* New();
+  vtkTypeMacro(vtkDataObjectCache, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Maximum total size of the entries, in kibibytes (the unit of
+  // vtkDataObject::GetActualMemorySize()). 0, the default, means no limit.
+  // Lowering the budget evicts entries right away.
+  void SetMemoryBudget(unsigned long budget);
+  vtkGetMacro(MemoryBudget, unsigned long);
+
+  //BTX
+  enum EvictionPolicies
+  {
+    LEAST_RECENTLY_USED = 0,
+    COST_AWARE = 1
+  };
+  //ETX
+
+  // Description:
+  // How entries are chosen for eviction. Defaults to LEAST_RECENTLY_USED.
+  void SetEvictionPolicy(int policy);
+  vtkGetMacro(EvictionPolicy, int);
+  void SetEvictionPolicyToLeastRecentlyUsed()
+    { this->SetEvictionPolicy(LEAST_RECENTLY_USED); }
+  void SetEvictionPolicyToCostAware()
+    { this->SetEvictionPolicy(COST_AWARE); }
+
+  // Description:
+  // Store data for (owner, key), replacing any previous entry. The cache
+  // keeps a reference to data. time is compared against in RemoveOlderThan()
+  // and cost is the (relative) cost of recomputing data, used by the
+  // COST_AWARE policy. Entries larger than the whole budget are not stored.
+  // Return true if the entry was stored.
+  bool Insert(vtkObject* owner, double key, vtkDataObject* data,
+              unsigned long time, double cost = 1.0);
+
+  // Description:
+  // Return the data stored for (owner, key), or NULL. This counts as a hit
+  // or a miss of owner and marks the entry as used. The returned pointer
+  // holds a reference taken under the lock, so the data stays valid for as
+  // long as the caller keeps it, even if another thread evicts the entry.
+  vtkSmartPointer<vtkDataObject> Find(vtkObject* owner, double key);
+
+  // Description:
+  // Return the data stored for (owner, key), or NULL, without touching the
+  // counters or the eviction order. Ownership is as for Find().
+  vtkSmartPointer<vtkDataObject> Peek(vtkObject* owner, double key);
+
+  // Description:
+  // Count a miss of owner. Owners that search their entries with Peek()
+  // count a hit by calling Find() on the entry they use, and a miss with
+  // this method.
+  void AddMiss(vtkObject* owner);
+
+  // Description:
+  // Remove the entry for (owner, key), if any.
+  void Remove(vtkObject* owner, double key);
+
+  // Description:
+  // Remove the entries of owner whose time is older than time.
+  void RemoveOlderThan(vtkObject* owner, unsigned long time);
+
+  // Description:
+  // Remove all the entries of owner, or of all owners.
+  void RemoveAll(vtkObject* owner);
+  void RemoveAll();
+
+  // Description:
+  // Remove the entries and the counters of owner. Owners call this when
+  // they are destroyed or stop using the cache.
+  void RemoveOwner(vtkObject* owner);
+
+  // Description:
+  // Evict the entry of owner that the policy would evict first. Owners
+  // use this to bound their own number of entries. Return false if owner
+  // has no entries.
+  bool EvictOne(vtkObject* owner);
+
+  // Description:
+  // Number of entries and total size in kibibytes, of owner or of all
+  // owners.
+  int GetNumberOfEntries(vtkObject* owner);
+  int GetNumberOfEntries();
+  unsigned long GetMemorySize(vtkObject* owner);
+  unsigned long GetMemorySize();
+
+  // Description:
+  // Counters of owner, or of all owners. Evictions count the entries
+  // removed to honor the budget or by EvictOne().
+  vtkIdType GetNumberOfHits(vtkObject* owner);
+  vtkIdType GetNumberOfMisses(vtkObject* owner);
+  vtkIdType GetNumberOfEvictions(vtkObject* owner);
+  vtkIdType GetNumberOfHits();
+  vtkIdType GetNumberOfMisses();
+  vtkIdType GetNumberOfEvictions();
+
+  // Description:
+  // Keys under which owners report their counters in their output
+  // information.
+  static vtkInformationIdTypeKey* HITS();
+  static vtkInformationIdTypeKey* MISSES();
+  static vtkInformationIdTypeKey* EVICTIONS();
+
+  // Description:
+  // Copy the counters of owner to info, with the keys above.
+  void ReportCounters(vtkObject* owner, vtkInformation* info);
+
+protected:
+  vtkDataObjectCache();
+  ~vtkDataObjectCache();
+
+  unsigned long MemoryBudget;
+  int EvictionPolicy;
+
+private:
+  vtkDataObjectCacheInternals* Internals;
+
+  vtkDataObjectCache(const vtkDataObjectCache&);  // Not implemented.
+  void operator=(const vtkDataObjectCache&);  // Not implemented.
+};
+
+#endif
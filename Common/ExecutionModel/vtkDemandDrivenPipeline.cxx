@@ -33,8 +33,11 @@
 #include "vtkInformationVector.h"
 #include "vtkInstantiator.h"
 #include "vtkObjectFactory.h"
+#include "vtkPipelineStatistics.h"
 #include "vtkPointData.h"
+#include "vtkSMPTools.h"
 
+#include <map>
 #include <vector>
 
 vtkStandardNewMacro(vtkDemandDrivenPipeline);
@@ -53,6 +56,7 @@ vtkDemandDrivenPipeline::vtkDemandDrivenPipeline()
   this->DataObjectRequest = 0;
   this->DataRequest = 0;
   this->PipelineMTime = 0;
+  this->ConcurrentUpstream = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -77,6 +81,7 @@ void vtkDemandDrivenPipeline::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
   os << indent << "PipelineMTime: " << this->PipelineMTime << "\n";
+  os << indent << "ConcurrentUpstream: " << this->ConcurrentUpstream << "\n";
 }
 
 
@@ -271,7 +276,17 @@ int vtkDemandDrivenPipeline::ProcessRequest(vtkInformation* request,
         }
 
       // Request data from the algorithm.
+      vtkPipelineStatistics* statistics = this->GetActiveStatistics();
+      vtkPipelineStatistics::Sample start;
+      if (statistics)
+        {
+        statistics->StartExecution(start);
+        }
       result = this->ExecuteData(request,inInfoVec,outInfoVec);
+      if (statistics)
+        {
+        statistics->EndExecution(this->Algorithm, start, outInfoVec);
+        }
 
       // Data are now up to date.
       this->DataTime.Modified();
@@ -287,6 +302,10 @@ int vtkDemandDrivenPipeline::ProcessRequest(vtkInformation* request,
       this->InformationTime.Modified();
       this->DataObjectTime.Modified();
       }
+    else if (vtkPipelineStatistics* statistics = this->GetActiveStatistics())
+      {
+      statistics->AddCacheHit(this->Algorithm);
+      }
     return result;
     }
 
@@ -294,6 +313,163 @@ int vtkDemandDrivenPipeline::ProcessRequest(vtkInformation* request,
   return this->Superclass::ProcessRequest(request, inInfoVec, outInfoVec);
 }
 
+//----------------------------------------------------------------------------
+namespace
+{
+// An input connection: the executive producing it and its output port.
+struct vtkDemandDrivenPipelineProducer
+{
+  vtkExecutive* Executive;
+  int Port;
+};
+
+typedef std::vector<vtkDemandDrivenPipelineProducer> vtkDemandDrivenPipelineBranch;
+
+// Assign to branch every executive upstream of e that has none yet, and
+// merge the branches that meet.
+void vtkDemandDrivenPipelineMarkUpstream(
+  vtkExecutive* e, int branch, std::map<vtkExecutive*, int>& owners,
+  std::vector<int>& parents)
+{
+  std::map<vtkExecutive*, int>::iterator found = owners.find(e);
+  if (found != owners.end())
+    {
+    int a = found->second;
+    while (parents[a] != a)
+      {
+      a = parents[a];
+      }
+    int b = branch;
+    while (parents[b] != b)
+      {
+      b = parents[b];
+      }
+    parents[a > b ? a : b] = a > b ? b : a;
+    return;
+    }
+  owners[e] = branch;
+  vtkAlgorithm* algorithm = e->GetAlgorithm();
+  for (int i = 0; i < algorithm->GetNumberOfInputPorts(); ++i)
+    {
+    for (int j = 0; j < algorithm->GetNumberOfInputConnections(i); ++j)
+      {
+      if (vtkExecutive* input = e->GetInputExecutive(i, j))
+        {
+        vtkDemandDrivenPipelineMarkUpstream(input, branch, owners, parents);
+        }
+      }
+    }
+}
+
+// Send a copy of the request up each branch; the branches run
+// concurrently, the producers of a branch one after the other.
+class vtkDemandDrivenPipelineForwardBranches
+{
+public:
+  vtkDemandDrivenPipelineForwardBranches(
+    vtkInformation* request,
+    std::vector<vtkDemandDrivenPipelineBranch>& branches) :
+    Request(request), Branches(branches), Results(branches.size(), 1)
+    {
+    }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    for (vtkIdType b = begin; b < end; ++b)
+      {
+      vtkInformation* request = vtkInformation::New();
+      request->Copy(this->Request);
+      // The request key is not an entry: Copy() leaves it out.
+      request->SetRequest(this->Request->GetRequest());
+      vtkDemandDrivenPipelineBranch& branch = this->Branches[b];
+      for (size_t k = 0; k < branch.size(); ++k)
+        {
+        vtkExecutive* e = branch[k].Executive;
+        request->Set(vtkExecutive::FROM_OUTPUT_PORT(), branch[k].Port);
+        if (!e->ProcessRequest(request,
+                               e->GetInputInformation(),
+                               e->GetOutputInformation()))
+          {
+          this->Results[b] = 0;
+          }
+        }
+      request->Delete();
+      }
+    }
+
+  vtkInformation* Request;
+  std::vector<vtkDemandDrivenPipelineBranch>& Branches;
+  std::vector<int> Results;
+};
+}
+
+//----------------------------------------------------------------------------
+int vtkDemandDrivenPipeline::ForwardUpstreamToProducers(
+  vtkInformation* request)
+{
+  if (!this->ConcurrentUpstream || !request->Has(REQUEST_DATA()))
+    {
+    return this->Superclass::ForwardUpstreamToProducers(request);
+    }
+
+  // Group the input connections into branches whose pipelines share no
+  // executive.
+  std::vector<vtkDemandDrivenPipelineProducer> producers;
+  std::vector<int> parents;
+  std::map<vtkExecutive*, int> owners;
+  for (int i = 0; i < this->GetNumberOfInputPorts(); ++i)
+    {
+    vtkInformationVector* inVector = this->GetInputInformation()[i];
+    int nic = this->Algorithm->GetNumberOfInputConnections(i);
+    for (int j = 0; j < nic; ++j)
+      {
+      vtkInformation* info = inVector->GetInformationObject(j);
+      vtkDemandDrivenPipelineProducer producer;
+      vtkExecutive::PRODUCER()->Get(info, producer.Executive, producer.Port);
+      if (producer.Executive)
+        {
+        int branch = static_cast<int>(producers.size());
+        producers.push_back(producer);
+        parents.push_back(branch);
+        vtkDemandDrivenPipelineMarkUpstream(
+          producer.Executive, branch, owners, parents);
+        }
+      }
+    }
+
+  std::vector<vtkDemandDrivenPipelineBranch> branches;
+  std::vector<int> branchOfRoot(producers.size(), -1);
+  for (size_t k = 0; k < producers.size(); ++k)
+    {
+    int root = static_cast<int>(k);
+    while (parents[root] != root)
+      {
+      root = parents[root];
+      }
+    if (branchOfRoot[root] < 0)
+      {
+      branchOfRoot[root] = static_cast<int>(branches.size());
+      branches.push_back(vtkDemandDrivenPipelineBranch());
+      }
+    branches[branchOfRoot[root]].push_back(producers[k]);
+    }
+  if (branches.size() < 2)
+    {
+    return this->Superclass::ForwardUpstreamToProducers(request);
+    }
+
+  vtkDemandDrivenPipelineForwardBranches forward(request, branches);
+  vtkSMPTools::For(0, static_cast<vtkIdType>(branches.size()), 1, forward);
+  for (size_t b = 0; b < branches.size(); ++b)
+    {
+    if (!forward.Results[b])
+      {
+      return 0;
+      }
+    }
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 void vtkDemandDrivenPipeline::ResetPipelineInformation(int,
                                                        vtkInformation*)
@@ -75,6 +75,19 @@ public:
   // Get the PipelineMTime for this exective.
   vtkGetMacro(PipelineMTime, unsigned long);
 
+  // Description:
+  // When on, the input connections of the algorithm whose upstream
+  // pipelines share no executive are brought up to date concurrently,
+  // with vtkSMPTools, during the REQUEST_DATA pass: a filter reading two
+  // files through two readers waits for the slowest reader instead of
+  // for both. Connections whose pipelines meet upstream are updated one
+  // after the other, as when this is off (the default). The algorithms
+  // of independent branches then execute on several threads; observers
+  // of their events must be thread safe.
+  vtkSetMacro(ConcurrentUpstream, int);
+  vtkGetMacro(ConcurrentUpstream, int);
+  vtkBooleanMacro(ConcurrentUpstream, int);
+
   // Description:
   // Set whether the given output port releases data when it is
   // consumed.  Returns 1 if the the value changes and 0 otherwise.
@@ -203,10 +216,16 @@ protected:
                                     vtkInformationVector** inInfoVec,
                                     vtkInformationVector* outInfoVec);
 
+  // Update independent upstream branches concurrently when
+  // ConcurrentUpstream is on.
+  virtual int ForwardUpstreamToProducers(vtkInformation* request);
+
   // Largest MTime of any algorithm on this executive or preceding
   // executives.
   unsigned long PipelineMTime;
 
+  int ConcurrentUpstream;
+
   // Time when information or data were last generated.
   vtkTimeStamp DataObjectTime;
   vtkTimeStamp InformationTime;
@@ -26,6 +26,7 @@
 #include "vtkInformationKeyVectorKey.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
+#include "vtkPipelineStatistics.h"
 #include "vtkSmartPointer.h"
 
 #include <vector>
@@ -42,6 +43,10 @@ vtkInformationKeyMacro(vtkExecutive, FROM_OUTPUT_PORT, Integer);
 vtkInformationKeyMacro(vtkExecutive, KEYS_TO_COPY, KeyVector);
 vtkInformationKeyMacro(vtkExecutive, PRODUCER, ExecutivePort);
 
+vtkCxxSetObjectMacro(vtkExecutive, Statistics, vtkPipelineStatistics);
+
+vtkPipelineStatistics* vtkExecutive::DefaultStatistics = 0;
+
 //----------------------------------------------------------------------------
 class vtkExecutiveInternals
 {
@@ -124,12 +129,14 @@ vtkExecutive::vtkExecutive()
   this->InAlgorithm = 0;
   this->SharedInputInformation = 0;
   this->SharedOutputInformation = 0;
+  this->Statistics = 0;
 }
 
 //----------------------------------------------------------------------------
 vtkExecutive::~vtkExecutive()
 {
   this->SetAlgorithm(0);
+  this->SetStatistics(0);
   if(this->OutputInformation)
     {
     this->OutputInformation->Delete();
@@ -149,6 +156,32 @@ void vtkExecutive::PrintSelf(ostream& os, vtkIndent indent)
     {
     os << indent << "Algorithm: (none)\n";
     }
+  os << indent << "Statistics: " << this->Statistics << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkExecutive::SetDefaultStatistics(vtkPipelineStatistics* statistics)
+{
+  if (vtkExecutive::DefaultStatistics == statistics)
+    {
+    return;
+    }
+  if (vtkExecutive::DefaultStatistics)
+    {
+    vtkExecutive::DefaultStatistics->UnRegister(0);
+    vtkExecutive::DefaultStatistics = 0;
+    }
+  if (statistics)
+    {
+    statistics->Register(0);
+    }
+  vtkExecutive::DefaultStatistics = statistics;
+}
+
+//----------------------------------------------------------------------------
+vtkPipelineStatistics* vtkExecutive::GetDefaultStatistics()
+{
+  return vtkExecutive::DefaultStatistics;
 }
 
 //----------------------------------------------------------------------------
@@ -623,6 +656,20 @@ int vtkExecutive::ForwardUpstream(vtkInformation* request)
     }
 
   // Forward the request upstream through all input connections.
+  int result = this->ForwardUpstreamToProducers(request);
+
+  if (!this->Algorithm->ModifyRequest(request, AfterForward))
+    {
+    return 0;
+    }
+
+  return result;
+}
+
+//----------------------------------------------------------------------------
+int vtkExecutive::ForwardUpstreamToProducers(vtkInformation* request)
+{
+  int port = request->Get(FROM_OUTPUT_PORT());
   int result = 1;
   for(int i=0; i < this->GetNumberOfInputPorts(); ++i)
     {
@@ -638,7 +685,6 @@ int vtkExecutive::ForwardUpstream(vtkInformation* request)
       vtkExecutive::PRODUCER()->Get(info,e,producerPort);
       if(e)
         {
-        int port = request->Get(FROM_OUTPUT_PORT());
         request->Set(FROM_OUTPUT_PORT(), producerPort);
         if(!e->ProcessRequest(request,
                               e->GetInputInformation(),
@@ -650,12 +696,6 @@ int vtkExecutive::ForwardUpstream(vtkInformation* request)
         }
       }
     }
-
-  if (!this->Algorithm->ModifyRequest(request, AfterForward))
-    {
-    return 0;
-    }
-
   return result;
 }
 
@@ -39,6 +39,7 @@ class vtkInformationIntegerKey;
 class vtkInformationRequestKey;
 class vtkInformationKeyVectorKey;
 class vtkInformationVector;
+class vtkPipelineStatistics;
 
 class VTKCOMMONEXECUTIONMODEL_EXPORT vtkExecutive : public vtkObject
 {
@@ -187,6 +188,15 @@ public:
                             vtkInformationVector** inInfo,
                             vtkInformationVector* outInfo);
 
+  // Description:
+  // Statistics recording the executions of the algorithm. Executives
+  // without statistics of their own use DefaultStatistics. None is set by
+  // default.
+  void SetStatistics(vtkPipelineStatistics* statistics);
+  vtkGetObjectMacro(Statistics, vtkPipelineStatistics);
+  static void SetDefaultStatistics(vtkPipelineStatistics* statistics);
+  static vtkPipelineStatistics* GetDefaultStatistics();
+
 protected:
   vtkExecutive();
   ~vtkExecutive();
@@ -208,6 +218,10 @@ protected:
 
   virtual int ForwardDownstream(vtkInformation* request);
   virtual int ForwardUpstream(vtkInformation* request);
+
+  // Send the request to the executive of every input connection, after
+  // the algorithm had a chance to modify it.  Called by ForwardUpstream().
+  virtual int ForwardUpstreamToProducers(vtkInformation* request);
   virtual void CopyDefaultInformation(vtkInformation* request, int direction,
                                       vtkInformationVector** inInfo,
                                       vtkInformationVector* outInfo);
@@ -223,6 +237,12 @@ protected:
 
   virtual void SetAlgorithm(vtkAlgorithm* algorithm);
 
+  // Statistics recording the executions, or NULL.
+  vtkPipelineStatistics* GetActiveStatistics()
+    {
+    return this->Statistics ? this->Statistics : DefaultStatistics;
+    }
+
   // The algorithm managed by this executive.
   vtkAlgorithm* Algorithm;
 
@@ -235,6 +255,9 @@ protected:
   vtkInformationVector** SharedInputInformation;
   vtkInformationVector* SharedOutputInformation;
 
+  vtkPipelineStatistics* Statistics;
+  static vtkPipelineStatistics* DefaultStatistics;
+
 private:
   // Store an information object for each output port of the algorithm.
   vtkInformationVector* OutputInformation;
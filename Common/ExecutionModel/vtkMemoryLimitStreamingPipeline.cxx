@@ -0,0 +1,401 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkMemoryLimitStreamingPipeline.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkMemoryLimitStreamingPipeline.h"
+
+#include "vtkAlgorithm.h"
+#include "vtkDataObject.h"
+#include "vtkInformation.h"
+#include "vtkInformationExecutivePortKey.h"
+#include "vtkInformationIntegerKey.h"
+#include "vtkInformationVector.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkSmartPointer.h"
+#include "vtkUpdateFuture.h"
+
+#include <cmath>
+#include <set>
+#include <utility>
+#include <vector>
+
+vtkStandardNewMacro(vtkMemoryLimitStreamingPipeline);
+
+vtkCxxSetObjectMacro(vtkMemoryLimitStreamingPipeline, AppendAlgorithm,
+                     vtkAlgorithm);
+
+//----------------------------------------------------------------------------
+class vtkMemoryLimitStreamingPipelineInternals
+{
+public:
+  vtkMemoryLimitStreamingPipelineInternals() :
+    Split(false), NumberOfPieces(0), NextNumberOfPieces(0) {}
+
+  // The (piece, number of pieces) requested by the algorithm from each
+  // input connection, in port then connection order.
+  std::vector<std::pair<int, int> > Requests;
+
+  // Whether the input requests are split for the coming REQUEST_DATA, and
+  // into how many pieces.
+  bool Split;
+  int NumberOfPieces;
+
+  // Number of pieces to start the next update with; 0 before the first.
+  int NextNumberOfPieces;
+
+  // Outputs of the pieces processed so far, appended after the last one.
+  std::vector<vtkSmartPointer<vtkDataObject> > Outputs;
+};
+
+//----------------------------------------------------------------------------
+vtkMemoryLimitStreamingPipeline::vtkMemoryLimitStreamingPipeline()
+{
+  this->MemoryLimit = 0;
+  this->InitialNumberOfPieces = 8;
+  this->MaximumNumberOfPieces = 1024;
+  this->Prefetch = 0;
+  this->AppendAlgorithm = 0;
+  this->NumberOfPieces = 0;
+  this->PeakMemorySize = 0;
+  this->Internals = new vtkMemoryLimitStreamingPipelineInternals;
+}
+
+//----------------------------------------------------------------------------
+vtkMemoryLimitStreamingPipeline::~vtkMemoryLimitStreamingPipeline()
+{
+  this->SetAppendAlgorithm(0);
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMemoryLimitStreamingPipeline::CanStream()
+{
+  vtkAlgorithm* algorithm = this->GetAlgorithm();
+  if (!algorithm || this->GetNumberOfInputPorts() == 0)
+    {
+    return false;
+    }
+  int numOutputs = algorithm->GetNumberOfOutputPorts();
+  if (numOutputs > 1 || (numOutputs == 1 && !this->AppendAlgorithm))
+    {
+    vtkWarningMacro("Cannot stream " << algorithm->GetClassName()
+                    << ": it needs one output port at most, and an "
+                    "AppendAlgorithm if it has one.");
+    return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int vtkMemoryLimitStreamingPipeline::ForwardUpstream(vtkInformation* request)
+{
+  if (this->MemoryLimit > 0 && request->Has(REQUEST_UPDATE_EXTENT()) &&
+      this->CanStream())
+    {
+    vtkMemoryLimitStreamingPipelineInternals* internals = this->Internals;
+
+    // Record the requests of the algorithm. The inputs of an algorithm
+    // without outputs still hold a split request if the previous one was
+    // not executed: keep the recorded requests then.
+    if (!internals->Split || this->Algorithm->GetNumberOfOutputPorts() > 0)
+      {
+      internals->Requests.clear();
+      for (int i = 0; i < this->GetNumberOfInputPorts(); ++i)
+        {
+        for (int j = 0; j < this->Algorithm->GetNumberOfInputConnections(i); ++j)
+          {
+          vtkInformation* inInfo = this->GetInputInformation(i, j);
+          int piece = inInfo->Has(UPDATE_PIECE_NUMBER()) ?
+            inInfo->Get(UPDATE_PIECE_NUMBER()) : 0;
+          int numPieces = inInfo->Has(UPDATE_NUMBER_OF_PIECES()) ?
+            inInfo->Get(UPDATE_NUMBER_OF_PIECES()) : 1;
+          internals->Requests.push_back(std::make_pair(piece, numPieces));
+          }
+        }
+      }
+
+    internals->NumberOfPieces = internals->NextNumberOfPieces > 0 ?
+      internals->NextNumberOfPieces : this->InitialNumberOfPieces;
+    internals->Split = true;
+    this->SetInputPieces(0, internals->NumberOfPieces);
+    }
+
+  return this->Superclass::ForwardUpstream(request);
+}
+
+//----------------------------------------------------------------------------
+void vtkMemoryLimitStreamingPipeline::SetInputPieces(int piece, int numPieces)
+{
+  size_t index = 0;
+  for (int i = 0; i < this->GetNumberOfInputPorts(); ++i)
+    {
+    for (int j = 0; j < this->Algorithm->GetNumberOfInputConnections(i) &&
+           index < this->Internals->Requests.size(); ++j, ++index)
+      {
+      vtkInformation* inInfo = this->GetInputInformation(i, j);
+      const std::pair<int, int>& request = this->Internals->Requests[index];
+      if (numPieces > 0)
+        {
+        inInfo->Set(UPDATE_PIECE_NUMBER(), request.first * numPieces + piece);
+        inInfo->Set(UPDATE_NUMBER_OF_PIECES(), request.second * numPieces);
+        }
+      else
+        {
+        inInfo->Set(UPDATE_PIECE_NUMBER(), request.first);
+        inInfo->Set(UPDATE_NUMBER_OF_PIECES(), request.second);
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkMemoryLimitStreamingPipeline::UpdateInputs()
+{
+  std::set<std::pair<vtkExecutive*, int> > updated;
+  for (int i = 0; i < this->GetNumberOfInputPorts(); ++i)
+    {
+    for (int j = 0; j < this->Algorithm->GetNumberOfInputConnections(i); ++j)
+      {
+      vtkExecutive* producer;
+      int port;
+      vtkExecutive::PRODUCER()->Get(this->GetInputInformation(i, j),
+                                    producer, port);
+      if (producer && updated.insert(std::make_pair(producer, port)).second &&
+          !producer->Update(port))
+        {
+        return 0;
+        }
+      }
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkMemoryLimitStreamingPipeline::GetUpstreamMemorySize()
+{
+  unsigned long size = 0;
+  std::set<vtkExecutive*> visited;
+  std::vector<vtkExecutive*> stack(1, this);
+  while (!stack.empty())
+    {
+    vtkExecutive* executive = stack.back();
+    stack.pop_back();
+    for (int i = 0; i < executive->GetNumberOfInputPorts(); ++i)
+      {
+      for (int j = 0; j < executive->GetNumberOfInputConnections(i); ++j)
+        {
+        vtkExecutive* producer;
+        int port;
+        vtkExecutive::PRODUCER()->Get(executive->GetInputInformation(i, j),
+                                      producer, port);
+        if (!producer || !visited.insert(producer).second)
+          {
+          continue;
+          }
+        for (int k = 0; k < producer->GetNumberOfOutputPorts(); ++k)
+          {
+          vtkDataObject* data = producer->GetOutputInformation(k)->Get(
+            vtkDataObject::DATA_OBJECT());
+          if (data)
+            {
+            size += data->GetActualMemorySize();
+            }
+          }
+        stack.push_back(producer);
+        }
+      }
+    }
+  return size;
+}
+
+//----------------------------------------------------------------------------
+int vtkMemoryLimitStreamingPipeline::ExecuteData(
+  vtkInformation* request,
+  vtkInformationVector** inInfoVec,
+  vtkInformationVector* outInfoVec)
+{
+  vtkMemoryLimitStreamingPipelineInternals* internals = this->Internals;
+  if (!internals->Split)
+    {
+    return this->Superclass::ExecuteData(request, inInfoVec, outInfoVec);
+    }
+  internals->Split = false;
+
+  // Prefetching keeps two pieces: each gets half of the memory.
+  int numPorts = this->GetNumberOfInputPorts();
+  bool prefetch = this->Prefetch && internals->Requests.size() == 1;
+  unsigned long limit = this->MemoryLimit;
+  if (prefetch && limit > 1)
+    {
+    limit /= 2;
+    }
+
+  // The inputs hold the first piece. Split them further while it is too
+  // large.
+  int numPieces = internals->NumberOfPieces;
+  unsigned long size = this->GetUpstreamMemorySize();
+  while (size > limit && numPieces < this->MaximumNumberOfPieces)
+    {
+    double needed = std::ceil(static_cast<double>(size) * numPieces / limit);
+    numPieces = needed > this->MaximumNumberOfPieces ?
+      this->MaximumNumberOfPieces : static_cast<int>(needed);
+    this->SetInputPieces(0, numPieces);
+    if (!this->UpdateInputs())
+      {
+      this->SetInputPieces(0, 0);
+      return 0;
+      }
+    size = this->GetUpstreamMemorySize();
+    }
+  unsigned long peak = size;
+
+  vtkDataObject* output = 0;
+  if (this->Algorithm->GetNumberOfOutputPorts() > 0)
+    {
+    output = outInfoVec->GetInformationObject(0)->Get(
+      vtkDataObject::DATA_OBJECT());
+    }
+
+  int result = 1;
+  for (int piece = 0; piece < numPieces && result; ++piece)
+    {
+    bool last = (piece == numPieces - 1);
+    if (prefetch && !last)
+      {
+      // The algorithm processes a copy of the piece while the producer
+      // replaces it with the next one.
+      std::vector<vtkSmartPointer<vtkInformationVector> > copies(numPorts);
+      std::vector<vtkInformationVector*> copyVec(numPorts);
+      for (int i = 0; i < numPorts; ++i)
+        {
+        copies[i] = vtkSmartPointer<vtkInformationVector>::New();
+        copyVec[i] = copies[i];
+        for (int j = 0; j < inInfoVec[i]->GetNumberOfInformationObjects(); ++j)
+          {
+          vtkInformation* inInfo = inInfoVec[i]->GetInformationObject(j);
+          vtkNew<vtkInformation> info;
+          info->Copy(inInfo);
+          vtkDataObject* data = inInfo->Get(vtkDataObject::DATA_OBJECT());
+          if (data)
+            {
+            vtkSmartPointer<vtkDataObject> copy;
+            copy.TakeReference(data->NewInstance());
+            copy->DeepCopy(data);
+            info->Set(vtkDataObject::DATA_OBJECT(), copy);
+            }
+          copies[i]->Append(info.GetPointer());
+          }
+        }
+
+      vtkExecutive* producer;
+      int port;
+      vtkExecutive::PRODUCER()->Get(this->GetInputInformation(0, 0),
+                                    producer, port);
+      for (int i = 1; !producer && i < numPorts; ++i)
+        {
+        if (this->Algorithm->GetNumberOfInputConnections(i) > 0)
+          {
+          vtkExecutive::PRODUCER()->Get(this->GetInputInformation(i, 0),
+                                        producer, port);
+          }
+        }
+      this->SetInputPieces(piece + 1, numPieces);
+      vtkNew<vtkUpdateFuture> future;
+      future->Start(producer->GetAlgorithm(), port);
+      result = this->Superclass::ExecuteData(request, &copyVec[0], outInfoVec);
+      result = future->Wait() && result;
+      }
+    else
+      {
+      result = this->Superclass::ExecuteData(request, inInfoVec, outInfoVec);
+      if (result && !last)
+        {
+        this->SetInputPieces(piece + 1, numPieces);
+        result = this->UpdateInputs();
+        }
+      }
+
+    // Keep the output of the piece. Appending it to the previous ones right
+    // away would copy them again for every piece. The outputs of all the
+    // pieces are thus held until the last one: only the memory upstream is
+    // bounded.
+    if (output)
+      {
+      vtkSmartPointer<vtkDataObject> pieceOutput;
+      pieceOutput.TakeReference(output->NewInstance());
+      pieceOutput->ShallowCopy(output);
+      internals->Outputs.push_back(pieceOutput);
+      }
+
+    size = this->GetUpstreamMemorySize();
+    peak = size > peak ? size : peak;
+    if (this->Algorithm->GetAbortExecute())
+      {
+      break;
+      }
+    }
+
+  // Restore the requests of the algorithm, so that it does not execute
+  // again until something changes.
+  this->SetInputPieces(0, 0);
+
+  // Append the outputs of all the pieces at once. They are released once
+  // appended, but until then both they and their appended copy are held.
+  if (output && internals->Outputs.size() == 1)
+    {
+    output->ShallowCopy(internals->Outputs[0]);
+    this->MarkOutputsGenerated(request, inInfoVec, outInfoVec);
+    }
+  else if (output && internals->Outputs.size() > 1)
+    {
+    this->AppendAlgorithm->RemoveAllInputConnections(0);
+    for (size_t i = 0; i < internals->Outputs.size(); ++i)
+      {
+      this->AppendAlgorithm->AddInputDataObject(0, internals->Outputs[i]);
+      }
+    internals->Outputs.clear();
+    this->AppendAlgorithm->Update();
+    output->ShallowCopy(this->AppendAlgorithm->GetOutputDataObject(0));
+    this->MarkOutputsGenerated(request, inInfoVec, outInfoVec);
+    this->AppendAlgorithm->RemoveAllInputConnections(0);
+    this->AppendAlgorithm->GetOutputDataObject(0)->Initialize();
+    }
+  internals->Outputs.clear();
+
+  // Start the next update with the number of pieces fitting this one.
+  this->NumberOfPieces = numPieces;
+  this->PeakMemorySize = peak;
+  double needed = std::ceil(static_cast<double>(peak) * numPieces / limit);
+  internals->NextNumberOfPieces = needed < 1 ? 1 :
+    (needed > this->MaximumNumberOfPieces ? this->MaximumNumberOfPieces :
+     static_cast<int>(needed));
+
+  return result;
+}
+
+//----------------------------------------------------------------------------
+void vtkMemoryLimitStreamingPipeline::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "MemoryLimit: " << this->MemoryLimit << endl;
+  os << indent << "InitialNumberOfPieces: " << this->InitialNumberOfPieces
+     << endl;
+  os << indent << "MaximumNumberOfPieces: " << this->MaximumNumberOfPieces
+     << endl;
+  os << indent << "Prefetch: " << this->Prefetch << endl;
+  os << indent << "AppendAlgorithm: " << this->AppendAlgorithm << endl;
+  os << indent << "NumberOfPieces: " << this->NumberOfPieces << endl;
+  os << indent << "PeakMemorySize: " << this->PeakMemorySize << endl;
+}
@@ -0,0 +1,161 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkMemoryLimitStreamingPipeline.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkMemoryLimitStreamingPipeline - executive that streams the input of its algorithm within a memory limit
+// .SECTION Description
+// vtkMemoryLimitStreamingPipeline executes its algorithm once per piece of
+// its input, so that the pipeline upstream never holds more than
+// MemoryLimit kibibytes of data. It turns any algorithm into a streaming
+// one, without vtkPolyDataStreamer-like filters: in a reader -> contour
+// chain where the contour filter uses this executive, the reader only
+// holds one piece of its data at a time.
+//
+// Only the data upstream is bounded. The output is not streamed: the
+// outputs of all the pieces are kept until the last one is processed, and
+// then appended, so that at the peak both the pieces and their appended
+// copy are in memory, about twice the size of the whole output. This
+// executive thus suits algorithms whose output is much smaller than their
+// input, such as contouring or thresholding a large volume. The whole
+// output must fit in memory twice.
+//
+// The number of pieces is chosen on each update. The first piece is
+// requested with the number of pieces of the previous update
+// (InitialNumberOfPieces the first time). If the data objects upstream
+// then use more than MemoryLimit, the input is split further and the first
+// piece requested again, up to MaximumNumberOfPieces pieces. The pieces
+// requested from the input are pieces of the piece requested from the
+// algorithm, so that the executive works in parallel pipelines too.
+//
+// The outputs of the algorithm for all the pieces are appended by
+// AppendAlgorithm (for instance a vtkAppendPolyData for an algorithm
+// producing polydata) once the last piece is processed. Sinks need no
+// append algorithm: they are executed for each piece, and each execution
+// only sees that piece. A sink that does not accumulate its pieces, such as
+// a writer, which rewrites its file on each execution, must not use this
+// executive. To write an output larger than the memory, use a writer that
+// streams itself, such as a vtkXMLPolyDataWriter with several pieces,
+// rather than this executive.
+//
+// When Prefetch is on, the pipeline upstream produces the next piece on
+// another thread while the algorithm processes a copy of the current one.
+// Two pieces then live at the same time, and each piece gets half of
+// MemoryLimit.
+//
+// .SECTION Caveats
+// Algorithms with more than one output port are not streamed, nor are
+// algorithms with an output when AppendAlgorithm is not set. The producers
+// of the input must honor piece requests. Algorithms that stream
+// themselves (setting CONTINUE_EXECUTING()) should not use this executive.
+// Prefetch is only used for algorithms with one input connection, and
+// requires the algorithm to get its input from the information vectors
+// given to RequestData() rather than with GetInput().
+//
+// .SECTION See Also
+// vtkStreamerBase vtkPolyDataStreamer vtkMemoryLimitImageDataStreamer
+
+#ifndef vtkMemoryLimitStreamingPipeline_h
+#define vtkMemoryLimitStreamingPipeline_h
+
+#include "vtkCommonExecutionModelModule.h" // For export macro
+#include "vtkCompositeDataPipeline.h"
+
+class vtkAlgorithm;
+class vtkMemoryLimitStreamingPipelineInternals;
+
+class VTKCOMMONEXECUTIONMODEL_EXPORT vtkMemoryLimitStreamingPipeline : public vtkCompositeDataPipeline
+{
+public:
+  static vtkMemoryLimitStreamingPipeline* New();
+  vtkTypeMacro(vtkMemoryLimitStreamingPipeline,vtkCompositeDataPipeline);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Maximum size, in kibibytes, of the data objects upstream of the
+  // algorithm while a piece is processed. 0, the default, disables
+  // streaming.
+  vtkSetMacro(MemoryLimit, unsigned long);
+  vtkGetMacro(MemoryLimit, unsigned long);
+
+  // Description:
+  // Number of pieces of the first update. Defaults to 8.
+  vtkSetClampMacro(InitialNumberOfPieces, int, 1, VTK_INT_MAX);
+  vtkGetMacro(InitialNumberOfPieces, int);
+
+  // Description:
+  // Largest number of pieces the input is split into. Defaults to 1024.
+  vtkSetClampMacro(MaximumNumberOfPieces, int, 1, VTK_INT_MAX);
+  vtkGetMacro(MaximumNumberOfPieces, int);
+
+  // Description:
+  // Produce the next piece while the algorithm processes the current one.
+  // Off by default.
+  vtkSetMacro(Prefetch, int);
+  vtkGetMacro(Prefetch, int);
+  vtkBooleanMacro(Prefetch, int);
+
+  // Description:
+  // Algorithm appending the outputs of the pieces. It gets the outputs of
+  // all the pieces, in order, as inputs of its port 0.
+  void SetAppendAlgorithm(vtkAlgorithm* append);
+  vtkGetObjectMacro(AppendAlgorithm, vtkAlgorithm);
+
+  // Description:
+  // Number of pieces of the last update, and largest size of the data
+  // objects upstream measured during it, in kibibytes.
+  vtkGetMacro(NumberOfPieces, int);
+  vtkGetMacro(PeakMemorySize, unsigned long);
+
+protected:
+  vtkMemoryLimitStreamingPipeline();
+  ~vtkMemoryLimitStreamingPipeline();
+
+  // Split the input requests before they are sent upstream.
+  virtual int ForwardUpstream(vtkInformation* request);
+  virtual int ForwardUpstream(int i, int j, vtkInformation* request)
+    { return this->Superclass::ForwardUpstream(i, j, request); }
+
+  // Execute the algorithm on every piece.
+  virtual int ExecuteData(vtkInformation* request,
+                          vtkInformationVector** inInfoVec,
+                          vtkInformationVector* outInfoVec);
+
+  // Return whether the algorithm can be streamed.
+  bool CanStream();
+
+  // Request piece of numPieces of the requests of the algorithm from the
+  // inputs, or restore these requests if numPieces is 0.
+  void SetInputPieces(int piece, int numPieces);
+
+  // Bring the inputs up to date.
+  int UpdateInputs();
+
+  // Total size of the outputs of the algorithms upstream, in kibibytes.
+  unsigned long GetUpstreamMemorySize();
+
+  unsigned long MemoryLimit;
+  int InitialNumberOfPieces;
+  int MaximumNumberOfPieces;
+  int Prefetch;
+  vtkAlgorithm* AppendAlgorithm;
+  int NumberOfPieces;
+  unsigned long PeakMemorySize;
+
+private:
+  vtkMemoryLimitStreamingPipelineInternals* Internals;
+
+  vtkMemoryLimitStreamingPipeline(const vtkMemoryLimitStreamingPipeline&);  // Not implemented.
+  void operator=(const vtkMemoryLimitStreamingPipeline&);  // Not implemented.
+};
+
+#endif
@@ -0,0 +1,347 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkPipelineStatistics.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPipelineStatistics.h"
+
+#include "vtkAlgorithm.h"
+#include "vtkDataObject.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkObjectFactory.h"
+#include "vtkSimpleCriticalSection.h"
+#include "vtkTimerLog.h"
+#include "vtkWeakPointer.h"
+
+#include <vtksys/SystemInformation.hxx>
+
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+vtkStandardNewMacro(vtkPipelineStatistics);
+
+//----------------------------------------------------------------------------
+class vtkPipelineStatisticsInternals
+{
+public:
+  struct Record
+  {
+    Record() : Executions(0), CacheHits(0), WallTime(0.0), CPUTime(0.0),
+               OutputMemorySize(0), PeakMemoryGrowth(0) {}
+    vtkWeakPointer<vtkAlgorithm> Algorithm;
+    std::string Name;
+    vtkIdType Executions;
+    vtkIdType CacheHits;
+    double WallTime;
+    double CPUTime;
+    unsigned long OutputMemorySize;
+    unsigned long PeakMemoryGrowth;
+  };
+
+  std::vector<Record> Records;
+  // Index in Records of the last record of each algorithm address. The
+  // address of a destroyed algorithm may be reused by a new one.
+  std::map<vtkAlgorithm*, size_t> Index;
+  vtkSimpleCriticalSection Lock;
+  vtksys::SystemInformation SystemInformation;
+
+  // Record of algorithm, or NULL.
+  Record* Find(vtkAlgorithm* algorithm)
+    {
+    std::map<vtkAlgorithm*, size_t>::iterator i = this->Index.find(algorithm);
+    if (i == this->Index.end() ||
+        this->Records[i->second].Algorithm.GetPointer() != algorithm)
+      {
+      return 0;
+      }
+    return &this->Records[i->second];
+    }
+
+  Record& FindOrCreate(vtkAlgorithm* algorithm)
+    {
+    if (Record* record = this->Find(algorithm))
+      {
+      return *record;
+      }
+    std::ostringstream name;
+    name << algorithm->GetClassName() << "(" << algorithm << ")";
+    this->Index[algorithm] = this->Records.size();
+    this->Records.push_back(Record());
+    this->Records.back().Algorithm = algorithm;
+    this->Records.back().Name = name.str();
+    return this->Records.back();
+    }
+};
+
+//----------------------------------------------------------------------------
+vtkPipelineStatistics::vtkPipelineStatistics()
+{
+  this->MeasureProcessMemory = 1;
+  this->Internals = new vtkPipelineStatisticsInternals;
+}
+
+//----------------------------------------------------------------------------
+vtkPipelineStatistics::~vtkPipelineStatistics()
+{
+  delete this->Internals;
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkPipelineStatistics::GetProcessMemory()
+{
+  if (!this->MeasureProcessMemory)
+    {
+    return 0;
+    }
+  this->Internals->Lock.Lock();
+  long long memory =
+    this->Internals->SystemInformation.GetProcMemoryUsed();
+  this->Internals->Lock.Unlock();
+  return memory > 0 ? static_cast<unsigned long>(memory) : 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkPipelineStatistics::StartExecution(Sample& start)
+{
+  start.ProcessMemory = this->GetProcessMemory();
+  start.CPUTime = vtkTimerLog::GetCPUTime();
+  start.WallTime = vtkTimerLog::GetUniversalTime();
+}
+
+//----------------------------------------------------------------------------
+void vtkPipelineStatistics::EndExecution(vtkAlgorithm* algorithm,
+                                         const Sample& start,
+                                         vtkInformationVector* outInfo)
+{
+  double wallTime = vtkTimerLog::GetUniversalTime() - start.WallTime;
+  double cpuTime = vtkTimerLog::GetCPUTime() - start.CPUTime;
+  unsigned long memory = this->GetProcessMemory();
+  unsigned long growth =
+    memory > start.ProcessMemory ? memory - start.ProcessMemory : 0;
+
+  unsigned long outputSize = 0;
+  for (int i = 0; outInfo && i < outInfo->GetNumberOfInformationObjects(); ++i)
+    {
+    vtkDataObject* data =
+      outInfo->GetInformationObject(i)->Get(vtkDataObject::DATA_OBJECT());
+    if (data)
+      {
+      outputSize += data->GetActualMemorySize();
+      }
+    }
+
+  this->Internals->Lock.Lock();
+  vtkPipelineStatisticsInternals::Record& record =
+    this->Internals->FindOrCreate(algorithm);
+  ++record.Executions;
+  record.WallTime += wallTime;
+  record.CPUTime += cpuTime;
+  record.OutputMemorySize = outputSize;
+  if (growth > record.PeakMemoryGrowth)
+    {
+    record.PeakMemoryGrowth = growth;
+    }
+  this->Internals->Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkPipelineStatistics::AddCacheHit(vtkAlgorithm* algorithm)
+{
+  this->Internals->Lock.Lock();
+  ++this->Internals->FindOrCreate(algorithm).CacheHits;
+  this->Internals->Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkPipelineStatistics::Reset()
+{
+  this->Internals->Lock.Lock();
+  this->Internals->Records.clear();
+  this->Internals->Index.clear();
+  this->Internals->Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+int vtkPipelineStatistics::GetNumberOfAlgorithms()
+{
+  return static_cast<int>(this->Internals->Records.size());
+}
+
+//----------------------------------------------------------------------------
+vtkAlgorithm* vtkPipelineStatistics::GetAlgorithm(int i)
+{
+  if (i < 0 || i >= this->GetNumberOfAlgorithms())
+    {
+    return 0;
+    }
+  return this->Internals->Records[i].Algorithm;
+}
+
+//----------------------------------------------------------------------------
+const char* vtkPipelineStatistics::GetAlgorithmName(int i)
+{
+  if (i < 0 || i >= this->GetNumberOfAlgorithms())
+    {
+    return 0;
+    }
+  return this->Internals->Records[i].Name.c_str();
+}
+
+//----------------------------------------------------------------------------
+#define vtkPipelineStatisticsGetMacro(name, type, field)                   \
+  type vtkPipelineStatistics::Get##name(vtkAlgorithm* algorithm)           \
+  {                                                                        \
+    vtkPipelineStatisticsInternals::Record* record =                       \
+      this->Internals->Find(algorithm);                                   \
+    return record ? record->field : 0;                                     \
+  }
+
+vtkPipelineStatisticsGetMacro(NumberOfExecutions, vtkIdType, Executions)
+vtkPipelineStatisticsGetMacro(NumberOfCacheHits, vtkIdType, CacheHits)
+vtkPipelineStatisticsGetMacro(WallTime, double, WallTime)
+vtkPipelineStatisticsGetMacro(CPUTime, double, CPUTime)
+vtkPipelineStatisticsGetMacro(OutputMemorySize, unsigned long,
+                              OutputMemorySize)
+vtkPipelineStatisticsGetMacro(PeakMemoryGrowth, unsigned long,
+                              PeakMemoryGrowth)
+
+//----------------------------------------------------------------------------
+vtkIdType vtkPipelineStatistics::GetNumberOfExecutions()
+{
+  vtkIdType total = 0;
+  for (size_t i = 0; i < this->Internals->Records.size(); ++i)
+    {
+    total += this->Internals->Records[i].Executions;
+    }
+  return total;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkPipelineStatistics::GetNumberOfCacheHits()
+{
+  vtkIdType total = 0;
+  for (size_t i = 0; i < this->Internals->Records.size(); ++i)
+    {
+    total += this->Internals->Records[i].CacheHits;
+    }
+  return total;
+}
+
+//----------------------------------------------------------------------------
+double vtkPipelineStatistics::GetWallTime()
+{
+  double total = 0.0;
+  for (size_t i = 0; i < this->Internals->Records.size(); ++i)
+    {
+    total += this->Internals->Records[i].WallTime;
+    }
+  return total;
+}
+
+//----------------------------------------------------------------------------
+double vtkPipelineStatistics::GetCPUTime()
+{
+  double total = 0.0;
+  for (size_t i = 0; i < this->Internals->Records.size(); ++i)
+    {
+    total += this->Internals->Records[i].CPUTime;
+    }
+  return total;
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkPipelineStatistics::GetOutputMemorySize()
+{
+  unsigned long total = 0;
+  for (size_t i = 0; i < this->Internals->Records.size(); ++i)
+    {
+    total += this->Internals->Records[i].OutputMemorySize;
+    }
+  return total;
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkPipelineStatistics::GetPeakMemoryGrowth()
+{
+  unsigned long peak = 0;
+  for (size_t i = 0; i < this->Internals->Records.size(); ++i)
+    {
+    if (this->Internals->Records[i].PeakMemoryGrowth > peak)
+      {
+      peak = this->Internals->Records[i].PeakMemoryGrowth;
+      }
+    }
+  return peak;
+}
+
+//----------------------------------------------------------------------------
+void vtkPipelineStatistics::WriteCSV(ostream& os)
+{
+  os << "Algorithm,Executions,CacheHits,WallTime,CPUTime,"
+        "OutputMemorySize,PeakMemoryGrowth\n";
+  this->Internals->Lock.Lock();
+  for (size_t i = 0; i < this->Internals->Records.size(); ++i)
+    {
+    const vtkPipelineStatisticsInternals::Record& record =
+      this->Internals->Records[i];
+    os << record.Name << ","
+       << record.Executions << ","
+       << record.CacheHits << ","
+       << record.WallTime << ","
+       << record.CPUTime << ","
+       << record.OutputMemorySize << ","
+       << record.PeakMemoryGrowth << "\n";
+    }
+  this->Internals->Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+void vtkPipelineStatistics::WriteJSON(ostream& os)
+{
+  os << "[";
+  this->Internals->Lock.Lock();
+  for (size_t i = 0; i < this->Internals->Records.size(); ++i)
+    {
+    const vtkPipelineStatisticsInternals::Record& record =
+      this->Internals->Records[i];
+    os << (i ? ",\n " : "\n ")
+       << "{\"Algorithm\": \"" << record.Name << "\", "
+       << "\"Executions\": " << record.Executions << ", "
+       << "\"CacheHits\": " << record.CacheHits << ", "
+       << "\"WallTime\": " << record.WallTime << ", "
+       << "\"CPUTime\": " << record.CPUTime << ", "
+       << "\"OutputMemorySize\": " << record.OutputMemorySize << ", "
+       << "\"PeakMemoryGrowth\": " << record.PeakMemoryGrowth << "}";
+    }
+  this->Internals->Lock.Unlock();
+  os << "\n]\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkPipelineStatistics::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "MeasureProcessMemory: " << this->MeasureProcessMemory
+     << endl;
+  os << indent << "NumberOfAlgorithms: " << this->GetNumberOfAlgorithms()
+     << endl;
+  os << indent << "NumberOfExecutions: " << this->GetNumberOfExecutions()
+     << endl;
+  os << indent << "NumberOfCacheHits: " << this->GetNumberOfCacheHits()
+     << endl;
+  os << indent << "WallTime: " << this->GetWallTime() << endl;
+  os << indent << "CPUTime: " << this->GetCPUTime() << endl;
+}
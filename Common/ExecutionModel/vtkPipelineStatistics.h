@@ -0,0 +1,154 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkPipelineStatistics.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPipelineStatistics - time and memory used by the algorithms of a pipeline
+// .SECTION Description
+// vtkPipelineStatistics records, for each algorithm, what executives
+// report about its executions: the number of executions, the wall and CPU
+// time they took, the size of the outputs they produced and how much the
+// memory of the process grew during them. Data requests that an executive
+// answers without executing the algorithm, because its outputs are up to
+// date or found in a cache (see vtkCachedStreamingDemandDrivenPipeline),
+// are counted as cache hits.
+//
+// Statistics are recorded by the executives given one with
+// vtkExecutive::SetStatistics(), or by all executives when set with
+// vtkExecutive::SetDefaultStatistics():
+//
+// \code
+// vtkNew<vtkPipelineStatistics> statistics;
+// vtkExecutive::SetDefaultStatistics(statistics.GetPointer());
+// writer->Write();
+// vtkExecutive::SetDefaultStatistics(0);
+// statistics->WriteCSV(cout);
+// \endcode
+//
+// .SECTION Caveats
+// Times are inclusive of the updates an algorithm makes during its
+// execution, such as internal pipelines, but not of the update of its
+// inputs. CPU time is the time of the whole process, so it includes other
+// threads working at the same time. VTK has no hook into memory
+// allocations: the growth of the resident memory of the process between
+// the start and the end of an execution stands for its peak allocation,
+// and memory allocated and released within the execution is not seen. It
+// is only measured where vtksys::SystemInformation supports it.
+//
+// .SECTION See Also
+// vtkExecutive vtkExecutionTimer vtkDataObjectCache
+
+#ifndef vtkPipelineStatistics_h
+#define vtkPipelineStatistics_h
+
+#include "vtkCommonExecutionModelModule.h" // For export macro
+#include "vtkObject.h"
+
+class vtkAlgorithm;
+class vtkInformationVector;
+class vtkPipelineStatisticsInternals;
+
+class VTKCOMMONEXECUTIONMODEL_EXPORT vtkPipelineStatistics : public vtkObject
+{
+public:
+  static vtkPipelineStatistics* New();
+  vtkTypeMacro(vtkPipelineStatistics, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Measure the memory of the process around executions. On by default.
+  // Reading it can cost as much as executing a trivial algorithm.
+  vtkSetMacro(MeasureProcessMemory, int);
+  vtkGetMacro(MeasureProcessMemory, int);
+  vtkBooleanMacro(MeasureProcessMemory, int);
+
+  // Description:
+  // Algorithms with statistics, in the order they were first recorded.
+  // GetAlgorithm() returns NULL for algorithms destroyed since, whose
+  // statistics are kept. Names are the class name and the address of the
+  // algorithm.
+  int GetNumberOfAlgorithms();
+  vtkAlgorithm* GetAlgorithm(int i);
+  const char* GetAlgorithmName(int i);
+
+  // Description:
+  // Statistics of an algorithm. Times are totals in seconds, and memory
+  // sizes are in kibibytes. OutputMemorySize is the size of the outputs
+  // after the last execution, and PeakMemoryGrowth the largest growth of
+  // the process memory during one execution. All are 0 for algorithms
+  // without statistics.
+  vtkIdType GetNumberOfExecutions(vtkAlgorithm* algorithm);
+  vtkIdType GetNumberOfCacheHits(vtkAlgorithm* algorithm);
+  double GetWallTime(vtkAlgorithm* algorithm);
+  double GetCPUTime(vtkAlgorithm* algorithm);
+  unsigned long GetOutputMemorySize(vtkAlgorithm* algorithm);
+  unsigned long GetPeakMemoryGrowth(vtkAlgorithm* algorithm);
+
+  // Description:
+  // Statistics of all algorithms: total times and output sizes, and the
+  // largest memory growth.
+  vtkIdType GetNumberOfExecutions();
+  vtkIdType GetNumberOfCacheHits();
+  double GetWallTime();
+  double GetCPUTime();
+  unsigned long GetOutputMemorySize();
+  unsigned long GetPeakMemoryGrowth();
+
+  // Description:
+  // Forget all statistics.
+  void Reset();
+
+  // Description:
+  // Write the statistics of every algorithm, one line each with a header
+  // line, or as a JSON array of objects.
+  void WriteCSV(ostream& os);
+  void WriteJSON(ostream& os);
+
+  //BTX
+  // Description:
+  // State of the process when an execution starts.
+  struct Sample
+  {
+    double WallTime;
+    double CPUTime;
+    unsigned long ProcessMemory;
+  };
+  //ETX
+
+  // Description:
+  // Called by executives: around the execution of algorithm for a data
+  // request, outInfo holding its outputs, and when they answer a data
+  // request without executing it. These methods are thread safe.
+  //BTX
+  void StartExecution(Sample& start);
+  void EndExecution(vtkAlgorithm* algorithm, const Sample& start,
+                    vtkInformationVector* outInfo);
+  //ETX
+  void AddCacheHit(vtkAlgorithm* algorithm);
+
+protected:
+  vtkPipelineStatistics();
+  ~vtkPipelineStatistics();
+
+  // Resident memory of the process in kibibytes, or 0 when unknown.
+  unsigned long GetProcessMemory();
+
+  int MeasureProcessMemory;
+
+private:
+  vtkPipelineStatisticsInternals* Internals;
+
+  vtkPipelineStatistics(const vtkPipelineStatistics&);  // Not implemented.
+  void operator=(const vtkPipelineStatistics&);  // Not implemented.
+};
+
+#endif
@@ -14,14 +14,29 @@
 =========================================================================*/
 #include "vtkScalarTree.h"
 
+#include "vtkCellArray.h"
 #include "vtkDataSet.h"
 #include "vtkDataArray.h"
 #include "vtkGarbageCollector.h"
+#include "vtkInformation.h"
+#include "vtkInformationObjectBaseKey.h"
 #include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSimpleCriticalSection.h"
+#include "vtkSpanSpace.h"
+#include "vtkTimerLog.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
 
 vtkCxxSetObjectMacro(vtkScalarTree,DataSet,vtkDataSet);
 vtkCxxSetObjectMacro(vtkScalarTree,Scalars,vtkDataArray);
 
+vtkInformationKeyMacro(vtkScalarTree, CACHED_TREE, ObjectBase);
+
+// Guards the creation and the use of cached trees.
+static vtkSimpleCriticalSection vtkScalarTreeCacheLock;
+
 //-----------------------------------------------------------------------------
 // Instantiate scalar tree.
 vtkScalarTree::vtkScalarTree()
@@ -29,6 +44,14 @@ vtkScalarTree::vtkScalarTree()
   this->DataSet = NULL;
   this->Scalars = NULL;
   this->ScalarValue = 0.0;
+
+  this->BuildDataSet = NULL;
+  this->BuildScalars = NULL;
+  this->BuildNumberOfCells = 0;
+  this->BuildNumberOfPoints = 0;
+  this->CacheInUse = 0;
+
+  this->ResetStatistics();
 }
 
 //-----------------------------------------------------------------------------
@@ -62,4 +85,176 @@ void vtkScalarTree::PrintSelf(ostream& os, vtkIndent indent)
     }
 
   os << indent << "Build Time: " << this->BuildTime.GetMTime() << "\n";
+  os << indent << "Number Of Builds: " << this->NumberOfBuilds << "\n";
+  os << indent << "Number Of Build Requests: "
+     << this->NumberOfBuildRequests << "\n";
+  os << indent << "Last Build Duration: " << this->LastBuildDuration << "\n";
+  os << indent << "Total Build Duration: " << this->TotalBuildDuration << "\n";
+  os << indent << "Number Of Traversals: " << this->NumberOfTraversals << "\n";
+  os << indent << "Number Of Candidate Cells: "
+     << this->NumberOfCandidateCells << "\n";
+}
+
+//-----------------------------------------------------------------------------
+// MTime of the structure of a dataset: the dataset itself, its points and its
+// cell arrays, but not its point and cell data.
+static unsigned long vtkScalarTreeStructureMTime(vtkDataSet *ds)
+{
+  unsigned long mtime = ds->vtkDataObject::GetMTime();
+  vtkObject *parts[5] = { NULL, NULL, NULL, NULL, NULL };
+  if ( vtkPointSet *ps = vtkPointSet::SafeDownCast(ds) )
+    {
+    parts[0] = ps->GetPoints();
+    }
+  if ( vtkUnstructuredGrid *ug = vtkUnstructuredGrid::SafeDownCast(ds) )
+    {
+    parts[1] = ug->GetCells();
+    parts[2] = ug->GetCellTypesArray();
+    }
+  else if ( vtkPolyData *pd = vtkPolyData::SafeDownCast(ds) )
+    {
+    parts[1] = pd->GetVerts();
+    parts[2] = pd->GetLines();
+    parts[3] = pd->GetPolys();
+    parts[4] = pd->GetStrips();
+    }
+  for ( int i=0; i < 5; i++ )
+    {
+    if ( parts[i] && parts[i]->GetMTime() > mtime )
+      {
+      mtime = parts[i]->GetMTime();
+      }
+    }
+  return mtime;
+}
+
+//-----------------------------------------------------------------------------
+// The tree is keyed on its scalars (their MTime) and on the structure of the
+// dataset rather than on the MTime of the dataset, which changes with any of
+// its arrays.
+int vtkScalarTree::RequestBuild(vtkIdType numCells)
+{
+  this->NumberOfBuildRequests++;
+
+  vtkIdType numPts = this->DataSet ? this->DataSet->GetNumberOfPoints() : 0;
+  return ( this->BuildTime <= this->MTime ||
+           this->DataSet != this->BuildDataSet ||
+           ( this->DataSet &&
+             this->BuildTime <= vtkScalarTreeStructureMTime(this->DataSet) ) ||
+           this->Scalars != this->BuildScalars ||
+           ( this->Scalars && this->BuildTime <= this->Scalars->GetMTime() ) ||
+           numCells != this->BuildNumberOfCells ||
+           numPts != this->BuildNumberOfPoints );
+}
+
+//-----------------------------------------------------------------------------
+void vtkScalarTree::BuildFinished(double startTime)
+{
+  this->BuildTime.Modified();
+  this->BuildDataSet = this->DataSet;
+  this->BuildScalars = this->Scalars;
+  this->BuildNumberOfCells = this->DataSet->GetNumberOfCells();
+  this->BuildNumberOfPoints = this->DataSet->GetNumberOfPoints();
+
+  this->NumberOfBuilds++;
+  this->LastBuildDuration = vtkTimerLog::GetUniversalTime() - startTime;
+  this->TotalBuildDuration += this->LastBuildDuration;
+}
+
+//-----------------------------------------------------------------------------
+double vtkScalarTree::GetHitRate()
+{
+  if ( this->NumberOfBuildRequests < 1 )
+    {
+    return 0.0;
+    }
+  return static_cast<double>(this->NumberOfBuildRequests - this->NumberOfBuilds)
+    / this->NumberOfBuildRequests;
+}
+
+//-----------------------------------------------------------------------------
+double vtkScalarTree::GetCandidateFraction()
+{
+  if ( this->NumberOfTraversals < 1 || this->BuildNumberOfCells < 1 )
+    {
+    return 0.0;
+    }
+  return static_cast<double>(this->NumberOfCandidateCells) /
+    (static_cast<double>(this->NumberOfTraversals) * this->BuildNumberOfCells);
+}
+
+//-----------------------------------------------------------------------------
+void vtkScalarTree::ResetStatistics()
+{
+  this->NumberOfBuilds = 0;
+  this->NumberOfBuildRequests = 0;
+  this->LastBuildDuration = 0.0;
+  this->TotalBuildDuration = 0.0;
+  this->NumberOfTraversals = 0;
+  this->NumberOfCandidateCells = 0;
+}
+
+//-----------------------------------------------------------------------------
+// The cached tree lives in the information of the dataset. It refers to the
+// dataset only while in use, or the two would never be deleted. Attaching
+// and detaching them does not modify the tree: RequestBuild() compares what
+// the tree was built from instead.
+vtkScalarTree* vtkScalarTree::GetCachedTree(vtkDataSet* dataSet,
+                                            vtkDataArray* scalars)
+{
+  if ( !dataSet )
+    {
+    return NULL;
+    }
+
+  vtkScalarTreeCacheLock.Lock();
+  vtkInformation* info = dataSet->GetInformation();
+  vtkScalarTree* tree =
+    vtkScalarTree::SafeDownCast(info->Get(vtkScalarTree::CACHED_TREE()));
+  if ( !tree )
+    {
+    tree = vtkSpanSpace::New();
+    info->Set(vtkScalarTree::CACHED_TREE(), tree);
+    tree->Delete();
+    }
+  if ( tree->CacheInUse )
+    {
+    vtkScalarTreeCacheLock.Unlock();
+    return NULL;
+    }
+  tree->CacheInUse = 1;
+  vtkScalarTreeCacheLock.Unlock();
+
+  tree->DataSet = dataSet;
+  tree->DataSet->Register(tree);
+  tree->Scalars = scalars;
+  if ( tree->Scalars )
+    {
+    tree->Scalars->Register(tree);
+    }
+  return tree;
+}
+
+//-----------------------------------------------------------------------------
+void vtkScalarTree::ReleaseCachedTree(vtkScalarTree* tree)
+{
+  if ( !tree )
+    {
+    return;
+    }
+
+  if ( tree->DataSet )
+    {
+    tree->DataSet->UnRegister(tree);
+    tree->DataSet = NULL;
+    }
+  if ( tree->Scalars )
+    {
+    tree->Scalars->UnRegister(tree);
+    tree->Scalars = NULL;
+    }
+
+  vtkScalarTreeCacheLock.Lock();
+  tree->CacheInUse = 0;
+  vtkScalarTreeCacheLock.Unlock();
 }
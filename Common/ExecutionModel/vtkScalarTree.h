@@ -32,6 +32,14 @@
 // parallel For() operation. First request the number of batches, and
 // then for each batch, retrieve the array of cell ids in that batch. These
 // batches contain cell ids that are likely to contain the isosurface.
+//
+// A tree is rebuilt only when its scalars, the structure of its dataset (the
+// dataset itself, its points or its cell arrays, but not its other point and
+// cell data), or the tree itself are modified, so that contouring the same
+// data repeatedly with different values reuses it. GetCachedTree() keeps a
+// tree in the information of a dataset, where every filter contouring that
+// dataset finds it. Statistics of the builds and traversals help deciding
+// whether a tree pays off.
 
 // .SECTION See Also
 // vtkSimpleScalarTree vtkSpanSpace
@@ -46,6 +54,7 @@ class vtkCell;
 class vtkDataArray;
 class vtkDataSet;
 class vtkIdList;
+class vtkInformationObjectBaseKey;
 class vtkTimeStamp;
 
 class VTKCOMMONEXECUTIONMODEL_EXPORT vtkScalarTree : public vtkObject
@@ -120,6 +129,40 @@ public:
   virtual const vtkIdType* GetCellBatch(vtkIdType batchNum,
                                         vtkIdType& numCells) = 0;
 
+  // Description:
+  // Statistics of the tree. NumberOfBuilds counts the times the tree was
+  // (re)built, LastBuildDuration and TotalBuildDuration the seconds spent
+  // doing so. NumberOfBuildRequests counts the calls to BuildTree(),
+  // including those that found the tree up to date; GetHitRate() is the
+  // fraction of them that did not rebuild. NumberOfTraversals counts the
+  // calls to InitTraversal() and NumberOfCandidateCells the cells they
+  // returned as possibly containing the scalar value; GetCandidateFraction()
+  // is the average fraction of the cells returned by a traversal.
+  vtkGetMacro(NumberOfBuilds,vtkIdType);
+  vtkGetMacro(NumberOfBuildRequests,vtkIdType);
+  vtkGetMacro(LastBuildDuration,double);
+  vtkGetMacro(TotalBuildDuration,double);
+  vtkGetMacro(NumberOfTraversals,vtkIdType);
+  vtkGetMacro(NumberOfCandidateCells,vtkIdType);
+  double GetHitRate();
+  double GetCandidateFraction();
+  void ResetStatistics();
+
+  // Description:
+  // Return the tree cached in the information of dataSet, with its DataSet
+  // set to dataSet and its Scalars to scalars. A vtkSpanSpace is created
+  // and cached the first time. The tree stays with the dataset, so that
+  // later calls, from any filter, reuse it as long as the scalars are not
+  // modified. Return NULL if the tree is in use by another caller; pass the
+  // tree to ReleaseCachedTree() when done with it.
+  static vtkScalarTree* GetCachedTree(vtkDataSet* dataSet,
+                                      vtkDataArray* scalars);
+  static void ReleaseCachedTree(vtkScalarTree* tree);
+
+  // Description:
+  // Key under which GetCachedTree() stores the tree in the information of
+  // a dataset.
+  static vtkInformationObjectBaseKey* CACHED_TREE();
 
 protected:
   vtkScalarTree();
@@ -131,7 +174,29 @@ protected:
 
   vtkTimeStamp BuildTime; //time at which tree was built
 
+  // Description:
+  // Used by subclasses in BuildTree(). RequestBuild() counts a build
+  // request and returns whether the tree must be rebuilt for numCells
+  // cells. BuildFinished() records a build started at startTime (from
+  // vtkTimerLog::GetUniversalTime()).
+  int RequestBuild(vtkIdType numCells);
+  void BuildFinished(double startTime);
+
+  vtkIdType NumberOfBuilds;
+  vtkIdType NumberOfBuildRequests;
+  double LastBuildDuration;
+  double TotalBuildDuration;
+  vtkIdType NumberOfTraversals;
+  vtkIdType NumberOfCandidateCells;
+
 private:
+  // What the tree was built from. Only compared, never dereferenced.
+  vtkDataSet   *BuildDataSet;
+  vtkDataArray *BuildScalars;
+  vtkIdType     BuildNumberOfCells;
+  vtkIdType     BuildNumberOfPoints;
+  int           CacheInUse;
+
   vtkScalarTree(const vtkScalarTree&);  // Not implemented.
   void operator=(const vtkScalarTree&);  // Not implemented.
 };
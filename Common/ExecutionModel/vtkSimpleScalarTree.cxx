@@ -20,6 +20,7 @@
 #include "vtkIdList.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkTimerLog.h"
 
 vtkStandardNewMacro(vtkSimpleScalarTree);
 
@@ -97,14 +98,6 @@ void vtkSimpleScalarTree::BuildTree()
     return;
     }
 
-  if ( this->Tree != NULL && this->BuildTime > this->MTime
-    && this->BuildTime > this->DataSet->GetMTime() )
-    {
-    return;
-    }
-
-  vtkDebugMacro( << "Building scalar tree..." );
-
   // If no scalars set then try and grab them from dataset
   if ( ! this->Scalars )
     {
@@ -116,6 +109,14 @@ void vtkSimpleScalarTree::BuildTree()
     return;
     }
 
+  if ( !this->RequestBuild(this->NumCells) && this->Tree != NULL )
+    {
+    return;
+    }
+
+  vtkDebugMacro( << "Building scalar tree..." );
+  double startTime = vtkTimerLog::GetUniversalTime();
+
   this->Initialize();
   cellScalars = vtkDoubleArray::New();
   cellScalars->Allocate(100);
@@ -199,7 +200,7 @@ void vtkSimpleScalarTree::BuildTree()
     offset = parentOffset;
     }
 
-  this->BuildTime.Modified();
+  this->BuildFinished(startTime);
   cellScalars->Delete();
 }
 
@@ -214,6 +215,11 @@ void vtkSimpleScalarTree::InitTraversal(double scalarValue)
 
   this->ScalarValue = scalarValue;
   this->TreeIndex = this->TreeSize;
+  this->NumberOfTraversals++;
+  if ( ! TTree )
+    {
+    return;
+    }
 
   // Check root of tree for overlap with scalar value
   //
@@ -350,6 +356,7 @@ vtkCell *vtkSimpleScalarTree::GetNextCell(vtkIdType& cellId,
       if ( this->ScalarValue >= min && this->ScalarValue <= max )
         {
         cellId = this->CellId;
+        this->NumberOfCandidateCells++;
         this->ChildNumber++; //prepare for next time
         this->CellId++;
         return cell;
@@ -393,6 +400,7 @@ vtkIdType vtkSimpleScalarTree::GetNumberOfCellBatches()
     // If here, must have not found anything in this leaf
     this->FindNextLeaf(this->TreeIndex, this->Level);
     } //while not all leafs visited
+  this->NumberOfCandidateCells += this->NumCandidates;
 
   // Watch for boundary conditions
   if ( this->NumCandidates < 1 )
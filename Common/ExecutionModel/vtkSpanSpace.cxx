@@ -24,6 +24,7 @@
 #include "vtkPointData.h"
 #include "vtkSMPTools.h"
 #include "vtkSMPThreadLocalObject.h"
+#include "vtkTimerLog.h"
 
 #include <algorithm> //std::sort
 
@@ -87,6 +88,15 @@ public:
     vtkIdType i = static_cast<vtkIdType>(
       static_cast<double>(this->Dim) * (value - this->SMin) / this->Range);
 
+    // Values outside of the scalar range are spanned by no cell; the
+    // maximum value falls in the last bucket.
+    if ( value < this->SMin || value > this->SMax )
+      {
+      rMin[0] = rMin[1] = rMax[0] = rMax[1] = 0;
+      return;
+      }
+    i = ( i >= this->Dim ? this->Dim-1 : i );
+
     rMin[0] = 0; //xmin on rectangle left boundary
     rMin[1] = i; //ymin on rectangle bottom
     rMax[0] = i+1; //xmax (non-inclusive interval) on right hand boundary
@@ -264,7 +274,12 @@ vtkSpanSpace::vtkSpanSpace()
   this->SpanSpace = NULL;
   this->RMin[0] = this->RMin[1] = 0;
   this->RMax[0] = this->RMax[1] = 0;
+  this->Resolution = 100;
   this->BatchSize = 10;
+  this->CurrentRow = 0;
+  this->CurrentSpan = NULL;
+  this->CurrentIdx = 0;
+  this->CurrentNumCells = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -300,14 +315,6 @@ void vtkSpanSpace::BuildTree()
     return;
     }
 
-  if ( this->BuildTime > this->MTime
-       && this->BuildTime > this->DataSet->GetMTime() )
-    {
-    return;
-    }
-
-  vtkDebugMacro( << "Building span space..." );
-
   // If no scalars set then try and grab them from dataset
   if ( ! this->Scalars )
     {
@@ -319,6 +326,14 @@ void vtkSpanSpace::BuildTree()
     return;
     }
 
+  if ( !this->RequestBuild(numCells) && this->SpanSpace )
+    {
+    return;
+    }
+
+  vtkDebugMacro( << "Building span space..." );
+  double startTime = vtkTimerLog::GetUniversalTime();
+
   // We need a range for the scalars
   double range[2];
   this->Scalars->GetRange(range);
@@ -347,8 +362,8 @@ void vtkSpanSpace::BuildTree()
   // Now sort and build span space
   this->SpanSpace->Build();
 
-  // Update our build time
-  this->BuildTime.Modified();
+  // Update our build time and statistics
+  this->BuildFinished(startTime);
 }
 
 //-----------------------------------------------------------------------------
@@ -358,10 +373,29 @@ void vtkSpanSpace::InitTraversal(double scalarValue)
 {
   this->BuildTree();
   this->ScalarValue = scalarValue;
+  this->NumberOfTraversals++;
+
+  // Without a span space (e.g., no data) there is nothing to traverse
+  if ( ! this->SpanSpace )
+    {
+    this->RMin[0] = this->RMin[1] = 0;
+    this->RMax[0] = this->RMax[1] = 0;
+    this->CurrentRow = 0;
+    this->CurrentNumCells = this->CurrentIdx = 0;
+    return;
+    }
 
   // Find the rectangle in span space that spans the isovalue
   this->SpanSpace->GetSpanRectangle(scalarValue, this->RMin, this->RMax);
 
+  // Count the candidate cells; each row of the rectangle is contiguous
+  vtkIdType row, numCells;
+  for (row=this->RMin[1]; row < this->RMax[1]; ++row)
+    {
+    this->SpanSpace->GetCellsInSpan(row, this->RMin, this->RMax, numCells);
+    this->NumberOfCandidateCells += numCells;
+    }
+
   // Initiate the serial looping over all span rows
   this->CurrentRow = this->RMin[1];
   this->CurrentSpan = this->SpanSpace->
@@ -415,6 +449,11 @@ vtkCell *vtkSpanSpace::GetNextCell(vtkIdType& cellId, vtkIdList* &cellPts,
 // InitTraversal() must have been called, which populates the span rectangle.
 vtkIdType vtkSpanSpace::GetNumberOfCellBatches()
 {
+  if ( ! this->SpanSpace )
+    {
+    return 0;
+    }
+
   // Basicall just perform a serial traversal and populate candidate list
   this->SpanSpace->NumCandidates = 0;
 
@@ -449,7 +488,7 @@ GetCellBatch(vtkIdType batchNum, vtkIdType& numCells)
 {
   // Make sure that everything is hunky dory
   vtkIdType pos = batchNum * this->BatchSize;
-  if ( this->SpanSpace->NumCells < 1 || ! this->SpanSpace->CandidateCells ||
+  if ( ! this->SpanSpace || this->SpanSpace->NumCells < 1 || ! this->SpanSpace->CandidateCells ||
        pos > this->SpanSpace->NumCandidates )
     {
     numCells = 0;
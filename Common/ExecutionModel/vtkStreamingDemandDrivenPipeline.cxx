@@ -36,6 +36,7 @@
 #include "vtkInformationUnsignedLongKey.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
+#include "vtkPipelineStatistics.h"
 #include "vtkSmartPointer.h"
 
 vtkStandardNewMacro(vtkStreamingDemandDrivenPipeline);
@@ -362,6 +363,11 @@ int vtkStreamingDemandDrivenPipeline::Update(int port)
         {
         retval = retval && this->UpdateData(port);
         }
+      else if (vtkPipelineStatistics* statistics = this->GetActiveStatistics())
+        {
+        // The outputs are up to date: no data request is made.
+        statistics->AddCacheHit(this->Algorithm);
+        }
       }
     while (this->ContinueExecuting);
     return retval;
@@ -36,18 +36,22 @@
 #include "vtkObjectFactory.h"
 #include "vtkDebugLeaks.h"
 #include "vtkImageData.h"
+#include "vtkDataSet.h"
 
 #include "vtkSMPThreadLocal.h"
 #include "vtkSMPThreadLocalObject.h"
 #include "vtkSMPTools.h"
 #include "vtkSMPProgressObserver.h"
 
+#include <algorithm>
 #include <vector>
 #include <cassert>
 
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkThreadedCompositeDataPipeline);
 
+vtkInformationKeyMacro(vtkThreadedCompositeDataPipeline, ALGORITHM_IS_REENTRANT, Integer);
+
 //----------------------------------------------------------------------------
 namespace
 {
@@ -125,14 +129,16 @@ public:
                int connection,
                vtkInformation* request,
                const std::vector<vtkDataObject*>& inObjs,
-               std::vector<vtkDataObject*>& outObjs)
+               std::vector<vtkDataObject*>& outObjs,
+               const std::vector<vtkIdType>& order)
     : Exec(exec),
       InInfoVec(inInfoVec),
       OutInfoVec(outInfoVec),
       CompositePort(compositePort),
       Connection(connection),
       Request(request),
-      InObjs(inObjs)
+      InObjs(inObjs),
+      Order(order)
   {
     int numInputPorts = this->Exec->GetNumberOfInputPorts();
     this->OutObjs = &outObjs[0];
@@ -186,8 +192,9 @@ public:
     vtkInformation* inInfo = inInfoVec[this->CompositePort]->GetInformationObject(this->Connection);
     vtkInformation* outInfo = outInfoVec->GetInformationObject(0);
 
-    for(vtkIdType i= begin; i<end; ++i)
+    for(vtkIdType k= begin; k<end; ++k)
       {
+      vtkIdType i = this->Order[k];
       vtkDataObject* outObj =
         this->Exec->ExecuteSimpleAlgorithmForBlock(&inInfoVec[0],
                                                    outInfoVec,
@@ -212,6 +219,7 @@ protected:
   int Connection;
   vtkInformation* Request;
   const std::vector<vtkDataObject*>& InObjs;
+  const std::vector<vtkIdType>& Order;
   vtkDataObject** OutObjs;
 
   vtkSMPThreadLocal<vtkInformationVector**> InInfoVecs;
@@ -223,6 +231,7 @@ protected:
 //----------------------------------------------------------------------------
 vtkThreadedCompositeDataPipeline::vtkThreadedCompositeDataPipeline()
 {
+  this->AssumeReentrant = 1;
 }
 
 //----------------------------------------------------------------------------
@@ -234,6 +243,65 @@ vtkThreadedCompositeDataPipeline::~vtkThreadedCompositeDataPipeline()
 void vtkThreadedCompositeDataPipeline::PrintSelf(ostream &os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "AssumeReentrant: " << this->AssumeReentrant << endl;
+}
+
+//----------------------------------------------------------------------------
+double vtkThreadedCompositeDataPipeline::EstimateBlockCost(vtkDataObject* block)
+{
+  if (!block)
+    {
+    return 0.0;
+    }
+  if (vtkDataSet* ds = vtkDataSet::SafeDownCast(block))
+    {
+    return static_cast<double>(ds->GetNumberOfPoints()) +
+      static_cast<double>(ds->GetNumberOfCells());
+    }
+  return static_cast<double>(block->GetActualMemorySize());
+}
+
+//----------------------------------------------------------------------------
+namespace
+{
+  struct vtkBlockCost
+  {
+    double Cost;
+    vtkIdType Index;
+    bool operator<(const vtkBlockCost& other) const
+      {
+      return this->Cost > other.Cost ||
+        (this->Cost == other.Cost && this->Index < other.Index);
+      }
+  };
+}
+
+//----------------------------------------------------------------------------
+void vtkThreadedCompositeDataPipeline::ComputeExecutionOrder(
+  vtkDataObject* const* blocks, vtkIdType n, vtkIdType* order)
+{
+  std::vector<vtkBlockCost> costs(n);
+  for (vtkIdType i = 0; i < n; ++i)
+    {
+    costs[i].Cost = EstimateBlockCost(blocks[i]);
+    costs[i].Index = i;
+    }
+  std::sort(costs.begin(), costs.end());
+  for (vtkIdType i = 0; i < n; ++i)
+    {
+    order[i] = costs[i].Index;
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkThreadedCompositeDataPipeline::AlgorithmIsReentrant()
+{
+  vtkInformation* info = this->Algorithm->GetInformation();
+  if (info->Has(ALGORITHM_IS_REENTRANT()))
+    {
+    return info->Get(ALGORITHM_IS_REENTRANT()) != 0;
+    }
+  return this->AssumeReentrant != 0;
 }
 
 //-------------------------------------------------------------------------
@@ -245,6 +313,13 @@ void vtkThreadedCompositeDataPipeline::ExecuteEach(vtkCompositeDataIterator* ite
                                                    vtkInformation* request,
                                                    vtkCompositeDataSet* compositeOutput)
 {
+  if (!this->AlgorithmIsReentrant())
+    {
+    this->Superclass::ExecuteEach(iter, inInfoVec, outInfoVec, compositePort,
+                                  connection, request, compositeOutput);
+    return;
+    }
+
   // from input data objects  itr -> (inObjs, indices)
   // inObjs are the non-null objects that we will loop over.
   // indices map the input objects to inObjs
@@ -268,6 +343,15 @@ void vtkThreadedCompositeDataPipeline::ExecuteEach(vtkCompositeDataIterator* ite
   std::vector<vtkDataObject*> outObjs;
   outObjs.resize(indices.size(),NULL);
 
+  // Hand out the largest blocks first, one at a time, so that a few large
+  // blocks do not end up on the same thread.
+  vtkIdType numObjs = static_cast<vtkIdType>(inObjs.size());
+  std::vector<vtkIdType> order(numObjs);
+  if (numObjs > 0)
+    {
+    ComputeExecutionOrder(&inObjs[0], numObjs, &order[0]);
+    }
+
   // create the parallel task processBlock
   ProcessBlock processBlock(this,
                             inInfoVec,
@@ -275,12 +359,12 @@ void vtkThreadedCompositeDataPipeline::ExecuteEach(vtkCompositeDataIterator* ite
                             compositePort,
                             connection,
                             request,
-                            inObjs,outObjs);
+                            inObjs,outObjs,order);
 
   vtkSmartPointer<vtkProgressObserver> origPo(this->Algorithm->GetProgressObserver());
   vtkNew<vtkSMPProgressObserver> po;
   this->Algorithm->SetProgressObserver(po.GetPointer());
-  vtkSMPTools::For(0, inObjs.size(), processBlock);
+  vtkSMPTools::For(0, numObjs, 1, processBlock);
   this->Algorithm->SetProgressObserver(origPo);
 
   int i =0;
@@ -21,6 +21,18 @@
 // algorithm implement all pipeline passes in a re-entrant way. It should
 // store/retrieve all state changes using input and output information
 // objects, which are unique to each thread.
+//
+// The blocks are handed to the threads one at a time, largest first (see
+// ComputeExecutionOrder()), so that inputs whose blocks differ much in size
+// keep all the threads busy.
+//
+// Algorithms declare whether they are re-entrant with the
+// ALGORITHM_IS_REENTRANT() key in their information object
+// (vtkAlgorithm::GetInformation()). The blocks of an algorithm that sets it
+// to 0 are executed one after the other, on the calling thread. The blocks
+// of an algorithm that does not set it are executed in parallel only when
+// AssumeReentrant is on, which is the default. Turn it off to use this
+// executive for pipelines made of arbitrary algorithms.
 
 #ifndef vtkThreadedCompositeDataPipeline_h
 #define vtkThreadedCompositeDataPipeline_h
@@ -28,8 +40,10 @@
 #include "vtkCommonExecutionModelModule.h" // For export macro
 #include "vtkCompositeDataPipeline.h"
 
-class vtkInformationVector;
+class vtkDataObject;
 class vtkInformation;
+class vtkInformationIntegerKey;
+class vtkInformationVector;
 
 class VTKCOMMONEXECUTIONMODEL_EXPORT vtkThreadedCompositeDataPipeline : public vtkCompositeDataPipeline
 {
@@ -45,6 +59,30 @@ class VTKCOMMONEXECUTIONMODEL_EXPORT vtkThreadedCompositeDataPipeline : public v
                             vtkInformationVector** inInfo,
                             vtkInformationVector* outInfo);
 
+  // Description:
+  // Whether the blocks of algorithms that do not set ALGORITHM_IS_REENTRANT()
+  // are executed in parallel. On by default.
+  vtkSetMacro(AssumeReentrant, int);
+  vtkGetMacro(AssumeReentrant, int);
+  vtkBooleanMacro(AssumeReentrant, int);
+
+  // Description:
+  // Key set in the information object of an algorithm to 1 if its pipeline
+  // passes may run concurrently on different blocks, or to 0 if not.
+  static vtkInformationIntegerKey* ALGORITHM_IS_REENTRANT();
+
+  // Description:
+  // Estimate the relative cost of processing a block: its number of points
+  // and cells for a data set, its memory size otherwise.
+  static double EstimateBlockCost(vtkDataObject* block);
+
+  // Description:
+  // Fill order with the indices of the n blocks, NULL ones included, from
+  // the most to the least expensive. Composite data aware algorithms that
+  // process their blocks in parallel use it to schedule their work.
+  static void ComputeExecutionOrder(vtkDataObject* const* blocks, vtkIdType n,
+                                    vtkIdType* order);
+
  protected:
   vtkThreadedCompositeDataPipeline();
   ~vtkThreadedCompositeDataPipeline();
@@ -56,6 +94,11 @@ class VTKCOMMONEXECUTIONMODEL_EXPORT vtkThreadedCompositeDataPipeline : public v
                            vtkInformation* request,
                            vtkCompositeDataSet* compositeOutput);
 
+  // Return whether the blocks of the algorithm can run in parallel.
+  bool AlgorithmIsReentrant();
+
+  int AssumeReentrant;
+
  private:
   vtkThreadedCompositeDataPipeline(const vtkThreadedCompositeDataPipeline&);  // Not implemented.
   void operator=(const vtkThreadedCompositeDataPipeline&);  // Not implemented.
@@ -0,0 +1,119 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkUpdateFuture.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkUpdateFuture.h"
+
+#include "vtkAlgorithm.h"
+#include "vtkExecutive.h"
+#include "vtkMultiThreader.h"
+#include "vtkObjectFactory.h"
+
+vtkStandardNewMacro(vtkUpdateFuture);
+
+//----------------------------------------------------------------------------
+class vtkUpdateFutureThread
+{
+public:
+  static VTK_THREAD_RETURN_TYPE Run(void* arg)
+    {
+    vtkMultiThreader::ThreadInfo* info =
+      static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    vtkUpdateFuture* self = static_cast<vtkUpdateFuture*>(info->UserData);
+    self->Result = self->Algorithm->GetExecutive()->Update(self->Port);
+    self->Done = 1;
+    return VTK_THREAD_RETURN_VALUE;
+    }
+};
+
+//----------------------------------------------------------------------------
+vtkUpdateFuture::vtkUpdateFuture()
+{
+  this->Algorithm = 0;
+  this->Port = 0;
+  this->Threader = vtkMultiThreader::New();
+  this->ThreadId = -1;
+  this->Result = 0;
+  this->Done = 1;
+}
+
+//----------------------------------------------------------------------------
+vtkUpdateFuture::~vtkUpdateFuture()
+{
+  this->Wait();
+  this->Threader->Delete();
+  if (this->Algorithm)
+    {
+    this->Algorithm->UnRegister(this);
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkUpdateFuture::Start(vtkAlgorithm* algorithm, int port)
+{
+  if (this->ThreadId >= 0 && !this->IsDone())
+    {
+    vtkErrorMacro("An update is already running.");
+    return 0;
+    }
+  // Reclaim the thread of the previous update.
+  this->Wait();
+  if (!algorithm)
+    {
+    vtkErrorMacro("No algorithm to update.");
+    return 0;
+    }
+
+  vtkSetObjectBodyMacro(Algorithm, vtkAlgorithm, algorithm);
+  this->Port = port;
+  this->Result = 0;
+  this->Done = 0;
+
+  // Create the executive on this thread.
+  algorithm->GetExecutive();
+  this->ThreadId =
+    this->Threader->SpawnThread(vtkUpdateFutureThread::Run, this);
+  if (this->ThreadId < 0)
+    {
+    vtkErrorMacro("Could not start the update thread.");
+    this->Done = 1;
+    return 0;
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkUpdateFuture::IsDone()
+{
+  return this->Done != 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkUpdateFuture::Wait()
+{
+  if (this->ThreadId >= 0)
+    {
+    this->Threader->TerminateThread(this->ThreadId);
+    this->ThreadId = -1;
+    }
+  return this->Result;
+}
+
+//----------------------------------------------------------------------------
+void vtkUpdateFuture::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Algorithm: " << this->Algorithm << "\n";
+  os << indent << "Port: " << this->Port << "\n";
+  os << indent << "Done: " << this->IsDone() << "\n";
+}
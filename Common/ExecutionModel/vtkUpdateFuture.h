@@ -0,0 +1,92 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkUpdateFuture.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkUpdateFuture - handle on a pipeline update running on its own thread
+// .SECTION Description
+// vtkUpdateFuture brings an output port of an algorithm up to date on a
+// separate thread, so that the application thread can keep rendering or
+// handling events meanwhile. It is usually obtained from
+// vtkAlgorithm::UpdateAsync(). The application polls IsDone(), for instance
+// from a timer, or blocks in Wait(), and then uses the output.
+//
+// .SECTION Caveats
+// Until the update is done, the algorithm, the algorithms upstream of it
+// and their outputs belong to the update thread: they must not be modified,
+// updated or rendered from another thread. Render a copy of a previous
+// output instead. Observers of the algorithms are invoked on the update
+// thread. Destroying the future waits for the update to finish.
+//
+// .SECTION See Also
+// vtkAlgorithm vtkDemandDrivenPipeline
+
+#ifndef vtkUpdateFuture_h
+#define vtkUpdateFuture_h
+
+#include "vtkCommonExecutionModelModule.h" // For export macro
+#include "vtkObject.h"
+#include "vtkAtomicTypes.h" // For Done
+
+class vtkAlgorithm;
+class vtkMultiThreader;
+
+class VTKCOMMONEXECUTIONMODEL_EXPORT vtkUpdateFuture : public vtkObject
+{
+public:
+  static vtkUpdateFuture* New();
+  vtkTypeMacro(vtkUpdateFuture, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Start bringing the given output port of algorithm up to date on a
+  // separate thread (-1 updates all the ports). Return 0, without starting
+  // anything, if an update started by this future is still running.
+  int Start(vtkAlgorithm* algorithm, int port = 0);
+
+  // Description:
+  // Return 1 if the update has finished, or was never started. Does not
+  // block.
+  int IsDone();
+
+  // Description:
+  // Block until the update has finished and return its result: 1 on
+  // success, 0 on failure.
+  int Wait();
+
+  // Description:
+  // The algorithm being updated, and the port it is updated through.
+  vtkGetObjectMacro(Algorithm, vtkAlgorithm);
+  vtkGetMacro(Port, int);
+
+protected:
+  vtkUpdateFuture();
+  ~vtkUpdateFuture();
+
+  vtkAlgorithm* Algorithm;
+  int Port;
+
+private:
+  //BTX
+  friend class vtkUpdateFutureThread;
+  //ETX
+
+  vtkMultiThreader* Threader;
+  int ThreadId;
+  int Result;
+  vtkAtomicInt32 Done;
+
+  vtkUpdateFuture(const vtkUpdateFuture&);  // Not implemented.
+  void operator=(const vtkUpdateFuture&);  // Not implemented.
+};
+
+#endif
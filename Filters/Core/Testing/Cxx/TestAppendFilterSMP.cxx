@@ -0,0 +1,331 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestAppendFilterSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Appends many blocks of a lattice of hexahedra, one of them a polyhedron,
+// with vtkAppendFilter, with and without merging the points the blocks
+// share, and many polydata with verts, lines and polys with
+// vtkAppendPolyData, and checks where the points, cells and attributes of
+// each input end up.
+
+#include "vtkAppendFilter.h"
+#include "vtkAppendPolyData.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkStaticPointLocator.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <vector>
+
+#define CHECK(cond)                                                    \
+  do                                                                   \
+    {                                                                  \
+    if (!(cond))                                                       \
+      {                                                                \
+      cerr << "Line " << __LINE__ << ": check failed: " #cond << endl; \
+      return EXIT_FAILURE;                                             \
+      }                                                                \
+    }                                                                  \
+  while (0)
+
+namespace
+{
+// Blocks of 2x2x2 hexahedra, with 6 blocks along each axis.
+const int BlockCells = 2;
+const int NumberOfBlocks = 6;
+const int LatticePoints = BlockCells * NumberOfBlocks + 1;
+
+vtkIdType LatticeIndex(const double x[3])
+{
+  return static_cast<vtkIdType>(x[0]) + LatticePoints *
+    (static_cast<vtkIdType>(x[1]) + LatticePoints *
+     static_cast<vtkIdType>(x[2]));
+}
+
+vtkSmartPointer<vtkUnstructuredGrid> MakeBlock(int bi, int bj, int bk)
+{
+  const int n = BlockCells + 1;
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  vtkNew<vtkIdTypeArray> index;
+  index->SetName("Index");
+  for (int k = 0; k < n; ++k)
+    {
+    for (int j = 0; j < n; ++j)
+      {
+      for (int i = 0; i < n; ++i)
+        {
+        double x[3] = { static_cast<double>(bi * BlockCells + i),
+                        static_cast<double>(bj * BlockCells + j),
+                        static_cast<double>(bk * BlockCells + k) };
+        points->InsertNextPoint(x);
+        index->InsertNextValue(LatticeIndex(x));
+        }
+      }
+    }
+
+  vtkSmartPointer<vtkUnstructuredGrid> block =
+    vtkSmartPointer<vtkUnstructuredGrid>::New();
+  block->SetPoints(points.GetPointer());
+  block->Allocate(BlockCells * BlockCells * BlockCells);
+  block->GetPointData()->AddArray(index.GetPointer());
+  vtkNew<vtkIntArray> blockIds;
+  blockIds->SetName("Block");
+  int blockId = bi + NumberOfBlocks * (bj + NumberOfBlocks * bk);
+  for (int k = 0; k < BlockCells; ++k)
+    {
+    for (int j = 0; j < BlockCells; ++j)
+      {
+      for (int i = 0; i < BlockCells; ++i)
+        {
+        vtkIdType p = i + n * (j + n * k);
+        vtkIdType hex[8] = { p, p + 1, p + n + 1, p + n,
+                             p + n * n, p + n * n + 1, p + n * n + n + 1,
+                             p + n * n + n };
+        if (blockId == 0 && p == 0)
+          {
+          // The first cell of the first block is a polyhedron.
+          vtkIdType faces[30] = {
+            4, hex[0], hex[3], hex[2], hex[1],
+            4, hex[4], hex[5], hex[6], hex[7],
+            4, hex[0], hex[1], hex[5], hex[4],
+            4, hex[1], hex[2], hex[6], hex[5],
+            4, hex[2], hex[3], hex[7], hex[6],
+            4, hex[3], hex[0], hex[4], hex[7] };
+          block->InsertNextCell(VTK_POLYHEDRON, 6, faces);
+          }
+        else
+          {
+          block->InsertNextCell(VTK_HEXAHEDRON, 8, hex);
+          }
+        blockIds->InsertNextValue(blockId);
+        }
+      }
+    }
+  block->GetCellData()->AddArray(blockIds.GetPointer());
+  return block;
+}
+
+// Every point of the output is where its Index says it is, and the cells
+// follow the blocks in order.
+int CheckBlocks(vtkUnstructuredGrid *output)
+{
+  const int cellsPerBlock = BlockCells * BlockCells * BlockCells;
+  vtkIdTypeArray *index = vtkIdTypeArray::SafeDownCast(
+    output->GetPointData()->GetArray("Index"));
+  vtkIntArray *blockIds = vtkIntArray::SafeDownCast(
+    output->GetCellData()->GetArray("Block"));
+  CHECK(index && blockIds);
+  CHECK(output->GetPoints()->GetDataType() == VTK_DOUBLE);
+  double x[3];
+  for (vtkIdType i = 0; i < output->GetNumberOfPoints(); ++i)
+    {
+    output->GetPoint(i, x);
+    CHECK(index->GetValue(i) == LatticeIndex(x));
+    }
+  CHECK(output->GetNumberOfCells() ==
+        NumberOfBlocks * NumberOfBlocks * NumberOfBlocks * cellsPerBlock);
+  vtkNew<vtkIdList> ptIds;
+  for (vtkIdType i = 0; i < output->GetNumberOfCells(); ++i)
+    {
+    CHECK(blockIds->GetValue(i) == i / cellsPerBlock);
+    CHECK(output->GetCellType(i) ==
+          (i == 0 ? VTK_POLYHEDRON : VTK_HEXAHEDRON));
+    output->GetCellPoints(i, ptIds.GetPointer());
+    CHECK(ptIds->GetNumberOfIds() == 8);
+    }
+
+  // The faces of the polyhedron refer to the output points.
+  output->GetFaceStream(0, ptIds.GetPointer());
+  CHECK(ptIds->GetNumberOfIds() == 31 && ptIds->GetId(0) == 6);
+  output->GetPoint(ptIds->GetId(2), x);
+  CHECK(x[0] == 0.0 && x[1] == 0.0 && x[2] == 0.0);
+  output->GetPoint(ptIds->GetId(7), x);
+  CHECK(x[0] == 0.0 && x[1] == 0.0 && x[2] == 1.0);
+  return EXIT_SUCCESS;
+}
+
+int TestAppendFilter()
+{
+  vtkNew<vtkAppendFilter> append;
+  std::vector<vtkSmartPointer<vtkUnstructuredGrid> > blocks;
+  for (int k = 0; k < NumberOfBlocks; ++k)
+    {
+    for (int j = 0; j < NumberOfBlocks; ++j)
+      {
+      for (int i = 0; i < NumberOfBlocks; ++i)
+        {
+        blocks.push_back(MakeBlock(i, j, k));
+        append->AddInputData(blocks.back());
+        }
+      }
+    }
+
+  append->Update();
+  vtkUnstructuredGrid *output = append->GetOutput();
+  vtkIdType pointsPerBlock = blocks[0]->GetNumberOfPoints();
+  CHECK(output->GetNumberOfPoints() ==
+        static_cast<vtkIdType>(blocks.size()) * pointsPerBlock);
+  CHECK(CheckBlocks(output) == EXIT_SUCCESS);
+  vtkNew<vtkIdList> ptIds;
+  output->GetCellPoints(9, ptIds.GetPointer());
+  CHECK(ptIds->GetId(0) == pointsPerBlock + 1);
+
+  // Merging leaves the lattice, the points numbered as they first appear.
+  append->MergePointsOn();
+  append->Update();
+  output = append->GetOutput();
+  CHECK(output->GetNumberOfPoints() ==
+        LatticePoints * LatticePoints * LatticePoints);
+  CHECK(CheckBlocks(output) == EXIT_SUCCESS);
+  for (vtkIdType i = 0; i < pointsPerBlock; ++i)
+    {
+    double x[3], y[3];
+    output->GetPoint(i, x);
+    blocks[0]->GetPoint(i, y);
+    CHECK(x[0] == y[0] && x[1] == y[1] && x[2] == y[2]);
+    }
+  return EXIT_SUCCESS;
+}
+
+int TestAppendPolyData()
+{
+  // Input i has i % 3 verts, a line and two triangles. The cells are
+  // numbered by input in the cell data.
+  const int numInputs = 500;
+  vtkNew<vtkAppendPolyData> append;
+  std::vector<vtkSmartPointer<vtkPolyData> > inputs;
+  for (int i = 0; i < numInputs; ++i)
+    {
+    vtkNew<vtkPoints> points;
+    vtkNew<vtkIntArray> pointIds;
+    pointIds->SetName("Input");
+    for (int j = 0; j < 4; ++j)
+      {
+      points->InsertNextPoint(i, j % 2, j / 2);
+      pointIds->InsertNextValue(i);
+      }
+    vtkNew<vtkCellArray> verts, lines, polys;
+    for (vtkIdType j = 0; j < i % 3; ++j)
+      {
+      verts->InsertNextCell(1, &j);
+      }
+    vtkIdType line[2] = { 0, 3 };
+    lines->InsertNextCell(2, line);
+    vtkIdType tris[6] = { 0, 1, 2, 1, 3, 2 };
+    polys->InsertNextCell(3, tris);
+    polys->InsertNextCell(3, tris + 3);
+
+    vtkSmartPointer<vtkPolyData> input = vtkSmartPointer<vtkPolyData>::New();
+    input->SetPoints(points.GetPointer());
+    input->SetVerts(verts.GetPointer());
+    input->SetLines(lines.GetPointer());
+    input->SetPolys(polys.GetPointer());
+    input->GetPointData()->SetScalars(pointIds.GetPointer());
+    vtkNew<vtkIntArray> cellIds;
+    cellIds->SetName("Cell");
+    for (vtkIdType j = 0; j < input->GetNumberOfCells(); ++j)
+      {
+      cellIds->InsertNextValue(i * 10 + j);
+      }
+    input->GetCellData()->AddArray(cellIds.GetPointer());
+    inputs.push_back(input);
+    append->AddInputData(input);
+    }
+
+  append->Update();
+  vtkPolyData *output = append->GetOutput();
+  CHECK(output->GetNumberOfPoints() == 4 * numInputs);
+  vtkDataArray *pointIds = output->GetPointData()->GetScalars();
+  CHECK(pointIds && pointIds->GetNumberOfTuples() == 4 * numInputs);
+  for (vtkIdType i = 0; i < output->GetNumberOfPoints(); ++i)
+    {
+    CHECK(pointIds->GetTuple1(i) == i / 4);
+    }
+
+  // The verts of all the inputs come first, then the lines and the polys.
+  vtkIntArray *cellIds = vtkIntArray::SafeDownCast(
+    output->GetCellData()->GetArray("Cell"));
+  CHECK(cellIds);
+  vtkIdType cellId = 0;
+  vtkNew<vtkIdList> ptIds;
+  for (int type = 0; type < 3; ++type)
+    {
+    for (int i = 0; i < numInputs; ++i)
+      {
+      int numVerts = i % 3;
+      int first[3] = { 0, numVerts, numVerts + 1 };
+      int count[3] = { numVerts, 1, 2 };
+      for (int j = 0; j < count[type]; ++j, ++cellId)
+        {
+        CHECK(cellIds->GetValue(cellId) == i * 10 + first[type] + j);
+        output->GetCellPoints(cellId, ptIds.GetPointer());
+        CHECK(ptIds->GetNumberOfIds() == (type == 0 ? 1 : type + 1));
+        CHECK(ptIds->GetId(0) / 4 == i);
+        }
+      }
+    }
+  CHECK(cellId == output->GetNumberOfCells());
+  return EXIT_SUCCESS;
+}
+
+int TestMergePoints()
+{
+  // Every third point is a copy of a point further up.
+  const vtkIdType n = 30000;
+  vtkNew<vtkPoints> points;
+  for (vtkIdType i = 0; i < n; ++i)
+    {
+    vtkIdType j = i % 3 ? i : (i * 7) % n;
+    points->InsertNextPoint(j % 101, (j / 101) % 97, j / (101 * 97));
+    }
+  vtkNew<vtkPolyData> cloud;
+  cloud->SetPoints(points.GetPointer());
+  vtkNew<vtkStaticPointLocator> locator;
+  locator->SetDataSet(cloud.GetPointer());
+  std::vector<vtkIdType> mergeMap(n);
+  locator->MergePoints(0.0, &mergeMap[0]);
+
+  for (vtkIdType i = 0; i < n; ++i)
+    {
+    double x[3], y[3];
+    points->GetPoint(i, x);
+    points->GetPoint(mergeMap[i], y);
+    CHECK(x[0] == y[0] && x[1] == y[1] && x[2] == y[2]);
+    CHECK(mergeMap[i] <= i);
+    CHECK(mergeMap[mergeMap[i]] == mergeMap[i]);
+    }
+
+  // Within a tolerance, points absorb the unmerged ones around them.
+  locator->MergePoints(1.5, &mergeMap[0]);
+  CHECK(mergeMap[0] == 0 && mergeMap[1] == 0 && mergeMap[2] == 2);
+  return EXIT_SUCCESS;
+}
+}
+
+int TestAppendFilterSMP(int, char *[])
+{
+  CHECK(TestAppendFilter() == EXIT_SUCCESS);
+  CHECK(TestAppendPolyData() == EXIT_SUCCESS);
+  CHECK(TestMergePoints() == EXIT_SUCCESS);
+
+  return EXIT_SUCCESS;
+}
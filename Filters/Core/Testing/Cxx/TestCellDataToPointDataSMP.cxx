@@ -0,0 +1,294 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCellDataToPointDataSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Maps cell data to point data and back on image data, blanked structured
+// grids, polydata and unstructured grids, and checks the averages against
+// the cells around each point and the points of each cell. The ghost
+// arrays passed through must not be mixed up with the interpolated ones.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCellDataToPointData.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdList.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPointDataToCellData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkStructuredGrid.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cmath>
+
+#define CHECK(cond)                                                    \
+  do                                                                   \
+    {                                                                  \
+    if (!(cond))                                                       \
+      {                                                                \
+      cerr << "Line " << __LINE__ << ": check failed: " #cond << endl; \
+      return EXIT_FAILURE;                                             \
+      }                                                                \
+    }                                                                  \
+  while (0)
+
+namespace
+{
+void AddArrays(vtkDataSetAttributes *attributes, vtkIdType n)
+{
+  vtkNew<vtkDoubleArray> values;
+  values->SetName("Values");
+  vtkNew<vtkIntArray> ints;
+  ints->SetName("Ints");
+  for (vtkIdType i = 0; i < n; ++i)
+    {
+    values->InsertNextValue(0.5 * i + (i % 7));
+    ints->InsertNextValue(static_cast<int>(i % 11));
+    }
+  attributes->SetScalars(values.GetPointer());
+  attributes->AddArray(ints.GetPointer());
+}
+
+void AddGhosts(vtkDataSetAttributes *attributes, vtkIdType n, int value)
+{
+  vtkNew<vtkUnsignedCharArray> ghosts;
+  ghosts->SetName(vtkDataSetAttributes::GhostArrayName());
+  ghosts->SetNumberOfTuples(n);
+  ghosts->FillComponent(0, value);
+  attributes->AddArray(ghosts.GetPointer());
+}
+
+// The point data of output is the mean of the cell data of the cells
+// around each point that visible() accepts.
+template <class TVisible>
+int CheckPointData(vtkDataSet *input, vtkDataSet *output, TVisible visible)
+{
+  vtkDataArray *cellValues = input->GetCellData()->GetArray("Values");
+  vtkDataArray *values = output->GetPointData()->GetScalars();
+  CHECK(values && values->GetName());
+  CHECK(values->GetNumberOfTuples() == input->GetNumberOfPoints());
+  vtkNew<vtkIdList> cellIds;
+  for (vtkIdType i = 0; i < input->GetNumberOfPoints(); ++i)
+    {
+    input->GetPointCells(i, cellIds.GetPointer());
+    double sum = 0.0;
+    int numCells = 0;
+    for (vtkIdType j = 0; j < cellIds->GetNumberOfIds(); ++j)
+      {
+      if (visible(cellIds->GetId(j)))
+        {
+        sum += cellValues->GetTuple1(cellIds->GetId(j));
+        ++numCells;
+        }
+      }
+    double expected = numCells ? sum / numCells : 0.0;
+    CHECK(std::fabs(values->GetTuple1(i) - expected) < 1e-9);
+    }
+  return EXIT_SUCCESS;
+}
+
+bool AllCells(vtkIdType)
+{
+  return true;
+}
+
+struct VisibleCells
+{
+  vtkStructuredGrid *Grid;
+  bool operator()(vtkIdType cellId)
+    {
+    return this->Grid->IsCellVisible(cellId) != 0;
+    }
+};
+
+// The cell data of output is the mean of the point data of each cell.
+int CheckCellData(vtkDataSet *input, vtkDataSet *output)
+{
+  vtkDataArray *pointValues = input->GetPointData()->GetArray("Values");
+  vtkDataArray *values = output->GetCellData()->GetScalars();
+  vtkDataArray *ints = output->GetCellData()->GetArray("Ints");
+  CHECK(values && ints);
+  CHECK(values->GetNumberOfTuples() == input->GetNumberOfCells());
+  vtkNew<vtkIdList> ptIds;
+  for (vtkIdType i = 0; i < input->GetNumberOfCells(); ++i)
+    {
+    input->GetCellPoints(i, ptIds.GetPointer());
+    double sum = 0.0;
+    for (vtkIdType j = 0; j < ptIds->GetNumberOfIds(); ++j)
+      {
+      sum += pointValues->GetTuple1(ptIds->GetId(j));
+      }
+    CHECK(std::fabs(values->GetTuple1(i) - sum / ptIds->GetNumberOfIds())
+          < 1e-9);
+    }
+  return EXIT_SUCCESS;
+}
+
+int TestImageData()
+{
+  vtkNew<vtkImageData> image;
+  image->SetExtent(-3, 26, 0, 19, 2, 18);
+  AddArrays(image->GetCellData(), image->GetNumberOfCells());
+  AddArrays(image->GetPointData(), image->GetNumberOfPoints());
+
+  vtkNew<vtkCellDataToPointData> c2p;
+  c2p->SetInputData(image.GetPointer());
+  c2p->Update();
+  CHECK(CheckPointData(image.GetPointer(), c2p->GetOutput(), AllCells) ==
+        EXIT_SUCCESS);
+
+  vtkNew<vtkPointDataToCellData> p2c;
+  p2c->SetInputData(image.GetPointer());
+  p2c->Update();
+  CHECK(CheckCellData(image.GetPointer(), p2c->GetOutput()) == EXIT_SUCCESS);
+  return EXIT_SUCCESS;
+}
+
+int TestBlankedStructuredGrid()
+{
+  vtkNew<vtkStructuredGrid> grid;
+  grid->SetDimensions(15, 12, 9);
+  vtkNew<vtkPoints> points;
+  for (int k = 0; k < 9; ++k)
+    {
+    for (int j = 0; j < 12; ++j)
+      {
+      for (int i = 0; i < 15; ++i)
+        {
+        points->InsertNextPoint(i, j, k + 0.1 * i);
+        }
+      }
+    }
+  grid->SetPoints(points.GetPointer());
+  AddArrays(grid->GetCellData(), grid->GetNumberOfCells());
+  for (vtkIdType i = 0; i < grid->GetNumberOfCells(); i += 3)
+    {
+    grid->BlankCell(i);
+    }
+
+  vtkNew<vtkCellDataToPointData> c2p;
+  c2p->SetInputData(grid.GetPointer());
+  c2p->Update();
+  VisibleCells visible = { grid.GetPointer() };
+  CHECK(CheckPointData(grid.GetPointer(), c2p->GetOutput(), visible) ==
+        EXIT_SUCCESS);
+  return EXIT_SUCCESS;
+}
+
+int TestPolyData()
+{
+  // A strip of quads and triangles; the last point is used by no cell.
+  const vtkIdType n = 5000;
+  vtkNew<vtkPoints> points;
+  for (vtkIdType i = 0; i <= n; ++i)
+    {
+    points->InsertNextPoint(i, 0.0, 0.0);
+    points->InsertNextPoint(i, 1.0, 0.0);
+    }
+  points->InsertNextPoint(0.0, 2.0, 0.0);
+  vtkNew<vtkCellArray> polys;
+  for (vtkIdType i = 0; i < n; ++i)
+    {
+    vtkIdType quad[4] = { 2 * i, 2 * i + 2, 2 * i + 3, 2 * i + 1 };
+    polys->InsertNextCell(i % 3 ? 4 : 3, quad);
+    }
+  vtkNew<vtkPolyData> polyData;
+  polyData->SetPoints(points.GetPointer());
+  polyData->SetPolys(polys.GetPointer());
+  AddArrays(polyData->GetCellData(), polyData->GetNumberOfCells());
+  AddArrays(polyData->GetPointData(), polyData->GetNumberOfPoints());
+  AddGhosts(polyData->GetCellData(), polyData->GetNumberOfCells(),
+            vtkDataSetAttributes::DUPLICATECELL);
+  AddGhosts(polyData->GetPointData(), polyData->GetNumberOfPoints(),
+            vtkDataSetAttributes::DUPLICATEPOINT);
+
+  vtkNew<vtkCellDataToPointData> c2p;
+  c2p->SetInputData(polyData.GetPointer());
+  c2p->Update();
+  vtkDataSet *output = c2p->GetOutput();
+  CHECK(CheckPointData(polyData.GetPointer(), output, AllCells) ==
+        EXIT_SUCCESS);
+  CHECK(output->GetPointData()->GetScalars()->GetTuple1(2 * n + 2) == 0.0);
+  vtkUnsignedCharArray *ghosts = output->GetPointGhostArray();
+  CHECK(ghosts && ghosts->GetNumberOfTuples() == output->GetNumberOfPoints());
+  CHECK(ghosts->GetValue(0) == vtkDataSetAttributes::DUPLICATEPOINT);
+
+  vtkNew<vtkPointDataToCellData> p2c;
+  p2c->SetInputData(polyData.GetPointer());
+  p2c->Update();
+  output = p2c->GetOutput();
+  CHECK(CheckCellData(polyData.GetPointer(), output) == EXIT_SUCCESS);
+  ghosts = output->GetCellGhostArray();
+  CHECK(ghosts && ghosts->GetNumberOfTuples() == output->GetNumberOfCells());
+  CHECK(ghosts->GetValue(0) == vtkDataSetAttributes::DUPLICATECELL);
+  return EXIT_SUCCESS;
+}
+
+int TestUnstructuredGrid()
+{
+  // Tetrahedra sharing points with their neighbours.
+  const vtkIdType n = 20000;
+  vtkNew<vtkPoints> points;
+  for (vtkIdType i = 0; i < n + 3; ++i)
+    {
+    points->InsertNextPoint(i, i % 2, i % 3);
+    }
+  vtkNew<vtkUnstructuredGrid> grid;
+  grid->SetPoints(points.GetPointer());
+  grid->Allocate(n);
+  for (vtkIdType i = 0; i < n; ++i)
+    {
+    vtkIdType tetra[4] = { i, i + 1, i + 2, i + 3 };
+    grid->InsertNextCell(VTK_TETRA, 4, tetra);
+    }
+  AddArrays(grid->GetCellData(), n);
+
+  vtkNew<vtkCellDataToPointData> c2p;
+  c2p->SetInputData(grid.GetPointer());
+  c2p->Update();
+  vtkDataSet *output = c2p->GetOutput();
+  CHECK(CheckPointData(grid.GetPointer(), output, AllCells) == EXIT_SUCCESS);
+
+  // Unstructured grids average integers in their own type.
+  vtkIntArray *ints = vtkIntArray::SafeDownCast(
+    output->GetPointData()->GetArray("Ints"));
+  CHECK(ints);
+  vtkNew<vtkIdList> cellIds;
+  for (vtkIdType i = 0; i < grid->GetNumberOfPoints(); ++i)
+    {
+    grid->GetPointCells(i, cellIds.GetPointer());
+    int sum = 0;
+    for (vtkIdType j = 0; j < cellIds->GetNumberOfIds(); ++j)
+      {
+      sum += static_cast<int>(cellIds->GetId(j) % 11);
+      }
+    CHECK(ints->GetValue(i) ==
+          sum / static_cast<int>(cellIds->GetNumberOfIds()));
+    }
+  return EXIT_SUCCESS;
+}
+}
+
+int TestCellDataToPointDataSMP(int, char *[])
+{
+  CHECK(TestImageData() == EXIT_SUCCESS);
+  CHECK(TestBlankedStructuredGrid() == EXIT_SUCCESS);
+  CHECK(TestPolyData() == EXIT_SUCCESS);
+  CHECK(TestUnstructuredGrid() == EXIT_SUCCESS);
+
+  return EXIT_SUCCESS;
+}
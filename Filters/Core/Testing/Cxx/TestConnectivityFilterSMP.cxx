@@ -0,0 +1,192 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestConnectivityFilterSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Extracts the regions of interleaved chains of lines, which cross the
+// blocks of cells the regions are found in, with vtkConnectivityFilter and
+// vtkPolyDataConnectivityFilter, and checks the region numbers and sizes,
+// with and without scalar connectivity, and seeding from a cell that does
+// not connect.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkConnectivityFilter.h"
+#include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataConnectivityFilter.h"
+#include "vtkUnstructuredGrid.h"
+
+#define CHECK(cond)                                                    \
+  do                                                                   \
+    {                                                                  \
+    if (!(cond))                                                       \
+      {                                                                \
+      cerr << "Line " << __LINE__ << ": check failed: " #cond << endl; \
+      return EXIT_FAILURE;                                             \
+      }                                                                \
+    }                                                                  \
+  while (0)
+
+namespace
+{
+// Line i joins points i and i + 7, so the lines i % 7 form seven chains.
+const vtkIdType NumberOfLines = 30000;
+const vtkIdType NumberOfChains = 7;
+
+// The lines from this one on, of the fourth chain, have their points out
+// of the scalar range and are regions of their own.
+const vtkIdType FirstOutOfRange = 15004;
+const vtkIdType NumberOfOutOfRange = 2143;
+
+void InitializeChains(vtkPolyData *polyData)
+{
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkFloatArray> scalars;
+  vtkNew<vtkIdTypeArray> pointIds;
+  pointIds->SetName("PointIds");
+  for (vtkIdType i = 0; i < NumberOfLines + NumberOfChains; ++i)
+    {
+    points->InsertNextPoint(i, i % NumberOfChains, 0.0);
+    scalars->InsertNextValue(
+      i >= FirstOutOfRange && i % NumberOfChains == 3 ? 0.0 : 1.0);
+    pointIds->InsertNextValue(i);
+    }
+  vtkNew<vtkCellArray> lines;
+  for (vtkIdType i = 0; i < NumberOfLines; ++i)
+    {
+    vtkIdType line[2] = { i, i + NumberOfChains };
+    lines->InsertNextCell(2, line);
+    }
+  polyData->SetPoints(points.GetPointer());
+  polyData->SetLines(lines.GetPointer());
+  polyData->GetPointData()->SetScalars(scalars.GetPointer());
+  polyData->GetPointData()->AddArray(pointIds.GetPointer());
+}
+
+vtkIdType ChainSize(vtkIdType chain)
+{
+  return (NumberOfLines - chain + NumberOfChains - 1) / NumberOfChains;
+}
+
+// The output points keep the order of the input points.
+int CheckPointOrder(vtkDataSet *output)
+{
+  vtkIdTypeArray *pointIds = vtkIdTypeArray::SafeDownCast(
+    output->GetPointData()->GetArray("PointIds"));
+  CHECK(pointIds);
+  for (vtkIdType i = 1; i < output->GetNumberOfPoints(); ++i)
+    {
+    CHECK(pointIds->GetValue(i - 1) < pointIds->GetValue(i));
+    }
+  return EXIT_SUCCESS;
+}
+
+int TestConnectivity(vtkPolyData *polyData)
+{
+  vtkNew<vtkConnectivityFilter> connectivity;
+  connectivity->SetInputData(polyData);
+  connectivity->SetExtractionModeToAllRegions();
+  connectivity->ColorRegionsOn();
+  connectivity->Update();
+
+  vtkUnstructuredGrid *output = connectivity->GetOutput();
+  CHECK(connectivity->GetNumberOfExtractedRegions() == NumberOfChains);
+  CHECK(output->GetNumberOfCells() == NumberOfLines);
+  CHECK(output->GetNumberOfPoints() == NumberOfLines + NumberOfChains);
+  vtkIdTypeArray *cellRegions = vtkIdTypeArray::SafeDownCast(
+    output->GetCellData()->GetArray("RegionId"));
+  vtkIdTypeArray *pointRegions = vtkIdTypeArray::SafeDownCast(
+    output->GetPointData()->GetArray("RegionId"));
+  CHECK(cellRegions && pointRegions);
+  for (vtkIdType i = 0; i < NumberOfLines; ++i)
+    {
+    CHECK(cellRegions->GetValue(i) == i % NumberOfChains);
+    CHECK(pointRegions->GetValue(i) == i % NumberOfChains);
+    }
+  CHECK(CheckPointOrder(output) == EXIT_SUCCESS);
+
+  // With scalar connectivity, the lines out of range follow the chains.
+  connectivity->ScalarConnectivityOn();
+  connectivity->SetScalarRange(0.5, 1.5);
+  connectivity->Update();
+  CHECK(connectivity->GetNumberOfExtractedRegions() ==
+        NumberOfChains + NumberOfOutOfRange);
+  cellRegions = vtkIdTypeArray::SafeDownCast(
+    output->GetCellData()->GetArray("RegionId"));
+  for (vtkIdType i = 0, outOfRange = 0; i < NumberOfLines; ++i)
+    {
+    if (i >= FirstOutOfRange && i % NumberOfChains == 3)
+      {
+      CHECK(cellRegions->GetValue(i) == NumberOfChains + outOfRange++);
+      }
+    else
+      {
+      CHECK(cellRegions->GetValue(i) == i % NumberOfChains);
+      }
+    }
+
+  // A seed out of range reaches the chain sharing its points.
+  connectivity->SetExtractionModeToCellSeededRegions();
+  connectivity->AddSeed(FirstOutOfRange);
+  connectivity->Update();
+  CHECK(output->GetNumberOfCells() == ChainSize(3) - NumberOfOutOfRange + 1);
+  CHECK(CheckPointOrder(output) == EXIT_SUCCESS);
+  return EXIT_SUCCESS;
+}
+
+int TestPolyDataConnectivity(vtkPolyData *polyData)
+{
+  vtkNew<vtkPolyDataConnectivityFilter> connectivity;
+  connectivity->SetInputData(polyData);
+  connectivity->SetExtractionModeToLargestRegion();
+  connectivity->Update();
+
+  vtkIdTypeArray *regionSizes = connectivity->GetRegionSizes();
+  CHECK(connectivity->GetNumberOfExtractedRegions() == NumberOfChains);
+  for (vtkIdType i = 0; i < NumberOfChains; ++i)
+    {
+    CHECK(regionSizes->GetValue(i) == ChainSize(i));
+    }
+  CHECK(connectivity->GetOutput()->GetNumberOfCells() == ChainSize(0));
+  CHECK(CheckPointOrder(connectivity->GetOutput()) == EXIT_SUCCESS);
+
+  connectivity->ScalarConnectivityOn();
+  connectivity->SetScalarRange(0.5, 1.5);
+  connectivity->SetExtractionModeToSpecifiedRegions();
+  connectivity->AddSpecifiedRegion(3);
+  connectivity->AddSpecifiedRegion(NumberOfChains);
+  connectivity->Update();
+  CHECK(connectivity->GetNumberOfExtractedRegions() ==
+        NumberOfChains + NumberOfOutOfRange);
+  CHECK(regionSizes->GetValue(3) == ChainSize(3) - NumberOfOutOfRange);
+  CHECK(regionSizes->GetValue(NumberOfChains) == 1);
+  CHECK(connectivity->GetOutput()->GetNumberOfCells() ==
+        ChainSize(3) - NumberOfOutOfRange + 1);
+  return EXIT_SUCCESS;
+}
+}
+
+int TestConnectivityFilterSMP(int, char *[])
+{
+  vtkNew<vtkPolyData> polyData;
+  InitializeChains(polyData.GetPointer());
+
+  CHECK(TestConnectivity(polyData.GetPointer()) == EXIT_SUCCESS);
+  CHECK(TestPolyDataConnectivity(polyData.GetPointer()) == EXIT_SUCCESS);
+
+  return EXIT_SUCCESS;
+}
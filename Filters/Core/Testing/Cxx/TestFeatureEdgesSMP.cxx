@@ -0,0 +1,179 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestFeatureEdgesSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Extracts the edges of a grid of quads folded at a right angle, with a
+// fin on one interior edge, and checks the number of edges of each type,
+// the merged points and the cell data of the lines.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkFeatureEdges.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkUnsignedCharArray.h"
+
+#define CHECK(cond)                                                    \
+  do                                                                   \
+    {                                                                  \
+    if (!(cond))                                                       \
+      {                                                                \
+      cerr << "Line " << __LINE__ << ": check failed: " #cond << endl; \
+      return EXIT_FAILURE;                                             \
+      }                                                                \
+    }                                                                  \
+  while (0)
+
+namespace
+{
+const int N = 200;
+
+// N x N quads in the plane z = 0 up to the row N/2, and in the plane
+// y = N/2 above it. The fin is a vertical quad on the edge from (1,1) to
+// (2,1).
+void MakeMesh(vtkPolyData *mesh)
+{
+  const int m = N / 2;
+  vtkNew<vtkPoints> points;
+  for (int j = 0; j <= N; ++j)
+    {
+    for (int i = 0; i <= N; ++i)
+      {
+      points->InsertNextPoint(i, j < m ? j : m, j < m ? 0 : j - m);
+      }
+    }
+  vtkNew<vtkCellArray> polys;
+  for (int j = 0; j < N; ++j)
+    {
+    for (int i = 0; i < N; ++i)
+      {
+      vtkIdType p = j * (N + 1) + i;
+      vtkIdType quad[4] = { p, p + 1, p + N + 2, p + N + 1 };
+      polys->InsertNextCell(4, quad);
+      }
+    }
+  vtkIdType fin[4] = { N + 2, N + 3, points->InsertNextPoint(2, 1, 5),
+                       points->InsertNextPoint(1, 1, 5) };
+  polys->InsertNextCell(4, fin);
+  mesh->SetPoints(points.GetPointer());
+  mesh->SetPolys(polys.GetPointer());
+
+  vtkNew<vtkIdTypeArray> ids;
+  ids->SetName("Ids");
+  for (vtkIdType i = 0; i < polys->GetNumberOfCells(); ++i)
+    {
+    ids->InsertNextValue(i);
+    }
+  mesh->GetCellData()->AddArray(ids.GetPointer());
+}
+
+// Count the lines colored with value.
+vtkIdType CountLines(vtkPolyData *output, float value)
+{
+  vtkDataArray *scalars = output->GetCellData()->GetScalars();
+  vtkIdType count = 0;
+  for (vtkIdType i = 0; i < scalars->GetNumberOfTuples(); ++i)
+    {
+    if (static_cast<float>(scalars->GetTuple1(i)) == value)
+      {
+      ++count;
+      }
+    }
+  return count;
+}
+
+// Each line is an edge of the polygon its cell data comes from.
+int CheckLines(vtkPolyData *mesh, vtkPolyData *output)
+{
+  vtkDataArray *ids = output->GetCellData()->GetArray("Ids");
+  CHECK(ids && ids->GetNumberOfTuples() == output->GetNumberOfCells());
+  vtkNew<vtkIdList> linePts;
+  vtkNew<vtkIdList> cellPts;
+  for (vtkIdType i = 0; i < output->GetNumberOfCells(); ++i)
+    {
+    output->GetCellPoints(i, linePts.GetPointer());
+    CHECK(linePts->GetNumberOfIds() == 2);
+    mesh->GetCellPoints(static_cast<vtkIdType>(ids->GetTuple1(i)),
+                        cellPts.GetPointer());
+    bool found = false;
+    vtkIdType npts = cellPts->GetNumberOfIds();
+    for (vtkIdType j = 0; j < npts && !found; ++j)
+      {
+      double x1[3], x2[3], y1[3], y2[3];
+      output->GetPoint(linePts->GetId(0), x1);
+      output->GetPoint(linePts->GetId(1), x2);
+      mesh->GetPoint(cellPts->GetId(j), y1);
+      mesh->GetPoint(cellPts->GetId((j + 1) % npts), y2);
+      found = x1[0] == y1[0] && x1[1] == y1[1] && x1[2] == y1[2] &&
+        x2[0] == y2[0] && x2[1] == y2[1] && x2[2] == y2[2];
+      }
+    CHECK(found);
+    }
+  return EXIT_SUCCESS;
+}
+}
+
+int TestFeatureEdgesSMP(int, char *[])
+{
+  vtkNew<vtkPolyData> mesh;
+  MakeMesh(mesh.GetPointer());
+
+  // Boundary edges of the grid and of the fin, the fold, and the edge
+  // shared by the grid and the fin.
+  vtkNew<vtkFeatureEdges> edges;
+  edges->SetInputData(mesh.GetPointer());
+  edges->Update();
+  vtkPolyData *output = edges->GetOutput();
+  CHECK(output->GetNumberOfCells() == 5 * N + 4);
+  CHECK(CountLines(output, 0.0f) == 4 * N + 3);
+  CHECK(CountLines(output, 0.222222f) == 1);
+  CHECK(CountLines(output, 0.444444f) == N);
+  CHECK(output->GetNumberOfPoints() == 5 * N + 3);
+  CHECK(CheckLines(mesh.GetPointer(), output) == EXIT_SUCCESS);
+
+  // A feature angle above the fold keeps it out.
+  edges->SetFeatureAngle(100.0);
+  edges->Update();
+  CHECK(output->GetNumberOfCells() == 4 * N + 4);
+  CHECK(CountLines(output, 0.444444f) == 0);
+
+  // Manifold edges are the ones between two quads, without feature edges,
+  // and use all the points but the corners of the grid.
+  edges->BoundaryEdgesOff();
+  edges->NonManifoldEdgesOff();
+  edges->FeatureEdgesOff();
+  edges->ManifoldEdgesOn();
+  edges->Update();
+  CHECK(output->GetNumberOfCells() == 2 * N * (N - 1) - 1);
+  CHECK(CountLines(output, 0.666667f) == 2 * N * (N - 1) - 1);
+  CHECK(output->GetNumberOfPoints() == (N + 1) * (N + 1) - 4);
+  CHECK(CheckLines(mesh.GetPointer(), output) == EXIT_SUCCESS);
+
+  // Duplicate cells produce no edges.
+  vtkNew<vtkUnsignedCharArray> ghosts;
+  ghosts->SetName(vtkDataSetAttributes::GhostArrayName());
+  ghosts->SetNumberOfTuples(mesh->GetNumberOfCells());
+  ghosts->FillComponent(0, vtkDataSetAttributes::DUPLICATECELL);
+  mesh->GetCellData()->AddArray(ghosts.GetPointer());
+  edges->BoundaryEdgesOn();
+  edges->NonManifoldEdgesOn();
+  edges->FeatureEdgesOn();
+  edges->Update();
+  CHECK(output->GetNumberOfCells() == 0);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,262 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestGlyph3DSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks the glyphs and attributes vtkGlyph3D computes in parallel against
+// glyphs transformed with vtkTransform, for float and double sources, and
+// that the serial path used for bit arrays gives the same output.
+
+#include "vtkBitArray.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkConeSource.h"
+#include "vtkDataSetAttributes.h"
+#include "vtkFloatArray.h"
+#include "vtkGlyph3D.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkTransform.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <cmath>
+
+#define CHECK(cond)                                                    \
+  do                                                                   \
+    {                                                                  \
+    if (!(cond))                                                       \
+      {                                                                \
+      cerr << "Line " << __LINE__ << ": check failed: " #cond << endl; \
+      return EXIT_FAILURE;                                             \
+      }                                                                \
+    }                                                                  \
+  while (0)
+
+namespace
+{
+bool SameTuples(vtkDataArray *a, vtkDataArray *b, double tolerance)
+{
+  if (!a || !b || a->GetNumberOfTuples() != b->GetNumberOfTuples() ||
+      a->GetNumberOfComponents() != b->GetNumberOfComponents())
+    {
+    return false;
+    }
+  for (vtkIdType i = 0; i < a->GetNumberOfTuples(); ++i)
+    {
+    for (int j = 0; j < a->GetNumberOfComponents(); ++j)
+      {
+      if (std::fabs(a->GetComponent(i, j) - b->GetComponent(i, j)) >
+          tolerance)
+        {
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+bool SameCells(vtkCellArray *a, vtkCellArray *b)
+{
+  if (a->GetNumberOfConnectivityEntries() !=
+      b->GetNumberOfConnectivityEntries())
+    {
+    return false;
+    }
+  for (vtkIdType i = 0; i < a->GetNumberOfConnectivityEntries(); ++i)
+    {
+    if (a->GetPointer()[i] != b->GetPointer()[i])
+      {
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int TestGlyph3DSMP(int, char *[])
+{
+  // Points on a grid, with scalars, vectors along all directions and along
+  // -x, and point data to copy.
+  const int n = 40;
+  vtkNew<vtkPolyData> input;
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkFloatArray> scalars;
+  vtkNew<vtkFloatArray> vectors;
+  vtkNew<vtkIdTypeArray> labels;
+  scalars->SetName("Scalars");
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(3);
+  labels->SetName("Labels");
+  for (int i = 0; i < n * n; ++i)
+    {
+    double x = i % n, y = i / n;
+    points->InsertNextPoint(x, y, 0.1 * x * y);
+    scalars->InsertNextValue(0.5 + 0.01 * (i % 50));
+    if (i % 9 == 0)
+      {
+      vectors->InsertNextTuple3(-2.0, 0.0, 0.0);
+      }
+    else
+      {
+      vectors->InsertNextTuple3(std::sin(0.1 * i), std::cos(0.2 * i), 0.5);
+      }
+    labels->InsertNextValue(7 * i);
+    }
+  input->SetPoints(points.GetPointer());
+  input->GetPointData()->SetScalars(scalars.GetPointer());
+  input->GetPointData()->SetVectors(vectors.GetPointer());
+  input->GetPointData()->AddArray(labels.GetPointer());
+  vtkIdType numPts = input->GetNumberOfPoints();
+
+  vtkNew<vtkConeSource> cone;
+  cone->SetResolution(8);
+  cone->Update();
+  vtkPolyData *source = cone->GetOutput();
+  vtkIdType numSourcePts = source->GetNumberOfPoints();
+  vtkIdType numSourceCells = source->GetNumberOfCells();
+
+  vtkNew<vtkGlyph3D> glyph;
+  glyph->SetInputData(input.GetPointer());
+  glyph->SetSourceData(source);
+  glyph->SetScaleModeToScaleByVector();
+  glyph->SetScaleFactor(0.3);
+  glyph->GeneratePointIdsOn();
+  glyph->FillCellDataOn();
+  glyph->Update();
+  vtkPolyData *output = glyph->GetOutput();
+
+  CHECK(output->GetNumberOfPoints() == numPts * numSourcePts);
+  CHECK(output->GetNumberOfCells() == numPts * numSourceCells);
+  vtkIdTypeArray *pointIds = vtkIdTypeArray::SafeDownCast(
+    output->GetPointData()->GetArray("InputPointIds"));
+  vtkIdTypeArray *outLabels = vtkIdTypeArray::SafeDownCast(
+    output->GetPointData()->GetArray("Labels"));
+  vtkIdTypeArray *cellLabels = vtkIdTypeArray::SafeDownCast(
+    output->GetCellData()->GetArray("Labels"));
+  vtkDataArray *outVectors = output->GetPointData()->GetVectors();
+  CHECK(pointIds && outLabels && cellLabels && outVectors);
+  CHECK(cellLabels->GetNumberOfTuples() == output->GetNumberOfCells());
+
+  // Each glyph is the source transformed as vtkGlyph3D used to, with a
+  // vtkTransform.
+  vtkNew<vtkTransform> transform;
+  vtkNew<vtkPoints> expected;
+  double x[3], v[3];
+  for (vtkIdType ptId = 0; ptId < numPts; ptId += 37)
+    {
+    input->GetPoint(ptId, x);
+    vectors->GetTuple(ptId, v);
+    double vMag = vtkMath::Norm(v);
+    transform->Identity();
+    transform->Translate(x);
+    if (v[1] == 0.0 && v[2] == 0.0)
+      {
+      transform->RotateWXYZ(180.0, 0, 1, 0);
+      }
+    else
+      {
+      transform->RotateWXYZ(180.0, (v[0] + vMag) / 2.0, v[1] / 2.0,
+                            v[2] / 2.0);
+      }
+    transform->Scale(0.3 * vMag, 0.3 * vMag, 0.3 * vMag);
+    expected->Reset();
+    transform->TransformPoints(source->GetPoints(), expected.GetPointer());
+    for (vtkIdType i = 0; i < numSourcePts; ++i)
+      {
+      vtkIdType outId = ptId * numSourcePts + i;
+      double y[3], z[3];
+      output->GetPoint(outId, y);
+      expected->GetPoint(i, z);
+      CHECK(vtkMath::Distance2BetweenPoints(y, z) < 1e-10);
+      CHECK(pointIds->GetValue(outId) == ptId);
+      CHECK(outLabels->GetValue(outId) == 7 * ptId);
+      CHECK(outVectors->GetComponent(outId, 1) == vectors->GetComponent(ptId, 1));
+      }
+    for (vtkIdType i = 0; i < numSourceCells; ++i)
+      {
+      CHECK(cellLabels->GetValue(ptId * numSourceCells + i) == 7 * ptId);
+      }
+    }
+
+  // Sources with double points give the same glyphs.
+  vtkNew<vtkConeSource> doubleCone;
+  doubleCone->SetResolution(8);
+  doubleCone->SetOutputPointsPrecision(vtkAlgorithm::DOUBLE_PRECISION);
+  doubleCone->Update();
+  vtkNew<vtkGlyph3D> doubleGlyph;
+  doubleGlyph->SetInputData(input.GetPointer());
+  doubleGlyph->SetSourceData(doubleCone->GetOutput());
+  doubleGlyph->SetScaleModeToScaleByVector();
+  doubleGlyph->SetScaleFactor(0.3);
+  doubleGlyph->Update();
+  CHECK(SameTuples(doubleGlyph->GetOutput()->GetPoints()->GetData(),
+                   output->GetPoints()->GetData(), 1e-5));
+  CHECK(SameCells(doubleGlyph->GetOutput()->GetPolys(), output->GetPolys()));
+
+  // Bit arrays are copied serially, with the same output.
+  vtkNew<vtkBitArray> bits;
+  bits->SetName("Bits");
+  bits->SetNumberOfTuples(numPts);
+  for (vtkIdType i = 0; i < numPts; ++i)
+    {
+    bits->SetValue(i, i % 3 == 0);
+    }
+  input->GetPointData()->AddArray(bits.GetPointer());
+  vtkNew<vtkGlyph3D> serialGlyph;
+  serialGlyph->SetInputData(input.GetPointer());
+  serialGlyph->SetSourceData(source);
+  serialGlyph->SetScaleModeToScaleByVector();
+  serialGlyph->SetScaleFactor(0.3);
+  serialGlyph->GeneratePointIdsOn();
+  serialGlyph->FillCellDataOn();
+  serialGlyph->Update();
+  vtkPolyData *serialOutput = serialGlyph->GetOutput();
+  CHECK(SameTuples(serialOutput->GetPoints()->GetData(),
+                   output->GetPoints()->GetData(), 0.0));
+  CHECK(SameCells(serialOutput->GetPolys(), output->GetPolys()));
+  CHECK(SameTuples(serialOutput->GetPointData()->GetVectors(),
+                   outVectors, 0.0));
+  CHECK(SameTuples(serialOutput->GetPointData()->GetArray("Labels"),
+                   outLabels, 0.0));
+  CHECK(SameTuples(serialOutput->GetCellData()->GetArray("Labels"),
+                   cellLabels, 0.0));
+  vtkBitArray *outBits = vtkBitArray::SafeDownCast(
+    serialOutput->GetPointData()->GetArray("Bits"));
+  CHECK(outBits && outBits->GetValue(3 * numSourcePts) == 1 &&
+        outBits->GetValue(4 * numSourcePts + 1) == 0);
+  input->GetPointData()->RemoveArray("Bits");
+
+  // Duplicate ghost points are not glyphed. Without source, glyphs are
+  // lines.
+  vtkNew<vtkUnsignedCharArray> ghosts;
+  ghosts->SetName(vtkDataSetAttributes::GhostArrayName());
+  ghosts->SetNumberOfTuples(numPts);
+  for (vtkIdType i = 0; i < numPts; ++i)
+    {
+    ghosts->SetValue(i, i < n ? vtkDataSetAttributes::DUPLICATEPOINT : 0);
+    }
+  input->GetPointData()->AddArray(ghosts.GetPointer());
+  vtkNew<vtkGlyph3D> lineGlyph;
+  lineGlyph->SetInputData(input.GetPointer());
+  lineGlyph->SetScaleModeToDataScalingOff();
+  lineGlyph->Update();
+  CHECK(lineGlyph->GetOutput()->GetNumberOfPoints() == 2 * (numPts - n));
+  CHECK(lineGlyph->GetOutput()->GetNumberOfLines() == numPts - n);
+  lineGlyph->GetOutput()->GetPoint(0, x);
+  CHECK(x[0] == 0.0 && x[1] == 1.0);
+
+  return EXIT_SUCCESS;
+}
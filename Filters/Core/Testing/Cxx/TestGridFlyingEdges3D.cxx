@@ -0,0 +1,348 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestGridFlyingEdges3D.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Contours an image with vtkFlyingEdges3D and the same samples as a
+// rectilinear and a structured grid with vtkGridFlyingEdges3D, and checks
+// that the isosurfaces match. Linear fields on non-uniform rectilinear and
+// warped structured grids must be contoured exactly, gradients included,
+// and blanked cells must produce no triangles.
+
+#include "vtkCellArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkFlyingEdges3D.h"
+#include "vtkGridFlyingEdges3D.h"
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkRectilinearGrid.h"
+#include "vtkStructuredGrid.h"
+
+#include <cmath>
+
+#define CHECK(cond)                                                    \
+  do                                                                   \
+    {                                                                  \
+    if (!(cond))                                                       \
+      {                                                                \
+      cerr << "Line " << __LINE__ << ": check failed: " #cond << endl; \
+      return EXIT_FAILURE;                                             \
+      }                                                                \
+    }                                                                  \
+  while (0)
+
+namespace
+{
+const int Dims[3] = { 30, 25, 20 };
+
+double Sphere(const double x[3])
+{
+  return x[0] * x[0] + 0.5 * x[1] * x[1] + x[2] * x[2];
+}
+
+double Linear(const double x[3])
+{
+  return 0.5 * x[0] + 0.25 * x[1] - x[2];
+}
+
+// Sample a field at the points of a dataset into its point scalars.
+void Sample(vtkDataSet *dataSet, double (*field)(const double *))
+{
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("Field");
+  scalars->SetNumberOfTuples(dataSet->GetNumberOfPoints());
+  double x[3];
+  for (vtkIdType i = 0; i < dataSet->GetNumberOfPoints(); ++i)
+    {
+    dataSet->GetPoint(i, x);
+    scalars->SetValue(i, field(x));
+    }
+  dataSet->GetPointData()->SetScalars(scalars.GetPointer());
+}
+
+void InitializeGrid(vtkRectilinearGrid *grid, const double origin[3],
+                    const double spacing[3], double stretch)
+{
+  grid->SetDimensions(Dims[0], Dims[1], Dims[2]);
+  vtkNew<vtkDoubleArray> coordinates[3];
+  for (int i = 0; i < 3; ++i)
+    {
+    for (int j = 0; j < Dims[i]; ++j)
+      {
+      coordinates[i]->InsertNextValue(
+        origin[i] + j * spacing[i] + stretch * j * j);
+      }
+    }
+  grid->SetXCoordinates(coordinates[0].GetPointer());
+  grid->SetYCoordinates(coordinates[1].GetPointer());
+  grid->SetZCoordinates(coordinates[2].GetPointer());
+}
+
+void InitializeGrid(vtkStructuredGrid *grid, vtkRectilinearGrid *source,
+                    double warp)
+{
+  grid->SetDimensions(Dims[0], Dims[1], Dims[2]);
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  for (int k = 0; k < Dims[2]; ++k)
+    {
+    for (int j = 0; j < Dims[1]; ++j)
+      {
+      for (int i = 0; i < Dims[0]; ++i)
+        {
+        double x[3];
+        x[0] = source->GetXCoordinates()->GetComponent(i, 0);
+        x[1] = source->GetYCoordinates()->GetComponent(j, 0);
+        x[2] = source->GetZCoordinates()->GetComponent(k, 0);
+        points->InsertNextPoint(x[0] + warp * std::sin(0.7 * j),
+                                x[1] + warp * (std::cos(0.5 * k) + 0.5 * i),
+                                x[2] + warp * std::sin(0.3 * i));
+        }
+      }
+    }
+  grid->SetPoints(points.GetPointer());
+}
+
+// The isosurfaces have the same triangles, and points, normals and
+// gradients within tol.
+int CheckSame(vtkPolyData *expected, vtkPolyData *output, double tol)
+{
+  CHECK(output->GetNumberOfPolys() > 0);
+  CHECK(output->GetNumberOfPoints() == expected->GetNumberOfPoints());
+  CHECK(output->GetNumberOfPolys() == expected->GetNumberOfPolys());
+  vtkIdTypeArray *tris = output->GetPolys()->GetData();
+  vtkIdTypeArray *expectedTris = expected->GetPolys()->GetData();
+  for (vtkIdType i = 0; i < tris->GetNumberOfTuples(); ++i)
+    {
+    CHECK(tris->GetValue(i) == expectedTris->GetValue(i));
+    }
+  const char *names[2] = { "Normals", "Gradients" };
+  vtkDataArray *arrays[3] = { output->GetPoints()->GetData(),
+    output->GetPointData()->GetArray(names[0]),
+    output->GetPointData()->GetArray(names[1]) };
+  vtkDataArray *expectedArrays[3] = { expected->GetPoints()->GetData(),
+    expected->GetPointData()->GetArray(names[0]),
+    expected->GetPointData()->GetArray(names[1]) };
+  for (int a = 0; a < 3; ++a)
+    {
+    CHECK(arrays[a] && expectedArrays[a]);
+    for (vtkIdType i = 0; i < output->GetNumberOfPoints(); ++i)
+      {
+      for (int c = 0; c < 3; ++c)
+        {
+        double value = expectedArrays[a]->GetComponent(i, c);
+        CHECK(std::fabs(arrays[a]->GetComponent(i, c) - value) <=
+              tol * (1.0 + std::fabs(value)));
+        }
+      }
+    }
+  return EXIT_SUCCESS;
+}
+
+// Every point of the isosurface of the linear field at value lies on the
+// plane, with the gradient of the field. The triangles use these points.
+int CheckLinear(vtkPolyData *output, double value)
+{
+  CHECK(output->GetNumberOfPolys() > 0);
+  vtkDataArray *gradients = output->GetPointData()->GetArray("Gradients");
+  vtkDataArray *normals = output->GetPointData()->GetNormals();
+  vtkDataArray *scalars = output->GetPointData()->GetScalars();
+  CHECK(gradients && normals && scalars);
+  double x[3], g[3], n[3];
+  for (vtkIdType i = 0; i < output->GetNumberOfPoints(); ++i)
+    {
+    output->GetPoint(i, x);
+    CHECK(std::fabs(Linear(x) - value) < 1e-4);
+    CHECK(scalars->GetTuple1(i) == value);
+    gradients->GetTuple(i, g);
+    CHECK(std::fabs(g[0] - 0.5) < 1e-5 && std::fabs(g[1] - 0.25) < 1e-5 &&
+          std::fabs(g[2] + 1.0) < 1e-5);
+    normals->GetTuple(i, n);
+    CHECK(std::fabs(n[2] - 1.0 / std::sqrt(1.3125)) < 1e-5);
+    }
+  vtkIdType npts, *pts;
+  vtkCellArray *polys = output->GetPolys();
+  for (polys->InitTraversal(); polys->GetNextCell(npts, pts);)
+    {
+    CHECK(npts == 3);
+    for (int j = 0; j < 3; ++j)
+      {
+      CHECK(pts[j] >= 0 && pts[j] < output->GetNumberOfPoints());
+      }
+    }
+  return EXIT_SUCCESS;
+}
+
+int TestImageEquivalence()
+{
+  const double origin[3] = { -7.0, -9.0, -6.0 };
+  const double spacing[3] = { 0.5, 0.75, 0.625 };
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(Dims[0], Dims[1], Dims[2]);
+  image->SetOrigin(origin[0], origin[1], origin[2]);
+  image->SetSpacing(spacing[0], spacing[1], spacing[2]);
+  Sample(image.GetPointer(), Sphere);
+  vtkNew<vtkRectilinearGrid> rGrid;
+  InitializeGrid(rGrid.GetPointer(), origin, spacing, 0.0);
+  Sample(rGrid.GetPointer(), Sphere);
+  vtkNew<vtkStructuredGrid> sGrid;
+  InitializeGrid(sGrid.GetPointer(), rGrid.GetPointer(), 0.0);
+  Sample(sGrid.GetPointer(), Sphere);
+
+  vtkNew<vtkFlyingEdges3D> flyingEdges;
+  flyingEdges->SetInputData(image.GetPointer());
+  flyingEdges->SetValue(0, 20.0);
+  flyingEdges->SetValue(1, 35.0);
+  flyingEdges->ComputeGradientsOn();
+  flyingEdges->Update();
+
+  vtkNew<vtkGridFlyingEdges3D> gridFlyingEdges;
+  gridFlyingEdges->SetInputData(rGrid.GetPointer());
+  gridFlyingEdges->SetValue(0, 20.0);
+  gridFlyingEdges->SetValue(1, 35.0);
+  gridFlyingEdges->ComputeGradientsOn();
+  gridFlyingEdges->Update();
+  CHECK(CheckSame(flyingEdges->GetOutput(), gridFlyingEdges->GetOutput(),
+                  1e-5) == EXIT_SUCCESS);
+
+  gridFlyingEdges->SetInputData(sGrid.GetPointer());
+  gridFlyingEdges->Update();
+  CHECK(CheckSame(flyingEdges->GetOutput(), gridFlyingEdges->GetOutput(),
+                  1e-5) == EXIT_SUCCESS);
+  return EXIT_SUCCESS;
+}
+
+int TestLinearField()
+{
+  // Non-uniform rectilinear coordinates, and the same points warped.
+  const double origin[3] = { -3.0, -2.0, -4.0 };
+  const double spacing[3] = { 0.3, 0.4, 0.35 };
+  vtkNew<vtkRectilinearGrid> rGrid;
+  InitializeGrid(rGrid.GetPointer(), origin, spacing, 0.01);
+  Sample(rGrid.GetPointer(), Linear);
+  vtkNew<vtkStructuredGrid> sGrid;
+  InitializeGrid(sGrid.GetPointer(), rGrid.GetPointer(), 0.1);
+  Sample(sGrid.GetPointer(), Linear);
+
+  vtkNew<vtkGridFlyingEdges3D> gridFlyingEdges;
+  gridFlyingEdges->SetInputData(rGrid.GetPointer());
+  gridFlyingEdges->SetValue(0, 0.5);
+  gridFlyingEdges->ComputeGradientsOn();
+  gridFlyingEdges->Update();
+  CHECK(CheckLinear(gridFlyingEdges->GetOutput(), 0.5) == EXIT_SUCCESS);
+
+  gridFlyingEdges->SetInputData(sGrid.GetPointer());
+  gridFlyingEdges->Update();
+  CHECK(CheckLinear(gridFlyingEdges->GetOutput(), 0.5) == EXIT_SUCCESS);
+  vtkIdType numTris = gridFlyingEdges->GetOutput()->GetNumberOfPolys();
+
+  // Float points are used in place.
+  vtkNew<vtkPoints> floatPoints;
+  floatPoints->SetDataTypeToFloat();
+  floatPoints->DeepCopy(sGrid->GetPoints());
+  sGrid->SetPoints(floatPoints.GetPointer());
+  Sample(sGrid.GetPointer(), Linear);
+  gridFlyingEdges->Update();
+  CHECK(CheckLinear(gridFlyingEdges->GetOutput(), 0.5) == EXIT_SUCCESS);
+
+  // Contour the second component of two.
+  vtkNew<vtkDoubleArray> components;
+  components->SetNumberOfComponents(2);
+  components->SetNumberOfTuples(sGrid->GetNumberOfPoints());
+  vtkDataArray *scalars = sGrid->GetPointData()->GetScalars();
+  for (vtkIdType i = 0; i < sGrid->GetNumberOfPoints(); ++i)
+    {
+    components->SetComponent(i, 0, (i % 2) ? 100.0 : -100.0);
+    components->SetComponent(i, 1, scalars->GetTuple1(i));
+    }
+  sGrid->GetPointData()->SetScalars(components.GetPointer());
+  gridFlyingEdges->SetArrayComponent(1);
+  gridFlyingEdges->ComputeScalarsOff();
+  gridFlyingEdges->Update();
+  CHECK(gridFlyingEdges->GetOutput()->GetNumberOfPolys() == numTris);
+  return EXIT_SUCCESS;
+}
+
+int TestBlanking()
+{
+  const double origin[3] = { -7.0, -9.0, -6.0 };
+  const double spacing[3] = { 0.5, 0.75, 0.625 };
+  vtkNew<vtkRectilinearGrid> rGrid;
+  InitializeGrid(rGrid.GetPointer(), origin, spacing, 0.0);
+  vtkNew<vtkStructuredGrid> sGrid;
+  InitializeGrid(sGrid.GetPointer(), rGrid.GetPointer(), 0.1);
+  Sample(sGrid.GetPointer(), Sphere);
+
+  vtkNew<vtkGridFlyingEdges3D> gridFlyingEdges;
+  gridFlyingEdges->SetInputData(sGrid.GetPointer());
+  gridFlyingEdges->SetValue(0, 20.0);
+  gridFlyingEdges->Update();
+  vtkIdType numTris = gridFlyingEdges->GetOutput()->GetNumberOfPolys();
+
+  // Blanking either half of the cells splits the triangles in two.
+  vtkNew<vtkStructuredGrid> lower, upper;
+  lower->DeepCopy(sGrid.GetPointer());
+  upper->DeepCopy(sGrid.GetPointer());
+  vtkIdType half = (Dims[0] - 1) / 2;
+  for (vtkIdType i = 0; i < sGrid->GetNumberOfCells(); ++i)
+    {
+    if (i % (Dims[0] - 1) < half)
+      {
+      lower->BlankCell(i);
+      }
+    else
+      {
+      upper->BlankCell(i);
+      }
+    }
+  gridFlyingEdges->SetInputData(lower.GetPointer());
+  gridFlyingEdges->Update();
+  vtkIdType numLower = gridFlyingEdges->GetOutput()->GetNumberOfPolys();
+  gridFlyingEdges->SetInputData(upper.GetPointer());
+  gridFlyingEdges->Update();
+  vtkIdType numUpper = gridFlyingEdges->GetOutput()->GetNumberOfPolys();
+  CHECK(numLower > 0 && numUpper > 0);
+  CHECK(numLower + numUpper == numTris);
+
+  // Blanking a point on the isosurface removes the triangles of its cells.
+  double x[3] = { 0.0, 0.0, 0.0 };
+  vtkIdType pointId = -1;
+  for (vtkIdType i = 0; i < sGrid->GetNumberOfPoints() && pointId < 0; ++i)
+    {
+    sGrid->GetPoint(i, x);
+    if (i % Dims[0] > 2 && i % Dims[0] < Dims[0] - 3 &&
+        std::fabs(Sphere(x) - 20.0) < 1.0)
+      {
+      pointId = i;
+      }
+    }
+  CHECK(pointId >= 0);
+  sGrid->BlankPoint(pointId);
+  gridFlyingEdges->SetInputData(sGrid.GetPointer());
+  gridFlyingEdges->Update();
+  CHECK(gridFlyingEdges->GetOutput()->GetNumberOfPolys() < numTris);
+  return EXIT_SUCCESS;
+}
+}
+
+int TestGridFlyingEdges3D(int, char *[])
+{
+  CHECK(TestImageEquivalence() == EXIT_SUCCESS);
+  CHECK(TestLinearField() == EXIT_SUCCESS);
+  CHECK(TestBlanking() == EXIT_SUCCESS);
+
+  return EXIT_SUCCESS;
+}
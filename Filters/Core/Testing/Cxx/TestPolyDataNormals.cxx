@@ -0,0 +1,173 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPolyDataNormals.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks the consistent ordering of polygons, in several regions, the
+// splitting of sharp edges and the point normals of vtkPolyDataNormals.
+
+#include "vtkAppendPolyData.h"
+#include "vtkCellArray.h"
+#include "vtkCleanPolyData.h"
+#include "vtkCubeSource.h"
+#include "vtkDataArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataNormals.h"
+#include "vtkSphereSource.h"
+#include "vtkTriangleFilter.h"
+
+#include <cmath>
+
+#define CHECK(cond)                                                    \
+  do                                                                   \
+    {                                                                  \
+    if (!(cond))                                                       \
+      {                                                                \
+      cerr << "Line " << __LINE__ << ": check failed: " #cond << endl; \
+      return EXIT_FAILURE;                                             \
+      }                                                                \
+    }                                                                  \
+  while (0)
+
+int TestPolyDataNormals(int, char *[])
+{
+  // Two spheres, the polygons of the second one numbered after the first.
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(80);
+  sphere->SetPhiResolution(60);
+  vtkNew<vtkSphereSource> sphere2;
+  sphere2->SetCenter(3.0, 0.0, 0.0);
+  sphere2->SetThetaResolution(30);
+  vtkNew<vtkAppendPolyData> append;
+  append->AddInputConnection(sphere->GetOutputPort());
+  append->AddInputConnection(sphere2->GetOutputPort());
+  append->Update();
+  vtkPolyData *spheres = append->GetOutput();
+  sphere->Update();
+  vtkIdType firstOfSecond = sphere->GetOutput()->GetNumberOfPolys();
+
+  // Reverse polygons, but not the first of each sphere from which the
+  // ordering starts.
+  vtkNew<vtkPolyData> reversed;
+  reversed->DeepCopy(spheres);
+  reversed->BuildCells();
+  vtkMath::RandomSeed(8775070);
+  for (vtkIdType cellId = 1; cellId < reversed->GetNumberOfPolys(); ++cellId)
+    {
+    if (cellId != firstOfSecond && vtkMath::Random() < 0.3)
+      {
+      reversed->ReverseCell(cellId);
+      }
+    }
+
+  vtkNew<vtkPolyDataNormals> normals;
+  normals->SetInputData(spheres);
+  normals->ComputeCellNormalsOn();
+  normals->Update();
+  vtkNew<vtkPolyData> expected;
+  expected->DeepCopy(normals->GetOutput());
+
+  // The ordering restores the polygons, and the normals are the same.
+  normals->SetInputData(reversed.GetPointer());
+  normals->Update();
+  vtkPolyData *output = normals->GetOutput();
+  CHECK(output->GetNumberOfPoints() == expected->GetNumberOfPoints());
+  vtkIdTypeArray *polys = output->GetPolys()->GetData();
+  vtkIdTypeArray *expectedPolys = expected->GetPolys()->GetData();
+  CHECK(polys->GetNumberOfTuples() == expectedPolys->GetNumberOfTuples());
+  for (vtkIdType i = 0; i < polys->GetNumberOfTuples(); ++i)
+    {
+    CHECK(polys->GetValue(i) == expectedPolys->GetValue(i));
+    }
+  vtkDataArray *pointNormals = output->GetPointData()->GetNormals();
+  vtkDataArray *expectedNormals = expected->GetPointData()->GetNormals();
+  for (vtkIdType i = 0; i < output->GetNumberOfPoints(); ++i)
+    {
+    for (int c = 0; c < 3; ++c)
+      {
+      CHECK(pointNormals->GetComponent(i, c) ==
+            expectedNormals->GetComponent(i, c));
+      }
+    }
+
+  // The normals of a sphere point out of its center.
+  for (vtkIdType i = 0; i < output->GetNumberOfPoints(); ++i)
+    {
+    double x[3], n[3];
+    output->GetPoint(i, x);
+    pointNormals->GetTuple(i, n);
+    if (x[0] > 1.5)
+      {
+      x[0] -= 3.0;
+      }
+    CHECK(vtkMath::Dot(x, n) > 0.0);
+    }
+
+  // Flipping reverses all the normals.
+  normals->FlipNormalsOn();
+  normals->Update();
+  pointNormals = output->GetPointData()->GetNormals();
+  for (vtkIdType i = 0; i < output->GetNumberOfPoints(); ++i)
+    {
+    for (int c = 0; c < 3; ++c)
+      {
+      CHECK(pointNormals->GetComponent(i, c) ==
+            -expectedNormals->GetComponent(i, c));
+      }
+    }
+
+  // A cube with shared corners is split along its edges, each corner into
+  // one point per face.
+  vtkNew<vtkCubeSource> cube;
+  vtkNew<vtkCleanPolyData> clean;
+  clean->SetInputConnection(cube->GetOutputPort());
+  vtkNew<vtkTriangleFilter> triangles;
+  triangles->SetInputConnection(clean->GetOutputPort());
+  vtkNew<vtkPolyDataNormals> cubeNormals;
+  cubeNormals->SetInputConnection(triangles->GetOutputPort());
+  cubeNormals->Update();
+  output = cubeNormals->GetOutput();
+  CHECK(output->GetNumberOfPoints() == 24);
+  pointNormals = output->GetPointData()->GetNormals();
+  for (vtkIdType i = 0; i < output->GetNumberOfPoints(); ++i)
+    {
+    double x[3], n[3];
+    output->GetPoint(i, x);
+    pointNormals->GetTuple(i, n);
+    int axis = fabs(n[0]) > 0.5 ? 0 : (fabs(n[1]) > 0.5 ? 1 : 2);
+    CHECK(fabs(fabs(n[axis]) - 1.0) < 1e-6);
+    CHECK(n[axis] * x[axis] > 0.0);
+    }
+
+  // Without splitting, the corners keep one normal along the diagonal.
+  cubeNormals->SplittingOff();
+  cubeNormals->Update();
+  output = cubeNormals->GetOutput();
+  CHECK(output->GetNumberOfPoints() == 8);
+  pointNormals = output->GetPointData()->GetNormals();
+  for (vtkIdType i = 0; i < output->GetNumberOfPoints(); ++i)
+    {
+    double x[3], n[3];
+    output->GetPoint(i, x);
+    pointNormals->GetTuple(i, n);
+    for (int c = 0; c < 3; ++c)
+      {
+      CHECK(n[c] * x[c] > 0.0);
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
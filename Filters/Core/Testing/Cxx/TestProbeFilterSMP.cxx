@@ -0,0 +1,198 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestProbeFilterSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Probes a linear field on image data and on its tetrahedra with points in
+// and out of the source, and checks the values, masks and valid points
+// vtkProbeFilter computes in parallel, and that the serial path used for
+// bit arrays gives the same output.
+
+#include "vtkBitArray.h"
+#include "vtkCell.h"
+#include "vtkCellData.h"
+#include "vtkCharArray.h"
+#include "vtkDataSetTriangleFilter.h"
+#include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPointSource.h"
+#include "vtkPolyData.h"
+#include "vtkProbeFilter.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cmath>
+
+#define CHECK(cond)                                                    \
+  do                                                                   \
+    {                                                                  \
+    if (!(cond))                                                       \
+      {                                                                \
+      cerr << "Line " << __LINE__ << ": check failed: " #cond << endl; \
+      return EXIT_FAILURE;                                             \
+      }                                                                \
+    }                                                                  \
+  while (0)
+
+namespace
+{
+double Field(const double x[3])
+{
+  return x[0] + 2.0 * x[1] - 3.0 * x[2];
+}
+
+// Checks the output of probing points into source, whose bounds are
+// [-5,5] along each axis and whose "Field" point array is Field().
+int CheckProbe(vtkPolyData *points, vtkDataSet *source, vtkDataSet *output,
+               vtkIdTypeArray *validPoints)
+{
+  vtkFloatArray *field = vtkFloatArray::SafeDownCast(
+    output->GetPointData()->GetArray("Field"));
+  vtkIdTypeArray *cellIds = vtkIdTypeArray::SafeDownCast(
+    output->GetPointData()->GetArray("CellIds"));
+  vtkCharArray *mask = vtkCharArray::SafeDownCast(
+    output->GetPointData()->GetArray("vtkValidPointMask"));
+  vtkIdType numPts = points->GetNumberOfPoints();
+  CHECK(field && cellIds && mask);
+  CHECK(field->GetNumberOfTuples() == numPts);
+  CHECK(cellIds->GetNumberOfTuples() == numPts);
+  CHECK(mask->GetNumberOfTuples() == numPts);
+
+  vtkIdType numValid = 0;
+  double x[3], bounds[6];
+  for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+    {
+    points->GetPoint(ptId, x);
+    bool inside = true, outside = false;
+    for (int j = 0; j < 3; ++j)
+      {
+      inside = inside && std::fabs(x[j]) < 4.99;
+      outside = outside || std::fabs(x[j]) > 5.01;
+      }
+    if (mask->GetValue(ptId) == 1)
+      {
+      CHECK(!outside);
+      CHECK(validPoints->GetValue(numValid++) == ptId);
+      CHECK(!inside || std::fabs(field->GetValue(ptId) - Field(x)) < 1e-4);
+      // Cells are found within 1/10 of their size.
+      const double tol = 0.1;
+      source->GetCell(cellIds->GetValue(ptId))->GetBounds(bounds);
+      for (int j = 0; j < 3; ++j)
+        {
+        CHECK(x[j] > bounds[2 * j] - tol && x[j] < bounds[2 * j + 1] + tol);
+        }
+      }
+    else
+      {
+      CHECK(!inside);
+      CHECK(field->GetValue(ptId) == 0.0f && cellIds->GetValue(ptId) == 0);
+      }
+    }
+  CHECK(validPoints->GetNumberOfTuples() == numValid);
+  return EXIT_SUCCESS;
+}
+}
+
+int TestProbeFilterSMP(int, char *[])
+{
+  // A linear field on a grid, with the ids of its cells.
+  vtkNew<vtkImageData> image;
+  image->SetOrigin(-5.0, -5.0, -5.0);
+  image->SetSpacing(0.5, 0.5, 0.5);
+  image->SetDimensions(21, 21, 21);
+  vtkNew<vtkFloatArray> field;
+  field->SetName("Field");
+  field->SetNumberOfTuples(image->GetNumberOfPoints());
+  double x[3];
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+    {
+    image->GetPoint(i, x);
+    field->SetValue(i, Field(x));
+    }
+  image->GetPointData()->SetScalars(field.GetPointer());
+  vtkNew<vtkIdTypeArray> cellIds;
+  cellIds->SetName("CellIds");
+  cellIds->SetNumberOfTuples(image->GetNumberOfCells());
+  for (vtkIdType i = 0; i < image->GetNumberOfCells(); ++i)
+    {
+    cellIds->SetValue(i, i);
+    }
+  image->GetCellData()->AddArray(cellIds.GetPointer());
+
+  vtkNew<vtkDataSetTriangleFilter> tetrahedra;
+  tetrahedra->SetInputData(image.GetPointer());
+  tetrahedra->Update();
+  vtkUnstructuredGrid *grid = tetrahedra->GetOutput();
+  vtkIdTypeArray *gridCellIds = vtkIdTypeArray::SafeDownCast(
+    grid->GetCellData()->GetArray("CellIds"));
+  CHECK(gridCellIds);
+  for (vtkIdType i = 0; i < grid->GetNumberOfCells(); ++i)
+    {
+    gridCellIds->SetValue(i, i);
+    }
+
+  // Points in and around the grid.
+  vtkNew<vtkPointSource> cloud;
+  cloud->SetNumberOfPoints(20000);
+  cloud->SetRadius(8.0);
+  cloud->Update();
+  vtkPolyData *points = cloud->GetOutput();
+
+  vtkNew<vtkProbeFilter> probe;
+  probe->SetInputData(points);
+  probe->SetSourceData(image.GetPointer());
+  probe->Update();
+  CHECK(probe->GetValidPoints()->GetNumberOfTuples() > 0);
+  CHECK(CheckProbe(points, image.GetPointer(), probe->GetOutput(),
+                   probe->GetValidPoints()) == EXIT_SUCCESS);
+
+  vtkNew<vtkProbeFilter> gridProbe;
+  gridProbe->SetInputData(points);
+  gridProbe->SetSourceData(grid);
+  gridProbe->Update();
+  CHECK(CheckProbe(points, grid, gridProbe->GetOutput(),
+                   gridProbe->GetValidPoints()) == EXIT_SUCCESS);
+
+  // Bit arrays are interpolated serially, with the same output.
+  vtkNew<vtkBitArray> bits;
+  bits->SetName("Bits");
+  bits->SetNumberOfTuples(grid->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < grid->GetNumberOfPoints(); ++i)
+    {
+    bits->SetValue(i, 1);
+    }
+  grid->GetPointData()->AddArray(bits.GetPointer());
+  vtkNew<vtkProbeFilter> serialProbe;
+  serialProbe->SetInputData(points);
+  serialProbe->SetSourceData(grid);
+  serialProbe->Update();
+  CHECK(CheckProbe(points, grid, serialProbe->GetOutput(),
+                   serialProbe->GetValidPoints()) == EXIT_SUCCESS);
+  vtkBitArray *outBits = vtkBitArray::SafeDownCast(
+    serialProbe->GetOutput()->GetPointData()->GetArray("Bits"));
+  vtkDataArray *mask =
+    serialProbe->GetOutput()->GetPointData()->GetArray("vtkValidPointMask");
+  CHECK(outBits && outBits->GetNumberOfTuples() == points->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < points->GetNumberOfPoints(); ++i)
+    {
+    CHECK(outBits->GetValue(i) == mask->GetComponent(i, 0));
+    CHECK(serialProbe->GetOutput()->GetPointData()->GetArray("Field")->
+          GetComponent(i, 0) ==
+          gridProbe->GetOutput()->GetPointData()->GetArray("Field")->
+          GetComponent(i, 0));
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -25,6 +25,9 @@
 #include "vtkImageData.h"
 #include "vtkThreadedCompositeDataPipeline.h"
 #include "vtkSynchronizedTemplates3D.h"
+#include "vtkCompositeCutter.h"
+#include "vtkCutter.h"
+#include "vtkPlane.h"
 #include "vtkSmartPointer.h"
 
 const int EXTENT = 100;
@@ -142,6 +145,35 @@ int TestSMPPipelineContour(int, char *[])
     }
 
 
+  // The composite cutter cuts the blocks in parallel; the pieces share no
+  // cells, so the cut has as many cells as the cut of the whole image.
+  vtkNew<vtkPlane> plane;
+  plane->SetOrigin(0.5, 0.5, 0.5);
+  plane->SetNormal(1.0, 1.0, 1.0);
+
+  vtkNew<vtkCompositeCutter> compositeCutter;
+  compositeCutter->SetCutFunction(plane.GetPointer());
+  compositeCutter->SetInputData(mbds.GetPointer());
+  tl->StartTimer();
+  compositeCutter->Update();
+  tl->StopTimer();
+
+  cout << "Composite cut time: " << tl->GetElapsedTime() << endl;
+
+  vtkNew<vtkCutter> cutter;
+  cutter->SetCutFunction(plane.GetPointer());
+  cutter->SetInputData(rt->GetOutput());
+  cutter->Update();
+
+  if (compositeCutter->GetOutput()->GetNumberOfCells() !=
+      cutter->GetOutput()->GetNumberOfCells())
+    {
+    cout << "Number of cut cells did not match: "
+         << compositeCutter->GetOutput()->GetNumberOfCells() << " and "
+         << cutter->GetOutput()->GetNumberOfCells() << endl;
+    return EXIT_FAILURE;
+    }
+
 #if 0
   vtkNew<vtkXMLMultiBlockDataWriter> writer;
   writer->SetInputData(cf->GetOutputDataObject(0));
@@ -0,0 +1,217 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestThresholdSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that vtkThreshold extracts the same cells, points and attributes
+// in parallel as with its serial algorithm, which it uses when the input
+// has bit arrays.
+
+#include "vtkBitArray.h"
+#include "vtkCellData.h"
+#include "vtkDataSetAttributes.h"
+#include "vtkDataObject.h"
+#include "vtkElevationFilter.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPointDataToCellData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkRTAnalyticSource.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkThreshold.h"
+#include "vtkUnstructuredGrid.h"
+
+#define CHECK(cond)                                                    \
+  do                                                                   \
+    {                                                                  \
+    if (!(cond))                                                       \
+      {                                                                \
+      cerr << "Line " << __LINE__ << ": check failed: " #cond << endl; \
+      return false;                                                    \
+      }                                                                \
+    }                                                                  \
+  while (0)
+
+namespace
+{
+// Whether a and b have the same tuples in the arrays of a. The arrays of
+// b may be followed by others.
+bool SameAttributes(vtkDataSetAttributes *a, vtkDataSetAttributes *b)
+{
+  for (int i = 0; i < a->GetNumberOfArrays(); ++i)
+    {
+    vtkDataArray *arrayA = a->GetArray(i);
+    vtkDataArray *arrayB = b->GetArray(i);
+    CHECK(arrayB != NULL);
+    CHECK(arrayA->GetNumberOfTuples() == arrayB->GetNumberOfTuples());
+    for (vtkIdType j = 0; j < arrayA->GetNumberOfTuples(); ++j)
+      {
+      for (int c = 0; c < arrayA->GetNumberOfComponents(); ++c)
+        {
+        CHECK(arrayA->GetComponent(j, c) == arrayB->GetComponent(j, c));
+        }
+      }
+    }
+  return true;
+}
+
+bool SameGrids(vtkUnstructuredGrid *a, vtkUnstructuredGrid *b)
+{
+  CHECK(a->GetNumberOfCells() == b->GetNumberOfCells());
+  CHECK(a->GetNumberOfPoints() == b->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); ++i)
+    {
+    double x[3], y[3];
+    a->GetPoint(i, x);
+    b->GetPoint(i, y);
+    CHECK(x[0] == y[0] && x[1] == y[1] && x[2] == y[2]);
+    }
+  vtkNew<vtkIdList> ptsA;
+  vtkNew<vtkIdList> ptsB;
+  for (vtkIdType i = 0; i < a->GetNumberOfCells(); ++i)
+    {
+    CHECK(a->GetCellType(i) == b->GetCellType(i));
+    a->GetCellPoints(i, ptsA.GetPointer());
+    b->GetCellPoints(i, ptsB.GetPointer());
+    CHECK(ptsA->GetNumberOfIds() == ptsB->GetNumberOfIds());
+    for (vtkIdType j = 0; j < ptsA->GetNumberOfIds(); ++j)
+      {
+      CHECK(ptsA->GetId(j) == ptsB->GetId(j));
+      }
+    }
+  return SameAttributes(a->GetPointData(), b->GetPointData()) &&
+    SameAttributes(a->GetCellData(), b->GetCellData());
+}
+
+// Threshold input in parallel and serially, with point or cell scalars,
+// and compare the outputs. The input is a copy of dataSet with unnamed
+// point and cell arrays.
+bool TestInput(vtkDataSet *dataSet, const char *scalars, double lower,
+               double upper)
+{
+  vtkSmartPointer<vtkDataSet> input;
+  input.TakeReference(dataSet->NewInstance());
+  input->ShallowCopy(dataSet);
+  vtkNew<vtkIdTypeArray> pointIds;
+  vtkNew<vtkIdTypeArray> cellIds;
+  for (vtkIdType i = 0; i < input->GetNumberOfPoints(); ++i)
+    {
+    pointIds->InsertNextValue(i);
+    }
+  for (vtkIdType i = 0; i < input->GetNumberOfCells(); ++i)
+    {
+    cellIds->InsertNextValue(i);
+    }
+  input->GetPointData()->AddArray(pointIds.GetPointer());
+  input->GetCellData()->AddArray(cellIds.GetPointer());
+
+  vtkNew<vtkThreshold> parallel;
+  parallel->SetInputData(input);
+  parallel->ThresholdBetween(lower, upper);
+
+  vtkSmartPointer<vtkDataSet> serialInput;
+  serialInput.TakeReference(input->NewInstance());
+  serialInput->ShallowCopy(input);
+  vtkNew<vtkBitArray> bits;
+  bits->SetName("Bits");
+  bits->SetNumberOfTuples(input->GetNumberOfPoints());
+  serialInput->GetPointData()->AddArray(bits.GetPointer());
+  vtkNew<vtkThreshold> serial;
+  serial->SetInputData(serialInput);
+  serial->ThresholdBetween(lower, upper);
+
+  int associations[] = { vtkDataObject::FIELD_ASSOCIATION_POINTS,
+                         vtkDataObject::FIELD_ASSOCIATION_CELLS };
+  for (int i = 0; i < 2; ++i)
+    {
+    parallel->SetInputArrayToProcess(0, 0, 0, associations[i], scalars);
+    serial->SetInputArrayToProcess(0, 0, 0, associations[i], scalars);
+    for (int allScalars = 0; allScalars < 2; ++allScalars)
+      {
+      parallel->SetAllScalars(allScalars);
+      serial->SetAllScalars(allScalars);
+      parallel->Update();
+      serial->Update();
+      CHECK(parallel->GetOutput()->GetNumberOfCells() > 0);
+      CHECK(parallel->GetOutput()->GetNumberOfCells() <
+            input->GetNumberOfCells());
+      CHECK(serial->GetOutput()->GetPointData()->GetArray("Bits") != NULL);
+      if (!SameGrids(parallel->GetOutput(), serial->GetOutput()))
+        {
+        return false;
+        }
+      }
+    }
+
+  // Without compaction, the output has all the points of the input.
+  parallel->CompactPointsOff();
+  serial->CompactPointsOff();
+  parallel->Update();
+  serial->Update();
+  CHECK(parallel->GetOutput()->GetNumberOfPoints() ==
+        input->GetNumberOfPoints());
+  return SameGrids(parallel->GetOutput(), serial->GetOutput());
+}
+}
+
+int TestThresholdSMP(int, char *[])
+{
+  // Image data, with point and cell scalars.
+  vtkNew<vtkRTAnalyticSource> wavelet;
+  wavelet->SetWholeExtent(-30, 30, -30, 30, -30, 30);
+  vtkNew<vtkPointDataToCellData> toCells;
+  toCells->SetInputConnection(wavelet->GetOutputPort());
+  toCells->PassPointDataOn();
+  toCells->Update();
+  if (!TestInput(toCells->GetOutput(), "RTData", 100.0, 200.0))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Polydata.
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(200);
+  sphere->SetPhiResolution(200);
+  vtkNew<vtkElevationFilter> elevation;
+  elevation->SetInputConnection(sphere->GetOutputPort());
+  elevation->SetLowPoint(0.0, 0.0, -0.5);
+  elevation->SetHighPoint(0.0, 0.0, 0.5);
+  vtkNew<vtkPointDataToCellData> sphereCells;
+  sphereCells->SetInputConnection(elevation->GetOutputPort());
+  sphereCells->PassPointDataOn();
+  sphereCells->Update();
+  if (!TestInput(sphereCells->GetOutput(), "Elevation", 0.25, 0.6))
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Unstructured grid made by a threshold.
+  vtkNew<vtkThreshold> all;
+  all->SetInputConnection(toCells->GetOutputPort());
+  all->SetInputArrayToProcess(0, 0, 0,
+    vtkDataObject::FIELD_ASSOCIATION_POINTS, "RTData");
+  all->ThresholdByUpper(-1.0e30);
+  all->Update();
+  if (all->GetOutput()->GetNumberOfCells() !=
+      toCells->GetOutput()->GetNumberOfCells() ||
+      !TestInput(all->GetOutput(), "RTData", 100.0, 200.0))
+    {
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
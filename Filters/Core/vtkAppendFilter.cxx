@@ -14,27 +14,347 @@
 =========================================================================*/
 #include "vtkAppendFilter.h"
 
-#include "vtkBoundingBox.h"
+#include "vtkArrayListTemplate.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCell.h"
 #include "vtkDataSetAttributes.h"
 #include "vtkDataSetCollection.h"
 #include "vtkExecutive.h"
-#include "vtkIncrementalOctreePointLocator.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
+#include "vtkStaticPointLocator.h"
+#include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+#include <algorithm>
 #include <set>
 #include <string>
+#include <vector>
 
 vtkStandardNewMacro(vtkAppendFilter);
 
+namespace
+{
+// A range of the points or cells of one input, and the output id of its
+// first element. Each piece is copied by a single thread.
+struct vtkAppendFilterPiece
+{
+  size_t Input;
+  vtkIdType Begin;
+  vtkIdType End;
+  vtkIdType Offset;
+};
+
+// Inputs are split into pieces of at most this many elements, so that a
+// few large inputs are spread across threads as well as many small ones.
+const vtkIdType vtkAppendFilterPieceSize = 65536;
+
+void vtkAppendFilterGetDataSets(vtkDataSetCollection *inputs,
+                                std::vector<vtkDataSet*> &dataSets)
+{
+  vtkCollectionSimpleIterator it;
+  inputs->InitTraversal(it);
+  while (vtkDataSet *dataSet = inputs->GetNextDataSet(it))
+    {
+    dataSets.push_back(dataSet);
+    }
+}
+
+void vtkAppendFilterMakePieces(const std::vector<vtkDataSet*> &dataSets,
+                               int attributesType,
+                               std::vector<vtkAppendFilterPiece> &pieces)
+{
+  vtkIdType offset = 0;
+  for (size_t i = 0; i < dataSets.size(); ++i)
+    {
+    vtkIdType num = attributesType == vtkDataObject::POINT ?
+      dataSets[i]->GetNumberOfPoints() : dataSets[i]->GetNumberOfCells();
+    for (vtkIdType begin = 0; begin < num; begin += vtkAppendFilterPieceSize)
+      {
+      vtkAppendFilterPiece piece;
+      piece.Input = i;
+      piece.Begin = begin;
+      piece.End = std::min(num, begin + vtkAppendFilterPieceSize);
+      piece.Offset = offset + begin;
+      pieces.push_back(piece);
+      }
+    offset += num;
+    }
+}
+
+bool vtkAppendFilterIsThreadSafe(vtkArrayList &arrays)
+{
+  for (size_t i = 0; i < arrays.Pairs.size(); ++i)
+    {
+    if (!vtkArrayList::IsThreadSafe(arrays.Pairs[i]->Input) ||
+        !vtkArrayList::IsThreadSafe(arrays.Pairs[i]->Output))
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+// Copy the points of each piece to their place in the output.
+template <class T>
+struct vtkAppendFilterCopyPoints
+{
+  const std::vector<vtkDataSet*> *DataSets;
+  const vtkAppendFilterPiece *Pieces;
+  T *Points;
+
+  void operator()(vtkIdType piece, vtkIdType endPiece)
+    {
+    double x[3];
+    for ( ; piece < endPiece; ++piece)
+      {
+      const vtkAppendFilterPiece &p = this->Pieces[piece];
+      vtkDataSet *dataSet = (*this->DataSets)[p.Input];
+      T *outPt = this->Points + 3 * p.Offset;
+      for (vtkIdType ptId = p.Begin; ptId < p.End; ++ptId, outPt += 3)
+        {
+        dataSet->GetPoint(ptId, x);
+        outPt[0] = static_cast<T>(x[0]);
+        outPt[1] = static_cast<T>(x[1]);
+        outPt[2] = static_cast<T>(x[2]);
+        }
+      }
+    }
+};
+
+// Gather the first of each set of merged points into the output points.
+struct vtkAppendFilterGatherPoints
+{
+  vtkArrayList *Points;
+  const vtkIdType *MergeMap;
+  const vtkIdType *GlobalIds;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+    {
+    for ( ; ptId < endPtId; ++ptId)
+      {
+      if (this->MergeMap[ptId] == ptId)
+        {
+        this->Points->Copy(ptId, this->GlobalIds[ptId]);
+        }
+      }
+    }
+};
+
+// Walks the cells of the pieces. The point ids of input Input are mapped
+// through GlobalIds when points are merged, and offset otherwise.
+struct vtkAppendFilterCells
+{
+  const std::vector<vtkDataSet*> *DataSets;
+  const vtkAppendFilterPiece *Pieces;
+  const vtkIdType *PointOffsets;
+  const vtkIdType *GlobalIds;
+  vtkSMPThreadLocalObject<vtkIdList> CellPoints;
+  vtkSMPThreadLocal<std::set<vtkIdType> > PolyhedronPoints;
+
+  vtkIdType MapId(size_t input, vtkIdType ptId) const
+    {
+    ptId += this->PointOffsets[input];
+    return this->GlobalIds ? this->GlobalIds[ptId] : ptId;
+    }
+
+  // Get the point ids of a cell, without copying them when the dataset
+  // stores them.
+  int GetCellPoints(vtkDataSet *dataSet, vtkUnstructuredGrid *grid,
+                    vtkPolyData *polyData, vtkIdType cellId, vtkIdType &npts,
+                    vtkIdType *&pts)
+    {
+    if (grid)
+      {
+      grid->GetCellPoints(cellId, npts, pts);
+      return grid->GetCellType(cellId);
+      }
+    if (polyData)
+      {
+      return polyData->GetCellPoints(cellId, npts, pts);
+      }
+    vtkIdList *&cellPts = this->CellPoints.Local();
+    dataSet->GetCellPoints(cellId, cellPts);
+    npts = cellPts->GetNumberOfIds();
+    pts = cellPts->GetPointer(0);
+    return dataSet->GetCellType(cellId);
+    }
+
+  // The points of a polyhedron are the sorted, unique ids of its faces, as
+  // vtkUnstructuredGrid::InsertNextCell() makes them.
+  std::set<vtkIdType> &GetPolyhedronPoints(size_t input, vtkIdType nfaces,
+                                           const vtkIdType *faces)
+    {
+    std::set<vtkIdType> &ptIds = this->PolyhedronPoints.Local();
+    ptIds.clear();
+    for (vtkIdType i = 0; i < nfaces; ++i)
+      {
+      vtkIdType npts = *faces++;
+      for (vtkIdType j = 0; j < npts; ++j)
+        {
+        ptIds.insert(this->MapId(input, *faces++));
+        }
+      }
+    return ptIds;
+    }
+};
+
+// Count the connectivity entries, and the face entries of polyhedra, of
+// each piece.
+struct vtkAppendFilterCountCells : public vtkAppendFilterCells
+{
+  vtkIdType *ConnectivitySizes;
+  vtkIdType *FacesSizes;
+
+  void operator()(vtkIdType piece, vtkIdType endPiece)
+    {
+    vtkIdType npts, *pts;
+    for ( ; piece < endPiece; ++piece)
+      {
+      const vtkAppendFilterPiece &p = this->Pieces[piece];
+      vtkDataSet *dataSet = (*this->DataSets)[p.Input];
+      vtkUnstructuredGrid *grid = vtkUnstructuredGrid::SafeDownCast(dataSet);
+      vtkPolyData *polyData = vtkPolyData::SafeDownCast(dataSet);
+      vtkIdType connSize = 0, facesSize = 0;
+      for (vtkIdType cellId = p.Begin; cellId < p.End; ++cellId)
+        {
+        if (grid && grid->GetCellType(cellId) == VTK_POLYHEDRON)
+          {
+          grid->GetFaceStream(cellId, npts, pts);
+          connSize += 1 + static_cast<vtkIdType>(
+            this->GetPolyhedronPoints(p.Input, npts, pts).size());
+          facesSize += 1;
+          for (vtkIdType i = 0; i < npts; ++i)
+            {
+            facesSize += 1 + *pts;
+            pts += 1 + *pts;
+            }
+          }
+        else
+          {
+          this->GetCellPoints(dataSet, grid, polyData, cellId, npts, pts);
+          connSize += 1 + npts;
+          }
+        }
+      this->ConnectivitySizes[piece] = connSize;
+      this->FacesSizes[piece] = facesSize;
+      }
+    }
+};
+
+// Copy the cells of each piece from the connectivity and face offsets
+// counted for it.
+struct vtkAppendFilterCopyCells : public vtkAppendFilterCells
+{
+  const vtkIdType *ConnectivityOffsets;
+  const vtkIdType *FacesOffsets;
+  unsigned char *Types;
+  vtkIdType *Locations;
+  vtkIdType *Connectivity;
+  vtkIdType *FaceLocations;
+  vtkIdType *Faces;
+
+  void operator()(vtkIdType piece, vtkIdType endPiece)
+    {
+    vtkIdType npts, *pts;
+    for ( ; piece < endPiece; ++piece)
+      {
+      const vtkAppendFilterPiece &p = this->Pieces[piece];
+      vtkDataSet *dataSet = (*this->DataSets)[p.Input];
+      vtkUnstructuredGrid *grid = vtkUnstructuredGrid::SafeDownCast(dataSet);
+      vtkPolyData *polyData = vtkPolyData::SafeDownCast(dataSet);
+      vtkIdType *conn = this->Connectivity + this->ConnectivityOffsets[piece];
+      vtkIdType *faces = this->Faces ?
+        this->Faces + this->FacesOffsets[piece] : NULL;
+      for (vtkIdType cellId = p.Begin, outCellId = p.Offset; cellId < p.End;
+           ++cellId, ++outCellId)
+        {
+        this->Locations[outCellId] = conn - this->Connectivity;
+        if (this->FaceLocations)
+          {
+          this->FaceLocations[outCellId] = -1;
+          }
+        if (grid && grid->GetCellType(cellId) == VTK_POLYHEDRON)
+          {
+          this->Types[outCellId] = VTK_POLYHEDRON;
+          this->FaceLocations[outCellId] = faces - this->Faces;
+          grid->GetFaceStream(cellId, npts, pts);
+          std::set<vtkIdType> &ptIds =
+            this->GetPolyhedronPoints(p.Input, npts, pts);
+          *conn++ = static_cast<vtkIdType>(ptIds.size());
+          conn = std::copy(ptIds.begin(), ptIds.end(), conn);
+          *faces++ = npts;
+          for (vtkIdType i = 0; i < npts; ++i)
+            {
+            vtkIdType numFacePts = *pts++;
+            *faces++ = numFacePts;
+            for (vtkIdType j = 0; j < numFacePts; ++j)
+              {
+              *faces++ = this->MapId(p.Input, *pts++);
+              }
+            }
+          }
+        else
+          {
+          this->Types[outCellId] = static_cast<unsigned char>(
+            this->GetCellPoints(dataSet, grid, polyData, cellId, npts,
+                                pts));
+          *conn++ = npts;
+          for (vtkIdType i = 0; i < npts; ++i)
+            {
+            *conn++ = this->MapId(p.Input, pts[i]);
+            }
+          }
+        }
+      }
+    }
+};
+
+// Copy the tuples of each piece. When points are merged, each output point
+// keeps the tuples of the last point merged into it, Sources[] telling
+// which one that is.
+struct vtkAppendFilterCopyTuples
+{
+  const vtkAppendFilterPiece *Pieces;
+  vtkArrayList **Arrays;
+  const vtkIdType *GlobalIds;
+  const vtkIdType *Sources;
+
+  void operator()(vtkIdType piece, vtkIdType endPiece)
+    {
+    for ( ; piece < endPiece; ++piece)
+      {
+      const vtkAppendFilterPiece &p = this->Pieces[piece];
+      vtkArrayList *arrays = this->Arrays[p.Input];
+      for (vtkIdType id = p.Begin, inputId = p.Offset; id < p.End;
+           ++id, ++inputId)
+        {
+        if (!this->GlobalIds)
+          {
+          arrays->Copy(id, inputId);
+          }
+        else if (this->Sources[this->GlobalIds[inputId]] == inputId)
+          {
+          arrays->Copy(id, this->GlobalIds[inputId]);
+          }
+        }
+      }
+    }
+};
+}
+
 //----------------------------------------------------------------------------
 vtkAppendFilter::vtkAppendFilter()
 {
@@ -150,11 +470,15 @@ int vtkAppendFilter::RequestData(
 
   vtkSmartPointer<vtkDataSetCollection> inputs;
   inputs.TakeReference(this->GetNonEmptyInputs(inputVector));
+  std::vector<vtkDataSet*> dataSets;
+  vtkAppendFilterGetDataSets(inputs, dataSets);
 
-  int numInputs = inputs->GetNumberOfItems();
-  for (int inputIndex = 0; inputIndex < numInputs; ++inputIndex)
+  size_t numInputs = dataSets.size();
+  std::vector<vtkIdType> pointOffsets(numInputs);
+  for (size_t inputIndex = 0; inputIndex < numInputs; ++inputIndex)
     {
-    vtkDataSet* dataSet = inputs->GetItem(inputIndex);
+    vtkDataSet* dataSet = dataSets[inputIndex];
+    pointOffsets[inputIndex] = totalNumPts;
     totalNumPts += dataSet->GetNumberOfPoints();
     totalNumCells += dataSet->GetNumberOfCells();
     }
@@ -165,9 +489,6 @@ int vtkAppendFilter::RequestData(
     return 1;
     }
 
-  // Now we can allocate memory
-  output->Allocate(totalNumCells);
-
   vtkSmartPointer<vtkPoints> newPts = vtkSmartPointer<vtkPoints>::New();
 
   // set precision for the points in the output
@@ -175,7 +496,9 @@ int vtkAppendFilter::RequestData(
     {
     // take the precision of the first pointset
     int datatype = VTK_FLOAT;
-    for (int inputIndex = 0; inputIndex < numInputs; ++inputIndex)
+    for (int inputIndex = 0;
+         inputIndex < inputVector[0]->GetNumberOfInformationObjects();
+         ++inputIndex)
       {
       vtkInformation* inInfo = inputVector[0]->GetInformationObject(inputIndex);
       vtkPointSet* ps = 0;
@@ -200,123 +523,133 @@ int vtkAppendFilter::RequestData(
     newPts->SetDataType(VTK_DOUBLE);
     }
 
-  // If we aren't merging points, we need to allocate the points here.
-  if (!reallyMergePoints)
+  // All the offsets are known up front, so the inputs are split into pieces
+  // and copied in parallel. First the points of all the inputs, one after
+  // the other.
+  vtkSmartPointer<vtkPoints> inputPts = newPts;
+  if (reallyMergePoints)
     {
-    newPts->SetNumberOfPoints(totalNumPts);
+    inputPts = vtkSmartPointer<vtkPoints>::New();
+    inputPts->SetDataType(newPts->GetDataType());
     }
+  inputPts->SetNumberOfPoints(totalNumPts);
 
-  vtkSmartPointer<vtkIdList> ptIds = vtkSmartPointer<vtkIdList>::New();
-  ptIds->Allocate(VTK_CELL_SIZE);
-  vtkSmartPointer<vtkIdList> newPtIds = vtkSmartPointer<vtkIdList>::New();
-  newPtIds->Allocate(VTK_CELL_SIZE);
-
-  vtkIdType twentieth = (totalNumPts + totalNumCells)/20 + 1;
+  std::vector<vtkAppendFilterPiece> pointPieces;
+  vtkAppendFilterMakePieces(dataSets, vtkDataObject::POINT, pointPieces);
+  switch (inputPts->GetDataType())
+    {
+    vtkTemplateMacro(
+      vtkAppendFilterCopyPoints<VTK_TT> copier;
+      copier.DataSets = &dataSets;
+      copier.Pieces = &pointPieces[0];
+      copier.Points = static_cast<VTK_TT*>(inputPts->GetVoidPointer(0));
+      vtkSMPTools::For(0, static_cast<vtkIdType>(pointPieces.size()),
+                       copier));
+    }
 
-  // For optionally merging duplicate points
-  vtkIdType* globalIndices = new vtkIdType[totalNumPts];
-  vtkSmartPointer<vtkIncrementalOctreePointLocator> ptInserter;
+  // Coincident points are merged into the first of them with a static point
+  // locator, and numbered in the order they first appear in. The points are
+  // compared once converted to the output type.
+  vtkIdType* globalIndices = NULL;
   if (reallyMergePoints)
     {
-    vtkBoundingBox outputBB;
-
-    for (int inputIndex = 0; inputIndex < numInputs; ++inputIndex)
+    vtkNew<vtkPolyData> cloud;
+    cloud->SetPoints(inputPts);
+    vtkNew<vtkStaticPointLocator> locator;
+    locator->SetDataSet(cloud.GetPointer());
+    std::vector<vtkIdType> mergeMap(totalNumPts);
+    locator->MergePoints(0.0, &mergeMap[0]);
+
+    globalIndices = new vtkIdType[totalNumPts];
+    vtkIdType numNewPts = 0;
+    for (vtkIdType ptId = 0; ptId < totalNumPts; ++ptId)
       {
-      vtkDataSet* dataSet = inputs->GetItem(inputIndex);
-
-      // Union of bounding boxes
-      double localBox[6];
-      dataSet->GetBounds(localBox);
-      outputBB.AddBounds(localBox);
+      globalIndices[ptId] = mergeMap[ptId] == ptId ?
+        numNewPts++ : globalIndices[mergeMap[ptId]];
       }
 
-    double outputBounds[6];
-    outputBB.GetBounds(outputBounds);
-
-    ptInserter = vtkSmartPointer<vtkIncrementalOctreePointLocator>::New();
-    ptInserter->SetTolerance(0.0);
-    ptInserter->InitPointInsertion(newPts, outputBounds);
+    vtkArrayList points;
+    points.AddArray(numNewPts, inputPts->GetData(), newPts->GetData());
+    vtkAppendFilterGatherPoints gatherer =
+      { &points, &mergeMap[0], globalIndices };
+    vtkSMPTools::For(0, totalNumPts, gatherer);
     }
-
-  // append the blocks / pieces in terms of the geoemetry and topology
-  vtkIdType count = 0;
-  vtkIdType ptOffset = 0;
-  float decimal = 0.0;
-  for (int inputIndex = 0, abort = 0; inputIndex < numInputs && !abort; ++inputIndex)
+  this->UpdateProgress(0.25);
+
+  // Now the cells. A first pass counts the connectivity of each piece, so
+  // that the pieces know where their cells go.
+  std::vector<vtkAppendFilterPiece> cellPieces;
+  vtkAppendFilterMakePieces(dataSets, vtkDataObject::CELL, cellPieces);
+  vtkIdType numCellPieces = static_cast<vtkIdType>(cellPieces.size());
+  for (size_t inputIndex = 0; inputIndex < numInputs; ++inputIndex)
     {
-    vtkDataSet* dataSet = inputs->GetItem(inputIndex);
-    vtkIdType dataSetNumPts = dataSet->GetNumberOfPoints();
-    vtkIdType dataSetNumCells = dataSet->GetNumberOfCells();
-
-    // copy points
-    for (vtkIdType ptId = 0; ptId < dataSetNumPts && !abort; ++ptId)
+    // Build the cells of polydata and the like before going threaded.
+    vtkDataSet* dataSet = dataSets[inputIndex];
+    if (dataSet->GetNumberOfCells() > 0)
       {
-      if (reallyMergePoints)
-        {
-        vtkIdType globalPtId = 0;
-        ptInserter->InsertUniquePoint(dataSet->GetPoint(ptId), globalPtId);
-        globalIndices[ptId + ptOffset] = globalPtId;
-        // The point inserter puts the point into newPts, so we don't have to do that here.
-        }
-      else
-        {
-        globalIndices[ptId + ptOffset] = ptId + ptOffset;
-        newPts->SetPoint(ptId + ptOffset, dataSet->GetPoint(ptId));
-        }
-
-      // Update progress
-      count++;
-      if ( !(count % twentieth) )
-        {
-        decimal += 0.05;
-        this->UpdateProgress(decimal);
-        abort = this->GetAbortExecute();
-        }
+      vtkNew<vtkIdList> cellPts;
+      dataSet->GetCellPoints(0, cellPts.GetPointer());
       }
+    }
 
-    // copy cell
-    vtkUnstructuredGrid *ug = vtkUnstructuredGrid::SafeDownCast(dataSet);
-    for (vtkIdType cellId = 0; cellId < dataSetNumCells && !abort; ++cellId)
-      {
-      newPtIds->Reset ();
-      if (ug && dataSet->GetCellType(cellId) == VTK_POLYHEDRON )
-        {
-        vtkIdType nfaces, *facePtIds;
-        ug->GetFaceStream(cellId,nfaces,facePtIds);
-        for(vtkIdType id=0; id < nfaces; ++id)
-          {
-          vtkIdType nPoints = facePtIds[0];
-          newPtIds->InsertNextId(nPoints);
-          for (vtkIdType j = 1; j <= nPoints; ++j)
-            {
-            newPtIds->InsertNextId(globalIndices[facePtIds[j] + ptOffset]);
-            }
-          facePtIds += nPoints + 1;
-          }
-        output->InsertNextCell(VTK_POLYHEDRON, nfaces, newPtIds->GetPointer(0));
-        }
-      else
-        {
-        dataSet->GetCellPoints(cellId, ptIds);
-        for (vtkIdType id = 0; id < ptIds->GetNumberOfIds(); ++id)
-          {
-          newPtIds->InsertId(id, globalIndices[ptIds->GetId(id) + ptOffset]);
-          }
-        output->InsertNextCell(dataSet->GetCellType(cellId),newPtIds);
-        }
+  std::vector<vtkIdType> connOffsets(numCellPieces + 1);
+  std::vector<vtkIdType> facesOffsets(numCellPieces + 1);
+  vtkAppendFilterCountCells counter;
+  counter.DataSets = &dataSets;
+  counter.Pieces = numCellPieces ? &cellPieces[0] : NULL;
+  counter.PointOffsets = &pointOffsets[0];
+  counter.GlobalIds = globalIndices;
+  counter.ConnectivitySizes = &connOffsets[0];
+  counter.FacesSizes = &facesOffsets[0];
+  vtkSMPTools::For(0, numCellPieces, counter);
+
+  // Turn the sizes into offsets.
+  vtkIdType connSize = 0, facesSize = 0;
+  for (vtkIdType piece = 0; piece <= numCellPieces; ++piece)
+    {
+    vtkIdType size = connOffsets[piece];
+    connOffsets[piece] = connSize;
+    connSize += size;
+    size = facesOffsets[piece];
+    facesOffsets[piece] = facesSize;
+    facesSize += size;
+    }
 
-      // Update progress
-      count++;
-      if ( !(count % twentieth) )
-        {
-        decimal += 0.05;
-        this->UpdateProgress(decimal);
-        abort = this->GetAbortExecute();
-        }
-      }
-    ptOffset += dataSetNumPts;
+  vtkNew<vtkUnsignedCharArray> types;
+  types->SetNumberOfValues(totalNumCells);
+  vtkNew<vtkIdTypeArray> locations;
+  locations->SetNumberOfValues(totalNumCells);
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->SetNumberOfValues(connSize);
+  vtkSmartPointer<vtkIdTypeArray> faceLocations;
+  vtkSmartPointer<vtkIdTypeArray> faces;
+  if (facesSize > 0)
+    {
+    faceLocations = vtkSmartPointer<vtkIdTypeArray>::New();
+    faceLocations->SetNumberOfValues(totalNumCells);
+    faces = vtkSmartPointer<vtkIdTypeArray>::New();
+    faces->SetNumberOfValues(facesSize);
     }
 
+  vtkAppendFilterCopyCells copier;
+  copier.DataSets = &dataSets;
+  copier.Pieces = counter.Pieces;
+  copier.PointOffsets = &pointOffsets[0];
+  copier.GlobalIds = globalIndices;
+  copier.ConnectivityOffsets = &connOffsets[0];
+  copier.FacesOffsets = &facesOffsets[0];
+  copier.Types = types->GetPointer(0);
+  copier.Locations = locations->GetPointer(0);
+  copier.Connectivity = connectivity->GetPointer(0);
+  copier.FaceLocations = faceLocations ? faceLocations->GetPointer(0) : NULL;
+  copier.Faces = faces ? faces->GetPointer(0) : NULL;
+  vtkSMPTools::For(0, numCellPieces, copier);
+
+  vtkNew<vtkCellArray> cells;
+  cells->SetCells(totalNumCells, connectivity.GetPointer());
+  output->SetCells(types.GetPointer(), locations.GetPointer(),
+                   cells.GetPointer(), faceLocations, faces);
+  this->UpdateProgress(0.5);
 
   // Now copy the array data
   this->AppendArrays(
@@ -391,10 +724,12 @@ void vtkAppendFilter::AppendArrays(int attributesType,
   vtkDataSetAttributes* firstInputData = NULL;
   vtkSmartPointer<vtkDataSetCollection> inputs;
   inputs.TakeReference(this->GetNonEmptyInputs(inputVector));
-  int numInputs = inputs->GetNumberOfItems();
-  for (int inputIndex = 0; inputIndex < numInputs; ++inputIndex)
+  std::vector<vtkDataSet*> dataSets;
+  vtkAppendFilterGetDataSets(inputs, dataSets);
+  size_t numInputs = dataSets.size();
+  for (size_t inputIndex = 0; inputIndex < numInputs; ++inputIndex)
     {
-    vtkDataSet* dataSet = inputs->GetItem(inputIndex);
+    vtkDataSet* dataSet = dataSets[inputIndex];
     vtkDataSetAttributes* inputData = dataSet->GetAttributes(attributesType);
 
     if (isFirstInputData)
@@ -469,9 +804,9 @@ void vtkAppendFilter::AppendArrays(int attributesType,
     attributeArrays[attribute] = firstInputData->GetAbstractAttribute(attribute);
     }
 
-  for (int inputIndex = 0; inputIndex < numInputs; ++inputIndex)
+  for (size_t inputIndex = 0; inputIndex < numInputs; ++inputIndex)
     {
-    vtkDataSet* dataSet = inputs->GetItem(inputIndex);
+    vtkDataSet* dataSet = dataSets[inputIndex];
 
     for (int attributeIndex = 0; attributeIndex < vtkDataSetAttributes::NUM_ATTRIBUTES; ++attributeIndex)
       {
@@ -519,9 +854,9 @@ void vtkAppendFilter::AppendArrays(int attributesType,
     {
     attributeNeedsNullArray[attributeIndex] = true;
     }
-  for (int inputIndex = 0; inputIndex < numInputs; ++inputIndex)
+  for (size_t inputIndex = 0; inputIndex < numInputs; ++inputIndex)
     {
-    vtkDataSet* dataSet = inputs->GetItem(inputIndex);
+    vtkDataSet* dataSet = dataSets[inputIndex];
 
     for (int attributeIndex = 0; attributeIndex < vtkDataSetAttributes::NUM_ATTRIBUTES; ++attributeIndex)
       {
@@ -564,28 +899,23 @@ void vtkAppendFilter::AppendArrays(int attributesType,
   //////////////////////////////////////////////////////////////
   // Phase 4 - Copy data
   //////////////////////////////////////////////////////////////
-  vtkIdType offset = 0;
-  for (int inputIndex = 0; inputIndex < numInputs; ++inputIndex)
+
+  // Pair the arrays of each input with the output arrays, then copy the
+  // pieces of the inputs in parallel, unless some array can only be
+  // written from one thread.
+  std::vector<vtkArrayList*> arrays(numInputs);
+  bool threadSafe = true;
+  for (size_t inputIndex = 0; inputIndex < numInputs; ++inputIndex)
     {
-    vtkDataSet* dataSet = inputs->GetItem(inputIndex);
-    vtkDataSetAttributes* inputData = dataSet->GetAttributes(attributesType);
+    vtkDataSetAttributes* inputData =
+      dataSets[inputIndex]->GetAttributes(attributesType);
+    arrays[inputIndex] = new vtkArrayList;
     for (std::set<std::string>::iterator it = dataArrayNames.begin(); it != dataArrayNames.end(); ++it)
       {
       const char* arrayName = it->c_str();
-      vtkAbstractArray* srcArray = inputData->GetAbstractArray(arrayName);
-      vtkAbstractArray* dstArray = outputData->GetAbstractArray(arrayName);
-
-      for (vtkIdType id = 0; id < srcArray->GetNumberOfTuples(); ++id)
-        {
-        if (globalIds)
-          {
-          dstArray->SetTuple(globalIds[id + offset], id, srcArray);
-          }
-        else
-          {
-          dstArray->SetTuple(id + offset, id, srcArray);
-          }
-        }
+      arrays[inputIndex]->AddArray(totalNumberOfElements,
+                                   inputData->GetAbstractArray(arrayName),
+                                   outputData->GetAbstractArray(arrayName));
       }
 
     // Copy attributes
@@ -599,29 +929,50 @@ void vtkAppendFilter::AppendArrays(int attributesType,
       if (srcArray && !srcArray->GetName() &&
           dstArray && !dstArray->GetName())
         {
-        for (vtkIdType id = 0; id < srcArray->GetNumberOfTuples(); ++id)
-          {
-          if (globalIds)
-            {
-            dstArray->SetTuple(globalIds[id + offset], id, srcArray);
-            }
-          else
-            {
-            dstArray->SetTuple(id + offset, id, srcArray);
-            }
-          }
+        arrays[inputIndex]->AddArray(totalNumberOfElements, srcArray, dstArray);
         }
       }
+    threadSafe = threadSafe && vtkAppendFilterIsThreadSafe(*arrays[inputIndex]);
+    }
+
+  // Merged points were written in order, so the last point merged into
+  // each output point gave it its tuples.
+  std::vector<vtkIdType> sources;
+  if (globalIds)
+    {
+    vtkIdType numInputElements = 0;
+    for (size_t inputIndex = 0; inputIndex < numInputs; ++inputIndex)
+      {
+      numInputElements += dataSets[inputIndex]->GetNumberOfPoints();
+      }
+    sources.resize(totalNumberOfElements);
+    for (vtkIdType id = 0; id < numInputElements; ++id)
+      {
+      sources[globalIds[id]] = id;
+      }
+    }
 
-    if (attributesType == vtkDataObject::POINT)
+  std::vector<vtkAppendFilterPiece> pieces;
+  vtkAppendFilterMakePieces(dataSets, attributesType, pieces);
+  vtkIdType numPieces = static_cast<vtkIdType>(pieces.size());
+  if (numPieces > 0)
+    {
+    vtkAppendFilterCopyTuples copier =
+      { &pieces[0], &arrays[0], globalIds, globalIds ? &sources[0] : NULL };
+    if (threadSafe)
       {
-      offset += dataSet->GetNumberOfPoints();
+      vtkSMPTools::For(0, numPieces, copier);
       }
-    else if (attributesType == vtkDataObject::CELL)
+    else
       {
-      offset += dataSet->GetNumberOfCells();
+      copier(0, numPieces);
       }
     }
+
+  for (size_t inputIndex = 0; inputIndex < numInputs; ++inputIndex)
+    {
+    delete arrays[inputIndex];
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -20,6 +20,11 @@
 // and appended only if all datasets have the point attributes available.
 // (For example, if one dataset has scalars but another does not, scalars will
 // not be appended.)
+//
+// The number of points, cells and connectivity entries of every input are
+// counted up front, and the inputs are then split into pieces whose points,
+// cells and attributes are copied in parallel with vtkSMPTools. Coincident
+// points are merged with a vtkStaticPointLocator.
 
 // .SECTION See Also
 // vtkAppendPolyData
@@ -15,6 +15,7 @@
 #include "vtkAppendPolyData.h"
 
 #include "vtkAlgorithmOutput.h"
+#include "vtkArrayListTemplate.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkDataArrayIteratorMacro.h"
@@ -24,11 +25,111 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTrivialProducer.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro(vtkAppendPolyData);
 
+namespace
+{
+// Where the points and the verts, lines, polys and strips of an input go in
+// the output, and its arrays paired with the output arrays.
+struct vtkAppendPolyDataInput
+{
+  vtkPolyData *Input;
+  vtkIdType PointOffset;
+  vtkIdType CellOffsets[4];
+  vtkIdType ConnectivityOffsets[4];
+  vtkArrayList *PointArrays;
+  vtkArrayList *CellArrays;
+};
+
+// Pair the arrays of input idx of list with the output arrays, as
+// vtkDataSetAttributes::CopyData() would copy them.
+void vtkAppendPolyDataAddArrays(vtkArrayList *arrays, vtkIdType numTuples,
+                                vtkDataSetAttributes::FieldList &list,
+                                int idx, vtkDataSetAttributes *in,
+                                vtkDataSetAttributes *out)
+{
+  for (int i = 0; i < list.GetNumberOfFields(); ++i)
+    {
+    if (list.GetFieldIndex(i) >= 0 && list.GetDSAIndex(idx, i) >= 0)
+      {
+      arrays->AddArray(numTuples,
+                       in->GetAbstractArray(list.GetDSAIndex(idx, i)),
+                       out->GetAbstractArray(list.GetFieldIndex(i)));
+      }
+    }
+}
+
+bool vtkAppendPolyDataIsThreadSafe(vtkArrayList &arrays)
+{
+  for (size_t i = 0; i < arrays.Pairs.size(); ++i)
+    {
+    if (!vtkArrayList::IsThreadSafe(arrays.Pairs[i]->Input) ||
+        !vtkArrayList::IsThreadSafe(arrays.Pairs[i]->Output))
+      {
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+//----------------------------------------------------------------------------
+// Append the points, cells and attributes of each input to the places set
+// aside for them. Each input is appended by a single thread.
+struct vtkAppendPolyDataAppendInputs
+{
+  vtkAppendPolyData *Self;
+  vtkAppendPolyDataInput *Inputs;
+  vtkDataArray *Points;
+  vtkIdType *Cells[4];
+
+  void operator()(vtkIdType idx, vtkIdType endIdx)
+    {
+    for ( ; idx < endIdx; ++idx)
+      {
+      vtkAppendPolyDataInput &input = this->Inputs[idx];
+      vtkPolyData *ds = input.Input;
+      vtkIdType numPts = ds->GetNumberOfPoints();
+      if (numPts > 0)
+        {
+        this->Self->AppendData(this->Points, ds->GetPoints()->GetData(),
+                               input.PointOffset);
+        for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+          {
+          input.PointArrays->Copy(ptId, input.PointOffset + ptId);
+          }
+        }
+
+      if (ds->GetNumberOfCells() > 0)
+        {
+        // The cells of the input are its verts, lines, polys and strips in
+        // this order.
+        vtkCellArray *inCells[4] = { ds->GetVerts(), ds->GetLines(),
+                                     ds->GetPolys(), ds->GetStrips() };
+        vtkIdType cellId = 0;
+        for (int i = 0; i < 4; ++i)
+          {
+          this->Self->AppendCells(
+            this->Cells[i] + input.ConnectivityOffsets[i], inCells[i],
+            input.PointOffset);
+          vtkIdType numCells = inCells[i]->GetNumberOfCells();
+          for (vtkIdType j = 0; j < numCells; ++j, ++cellId)
+            {
+            input.CellArrays->Copy(cellId, input.CellOffsets[i] + j);
+            }
+          }
+        }
+      }
+    }
+};
+
 //----------------------------------------------------------------------------
 vtkAppendPolyData::vtkAppendPolyData()
 {
@@ -128,14 +229,10 @@ int vtkAppendPolyData::ExecuteAppend(vtkPolyData* output,
 {
   int idx;
   vtkPolyData *ds;
-  vtkPoints  *inPts;
   vtkPoints *newPts;
-  vtkCellArray *inVerts, *newVerts;
-  vtkCellArray *inLines, *newLines;
-  vtkCellArray *inPolys, *newPolys;
-  vtkIdType sizePolys, numPolys;
-  vtkCellArray *inStrips, *newStrips;
-  vtkIdType numPts, numCells;
+  vtkCellArray *newVerts, *newLines, *newPolys, *newStrips;
+  vtkIdType numPts, numCells, numPolys;
+  vtkIdType sizeCells[4] = { 0, 0, 0, 0 };
   vtkPointData *inPD = NULL;
   vtkCellData *inCD = NULL;
   vtkPointData *outputPD = output->GetPointData();
@@ -146,17 +243,13 @@ int vtkAppendPolyData::ExecuteAppend(vtkPolyData* output,
   vtkDataArray *newPtTCoords = NULL;
   vtkDataArray *newPtTensors = NULL;
   int i;
-  vtkIdType *pts = 0;
-  vtkIdType *pPolys;
-  vtkIdType npts = 0;
-  vtkIdType ptId, cellId;
 
   vtkDebugMacro(<<"Appending polydata");
 
   // loop over all data sets, checking to see what point data is available.
   numPts = 0;
   numCells = 0;
-  sizePolys = numPolys = 0;
+  numPolys = 0;
 
   int countPD=0;
   int countCD=0;
@@ -211,11 +304,11 @@ int vtkAppendPolyData::ExecuteAppend(vtkPolyData* output,
       // Although we cannot have cells without points ... let's not nest.
       if (ds->GetNumberOfCells() > 0)
         {
-        // keep track of the size of the poly cell array
-        if (ds->GetPolys())
-          {
-          sizePolys += ds->GetPolys()->GetNumberOfConnectivityEntries();
-          }
+        // keep track of the size of the cell arrays
+        sizeCells[0] += ds->GetVerts()->GetNumberOfConnectivityEntries();
+        sizeCells[1] += ds->GetLines()->GetNumberOfConnectivityEntries();
+        sizeCells[2] += ds->GetPolys()->GetNumberOfConnectivityEntries();
+        sizeCells[3] += ds->GetStrips()->GetNumberOfConnectivityEntries();
         numCells += ds->GetNumberOfCells();
         // Count the cells of each type.
         // This is used to ensure that cell data is copied at the correct
@@ -287,23 +380,29 @@ int vtkAppendPolyData::ExecuteAppend(vtkPolyData* output,
 
   newPts->SetNumberOfPoints(numPts);
 
-  newVerts = vtkCellArray::New();
-  newVerts->Allocate(numCells*4);
-
-  newLines = vtkCellArray::New();
-  newLines->Allocate(numCells*4);
-
-  newStrips = vtkCellArray::New();
-  newStrips->Allocate(numCells*4);
-
-  newPolys = vtkCellArray::New();
-  pPolys = newPolys->WritePointer(numPolys, sizePolys);
-
-  if (!pPolys && sizePolys > 0)
+  // The cells of each type go to an array of their own, sized up front.
+  vtkIdType numCellsOfType[4] = { numVerts, numLines, numPolys, numStrips };
+  vtkCellArray *newCells[4];
+  vtkIdType *pCells[4];
+  for (i = 0; i < 4; ++i)
     {
-    vtkErrorMacro(<<"Memory allocation failed in append filter");
-    return 0;
+    newCells[i] = vtkCellArray::New();
+    pCells[i] = newCells[i]->WritePointer(numCellsOfType[i], sizeCells[i]);
+    if (!pCells[i] && sizeCells[i] > 0)
+      {
+      vtkErrorMacro(<<"Memory allocation failed in append filter");
+      for (int j = 0; j <= i; ++j)
+        {
+        newCells[j]->Delete();
+        }
+      newPts->Delete();
+      return 0;
+      }
     }
+  newVerts = newCells[0];
+  newLines = newCells[1];
+  newPolys = newCells[2];
+  newStrips = newCells[3];
 
   // These are created manually for faster execution
   // Uses the properties of the last input
@@ -383,152 +482,101 @@ int vtkAppendPolyData::ExecuteAppend(vtkPolyData* output,
   outputPD->CopyAllocate(ptList,numPts);
   outputCD->CopyAllocate(cellList,numCells);
 
-  // loop over all input sets
+  // Work out where the points and the cells of each type of every input go
+  // in the output, and pair the arrays of the inputs with the output arrays.
+  std::vector<vtkAppendPolyDataInput> appended;
   vtkIdType ptOffset = 0;
-  vtkIdType vertOffset = 0;
-  vtkIdType linesOffset = 0;
-  vtkIdType polysOffset = 0;
-  vtkIdType stripsOffset = 0;
+  vtkIdType cellOffsets[4] = { 0, numVerts, numVerts + numLines,
+                               numVerts + numLines + numPolys };
+  vtkIdType connOffsets[4] = { 0, 0, 0, 0 };
+  vtkDataArray *newPtAttributes[5] = { newPtScalars, newPtVectors,
+                                       newPtNormals, newPtTCoords,
+                                       newPtTensors };
+  bool threadSafe = true;
   countPD = countCD = 0;
   for (idx = 0; idx < numInputs; ++idx)
     {
-    this->UpdateProgress(0.2 + 0.8*idx/numInputs);
     ds = inputs[idx];
-    // this check is not necessary, but I'll put it in anyway
-    if (ds != NULL)
+    if (ds == NULL ||
+        (ds->GetNumberOfPoints() <= 0 && ds->GetNumberOfCells() <= 0))
       {
-      numPts = ds->GetNumberOfPoints();
-      numCells = ds->GetNumberOfCells();
-      if ( numPts <= 0 && numCells <= 0 )
-        {
-        continue; //no input, just skip
-        }
+      continue; //no input, just skip
+      }
 
+    vtkAppendPolyDataInput input;
+    input.Input = ds;
+    input.PointOffset = ptOffset;
+    input.PointArrays = NULL;
+    input.CellArrays = NULL;
+    if (ds->GetNumberOfPoints() > 0)
+      {
       inPD = ds->GetPointData();
-      inCD = ds->GetCellData();
-
-      inPts = ds->GetPoints();
-      inVerts = ds->GetVerts();
-      inLines = ds->GetLines();
-      inPolys = ds->GetPolys();
-      inStrips = ds->GetStrips();
-
-      if (ds->GetNumberOfPoints() > 0)
+      input.PointArrays = new vtkArrayList;
+      vtkAppendPolyDataAddArrays(input.PointArrays, numPts, ptList, countPD,
+                                 inPD, outputPD);
+      vtkDataArray *inPtAttributes[5] = { inPD->GetScalars(),
+                                          inPD->GetVectors(),
+                                          inPD->GetNormals(),
+                                          inPD->GetTCoords(),
+                                          inPD->GetTensors() };
+      for (i = 0; i < 5; ++i)
         {
-        // copy points directly
-        this->AppendData(newPts->GetData(),
-                         inPts->GetData(), ptOffset);
-
-        // copy scalars directly
-        if (newPtScalars)
-          {
-          this->AppendData(newPtScalars,inPD->GetScalars(), ptOffset);
-          }
-        // copy normals directly
-        if (newPtNormals)
-          {
-          this->AppendData(newPtNormals, inPD->GetNormals(), ptOffset);
-          }
-        // copy vectors directly
-        if (newPtVectors)
-          {
-          this->AppendData(newPtVectors, inPD->GetVectors(), ptOffset);
-          }
-        // copy tcoords directly
-        if (newPtTCoords)
-          {
-          this->AppendData(newPtTCoords, inPD->GetTCoords() , ptOffset);
-          }
-        // copy tensors directly
-        if (newPtTensors)
+        if (newPtAttributes[i])
           {
-          this->AppendData(newPtTensors, inPD->GetTensors(), ptOffset);
+          input.PointArrays->AddArray(numPts, inPtAttributes[i],
+                                      newPtAttributes[i]);
           }
-        // append the remainder of the field data
-        for (ptId=0; ptId < numPts; ptId++)
-          {
-          outputPD->CopyData(ptList,inPD,countPD,ptId,ptId+ptOffset);
-          }
-        ++countPD;
         }
-
-
-      if (ds->GetNumberOfCells() > 0)
+      threadSafe = threadSafe &&
+        vtkAppendPolyDataIsThreadSafe(*input.PointArrays);
+      ++countPD;
+      }
+    if (ds->GetNumberOfCells() > 0)
+      {
+      input.CellArrays = new vtkArrayList;
+      vtkAppendPolyDataAddArrays(input.CellArrays, numCells, cellList,
+                                 countCD, ds->GetCellData(), outputCD);
+      threadSafe = threadSafe &&
+        vtkAppendPolyDataIsThreadSafe(*input.CellArrays);
+      ++countCD;
+
+      vtkCellArray *inCells[4] = { ds->GetVerts(), ds->GetLines(),
+                                   ds->GetPolys(), ds->GetStrips() };
+      for (i = 0; i < 4; ++i)
         {
-        // These are the cellIDs at which each of the cell types start.
-        vtkIdType linesIndex = ds->GetNumberOfVerts();
-        vtkIdType polysIndex = linesIndex + ds->GetNumberOfLines();
-        vtkIdType stripsIndex = polysIndex + ds->GetNumberOfPolys();
-
-        // cell data could be made efficient like the point data,
-        // but I will wait on that.
-        // copy cell data
-        for (cellId=0; cellId < numCells; cellId++)
-          {
-          vtkIdType outCellId = 0;
-          if (cellId < linesIndex)
-            {
-            outCellId = vertOffset;
-            vertOffset++;
-            }
-          else if (cellId < polysIndex)
-            {
-            // outCellId = number of lines we already added + total number of
-            // verts expected in the output.
-            outCellId = linesOffset + numVerts;
-            linesOffset++;
-            }
-          else if (cellId < stripsIndex)
-            {
-            // outCellId = number of polys we already added + total number of
-            // verts and lines expected in the output.
-            outCellId = polysOffset + numLines + numVerts;
-            polysOffset++;
-            }
-          else
-            {
-            // outCellId = number of tstrips we already added + total number of
-            // polys, verts and lines expected in the output.
-            outCellId = stripsOffset + numPolys + numLines + numVerts;
-            stripsOffset++;
-            }
-          outputCD->CopyData(cellList,inCD,countCD,cellId,outCellId);
-          }
-        ++countCD;
-
-        // copy the cells
-        pPolys = this->AppendCells(pPolys, inPolys, ptOffset);
-
-        // These other cell arrays could be made efficient like polys ...
-        for (inVerts->InitTraversal(); inVerts->GetNextCell(npts,pts); )
-          {
-          newVerts->InsertNextCell(npts);
-          for (i=0; i < npts; i++)
-            {
-            newVerts->InsertCellPoint(pts[i]+ptOffset);
-            }
-          }
-
-        for (inLines->InitTraversal(); inLines->GetNextCell(npts,pts); )
-          {
-          newLines->InsertNextCell(npts);
-          for (i=0; i < npts; i++)
-            {
-            newLines->InsertCellPoint(pts[i]+ptOffset);
-            }
-          }
-
-        for (inStrips->InitTraversal(); inStrips->GetNextCell(npts,pts); )
-          {
-          newStrips->InsertNextCell(npts);
-          for (i=0; i < npts; i++)
-            {
-            newStrips->InsertCellPoint(pts[i]+ptOffset);
-            }
-          }
+        input.CellOffsets[i] = cellOffsets[i];
+        input.ConnectivityOffsets[i] = connOffsets[i];
+        cellOffsets[i] += inCells[i]->GetNumberOfCells();
+        connOffsets[i] += inCells[i]->GetNumberOfConnectivityEntries();
         }
-      ptOffset += numPts;
       }
+    ptOffset += ds->GetNumberOfPoints();
+    appended.push_back(input);
+    }
+  this->UpdateProgress(0.2);
+
+  // Now append the inputs, each one from a single thread.
+  if (!appended.empty())
+    {
+    vtkAppendPolyDataAppendInputs appender;
+    appender.Self = this;
+    appender.Inputs = &appended[0];
+    appender.Points = newPts->GetData();
+    std::copy(pCells, pCells + 4, appender.Cells);
+    vtkIdType numAppended = static_cast<vtkIdType>(appended.size());
+    if (threadSafe)
+      {
+      vtkSMPTools::For(0, numAppended, 1, appender);
+      }
+    else
+      {
+      appender(0, numAppended);
+      }
+    }
+  for (size_t k = 0; k < appended.size(); ++k)
+    {
+    delete appended[k].PointArrays;
+    delete appended[k].CellArrays;
     }
 
   // Update ourselves and release memory
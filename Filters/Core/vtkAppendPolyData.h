@@ -21,6 +21,10 @@
 // extracted and appended only if all datasets have the point and/or cell
 // attributes available.  (For example, if one dataset has point scalars but
 // another does not, point scalars will not be appended.)
+//
+// The place of the points and of the verts, lines, polys and strips of every
+// input in the output is worked out up front, and the inputs are then
+// appended in parallel with vtkSMPTools, each one by a single thread.
 
 // .SECTION See Also
 // vtkAppendFilter
@@ -142,6 +146,8 @@ protected:
 
   int UserManagedInputs;
 
+  friend struct vtkAppendPolyDataAppendInputs;
+
 private:
   vtkAppendPolyData(const vtkAppendPolyData&);  // Not implemented.
   void operator=(const vtkAppendPolyData&);  // Not implemented.
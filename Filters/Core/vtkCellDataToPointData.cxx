@@ -14,22 +14,29 @@
 =========================================================================*/
 #include "vtkCellDataToPointData.h"
 
+#include "vtkArrayListTemplate.h"
 #include "vtkCellData.h"
 #include "vtkCell.h"
 #include "vtkDataSet.h"
 #include "vtkIdList.h"
+#include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkRectilinearGrid.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
+#include "vtkStaticCellLinksTemplate.h"
+#include "vtkStructuredData.h"
 #include "vtkStructuredGrid.h"
-#include "vtkUnsignedIntArray.h"
 #include "vtkUnstructuredGrid.h"
 
 #include <algorithm>
-#include <functional>
+#include <vector>
 
 #define VTK_MAX_CELLS_PER_POINT 4096
 
@@ -111,51 +118,233 @@ void vtkCellDataToPointData::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Pass Cell Data: " << (this->PassCellData ? "On\n" : "Off\n");
 }
 
+
 //----------------------------------------------------------------------------
-// Helper template function that implement the major part of the algorighm
-// which will be expanded by the vtkTemplateMacro. The template function is
-// provided so that coverage test can cover this function.
+// Helpers averaging the cell data around the points from several threads.
+// Each thread writes the tuples of its own points only.
 namespace
 {
-  template <typename T>
-  void __spread (vtkUnstructuredGrid* const src, vtkUnsignedIntArray* const num,
-             vtkDataArray* const srcarray, vtkDataArray* const dstarray,
-             vtkIdType ncells, vtkIdType npoints, vtkIdType ncomps)
+  // Set the tuples of point ptId to the mean of the tuples of its numCells
+  // cells, or to zero when the point has no cell or too many of them.
+  void vtkCellDataToPointDataAverage(vtkArrayList *arrays,
+                                     vtkIdType numCells,
+                                     const vtkIdType *cells,
+                                     std::vector<double> &weights,
+                                     vtkIdType ptId)
+  {
+    if ( numCells > 0 && numCells < VTK_MAX_CELLS_PER_POINT )
+      {
+      if (static_cast<vtkIdType>(weights.size()) < numCells)
+        {
+        weights.resize(numCells);
+        }
+      std::fill_n(weights.begin(), numCells, 1.0 / numCells);
+      arrays->Interpolate(static_cast<int>(numCells), cells, &weights[0],
+                          ptId);
+      }
+    else
+      {
+      arrays->Interpolate(0, cells, NULL, ptId);
+      }
+  }
+
+  bool vtkCellDataToPointDataIsThreadSafe(vtkArrayList &arrays)
+  {
+    for (size_t i = 0; i < arrays.Pairs.size(); ++i)
+      {
+      if (!vtkArrayList::IsThreadSafe(arrays.Pairs[i]->Input) ||
+          !vtkArrayList::IsThreadSafe(arrays.Pairs[i]->Output))
+        {
+        return false;
+        }
+      }
+    return true;
+  }
+
+  // Structured data give the cells around a point from its structured
+  // coordinates, without links. When Grid is set, its blanked cells are
+  // left out.
+  struct vtkCellDataToPointDataStructured
+  {
+    int Dimensions[3];
+    vtkStructuredGrid *Grid;
+    vtkArrayList *Arrays;
+    vtkSMPThreadLocalObject<vtkIdList> CellIds;
+    vtkSMPThreadLocal<std::vector<double> > Weights;
+
+    void operator()(vtkIdType ptId, vtkIdType endPtId)
+      {
+      vtkIdList *&cellIds = this->CellIds.Local();
+      std::vector<double> &weights = this->Weights.Local();
+      for ( ; ptId < endPtId; ++ptId)
+        {
+        vtkStructuredData::GetPointCells(ptId, cellIds, this->Dimensions);
+        vtkIdType *cells = cellIds->GetPointer(0);
+        vtkIdType numCells = cellIds->GetNumberOfIds();
+        if (this->Grid)
+          {
+          vtkIdType numVisible = 0;
+          for (vtkIdType i = 0; i < numCells; ++i)
+            {
+            if (this->Grid->IsCellVisible(cells[i]))
+              {
+              cells[numVisible++] = cells[i];
+              }
+            }
+          numCells = numVisible;
+          }
+        vtkCellDataToPointDataAverage(this->Arrays, numCells, cells, weights,
+                                      ptId);
+        }
+      }
+  };
+
+  // Other datasets use static cell links. Their runs list the cells in
+  // decreasing order; they are reversed so that the cells are summed in
+  // increasing order, as vtkDataSet::GetPointCells() returns them.
+  struct vtkCellDataToPointDataLinked
   {
-    T const* const srcptr = static_cast<T const*>(srcarray->GetVoidPointer(0));
-    T      * const dstptr = static_cast<T      *>(dstarray->GetVoidPointer(0));
+    vtkStaticCellLinksTemplate<vtkIdType> *Links;
+    vtkArrayList *Arrays;
+    vtkSMPThreadLocal<std::vector<vtkIdType> > CellIds;
+    vtkSMPThreadLocal<std::vector<double> > Weights;
 
-    // zero initialization
-    std::fill_n(dstptr, npoints*ncomps, T(0));
+    void operator()(vtkIdType ptId, vtkIdType endPtId)
+      {
+      std::vector<vtkIdType> &cellIds = this->CellIds.Local();
+      std::vector<double> &weights = this->Weights.Local();
+      for ( ; ptId < endPtId; ++ptId)
+        {
+        vtkIdType numCells = this->Links->GetNumberOfCells(ptId);
+        const vtkIdType *cells = this->Links->GetCells(ptId);
+        if ( numCells > 0 && numCells < VTK_MAX_CELLS_PER_POINT )
+          {
+          if (static_cast<vtkIdType>(cellIds.size()) < numCells)
+            {
+            cellIds.resize(numCells);
+            }
+          std::reverse_copy(cells, cells + numCells, cellIds.begin());
+          cells = &cellIds[0];
+          }
+        vtkCellDataToPointDataAverage(this->Arrays, numCells, cells, weights,
+                                      ptId);
+        }
+      }
+  };
+
+  // Interpolate the cell data into point data of their own, so that the
+  // arrays passed from the input point data are not paired with the cell
+  // arrays of the same name, and then move the arrays to outPD as
+  // InterpolateAllocate() would have added them.
+  template <class TAverage>
+  void vtkCellDataToPointDataInterpolate(TAverage &average,
+                                         vtkIdType numPts,
+                                         vtkCellData *inCD,
+                                         vtkPointData *outPD)
+  {
+    vtkNew<vtkPointData> pointData;
+    pointData->CopyGlobalIdsOff();
+    pointData->CopyFieldOff(vtkDataSetAttributes::GhostArrayName());
+    pointData->InterpolateAllocate(inCD, numPts);
+
+    vtkArrayList arrays;
+    arrays.AddArrays(numPts, inCD, pointData.GetPointer());
+    average.Arrays = &arrays;
+    if (vtkCellDataToPointDataIsThreadSafe(arrays))
+      {
+      vtkSMPTools::For(0, numPts, average);
+      }
+    else
+      {
+      average(0, numPts);
+      }
 
-    // accumulate
-    T const* srcbeg = srcptr;
-    vtkNew<vtkIdList> pids;
-    for (vtkIdType cid = 0; cid < ncells; ++cid, srcbeg += ncomps)
+    for (int i = 0; i < pointData->GetNumberOfArrays(); ++i)
       {
-      src->GetCellPoints(cid, pids.GetPointer());
-      for (vtkIdType i = 0, I = pids->GetNumberOfIds(); i < I; ++i)
+      int idx = outPD->AddArray(pointData->GetAbstractArray(i));
+      int attributeType = pointData->IsArrayAnAttribute(i);
+      if (attributeType >= 0)
         {
-        T* const dstbeg = dstptr + pids->GetId(i)*ncomps;
-        // accumulate cell data to point data <==> point_data += cell_data
-        std::transform(srcbeg,srcbeg+ncomps,dstbeg,dstbeg,std::plus<T>());
+        outPD->SetActiveAttribute(idx, attributeType);
         }
       }
+  }
+
+  // The unstructured grid path averages in the value type of each array.
+  class vtkCellDataToPointDataArray
+  {
+  public:
+    virtual ~vtkCellDataToPointDataArray() {}
+    virtual void Average(vtkStaticCellLinksTemplate<vtkIdType> *links,
+                         vtkIdType ptId, vtkIdType endPtId) = 0;
+  };
+
+  template <typename T>
+  class vtkCellDataToPointDataTypedArray : public vtkCellDataToPointDataArray
+  {
+  public:
+    vtkCellDataToPointDataTypedArray(vtkDataArray *in, vtkDataArray *out)
+      {
+      this->Input = static_cast<T*>(in->GetVoidPointer(0));
+      this->Output = static_cast<T*>(out->GetVoidPointer(0));
+      this->NumberOfComponents = in->GetNumberOfComponents();
+      }
 
-    // average
-    T* dstbeg = dstptr;
-    for (vtkIdType pid = 0; pid < npoints; ++pid, dstbeg += ncomps)
+    // The cells of a run of static links are in decreasing order: they are
+    // summed backwards, in the order the cells used to be scattered.
+    virtual void Average(vtkStaticCellLinksTemplate<vtkIdType> *links,
+                         vtkIdType ptId, vtkIdType endPtId)
       {
-      // guard against divide by zero
-      if (unsigned int const denum = num->GetValue(pid))
+      int numComp = this->NumberOfComponents;
+      T *out = this->Output + ptId * numComp;
+      for ( ; ptId < endPtId; ++ptId, out += numComp)
         {
-        // divide point data by the number of cells using it <==>
-        // point_data /= denum
-        std::transform(dstbeg, dstbeg+ncomps, dstbeg,
-          std::bind2nd(std::divides<T>(), denum));
+        vtkIdType numCells = links->GetNumberOfCells(ptId);
+        const vtkIdType *cells = links->GetCells(ptId);
+        std::fill_n(out, numComp, T(0));
+        for (vtkIdType i = numCells; i--; )
+          {
+          const T *in = this->Input + cells[i] * numComp;
+          for (int j = 0; j < numComp; ++j)
+            {
+            out[j] += in[j];
+            }
+          }
+        if (numCells > 0)
+          {
+          for (int j = 0; j < numComp; ++j)
+            {
+            out[j] /= static_cast<T>(numCells);
+            }
+          }
         }
       }
+
+    T *Input;
+    T *Output;
+    int NumberOfComponents;
+  };
+
+  template <typename T>
+  vtkCellDataToPointDataArray *vtkCellDataToPointDataNewArray(
+    T *, vtkDataArray *in, vtkDataArray *out)
+  {
+    return new vtkCellDataToPointDataTypedArray<T>(in, out);
   }
+
+  struct vtkCellDataToPointDataUnstructured
+  {
+    vtkStaticCellLinksTemplate<vtkIdType> *Links;
+    std::vector<vtkCellDataToPointDataArray*> *Arrays;
+
+    void operator()(vtkIdType ptId, vtkIdType endPtId)
+      {
+      for (size_t i = 0; i < this->Arrays->size(); ++i)
+        {
+        (*this->Arrays)[i]->Average(this->Links, ptId, endPtId);
+        }
+      }
+  };
 }
 
 //----------------------------------------------------------------------------
@@ -177,23 +366,6 @@ int vtkCellDataToPointData::RequestDataForUnstructuredGrid
     return 1;
     }
 
-  // count the number of cells associated with each point
-  vtkSmartPointer<vtkUnsignedIntArray> num
-    = vtkSmartPointer<vtkUnsignedIntArray>::New();
-  num->SetNumberOfComponents(1);
-  num->SetNumberOfTuples(npoints);
-  std::fill_n(num->GetPointer(0), npoints, 0u);
-  vtkNew<vtkIdList> pids;
-  for (vtkIdType cid = 0; cid < ncells; ++cid)
-    {
-    src->GetCellPoints(cid, pids.GetPointer());
-    for (vtkIdType i = 0, I = pids->GetNumberOfIds(); i < I; ++i)
-      {
-      vtkIdType const pid = pids->GetId(i);
-      num->SetValue(pid, num->GetValue(pid)+1);
-      }
-    }
-
   // First, copy the input to the output as a starting point
   dst->CopyStructure(src);
   vtkPointData* const opd = dst->GetPointData();
@@ -223,15 +395,9 @@ int vtkCellDataToPointData::RequestDataForUnstructuredGrid
   cfl.InitializeFieldList(clean);
   opd->InterpolateAllocate(cfl, npoints, npoints);
 
+  std::vector<vtkCellDataToPointDataArray*> arrays;
   for (int fid = 0, nfields = cfl.GetNumberOfFields(); fid < nfields; ++fid)
     {
-    // update progress and check for an abort request.
-    this->UpdateProgress((fid+1.)/nfields);
-    if (this->GetAbortExecute())
-      {
-      break;
-      }
-
     // indices into the field arrays associated with the cell and the point
     // respectively
     int const dstid = cfl.GetFieldIndex(fid);
@@ -241,26 +407,31 @@ int vtkCellDataToPointData::RequestDataForUnstructuredGrid
       continue;
       }
 
-    vtkCellData * const srccelldata  = clean;
-    vtkPointData* const dstpointdata = dst->GetPointData();
-
-    if (!srccelldata || !dstpointdata)
-      {
-      continue;
-      }
-
-    vtkDataArray* const srcarray = srccelldata ->GetArray(srcid);
-    vtkDataArray* const dstarray = dstpointdata->GetArray(dstid);
+    vtkDataArray* const srcarray = clean->GetArray(srcid);
+    vtkDataArray* const dstarray = opd->GetArray(dstid);
     dstarray->SetNumberOfTuples(npoints);
 
-    vtkIdType const ncomps = srcarray->GetNumberOfComponents();
     switch (srcarray->GetDataType())
       {
-      vtkTemplateMacro
-        (__spread<VTK_TT>(src,num,srcarray,dstarray,ncells,npoints,ncomps));
+      vtkTemplateMacro(arrays.push_back(vtkCellDataToPointDataNewArray(
+        static_cast<VTK_TT*>(0), srcarray, dstarray)));
       }
     }
 
+  // Average all the arrays over the points, which find the cells using
+  // them in static links.
+  vtkStaticCellLinksTemplate<vtkIdType> links;
+  links.BuildLinks(src);
+  vtkCellDataToPointDataUnstructured average;
+  average.Links = &links;
+  average.Arrays = &arrays;
+  vtkSMPTools::For(0, npoints, average);
+  for (size_t i = 0; i < arrays.size(); ++i)
+    {
+    delete arrays[i];
+    }
+  this->UpdateProgress(1.0);
+
   if (!this->PassCellData)
     {
     dst->GetCellData()->CopyAllOff();
@@ -274,99 +445,57 @@ int vtkCellDataToPointData::RequestDataForUnstructuredGrid
 void vtkCellDataToPointData::interpolatePointData(vtkDataSet *input,
                                                   vtkDataSet *output)
 {
-  vtkNew<vtkIdList> cellIds;
-  cellIds->Allocate(VTK_MAX_CELLS_PER_POINT);
-
   vtkIdType numPts = input->GetNumberOfPoints();
 
   vtkCellData *inCD = input->GetCellData();
   vtkPointData *outPD = output->GetPointData();
-  outPD->InterpolateAllocate(inCD,numPts);
-
-  std::vector<double> weights(VTK_MAX_CELLS_PER_POINT);
 
-  int abort = 0;
-  vtkIdType progressInterval = numPts / 20 + 1;
-  for (vtkIdType ptId = 0; ptId < numPts && !abort; ptId++)
+  vtkImageData *image = vtkImageData::SafeDownCast(input);
+  vtkRectilinearGrid *rGrid = vtkRectilinearGrid::SafeDownCast(input);
+  vtkStructuredGrid *sGrid = vtkStructuredGrid::SafeDownCast(input);
+  if (image || rGrid || sGrid)
     {
-    if ( !(ptId % progressInterval) )
+    vtkCellDataToPointDataStructured average;
+    if (image)
       {
-      this->UpdateProgress(static_cast<double>(ptId)/numPts);
-      abort = GetAbortExecute();
+      image->GetDimensions(average.Dimensions);
       }
-
-    input->GetPointCells(ptId, cellIds.GetPointer());
-    vtkIdType numCells = cellIds->GetNumberOfIds();
-
-    if ( numCells > 0 && numCells < VTK_MAX_CELLS_PER_POINT )
+    else if (rGrid)
       {
-      double weight = 1.0 / numCells;
-      for (vtkIdType cellId = 0; cellId < numCells; cellId++)
-        {
-        weights[cellId] = weight;
-        }
-      outPD->InterpolatePoint(inCD, ptId, cellIds.GetPointer(), &weights[0]);
+      rGrid->GetDimensions(average.Dimensions);
       }
     else
       {
-      outPD->NullPoint(ptId);
+      sGrid->GetDimensions(average.Dimensions);
       }
+    average.Grid = NULL;
+    vtkCellDataToPointDataInterpolate(average, numPts, inCD, outPD);
     }
+  else
+    {
+    vtkStaticCellLinksTemplate<vtkIdType> links;
+    links.BuildLinks(input);
+    vtkCellDataToPointDataLinked average;
+    average.Links = &links;
+    vtkCellDataToPointDataInterpolate(average, numPts, inCD, outPD);
+    }
+  this->UpdateProgress(1.0);
 }
 
 void vtkCellDataToPointData::interpolatePointDataWithMask(
     vtkStructuredGrid *input, vtkDataSet *output)
 {
-  vtkNew<vtkIdList> allCellIds;
-  allCellIds->Allocate(VTK_MAX_CELLS_PER_POINT);
-  vtkNew<vtkIdList> cellIds;
-  cellIds->Allocate(VTK_MAX_CELLS_PER_POINT);
-
   vtkIdType numPts = input->GetNumberOfPoints();
 
   vtkCellData *inCD = input->GetCellData();
   vtkPointData *outPD = output->GetPointData();
-  outPD->InterpolateAllocate(inCD,numPts);
-
-  std::vector<double> weights(VTK_MAX_CELLS_PER_POINT);
-
-  int abort = 0;
-  vtkIdType progressInterval = numPts / 20 + 1;
-  for (vtkIdType ptId = 0; ptId < numPts && !abort; ptId++)
-    {
-    if ( !(ptId % progressInterval) )
-      {
-      this->UpdateProgress(static_cast<double>(ptId)/numPts);
-      abort = GetAbortExecute();
-      }
-
-    input->GetPointCells(ptId, allCellIds.GetPointer());
-    cellIds->Reset();
-    // Only consider cells that are not masked:
-    for (vtkIdType cId = 0; cId < allCellIds->GetNumberOfIds(); ++cId)
-      {
-      vtkIdType curCell = allCellIds->GetId(cId);
-      if (input->IsCellVisible(curCell))
-        {
-        cellIds->InsertNextId(curCell);
-        }
-      }
 
-    vtkIdType numCells = cellIds->GetNumberOfIds();
+  // IsCellVisible() caches the ghost arrays of the grid on its first call.
+  input->IsCellVisible(0);
 
-    if ( numCells > 0 && numCells < VTK_MAX_CELLS_PER_POINT )
-      {
-      double weight = 1.0 / numCells;
-      for (vtkIdType cellId = 0; cellId < numCells; cellId++)
-        {
-        weights[cellId] = weight;
-        }
-      outPD->InterpolatePoint(inCD, ptId, cellIds.GetPointer(), &weights[0]);
-      }
-    else
-      {
-      outPD->NullPoint(ptId);
-      }
-    }
+  vtkCellDataToPointDataStructured average;
+  input->GetDimensions(average.Dimensions);
+  average.Grid = input;
+  vtkCellDataToPointDataInterpolate(average, numPts, inCD, outPD);
+  this->UpdateProgress(1.0);
 }
-
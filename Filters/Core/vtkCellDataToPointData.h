@@ -19,6 +19,11 @@
 // points). The method of transformation is based on averaging the data
 // values of all cells using a particular point. Optionally, the input cell
 // data can be passed through to the output as well.
+//
+// The points are processed in parallel with vtkSMPTools. Structured data
+// find the cells around a point from its structured coordinates; other
+// datasets use static cell links. Arrays that cannot be written from several
+// threads, such as string arrays, are interpolated from one thread.
 
 // .SECTION Caveats
 // This filter is an abstract filter, that is, the output is an abstract type
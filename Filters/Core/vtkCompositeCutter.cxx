@@ -28,7 +28,10 @@
 #include "vtkPlane.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkThreadedCompositeDataPipeline.h"
 #include "vtkAppendPolyData.h"
 
 #include <math.h>
@@ -36,6 +39,8 @@
 #include "vtkCompositeDataIterator.h"
 #include "vtkSmartPointer.h"
 #include <cassert>
+#include <map>
+#include <vector>
 
 vtkStandardNewMacro(vtkCompositeCutter);
 
@@ -74,6 +79,60 @@ namespace
       }
     return false;
   }
+
+  // Cut the blocks in parallel, each thread with its own cutter set up
+  // like the composite cutter.
+  class CutBlocks
+  {
+  public:
+    CutBlocks(vtkCutter* self, const std::vector<vtkDataObject*>& blocks,
+              const std::vector<vtkIdType>& order,
+              std::vector<vtkSmartPointer<vtkPolyData> >& outputs)
+      : Self(self), Blocks(blocks), Order(order), Outputs(outputs)
+    {
+    }
+
+    void Initialize()
+    {
+    vtkCutter* cutter = this->Cutters.Local();
+    cutter->SetCutFunction(this->Self->GetCutFunction());
+    int numContours = this->Self->GetNumberOfContours();
+    cutter->SetNumberOfContours(numContours);
+    for (int c = 0; c < numContours; ++c)
+      {
+      cutter->SetValue(c, this->Self->GetValue(c));
+      }
+    cutter->SetGenerateCutScalars(this->Self->GetGenerateCutScalars());
+    cutter->SetGenerateTriangles(this->Self->GetGenerateTriangles());
+    cutter->SetSortBy(this->Self->GetSortBy());
+    cutter->SetOutputPointsPrecision(this->Self->GetOutputPointsPrecision());
+    }
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+    vtkCutter* cutter = this->Cutters.Local();
+    for (vtkIdType k = begin; k < end; ++k)
+      {
+      vtkIdType i = this->Order[k];
+      cutter->SetInputData(this->Blocks[i]);
+      cutter->Update();
+      this->Outputs[i] = vtkSmartPointer<vtkPolyData>::New();
+      this->Outputs[i]->ShallowCopy(cutter->GetOutput());
+      }
+    cutter->SetInputData(NULL);
+    }
+
+    void Reduce()
+    {
+    }
+
+  private:
+    vtkCutter* Self;
+    const std::vector<vtkDataObject*>& Blocks;
+    const std::vector<vtkIdType>& Order;
+    std::vector<vtkSmartPointer<vtkPolyData> >& Outputs;
+    vtkSMPThreadLocalObject<vtkCutter> Cutters;
+  };
 };
 
 vtkCompositeCutter::vtkCompositeCutter(vtkImplicitFunction *cf):vtkCutter(cf)
@@ -149,19 +208,56 @@ int vtkCompositeCutter::RequestData(vtkInformation *request,
   itr->SetSkipEmptyNodes(true);
 
   vtkNew<vtkAppendPolyData> append;
-  int numObjects(0);
-  itr->GoToFirstItem();
-  while(!itr->IsDoneWithTraversal())
+  if (this->Locator)
+    {
+    // A locator given by the user cannot be shared by several threads.
+    itr->GoToFirstItem();
+    while(!itr->IsDoneWithTraversal())
+      {
+      vtkDataSet* data = vtkDataSet::SafeDownCast(itr->GetCurrentDataObject());
+      assert(data);
+      inInfo->Set(vtkDataObject::DATA_OBJECT(),data);
+      vtkNew<vtkPolyData> out;
+      outInfo->Set(vtkDataObject::DATA_OBJECT(),out.GetPointer());
+      this->Superclass::RequestData(request,inputVector,outputVector);
+      append->AddInputData(out.GetPointer());
+      itr->GoToNextItem();
+      }
+    }
+  else
     {
-    vtkDataSet* data = vtkDataSet::SafeDownCast(itr->GetCurrentDataObject());
-    assert(data);
-    inInfo->Set(vtkDataObject::DATA_OBJECT(),data);
-    vtkNew<vtkPolyData> out;
-    outInfo->Set(vtkDataObject::DATA_OBJECT(),out.GetPointer());
-    this->Superclass::RequestData(request,inputVector,outputVector);
-    append->AddInputData(out.GetPointer());
-    numObjects++;
-    itr->GoToNextItem();
+    // A block may appear several times in the input: cut it once.
+    std::vector<vtkDataObject*> blocks;
+    std::vector<vtkIdType> blockOfLeaf;
+    std::map<vtkDataObject*, vtkIdType> blockIds;
+    for (itr->GoToFirstItem(); !itr->IsDoneWithTraversal(); itr->GoToNextItem())
+      {
+      vtkDataObject* data = itr->GetCurrentDataObject();
+      assert(vtkDataSet::SafeDownCast(data));
+      std::map<vtkDataObject*, vtkIdType>::iterator found = blockIds.find(data);
+      if (found == blockIds.end())
+        {
+        found = blockIds.insert(std::make_pair(
+          data, static_cast<vtkIdType>(blocks.size()))).first;
+        blocks.push_back(data);
+        }
+      blockOfLeaf.push_back(found->second);
+      }
+
+    vtkIdType numBlocks = static_cast<vtkIdType>(blocks.size());
+    std::vector<vtkIdType> order(numBlocks);
+    std::vector<vtkSmartPointer<vtkPolyData> > outputs(numBlocks);
+    if (numBlocks > 0)
+      {
+      vtkThreadedCompositeDataPipeline::ComputeExecutionOrder(
+        &blocks[0], numBlocks, &order[0]);
+      CutBlocks cut(this, blocks, order, outputs);
+      vtkSMPTools::For(0, numBlocks, 1, cut);
+      }
+    for (size_t i = 0; i < blockOfLeaf.size(); ++i)
+      {
+      append->AddInputData(outputs[blockOfLeaf[i]]);
+      }
     }
   append->Update();
 
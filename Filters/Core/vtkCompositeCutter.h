@@ -14,7 +14,9 @@
 =========================================================================*/
 // .NAME vtkCompositeCutter - Cut composite data sets with user-specified implicit function
 // .SECTION Description
-// Loop over each data set in the composite input and apply vtkCutter
+// Loop over each data set in the composite input and apply vtkCutter.
+// The data sets are cut in parallel with vtkSMPTools, largest first,
+// unless a locator is set.
 // .SECTION See Also
 // vtkCutter
 
@@ -16,21 +16,68 @@
 
 #include "vtkCell.h"
 #include "vtkCellData.h"
+#include "vtkConnectivityHelper.h"
 #include "vtkDataSet.h"
-#include "vtkFloatArray.h"
 #include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
-#include "vtkMath.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
-#include "vtkPointData.h"
 #include "vtkPoints.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkIdTypeArray.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro(vtkConnectivityFilter);
 
+namespace
+{
+// Flag the cells connected by scalar, those with the first component of
+// the scalars of one of their points in the scalar range.
+class vtkCellScalarConnects
+{
+public:
+  vtkCellScalarConnects(vtkDataSet *input, vtkDataArray *scalars,
+                        const double range[2], unsigned char *connects) :
+    Input(input), Scalars(scalars), Connects(connects)
+  {
+    this->Range[0] = range[0];
+    this->Range[1] = range[1];
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdList *ptIds = this->PointIds.Local();
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+      this->Input->GetCellPoints(cellId, ptIds);
+      double range[2] = { VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX };
+      for (vtkIdType i = 0; i < ptIds->GetNumberOfIds(); ++i)
+        {
+        // The scalars have always been compared in single precision.
+        double s = static_cast<float>(
+          this->Scalars->GetComponent(ptIds->GetId(i), 0));
+        range[0] = std::min(range[0], s);
+        range[1] = std::max(range[1], s);
+        }
+      this->Connects[cellId] =
+        range[1] >= this->Range[0] && range[0] <= this->Range[1];
+      }
+  }
+
+private:
+  vtkDataSet *Input;
+  vtkDataArray *Scalars;
+  double Range[2];
+  unsigned char *Connects;
+  vtkSMPThreadLocalObject<vtkIdList> PointIds;
+};
+}
+
 // Construct with default extraction mode to extract largest regions.
 vtkConnectivityFilter::vtkConnectivityFilter()
 {
@@ -44,12 +91,6 @@ vtkConnectivityFilter::vtkConnectivityFilter()
 
   this->ClosestPoint[0] = this->ClosestPoint[1] = this->ClosestPoint[2] = 0.0;
 
-  this->CellScalars = vtkFloatArray::New();
-  this->CellScalars->Allocate(8);
-
-  this->NeighborCellPointIds = vtkIdList::New();
-  this->NeighborCellPointIds->Allocate(8);
-
   this->Seeds = vtkIdList::New();
   this->SpecifiedRegionIds = vtkIdList::New();
 
@@ -62,8 +103,6 @@ vtkConnectivityFilter::vtkConnectivityFilter()
 vtkConnectivityFilter::~vtkConnectivityFilter()
 {
   this->RegionSizes->Delete();
-  this->CellScalars->Delete();
-  this->NeighborCellPointIds->Delete();
   this->Seeds->Delete();
   this->SpecifiedRegionIds->Delete();
 }
@@ -86,8 +125,7 @@ int vtkConnectivityFilter::RequestData(
   vtkIdType numPts, numCells, cellId, newCellId, i, j, pt;
   vtkPoints *newPts;
   int id;
-  int maxCellsInRegion;
-  int largestRegionId = 0;
+  vtkIdType largestRegionId = 0;
   vtkPointData *pd=input->GetPointData(), *outputPD=output->GetPointData();
   vtkCellData *cd=input->GetCellData(), *outputCD=output->GetCellData();
 
@@ -122,15 +160,7 @@ int vtkConnectivityFilter::RequestData(
   //
   this->RegionSizes->Reset();
   this->Visited = new vtkIdType[numCells];
-  for ( i=0; i < numCells; i++ )
-    {
-    this->Visited[i] = -1;
-    }
   this->PointMap = new vtkIdType[numPts];
-  for ( i=0; i < numPts; i++ )
-    {
-    this->PointMap[i] = -1;
-    }
 
   this->NewScalars = vtkIdTypeArray::New();
   this->NewScalars->SetName("RegionId");
@@ -166,69 +196,51 @@ int vtkConnectivityFilter::RequestData(
 
   newPts->Allocate(numPts);
 
-  // Traverse all cells marking those visited.  Each new search
-  // starts a new connected region. Connected region grows
-  // using a connected wave propagation.
+  // Find the connected regions in parallel. With scalar connectivity, only
+  // the cells with a scalar in range at one of their points are reached
+  // from the cells sharing their points. GetCellPoints() is called once
+  // first so that the input builds its cells before threads use them.
   //
-  this->Wave = vtkIdList::New();
-  this->Wave->Allocate(numPts/4+1,numPts);
-  this->Wave2 = vtkIdList::New();
-  this->Wave2->Allocate(numPts/4+1,numPts);
-
-  this->PointNumber = 0;
-  this->RegionNumber = 0;
-  maxCellsInRegion = 0;
-
-  this->CellIds = vtkIdList::New();
-  this->CellIds->Allocate(8, VTK_CELL_SIZE);
   this->PointIds = vtkIdList::New();
   this->PointIds->Allocate(8, VTK_CELL_SIZE);
+  input->GetCellPoints(0, this->PointIds);
+
+  std::vector<unsigned char> connects;
+  if ( this->InScalars )
+    {
+    connects.resize(numCells);
+    vtkCellScalarConnects cellConnects(input, this->InScalars,
+                                       this->ScalarRange, &connects[0]);
+    vtkSMPTools::For(0, numCells, cellConnects);
+    }
+
+  vtkConnectivityHelper helper;
+  helper.BuildComponents(input, connects.empty() ? NULL : &connects[0]);
+  this->UpdateProgress (0.5);
 
+  this->RegionNumber = 0;
   if ( this->ExtractionMode != VTK_EXTRACT_POINT_SEEDED_REGIONS &&
   this->ExtractionMode != VTK_EXTRACT_CELL_SEEDED_REGIONS &&
   this->ExtractionMode != VTK_EXTRACT_CLOSEST_POINT_REGION )
-    { //visit all cells marking with region number
-    for (cellId=0; cellId < numCells; cellId++)
-      {
-      if ( cellId && !(cellId % 5000) )
-        {
-        this->UpdateProgress (0.1 + 0.8*cellId/numCells);
-        }
-
-      if ( this->Visited[cellId] < 0 )
-        {
-        this->NumCellsInRegion = 0;
-        this->Wave->InsertNextId(cellId);
-        this->TraverseAndMark (input);
-
-        if ( this->NumCellsInRegion > maxCellsInRegion )
-          {
-          maxCellsInRegion = this->NumCellsInRegion;
-          largestRegionId = this->RegionNumber;
-          }
-
-        this->RegionSizes->InsertValue(this->RegionNumber++,
-                                       this->NumCellsInRegion);
-        this->Wave->Reset();
-        this->Wave2->Reset();
-        }
-      }
+    { //mark all cells with region number
+    largestRegionId = helper.LabelAllRegions(this->Visited, this->RegionSizes);
+    this->RegionNumber = this->RegionSizes->GetNumberOfTuples();
     }
   else // regions have been seeded, everything considered in same region
     {
-    this->NumCellsInRegion = 0;
+    vtkIdList *seedCells = vtkIdList::New();
 
     if ( this->ExtractionMode == VTK_EXTRACT_POINT_SEEDED_REGIONS )
       {
       for (i=0; i < this->Seeds->GetNumberOfIds(); i++)
         {
         pt = this->Seeds->GetId(i);
-        if ( pt >= 0 )
+        if ( pt >= 0 && pt < numPts )
           {
-          input->GetPointCells(pt,this->CellIds);
-          for (j=0; j < this->CellIds->GetNumberOfIds(); j++)
+          const vtkIdType *cells = helper.GetPointCells(pt);
+          for (j=0; j < helper.GetNumberOfPointCells(pt); j++)
             {
-            this->Wave->InsertNextId(this->CellIds->GetId(j));
+            seedCells->InsertNextId(cells[j]);
             }
           }
         }
@@ -240,41 +252,35 @@ int vtkConnectivityFilter::RequestData(
         cellId = this->Seeds->GetId(i);
         if ( cellId >= 0 )
           {
-          this->Wave->InsertNextId(cellId);
+          seedCells->InsertNextId(cellId);
           }
         }
       }
     else if ( this->ExtractionMode == VTK_EXTRACT_CLOSEST_POINT_REGION )
-      {//loop over points, find closest one
-      double minDist2, dist2, x[3];
-      vtkIdType minId = 0;
-      for (minDist2=VTK_DOUBLE_MAX, i=0; i<numPts; i++)
+      {//find closest point
+      pt = vtkConnectivityHelper::FindClosestPoint(input, this->ClosestPoint);
+      const vtkIdType *cells = helper.GetPointCells(pt);
+      for (j=0; j < helper.GetNumberOfPointCells(pt); j++)
         {
-        input->GetPoint(i,x);
-        dist2 = vtkMath::Distance2BetweenPoints(x,this->ClosestPoint);
-        if ( dist2 < minDist2 )
-          {
-          minId = i;
-          minDist2 = dist2;
-          }
-        }
-      input->GetPointCells(minId,this->CellIds);
-      for (j=0; j < this->CellIds->GetNumberOfIds(); j++)
-        {
-        this->Wave->InsertNextId(this->CellIds->GetId(j));
+        seedCells->InsertNextId(cells[j]);
         }
       }
-    this->UpdateProgress (0.5);
 
     //mark all seeded regions
-    this->TraverseAndMark (input);
-    this->RegionSizes->InsertValue(this->RegionNumber,this->NumCellsInRegion);
-    this->UpdateProgress (0.9);
+    this->RegionSizes->InsertValue(this->RegionNumber,
+      helper.LabelSeededRegion(seedCells, this->Visited));
+    seedCells->Delete();
     }
+  this->UpdateProgress (0.7);
+
+  // Number the points used by the marked cells, in input order
+  helper.MapPoints(this->Visited, this->PointMap,
+                   this->NewScalars->GetPointer(0));
+  std::copy(this->Visited, this->Visited + numCells,
+            this->NewCellScalars->GetPointer(0));
+  this->UpdateProgress (0.9);
 
   vtkDebugMacro (<<"Extracted " << this->RegionNumber << " region(s)");
-  this->Wave->Delete();
-  this->Wave2->Delete();
 
   // Now that points and cells have been marked, traverse these lists pulling
   // everything that has been visited.
@@ -417,7 +423,6 @@ int vtkConnectivityFilter::RequestData(
   delete [] this->Visited;
   delete [] this->PointMap;
   this->PointIds->Delete();
-  this->CellIds->Delete();
   output->Squeeze();
   vtkDataArray* outScalars = 0;
   if (this->ColorRegions && (outScalars=output->GetPointData()->GetScalars()))
@@ -439,91 +444,6 @@ int vtkConnectivityFilter::RequestData(
 }
 
 
-// Mark current cell as visited and assign region number.  Note:
-// traversal occurs across shared vertices.
-//
-void vtkConnectivityFilter::TraverseAndMark (vtkDataSet *input)
-{
-  vtkIdType i, j, k, cellId, numIds, ptId, numPts, numCells;
-  vtkIdList *tmpWave;
-
-  while ( (numIds=this->Wave->GetNumberOfIds()) > 0 )
-    {
-    for ( i=0; i < numIds; i++ )
-      {
-      cellId = this->Wave->GetId(i);
-      if ( this->Visited[cellId] < 0 )
-        {
-        this->NewCellScalars->SetValue(cellId, this->RegionNumber);
-        this->Visited[cellId] = this->RegionNumber;
-        this->NumCellsInRegion++;
-        input->GetCellPoints(cellId, this->PointIds);
-
-        numPts = this->PointIds->GetNumberOfIds();
-        for (j=0; j < numPts; j++)
-          {
-          if ( this->PointMap[ptId=this->PointIds->GetId(j)] < 0 )
-            {
-            this->PointMap[ptId] = this->PointNumber++;
-            this->NewScalars->SetValue(this->PointMap[ptId],
-                                       this->RegionNumber);
-            }
-
-          input->GetPointCells(ptId,this->CellIds);
-
-          // check connectivity criterion (geometric + scalar)
-          numCells = this->CellIds->GetNumberOfIds();
-          for (k=0; k < numCells; k++)
-            {
-            cellId = this->CellIds->GetId(k);
-            if ( this->InScalars )
-              {
-              int numScalars, ii;
-              double s, range[2];
-
-              input->GetCellPoints(cellId, this->NeighborCellPointIds);
-              numScalars = this->NeighborCellPointIds->GetNumberOfIds();
-              this->CellScalars->SetNumberOfComponents(this->InScalars->GetNumberOfComponents());
-              this->CellScalars->SetNumberOfTuples(numScalars);
-              this->InScalars->GetTuples(this->NeighborCellPointIds,
-                                         this->CellScalars);
-              range[0] = VTK_DOUBLE_MAX; range[1] = -VTK_DOUBLE_MAX;
-              for (ii=0; ii < numScalars;  ii++)
-                {
-                s = this->CellScalars->GetComponent(ii,0);
-                if ( s < range[0] )
-                  {
-                  range[0] = s;
-                  }
-                if ( s > range[1] )
-                  {
-                  range[1] = s;
-                  }
-                }
-              if ( range[1] >= this->ScalarRange[0] &&
-                   range[0] <= this->ScalarRange[1] )
-                {
-                this->Wave2->InsertNextId(cellId);
-                }
-              }
-            else
-              {
-              this->Wave2->InsertNextId(cellId);
-              }
-            }//for all cells using this point
-          }//for all points of this cell
-        }//if cell not yet visited
-      }//for all cells in this wave
-
-    tmpWave = this->Wave;
-    this->Wave = this->Wave2;
-    this->Wave2 = tmpWave;
-    tmpWave->Reset();
-    } //while wave is not empty
-
-  return;
-}
-
 // Obtain the number of connected regions.
 int vtkConnectivityFilter::GetNumberOfExtractedRegions()
 {
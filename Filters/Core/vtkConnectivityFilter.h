@@ -29,6 +29,11 @@
 // your input type is vtkPolyData, you may wish to use
 // vtkPolyDataConnectivityFilter.
 //
+// The regions are found with vtkSMPTools, by a union-find over the cells
+// sharing points (see vtkConnectivityHelper). Regions and cells are
+// numbered as a traversal from the first unvisited cell would, and the
+// output points keep the order of the input points.
+//
 // The behavior of vtkConnectivityFilter can be modified by turning on the
 // boolean ivar ScalarConnectivity. If this flag is on, the connectivity
 // algorithm is modified so that cells are considered connected only if 1)
@@ -58,7 +63,6 @@
 #define VTK_EXTRACT_CLOSEST_POINT_REGION 6
 
 class vtkDataArray;
-class vtkFloatArray;
 class vtkIdList;
 class vtkIdTypeArray;
 class vtkIntArray;
@@ -172,24 +176,15 @@ protected:
   int ScalarConnectivity;
   double ScalarRange[2];
 
-  void TraverseAndMark(vtkDataSet *input);
-
 private:
   // used to support algorithm execution
-  vtkFloatArray *CellScalars;
-  vtkIdList *NeighborCellPointIds;
   vtkIdType *Visited;
   vtkIdType *PointMap;
   vtkIdTypeArray *NewScalars;
   vtkIdTypeArray *NewCellScalars;
   vtkIdType RegionNumber;
-  vtkIdType PointNumber;
-  vtkIdType NumCellsInRegion;
   vtkDataArray *InScalars;
-  vtkIdList *Wave;
-  vtkIdList *Wave2;
   vtkIdList *PointIds;
-  vtkIdList *CellIds;
 private:
   vtkConnectivityFilter(const vtkConnectivityFilter&);  // Not implemented.
   void operator=(const vtkConnectivityFilter&);  // Not implemented.
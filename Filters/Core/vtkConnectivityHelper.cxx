@@ -0,0 +1,864 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkConnectivityHelper.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkConnectivityHelper.h"
+
+#include "vtkDataSet.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkStaticCellLinksTemplate.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+// Cells and points are processed in blocks of contiguous ids, at most this
+// many, so that few unions cross blocks.
+const vtkIdType VTK_CONNECTIVITY_MAX_NUMBER_OF_BLOCKS = 128;
+const vtkIdType VTK_CONNECTIVITY_MIN_BLOCK_SIZE = 4096;
+
+vtkIdType GetBlockSize(vtkIdType num)
+{
+  vtkIdType size = (num + VTK_CONNECTIVITY_MAX_NUMBER_OF_BLOCKS - 1) /
+    VTK_CONNECTIVITY_MAX_NUMBER_OF_BLOCKS;
+  return std::max(size, VTK_CONNECTIVITY_MIN_BLOCK_SIZE);
+}
+
+//----------------------------------------------------------------------------
+// Get the points of a cell straight from the cells of vtkUnstructuredGrid
+// and vtkPolyData, and through a list of ids for the other datasets.
+class vtkCellPointsGetter
+{
+public:
+  vtkCellPointsGetter(vtkDataSet *input) :
+    Input(input),
+    Grid(vtkUnstructuredGrid::SafeDownCast(input)),
+    PolyData(vtkPolyData::SafeDownCast(input))
+  {
+  }
+
+  void operator()(vtkIdType cellId, vtkIdType &npts, vtkIdType *&pts,
+                  vtkIdList *ids) const
+  {
+    if (this->Grid)
+      {
+      this->Grid->GetCellPoints(cellId, npts, pts);
+      }
+    else if (this->PolyData)
+      {
+      this->PolyData->GetCellPoints(cellId, npts, pts);
+      }
+    else
+      {
+      this->Input->GetCellPoints(cellId, ids);
+      npts = ids->GetNumberOfIds();
+      pts = ids->GetPointer(0);
+      }
+  }
+
+private:
+  vtkDataSet *Input;
+  vtkUnstructuredGrid *Grid;
+  vtkPolyData *PolyData;
+};
+
+//----------------------------------------------------------------------------
+// Find the root of a cell, halving the path. Only called on the cells whose
+// parents the calling thread writes.
+inline vtkIdType FindRoot(vtkIdType *parents, vtkIdType cellId)
+{
+  while (parents[cellId] != cellId)
+    {
+    parents[cellId] = parents[parents[cellId]];
+    cellId = parents[cellId];
+    }
+  return cellId;
+}
+
+// Find the root of a cell without changing the forest.
+inline vtkIdType FindRootConst(const vtkIdType *parents, vtkIdType cellId)
+{
+  while (parents[cellId] != cellId)
+    {
+    cellId = parents[cellId];
+    }
+  return cellId;
+}
+
+// Join the components of two cells, the larger root under the smaller, so
+// that the root of a component is its smallest cell.
+inline void Union(vtkIdType *parents, vtkIdType *sizes, vtkIdType a,
+                  vtkIdType b)
+{
+  a = FindRoot(parents, a);
+  b = FindRoot(parents, b);
+  if (a == b)
+    {
+    return;
+    }
+  if (b < a)
+    {
+    std::swap(a, b);
+    }
+  parents[b] = a;
+  if (sizes)
+    {
+    sizes[a] += sizes[b];
+    }
+}
+
+//----------------------------------------------------------------------------
+// Shared state of the functors.
+struct vtkConnectivityState
+{
+  vtkConnectivityState(vtkDataSet *input, const unsigned char *connects,
+                       vtkStaticCellLinksTemplate<vtkIdType> *links,
+                       vtkIdType *parents, vtkIdType *sizes) :
+    CellPoints(input), Connects(connects), Links(links),
+    NumberOfCells(input->GetNumberOfCells()), Parents(parents), Sizes(sizes)
+  {
+    this->BlockSize = GetBlockSize(this->NumberOfCells);
+    this->NumberOfBlocks =
+      (this->NumberOfCells + this->BlockSize - 1) / this->BlockSize;
+  }
+
+  // Find the smallest connecting cell using a point within [begin,end), or
+  // NumberOfCells if there is none, and the smallest overall.
+  void FindSmallestCells(vtkIdType ptId, vtkIdType begin, vtkIdType end,
+                         vtkIdType &inBlock, vtkIdType &overall) const
+  {
+    vtkIdType numCells = this->Links->GetNumberOfCells(ptId);
+    const vtkIdType *cells = this->Links->GetCells(ptId);
+    inBlock = overall = this->NumberOfCells;
+    for (vtkIdType i = 0; i < numCells; ++i)
+      {
+      vtkIdType cellId = cells[i];
+      if (this->Connects && !this->Connects[cellId])
+        {
+        continue;
+        }
+      overall = std::min(overall, cellId);
+      if (cellId >= begin && cellId < end && cellId < inBlock)
+        {
+        inBlock = cellId;
+        }
+      }
+  }
+
+  vtkCellPointsGetter CellPoints;
+  const unsigned char *Connects;
+  vtkStaticCellLinksTemplate<vtkIdType> *Links;
+  vtkIdType NumberOfCells;
+  vtkIdType *Parents;
+  vtkIdType *Sizes;
+  vtkIdType BlockSize;
+  vtkIdType NumberOfBlocks;
+};
+
+//----------------------------------------------------------------------------
+// Join the connecting cells of each block sharing points, then point each
+// cell straight to the root of its block component and count the cells of
+// the components.
+class vtkUnionBlocks
+{
+public:
+  vtkUnionBlocks(const vtkConnectivityState &state) : State(state)
+  {
+  }
+
+  void operator()(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    const vtkConnectivityState &s = this->State;
+    vtkIdList *ids = this->CellIds.Local();
+    vtkIdType npts, *pts, inBlock, overall;
+    for (vtkIdType block = beginBlock; block < endBlock; ++block)
+      {
+      vtkIdType begin = block * s.BlockSize;
+      vtkIdType end = std::min(begin + s.BlockSize, s.NumberOfCells);
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+        {
+        s.Parents[cellId] = cellId;
+        s.Sizes[cellId] = 0;
+        }
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+        {
+        if (s.Connects && !s.Connects[cellId])
+          {
+          continue;
+          }
+        s.CellPoints(cellId, npts, pts, ids);
+        for (vtkIdType i = 0; i < npts; ++i)
+          {
+          s.FindSmallestCells(pts[i], begin, end, inBlock, overall);
+          if (inBlock < cellId)
+            {
+            Union(s.Parents, NULL, inBlock, cellId);
+            }
+          }
+        }
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+        {
+        vtkIdType root = FindRoot(s.Parents, cellId);
+        s.Parents[cellId] = root;
+        s.Sizes[root]++;
+        }
+      }
+  }
+
+private:
+  const vtkConnectivityState &State;
+  vtkSMPThreadLocalObject<vtkIdList> CellIds;
+};
+
+//----------------------------------------------------------------------------
+// Collect the pairs of block roots to join: at each point, the smallest
+// connecting cell of a block is joined to the smallest connecting cell of
+// the point when that is in an earlier block.
+class vtkCollectBlockUnions
+{
+public:
+  vtkCollectBlockUnions(const vtkConnectivityState &state) : State(state)
+  {
+  }
+
+  void operator()(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    const vtkConnectivityState &s = this->State;
+    vtkIdList *ids = this->CellIds.Local();
+    std::vector<vtkIdType> &pairs = this->Pairs.Local();
+    vtkIdType npts, *pts, inBlock, overall;
+    for (vtkIdType block = beginBlock; block < endBlock; ++block)
+      {
+      vtkIdType begin = block * s.BlockSize;
+      vtkIdType end = std::min(begin + s.BlockSize, s.NumberOfCells);
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+        {
+        if (s.Connects && !s.Connects[cellId])
+          {
+          continue;
+          }
+        s.CellPoints(cellId, npts, pts, ids);
+        for (vtkIdType i = 0; i < npts; ++i)
+          {
+          s.FindSmallestCells(pts[i], begin, end, inBlock, overall);
+          if (inBlock == cellId && overall < begin)
+            {
+            vtkIdType a = s.Parents[overall], b = s.Parents[cellId];
+            vtkIdType size = static_cast<vtkIdType>(pairs.size());
+            if (size == 0 || pairs[size-2] != a || pairs[size-1] != b)
+              {
+              pairs.push_back(a);
+              pairs.push_back(b);
+              }
+            }
+          }
+        }
+      }
+  }
+
+  vtkSMPThreadLocal<std::vector<vtkIdType> > Pairs;
+
+private:
+  const vtkConnectivityState &State;
+  vtkSMPThreadLocalObject<vtkIdList> CellIds;
+};
+
+//----------------------------------------------------------------------------
+// Collect the components a cell that does not connect reaches when it
+// starts a region: those of the connecting cells sharing its points whose
+// smallest cell comes later.
+class vtkCollectStartingUnions
+{
+public:
+  vtkCollectStartingUnions(const vtkConnectivityState &state) : State(state)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    const vtkConnectivityState &s = this->State;
+    vtkIdList *ids = this->CellIds.Local();
+    std::vector<vtkIdType> &pairs = this->Pairs.Local();
+    vtkIdType npts, *pts;
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+      if (s.Connects[cellId])
+        {
+        continue;
+        }
+      s.CellPoints(cellId, npts, pts, ids);
+      for (vtkIdType i = 0; i < npts; ++i)
+        {
+        vtkIdType numCells = s.Links->GetNumberOfCells(pts[i]);
+        const vtkIdType *cells = s.Links->GetCells(pts[i]);
+        for (vtkIdType j = 0; j < numCells; ++j)
+          {
+          if (!s.Connects[cells[j]])
+            {
+            continue;
+            }
+          vtkIdType root = FindRootConst(s.Parents, cells[j]);
+          vtkIdType size = static_cast<vtkIdType>(pairs.size());
+          if (root > cellId &&
+              (size == 0 || pairs[size-2] != root || pairs[size-1] != cellId))
+            {
+            pairs.push_back(root);
+            pairs.push_back(cellId);
+            }
+          }
+        }
+      }
+  }
+
+  vtkSMPThreadLocal<std::vector<vtkIdType> > Pairs;
+
+private:
+  const vtkConnectivityState &State;
+  vtkSMPThreadLocalObject<vtkIdList> CellIds;
+};
+
+//----------------------------------------------------------------------------
+// Numbering the regions takes three passes over the blocks of cells: find
+// the root of each cell and count the roots of each block, number the roots
+// from the offset of their block, then give each cell the number of its
+// root.
+class vtkFindRoots
+{
+public:
+  vtkFindRoots(const vtkConnectivityState &state, vtkIdType *cellRegions,
+               vtkIdType *blockCounts) :
+    State(state), CellRegions(cellRegions), BlockCounts(blockCounts)
+  {
+  }
+
+  void operator()(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    const vtkConnectivityState &s = this->State;
+    for (vtkIdType block = beginBlock; block < endBlock; ++block)
+      {
+      vtkIdType begin = block * s.BlockSize;
+      vtkIdType end = std::min(begin + s.BlockSize, s.NumberOfCells);
+      vtkIdType numRoots = 0;
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+        {
+        vtkIdType root = FindRootConst(s.Parents, cellId);
+        this->CellRegions[cellId] = root;
+        numRoots += (root == cellId);
+        }
+      this->BlockCounts[block] = numRoots;
+      }
+  }
+
+private:
+  const vtkConnectivityState &State;
+  vtkIdType *CellRegions;
+  vtkIdType *BlockCounts;
+};
+
+class vtkNumberRoots
+{
+public:
+  vtkNumberRoots(const vtkConnectivityState &state, vtkIdType *cellRegions,
+                 const vtkIdType *blockOffsets, vtkIdType *regionSizes) :
+    State(state), CellRegions(cellRegions), BlockOffsets(blockOffsets),
+    RegionSizes(regionSizes)
+  {
+  }
+
+  void operator()(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    const vtkConnectivityState &s = this->State;
+    for (vtkIdType block = beginBlock; block < endBlock; ++block)
+      {
+      vtkIdType begin = block * s.BlockSize;
+      vtkIdType end = std::min(begin + s.BlockSize, s.NumberOfCells);
+      vtkIdType regionId = this->BlockOffsets[block];
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+        {
+        if (s.Parents[cellId] == cellId)
+          {
+          this->RegionSizes[regionId] = s.Sizes[cellId];
+          this->CellRegions[cellId] = regionId++;
+          }
+        }
+      }
+  }
+
+private:
+  const vtkConnectivityState &State;
+  vtkIdType *CellRegions;
+  const vtkIdType *BlockOffsets;
+  vtkIdType *RegionSizes;
+};
+
+class vtkNumberCells
+{
+public:
+  vtkNumberCells(const vtkConnectivityState &state, vtkIdType *cellRegions) :
+    State(state), CellRegions(cellRegions)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    const vtkIdType *parents = this->State.Parents;
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+      // The roots were numbered, the other cells hold their root.
+      if (parents[cellId] != cellId)
+        {
+        this->CellRegions[cellId] =
+          this->CellRegions[this->CellRegions[cellId]];
+        }
+      }
+  }
+
+private:
+  const vtkConnectivityState &State;
+  vtkIdType *CellRegions;
+};
+
+//----------------------------------------------------------------------------
+// Set the cells whose root is marked to region 0, and count them.
+class vtkLabelMarkedCells
+{
+public:
+  vtkLabelMarkedCells(const vtkIdType *parents, const unsigned char *marked,
+                      vtkIdType *cellRegions) :
+    Parents(parents), Marked(marked), CellRegions(cellRegions),
+    NumberOfCells(0)
+  {
+  }
+
+  void Initialize()
+  {
+    this->Count.Local() = 0;
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdType &count = this->Count.Local();
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+      if (this->Marked[FindRootConst(this->Parents, cellId)])
+        {
+        this->CellRegions[cellId] = 0;
+        count++;
+        }
+      else
+        {
+        this->CellRegions[cellId] = -1;
+        }
+      }
+  }
+
+  void Reduce()
+  {
+    vtkSMPThreadLocal<vtkIdType>::iterator itr = this->Count.begin();
+    for (; itr != this->Count.end(); ++itr)
+      {
+      this->NumberOfCells += *itr;
+      }
+  }
+
+  const vtkIdType *Parents;
+  const unsigned char *Marked;
+  vtkIdType *CellRegions;
+  vtkIdType NumberOfCells;
+  vtkSMPThreadLocal<vtkIdType> Count;
+};
+
+//----------------------------------------------------------------------------
+// Mapping the points takes two passes over the blocks of points: find the
+// smallest region using each point and count the used points of each block,
+// then number the used points from the offset of their block.
+class vtkFindPointRegions
+{
+public:
+  vtkFindPointRegions(vtkStaticCellLinksTemplate<vtkIdType> *links,
+                      const vtkIdType *cellRegions, vtkIdType *pointMap,
+                      vtkIdType numPts, vtkIdType blockSize,
+                      vtkIdType *blockCounts) :
+    Links(links), CellRegions(cellRegions), PointMap(pointMap),
+    NumberOfPoints(numPts), BlockSize(blockSize), BlockCounts(blockCounts)
+  {
+  }
+
+  void operator()(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    for (vtkIdType block = beginBlock; block < endBlock; ++block)
+      {
+      vtkIdType begin = block * this->BlockSize;
+      vtkIdType end = std::min(begin + this->BlockSize, this->NumberOfPoints);
+      vtkIdType numUsed = 0;
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+        {
+        vtkIdType numCells = this->Links->GetNumberOfCells(ptId);
+        const vtkIdType *cells = this->Links->GetCells(ptId);
+        vtkIdType regionId = -1;
+        for (vtkIdType i = 0; i < numCells; ++i)
+          {
+          vtkIdType cellRegion = this->CellRegions[cells[i]];
+          if (cellRegion >= 0 && (regionId < 0 || cellRegion < regionId))
+            {
+            regionId = cellRegion;
+            }
+          }
+        this->PointMap[ptId] = regionId;
+        numUsed += (regionId >= 0);
+        }
+      this->BlockCounts[block] = numUsed;
+      }
+  }
+
+private:
+  vtkStaticCellLinksTemplate<vtkIdType> *Links;
+  const vtkIdType *CellRegions;
+  vtkIdType *PointMap;
+  vtkIdType NumberOfPoints;
+  vtkIdType BlockSize;
+  vtkIdType *BlockCounts;
+};
+
+class vtkNumberPoints
+{
+public:
+  vtkNumberPoints(vtkIdType *pointMap, vtkIdType *pointRegions,
+                  vtkIdType numPts, vtkIdType blockSize,
+                  const vtkIdType *blockOffsets) :
+    PointMap(pointMap), PointRegions(pointRegions), NumberOfPoints(numPts),
+    BlockSize(blockSize), BlockOffsets(blockOffsets)
+  {
+  }
+
+  void operator()(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    for (vtkIdType block = beginBlock; block < endBlock; ++block)
+      {
+      vtkIdType begin = block * this->BlockSize;
+      vtkIdType end = std::min(begin + this->BlockSize, this->NumberOfPoints);
+      vtkIdType newPtId = this->BlockOffsets[block];
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+        {
+        if (this->PointMap[ptId] >= 0)
+          {
+          this->PointRegions[newPtId] = this->PointMap[ptId];
+          this->PointMap[ptId] = newPtId++;
+          }
+        }
+      }
+  }
+
+private:
+  vtkIdType *PointMap;
+  vtkIdType *PointRegions;
+  vtkIdType NumberOfPoints;
+  vtkIdType BlockSize;
+  const vtkIdType *BlockOffsets;
+};
+
+//----------------------------------------------------------------------------
+// Find the closest point in each thread, then the closest of those.
+class vtkFindClosestPoint
+{
+public:
+  struct Closest
+  {
+    double Distance2;
+    vtkIdType Id;
+  };
+
+  vtkFindClosestPoint(vtkDataSet *input, const double x[3]) : Input(input),
+                                                              ClosestId(0)
+  {
+    this->X[0] = x[0];
+    this->X[1] = x[1];
+    this->X[2] = x[2];
+  }
+
+  void Initialize()
+  {
+    Closest &closest = this->LocalClosest.Local();
+    closest.Distance2 = VTK_DOUBLE_MAX;
+    closest.Id = -1;
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    Closest &closest = this->LocalClosest.Local();
+    double x[3];
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+      this->Input->GetPoint(ptId, x);
+      double dist2 = vtkMath::Distance2BetweenPoints(x, this->X);
+      if (dist2 < closest.Distance2)
+        {
+        closest.Distance2 = dist2;
+        closest.Id = ptId;
+        }
+      }
+  }
+
+  void Reduce()
+  {
+    double minDist2 = VTK_DOUBLE_MAX;
+    vtkSMPThreadLocal<Closest>::iterator itr = this->LocalClosest.begin();
+    for (; itr != this->LocalClosest.end(); ++itr)
+      {
+      if ((*itr).Id >= 0 && ((*itr).Distance2 < minDist2 ||
+          ((*itr).Distance2 == minDist2 && (*itr).Id < this->ClosestId)))
+        {
+        minDist2 = (*itr).Distance2;
+        this->ClosestId = (*itr).Id;
+        }
+      }
+  }
+
+  vtkDataSet *Input;
+  double X[3];
+  vtkIdType ClosestId;
+  vtkSMPThreadLocal<Closest> LocalClosest;
+};
+
+//----------------------------------------------------------------------------
+// Exclusive prefix sum of the block counts, returning the total.
+vtkIdType ComputeOffsets(std::vector<vtkIdType> &counts)
+{
+  vtkIdType total = 0;
+  for (size_t i = 0; i < counts.size(); ++i)
+    {
+    vtkIdType count = counts[i];
+    counts[i] = total;
+    total += count;
+    }
+  return total;
+}
+
+} // end anonymous namespace
+
+//----------------------------------------------------------------------------
+vtkConnectivityHelper::vtkConnectivityHelper() :
+  Input(NULL), Connects(NULL), Links(NULL), NumberOfCells(0), Parents(NULL),
+  Sizes(NULL)
+{
+}
+
+//----------------------------------------------------------------------------
+vtkConnectivityHelper::~vtkConnectivityHelper()
+{
+  delete this->Links;
+  delete [] this->Parents;
+  delete [] this->Sizes;
+}
+
+//----------------------------------------------------------------------------
+void vtkConnectivityHelper::BuildComponents(vtkDataSet *input,
+                                            const unsigned char *connects)
+{
+  delete this->Links;
+  delete [] this->Parents;
+  delete [] this->Sizes;
+
+  this->Input = input;
+  this->Connects = connects;
+  this->NumberOfCells = input->GetNumberOfCells();
+  this->Links = new vtkStaticCellLinksTemplate<vtkIdType>;
+  this->Links->BuildLinks(input);
+  this->Parents = new vtkIdType[this->NumberOfCells];
+  this->Sizes = new vtkIdType[this->NumberOfCells];
+
+  vtkConnectivityState state(input, connects, this->Links, this->Parents,
+                             this->Sizes);
+  vtkUnionBlocks unionBlocks(state);
+  vtkSMPTools::For(0, state.NumberOfBlocks, unionBlocks);
+
+  // Few components cross blocks in meshes with some locality, so they are
+  // joined serially.
+  vtkCollectBlockUnions blockUnions(state);
+  vtkSMPTools::For(0, state.NumberOfBlocks, blockUnions);
+  vtkSMPThreadLocal<std::vector<vtkIdType> >::iterator itr;
+  for (itr = blockUnions.Pairs.begin(); itr != blockUnions.Pairs.end(); ++itr)
+    {
+    const std::vector<vtkIdType> &pairs = *itr;
+    for (size_t i = 0; i < pairs.size(); i += 2)
+      {
+      Union(this->Parents, this->Sizes, pairs[i], pairs[i+1]);
+      }
+    }
+  // Point the joined block roots straight to their roots.
+  for (itr = blockUnions.Pairs.begin(); itr != blockUnions.Pairs.end(); ++itr)
+    {
+    const std::vector<vtkIdType> &pairs = *itr;
+    for (size_t i = 0; i < pairs.size(); ++i)
+      {
+      this->Parents[pairs[i]] = FindRoot(this->Parents, pairs[i]);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkConnectivityHelper::LabelAllRegions(vtkIdType *cellRegions,
+                                                 vtkIdTypeArray *regionSizes)
+{
+  vtkConnectivityState state(this->Input, this->Connects, this->Links,
+                             this->Parents, this->Sizes);
+
+  // A cell that does not connect starts its own region, reaching the
+  // components sharing its points that have not been visited yet, i.e.
+  // whose smallest cell comes later and that no earlier such cell reached.
+  if (this->Connects)
+    {
+    vtkCollectStartingUnions startingUnions(state);
+    vtkSMPTools::For(0, this->NumberOfCells, startingUnions);
+    vtkSMPThreadLocal<std::vector<vtkIdType> >::iterator itr;
+    for (itr = startingUnions.Pairs.begin();
+         itr != startingUnions.Pairs.end(); ++itr)
+      {
+      const std::vector<vtkIdType> &pairs = *itr;
+      for (size_t i = 0; i < pairs.size(); i += 2)
+        {
+        vtkIdType root = pairs[i], cellId = pairs[i+1];
+        if (this->Parents[root] == root || cellId < this->Parents[root])
+          {
+          this->Parents[root] = cellId;
+          }
+        }
+      }
+    for (itr = startingUnions.Pairs.begin();
+         itr != startingUnions.Pairs.end(); ++itr)
+      {
+      const std::vector<vtkIdType> &pairs = *itr;
+      for (size_t i = 0; i < pairs.size(); i += 2)
+        {
+        vtkIdType root = pairs[i];
+        this->Sizes[this->Parents[root]] += this->Sizes[root];
+        this->Sizes[root] = 0;
+        }
+      }
+    }
+
+  std::vector<vtkIdType> blockOffsets(state.NumberOfBlocks);
+  vtkFindRoots findRoots(state, cellRegions, &blockOffsets[0]);
+  vtkSMPTools::For(0, state.NumberOfBlocks, findRoots);
+  vtkIdType numRegions = ComputeOffsets(blockOffsets);
+
+  regionSizes->SetNumberOfTuples(numRegions);
+  vtkNumberRoots numberRoots(state, cellRegions, &blockOffsets[0],
+                             regionSizes->GetPointer(0));
+  vtkSMPTools::For(0, state.NumberOfBlocks, numberRoots);
+  vtkNumberCells numberCells(state, cellRegions);
+  vtkSMPTools::For(0, this->NumberOfCells, numberCells);
+
+  vtkIdType largestRegionId = 0;
+  const vtkIdType *sizes = regionSizes->GetPointer(0);
+  for (vtkIdType regionId = 1; regionId < numRegions; ++regionId)
+    {
+    if (sizes[regionId] > sizes[largestRegionId])
+      {
+      largestRegionId = regionId;
+      }
+    }
+  return largestRegionId;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkConnectivityHelper::LabelSeededRegion(vtkIdList *seedCells,
+                                                   vtkIdType *cellRegions)
+{
+  // Mark the roots of the components the seeds reach. A seed that does not
+  // connect still reaches the components sharing its points.
+  std::vector<unsigned char> marked(this->NumberOfCells, 0);
+  vtkCellPointsGetter cellPoints(this->Input);
+  vtkNew<vtkIdList> ids;
+  vtkIdType npts, *pts;
+  for (vtkIdType i = 0; i < seedCells->GetNumberOfIds(); ++i)
+    {
+    vtkIdType seedId = seedCells->GetId(i);
+    if (seedId < 0 || seedId >= this->NumberOfCells)
+      {
+      continue;
+      }
+    marked[FindRoot(this->Parents, seedId)] = 1;
+    if (!this->Connects || this->Connects[seedId])
+      {
+      continue;
+      }
+    cellPoints(seedId, npts, pts, ids.GetPointer());
+    for (vtkIdType j = 0; j < npts; ++j)
+      {
+      vtkIdType numCells = this->Links->GetNumberOfCells(pts[j]);
+      const vtkIdType *cells = this->Links->GetCells(pts[j]);
+      for (vtkIdType k = 0; k < numCells; ++k)
+        {
+        if (this->Connects[cells[k]])
+          {
+          marked[FindRoot(this->Parents, cells[k])] = 1;
+          }
+        }
+      }
+    }
+
+  vtkLabelMarkedCells labelCells(this->Parents, &marked[0], cellRegions);
+  vtkSMPTools::For(0, this->NumberOfCells, labelCells);
+  return labelCells.NumberOfCells;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkConnectivityHelper::MapPoints(const vtkIdType *cellRegions,
+                                           vtkIdType *pointMap,
+                                           vtkIdType *pointRegions)
+{
+  vtkIdType numPts = this->Input->GetNumberOfPoints();
+  vtkIdType blockSize = GetBlockSize(numPts);
+  vtkIdType numBlocks = (numPts + blockSize - 1) / blockSize;
+  std::vector<vtkIdType> blockOffsets(numBlocks);
+
+  vtkFindPointRegions findRegions(this->Links, cellRegions, pointMap, numPts,
+                                  blockSize, &blockOffsets[0]);
+  vtkSMPTools::For(0, numBlocks, findRegions);
+  vtkIdType numUsed = ComputeOffsets(blockOffsets);
+  vtkNumberPoints numberPoints(pointMap, pointRegions, numPts, blockSize,
+                               &blockOffsets[0]);
+  vtkSMPTools::For(0, numBlocks, numberPoints);
+  return numUsed;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkConnectivityHelper::GetNumberOfPointCells(vtkIdType ptId)
+{
+  return this->Links->GetNumberOfCells(ptId);
+}
+
+//----------------------------------------------------------------------------
+const vtkIdType *vtkConnectivityHelper::GetPointCells(vtkIdType ptId)
+{
+  return this->Links->GetCells(ptId);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkConnectivityHelper::FindClosestPoint(vtkDataSet *input,
+                                                  const double x[3])
+{
+  vtkFindClosestPoint find(input, x);
+  vtkSMPTools::For(0, input->GetNumberOfPoints(), find);
+  return find.ClosestId;
+}
@@ -0,0 +1,101 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkConnectivityHelper.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkConnectivityHelper - A utility class used by the connectivity filters
+// .SECTION Description
+// vtkConnectivityHelper finds the regions of cells connected through shared
+// points in parallel, for vtkConnectivityFilter and
+// vtkPolyDataConnectivityFilter. Blocks of cells are joined with a
+// union-find in parallel, each thread only writing the parents of the cells
+// of its blocks, and the components joined across blocks are then merged.
+// The root of a component is its smallest cell, so the regions are numbered
+// in the order the filters have always visited them.
+//
+// Cells can be marked as not connecting, as with scalar connectivity: such
+// a cell is not reached from the cells sharing its points, but reaches them
+// when it starts a region, either because it is the smallest unvisited cell
+// or because it is a seed.
+// .SECTION See Also
+// vtkConnectivityFilter vtkPolyDataConnectivityFilter
+
+#ifndef vtkConnectivityHelper_h
+#define vtkConnectivityHelper_h
+
+#include "vtkFiltersCoreModule.h" // For export macro
+#include "vtkType.h" // For vtkIdType
+
+class vtkDataSet;
+class vtkIdList;
+class vtkIdTypeArray;
+template <typename TIds> class vtkStaticCellLinksTemplate;
+
+class VTKFILTERSCORE_EXPORT vtkConnectivityHelper
+{
+public:
+  vtkConnectivityHelper();
+  ~vtkConnectivityHelper();
+
+  // Description:
+  // Find the connected components of the cells of input. If connects is not
+  // NULL, only the cells with a nonzero value are reached from the cells
+  // sharing their points. The input must be safe to query from several
+  // threads, i.e. GetCellPoints() has been called once.
+  void BuildComponents(vtkDataSet *input, const unsigned char *connects);
+
+  // Description:
+  // Number the regions of all the cells by their smallest cell: set the
+  // region of each cell in cellRegions, and the number of cells of each
+  // region in regionSizes. Return the first largest region.
+  vtkIdType LabelAllRegions(vtkIdType *cellRegions,
+                            vtkIdTypeArray *regionSizes);
+
+  // Description:
+  // Set the cells of the region grown from the given seed cells to 0 in
+  // cellRegions, and the others to -1. Return the number of cells in the
+  // region.
+  vtkIdType LabelSeededRegion(vtkIdList *seedCells, vtkIdType *cellRegions);
+
+  // Description:
+  // Number the points used by the cells of a region (a nonnegative value in
+  // cellRegions) in increasing order of their ids. Set the new id of each
+  // point in pointMap, -1 for unused points, and the smallest region of the
+  // cells using the point in pointRegions, at its new id. Return the number
+  // of points used.
+  vtkIdType MapPoints(const vtkIdType *cellRegions, vtkIdType *pointMap,
+                      vtkIdType *pointRegions);
+
+  // Description:
+  // Get the cells using a point, once the components are built.
+  vtkIdType GetNumberOfPointCells(vtkIdType ptId);
+  const vtkIdType *GetPointCells(vtkIdType ptId);
+
+  // Description:
+  // Return the id of the point of input closest to x, the smallest one if
+  // several are as close.
+  static vtkIdType FindClosestPoint(vtkDataSet *input, const double x[3]);
+
+private:
+  vtkDataSet *Input;
+  const unsigned char *Connects;
+  vtkStaticCellLinksTemplate<vtkIdType> *Links;
+  vtkIdType NumberOfCells;
+  vtkIdType *Parents; // union-find forest of the cells
+  vtkIdType *Sizes; // number of cells in the component of each root
+
+  vtkConnectivityHelper(const vtkConnectivityHelper&);  // Not implemented.
+  void operator=(const vtkConnectivityHelper&);  // Not implemented.
+};
+
+#endif
+// VTK-HeaderTest-Exclude: vtkConnectivityHelper.h
@@ -35,7 +35,7 @@
 #include "vtkPolyDataNormals.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkRectilinearSynchronizedTemplates.h"
-#include "vtkSpanSpace.h"
+#include "vtkScalarTree.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGrid.h"
 #include "vtkSynchronizedTemplates2D.h"
@@ -415,13 +415,10 @@ int vtkContourFilter::RequestData(
     cgrid->SetOutputPointsPrecision(this->OutputPointsPrecision);
     cgrid->SetGenerateTriangles(this->GenerateTriangles);
     cgrid->SetUseScalarTree(this->UseScalarTree);
-    if ( this->UseScalarTree ) //special treatment to reuse it
+    // Without a scalar tree of our own, vtkContourGrid uses the one cached
+    // on the input, which outlives the internal filter.
+    if ( this->UseScalarTree && this->ScalarTree )
       {
-      if ( this->ScalarTree == NULL )
-        {
-        this->ScalarTree = vtkSpanSpace::New();
-        }
-      this->ScalarTree->SetDataSet(input);
       cgrid->SetScalarTree(this->ScalarTree);
       }
     if ( this->Locator )
@@ -517,9 +514,26 @@ int vtkContourFilter::RequestData(
     outCd->CopyAllocate(inCd,estimatedSize,estimatedSize);
 
     vtkContourHelper helper(this->Locator, newVerts, newLines, newPolys,inPd, inCd, outPd,outCd, estimatedSize, this->GenerateTriangles!=0);
-    // If enabled, build a scalar tree to accelerate search
+    // If enabled, build a scalar tree to accelerate search. Without one
+    // specified, use the tree cached on the input, unless it is busy.
     //
-    if ( !this->UseScalarTree )
+    vtkScalarTree *scalarTree = NULL;
+    vtkScalarTree *cachedTree = NULL;
+    if ( this->UseScalarTree )
+      {
+      scalarTree = this->ScalarTree;
+      if ( scalarTree )
+        {
+        scalarTree->SetDataSet(input);
+        scalarTree->SetScalars(inScalars);
+        }
+      else
+        {
+        scalarTree = cachedTree =
+          vtkScalarTree::GetCachedTree(input, inScalars);
+        }
+      }
+    if ( !scalarTree )
       {
       vtkGenericCell *cell = vtkGenericCell::New();
       // Three passes over the cells to process lower dimensional cells first.
@@ -596,13 +610,14 @@ int vtkContourFilter::RequestData(
       //
       for (i=0; i < numContours; i++)
         {
-        for ( this->ScalarTree->InitTraversal(values[i]);
-              (cell=this->ScalarTree->GetNextCell(cellId,cellPts,cellScalars)) != NULL; )
+        for ( scalarTree->InitTraversal(values[i]);
+              (cell=scalarTree->GetNextCell(cellId,cellPts,cellScalars)) != NULL; )
           {
           helper.Contour(cell,values[i],cellScalars,cellId);
           } //for all cells
         } //for all contour values
       } //using scalar tree
+    vtkScalarTree::ReleaseCachedTree(cachedTree);
 
     vtkDebugMacro(<<"Created: "
                   << newPts->GetNumberOfPoints() << " points, "
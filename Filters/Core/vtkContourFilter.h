@@ -120,7 +120,9 @@ public:
   vtkBooleanMacro(UseScalarTree,int);
 
   // Description:
-  // Enable the use of a scalar tree to accelerate contour extraction.
+  // Specify the instance of vtkScalarTree to use. If not specified and
+  // UseScalarTree is enabled, then the tree cached on the input (see
+  // vtkScalarTree::GetCachedTree()) is used.
   virtual void SetScalarTree(vtkScalarTree*);
   vtkGetObjectMacro(ScalarTree,vtkScalarTree);
 
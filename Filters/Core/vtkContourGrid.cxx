@@ -28,7 +28,7 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkPolyDataNormals.h"
-#include "vtkSimpleScalarTree.h"
+#include "vtkScalarTree.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkUnstructuredGridBase.h"
@@ -392,17 +392,24 @@ int vtkContourGrid::RequestData(
     return 1;
     }
 
-  // Create scalar tree if necessary and if requested
+  // Use the scalar tree if requested. Without one specified, use the tree
+  // cached on the input so that it is built once for all the executions
+  // with different contour values. Visit all cells if it is busy.
   int useScalarTree = this->GetUseScalarTree();
   vtkScalarTree *scalarTree = this->ScalarTree;
+  vtkScalarTree *cachedTree = NULL;
   if ( useScalarTree )
     {
     if ( scalarTree == NULL )
       {
-      scalarTree = vtkSimpleScalarTree::New();
+      scalarTree = cachedTree = vtkScalarTree::GetCachedTree(input, inScalars);
+      useScalarTree = (scalarTree != NULL);
+      }
+    else
+      {
+      scalarTree->SetDataSet(input);
+      scalarTree->SetScalars(inScalars);
       }
-    scalarTree->SetDataSet(input);
-    scalarTree->SetScalars(inScalars);
     }
 
   switch (inScalars->GetDataType())
@@ -413,8 +420,10 @@ int vtkContourGrid::RequestData(
             this->GenerateTriangles != 0));
     default:
       vtkErrorMacro(<< "Execute: Unknown ScalarType");
+      vtkScalarTree::ReleaseCachedTree(cachedTree);
       return 1;
     }
+  vtkScalarTree::ReleaseCachedTree(cachedTree);
 
   if(this->ComputeNormals)
     {
@@ -117,7 +117,9 @@ public:
 
   // Description:
   // Specify the instance of vtkScalarTree to use. If not specified
-  // and UseScalarTree is enabled, then a vtkSimpleScalarTree will be used.
+  // and UseScalarTree is enabled, then the tree cached on the input (see
+  // vtkScalarTree::GetCachedTree()) is used, and reused by the following
+  // executions until the input scalars are modified.
   void SetScalarTree(vtkScalarTree *sTree);
   vtkGetObjectMacro(ScalarTree,vtkScalarTree);
 
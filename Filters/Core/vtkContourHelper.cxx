@@ -81,6 +81,9 @@ void vtkContourHelper::Contour(vtkCell* cell, double value, vtkDataArray *cellSc
     {
     this->PolyBuilder.Reset();
 
+    // Cell data of polys follows that of the verts and lines.
+    vtkIdType offset =
+      this->Verts->GetNumberOfCells() + this->Lines->GetNumberOfCells();
     vtkIdType cellSize;
     vtkIdType* cellVerts;
     while(this->Tris->GetNextCell(cellSize,cellVerts))
@@ -91,7 +94,8 @@ void vtkContourHelper::Contour(vtkCell* cell, double value, vtkDataArray *cellSc
         }
       else //for whatever reason, the cell contouring is already outputing polys
         {
-        vtkIdType outCellId = this->Polys->InsertNextCell(cellSize, cellVerts);
+        vtkIdType outCellId =
+          offset + this->Polys->InsertNextCell(cellSize, cellVerts);
         this->OutCd->CopyData(this->InCd, cellId, outCellId);
         }
       }
@@ -103,7 +107,7 @@ void vtkContourHelper::Contour(vtkCell* cell, double value, vtkDataArray *cellSc
       vtkIdList* poly = this->PolyCollection->GetItem(polyId);
       if(poly->GetNumberOfIds()!=0)
         {
-        vtkIdType outCellId = this->Polys->InsertNextCell(poly);
+        vtkIdType outCellId = offset + this->Polys->InsertNextCell(poly);
         this->OutCd->CopyData(this->InCd, cellId, outCellId);
         }
       poly->Delete();
@@ -20,7 +20,6 @@
 #include "vtkContourValues.h"
 #include "vtkDataSet.h"
 #include "vtkDoubleArray.h"
-#include "vtkDataArrayIteratorMacro.h"
 #include "vtkFloatArray.h"
 #include "vtkGenericCell.h"
 #include "vtkGridSynchronizedTemplates3D.h"
@@ -33,6 +32,8 @@
 #include "vtkObjectFactory.h"
 #include "vtkPlane.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPointSet.h"
 #include "vtkPolyData.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkRectilinearSynchronizedTemplates.h"
@@ -200,18 +201,26 @@ void vtkCutter::StructuredPointsCutter(vtkDataSet *dataSetInput,
 }
 
 namespace {
-template<typename Iterator>
-void ExecuteFunction(vtkImplicitFunction* CutFunction, Iterator begin, Iterator end, float *output)
-  {
-  for (Iterator input = begin; input < end; std::advance(input,3), std::advance(output,1))
+// Evaluate the cut function at all the points of the input. Explicit points
+// are handed to the implicit function in one batch.
+void vtkCutterEvaluateFunction(vtkImplicitFunction *cutFunction,
+                               vtkDataSet *input, vtkDataArray *cutScalars)
+{
+  vtkPointSet *pointSet = vtkPointSet::SafeDownCast(input);
+  if ( pointSet && pointSet->GetPoints() )
+    {
+    cutFunction->FunctionValue(pointSet->GetPoints()->GetData(), cutScalars);
+    return;
+    }
+
+  vtkIdType numPts = input->GetNumberOfPoints();
+  cutScalars->SetNumberOfComponents(1);
+  cutScalars->SetNumberOfTuples(numPts);
+  for ( vtkIdType i=0; i < numPts; i++ )
     {
-    double in[3];
-    in[0] = static_cast<double>(input[0]);
-    in[1] = static_cast<double>(input[1]);
-    in[2] = static_cast<double>(input[2]);
-    *output = static_cast<float>(CutFunction->FunctionValue(in));
+    cutScalars->SetComponent(i,0,cutFunction->FunctionValue(input->GetPoint(i)));
     }
-  }
+}
 }
 
 //----------------------------------------------------------------------------
@@ -241,12 +250,7 @@ void vtkCutter::StructuredGridCutter(vtkDataSet *dataSetInput,
     contourData->GetPointData()->AddArray(cutScalars);
     }
 
-  float* ptrCutScalars = cutScalars->WritePointer(0, numPts);
-  vtkDataArray* dataArrayInput = input->GetPoints()->GetData();
-  switch(dataArrayInput->GetDataType())
-    {
-    vtkDataArrayIteratorMacro(dataArrayInput,ExecuteFunction(this->CutFunction,vtkDABegin,vtkDAEnd,ptrCutScalars););
-    }
+  this->CutFunction->FunctionValue(input->GetPoints()->GetData(), cutScalars);
   int numContours = this->GetNumberOfContours();
 
   this->GridSynchronizedTemplates->SetDebug(this->GetDebug());
@@ -557,11 +561,7 @@ void vtkCutter::DataSetCutter(vtkDataSet *input, vtkPolyData *output)
 
   // Loop over all points evaluating scalar function at each point
   //
-  for ( i=0; i < numPts; i++ )
-    {
-    s = this->CutFunction->FunctionValue(input->GetPoint(i));
-    cutScalars->SetComponent(i,0,s);
-    }
+  vtkCutterEvaluateFunction(this->CutFunction, input, cutScalars);
 
   // Compute some information for progress methods
   //
@@ -724,7 +724,7 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
   vtkCellArray *newVerts, *newLines, *newPolys;
   vtkPoints *newPoints;
   vtkDoubleArray *cutScalars;
-  double value, s;
+  double value;
   vtkIdType estimatedSize, numCells=input->GetNumberOfCells();
   vtkIdType numPts=input->GetNumberOfPoints();
   int numCellPts;
@@ -807,11 +807,7 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
 
   // Loop over all points evaluating scalar function at each point
   //
-  for ( i=0; i < numPts; i++ )
-    {
-    s = this->CutFunction->FunctionValue(input->GetPoint(i));
-    cutScalars->SetComponent(i,0,s);
-    }
+  vtkCutterEvaluateFunction(this->CutFunction, input, cutScalars);
 
   // Compute some information for progress methods
   //
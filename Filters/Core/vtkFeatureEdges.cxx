@@ -14,6 +14,7 @@
 =========================================================================*/
 #include "vtkFeatureEdges.h"
 
+#include "vtkArrayListTemplate.h"
 #include "vtkFloatArray.h"
 #include "vtkMath.h"
 #include "vtkMergePoints.h"
@@ -22,6 +23,7 @@
 #include "vtkObjectFactory.h"
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTriangleStrip.h"
 #include "vtkUnsignedCharArray.h"
@@ -30,8 +32,304 @@
 #include "vtkPointData.h"
 #include "vtkIncrementalPointLocator.h"
 
+#include <vector>
+
 vtkStandardNewMacro(vtkFeatureEdges);
 
+namespace
+{
+// Types of the extracted edges, and the scalars they are colored with.
+enum
+{
+  VTK_FEATURE_EDGES_NONE = -1,
+  VTK_FEATURE_EDGES_BOUNDARY = 0,
+  VTK_FEATURE_EDGES_NON_MANIFOLD = 1,
+  VTK_FEATURE_EDGES_FEATURE = 2,
+  VTK_FEATURE_EDGES_MANIFOLD = 3
+};
+
+const float vtkFeatureEdgesScalars[4] =
+  { 0.0f, 0.222222f, 0.444444f, 0.666667f };
+
+// An edge of a polygon. Sorting the edges by their end points, smallest
+// first, brings the uses of each edge of the mesh together, ordered by
+// cell.
+struct vtkFeatureEdgesEdge
+{
+  vtkIdType V0;
+  vtkIdType V1;
+  vtkIdType CellId;
+  vtkIdType EdgeId; // i-th edge of the mesh, in the order of the polygons
+
+  bool operator<(const vtkFeatureEdgesEdge &other) const
+    {
+    if (this->V0 != other.V0)
+      {
+      return this->V0 < other.V0;
+      }
+    if (this->V1 != other.V1)
+      {
+      return this->V1 < other.V1;
+      }
+    if (this->CellId != other.CellId)
+      {
+      return this->CellId < other.CellId;
+      }
+    return this->EdgeId < other.EdgeId;
+    }
+
+  bool SameEdge(const vtkFeatureEdgesEdge &other) const
+    {
+    return this->V0 == other.V0 && this->V1 == other.V1;
+    }
+};
+
+// The polygons of the mesh, with the location of each one in the
+// connectivity array and the id of its first edge.
+struct vtkFeatureEdgesPolys
+{
+  const vtkIdType *Connectivity;
+  std::vector<vtkIdType> Locations;
+  std::vector<vtkIdType> EdgeOffsets;
+};
+
+// Compute the normal of each polygon.
+struct vtkFeatureEdgesComputeNormals
+{
+  vtkPoints *Points;
+  const vtkFeatureEdgesPolys *Polys;
+  float *Normals;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+    {
+    double n[3];
+    for ( ; cellId < endCellId; ++cellId)
+      {
+      const vtkIdType *cell =
+        this->Polys->Connectivity + this->Polys->Locations[cellId];
+      vtkPolygon::ComputeNormal(this->Points, static_cast<int>(cell[0]),
+                                const_cast<vtkIdType*>(cell + 1), n);
+      float *normal = this->Normals + 3 * cellId;
+      normal[0] = static_cast<float>(n[0]);
+      normal[1] = static_cast<float>(n[1]);
+      normal[2] = static_cast<float>(n[2]);
+      }
+    }
+};
+
+// Make the edges of each polygon.
+struct vtkFeatureEdgesMakeEdges
+{
+  const vtkFeatureEdgesPolys *Polys;
+  vtkFeatureEdgesEdge *Edges;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+    {
+    for ( ; cellId < endCellId; ++cellId)
+      {
+      const vtkIdType *cell =
+        this->Polys->Connectivity + this->Polys->Locations[cellId];
+      vtkIdType npts = cell[0];
+      const vtkIdType *pts = cell + 1;
+      vtkIdType edgeId = this->Polys->EdgeOffsets[cellId];
+      for (vtkIdType i = 0; i < npts; ++i, ++edgeId)
+        {
+        vtkIdType p1 = pts[i];
+        vtkIdType p2 = pts[(i + 1) % npts];
+        vtkFeatureEdgesEdge &edge = this->Edges[edgeId];
+        edge.V0 = p1 < p2 ? p1 : p2;
+        edge.V1 = p1 < p2 ? p2 : p1;
+        edge.CellId = cellId;
+        edge.EdgeId = edgeId;
+        }
+      }
+    }
+};
+
+// Classify the uses of each edge of the mesh by the number of other cells
+// using the edge. A range of sorted edges may start in the middle of the
+// uses of an edge: those are classified by the range where they begin.
+struct vtkFeatureEdgesClassify
+{
+  const vtkFeatureEdgesEdge *Edges;
+  vtkIdType NumberOfEdges;
+  const float *Normals;
+  const unsigned char *Ghosts;
+  double CosAngle;
+  int BoundaryEdges;
+  int NonManifoldEdges;
+  int FeatureEdges;
+  int ManifoldEdges;
+  signed char *Types; // per edge id
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    const vtkFeatureEdgesEdge *edges = this->Edges;
+    while (begin > 0 && begin < end && edges[begin].SameEdge(edges[begin-1]))
+      {
+      ++begin;
+      }
+    while (begin < end)
+      {
+      // The uses of this edge are [begin,last), the ones by the first cell
+      // using it are [begin,second).
+      vtkIdType cellId = edges[begin].CellId;
+      vtkIdType second = begin + 1;
+      while (second < this->NumberOfEdges &&
+             edges[second].SameEdge(edges[begin]) &&
+             edges[second].CellId == cellId)
+        {
+        ++second;
+        }
+      vtkIdType numNei = 0;
+      vtkIdType last = second;
+      for ( ; last < this->NumberOfEdges &&
+              edges[last].SameEdge(edges[begin]); ++last)
+        {
+        if (edges[last].CellId != edges[last-1].CellId)
+          {
+          ++numNei;
+          }
+        }
+
+      // Only the first cell using an edge produces it, except boundary
+      // edges which have a single cell.
+      signed char type = VTK_FEATURE_EDGES_NONE;
+      if (numNei < 1)
+        {
+        if (this->BoundaryEdges)
+          {
+          type = VTK_FEATURE_EDGES_BOUNDARY;
+          }
+        }
+      else if (numNei > 1)
+        {
+        if (this->NonManifoldEdges)
+          {
+          type = VTK_FEATURE_EDGES_NON_MANIFOLD;
+          }
+        }
+      else if (this->FeatureEdges)
+        {
+        const float *n1 = this->Normals + 3 * cellId;
+        const float *n2 = this->Normals + 3 * edges[second].CellId;
+        double dot = static_cast<double>(n1[0]) * n2[0] +
+          static_cast<double>(n1[1]) * n2[1] +
+          static_cast<double>(n1[2]) * n2[2];
+        if (dot <= this->CosAngle)
+          {
+          type = VTK_FEATURE_EDGES_FEATURE;
+          }
+        }
+      else if (this->ManifoldEdges)
+        {
+        type = VTK_FEATURE_EDGES_MANIFOLD;
+        }
+
+      if (this->Ghosts &&
+          this->Ghosts[cellId] & vtkDataSetAttributes::DUPLICATECELL)
+        {
+        type = VTK_FEATURE_EDGES_NONE;
+        }
+      for (vtkIdType i = begin; i < second; ++i)
+        {
+        this->Types[edges[i].EdgeId] = type;
+        }
+      for (vtkIdType i = second; i < last; ++i)
+        {
+        this->Types[edges[i].EdgeId] = VTK_FEATURE_EDGES_NONE;
+        }
+      begin = last;
+      }
+    }
+};
+
+// Count the extracted edges of each polygon.
+struct vtkFeatureEdgesCountLines
+{
+  const vtkFeatureEdgesPolys *Polys;
+  const signed char *Types;
+  vtkIdType *LineOffsets;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+    {
+    for ( ; cellId < endCellId; ++cellId)
+      {
+      vtkIdType numLines = 0;
+      for (vtkIdType edgeId = this->Polys->EdgeOffsets[cellId];
+           edgeId < this->Polys->EdgeOffsets[cellId+1]; ++edgeId)
+        {
+        if (this->Types[edgeId] != VTK_FEATURE_EDGES_NONE)
+          {
+          ++numLines;
+          }
+        }
+      this->LineOffsets[cellId] = numLines;
+      }
+    }
+};
+
+// Write the extracted edges of each polygon as lines, with the ids of the
+// input points, from the line offset of the polygon.
+struct vtkFeatureEdgesFillLines
+{
+  const vtkFeatureEdgesPolys *Polys;
+  const signed char *Types;
+  const vtkIdType *LineOffsets;
+  vtkIdType *Lines;
+  vtkIdType *LineCells;
+  signed char *LineTypes;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+    {
+    for ( ; cellId < endCellId; ++cellId)
+      {
+      const vtkIdType *cell =
+        this->Polys->Connectivity + this->Polys->Locations[cellId];
+      vtkIdType npts = cell[0];
+      const vtkIdType *pts = cell + 1;
+      vtkIdType edgeId = this->Polys->EdgeOffsets[cellId];
+      vtkIdType lineId = this->LineOffsets[cellId];
+      for (vtkIdType i = 0; i < npts; ++i, ++edgeId)
+        {
+        if (this->Types[edgeId] == VTK_FEATURE_EDGES_NONE)
+          {
+          continue;
+          }
+        vtkIdType *line = this->Lines + 3 * lineId;
+        line[0] = 2;
+        line[1] = pts[i];
+        line[2] = pts[(i + 1) % npts];
+        this->LineCells[lineId] = cellId;
+        this->LineTypes[lineId] = this->Types[edgeId];
+        ++lineId;
+        }
+      }
+    }
+};
+
+// Copy the cell data of the polygon of each line, and color the lines.
+struct vtkFeatureEdgesCopyCellData
+{
+  vtkArrayList *Arrays;
+  const vtkIdType *LineCells;
+  const signed char *LineTypes;
+  float *Scalars;
+
+  void operator()(vtkIdType lineId, vtkIdType endLineId)
+    {
+    for ( ; lineId < endLineId; ++lineId)
+      {
+      this->Arrays->Copy(this->LineCells[lineId], lineId);
+      if (this->Scalars)
+        {
+        this->Scalars[lineId] = vtkFeatureEdgesScalars[this->LineTypes[lineId]];
+        }
+      }
+    }
+};
+}
+
 // Construct object with feature angle = 30; all types of edges, except
 // manifold edges, are extracted and colored.
 vtkFeatureEdges::vtkFeatureEdges()
@@ -75,20 +373,14 @@ int vtkFeatureEdges::RequestData(
   vtkPoints *newPts;
   vtkFloatArray *newScalars = NULL;
   vtkCellArray *newLines;
-  vtkPolyData *Mesh;
-  int i;
-  vtkIdType j, numNei, cellId;
   vtkIdType numBEdges, numNonManifoldEdges, numFedges, numManifoldEdges;
-  double scalar, n[3], x1[3], x2[3];
+  double x[3];
   double cosAngle = 0;
-  vtkIdType lineIds[2];
   vtkIdType npts = 0;
   vtkIdType *pts = 0;
   vtkCellArray *inPolys, *inStrips, *newPolys;
-  vtkFloatArray *polyNormals = NULL;
-  vtkIdType numPts, numCells, numPolys, numStrips, nei;
-  vtkIdList *neighbors;
-  vtkIdType p1, p2, newId;
+  vtkIdType numPts, numCells, numPolys, numStrips;
+  vtkIdType cellId, lineId;
   vtkPointData *pd=input->GetPointData(), *outPD=output->GetPointData();
   vtkCellData *cd=input->GetCellData(), *outCD=output->GetCellData();
   unsigned char* ghosts=0;
@@ -129,8 +421,6 @@ int vtkFeatureEdges::RequestData(
     }
 
   // Build cell structure.  Might have to triangulate the strips.
-  Mesh = vtkPolyData::New();
-  Mesh->SetPoints(inPts);
   inPolys=input->GetPolys();
   if ( numStrips > 0 )
     {
@@ -148,17 +438,101 @@ int vtkFeatureEdges::RequestData(
       {
       vtkTriangleStrip::DecomposeStrip(npts, pts, newPolys);
       }
-    Mesh->SetPolys(newPolys);
-    newPolys->Delete();
     }
   else
     {
     newPolys = inPolys;
-    Mesh->SetPolys(newPolys);
+    newPolys->Register(this);
     }
-  Mesh->BuildLinks();
 
-  // Allocate storage for lines/points (arbitrary allocation sizes)
+  // Locate the polygons in the connectivity array and number their
+  // edges, which are made and sorted in parallel. The uses of each edge
+  // are then adjacent, ordered by cell, and classified without links.
+  vtkIdType numMeshPolys = newPolys->GetNumberOfCells();
+  vtkFeatureEdgesPolys polys;
+  polys.Connectivity = newPolys->GetPointer();
+  polys.Locations.resize(numMeshPolys);
+  polys.EdgeOffsets.resize(numMeshPolys + 1);
+  vtkIdType location = 0, numEdges = 0;
+  for (cellId = 0; cellId < numMeshPolys; ++cellId)
+    {
+    polys.Locations[cellId] = location;
+    polys.EdgeOffsets[cellId] = numEdges;
+    npts = polys.Connectivity[location];
+    numEdges += npts;
+    location += npts + 1;
+    }
+  polys.EdgeOffsets[numMeshPolys] = numEdges;
+  if ( numEdges < 1 )
+    {
+    vtkDebugMacro(<<"No polygon edges!");
+    newPolys->UnRegister(this);
+    return 1;
+    }
+
+  std::vector<vtkFeatureEdgesEdge> edges(numEdges);
+  vtkFeatureEdgesMakeEdges makeEdges = { &polys, &edges[0] };
+  vtkSMPTools::For(0, numMeshPolys, makeEdges);
+  vtkSMPTools::Sort(edges.begin(), edges.end());
+  this->UpdateProgress(0.3);
+
+  std::vector<float> polyNormals;
+  if ( this->FeatureEdges )
+    {
+    polyNormals.resize(3 * numMeshPolys);
+    vtkFeatureEdgesComputeNormals computeNormals =
+      { inPts, &polys, &polyNormals[0] };
+    vtkSMPTools::For(0, numMeshPolys, computeNormals);
+
+    cosAngle = cos( vtkMath::RadiansFromDegrees( this->FeatureAngle ) );
+    }
+
+  // Classify the edges, then count, place and write the lines in the order
+  // of the polygons and of their edges.
+  std::vector<signed char> types(numEdges);
+  vtkFeatureEdgesClassify classify;
+  classify.Edges = &edges[0];
+  classify.NumberOfEdges = numEdges;
+  classify.Normals = polyNormals.empty() ? NULL : &polyNormals[0];
+  classify.Ghosts = ghosts;
+  classify.CosAngle = cosAngle;
+  classify.BoundaryEdges = this->BoundaryEdges;
+  classify.NonManifoldEdges = this->NonManifoldEdges;
+  classify.FeatureEdges = this->FeatureEdges;
+  classify.ManifoldEdges = this->ManifoldEdges;
+  classify.Types = &types[0];
+  vtkSMPTools::For(0, numEdges, classify);
+  std::vector<vtkFeatureEdgesEdge>().swap(edges);
+  this->UpdateProgress(0.6);
+
+  std::vector<vtkIdType> lineOffsets(numMeshPolys + 1);
+  vtkFeatureEdgesCountLines countLines =
+    { &polys, &types[0], &lineOffsets[0] };
+  vtkSMPTools::For(0, numMeshPolys, countLines);
+  vtkIdType numLines = 0;
+  for (cellId = 0; cellId < numMeshPolys; ++cellId)
+    {
+    vtkIdType numCellLines = lineOffsets[cellId];
+    lineOffsets[cellId] = numLines;
+    numLines += numCellLines;
+    }
+  lineOffsets[numMeshPolys] = numLines;
+
+  newLines = vtkCellArray::New();
+  vtkIdType *lines = newLines->WritePointer(numLines, 3 * numLines);
+  std::vector<vtkIdType> lineCells(numLines);
+  std::vector<signed char> lineTypes(numLines);
+  if ( numLines > 0 )
+    {
+    vtkFeatureEdgesFillLines fillLines =
+      { &polys, &types[0], &lineOffsets[0], lines, &lineCells[0],
+        &lineTypes[0] };
+    vtkSMPTools::For(0, numMeshPolys, fillLines);
+    }
+  newPolys->UnRegister(this);
+  this->UpdateProgress(0.8);
+
+  // Allocate storage for points (arbitrary allocation sizes)
   //
   newPts = vtkPoints::New();
 
@@ -177,15 +551,6 @@ int vtkFeatureEdges::RequestData(
     }
 
   newPts->Allocate(numPts/10,numPts);
-  newLines = vtkCellArray::New();
-  newLines->Allocate(numPts/10);
-  if ( this->Coloring )
-    {
-    newScalars = vtkFloatArray::New();
-    newScalars->SetName("Edge Types");
-    newScalars->Allocate(numCells/10,numCells);
-    }
-
   outPD->CopyAllocate(pd, numPts);
   outCD->CopyAllocate(cd, numCells);
 
@@ -197,155 +562,50 @@ int vtkFeatureEdges::RequestData(
     }
   this->Locator->InitPointInsertion (newPts, input->GetBounds());
 
-  // Loop over all polygons generating boundary, non-manifold,
-  // and feature edges
-  //
-  if ( this->FeatureEdges )
+  // The points are merged through the locator in the order of the lines,
+  // which is serial, and renumbered in place. vtkMergePoints merges
+  // coincident points only, so each input point is looked up once.
+  std::vector<vtkIdType> pointMap;
+  if ( this->Locator->IsA("vtkMergePoints") )
     {
-    polyNormals = vtkFloatArray::New();
-    polyNormals->SetNumberOfComponents(3);
-    polyNormals->Allocate(3*newPolys->GetNumberOfCells());
-
-    for (cellId=0, newPolys->InitTraversal(); newPolys->GetNextCell(npts,pts);
-    cellId++)
-      {
-      vtkPolygon::ComputeNormal(inPts,npts,pts,n);
-      polyNormals->InsertTuple(cellId,n);
-      }
-
-    cosAngle = cos( vtkMath::RadiansFromDegrees( this->FeatureAngle ) );
+    pointMap.resize(numPts, -1);
     }
-
-  neighbors = vtkIdList::New();
-  neighbors->Allocate(VTK_CELL_SIZE);
-
-  int abort=0;
-  vtkIdType progressInterval=numCells/20+1;
-
   numBEdges = numNonManifoldEdges = numFedges = numManifoldEdges = 0;
-  for (cellId=0, newPolys->InitTraversal();
-       newPolys->GetNextCell(npts,pts) && !abort; cellId++)
+  for (lineId = 0; lineId < numLines; ++lineId)
     {
-    if ( ! (cellId % progressInterval) ) //manage progress / early abort
-      {
-      this->UpdateProgress (static_cast<double>(cellId) / numCells);
-      abort = this->GetAbortExecute();
-      }
-
-    for (i=0; i < npts; i++)
+    vtkIdType *line = lines + 3 * lineId;
+    for (int i = 1; i < 3; ++i)
       {
-      p1 = pts[i];
-      p2 = pts[(i+1)%npts];
-
-      Mesh->GetCellEdgeNeighbors(cellId,p1,p2, neighbors);
-      numNei = neighbors->GetNumberOfIds();
-
-      if ( this->BoundaryEdges && numNei < 1 )
-        {
-        if (ghosts &&
-            ghosts[cellId] & vtkDataSetAttributes::DUPLICATECELL)
-          {
-          continue;
-          }
-        else
-          {
-          numBEdges++;
-          scalar = 0.0;
-          }
-        }
-
-      else if ( this->NonManifoldEdges && numNei > 1 )
-        {
-        // check to make sure that this edge hasn't been created before
-        for (j=0; j < numNei; j++)
-          {
-          if ( neighbors->GetId(j) < cellId )
-            {
-            break;
-            }
-          }
-        if ( j >= numNei )
-          {
-          if (ghosts &&
-              ghosts[cellId]  & vtkDataSetAttributes::DUPLICATECELL)
-            {
-            continue;
-            }
-          else
-            {
-            numNonManifoldEdges++;
-            scalar = 0.222222;
-            }
-          }
-        else
-          {
-          continue;
-          }
-        }
-      else if ( this->FeatureEdges &&
-                numNei == 1 && (nei=neighbors->GetId(0)) > cellId )
-        {
-        double neiTuple[3];
-        double cellTuple[3];
-        polyNormals->GetTuple(nei, neiTuple);
-        polyNormals->GetTuple(cellId, cellTuple);
-        if ( vtkMath::Dot(neiTuple, cellTuple) <= cosAngle )
-          {
-          if (ghosts &&
-              ghosts[cellId] & vtkDataSetAttributes::DUPLICATECELL)
-            {
-            continue;
-            }
-          else
-            {
-            numFedges++;
-            scalar = 0.444444;
-            }
-          }
-        else
-          {
-          continue;
-          }
-        }
-      else if ( this->ManifoldEdges &&
-                numNei == 1 && neighbors->GetId(0) > cellId )
-        {
-        if (ghosts &&
-            ghosts[cellId] & vtkDataSetAttributes::DUPLICATECELL)
-          {
-          continue;
-          }
-        else
-          {
-          numManifoldEdges++;
-          scalar = 0.666667;
-          }
-        }
-      else
+      vtkIdType ptId = line[i];
+      if ( !pointMap.empty() && pointMap[ptId] >= 0 )
         {
+        line[i] = pointMap[ptId];
         continue;
         }
-
-      // Add edge to output
-      Mesh->GetPoint(p1, x1);
-      Mesh->GetPoint(p2, x2);
-
-      if ( this->Locator->InsertUniquePoint(x1, lineIds[0]) )
+      inPts->GetPoint(ptId, x);
+      if ( this->Locator->InsertUniquePoint(x, line[i]) )
         {
-        outPD->CopyData (pd,p1,lineIds[0]);
+        outPD->CopyData (pd,ptId,line[i]);
         }
-
-      if ( this->Locator->InsertUniquePoint(x2, lineIds[1]) )
+      if ( !pointMap.empty() )
         {
-        outPD->CopyData (pd,p2,lineIds[1]);
+        pointMap[ptId] = line[i];
         }
+      }
 
-      newId = newLines->InsertNextCell(2,lineIds);
-      outCD->CopyData (cd,cellId,newId);
-      if ( this->Coloring )
-        {
-        newScalars->InsertTuple(newId, &scalar);
-        }
+    switch (lineTypes[lineId])
+      {
+      case VTK_FEATURE_EDGES_BOUNDARY:
+        numBEdges++;
+        break;
+      case VTK_FEATURE_EDGES_NON_MANIFOLD:
+        numNonManifoldEdges++;
+        break;
+      case VTK_FEATURE_EDGES_FEATURE:
+        numFedges++;
+        break;
+      default:
+        numManifoldEdges++;
       }
     }
 
@@ -354,18 +614,33 @@ int vtkFeatureEdges::RequestData(
                 << numFedges << " feature edges, "
                 << numManifoldEdges << " manifold edges");
 
-  //  Update ourselves.
-  //
-  if ( this->FeatureEdges )
+  // The cell data of the lines is copied from their polygons.
+  vtkArrayList arrays;
+  arrays.AddArrays(numLines, cd, outCD);
+  if ( this->Coloring )
     {
-    polyNormals->Delete();
+    newScalars = vtkFloatArray::New();
+    newScalars->SetName("Edge Types");
+    newScalars->SetNumberOfTuples(numLines);
+    }
+  vtkFeatureEdgesCopyCellData copyCellData;
+  copyCellData.Arrays = &arrays;
+  copyCellData.LineCells = lineCells.empty() ? NULL : &lineCells[0];
+  copyCellData.LineTypes = lineTypes.empty() ? NULL : &lineTypes[0];
+  copyCellData.Scalars = newScalars ? newScalars->GetPointer(0) : NULL;
+  if ( vtkArrayList::IsThreadSafe(cd) && vtkArrayList::IsThreadSafe(outCD) )
+    {
+    vtkSMPTools::For(0, numLines, copyCellData);
+    }
+  else
+    {
+    copyCellData(0, numLines);
     }
 
-  Mesh->Delete();
-
+  //  Update ourselves.
+  //
   output->SetPoints(newPts);
   newPts->Delete();
-  neighbors->Delete();
 
   output->SetLines(newLines);
   newLines->Delete();
@@ -23,6 +23,12 @@
 // combination. Edges may also be "colored" (i.e., scalar values assigned)
 // based on edge type. The cell coloring is assigned to the cell data of
 // the extracted edges.
+//
+// The edges of the polygons are sorted by their end points with
+// vtkSMPTools, so that the polygons using each edge are found without
+// building links, and the edges are classified and written to the output
+// in parallel. The output points are merged through the locator serially,
+// in the order of the lines.
 
 // .SECTION Caveats
 // To see the coloring of the liens you may have to set the ScalarMode
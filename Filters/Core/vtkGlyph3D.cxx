@@ -14,10 +14,11 @@
 =========================================================================*/
 #include "vtkGlyph3D.h"
 
+#include "vtkArrayListTemplate.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
-#include "vtkCell.h"
+#include "vtkDoubleArray.h"
 #include "vtkFloatArray.h"
-#include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
@@ -26,6 +27,7 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTransform.h"
@@ -33,6 +35,9 @@
 #include "vtkUniformGrid.h"
 #include "vtkUnsignedCharArray.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro(vtkGlyph3D);
 vtkCxxSetObjectMacro(vtkGlyph3D, SourceTransform, vtkTransform);
 
@@ -118,6 +123,492 @@ bool vtkGlyph3D::Execute(
   return this->Execute(input, sourceVector, output, inSScalars, inVectors);
 }
 
+//----------------------------------------------------------------------------
+namespace
+{
+// Number of input points in a block. Blocks are glyphed by one thread
+// each, and the output is sized with a prefix sum over blocks.
+const vtkIdType VTK_GLYPH3D_BLOCK_SIZE = 1024;
+
+// Cell arrays of vtkPolyData, in the order of the output cells.
+const int VTK_GLYPH3D_CELL_TYPES = 4;
+
+// A glyph of the table, ready to be copied: its points, transformed by the
+// SourceTransform, and its normals are float or double arrays.
+struct vtkGlyph3DSource
+{
+  vtkGlyph3DSource() : NumberOfPoints(0)
+    {
+    for (int k = 0; k < VTK_GLYPH3D_CELL_TYPES; ++k)
+      {
+      this->Cells[k] = 0;
+      this->NumberOfCells[k] = this->ConnectivitySize[k] = 0;
+      }
+    }
+
+  vtkIdType NumberOfPoints;
+  vtkSmartPointer<vtkDataArray> Points;
+  vtkSmartPointer<vtkDataArray> Normals;
+  vtkSmartPointer<vtkFloatArray> TCoords;
+  const vtkIdType *Cells[VTK_GLYPH3D_CELL_TYPES];
+  vtkIdType NumberOfCells[VTK_GLYPH3D_CELL_TYPES];
+  vtkIdType ConnectivitySize[VTK_GLYPH3D_CELL_TYPES];
+};
+
+// An array of tuples of 3 float or double values, converting it if needed.
+vtkSmartPointer<vtkDataArray> vtkGlyph3DFloatOrDouble(vtkDataArray *array)
+{
+  vtkSmartPointer<vtkDataArray> result = array;
+  if ((array->GetDataType() != VTK_FLOAT &&
+       array->GetDataType() != VTK_DOUBLE) ||
+      array->GetNumberOfComponents() != 3 ||
+      !array->HasStandardMemoryLayout())
+    {
+    result = vtkSmartPointer<vtkDoubleArray>::New();
+    result->SetNumberOfComponents(3);
+    result->SetNumberOfTuples(array->GetNumberOfTuples());
+    double x[3];
+    for (vtkIdType i = 0; i < array->GetNumberOfTuples(); ++i)
+      {
+      x[0] = x[1] = x[2] = 0.0;
+      array->GetTuple(i, x);
+      result->SetTuple(i, x);
+      }
+    }
+  return result;
+}
+
+void vtkGlyph3DPrepareSource(vtkPolyData *source, vtkTransform *transform,
+                             bool normals, bool tcoords,
+                             vtkGlyph3DSource &glyph)
+{
+  vtkPoints *points = source->GetPoints();
+  if (points && points->GetNumberOfPoints() > 0)
+    {
+    glyph.NumberOfPoints = points->GetNumberOfPoints();
+    if (transform)
+      {
+      vtkNew<vtkPoints> transformed;
+      transformed->SetDataType(
+        points->GetDataType() == VTK_FLOAT ? VTK_FLOAT : VTK_DOUBLE);
+      transformed->Allocate(glyph.NumberOfPoints);
+      transform->TransformPoints(points, transformed.GetPointer());
+      points = transformed.GetPointer();
+      glyph.Points = points->GetData();
+      }
+    else
+      {
+      glyph.Points = vtkGlyph3DFloatOrDouble(points->GetData());
+      }
+    }
+  if (normals && glyph.NumberOfPoints > 0)
+    {
+    glyph.Normals =
+      vtkGlyph3DFloatOrDouble(source->GetPointData()->GetNormals());
+    }
+  if (tcoords && glyph.NumberOfPoints > 0)
+    {
+    vtkDataArray *sourceTCoords = source->GetPointData()->GetTCoords();
+    glyph.TCoords = vtkFloatArray::SafeDownCast(sourceTCoords);
+    if (!glyph.TCoords || !sourceTCoords->HasStandardMemoryLayout())
+      {
+      glyph.TCoords = vtkSmartPointer<vtkFloatArray>::New();
+      glyph.TCoords->DeepCopy(sourceTCoords);
+      }
+    }
+
+  vtkCellArray *cells[VTK_GLYPH3D_CELL_TYPES] =
+    { source->GetVerts(), source->GetLines(), source->GetPolys(),
+      source->GetStrips() };
+  for (int k = 0; k < VTK_GLYPH3D_CELL_TYPES; ++k)
+    {
+    glyph.NumberOfCells[k] = cells[k]->GetNumberOfCells();
+    glyph.ConnectivitySize[k] = cells[k]->GetNumberOfConnectivityEntries();
+    glyph.Cells[k] = glyph.NumberOfCells[k] ? cells[k]->GetPointer() : 0;
+    }
+}
+
+// Output of the glyphs that precede a block of input points.
+struct vtkGlyph3DOffsets
+{
+  vtkIdType Points;
+  vtkIdType Cells[VTK_GLYPH3D_CELL_TYPES];
+  vtkIdType Connectivity[VTK_GLYPH3D_CELL_TYPES];
+};
+
+// Scale, vector and glyph of the input points, as set by the filter.
+struct vtkGlyph3DPointParameters
+{
+  vtkDataArray *ScaleScalars;
+  vtkDataArray *Vectors;
+  int ScaleMode;
+  int Clamping;
+  double Range[2];
+  double Den;
+  int IndexMode;
+  int NumberOfSources;
+
+  // Compute the scale of point ptId, before the scale factor, its vector
+  // and the magnitude of the vector. Return the index of its glyph.
+  int Evaluate(vtkIdType ptId, double scale[3], double v[3],
+               double &vMag) const
+    {
+    double s = 0.0;
+    scale[0] = scale[1] = scale[2] = 1.0;
+    v[0] = v[1] = v[2] = vMag = 0.0;
+    if (this->ScaleScalars)
+      {
+      s = this->ScaleScalars->GetComponent(ptId, 0);
+      if (this->ScaleMode == VTK_SCALE_BY_SCALAR ||
+          this->ScaleMode == VTK_DATA_SCALING_OFF)
+        {
+        scale[0] = scale[1] = scale[2] = s;
+        }
+      }
+    if (this->Vectors)
+      {
+      this->Vectors->GetTuple(ptId, v);
+      vMag = vtkMath::Norm(v);
+      if (this->ScaleMode == VTK_SCALE_BY_VECTORCOMPONENTS)
+        {
+        scale[0] = v[0];
+        scale[1] = v[1];
+        scale[2] = v[2];
+        }
+      else if (this->ScaleMode == VTK_SCALE_BY_VECTOR)
+        {
+        scale[0] = scale[1] = scale[2] = vMag;
+        }
+      }
+    if (this->Clamping)
+      {
+      for (int i = 0; i < 3; ++i)
+        {
+        scale[i] = (scale[i] < this->Range[0] ? this->Range[0] :
+                    (scale[i] > this->Range[1] ? this->Range[1] : scale[i]));
+        scale[i] = (scale[i] - this->Range[0]) / this->Den;
+        }
+      }
+    if (this->IndexMode == VTK_INDEXING_OFF)
+      {
+      return 0;
+      }
+    double value = this->IndexMode == VTK_INDEXING_BY_SCALAR ? s : vMag;
+    int index = static_cast<int>(
+      (value - this->Range[0]) * this->NumberOfSources / this->Den);
+    return (index < 0 ? 0 : (index >= this->NumberOfSources ?
+                             (this->NumberOfSources - 1) : index));
+    }
+};
+
+// Transform the points of a glyph by the 3x4 matrix m, in the precision of
+// the points.
+template <class TPoint>
+void vtkGlyph3DTransformPoints(const TPoint *in, vtkIdType numPts,
+                               const double m[3][4], float *out)
+{
+  const TPoint m00 = static_cast<TPoint>(m[0][0]);
+  const TPoint m01 = static_cast<TPoint>(m[0][1]);
+  const TPoint m02 = static_cast<TPoint>(m[0][2]);
+  const TPoint m03 = static_cast<TPoint>(m[0][3]);
+  const TPoint m10 = static_cast<TPoint>(m[1][0]);
+  const TPoint m11 = static_cast<TPoint>(m[1][1]);
+  const TPoint m12 = static_cast<TPoint>(m[1][2]);
+  const TPoint m13 = static_cast<TPoint>(m[1][3]);
+  const TPoint m20 = static_cast<TPoint>(m[2][0]);
+  const TPoint m21 = static_cast<TPoint>(m[2][1]);
+  const TPoint m22 = static_cast<TPoint>(m[2][2]);
+  const TPoint m23 = static_cast<TPoint>(m[2][3]);
+  for (vtkIdType i = 0; i < numPts; ++i, in += 3, out += 3)
+    {
+    out[0] = static_cast<float>(m00 * in[0] + m01 * in[1] + m02 * in[2] + m03);
+    out[1] = static_cast<float>(m10 * in[0] + m11 * in[1] + m12 * in[2] + m13);
+    out[2] = static_cast<float>(m20 * in[0] + m21 * in[1] + m22 * in[2] + m23);
+    }
+}
+
+// Transform the normals of a glyph by the 3x3 matrix m and normalize them,
+// in the precision of the normals.
+template <class TNormal>
+void vtkGlyph3DTransformNormals(const TNormal *in, vtkIdType numPts,
+                                const double m[3][3], float *out)
+{
+  TNormal n[3][3];
+  for (int i = 0; i < 3; ++i)
+    {
+    for (int j = 0; j < 3; ++j)
+      {
+      n[i][j] = static_cast<TNormal>(m[i][j]);
+      }
+    }
+  for (vtkIdType i = 0; i < numPts; ++i, in += 3, out += 3)
+    {
+    TNormal x = n[0][0] * in[0] + n[0][1] * in[1] + n[0][2] * in[2];
+    TNormal y = n[1][0] * in[0] + n[1][1] * in[1] + n[1][2] * in[2];
+    TNormal z = n[2][0] * in[0] + n[2][1] * in[1] + n[2][2] * in[2];
+    TNormal den = sqrt(x * x + y * y + z * z);
+    if (den != 0.0)
+      {
+      x /= den;
+      y /= den;
+      z /= den;
+      }
+    out[0] = static_cast<float>(x);
+    out[1] = static_cast<float>(y);
+    out[2] = static_cast<float>(z);
+    }
+}
+
+// Copy the glyphs of blocks of input points to the output, at the offsets
+// of the blocks.
+struct vtkGlyph3DFillBlocks
+{
+  vtkDataSet *Input;
+  vtkIdType NumberOfPoints;
+  const int *Glyphs;
+  const vtkGlyph3DSource *Sources;
+  const vtkGlyph3DOffsets *Offsets;
+  const vtkGlyph3DPointParameters *Parameters;
+  int Scaling;
+  int ScaleMode;
+  double ScaleFactor;
+  int Orient;
+
+  float *Points;
+  vtkIdType *Cells[VTK_GLYPH3D_CELL_TYPES];
+  // Id of the first output cell of each type.
+  vtkIdType FirstCell[VTK_GLYPH3D_CELL_TYPES];
+  // Scale or vector magnitude of the input point, or NULL.
+  float *Scalars;
+  bool ScalarsAreMagnitudes;
+  vtkArrayList *ColorScalars;
+  float *Vectors;
+  float *Normals;
+  float *TCoords;
+  vtkIdType *PointIds;
+  vtkArrayList *PointData;
+  vtkArrayList *CellData;
+
+  void operator()(vtkIdType block, vtkIdType endBlock)
+    {
+    double x[3], v[3], vMag, scale[3], rotation[3][3];
+    double pointMatrix[3][4], normalMatrix[3][3];
+    for ( ; block < endBlock; ++block)
+      {
+      const vtkGlyph3DOffsets &offsets = this->Offsets[block];
+      vtkIdType ptIncr = offsets.Points;
+      vtkIdType cellIncr[VTK_GLYPH3D_CELL_TYPES];
+      vtkIdType connIncr[VTK_GLYPH3D_CELL_TYPES];
+      for (int k = 0; k < VTK_GLYPH3D_CELL_TYPES; ++k)
+        {
+        cellIncr[k] = offsets.Cells[k];
+        connIncr[k] = offsets.Connectivity[k];
+        }
+      vtkIdType inPtId = block * VTK_GLYPH3D_BLOCK_SIZE;
+      vtkIdType endPtId = inPtId + VTK_GLYPH3D_BLOCK_SIZE;
+      if (endPtId > this->NumberOfPoints)
+        {
+        endPtId = this->NumberOfPoints;
+        }
+      for ( ; inPtId < endPtId; ++inPtId)
+        {
+        if (this->Glyphs[inPtId] < 0)
+          {
+          continue;
+          }
+        const vtkGlyph3DSource &glyph = this->Sources[this->Glyphs[inPtId]];
+        vtkIdType numGlyphPts = glyph.NumberOfPoints;
+        this->Parameters->Evaluate(inPtId, scale, v, vMag);
+
+        // Topology, offset by the first point of the glyph.
+        for (int k = 0; k < VTK_GLYPH3D_CELL_TYPES; ++k)
+          {
+          const vtkIdType *src = glyph.Cells[k];
+          const vtkIdType *srcEnd = src + glyph.ConnectivitySize[k];
+          vtkIdType *dst = this->Cells[k] + connIncr[k];
+          while (src < srcEnd)
+            {
+            vtkIdType npts = *src++;
+            *dst++ = npts;
+            for (vtkIdType i = 0; i < npts; ++i)
+              {
+              *dst++ = *src++ + ptIncr;
+              }
+            }
+          connIncr[k] += glyph.ConnectivitySize[k];
+          }
+
+        // Point attributes, with the scale before the scale factor.
+        vtkIdType i;
+        if (this->Scalars)
+          {
+          float value = static_cast<float>(
+            this->ScalarsAreMagnitudes ? vMag : scale[0]);
+          for (i = 0; i < numGlyphPts; ++i)
+            {
+            this->Scalars[ptIncr + i] = value;
+            }
+          }
+        else if (this->ColorScalars)
+          {
+          for (i = 0; i < numGlyphPts; ++i)
+            {
+            this->ColorScalars->Copy(inPtId, ptIncr + i);
+            }
+          }
+        if (this->Vectors)
+          {
+          float *vector = this->Vectors + 3 * ptIncr;
+          for (i = 0; i < numGlyphPts; ++i, vector += 3)
+            {
+            vector[0] = static_cast<float>(v[0]);
+            vector[1] = static_cast<float>(v[1]);
+            vector[2] = static_cast<float>(v[2]);
+            }
+          }
+        if (this->TCoords)
+          {
+          int numComps = glyph.TCoords->GetNumberOfComponents();
+          const float *tc = glyph.TCoords->GetPointer(0);
+          std::copy(tc, tc + numComps * numGlyphPts,
+                    this->TCoords + numComps * ptIncr);
+          }
+        if (this->PointData)
+          {
+          for (i = 0; i < numGlyphPts; ++i)
+            {
+            this->PointData->Copy(inPtId, ptIncr + i);
+            }
+          }
+        if (this->CellData)
+          {
+          for (int k = 0; k < VTK_GLYPH3D_CELL_TYPES; ++k)
+            {
+            vtkIdType cellId = this->FirstCell[k] + cellIncr[k];
+            for (i = 0; i < glyph.NumberOfCells[k]; ++i)
+              {
+              this->CellData->Copy(inPtId, cellId + i);
+              }
+            }
+          }
+        if (this->PointIds)
+          {
+          std::fill(this->PointIds + ptIncr,
+                    this->PointIds + ptIncr + numGlyphPts, inPtId);
+          }
+        for (int k = 0; k < VTK_GLYPH3D_CELL_TYPES; ++k)
+          {
+          cellIncr[k] += glyph.NumberOfCells[k];
+          }
+
+        // Rotate by 180 degrees around the bisector of the x axis and the
+        // vector, or around the y axis for vectors along -x.
+        for (int r = 0; r < 3; ++r)
+          {
+          rotation[r][0] = rotation[r][1] = rotation[r][2] = 0.0;
+          rotation[r][r] = 1.0;
+          }
+        if (this->Parameters->Vectors && this->Orient && vMag > 0.0)
+          {
+          if (v[1] == 0.0 && v[2] == 0.0)
+            {
+            if (v[0] < 0)
+              {
+              rotation[0][0] = rotation[2][2] = -1.0;
+              }
+            }
+          else
+            {
+            double axis[3] = { (v[0] + vMag) / 2.0, v[1] / 2.0, v[2] / 2.0 };
+            vtkMath::Normalize(axis);
+            for (int r = 0; r < 3; ++r)
+              {
+              for (int c = 0; c < 3; ++c)
+                {
+                rotation[r][c] = 2.0 * axis[r] * axis[c] - (r == c ? 1.0 : 0.0);
+                }
+              }
+            }
+          }
+
+        if (this->Scaling)
+          {
+          if (this->ScaleMode == VTK_DATA_SCALING_OFF)
+            {
+            scale[0] = scale[1] = scale[2] = this->ScaleFactor;
+            }
+          else
+            {
+            scale[0] *= this->ScaleFactor;
+            scale[1] *= this->ScaleFactor;
+            scale[2] *= this->ScaleFactor;
+            }
+          for (int c = 0; c < 3; ++c)
+            {
+            if (scale[c] == 0.0)
+              {
+              scale[c] = 1.0e-10;
+              }
+            }
+          }
+        else
+          {
+          scale[0] = scale[1] = scale[2] = 1.0;
+          }
+
+        // Translate to the input point after rotating and scaling. Normals
+        // go through the inverse transpose, the rotation times the inverse
+        // scale.
+        this->Input->GetPoint(inPtId, x);
+        for (int r = 0; r < 3; ++r)
+          {
+          for (int c = 0; c < 3; ++c)
+            {
+            pointMatrix[r][c] = rotation[r][c] * scale[c];
+            normalMatrix[r][c] = rotation[r][c] / scale[c];
+            }
+          pointMatrix[r][3] = x[r];
+          }
+
+        float *outPts = this->Points + 3 * ptIncr;
+        vtkDataArray *glyphPts = glyph.Points;
+        if (glyphPts && glyphPts->GetDataType() == VTK_FLOAT)
+          {
+          vtkGlyph3DTransformPoints(
+            static_cast<float*>(glyphPts->GetVoidPointer(0)),
+            numGlyphPts, pointMatrix, outPts);
+          }
+        else if (glyphPts)
+          {
+          vtkGlyph3DTransformPoints(
+            static_cast<double*>(glyphPts->GetVoidPointer(0)),
+            numGlyphPts, pointMatrix, outPts);
+          }
+        if (this->Normals)
+          {
+          float *outNormals = this->Normals + 3 * ptIncr;
+          vtkDataArray *normals = glyph.Normals;
+          if (normals && normals->GetDataType() == VTK_FLOAT)
+            {
+            vtkGlyph3DTransformNormals(
+              static_cast<float*>(normals->GetVoidPointer(0)),
+              numGlyphPts, normalMatrix, outNormals);
+            }
+          else if (normals)
+            {
+            vtkGlyph3DTransformNormals(
+              static_cast<double*>(normals->GetVoidPointer(0)),
+              numGlyphPts, normalMatrix, outNormals);
+            }
+          }
+
+        ptIncr += numGlyphPts;
+        }
+      }
+    }
+};
+}
+
 //----------------------------------------------------------------------------
 bool vtkGlyph3D::Execute(
   vtkDataSet* input,
@@ -139,41 +630,18 @@ bool vtkGlyph3D::Execute(
   vtkPointData *pd;
   vtkDataArray *inCScalars; // Scalars for Coloring
   unsigned char* inGhostLevels=0;
-  vtkDataArray *inNormals, *sourceNormals = NULL;
-  vtkDataArray *sourceTCoords = NULL;
-  vtkIdType numPts, numSourcePts, numSourceCells, inPtId, i;
-  vtkPoints *sourcePts = NULL;
-  vtkSmartPointer<vtkPoints> transformedSourcePts = vtkSmartPointer<vtkPoints>::New();
-  vtkPoints *newPts;
-  vtkDataArray *newScalars=NULL;
-  vtkDataArray *newVectors=NULL;
-  vtkDataArray *newNormals=NULL;
-  vtkDataArray *newTCoords = NULL;
-  double x[3], v[3], vNew[3], s = 0.0, vMag = 0.0, value, tc[3];
-  vtkTransform *trans = vtkTransform::New();
-  vtkNew<vtkIdList> pointIdList;
-  vtkIdList *cellPts;
-  int npts;
-  vtkIdList *pts;
-  vtkIdType ptIncr, cellIncr, cellId;
-  int haveVectors, haveNormals, haveTCoords = 0;
-  double scalex,scaley,scalez, den;
+  vtkDataArray *inNormals;
+  vtkIdType numPts, inPtId;
+  int haveVectors, haveNormals = 1, haveTCoords = 0;
+  double den;
   vtkPointData* outputPD = output->GetPointData();
   vtkCellData* outputCD = output->GetCellData();
   int numberOfSources = this->GetNumberOfInputConnections(1);
-  vtkPolyData *defaultSource = NULL;
-  vtkIdTypeArray *pointIds=0;
   vtkPolyData *source = this->GetSource(0, sourceVector);
-  vtkNew<vtkIdList> srcPointIdList;
-  vtkNew<vtkIdList> dstPointIdList;
-  vtkNew<vtkIdList> srcCellIdList;
-  vtkNew<vtkIdList> dstCellIdList;
+  int i, k;
 
   vtkDebugMacro(<<"Generating glyphs");
 
-  pts = vtkIdList::New();
-  pts->Allocate(VTK_CELL_SIZE);
-
   pd = input->GetPointData();
   inNormals = this->GetInputArrayToProcess(2, input);
   inCScalars = this->GetInputArrayToProcess(3, input);
@@ -202,8 +670,6 @@ bool vtkGlyph3D::Execute(
   if (numPts < 1)
     {
     vtkDebugMacro(<<"No points to glyph!");
-    pts->Delete();
-    trans->Delete();
     return 1;
     }
 
@@ -224,6 +690,17 @@ bool vtkGlyph3D::Execute(
     haveVectors = 0;
     }
 
+  vtkDataArray *array3D = NULL;
+  if ( haveVectors )
+    {
+    array3D = this->VectorMode == VTK_USE_NORMAL? inNormals : inVectors;
+    if(array3D->GetNumberOfComponents()>3)
+      {
+      vtkErrorMacro(<<"vtkDataArray "<<array3D->GetName()<<" has more than 3 components.\n");
+      return false;
+      }
+    }
+
   if ( (this->IndexMode == VTK_INDEXING_BY_SCALAR && !inSScalars) ||
        (this->IndexMode == VTK_INDEXING_BY_VECTOR &&
        ((!inVectors && this->VectorMode == VTK_USE_VECTOR) ||
@@ -232,8 +709,6 @@ bool vtkGlyph3D::Execute(
     if ( !source )
       {
       vtkErrorMacro(<<"Indexing on but don't have data to index with");
-      pts->Delete();
-      trans->Delete();
       return true;
       }
     else
@@ -249,111 +724,195 @@ bool vtkGlyph3D::Execute(
   outputPD->CopyNormalsOff();
   outputPD->CopyTCoordsOff();
 
+  vtkSmartPointer<vtkPolyData> defaultSource;
   if (!source)
     {
-    defaultSource = vtkPolyData::New();
+    defaultSource = vtkSmartPointer<vtkPolyData>::New();
     defaultSource->Allocate();
-    vtkPoints *defaultPoints = vtkPoints::New();
+    vtkNew<vtkPoints> defaultPoints;
     defaultPoints->Allocate(6);
     defaultPoints->InsertNextPoint(0, 0, 0);
     defaultPoints->InsertNextPoint(1, 0, 0);
     vtkIdType defaultPointIds[2];
     defaultPointIds[0] = 0;
     defaultPointIds[1] = 1;
-    defaultSource->SetPoints(defaultPoints);
+    defaultSource->SetPoints(defaultPoints.GetPointer());
     defaultSource->InsertNextCell(VTK_LINE, 2, defaultPointIds);
-    defaultSource->Delete();
-    defaultSource = NULL;
-    defaultPoints->Delete();
-    defaultPoints = NULL;
     source = defaultSource;
     }
 
+  // Prepare the table of glyphs.
+  std::vector<vtkGlyph3DSource> sources;
+  std::vector<bool> haveSource;
   if ( this->IndexMode != VTK_INDEXING_OFF )
     {
     pd = NULL;
-    haveNormals = 1;
-    for (numSourcePts=numSourceCells=i=0; i < numberOfSources; i++)
+    sources.resize(numberOfSources);
+    haveSource.resize(numberOfSources, false);
+    for (i = 0; i < numberOfSources; i++)
       {
-      source = this->GetSource(i, sourceVector);
-      if ( source != NULL )
+      if ( (source = this->GetSource(i, sourceVector)) != NULL )
         {
-        if (source->GetNumberOfPoints() > numSourcePts)
-          {
-          numSourcePts = source->GetNumberOfPoints();
-          }
-        if (source->GetNumberOfCells() > numSourceCells)
-          {
-          numSourceCells = source->GetNumberOfCells();
-          }
-        if ( !(sourceNormals = source->GetPointData()->GetNormals()) )
+        haveSource[i] = true;
+        if ( !source->GetPointData()->GetNormals() )
           {
           haveNormals = 0;
           }
         }
       }
+    for (i = 0; i < numberOfSources; i++)
+      {
+      if ( haveSource[i] )
+        {
+        vtkGlyph3DPrepareSource(this->GetSource(i, sourceVector),
+                                this->SourceTransform, haveNormals != 0,
+                                false, sources[i]);
+        }
+      }
     }
   else
     {
-    sourcePts = source->GetPoints();
-    numSourcePts = sourcePts->GetNumberOfPoints();
-    numSourceCells = source->GetNumberOfCells();
+    haveNormals = source->GetPointData()->GetNormals() ? 1 : 0;
+    haveTCoords = source->GetPointData()->GetTCoords() ? 1 : 0;
+    sources.resize(1);
+    haveSource.resize(1, true);
+    vtkGlyph3DPrepareSource(source, this->SourceTransform, haveNormals != 0,
+                            haveTCoords != 0, sources[0]);
+    pd = input->GetPointData();
+    }
 
-    sourceNormals = source->GetPointData()->GetNormals();
-    if ( sourceNormals )
+  // Find the glyph of each input point, -1 for points without glyph, and
+  // the size of the output glyphs of each block of points.
+  vtkGlyph3DPointParameters parameters;
+  parameters.ScaleScalars = inSScalars;
+  parameters.Vectors = array3D;
+  parameters.ScaleMode = this->ScaleMode;
+  parameters.Clamping = this->Clamping;
+  parameters.Range[0] = this->Range[0];
+  parameters.Range[1] = this->Range[1];
+  parameters.Den = den;
+  parameters.IndexMode = this->IndexMode;
+  parameters.NumberOfSources = numberOfSources;
+
+  vtkIdType numBlocks =
+    (numPts + VTK_GLYPH3D_BLOCK_SIZE - 1) / VTK_GLYPH3D_BLOCK_SIZE;
+  std::vector<int> glyphs(numPts, -1);
+  std::vector<vtkGlyph3DOffsets> offsets(numBlocks + 1);
+  vtkGlyph3DOffsets total;
+  total.Points = 0;
+  for (k = 0; k < VTK_GLYPH3D_CELL_TYPES; ++k)
+    {
+    total.Cells[k] = total.Connectivity[k] = 0;
+    }
+  double scale[3], v[3], vMag;
+  for (inPtId=0; inPtId < numPts; inPtId++)
+    {
+    if ( ! (inPtId % VTK_GLYPH3D_BLOCK_SIZE) )
       {
-      haveNormals = 1;
+      offsets[inPtId / VTK_GLYPH3D_BLOCK_SIZE] = total;
       }
-    else
+    if ( ! (inPtId % 10000) )
       {
-      haveNormals = 0;
+      this->UpdateProgress(0.1*inPtId/numPts);
+      if (this->GetAbortExecute())
+        {
+        break;
+        }
       }
 
-    sourceTCoords = source->GetPointData()->GetTCoords();
-    if (sourceTCoords)
+    // Make sure we're not indexing into empty glyph
+    int index = this->IndexMode == VTK_INDEXING_OFF ? 0 :
+      parameters.Evaluate(inPtId, scale, v, vMag);
+    if ( index < 0 || !haveSource[index] )
       {
-      haveTCoords = 1;
+      continue;
       }
-    else
+
+    // Check ghost points.
+    // If we are processing a piece, we do not want to duplicate
+    // glyphs on the borders.
+    if (inGhostLevels &&
+        inGhostLevels[inPtId] & vtkDataSetAttributes::DUPLICATEPOINT)
       {
-      haveTCoords = 0;
+      continue;
       }
 
-    // Prepare to copy output.
-    pd = input->GetPointData();
-    outputPD->CopyAllocate(pd,numPts*numSourcePts);
-    if (this->FillCellData)
+    if (inputUG && !inputUG->IsPointVisible(inPtId))
       {
-      outputCD->CopyAllocate(pd,numPts*numSourceCells);
+      // input is a vtkUniformGrid and the current point is blanked. Don't glyph
+      // it.
+      continue;
       }
+
+    if (!this->IsPointVisible(input, inPtId))
+      {
+      continue;
+      }
+
+    glyphs[inPtId] = index;
+    total.Points += sources[index].NumberOfPoints;
+    for (k = 0; k < VTK_GLYPH3D_CELL_TYPES; ++k)
+      {
+      total.Cells[k] += sources[index].NumberOfCells[k];
+      total.Connectivity[k] += sources[index].ConnectivitySize[k];
+      }
+    }
+  for (vtkIdType block = (inPtId + VTK_GLYPH3D_BLOCK_SIZE - 1) /
+         VTK_GLYPH3D_BLOCK_SIZE; block <= numBlocks; ++block)
+    {
+    offsets[block] = total;
+    }
+  vtkIdType numOutPts = total.Points;
+  vtkIdType numOutCells = 0;
+  for (k = 0; k < VTK_GLYPH3D_CELL_TYPES; ++k)
+    {
+    numOutCells += total.Cells[k];
     }
 
-  srcPointIdList->SetNumberOfIds(numSourcePts);
-  dstPointIdList->SetNumberOfIds(numSourcePts);
-  srcCellIdList->SetNumberOfIds(numSourceCells);
-  dstCellIdList->SetNumberOfIds(numSourceCells);
+  // Allocate the output, and pair its arrays with the input arrays. Arrays
+  // that cannot be written by several threads are filled serially.
+  bool threadSafe = (!inSScalars || vtkArrayList::IsThreadSafe(inSScalars)) &&
+    (!array3D || vtkArrayList::IsThreadSafe(array3D));
+  vtkArrayList pointData;
+  vtkArrayList cellData;
+  if ( pd )
+    {
+    outputPD->CopyAllocate(pd, numOutPts);
+    pointData.AddArrays(numOutPts, pd, outputPD);
+    if (this->FillCellData)
+      {
+      outputCD->CopyAllocate(pd, numOutCells);
+      cellData.AddArrays(numOutCells, pd, outputCD);
+      }
+    threadSafe = threadSafe && vtkArrayList::IsThreadSafe(pd);
+    }
 
-  newPts = vtkPoints::New();
-  newPts->Allocate(numPts*numSourcePts);
+  vtkNew<vtkPoints> newPts;
+  newPts->SetNumberOfPoints(numOutPts);
+  vtkIdTypeArray *pointIds = NULL;
   if ( this->GeneratePointIds )
     {
     pointIds = vtkIdTypeArray::New();
     pointIds->SetName(this->PointIdsName);
-    pointIds->Allocate(numPts*numSourcePts);
+    pointIds->SetNumberOfValues(numOutPts);
     outputPD->AddArray(pointIds);
     pointIds->Delete();
     }
+  vtkDataArray *newScalars = NULL;
+  vtkArrayList colorScalars;
   if ( this->ColorMode == VTK_COLOR_BY_SCALAR && inCScalars )
     {
     newScalars = inCScalars->NewInstance();
     newScalars->SetNumberOfComponents(inCScalars->GetNumberOfComponents());
-    newScalars->Allocate(inCScalars->GetNumberOfComponents()*numPts*numSourcePts);
     newScalars->SetName(inCScalars->GetName());
+    colorScalars.AddArray(numOutPts, inCScalars, newScalars);
+    threadSafe = threadSafe && vtkArrayList::IsThreadSafe(inCScalars) &&
+      vtkArrayList::IsThreadSafe(newScalars);
     }
   else if ( (this->ColorMode == VTK_COLOR_BY_SCALE) && inSScalars)
     {
     newScalars = vtkFloatArray::New();
-    newScalars->Allocate(numPts*numSourcePts);
+    newScalars->SetNumberOfTuples(numOutPts);
     newScalars->SetName("GlyphScale");
     if (this->ScaleMode == VTK_SCALE_BY_SCALAR)
       {
@@ -363,342 +922,118 @@ bool vtkGlyph3D::Execute(
   else if ( (this->ColorMode == VTK_COLOR_BY_VECTOR) && haveVectors)
     {
     newScalars = vtkFloatArray::New();
-    newScalars->Allocate(numPts*numSourcePts);
+    newScalars->SetNumberOfTuples(numOutPts);
     newScalars->SetName("VectorMagnitude");
     }
+  vtkFloatArray *newVectors = NULL;
   if ( haveVectors )
     {
     newVectors = vtkFloatArray::New();
     newVectors->SetNumberOfComponents(3);
-    newVectors->Allocate(3*numPts*numSourcePts);
+    newVectors->SetNumberOfTuples(numOutPts);
     newVectors->SetName("GlyphVector");
     }
+  vtkFloatArray *newNormals = NULL;
   if ( haveNormals )
     {
     newNormals = vtkFloatArray::New();
     newNormals->SetNumberOfComponents(3);
-    newNormals->Allocate(3*numPts*numSourcePts);
+    newNormals->SetNumberOfTuples(numOutPts);
     newNormals->SetName("Normals");
     }
-  if (haveTCoords)
+  vtkFloatArray *newTCoords = NULL;
+  if ( haveTCoords )
     {
     newTCoords = vtkFloatArray::New();
-    int numComps = sourceTCoords->GetNumberOfComponents();
-    newTCoords->SetNumberOfComponents(numComps);
-    newTCoords->Allocate(numComps*numPts*numSourcePts);
+    newTCoords->SetNumberOfComponents(
+      source->GetPointData()->GetTCoords()->GetNumberOfComponents());
+    newTCoords->SetNumberOfTuples(numOutPts);
     newTCoords->SetName("TCoords");
     }
 
-  // Setting up for calls to PolyData::InsertNextCell()
-  if (this->IndexMode != VTK_INDEXING_OFF )
+  vtkSmartPointer<vtkIdTypeArray> connectivity[VTK_GLYPH3D_CELL_TYPES];
+  for (k = 0; k < VTK_GLYPH3D_CELL_TYPES; ++k)
     {
-    output->Allocate(3*numPts*numSourceCells,numPts*numSourceCells);
+    connectivity[k] = vtkSmartPointer<vtkIdTypeArray>::New();
+    connectivity[k]->SetNumberOfValues(total.Connectivity[k]);
     }
-  else
+
+  // Transform the glyphs and copy their attributes.
+  vtkGlyph3DFillBlocks fill;
+  fill.Input = input;
+  fill.NumberOfPoints = numPts;
+  fill.Glyphs = numPts ? &glyphs[0] : NULL;
+  fill.Sources = sources.empty() ? NULL : &sources[0];
+  fill.Offsets = &offsets[0];
+  fill.Parameters = &parameters;
+  fill.Scaling = this->Scaling;
+  fill.ScaleMode = this->ScaleMode;
+  fill.ScaleFactor = this->ScaleFactor;
+  fill.Orient = this->Orient;
+  fill.Points = static_cast<float*>(newPts->GetVoidPointer(0));
+  vtkIdType firstCell = 0;
+  for (k = 0; k < VTK_GLYPH3D_CELL_TYPES; ++k)
     {
-    output->Allocate(source,
-                     3*numPts*numSourceCells, numPts*numSourceCells);
+    fill.Cells[k] = connectivity[k]->GetPointer(0);
+    fill.FirstCell[k] = firstCell;
+    firstCell += total.Cells[k];
     }
-
-  transformedSourcePts->SetDataTypeToDouble();
-  transformedSourcePts->Allocate(numSourcePts);
-
-  // Traverse all Input points, transforming Source points and copying
-  // point attributes.
-  //
-  ptIncr=0;
-  cellIncr=0;
-  for (inPtId=0; inPtId < numPts; inPtId++)
+  fill.Scalars = NULL;
+  fill.ScalarsAreMagnitudes = this->ColorMode == VTK_COLOR_BY_VECTOR;
+  if (newScalars && colorScalars.GetNumberOfArrays() == 0)
     {
-    scalex = scaley = scalez = 1.0;
-    if ( ! (inPtId % 10000) )
-      {
-      this->UpdateProgress(static_cast<double>(inPtId)/numPts);
-      if (this->GetAbortExecute())
-        {
-        break;
-        }
-      }
-
-    // Get the scalar and vector data
-    if ( inSScalars )
-      {
-      s = inSScalars->GetComponent(inPtId, 0);
-      if ( this->ScaleMode == VTK_SCALE_BY_SCALAR ||
-           this->ScaleMode == VTK_DATA_SCALING_OFF )
-        {
-        scalex = scaley = scalez = s;
-        }
-      }
-
-    if ( haveVectors )
-      {
-      vtkDataArray *array3D = this->VectorMode == VTK_USE_NORMAL? inNormals : inVectors;
-      if(array3D->GetNumberOfComponents()>3)
-        {
-        vtkErrorMacro(<<"vtkDataArray "<<array3D->GetName()<<" has more than 3 components.\n");
-        pts->Delete();
-        trans->Delete();
-        if(newPts)
-          {
-          newPts->Delete();
-          }
-        if(newVectors)
-          {
-          newVectors->Delete();
-          }
-        return false;
-        }
-
-      v[0] = 0;
-      v[1] = 0;
-      v[2] = 0;
-      array3D->GetTuple(inPtId, v);
-      vMag = vtkMath::Norm(v);
-      if ( this->ScaleMode == VTK_SCALE_BY_VECTORCOMPONENTS )
-        {
-        scalex = v[0];
-        scaley = v[1];
-        scalez = v[2];
-        }
-      else if ( this->ScaleMode == VTK_SCALE_BY_VECTOR )
-        {
-        scalex = scaley = scalez = vMag;
-        }
-      }
-
-    // Clamp data scale if enabled
-    if ( this->Clamping )
-      {
-      scalex = (scalex < this->Range[0] ? this->Range[0] :
-                (scalex > this->Range[1] ? this->Range[1] : scalex));
-      scalex = (scalex - this->Range[0]) / den;
-      scaley = (scaley < this->Range[0] ? this->Range[0] :
-                (scaley > this->Range[1] ? this->Range[1] : scaley));
-      scaley = (scaley - this->Range[0]) / den;
-      scalez = (scalez < this->Range[0] ? this->Range[0] :
-                (scalez > this->Range[1] ? this->Range[1] : scalez));
-      scalez = (scalez - this->Range[0]) / den;
-      }
-
-    // Compute index into table of glyphs
-    if ( this->IndexMode != VTK_INDEXING_OFF )
-      {
-      if ( this->IndexMode == VTK_INDEXING_BY_SCALAR )
-        {
-        value = s;
-        }
-      else
-        {
-        value = vMag;
-        }
-
-      int index = static_cast<int>((value - this->Range[0])*numberOfSources / den);
-      index = (index < 0 ? 0 :
-              (index >= numberOfSources ? (numberOfSources-1) : index));
-
-      source = this->GetSource(index, sourceVector);
-      if ( source != NULL )
-        {
-        sourcePts = source->GetPoints();
-        sourceNormals = source->GetPointData()->GetNormals();
-        numSourcePts = sourcePts->GetNumberOfPoints();
-        numSourceCells = source->GetNumberOfCells();
-        }
-      }
-
-    // Make sure we're not indexing into empty glyph
-    if ( !source )
-      {
-      continue;
-      }
-
-    // Check ghost points.
-    // If we are processing a piece, we do not want to duplicate
-    // glyphs on the borders.
-    if (inGhostLevels &&
-        inGhostLevels[inPtId] & vtkDataSetAttributes::DUPLICATEPOINT)
-      {
-      continue;
-      }
-
-    if (inputUG && !inputUG->IsPointVisible(inPtId))
-      {
-      // input is a vtkUniformGrid and the current point is blanked. Don't glyph
-      // it.
-      continue;
-      }
-
-    if (!this->IsPointVisible(input, inPtId))
-      {
-      continue;
-      }
-
-    // Now begin copying/transforming glyph
-    trans->Identity();
-
-    // Copy all topology (transformation independent)
-    for (cellId=0; cellId < numSourceCells; cellId++)
-      {
-      source->GetCellPoints(cellId, pointIdList.GetPointer());
-      cellPts = pointIdList.GetPointer();
-      npts = cellPts->GetNumberOfIds();
-      for (pts->Reset(), i=0; i < npts; i++)
-        {
-        pts->InsertId(i, cellPts->GetId(i) + ptIncr);
-        }
-      output->InsertNextCell(source->GetCellType(cellId), pts);
-      }
-
-    // translate Source to Input point
-    input->GetPoint(inPtId, x);
-    trans->Translate(x[0], x[1], x[2]);
-
-    if ( haveVectors )
-      {
-      // Copy Input vector
-      for (i=0; i < numSourcePts; i++)
-        {
-        newVectors->InsertTuple(i+ptIncr, v);
-        }
-      if (this->Orient && (vMag > 0.0))
-        {
-        // if there is no y or z component
-        if ( v[1] == 0.0 && v[2] == 0.0 )
-          {
-          if (v[0] < 0) //just flip x if we need to
-            {
-            trans->RotateWXYZ(180.0,0,1,0);
-            }
-          }
-        else
-          {
-          vNew[0] = (v[0]+vMag) / 2.0;
-          vNew[1] = v[1] / 2.0;
-          vNew[2] = v[2] / 2.0;
-          trans->RotateWXYZ(180.0,vNew[0],vNew[1],vNew[2]);
-          }
-        }
-      }
-
-    if (haveTCoords)
-      {
-      for (i = 0; i < numSourcePts; i++)
-        {
-        sourceTCoords->GetTuple(i, tc);
-        newTCoords->InsertTuple(i+ptIncr, tc);
-        }
-      }
-
-    // determine scale factor from scalars if appropriate
-    // Copy scalar value
-    if (inSScalars && (this->ColorMode == VTK_COLOR_BY_SCALE))
-      {
-      for (i=0; i < numSourcePts; i++)
-        {
-        newScalars->InsertTuple(i+ptIncr, &scalex); // = scaley = scalez
-        }
-      }
-    else if (inCScalars && (this->ColorMode == VTK_COLOR_BY_SCALAR))
-      {
-      for (i=0; i < numSourcePts; i++)
-        {
-        outputPD->CopyTuple(inCScalars, newScalars, inPtId, ptIncr+i);
-        }
-      }
-    if (haveVectors && this->ColorMode == VTK_COLOR_BY_VECTOR)
-      {
-      for (i=0; i < numSourcePts; i++)
-        {
-        newScalars->InsertTuple(i+ptIncr, &vMag);
-        }
-      }
-
-    // scale data if appropriate
-    if ( this->Scaling )
-      {
-      if ( this->ScaleMode == VTK_DATA_SCALING_OFF )
-        {
-        scalex = scaley = scalez = this->ScaleFactor;
-        }
-      else
-        {
-        scalex *= this->ScaleFactor;
-        scaley *= this->ScaleFactor;
-        scalez *= this->ScaleFactor;
-        }
-
-      if ( scalex == 0.0 )
-        {
-        scalex = 1.0e-10;
-        }
-      if ( scaley == 0.0 )
-        {
-        scaley = 1.0e-10;
-        }
-      if ( scalez == 0.0 )
-        {
-        scalez = 1.0e-10;
-        }
-      trans->Scale(scalex,scaley,scalez);
-      }
-
-    // multiply points and normals by resulting matrix
-    if (this->SourceTransform)
-      {
-      transformedSourcePts->Reset();
-      this->SourceTransform->TransformPoints(sourcePts, transformedSourcePts);
-      trans->TransformPoints(transformedSourcePts, newPts);
-      }
-    else
-      {
-      trans->TransformPoints(sourcePts,newPts);
-      }
-
-    if ( haveNormals )
-      {
-      trans->TransformNormals(sourceNormals,newNormals);
-      }
-
-    // Copy point data from source (if possible)
-    if ( pd )
-      {
-      for (i = 0; i < numSourcePts; ++i)
-        {
-        srcPointIdList->SetId(i, inPtId);
-        dstPointIdList->SetId(i, ptIncr + i);
-        }
-      outputPD->CopyData(pd, srcPointIdList.GetPointer(),
-                         dstPointIdList.GetPointer());
-      if (this->FillCellData)
-        {
-        for (i = 0; i < numSourceCells; ++i)
-          {
-          srcCellIdList->SetId(i, inPtId);
-          dstCellIdList->SetId(i, cellIncr + i);
-          }
-        outputCD->CopyData(pd, srcCellIdList.GetPointer(),
-                           dstCellIdList.GetPointer());
-        }
-      }
-
-    // If point ids are to be generated, do it here
-    if ( this->GeneratePointIds )
-      {
-      for (i=0; i < numSourcePts; i++)
-        {
-        pointIds->InsertNextValue(inPtId);
-        }
-      }
-
-    ptIncr += numSourcePts;
-    cellIncr += numSourceCells;
+    fill.Scalars = static_cast<vtkFloatArray*>(newScalars)->GetPointer(0);
+    }
+  fill.ColorScalars =
+    colorScalars.GetNumberOfArrays() ? &colorScalars : NULL;
+  fill.Vectors = newVectors ? newVectors->GetPointer(0) : NULL;
+  fill.Normals = newNormals ? newNormals->GetPointer(0) : NULL;
+  fill.TCoords = newTCoords ? newTCoords->GetPointer(0) : NULL;
+  fill.PointIds = pointIds ? pointIds->GetPointer(0) : NULL;
+  fill.PointData = pointData.GetNumberOfArrays() ? &pointData : NULL;
+  fill.CellData = cellData.GetNumberOfArrays() ? &cellData : NULL;
+
+  // GetPoint() is thread safe once called from a single thread.
+  double x[3];
+  input->GetPoint(0, x);
+  if (threadSafe)
+    {
+    vtkSMPTools::For(0, numBlocks, fill);
+    }
+  else
+    {
+    fill(0, numBlocks);
     }
+  this->UpdateProgress(1.0);
 
   // Update ourselves and release memory
   //
-  output->SetPoints(newPts);
-  newPts->Delete();
+  output->SetPoints(newPts.GetPointer());
+
+  vtkNew<vtkCellArray> verts, lines, polys, strips;
+  vtkCellArray *cells[VTK_GLYPH3D_CELL_TYPES] =
+    { verts.GetPointer(), lines.GetPointer(), polys.GetPointer(),
+      strips.GetPointer() };
+  for (k = 0; k < VTK_GLYPH3D_CELL_TYPES; ++k)
+    {
+    cells[k]->SetCells(total.Cells[k], connectivity[k]);
+    }
+  if (total.Cells[0])
+    {
+    output->SetVerts(verts.GetPointer());
+    }
+  if (total.Cells[1])
+    {
+    output->SetLines(lines.GetPointer());
+    }
+  if (total.Cells[2])
+    {
+    output->SetPolys(polys.GetPointer());
+    }
+  if (total.Cells[3])
+    {
+    output->SetStrips(strips.GetPointer());
+    }
 
   if (newScalars)
     {
@@ -725,10 +1060,6 @@ bool vtkGlyph3D::Execute(
     newTCoords->Delete();
     }
 
-  output->Squeeze();
-  trans->Delete();
-  pts->Delete();
-
   return true;
 }
 
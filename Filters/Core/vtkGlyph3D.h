@@ -65,6 +65,14 @@
 // color scalars by using the SetInputArrayToProcess methods in
 // vtkAlgorithm. The first array is scalars, the next vectors, the next
 // normals and finally color scalars.
+//
+// The glyph of each input point, and so the size of the output, is found
+// first. The glyphs are then transformed and their attributes copied in
+// parallel with vtkSMPTools, blocks of input points at a time. Glyph
+// sources with float points are transformed in single precision. The
+// output lists the vertices of all glyphs, then their lines, polygons and
+// strips, as vtkPolyData does for cells of several types. IsPointVisible()
+// is only called from the calling thread.
 
 // .SECTION See Also
 // vtkTensorGlyph
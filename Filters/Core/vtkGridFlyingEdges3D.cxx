@@ -0,0 +1,1553 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkGridFlyingEdges3D.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkGridFlyingEdges3D.h"
+
+#include "vtkMath.h"
+#include "vtkCellArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMarchingCubesTriangleCases.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkRectilinearGrid.h"
+#include "vtkSMPTools.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkStructuredGrid.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <algorithm>
+#include <vector>
+
+vtkStandardNewMacro(vtkGridFlyingEdges3D);
+
+//----------------------------------------------------------------------------
+// The geometry of a rectilinear grid: the coordinates along each axis,
+// starting at the first point of the extent being contoured.
+struct vtkGridFlyingEdges3DRectilinear
+{
+  const double *Coordinates[3];
+
+  void GetPoint(const vtkIdType ijk[3], double x[3]) const
+    {
+    x[0] = this->Coordinates[0][ijk[0]];
+    x[1] = this->Coordinates[1][ijk[1]];
+    x[2] = this->Coordinates[2][ijk[2]];
+    }
+
+  // Map the scalar differences ds between the points lo and hi steps away
+  // from ijk along each axis into a world space gradient.
+  void ComputeGradient(const vtkIdType ijk[3], const int lo[3],
+                       const int hi[3], const double ds[3], float g[3]) const
+    {
+    for (int i=0; i < 3; ++i)
+      {
+      const double *x = this->Coordinates[i] + ijk[i];
+      double dx = x[hi[i]] - x[lo[i]];
+      g[i] = static_cast<float>(dx != 0.0 ? ds[i] / dx : 0.0);
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+// The geometry of a structured grid: the explicit point coordinates,
+// starting at the first point of the extent being contoured, and the
+// increments (in coordinate values) between points along each axis.
+template <class TP>
+struct vtkGridFlyingEdges3DCurvilinear
+{
+  const TP *Points;
+  vtkIdType Incs[3];
+
+  void GetPoint(const vtkIdType ijk[3], double x[3]) const
+    {
+    const TP *p = this->Points + ijk[0]*this->Incs[0] +
+      ijk[1]*this->Incs[1] + ijk[2]*this->Incs[2];
+    x[0] = static_cast<double>(p[0]);
+    x[1] = static_cast<double>(p[1]);
+    x[2] = static_cast<double>(p[2]);
+    }
+
+  // The rows of the jacobian are the coordinate differences along the grid
+  // axes, the same differences the scalar differences ds were taken over;
+  // the gradient g solves jacobian * g = ds.
+  void ComputeGradient(const vtkIdType ijk[3], const int lo[3],
+                       const int hi[3], const double ds[3], float g[3]) const
+    {
+    const TP *p = this->Points + ijk[0]*this->Incs[0] +
+      ijk[1]*this->Incs[1] + ijk[2]*this->Incs[2];
+    double jacobian[3][3];
+    for (int i=0; i < 3; ++i)
+      {
+      const TP *p0 = p + lo[i]*this->Incs[i];
+      const TP *p1 = p + hi[i]*this->Incs[i];
+      for (int j=0; j < 3; ++j)
+        {
+        jacobian[i][j] = static_cast<double>(p1[j]) -
+          static_cast<double>(p0[j]);
+        }
+      }
+    if ( vtkMath::Determinant3x3(jacobian) == 0.0 )
+      {
+      g[0] = g[1] = g[2] = 0.0f;
+      return;
+      }
+    double gradient[3];
+    vtkMath::LinearSolve3x3(jacobian, ds, gradient);
+    g[0] = static_cast<float>(gradient[0]);
+    g[1] = static_cast<float>(gradient[1]);
+    g[2] = static_cast<float>(gradient[2]);
+    }
+};
+
+//----------------------------------------------------------------------------
+// The part of the input grid being contoured: its dimensions, the scalar
+// increments along each axis, and the ghost arrays (offset to the first
+// point and cell of the extent) used to skip blanked cells.
+struct vtkGridFlyingEdges3DInput
+{
+  vtkIdType Dims[3];
+  vtkIdType Incs[3];
+  const unsigned char *CellGhosts;
+  vtkIdType CellIncs[3];
+  const unsigned char *PointGhosts;
+  vtkIdType PointIncs[3];
+};
+
+//----------------------------------------------------------------------------
+// This templated class implements the heart of the algorithm. It is the
+// algorithm of vtkFlyingEdges3D, with point coordinates and gradients taken
+// from the grid geometry TGeometry rather than from an origin and spacing.
+template <class T, class TGeometry>
+class vtkGridFlyingEdges3DAlgorithm
+{
+public:
+  // Edge case table values.
+  enum EdgeClass {
+    Below = 0, //below isovalue
+    Above = 1, //above isovalue
+    LeftAbove = 1, //left vertex is above isovalue
+    RightAbove = 2, //right vertex is above isovalue
+    BothAbove = 3 //entire edge is above isovalue
+  };
+
+  // Dealing with boundary situations when processing grids.
+  enum CellClass {
+    Interior = 0,
+    MinBoundary = 1,
+    MaxBoundary = 2
+  };
+
+  // Edge-based case table to generate output triangle primitives, built
+  // from the MC case table when the class is instantiated.
+  unsigned char EdgeCases[256][16];
+
+  // A table to map old edge ids (as defined from vtkMarchingCubesCases) into
+  // the edge-based case table.
+  static const unsigned char EdgeMap[12];
+
+  // A table that lists voxel point ids as a function of edge ids (edge ids
+  // for edge-based case table).
+  static const unsigned char VertMap[12][2];
+
+  // A table describing vertex offsets (in index space) from the cube axes
+  // origin for each of the eight vertices of a voxel.
+  static const unsigned char VertOffsets[8][3];
+
+  // Which voxel edges intersect the contour, as a function of the voxel
+  // case number.
+  unsigned char EdgeUses[256][12];
+
+  // Flags indicate whether a particular case requires voxel axes to be
+  // processed.
+  unsigned char IncludesAxes[256];
+
+  // Algorithm-derived data. XCases tracks the x-row edge cases. The
+  // EdgeMetaData tracks information needed for parallel partitioning,
+  // and to enable generation of the output primitives without using
+  // a point locator.
+  unsigned char *XCases;
+  vtkIdType *EdgeMetaData;
+
+  // Internal variables used by the various algorithm methods.
+  T        *Scalars;
+  vtkIdType Dims[3];
+  vtkIdType Incs[3];
+  vtkIdType NumberOfEdges;
+  vtkIdType SliceOffset;
+  TGeometry Geometry;
+
+  // Blanking. When the grid has blanked cells, the cells are checked
+  // against the ghost arrays before generating triangles.
+  const unsigned char *CellGhosts;
+  vtkIdType CellIncs[3];
+  const unsigned char *PointGhosts;
+  vtkIdType PointIncs[3];
+  unsigned char Blanking;
+
+  // Output data. Threads write to partitioned memory.
+  T         *NewScalars;
+  vtkIdType *NewTris;
+  float     *NewPoints;
+  float     *NewGradients;
+  float     *NewNormals;
+  unsigned char NeedGradients;
+
+  // Setup algorithm
+  vtkGridFlyingEdges3DAlgorithm();
+
+  // The three main passes of the algorithm.
+  void ProcessXEdge(double value, T const * const inPtr, vtkIdType row, vtkIdType slice); //PASS 1
+  void ProcessYZEdges(vtkIdType row, vtkIdType slice); //PASS 2
+  void GenerateOutput(double value, T* inPtr, vtkIdType row, vtkIdType slice);//PASS 4
+
+  // Given the four x-edge cases defining this voxel, return the voxel case
+  // number.
+  unsigned char GetEdgeCase(unsigned char *ePtr[4])
+    {
+    return (*(ePtr[0]) | ((*(ePtr[1]))<<2) | ((*(ePtr[2]))<<4) | ((*(ePtr[3]))<<6));
+    }
+
+  // Return the number of contouring primitives for a particular edge case number.
+  unsigned char GetNumberOfPrimitives(unsigned char eCase)
+    { return this->EdgeCases[eCase][0]; }
+
+  // Return an array indicating which voxel edges intersect the contour.
+  unsigned char *GetEdgeUses(unsigned char eCase)
+    { return this->EdgeUses[eCase]; }
+
+  // Indicate whether voxel axes need processing for this case.
+  unsigned char CaseIncludesAxes(unsigned char eCase)
+    { return this->IncludesAxes[eCase]; }
+
+  // Return whether the voxel (i,j,k) is visible, i.e. neither the cell nor
+  // any of its points is blanked.
+  bool IsCellVisible(vtkIdType i, vtkIdType j, vtkIdType k)
+    {
+      if ( this->CellGhosts &&
+           (this->CellGhosts[i*this->CellIncs[0] + j*this->CellIncs[1] +
+                             k*this->CellIncs[2]] &
+            (vtkDataSetAttributes::HIDDENCELL |
+             vtkDataSetAttributes::REFINEDCELL)) )
+        {
+        return false;
+        }
+      if ( this->PointGhosts )
+        {
+        const unsigned char *p = this->PointGhosts + i*this->PointIncs[0] +
+          j*this->PointIncs[1] + k*this->PointIncs[2];
+        for (int v=0; v < 8; ++v)
+          {
+          const unsigned char *offsets = this->VertOffsets[v];
+          if ( p[offsets[0]*this->PointIncs[0] + offsets[1]*this->PointIncs[1] +
+                 offsets[2]*this->PointIncs[2]] &
+               vtkDataSetAttributes::HIDDENPOINT )
+            {
+            return false;
+            }
+          }
+        }
+      return true;
+    }
+
+  // Count edge intersections near grid boundaries.
+  void CountBoundaryYZInts(unsigned char loc, unsigned char *edgeCases,
+                           vtkIdType *eMD[4]);
+
+  // Produce the output triangles for this voxel cell.
+  void GenerateTris(unsigned char eCase, unsigned char numTris, vtkIdType *eIds,
+                    vtkIdType &triId)
+    {
+      vtkIdType *tri;
+      const unsigned char *edges = this->EdgeCases[eCase] + 1;
+      for (int i=0; i < numTris; ++i, edges+=3)
+        {
+        tri = this->NewTris + 4*triId++;
+        tri[0] = 3;
+        tri[1] = eIds[edges[0]];
+        tri[2] = eIds[edges[1]];
+        tri[3] = eIds[edges[2]];
+        }
+    }
+
+  // Compute the gradient at the grid point ijk, whose scalar is *s, with
+  // central differences in the interior and one-sided differences on the
+  // boundary of the grid.
+  void ComputeGradient(const vtkIdType ijk[3], T const * const s, float g[3])
+    {
+      int lo[3], hi[3];
+      double ds[3];
+      for (int i=0; i < 3; ++i)
+        {
+        lo[i] = (ijk[i] > 0 ? -1 : 0);
+        hi[i] = (ijk[i] < (this->Dims[i]-1) ? 1 : 0);
+        ds[i] = static_cast<double>(*(s + hi[i]*this->Incs[i])) -
+          static_cast<double>(*(s + lo[i]*this->Incs[i]));
+        }
+      this->Geometry.ComputeGradient(ijk, lo, hi, ds, g);
+    }
+
+  // Interpolate the gradients g0 and g1 into the output point vId, and
+  // derive its normal.
+  void InterpolateGradient(double t, const float g0[3], const float g1[3],
+                           vtkIdType vId)
+    {
+      float gTmp[3];
+      float *g = ( this->NewGradients ? this->NewGradients + 3*vId : gTmp );
+      g[0] = g0[0] + t*(g1[0]-g0[0]);
+      g[1] = g0[1] + t*(g1[1]-g0[1]);
+      g[2] = g0[2] + t*(g1[2]-g0[2]);
+
+      if ( this->NewNormals )
+        {
+        float *n = this->NewNormals + 3*vId;
+        n[0] = -g[0];
+        n[1] = -g[1];
+        n[2] = -g[2];
+        vtkMath::Normalize(n);
+        }
+    }
+
+  // Interpolate along a voxel axes edge, from the voxel origin x0 (with
+  // gradient g0) to the grid point ijk1 whose scalar is *s1.
+  void InterpolateAxesEdge(double t, const double x0[3], const float g0[3],
+                           const vtkIdType ijk1[3], T const * const s1,
+                           vtkIdType vId)
+    {
+      double x1[3];
+      this->Geometry.GetPoint(ijk1, x1);
+      float *x = this->NewPoints + 3*vId;
+      x[0] = x0[0] + t*(x1[0]-x0[0]);
+      x[1] = x0[1] + t*(x1[1]-x0[1]);
+      x[2] = x0[2] + t*(x1[2]-x0[2]);
+
+      if ( this->NeedGradients )
+        {
+        float g1[3];
+        this->ComputeGradient(ijk1, s1, g1);
+        this->InterpolateGradient(t, g0, g1, vId);
+        }
+    }
+
+  // Interpolate along an arbitrary edge, typically one that may be on the
+  // grid boundary.
+  void InterpolateEdge(double value, const vtkIdType ijk[3],
+                       T const * const s, unsigned char edgeNum,
+                       unsigned char const* const edgeUses,
+                       vtkIdType *eIds);
+
+  // Produce the output points on the voxel axes for this voxel cell.
+  void GeneratePoints(double value, unsigned char loc, const vtkIdType ijk[3],
+                      T const * const sPtr,
+                      unsigned char const * const edgeUses,
+                      vtkIdType *eIds);
+
+  // Helper function to set up the point ids on voxel edges.
+  unsigned char InitVoxelIds(unsigned char *ePtr[4], vtkIdType *eMD[4],
+                             vtkIdType *eIds)
+    {
+      unsigned char eCase = GetEdgeCase(ePtr);
+      eIds[0] = eMD[0][0]; //x-edges
+      eIds[1] = eMD[1][0];
+      eIds[2] = eMD[2][0];
+      eIds[3] = eMD[3][0];
+      eIds[4] = eMD[0][1]; //y-edges
+      eIds[5] = eIds[4] + this->EdgeUses[eCase][4];
+      eIds[6] = eMD[2][1];
+      eIds[7] = eIds[6] + this->EdgeUses[eCase][6];
+      eIds[8] = eMD[0][2]; //z-edges
+      eIds[9] = eIds[8] + this->EdgeUses[eCase][8];
+      eIds[10] = eMD[1][2];
+      eIds[11] = eIds[10] + this->EdgeUses[eCase][10];
+      return eCase;
+    }
+
+  // Helper function to advance the point ids along voxel rows.
+  void AdvanceVoxelIds(unsigned char eCase, vtkIdType *eIds)
+    {
+      eIds[0] += this->EdgeUses[eCase][0]; //x-edges
+      eIds[1] += this->EdgeUses[eCase][1];
+      eIds[2] += this->EdgeUses[eCase][2];
+      eIds[3] += this->EdgeUses[eCase][3];
+      eIds[4] += this->EdgeUses[eCase][4]; //y-edges
+      eIds[5] = eIds[4] + this->EdgeUses[eCase][5];
+      eIds[6] += this->EdgeUses[eCase][6];
+      eIds[7] = eIds[6] + this->EdgeUses[eCase][7];
+      eIds[8] += this->EdgeUses[eCase][8]; //z-edges
+      eIds[9] = eIds[8] + this->EdgeUses[eCase][9];
+      eIds[10] += this->EdgeUses[eCase][10];
+      eIds[11] = eIds[10] + this->EdgeUses[eCase][11];
+    }
+
+  // Threading integration via SMPTools
+  class Pass1
+    {
+    public:
+      vtkGridFlyingEdges3DAlgorithm *Algo;
+      double Value;
+      Pass1(vtkGridFlyingEdges3DAlgorithm *algo, double value)
+        {this->Algo = algo; this->Value = value;}
+      void  operator()(vtkIdType slice, vtkIdType end)
+        {
+        vtkIdType row;
+        T *rowPtr, *slicePtr = this->Algo->Scalars + slice*this->Algo->Incs[2];
+        for ( ; slice < end; ++slice )
+          {
+          for (row=0, rowPtr=slicePtr; row < this->Algo->Dims[1]; ++row)
+            {
+            this->Algo->ProcessXEdge(this->Value, rowPtr, row, slice);
+            rowPtr += this->Algo->Incs[1];
+            }//for all rows in this slice
+          slicePtr += this->Algo->Incs[2];
+          }//for all slices in this batch
+        }
+    };
+  class Pass2
+    {
+    public:
+      Pass2(vtkGridFlyingEdges3DAlgorithm *algo)
+        {this->Algo = algo;}
+      vtkGridFlyingEdges3DAlgorithm *Algo;
+      void  operator()(vtkIdType slice, vtkIdType end)
+        {
+        for ( ; slice < end; ++slice)
+          {
+          for ( vtkIdType row=0; row < (this->Algo->Dims[1]-1); ++row)
+            {
+            this->Algo->ProcessYZEdges(row, slice);
+            }//for all rows in this slice
+          }//for all slices in this batch
+        }
+    };
+  class Pass4
+    {
+    public:
+      Pass4(vtkGridFlyingEdges3DAlgorithm *algo, double value)
+        {this->Algo = algo; this->Value = value;}
+      vtkGridFlyingEdges3DAlgorithm *Algo;
+      double Value;
+      void  operator()(vtkIdType slice, vtkIdType end)
+        {
+        vtkIdType row;
+        vtkIdType *eMD0 = this->Algo->EdgeMetaData + slice*6*this->Algo->Dims[1];
+        vtkIdType *eMD1 = eMD0 + 6*this->Algo->Dims[1];
+        T *rowPtr, *slicePtr = this->Algo->Scalars + slice*this->Algo->Incs[2];
+        for ( ; slice < end; ++slice )
+          {
+          // It's possible to skip entire slices if there is nothing to
+          // generate. With blanking, a slice may have points but no
+          // triangles, so it is always processed.
+          if ( this->Algo->Blanking || eMD1[3] > eMD0[3] )
+            {
+            for (row=0, rowPtr=slicePtr; row < this->Algo->Dims[1]-1; ++row)
+              {
+              this->Algo->GenerateOutput(this->Value, rowPtr, row, slice);
+              rowPtr += this->Algo->Incs[1];
+              }//for all rows in this slice
+            }//if there are triangles
+          slicePtr += this->Algo->Incs[2];
+          eMD0 = eMD1;
+          eMD1 = eMD0 + 6*this->Algo->Dims[1];
+          }//for all slices in this batch
+        }
+    };
+
+  // Interface between VTK and templated functions
+  static void Contour(vtkGridFlyingEdges3D *self,
+                      const vtkGridFlyingEdges3DInput &input,
+                      const TGeometry &geometry, T *scalars,
+                      vtkPoints *newPts, vtkCellArray *newTris,
+                      vtkDataArray *newScalars, vtkFloatArray *newNormals,
+                      vtkFloatArray *newGradients);
+};
+
+//----------------------------------------------------------------------------
+// Map MC edges numbering to use the saner FlyingEdges edge numbering scheme.
+template <class T, class TGeometry> const unsigned char
+vtkGridFlyingEdges3DAlgorithm<T,TGeometry>::
+EdgeMap[12] = {0,5,1,4,2,7,3,6,8,9,10,11};
+
+//----------------------------------------------------------------------------
+// Map MC edges numbering to use the saner FlyingEdges edge numbering scheme.
+template <class T, class TGeometry> const unsigned char
+vtkGridFlyingEdges3DAlgorithm<T,TGeometry>::
+VertMap[12][2] = {{0,1}, {2,3}, {4,5}, {6,7}, {0,2}, {1,3}, {4,6}, {5,7},
+                  {0,4}, {1,5}, {2,6}, {3,7}};
+
+//----------------------------------------------------------------------------
+// The offsets of each vertex (in index space) from the voxel axes origin.
+template <class T, class TGeometry> const unsigned char
+vtkGridFlyingEdges3DAlgorithm<T,TGeometry>::
+VertOffsets[8][3] = {{0,0,0}, {1,0,0}, {0,1,0}, {1,1,0},
+                     {0,0,1}, {1,0,1}, {0,1,1}, {1,1,1}};
+
+//----------------------------------------------------------------------------
+// Instantiate and initialize key data members. Mostly we build the
+// edge-based case table, and associated acceleration structures, from the
+// marching cubes case table, as vtkFlyingEdges3D does.
+template <class T, class TGeometry>
+vtkGridFlyingEdges3DAlgorithm<T,TGeometry>::
+vtkGridFlyingEdges3DAlgorithm():XCases(NULL),EdgeMetaData(NULL),
+                                CellGhosts(NULL),PointGhosts(NULL),
+                                Blanking(0),NewScalars(NULL),NewTris(NULL),
+                                NewPoints(NULL),NewGradients(NULL),
+                                NewNormals(NULL),NeedGradients(0)
+{
+  int i, j, k, l, ii, eCase, index, numTris;
+  static int vertMap[8] = {0,1,3,2,4,5,7,6};
+  static int CASE_MASK[8] = {1,2,4,8,16,32,64,128};
+  EDGE_LIST *edge;
+  vtkMarchingCubesTriangleCases *triCase;
+  unsigned char *edgeCase;
+
+  // Initialize cases, increments, and edge intersection flags
+  for (eCase=0; eCase<256; ++eCase)
+    {
+    for (j=0; j<16; ++j)
+      {
+      this->EdgeCases[eCase][j] = 0;
+      }
+    for (j=0; j<12; ++j)
+      {
+      this->EdgeUses[eCase][j] = 0;
+      }
+    this->IncludesAxes[eCase] = 0;
+    }
+
+  // The voxel, edge-based case table is a function of the four x-edge cases
+  // that define the voxel. Here we convert the existing MC vertex-based case
+  // table into a x-edge case table. Note that the four x-edges are ordered
+  // (0->3): x, x+y, x+z, x+y+z; the four y-edges are ordered (4->7): y, y+x,
+  // y+z, y+x+z; and the four z-edges are ordered (8->11): z, z+x, z+y,
+  // z+x+y.
+  for (l=0; l<4; ++l)
+    {
+    for (k=0; k<4; ++k)
+      {
+      for (j=0; j<4; ++j)
+        {
+        for (i=0; i<4; ++i)
+          {
+          eCase = i | (j<<2) | (k<<4) | (l<<6);
+          for ( ii=0, index = 0; ii < 8; ++ii)
+            {
+            if ( eCase & (1<<vertMap[ii]) ) //map into ancient MC table
+              {
+              index |= CASE_MASK[ii];
+              }
+            }
+          //Now build case table
+          triCase = vtkMarchingCubesTriangleCases::GetCases() + index;
+          for ( numTris=0, edge=triCase->edges; edge[0] > -1; edge += 3 )
+            {//count the number of triangles
+            numTris++;
+            }
+          if ( numTris > 0 )
+            {
+            edgeCase = this->EdgeCases[eCase];
+            *edgeCase++ = numTris;
+            for ( edge = triCase->edges; edge[0] > -1; edge += 3, edgeCase+=3 )
+              {
+              // Build new case table.
+              edgeCase[0] = this->EdgeMap[edge[0]];
+              edgeCase[1] = this->EdgeMap[edge[1]];
+              edgeCase[2] = this->EdgeMap[edge[2]];
+              }
+            }
+          }//x-edges
+        }//x+y-edges
+      }//x+z-edges
+    }//x+y+z-edges
+
+  // Okay now build the acceleration structure, a function of the
+  // particular case number.
+  for (eCase=0; eCase < 256; ++eCase)
+    {
+    edgeCase = this->EdgeCases[eCase];
+    numTris = *edgeCase++;
+
+    // Mark edges that are used by this case.
+    for (i=0; i < numTris*3; ++i) //just loop over all edges
+      {
+      this->EdgeUses[eCase][edgeCase[i]] = 1;
+      }
+
+    this->IncludesAxes[eCase] = this->EdgeUses[eCase][0] |
+      this->EdgeUses[eCase][4] | this->EdgeUses[eCase][8];
+
+    }//for all cases
+}
+
+//----------------------------------------------------------------------------
+// Count intersections along voxel axes. The voxel axes on the +x, +y and
+// +z boundaries of the grid are not fully formed and are treated specially.
+template <class T, class TGeometry>
+void vtkGridFlyingEdges3DAlgorithm<T,TGeometry>::
+CountBoundaryYZInts(unsigned char loc, unsigned char *edgeUses,
+                    vtkIdType *eMD[4])
+{
+  switch (loc)
+    {
+    case 2: //+x boundary
+      eMD[0][1] += edgeUses[5];
+      eMD[0][2] += edgeUses[9];
+      break;
+    case 8: //+y
+      eMD[1][2] += edgeUses[10];
+      break;
+    case 10://+x +y
+      eMD[0][1] += edgeUses[5];
+      eMD[0][2] += edgeUses[9];
+      eMD[1][2] += edgeUses[10];
+      eMD[1][2] += edgeUses[11];
+      break;
+    case 32://+z
+      eMD[2][1] += edgeUses[6];
+      break;
+    case 34: //+x +z
+      eMD[0][1] += edgeUses[5];
+      eMD[0][2] += edgeUses[9];
+      eMD[2][1] += edgeUses[6];
+      eMD[2][1] += edgeUses[7];
+      break;
+    case 40: //+y +z
+      eMD[2][1] += edgeUses[6];
+      eMD[1][2] += edgeUses[10];
+      break;
+    case 42: //+x +y +z happens no more than once per grid
+      eMD[0][1] += edgeUses[5];
+      eMD[0][2] += edgeUses[9];
+      eMD[1][2] += edgeUses[10];
+      eMD[1][2] += edgeUses[11];
+      eMD[2][1] += edgeUses[6];
+      eMD[2][1] += edgeUses[7];
+      break;
+    default: //uh-oh shouldn't happen
+      break;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Interpolate a new point along a boundary edge. The gradients at both ends
+// take the proximity to the boundary into account.
+template <class T, class TGeometry>
+void vtkGridFlyingEdges3DAlgorithm<T,TGeometry>::
+InterpolateEdge(double value, const vtkIdType ijk[3],
+                T const * const s, unsigned char edgeNum,
+                unsigned char const * const edgeUses,
+                vtkIdType *eIds)
+{
+  // if this edge is not used then get out
+  if ( ! edgeUses[edgeNum] )
+    {
+    return;
+    }
+
+  // build the edge information
+  const unsigned char *vertMap = this->VertMap[edgeNum];
+
+  double x0[3], x1[3];
+  vtkIdType ijk0[3], ijk1[3], vId=eIds[edgeNum];
+  int i;
+
+  const unsigned char *offsets = this->VertOffsets[vertMap[0]];
+  T const * const s0 = s + offsets[0]*this->Incs[0] +
+                           offsets[1]*this->Incs[1] +
+                           offsets[2]*this->Incs[2];
+  for (i=0; i<3; ++i)
+    {
+    ijk0[i] = ijk[i] + offsets[i];
+    }
+
+  offsets = this->VertOffsets[vertMap[1]];
+  T const * const s1 = s + offsets[0]*this->Incs[0] +
+                           offsets[1]*this->Incs[1] +
+                           offsets[2]*this->Incs[2];
+  for (i=0; i<3; ++i)
+    {
+    ijk1[i] = ijk[i] + offsets[i];
+    }
+
+  // Okay interpolate
+  this->Geometry.GetPoint(ijk0, x0);
+  this->Geometry.GetPoint(ijk1, x1);
+  double t = (value - static_cast<double>(*s0)) /
+    (static_cast<double>(*s1) - static_cast<double>(*s0));
+  float *xPtr = this->NewPoints + 3*vId;
+  xPtr[0] = x0[0] + t*(x1[0]-x0[0]);
+  xPtr[1] = x0[1] + t*(x1[1]-x0[1]);
+  xPtr[2] = x0[2] + t*(x1[2]-x0[2]);
+
+  if ( this->NeedGradients )
+    {
+    float g0[3], g1[3];
+    this->ComputeGradient(ijk0, s0, g0);
+    this->ComputeGradient(ijk1, s1, g1);
+    this->InterpolateGradient(t, g0, g1, vId);
+    }
+}
+
+//----------------------------------------------------------------------------
+// Generate the output points and optionally normals and gradients.
+template <class T, class TGeometry>
+void vtkGridFlyingEdges3DAlgorithm<T,TGeometry>::
+GeneratePoints(double value, unsigned char loc, const vtkIdType ijk[3],
+               T const * const sPtr,
+               unsigned char const * const edgeUses,
+               vtkIdType *eIds)
+{
+  double x[3];
+  this->Geometry.GetPoint(ijk, x);
+  float g0[3];
+  if ( this->NeedGradients )
+    {
+    this->ComputeGradient(ijk, sPtr, g0);
+    }
+
+  // Interpolate the cell axes edges
+  for(int i=0; i < 3; ++i)
+    {
+    if(edgeUses[i*4])
+      {
+      //edgesUses[0] == x axes edge
+      //edgesUses[4] == y axes edge
+      //edgesUses[8] == z axes edge
+      vtkIdType ijk1[3] = { ijk[0], ijk[1], ijk[2] }; ++ijk1[i];
+
+      T const * const sPtr2 = (sPtr+this->Incs[i]);
+      double t = (value - static_cast<double>(*sPtr)) /
+        (static_cast<double>(*sPtr2) - static_cast<double>(*sPtr));
+      this->InterpolateAxesEdge(t, x, g0, ijk1, sPtr2, eIds[i*4]);
+      }
+    }
+
+  // On the boundary cells special work has to be done to cover the partial
+  // cell axes on the +x,+y,+z grid boundaries. Note that loc is one of 27
+  // regions in the grid, with (0,1,2) indicating (interior, min, max) along
+  // coordinate axes.
+  switch (loc)
+    {
+    case 2: case 6: case 18: case 22: //+x
+      this->InterpolateEdge(value, ijk, sPtr, 5, edgeUses, eIds);
+      this->InterpolateEdge(value, ijk, sPtr, 9, edgeUses, eIds);
+      break;
+    case 8: case 9: case 24: case 25: //+y
+      this->InterpolateEdge(value, ijk, sPtr, 1, edgeUses, eIds);
+      this->InterpolateEdge(value, ijk, sPtr, 10, edgeUses, eIds);
+      break;
+    case 32: case 33: case 36: case 37: //+z
+      this->InterpolateEdge(value, ijk, sPtr, 2, edgeUses, eIds);
+      this->InterpolateEdge(value, ijk, sPtr, 6, edgeUses, eIds);
+      break;
+    case 10: case 26: //+x +y
+      this->InterpolateEdge(value, ijk, sPtr, 1, edgeUses, eIds);
+      this->InterpolateEdge(value, ijk, sPtr, 5, edgeUses, eIds);
+      this->InterpolateEdge(value, ijk, sPtr, 9, edgeUses, eIds);
+      this->InterpolateEdge(value, ijk, sPtr, 10, edgeUses, eIds);
+      this->InterpolateEdge(value, ijk, sPtr, 11, edgeUses, eIds);
+      break;
+    case 34: case 38: //+x +z
+      this->InterpolateEdge(value, ijk, sPtr, 2, edgeUses, eIds);
+      this->InterpolateEdge(value, ijk, sPtr, 5, edgeUses, eIds);
+      this->InterpolateEdge(value, ijk, sPtr, 9, edgeUses, eIds);
+      this->InterpolateEdge(value, ijk, sPtr, 6, edgeUses, eIds);
+      this->InterpolateEdge(value, ijk, sPtr, 7, edgeUses, eIds);
+      break;
+    case 40: case 41: //+y +z
+      this->InterpolateEdge(value, ijk, sPtr, 1, edgeUses, eIds);
+      this->InterpolateEdge(value, ijk, sPtr, 2, edgeUses, eIds);
+      this->InterpolateEdge(value, ijk, sPtr, 3, edgeUses, eIds);
+      this->InterpolateEdge(value, ijk, sPtr, 6, edgeUses, eIds);
+      this->InterpolateEdge(value, ijk, sPtr, 10, edgeUses, eIds);
+      break;
+    case 42: //+x +y +z happens no more than once per grid
+      this->InterpolateEdge(value, ijk, sPtr, 1, edgeUses, eIds);
+      this->InterpolateEdge(value, ijk, sPtr, 2, edgeUses, eIds);
+      this->InterpolateEdge(value, ijk, sPtr, 3, edgeUses, eIds);
+      this->InterpolateEdge(value, ijk, sPtr, 5, edgeUses, eIds);
+      this->InterpolateEdge(value, ijk, sPtr, 9, edgeUses, eIds);
+      this->InterpolateEdge(value, ijk, sPtr, 10, edgeUses, eIds);
+      this->InterpolateEdge(value, ijk, sPtr, 11, edgeUses, eIds);
+      this->InterpolateEdge(value, ijk, sPtr, 6, edgeUses, eIds);
+      this->InterpolateEdge(value, ijk, sPtr, 7, edgeUses, eIds);
+      break;
+    default: //interior, or -x,-y,-z boundaries
+      return;
+    }
+}
+
+//----------------------------------------------------------------------------
+// PASS 1: Process a single grid x-row (and all of the voxel edges that
+// compose the row). Determine the x-edges case classification, count the
+// number of x-edge intersections, and figure out where intersections along
+// the x-row begins and ends (i.e., gather information for computational
+// trimming).
+template <class T, class TGeometry>
+void vtkGridFlyingEdges3DAlgorithm<T,TGeometry>::
+ProcessXEdge(double value, T const* const inPtr, vtkIdType row, vtkIdType slice)
+{
+  vtkIdType nxcells=this->Dims[0]-1;
+  vtkIdType minInt=nxcells, maxInt = 0;
+  vtkIdType *edgeMetaData;
+  unsigned char *ePtr = this->XCases + slice*this->SliceOffset + row*nxcells;
+  double s0, s1 = static_cast<double>(*inPtr);
+
+  //run along the entire x-edge computing edge cases
+  edgeMetaData = this->EdgeMetaData + (slice*this->Dims[1] + row)*6;
+  std::fill_n(edgeMetaData, 6, 0);
+
+  vtkIdType sum = 0;
+
+  //pull this out help reduce false sharing
+  vtkIdType inc0 = this->Incs[0];
+
+  for (vtkIdType i=0; i < nxcells; ++i, ++ePtr)
+    {
+    s0 = s1;
+    s1 = static_cast<double>(*(inPtr + (i+1)*inc0));
+
+    unsigned char edgeCase = vtkGridFlyingEdges3DAlgorithm::Below;
+    if (s0 >= value)
+      {
+      edgeCase = vtkGridFlyingEdges3DAlgorithm::LeftAbove;
+      }
+    if( s1 >= value)
+      {
+      edgeCase |= vtkGridFlyingEdges3DAlgorithm::RightAbove;
+      }
+
+    *ePtr = edgeCase;
+
+    // if edge intersects contour
+    if ( edgeCase == vtkGridFlyingEdges3DAlgorithm::LeftAbove ||
+         edgeCase == vtkGridFlyingEdges3DAlgorithm::RightAbove )
+      {
+      ++sum; //increment number of intersections along x-edge
+      minInt = ( i < minInt ? i : minInt);
+      maxInt = i + 1;
+      }//if contour interacts with this x-edge
+    }//for all x-cell edges along this x-edge
+
+  edgeMetaData[0] += sum; //write back the number of intersections along x-edge
+
+  // The beginning and ending of intersections along the edge is used for
+  // computational trimming.
+  edgeMetaData[4] = minInt; //where intersections start along x edge
+  edgeMetaData[5] = maxInt; //where intersections end along x edge
+}
+
+//----------------------------------------------------------------------------
+// PASS 2: Process a single x-row of voxels. Count the number of y- and
+// z-intersections by topological reasoning from x-edge cases. Determine the
+// number of primitives (i.e., triangles) generated from this row; blanked
+// voxels generate none. Use computational trimming to reduce work.
+template <class T, class TGeometry>
+void vtkGridFlyingEdges3DAlgorithm<T,TGeometry>::
+ProcessYZEdges(vtkIdType row, vtkIdType slice)
+{
+  // Grab the four edge cases bounding this voxel x-row.
+  unsigned char *ePtr[4], ec0, ec1, ec2, ec3, xInts=1;
+  ePtr[0] = this->XCases + slice*this->SliceOffset + row*(this->Dims[0]-1);
+  ePtr[1] = ePtr[0] + this->Dims[0]-1;
+  ePtr[2] = ePtr[0] + this->SliceOffset;
+  ePtr[3] = ePtr[2] + this->Dims[0]-1;
+
+  // Grab the edge meta data surrounding the voxel row.
+  vtkIdType *eMD[4];
+  eMD[0] = this->EdgeMetaData + (slice*this->Dims[1] + row)*6; //this x-edge
+  eMD[1] = eMD[0] + 6; //x-edge in +y direction
+  eMD[2] = eMD[0] + this->Dims[1]*6; //x-edge in +z direction
+  eMD[3] = eMD[2] + 6; //x-edge in +y+z direction
+
+  // Determine whether this row of x-cells needs processing. If there are no
+  // x-edge intersections, and the state of the four bounding x-edges is the
+  // same, then there is no need for processing.
+  if ( (eMD[0][0] | eMD[1][0] | eMD[2][0] | eMD[3][0]) == 0 ) //any x-ints?
+    {
+    if ( *(ePtr[0]) == *(ePtr[1]) &&  *(ePtr[1]) == *(ePtr[2]) &&
+         *(ePtr[2]) == *(ePtr[3]) )
+      {
+      return; //there are no y- or z-ints, thus no contour, skip voxel row
+      }
+    else
+      {
+      xInts = 0; //there are y- or z- edge ints however
+      }
+    }
+
+  // Determine proximity to the boundary of the grid. This information is
+  // used to count edge intersections in boundary situations.
+  unsigned char loc, yLoc, zLoc, yzLoc;
+  yLoc = (row >= (this->Dims[1]-2) ? MaxBoundary : Interior);
+  zLoc = (slice >= (this->Dims[2]-2) ? MaxBoundary : Interior);
+  yzLoc = (yLoc << 2) | (zLoc << 4);
+
+  // The trim edges may need adjustment if the contour travels between rows
+  // of x-edges (without intersecting these x-edges).
+  vtkIdType xL=eMD[0][4], xR=eMD[0][5];
+  vtkIdType i;
+  if ( xInts )
+    {
+    for (i=1; i < 4; ++i)
+      {
+      xL = ( eMD[i][4] < xL ? eMD[i][4] : xL);
+      xR = ( eMD[i][5] > xR ? eMD[i][5] : xR);
+      }
+
+    if ( xL > 0 ) //if trimmed in the -x direction
+      {
+      ec0 = *(ePtr[0]+xL); ec1 = *(ePtr[1]+xL);
+      ec2 = *(ePtr[2]+xL); ec3 = *(ePtr[3]+xL);
+      if ( (ec0 & 0x1) != (ec1 & 0x1) || (ec1 & 0x1) != (ec2 & 0x1) ||
+           (ec2 & 0x1) != (ec3 & 0x1) )
+        {
+        xL = eMD[0][4] = 0; //reset left trim
+        }
+      }
+
+    if ( xR < (this->Dims[0]-1) ) //if trimmed in the +x direction
+      {
+      ec0 = *(ePtr[0]+xR); ec1 = *(ePtr[1]+xR);
+      ec2 = *(ePtr[2]+xR); ec3 = *(ePtr[3]+xR);
+      if ( (ec0 & 0x2) != (ec1 & 0x2) || (ec1 & 0x2) != (ec2 & 0x2) ||
+           (ec2 & 0x2) != (ec3 & 0x2) )
+        {
+        xR = eMD[0][5] = this->Dims[0]-1; //reset right trim
+        }
+      }
+    }
+  else //contour cuts through without intersecting x-edges, reset trim edges
+    {
+    xL = eMD[0][4] = 0;
+    xR = eMD[0][5] = this->Dims[0]-1;
+    }
+
+  // Okay run along the x-voxels and count the number of y- and
+  // z-intersections, and the number of primitives generated.
+  unsigned char *edgeUses, eCase, numTris;
+  ePtr[0] += xL; ePtr[1] += xL; ePtr[2] += xL; ePtr[3] += xL;
+  for (i=xL; i < xR; ++i) //run along the trimmed x-voxels
+    {
+    eCase = this->GetEdgeCase(ePtr);
+    if ( (numTris=this->GetNumberOfPrimitives(eCase)) > 0 )
+      {
+      // Okay let's increment the triangle count.
+      if ( ! this->Blanking || this->IsCellVisible(i, row, slice) )
+        {
+        eMD[0][3] += numTris;
+        }
+
+      // Count the number of y- and z-points to be generated. Points are
+      // generated for blanked voxels too, the ids along the row depend on
+      // them.
+      edgeUses = this->GetEdgeUses(eCase);
+      eMD[0][1] += edgeUses[4]; //y-voxel axes edge always counted
+      eMD[0][2] += edgeUses[8]; //z-voxel axes edge always counted
+      loc = yzLoc | (i >= (this->Dims[0]-2) ? MaxBoundary : Interior);
+      if ( loc != 0 )
+        {
+        this->CountBoundaryYZInts(loc,edgeUses,eMD);
+        }
+      }//if cell contains contour
+
+    // advance the four pointers along voxel row
+    ePtr[0]++; ePtr[1]++; ePtr[2]++; ePtr[3]++;
+    }//for all voxels along this x-edge
+}
+
+//----------------------------------------------------------------------------
+// PASS 4: Process the x-row cells to generate output primitives, including
+// point coordinates and triangles. This is the fourth and final pass of the
+// algorithm.
+template <class T, class TGeometry>
+void vtkGridFlyingEdges3DAlgorithm<T,TGeometry>::
+GenerateOutput(double value, T* rowPtr, vtkIdType row, vtkIdType slice)
+{
+  // Grab the edge meta data surrounding the voxel row.
+  vtkIdType *eMD[4];
+  eMD[0] = this->EdgeMetaData + (slice*this->Dims[1] + row)*6; //this x-edge
+  eMD[1] = eMD[0] + 6; //x-edge in +y direction
+  eMD[2] = eMD[0] + this->Dims[1]*6; //x-edge in +z direction
+  eMD[3] = eMD[2] + 6; //x-edge in +y+z direction
+
+  // Return if there is nothing to do (i.e., no triangles to generate)
+  if ( ! this->Blanking && eMD[0][3] == eMD[1][3] )
+    {
+    return;
+    }
+
+  // Find the voxel row trim edges, need to check all four x-edges to
+  // compute row trim edge.
+  vtkIdType xL=eMD[0][4], xR=eMD[0][5];
+  vtkIdType i;
+  for (i=1; i < 4; ++i)
+    {
+    xL = ( eMD[i][4] < xL ? eMD[i][4] : xL);
+    xR = ( eMD[i][5] > xR ? eMD[i][5] : xR);
+    }
+  if ( xL >= xR )
+    {
+    return;
+    }
+
+  // Grab the four edge cases bounding this voxel x-row. Begin at left trim edge.
+  unsigned char *ePtr[4];
+  ePtr[0] = this->XCases + slice*this->SliceOffset + row*(this->Dims[0]-1) + xL;
+  ePtr[1] = ePtr[0] + this->Dims[0]-1;
+  ePtr[2] = ePtr[0] + this->SliceOffset;
+  ePtr[3] = ePtr[2] + this->Dims[0]-1;
+
+  // Traverse all voxels in this row, those containing the contour are
+  // further identified for processing, meaning generating points and
+  // triangles. Begin by setting up point ids on voxel edges.
+  vtkIdType triId = eMD[0][3];
+  vtkIdType eIds[12]; //the ids of generated points
+
+  unsigned char eCase = this->InitVoxelIds(ePtr,eMD,eIds);
+
+  // Determine the proximity to the boundary of the grid.
+  unsigned char loc, yLoc, zLoc, yzLoc;
+  yLoc = (row < 1 ? MinBoundary :
+          (row >= (this->Dims[1]-2) ? MaxBoundary : Interior));
+  zLoc = (slice < 1 ? MinBoundary :
+          (slice >= (this->Dims[2]-2) ? MaxBoundary : Interior));
+  yzLoc = (yLoc << 2) | (zLoc << 4);
+
+  // Run along voxels in x-row direction and generate output primitives.
+  vtkIdType ijk[3] = { xL, row, slice};
+  const T* sPtr = rowPtr + xL*this->Incs[0];
+
+  for (i=xL; i < xR; ++i)
+    {
+    const unsigned char numTris = this->GetNumberOfPrimitives(eCase);
+    if ( numTris > 0 )
+      {
+      // Start by generating triangles for this case
+      if ( ! this->Blanking || this->IsCellVisible(i, row, slice) )
+        {
+        this->GenerateTris(eCase,numTris,eIds,triId);
+        }
+
+      // Now generate point(s) along voxel axes if needed. Remember to take
+      // boundary into account.
+      loc = yzLoc | (i < 1 ? MinBoundary :
+          (i >= (this->Dims[0]-2) ? MaxBoundary : Interior));
+      if ( this->CaseIncludesAxes(eCase) || loc != Interior )
+        {
+        unsigned char const * const edgeUses = this->GetEdgeUses(eCase);
+        this->GeneratePoints(value, loc, ijk, sPtr, edgeUses, eIds);
+        }
+      this->AdvanceVoxelIds(eCase,eIds);
+      }
+
+    // advance along voxel row
+    ePtr[0]++; ePtr[1]++; ePtr[2]++; ePtr[3]++;
+    eCase = this->GetEdgeCase(ePtr);
+
+    ++ijk[0];
+    sPtr += this->Incs[0];
+    } //for all non-trimmed cells along this x-edge
+}
+
+//----------------------------------------------------------------------------
+// This templated function interfaces the vtkGridFlyingEdges3D class with
+// the templated algorithm class. It also invokes the four passes of the
+// Flying Edges algorithm.
+template <class T, class TGeometry>
+void vtkGridFlyingEdges3DAlgorithm<T,TGeometry>::
+Contour(vtkGridFlyingEdges3D *self, const vtkGridFlyingEdges3DInput &input,
+        const TGeometry &geometry, T *scalars, vtkPoints *newPts,
+        vtkCellArray *newTris, vtkDataArray *newScalars,
+        vtkFloatArray *newNormals, vtkFloatArray *newGradients)
+{
+  double value, *values = self->GetValues();
+  int numContours = self->GetNumberOfContours();
+  vtkIdType vidx, row, slice, *eMD, zInc;
+  vtkIdType numOutXPts, numOutYPts, numOutZPts, numOutTris;
+  vtkIdType numXPts=0, numYPts=0, numZPts=0, numTris=0;
+  vtkIdType startXPts, startYPts, startZPts, startTris;
+  startXPts = startYPts = startZPts = startTris = 0;
+
+  // Capture the grid for subsequent processing.
+  vtkGridFlyingEdges3DAlgorithm<T,TGeometry> algo;
+  algo.Scalars = scalars;
+  algo.Geometry = geometry;
+  for (int i=0; i < 3; ++i)
+    {
+    algo.Dims[i] = input.Dims[i];
+    algo.Incs[i] = input.Incs[i];
+    algo.CellIncs[i] = input.CellIncs[i];
+    algo.PointIncs[i] = input.PointIncs[i];
+    }
+  algo.CellGhosts = input.CellGhosts;
+  algo.PointGhosts = input.PointGhosts;
+  algo.Blanking = (algo.CellGhosts || algo.PointGhosts ? 1 : 0);
+
+  // Now allocate working arrays. The XCases array tracks x-edge cases.
+  algo.NumberOfEdges = algo.Dims[1]*algo.Dims[2];
+  algo.SliceOffset = (algo.Dims[0]-1) * algo.Dims[1];
+  algo.XCases = new unsigned char [(algo.Dims[0]-1)*algo.NumberOfEdges];
+
+  // Also allocate the characterization (metadata) array for the x edges,
+  // as vtkFlyingEdges3D does: the number of x-, y- and z- intersections on
+  // the voxel axes along an x-edge, the number of output triangles, and the
+  // trim edges.
+  algo.EdgeMetaData = new vtkIdType [algo.NumberOfEdges*6];
+
+  // Loop across each contour value. This encompasses all four passes.
+  for (vidx = 0; vidx < numContours; vidx++)
+    {
+    value = values[vidx];
+
+    // PASS 1: Traverse all x-rows building edge cases and counting number of
+    // intersections.
+    Pass1 pass1(&algo,value);
+    vtkSMPTools::For(0,algo.Dims[2], pass1);
+
+    // PASS 2: Traverse all voxel x-rows and process voxel y&z edges.
+    Pass2 pass2(&algo);
+    vtkSMPTools::For(0,algo.Dims[2]-1, pass2);
+
+    // PASS 3: Update the edge meta data to partition the output into
+    // separate pieces so independent threads can write without collisions.
+    numOutXPts = startXPts;
+    numOutYPts = startYPts;
+    numOutZPts = startZPts;
+    numOutTris = startTris;
+
+    // Count number of points and tris generate along each cell row
+    for (slice=0; slice < algo.Dims[2]; ++slice)
+      {
+      zInc = slice * algo.Dims[1];
+      for (row=0; row < algo.Dims[1]; ++row)
+        {
+        eMD = algo.EdgeMetaData + (zInc+row)*6;
+        numXPts = eMD[0];
+        numYPts = eMD[1];
+        numZPts = eMD[2];
+        numTris = eMD[3];
+        eMD[0] = numOutXPts + numOutYPts + numOutZPts;
+        eMD[1] = eMD[0] + numXPts;
+        eMD[2] = eMD[1] + numYPts;
+        eMD[3] = numOutTris;
+        numOutXPts += numXPts;
+        numOutYPts += numYPts;
+        numOutZPts += numZPts;
+        numOutTris += numTris;
+        }
+      }
+
+    // Output can now be allocated.
+    vtkIdType totalPts = numOutXPts + numOutYPts + numOutZPts;
+    if ( totalPts > 0 )
+      {
+      newPts->GetData()->WriteVoidPointer(0,3*totalPts);
+      algo.NewPoints = static_cast<float*>(newPts->GetVoidPointer(0));
+      newTris->WritePointer(numOutTris,4*numOutTris);
+      algo.NewTris = static_cast<vtkIdType*>(newTris->GetPointer());
+      if (newScalars)
+        {
+        vtkIdType numPrevPts = newScalars->GetNumberOfTuples();
+        vtkIdType numNewPts = totalPts - numPrevPts;
+        newScalars->WriteVoidPointer(0,totalPts);
+        algo.NewScalars = static_cast<T*>(newScalars->GetVoidPointer(0));
+        T TValue = static_cast<T>(value);
+        std::fill_n(algo.NewScalars+numPrevPts, numNewPts, TValue);
+        }
+      if (newGradients)
+        {
+        newGradients->WriteVoidPointer(0,3*totalPts);
+        algo.NewGradients = static_cast<float*>(newGradients->GetVoidPointer(0));
+        }
+      if (newNormals)
+        {
+        newNormals->WriteVoidPointer(0,3*totalPts);
+        algo.NewNormals = static_cast<float*>(newNormals->GetVoidPointer(0));
+        }
+      algo.NeedGradients = (algo.NewGradients || algo.NewNormals ? 1 : 0);
+
+      // PASS 4: Fourth and final pass: Process voxel rows and generate output.
+      Pass4 pass4(&algo,value);
+      vtkSMPTools::For(0,algo.Dims[2]-1, pass4);
+      }//if anything generated
+
+    // Handle multiple contours
+    startXPts = numOutXPts;
+    startYPts = numOutYPts;
+    startZPts = numOutZPts;
+    startTris = numOutTris;
+    }// for all contour values
+
+  // Clean up and return
+  delete [] algo.XCases;
+  delete [] algo.EdgeMetaData;
+}
+
+//----------------------------------------------------------------------------
+// Deduce the algorithm from the scalar type and the grid geometry.
+template <class T, class TGeometry>
+void vtkGridFlyingEdges3DContour(vtkGridFlyingEdges3D *self,
+                                 const vtkGridFlyingEdges3DInput &input,
+                                 const TGeometry &geometry, T *scalars,
+                                 vtkPoints *newPts, vtkCellArray *newTris,
+                                 vtkDataArray *newScalars,
+                                 vtkFloatArray *newNormals,
+                                 vtkFloatArray *newGradients)
+{
+  vtkGridFlyingEdges3DAlgorithm<T,TGeometry>::
+    Contour(self, input, geometry, scalars, newPts, newTris, newScalars,
+            newNormals, newGradients);
+}
+
+//----------------------------------------------------------------------------
+// Dispatch on the scalar type for the given grid geometry.
+template <class TGeometry>
+void vtkGridFlyingEdges3DExecute(vtkGridFlyingEdges3D *self,
+                                 const vtkGridFlyingEdges3DInput &input,
+                                 const TGeometry &geometry, int dataType,
+                                 void *ptr, vtkPoints *newPts,
+                                 vtkCellArray *newTris,
+                                 vtkDataArray *newScalars,
+                                 vtkFloatArray *newNormals,
+                                 vtkFloatArray *newGradients)
+{
+  switch (dataType)
+    {
+    vtkTemplateMacro(vtkGridFlyingEdges3DContour(self, input, geometry,
+                                                 static_cast<VTK_TT*>(ptr),
+                                                 newPts, newTris, newScalars,
+                                                 newNormals, newGradients));
+    default:
+      vtkErrorWithObjectMacro(self, "Unsupported scalar type.");
+      break;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Here is the VTK class proper.
+// Construct object with a single contour value of 0.0.
+vtkGridFlyingEdges3D::vtkGridFlyingEdges3D()
+{
+  this->ContourValues = vtkContourValues::New();
+  this->ComputeNormals = 1;
+  this->ComputeGradients = 0;
+  this->ComputeScalars = 1;
+  this->ArrayComponent = 0;
+
+  // by default process active point scalars
+  this->SetInputArrayToProcess(0,0,0,vtkDataObject::FIELD_ASSOCIATION_POINTS,
+                               vtkDataSetAttributes::SCALARS);
+}
+
+//----------------------------------------------------------------------------
+vtkGridFlyingEdges3D::~vtkGridFlyingEdges3D()
+{
+  this->ContourValues->Delete();
+}
+
+//----------------------------------------------------------------------------
+// Overload standard modified time function. If contour values are modified,
+// then this object is modified as well.
+unsigned long vtkGridFlyingEdges3D::GetMTime()
+{
+  unsigned long mTime=this->Superclass::GetMTime();
+  unsigned long mTime2=this->ContourValues->GetMTime();
+  return ( mTime2 > mTime ? mTime2 : mTime );
+}
+
+//----------------------------------------------------------------------------
+int vtkGridFlyingEdges3D::RequestUpdateExtent(
+  vtkInformation *vtkNotUsed(request),
+  vtkInformationVector **inputVector,
+  vtkInformationVector *outputVector)
+{
+  // These require extra ghost levels
+  if (this->ComputeGradients || this->ComputeNormals)
+    {
+    vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
+    vtkInformation *outInfo = outputVector->GetInformationObject(0);
+
+    int ghostLevels;
+    ghostLevels =
+      outInfo->Get(
+        vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_GHOST_LEVELS());
+    inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_GHOST_LEVELS(),
+                ghostLevels + 1);
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkGridFlyingEdges3D::RequestData(
+  vtkInformation *request,
+  vtkInformationVector **inputVector,
+  vtkInformationVector *outputVector)
+{
+  vtkDebugMacro(<< "Executing 3D grid contour");
+
+  // get the info objects
+  vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+
+  // get the input and output
+  vtkDataObject *inputObject = inInfo->Get(vtkDataObject::DATA_OBJECT());
+  vtkRectilinearGrid *rGrid = vtkRectilinearGrid::SafeDownCast(inputObject);
+  vtkStructuredGrid *sGrid = vtkStructuredGrid::SafeDownCast(inputObject);
+  vtkPolyData *output = vtkPolyData::SafeDownCast(
+    outInfo->Get(vtkDataObject::DATA_OBJECT()));
+  if ( ! rGrid && ! sGrid )
+    {
+    vtkErrorMacro("Input must be a rectilinear or structured grid.");
+    return 0;
+    }
+  if ( sGrid && ! sGrid->GetPoints() )
+    {
+    vtkDebugMacro("No points to contour.");
+    return 0;
+    }
+
+  // to be safe recompute the update extent
+  this->RequestUpdateExtent(request,inputVector,outputVector);
+  vtkDataArray *inScalars = this->GetInputArrayToProcess(0,inputVector);
+
+  // Determine extent
+  int* inExt = ( rGrid ? rGrid->GetExtent() : sGrid->GetExtent() );
+  int exExt[6];
+  inInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), exExt);
+  for (int i=0; i<3; i++)
+    {
+    if (inExt[2*i] > exExt[2*i])
+      {
+      exExt[2*i] = inExt[2*i];
+      }
+    if (inExt[2*i+1] < exExt[2*i+1])
+      {
+      exExt[2*i+1] = inExt[2*i+1];
+      }
+    }
+  if ( exExt[0] >= exExt[1] || exExt[2] >= exExt[3] || exExt[4] >= exExt[5] )
+    {
+    vtkDebugMacro(<<"3D grid contours requires 3D data");
+    return 0;
+    }
+
+  // Check data type and execute appropriate function
+  //
+  if (inScalars == NULL)
+    {
+    vtkDebugMacro("No scalars for contouring.");
+    return 0;
+    }
+  int numComps = inScalars->GetNumberOfComponents();
+
+  if (this->ArrayComponent >= numComps)
+    {
+    vtkErrorMacro("Scalars have " << numComps << " components. "
+                  "ArrayComponent must be smaller than " << numComps);
+    return 0;
+    }
+
+  // Describe the extent being contoured within the input grid: its
+  // dimensions, and the offsets and increments of its points and cells.
+  vtkIdType inDims[3], pointOffset = 0, cellOffset = 0;
+  vtkIdType pointIncs[3], cellIncs[3];
+  vtkGridFlyingEdges3DInput input;
+  for (int i=0; i < 3; ++i)
+    {
+    inDims[i] = inExt[2*i+1] - inExt[2*i] + 1;
+    input.Dims[i] = exExt[2*i+1] - exExt[2*i] + 1;
+    }
+  pointIncs[0] = cellIncs[0] = 1;
+  pointIncs[1] = inDims[0];
+  pointIncs[2] = inDims[0]*inDims[1];
+  cellIncs[1] = inDims[0]-1;
+  cellIncs[2] = (inDims[0]-1)*(inDims[1]-1);
+  for (int i=0; i < 3; ++i)
+    {
+    pointOffset += (exExt[2*i] - inExt[2*i])*pointIncs[i];
+    cellOffset += (exExt[2*i] - inExt[2*i])*cellIncs[i];
+    input.Incs[i] = numComps*pointIncs[i];
+    input.PointIncs[i] = pointIncs[i];
+    input.CellIncs[i] = cellIncs[i];
+    }
+  input.CellGhosts = NULL;
+  input.PointGhosts = NULL;
+  if ( sGrid && sGrid->HasAnyBlankCells() )
+    {
+    vtkUnsignedCharArray *ghosts = sGrid->GetCellGhostArray();
+    if ( ghosts )
+      {
+      input.CellGhosts = ghosts->GetPointer(cellOffset);
+      }
+    ghosts = sGrid->GetPointGhostArray();
+    if ( ghosts && sGrid->HasAnyBlankPoints() )
+      {
+      input.PointGhosts = ghosts->GetPointer(pointOffset);
+      }
+    }
+  void *ptr = inScalars->GetVoidPointer(numComps*pointOffset +
+                                        this->ArrayComponent);
+
+  // Create necessary objects to hold output. We will defer the
+  // actual allocation to a later point.
+  vtkCellArray *newTris = vtkCellArray::New();
+  vtkPoints *newPts = vtkPoints::New();
+  newPts->SetDataTypeToFloat();
+  vtkDataArray *newScalars = NULL;
+  vtkFloatArray *newNormals = NULL;
+  vtkFloatArray *newGradients = NULL;
+
+  if (this->ComputeScalars)
+    {
+    newScalars = inScalars->NewInstance();
+    newScalars->SetNumberOfComponents(1);
+    newScalars->SetName(inScalars->GetName());
+    }
+  if (this->ComputeNormals)
+    {
+    newNormals = vtkFloatArray::New();
+    newNormals->SetNumberOfComponents(3);
+    newNormals->SetName("Normals");
+    }
+  if (this->ComputeGradients)
+    {
+    newGradients = vtkFloatArray::New();
+    newGradients->SetNumberOfComponents(3);
+    newGradients->SetName("Gradients");
+    }
+
+  // The coordinates of a rectilinear grid are gathered per axis; the points
+  // of a structured grid are used in place when they are float or double.
+  int dataType = inScalars->GetDataType();
+  if ( rGrid )
+    {
+    vtkDataArray *coordinates[3] = { rGrid->GetXCoordinates(),
+                                     rGrid->GetYCoordinates(),
+                                     rGrid->GetZCoordinates() };
+    std::vector<double> axes[3];
+    vtkGridFlyingEdges3DRectilinear geometry;
+    for (int i=0; i < 3; ++i)
+      {
+      axes[i].resize(input.Dims[i]);
+      for (vtkIdType j=0; j < input.Dims[i]; ++j)
+        {
+        axes[i][j] = coordinates[i]->GetComponent(exExt[2*i]-inExt[2*i]+j, 0);
+        }
+      geometry.Coordinates[i] = &axes[i][0];
+      }
+    vtkGridFlyingEdges3DExecute(this, input, geometry, dataType, ptr,
+                                newPts, newTris, newScalars, newNormals,
+                                newGradients);
+    }
+  else
+    {
+    vtkDataArray *points = sGrid->GetPoints()->GetData();
+    if ( points->GetDataType() == VTK_FLOAT )
+      {
+      vtkGridFlyingEdges3DCurvilinear<float> geometry;
+      geometry.Points = static_cast<float*>(
+        points->GetVoidPointer(3*pointOffset));
+      for (int i=0; i < 3; ++i)
+        {
+        geometry.Incs[i] = 3*pointIncs[i];
+        }
+      vtkGridFlyingEdges3DExecute(this, input, geometry, dataType, ptr,
+                                  newPts, newTris, newScalars, newNormals,
+                                  newGradients);
+      }
+    else
+      {
+      vtkDoubleArray *doublePoints = vtkDoubleArray::SafeDownCast(points);
+      if ( ! doublePoints )
+        {
+        doublePoints = vtkDoubleArray::New();
+        doublePoints->DeepCopy(points);
+        }
+      else
+        {
+        doublePoints->Register(this);
+        }
+      vtkGridFlyingEdges3DCurvilinear<double> geometry;
+      geometry.Points = doublePoints->GetPointer(3*pointOffset);
+      for (int i=0; i < 3; ++i)
+        {
+        geometry.Incs[i] = 3*pointIncs[i];
+        }
+      vtkGridFlyingEdges3DExecute(this, input, geometry, dataType, ptr,
+                                  newPts, newTris, newScalars, newNormals,
+                                  newGradients);
+      doublePoints->UnRegister(this);
+      }
+    }
+
+  vtkDebugMacro(<<"Created: "
+                << newPts->GetNumberOfPoints() << " points, "
+                << newTris->GetNumberOfCells() << " triangles");
+
+  // Update ourselves.
+  output->SetPoints(newPts);
+  newPts->Delete();
+
+  output->SetPolys(newTris);
+  newTris->Delete();
+
+  if (newScalars)
+    {
+    int idx = output->GetPointData()->AddArray(newScalars);
+    output->GetPointData()->SetActiveAttribute(idx, vtkDataSetAttributes::SCALARS);
+    newScalars->Delete();
+    }
+
+  if (newNormals)
+    {
+    int idx = output->GetPointData()->AddArray(newNormals);
+    output->GetPointData()->SetActiveAttribute(idx, vtkDataSetAttributes::NORMALS);
+    newNormals->Delete();
+    }
+
+  if (newGradients)
+    {
+    int idx = output->GetPointData()->AddArray(newGradients);
+    output->GetPointData()->SetActiveAttribute(idx, vtkDataSetAttributes::VECTORS);
+    newGradients->Delete();
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkGridFlyingEdges3D::FillInputPortInformation(int, vtkInformation *info)
+{
+  info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkRectilinearGrid");
+  info->Append(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkStructuredGrid");
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkGridFlyingEdges3D::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  this->ContourValues->PrintSelf(os,indent.GetNextIndent());
+
+  os << indent << "Compute Normals: " << (this->ComputeNormals ? "On\n" : "Off\n");
+  os << indent << "Compute Gradients: " << (this->ComputeGradients ? "On\n" : "Off\n");
+  os << indent << "Compute Scalars: " << (this->ComputeScalars ? "On\n" : "Off\n");
+  os << indent << "ArrayComponent: " << this->ArrayComponent << endl;
+}
@@ -0,0 +1,161 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkGridFlyingEdges3D.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkGridFlyingEdges3D - generate isosurface from rectilinear or structured grids
+// .SECTION Description
+// vtkGridFlyingEdges3D is the flying edges algorithm of vtkFlyingEdges3D
+// applied to vtkRectilinearGrid and vtkStructuredGrid inputs. It makes the
+// same four passes over the x-rows of the grid: x-edge cases are computed,
+// y-z edge intersections and triangles are counted per row, a prefix sum
+// assigns each row its place in the output, and the output points and
+// triangles are generated into pre-allocated arrays. The first, second and
+// fourth passes are threaded with vtkSMPTools.
+//
+// Where vtkFlyingEdges3D derives point coordinates from the origin and
+// spacing of the image, this filter interpolates between the coordinates of
+// the grid points: the per-axis coordinates of a rectilinear grid or the
+// explicit points of a structured grid. Gradients are computed by central
+// differences in index space (one-sided on the boundary), mapped to world
+// space with the differences of the point coordinates along the three grid
+// axes.
+
+// .SECTION Caveats
+// This filter is specialized to 3D grids. Like vtkFlyingEdges3D it can
+// produce degenerate triangles, and it produces float points, normals and
+// gradients whatever the precision of the input coordinates.
+//
+// Blanked cells of a structured grid produce no triangles. The points on
+// their edges are still generated, and are left unused in the output, as
+// vtkGridSynchronizedTemplates3D does.
+
+// .SECTION See Also
+// vtkFlyingEdges3D vtkRectilinearSynchronizedTemplates
+// vtkGridSynchronizedTemplates3D vtkContourFilter
+
+#ifndef vtkGridFlyingEdges3D_h
+#define vtkGridFlyingEdges3D_h
+
+#include "vtkFiltersCoreModule.h" // For export macro
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkContourValues.h" // Passes calls through
+
+class VTKFILTERSCORE_EXPORT vtkGridFlyingEdges3D : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkGridFlyingEdges3D *New();
+  vtkTypeMacro(vtkGridFlyingEdges3D,vtkPolyDataAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Because we delegate to vtkContourValues.
+  unsigned long int GetMTime();
+
+  // Description:
+  // Set/Get the computation of normals. Normal computation is fairly
+  // expensive in both time and storage. If the output data will be processed
+  // by filters that modify topology or geometry, it may be wise to turn
+  // Normals and Gradients off.
+  vtkSetMacro(ComputeNormals,int);
+  vtkGetMacro(ComputeNormals,int);
+  vtkBooleanMacro(ComputeNormals,int);
+
+  // Description:
+  // Set/Get the computation of gradients. Gradient computation is fairly
+  // expensive in both time and storage. Note that if ComputeNormals is on,
+  // gradients will have to be calculated, but will not be stored in the
+  // output dataset. If the output data will be processed by filters that
+  // modify topology or geometry, it may be wise to turn Normals and
+  // Gradients off.
+  vtkSetMacro(ComputeGradients,int);
+  vtkGetMacro(ComputeGradients,int);
+  vtkBooleanMacro(ComputeGradients,int);
+
+  // Description:
+  // Set/Get the computation of scalars.
+  vtkSetMacro(ComputeScalars,int);
+  vtkGetMacro(ComputeScalars,int);
+  vtkBooleanMacro(ComputeScalars,int);
+
+  // Description:
+  // Set a particular contour value at contour number i. The index i ranges
+  // between 0<=i<NumberOfContours.
+  void SetValue(int i, double value) {this->ContourValues->SetValue(i,value);}
+
+  // Description:
+  // Get the ith contour value.
+  double GetValue(int i) {return this->ContourValues->GetValue(i);}
+
+  // Description:
+  // Get a pointer to an array of contour values. There will be
+  // GetNumberOfContours() values in the list.
+  double *GetValues() {return this->ContourValues->GetValues();}
+
+  // Description:
+  // Fill a supplied list with contour values. There will be
+  // GetNumberOfContours() values in the list. Make sure you allocate
+  // enough memory to hold the list.
+  void GetValues(double *contourValues) {
+    this->ContourValues->GetValues(contourValues);}
+
+  // Description:
+  // Set the number of contours to place into the list. You only really
+  // need to use this method to reduce list size. The method SetValue()
+  // will automatically increase list size as needed.
+  void SetNumberOfContours(int number) {
+    this->ContourValues->SetNumberOfContours(number);}
+
+  // Description:
+  // Get the number of contours in the list of contour values.
+  int GetNumberOfContours() {
+    return this->ContourValues->GetNumberOfContours();}
+
+  // Description:
+  // Generate numContours equally spaced contour values between specified
+  // range. Contour values will include min/max range values.
+  void GenerateValues(int numContours, double range[2]) {
+    this->ContourValues->GenerateValues(numContours, range);}
+
+  // Description:
+  // Generate numContours equally spaced contour values between specified
+  // range. Contour values will include min/max range values.
+  void GenerateValues(int numContours, double rangeStart, double rangeEnd)
+    {this->ContourValues->GenerateValues(numContours, rangeStart, rangeEnd);}
+
+  // Description:
+  // Set/get which component of the scalar array to contour on; defaults to 0.
+  vtkSetMacro(ArrayComponent, int);
+  vtkGetMacro(ArrayComponent, int);
+
+protected:
+  vtkGridFlyingEdges3D();
+  ~vtkGridFlyingEdges3D();
+
+  int ComputeNormals;
+  int ComputeGradients;
+  int ComputeScalars;
+  int ArrayComponent;
+  vtkContourValues *ContourValues;
+
+  virtual int RequestData(vtkInformation *, vtkInformationVector **,
+                          vtkInformationVector *);
+  virtual int RequestUpdateExtent(vtkInformation *, vtkInformationVector **,
+                                  vtkInformationVector *);
+  virtual int FillInputPortInformation(int port, vtkInformation *info);
+
+private:
+  vtkGridFlyingEdges3D(const vtkGridFlyingEdges3D&);  // Not implemented.
+  void operator=(const vtkGridFlyingEdges3D&);  // Not implemented.
+};
+
+#endif
@@ -14,16 +14,72 @@
 =========================================================================*/
 #include "vtkPointDataToCellData.h"
 
+#include "vtkArrayListTemplate.h"
 #include "vtkCellData.h"
 #include "vtkDataSet.h"
 #include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <vector>
 
 vtkStandardNewMacro(vtkPointDataToCellData);
 
+namespace
+{
+bool vtkPointDataToCellDataIsThreadSafe(vtkArrayList &arrays)
+{
+  for (size_t i = 0; i < arrays.Pairs.size(); ++i)
+    {
+    if (!vtkArrayList::IsThreadSafe(arrays.Pairs[i]->Input) ||
+        !vtkArrayList::IsThreadSafe(arrays.Pairs[i]->Output))
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+// Set the tuples of each cell to the mean of the tuples of its points.
+// Each thread writes the tuples of its own cells only.
+struct vtkPointDataToCellDataAverage
+{
+  vtkDataSet *Input;
+  vtkArrayList *Arrays;
+  vtkSMPThreadLocalObject<vtkIdList> PointIds;
+  vtkSMPThreadLocal<std::vector<double> > Weights;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+    {
+    vtkIdList *&cellPts = this->PointIds.Local();
+    std::vector<double> &weights = this->Weights.Local();
+    for ( ; cellId < endCellId; ++cellId)
+      {
+      this->Input->GetCellPoints(cellId, cellPts);
+      vtkIdType numPts = cellPts->GetNumberOfIds();
+      if (static_cast<vtkIdType>(weights.size()) < numPts)
+        {
+        weights.resize(numPts);
+        }
+      if (numPts > 0)
+        {
+        std::fill_n(weights.begin(), numPts, 1.0 / numPts);
+        }
+      this->Arrays->Interpolate(static_cast<int>(numPts),
+                                cellPts->GetPointer(0),
+                                numPts > 0 ? &weights[0] : NULL, cellId);
+      }
+    }
+};
+}
+
 //----------------------------------------------------------------------------
 // Instantiate object so that point data is not passed to output.
 vtkPointDataToCellData::vtkPointDataToCellData()
@@ -45,14 +101,9 @@ int vtkPointDataToCellData::RequestData(
   vtkDataSet *input = vtkDataSet::SafeDownCast(
     inInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  vtkIdType cellId, ptId;
-  vtkIdType numCells, numPts;
+  vtkIdType numCells;
   vtkPointData *inPD=input->GetPointData();
   vtkCellData *outCD=output->GetCellData();
-  int maxCellSize=input->GetMaxCellSize();
-  vtkIdList *cellPts;
-  double weight;
-  double *weights;
 
   vtkDebugMacro(<<"Mapping point data to cell data");
 
@@ -64,10 +115,6 @@ int vtkPointDataToCellData::RequestData(
     vtkDebugMacro(<<"No input cells!");
     return 1;
     }
-  weights=new double[maxCellSize];
-
-  cellPts = vtkIdList::New();
-  cellPts->Allocate(maxCellSize);
 
   // Pass the cell data first. The fields and attributes
   // which also exist in the point data of the input will
@@ -76,30 +123,42 @@ int vtkPointDataToCellData::RequestData(
   output->GetCellData()->PassData(input->GetCellData());
   output->GetCellData()->CopyFieldOff(vtkDataSetAttributes::GhostArrayName());
 
-  // notice that inPD and outCD are vtkPointData and vtkCellData; respectively.
-  // It's weird, but it works.
-  outCD->InterpolateAllocate(inPD,numCells);
-
-  int abort=0;
-  vtkIdType progressInterval=numCells/20 + 1;
-  for (cellId=0; cellId < numCells && !abort; cellId++)
+  // notice that inPD and cellData are vtkPointData and vtkCellData;
+  // respectively. It's weird, but it works. The point data is interpolated
+  // into cell data of its own, so that the arrays passed from the input
+  // cell data are not paired with the point arrays of the same name.
+  vtkNew<vtkCellData> cellData;
+  cellData->CopyGlobalIdsOff();
+  cellData->CopyFieldOff(vtkDataSetAttributes::GhostArrayName());
+  cellData->InterpolateAllocate(inPD,numCells);
+  vtkArrayList arrays;
+  arrays.AddArrays(numCells, inPD, cellData.GetPointer());
+
+  // GetCellPoints() is thread safe once called from a single thread, which
+  // builds the cells of polydata.
+  vtkNew<vtkIdList> cellPts;
+  input->GetCellPoints(0, cellPts.GetPointer());
+
+  vtkPointDataToCellDataAverage average;
+  average.Input = input;
+  average.Arrays = &arrays;
+  if (vtkPointDataToCellDataIsThreadSafe(arrays))
     {
-    if ( !(cellId % progressInterval) )
-      {
-      this->UpdateProgress((double)cellId/numCells);
-      abort = GetAbortExecute();
-      }
+    vtkSMPTools::For(0, numCells, average);
+    }
+  else
+    {
+    average(0, numCells);
+    }
+  this->UpdateProgress(1.0);
 
-    input->GetCellPoints(cellId, cellPts);
-    numPts = cellPts->GetNumberOfIds();
-    if ( numPts > 0 )
+  for (int i = 0; i < cellData->GetNumberOfArrays(); ++i)
+    {
+    int idx = outCD->AddArray(cellData->GetAbstractArray(i));
+    int attributeType = cellData->IsArrayAnAttribute(i);
+    if (attributeType >= 0)
       {
-      weight = 1.0 / numPts;
-      for (ptId=0; ptId < numPts; ptId++)
-        {
-        weights[ptId] = weight;
-        }
-      outCD->InterpolatePoint(inPD, cellId, cellPts, weights);
+      outCD->SetActiveAttribute(idx, attributeType);
       }
     }
 
@@ -110,9 +169,6 @@ int vtkPointDataToCellData::RequestData(
     }
   output->GetPointData()->PassData(input->GetPointData());
 
-  cellPts->Delete();
-  delete [] weights;
-
   return 1;
 }
 
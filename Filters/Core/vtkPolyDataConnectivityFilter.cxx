@@ -17,20 +17,45 @@
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCell.h"
+#include "vtkConnectivityHelper.h"
 #include "vtkFloatArray.h"
 #include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
-#include "vtkMath.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 
-#include <algorithm> // for fill_n
+#include <vector>
 
 vtkStandardNewMacro(vtkPolyDataConnectivityFilter);
 
+// Flag the scalar connected cells in parallel.
+class vtkPolyDataConnectivityFilter::vtkCellScalarConnects
+{
+public:
+  vtkCellScalarConnects(vtkPolyDataConnectivityFilter *filter,
+                        unsigned char *connects) :
+    Filter(filter), Connects(connects)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+      this->Connects[cellId] =
+        static_cast<unsigned char>(this->Filter->IsScalarConnected(cellId));
+      }
+  }
+
+private:
+  vtkPolyDataConnectivityFilter *Filter;
+  unsigned char *Connects;
+};
+
 // Construct with default extraction mode to extract largest regions.
 vtkPolyDataConnectivityFilter::vtkPolyDataConnectivityFilter()
 {
@@ -45,12 +70,6 @@ vtkPolyDataConnectivityFilter::vtkPolyDataConnectivityFilter()
 
   this->ClosestPoint[0] = this->ClosestPoint[1] = this->ClosestPoint[2] = 0.0;
 
-  this->CellScalars = vtkFloatArray::New();
-  this->CellScalars->Allocate(8);
-
-  this->NeighborCellPointIds = vtkIdList::New();
-  this->NeighborCellPointIds->Allocate(8);
-
   this->Seeds = vtkIdList::New();
   this->SpecifiedRegionIds = vtkIdList::New();
 
@@ -58,16 +77,25 @@ vtkPolyDataConnectivityFilter::vtkPolyDataConnectivityFilter()
   this->VisitedPointIds = vtkIdList::New();
 
   this->OutputPointsPrecision = DEFAULT_PRECISION;
+
+  // deprecated members
+  this->CellScalars = vtkFloatArray::New();
+  this->CellScalars->Allocate(8);
+  this->NeighborCellPointIds = vtkIdList::New();
+  this->NeighborCellPointIds->Allocate(8);
+  this->PointNumber = 0;
+  this->NumCellsInRegion = 0;
+  this->CellIds = NULL;
 }
 
 vtkPolyDataConnectivityFilter::~vtkPolyDataConnectivityFilter()
 {
   this->RegionSizes->Delete();
-  this->CellScalars->Delete();
-  this->NeighborCellPointIds->Delete();
   this->Seeds->Delete();
   this->SpecifiedRegionIds->Delete();
   this->VisitedPointIds->Delete();
+  this->CellScalars->Delete();
+  this->NeighborCellPointIds->Delete();
 }
 
 int vtkPolyDataConnectivityFilter::RequestData(
@@ -88,9 +116,8 @@ int vtkPolyDataConnectivityFilter::RequestData(
   vtkIdType cellId, newCellId, i, pt;
   vtkPoints *inPts;
   vtkPoints *newPts;
-  vtkIdType *cells, *pts, npts, id, n;
-  unsigned short ncells;
-  vtkIdType maxCellsInRegion;
+  vtkIdType *pts, npts, id, n;
+  const vtkIdType *cells;
   vtkIdType largestRegionId = 0;
   vtkPointData *pd=input->GetPointData(), *outputPD=output->GetPointData();
   vtkCellData *cd=input->GetCellData(), *outputCD=output->GetCellData();
@@ -131,11 +158,11 @@ int vtkPolyDataConnectivityFilter::RequestData(
       }
     }
 
-  // Build cell structure
+  // Build cell structure. The cells are built before threads use them.
   //
   this->Mesh = vtkPolyData::New();
   this->Mesh->CopyStructure(input);
-  this->Mesh->BuildLinks();
+  this->Mesh->BuildCells();
   this->UpdateProgress(0.10);
 
   // Remove all visited point ids
@@ -145,9 +172,7 @@ int vtkPolyDataConnectivityFilter::RequestData(
   //
   this->RegionSizes->Reset();
   this->Visited = new vtkIdType[numCells];
-  std::fill_n(this->Visited, numCells, -1);
   this->PointMap = new vtkIdType[numPts];
-  std::fill_n(this->PointMap, numPts, -1);
 
   this->NewScalars = vtkIdTypeArray::New();
   this->NewScalars->SetName("RegionId");
@@ -170,67 +195,48 @@ int vtkPolyDataConnectivityFilter::RequestData(
 
   newPts->Allocate(numPts);
 
-  // Traverse all cells marking those visited.  Each new search
-  // starts a new connected region. Connected region grows
-  // using a connected wave propagation.
+  // Find the connected regions in parallel. With scalar connectivity, only
+  // the scalar connected cells are reached from the cells sharing their
+  // points.
   //
-  this->Wave.reserve(numPts);
-  this->Wave2.reserve(numPts);
+  std::vector<unsigned char> connects;
+  if ( this->InScalars )
+    {
+    connects.resize(numCells);
+    vtkCellScalarConnects cellConnects(this, &connects[0]);
+    vtkSMPTools::For(0, numCells, cellConnects);
+    }
 
-  this->PointNumber = 0;
-  this->RegionNumber = 0;
-  maxCellsInRegion = 0;
+  vtkConnectivityHelper helper;
+  helper.BuildComponents(this->Mesh, connects.empty() ? NULL : &connects[0]);
+  this->UpdateProgress (0.5);
 
-  this->CellIds = vtkIdList::New();
-  this->CellIds->Allocate(8, VTK_CELL_SIZE);
+  this->RegionNumber = 0;
   this->PointIds = vtkIdList::New();
   this->PointIds->Allocate(8, VTK_CELL_SIZE);
 
   if ( this->ExtractionMode != VTK_EXTRACT_POINT_SEEDED_REGIONS &&
   this->ExtractionMode != VTK_EXTRACT_CELL_SEEDED_REGIONS &&
   this->ExtractionMode != VTK_EXTRACT_CLOSEST_POINT_REGION )
-    { //visit all cells marking with region number
-    for (cellId=0; cellId < numCells; cellId++)
-      {
-      if ( cellId && !(cellId % 5000) )
-        {
-        this->UpdateProgress (0.1 + 0.8*cellId/numCells);
-        }
-
-      if ( this->Visited[cellId] < 0 )
-        {
-        this->NumCellsInRegion = 0;
-        this->Wave.push_back(cellId);
-        this->TraverseAndMark ();
-
-        if ( this->NumCellsInRegion > maxCellsInRegion )
-          {
-          maxCellsInRegion = this->NumCellsInRegion;
-          largestRegionId = this->RegionNumber;
-          }
-
-        this->RegionSizes->InsertValue(this->RegionNumber++,
-                                       this->NumCellsInRegion);
-        this->Wave.clear();
-        this->Wave2.clear();
-       }
-      }
+    { //mark all cells with region number
+    largestRegionId = helper.LabelAllRegions(this->Visited, this->RegionSizes);
+    this->RegionNumber = this->RegionSizes->GetNumberOfTuples();
     }
   else // regions have been seeded, everything considered in same region
     {
-    this->NumCellsInRegion = 0;
+    vtkIdList *seedCells = vtkIdList::New();
 
     if ( this->ExtractionMode == VTK_EXTRACT_POINT_SEEDED_REGIONS )
       {
       for (i=0; i < this->Seeds->GetNumberOfIds(); i++)
         {
         pt = this->Seeds->GetId(i);
-        if ( pt >= 0 )
+        if ( pt >= 0 && pt < numPts )
           {
-          this->Mesh->GetPointCells(pt,ncells,cells);
-          for (unsigned short j = 0; j < ncells; ++j)
+          cells = helper.GetPointCells(pt);
+          for (n = 0; n < helper.GetNumberOfPointCells(pt); ++n)
             {
-            this->Wave.push_back(cells[j]);
+            seedCells->InsertNextId(cells[n]);
             }
           }
         }
@@ -242,37 +248,31 @@ int vtkPolyDataConnectivityFilter::RequestData(
         cellId = this->Seeds->GetId(i);
         if ( cellId >= 0 )
           {
-          this->Wave.push_back(cellId);
+          seedCells->InsertNextId(cellId);
           }
         }
       }
     else if ( this->ExtractionMode == VTK_EXTRACT_CLOSEST_POINT_REGION )
-      {//loop over points, find closest one
-      double minDist2, dist2, x[3];
-      int minId = 0;
-      for (minDist2=VTK_DOUBLE_MAX, i=0; i<numPts; i++)
+      {//find closest point
+      pt = vtkConnectivityHelper::FindClosestPoint(input, this->ClosestPoint);
+      cells = helper.GetPointCells(pt);
+      for (n = 0; n < helper.GetNumberOfPointCells(pt); ++n)
         {
-        inPts->GetPoint(i,x);
-        dist2 = vtkMath::Distance2BetweenPoints(x,this->ClosestPoint);
-        if ( dist2 < minDist2 )
-          {
-          minId = i;
-          minDist2 = dist2;
-          }
-        }
-      this->Mesh->GetPointCells(minId,ncells,cells);
-      for (unsigned short j=0; j < ncells; ++j)
-        {
-        this->Wave.push_back(cells[j]);
+        seedCells->InsertNextId(cells[n]);
         }
       }
-    this->UpdateProgress (0.5);
 
     //mark all seeded regions
-    this->TraverseAndMark ();
-    this->RegionSizes->InsertValue(this->RegionNumber,this->NumCellsInRegion);
-    this->UpdateProgress (0.9);
+    this->RegionSizes->InsertValue(this->RegionNumber,
+      helper.LabelSeededRegion(seedCells, this->Visited));
+    seedCells->Delete();
     }//else extracted seeded cells
+  this->UpdateProgress (0.7);
+
+  // Number the points used by the marked cells, in input order
+  helper.MapPoints(this->Visited, this->PointMap,
+    vtkIdTypeArray::SafeDownCast(this->NewScalars)->GetPointer(0));
+  this->UpdateProgress (0.9);
 
   vtkDebugMacro (<<"Extracted " << this->RegionNumber << " region(s)");
 
@@ -430,7 +430,6 @@ int vtkPolyDataConnectivityFilter::RequestData(
   delete [] this->PointMap;
   this->Mesh->Delete();
   output->Squeeze();
-  this->CellIds->Delete();
   this->PointIds->Delete();
 
   int num = this->GetNumberOfExtractedRegions();
@@ -446,11 +445,14 @@ int vtkPolyDataConnectivityFilter::RequestData(
   return 1;
 }
 
+#if !defined(VTK_LEGACY_REMOVE)
 // Mark current cell as visited and assign region number.  Note:
 // traversal occurs across shared vertices.
 //
 void vtkPolyDataConnectivityFilter::TraverseAndMark ()
 {
+  VTK_LEGACY_BODY(vtkPolyDataConnectivityFilter::TraverseAndMark, "VTK 7.1");
+
   vtkIdType cellId, ptId, numIds, i;
   int j, k;
   vtkIdType *pts, *cells, npts;
@@ -508,25 +510,23 @@ void vtkPolyDataConnectivityFilter::TraverseAndMark ()
 
   return;
 }
+#endif
 
 // --------------------------------------------------------------------------
 int vtkPolyDataConnectivityFilter::IsScalarConnected( vtkIdType cellId )
 {
+  vtkIdType npts, *pts;
   double s;
 
-  this->Mesh->GetCellPoints(cellId, this->NeighborCellPointIds);
-  const int numScalars = this->NeighborCellPointIds->GetNumberOfIds();
-
-  this->CellScalars->SetNumberOfTuples(numScalars);
-  this->InScalars->GetTuples(this->NeighborCellPointIds,
-                             this->CellScalars);
+  this->Mesh->GetCellPoints(cellId, npts, pts);
 
   double range[2] = {VTK_DOUBLE_MAX, VTK_DOUBLE_MIN};
 
-  // Loop through the cell points.
-  for (int ii=0; ii < numScalars;  ii++)
+  // Loop through the cell points. The scalars have always been compared in
+  // single precision.
+  for (vtkIdType ii=0; ii < npts;  ii++)
     {
-    s = this->CellScalars->GetComponent(ii, 0);
+    s = static_cast<float>(this->InScalars->GetComponent(pts[ii], 0));
     if ( s < range[0] )
       {
       range[0] = s;
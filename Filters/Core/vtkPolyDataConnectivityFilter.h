@@ -41,6 +41,11 @@
 // This use of ScalarConnectivity is particularly useful for selecting cells
 // for later processing.
 //
+// The regions are found with vtkSMPTools, by a union-find over the cells
+// sharing points (see vtkConnectivityHelper). Regions and cells are
+// numbered as a traversal from the first unvisited cell would, and the
+// output points keep the order of the input points.
+//
 // .SECTION See Also
 // vtkConnectivityFilter
 
@@ -198,34 +203,43 @@ protected:
   int ScalarConnectivity;
   int FullScalarConnectivity;
 
-  // Does this cell qualify as being scalar connected ?
+  // Does this cell qualify as being scalar connected ? Safe to call from
+  // several threads.
   int IsScalarConnected( vtkIdType cellId );
 
   double ScalarRange[2];
 
-  void TraverseAndMark();
-
   // used to support algorithm execution
-  vtkDataArray *CellScalars;
-  vtkIdList *NeighborCellPointIds;
   vtkIdType *Visited;
   vtkIdType *PointMap;
   vtkDataArray *NewScalars;
   vtkIdType RegionNumber;
-  vtkIdType PointNumber;
-  vtkIdType NumCellsInRegion;
   vtkDataArray *InScalars;
   vtkPolyData *Mesh;
-  std::vector<vtkIdType> Wave;
-  std::vector<vtkIdType> Wave2;
   vtkIdList *PointIds;
-  vtkIdList *CellIds;
   vtkIdList *VisitedPointIds;
 
   int MarkVisitedPointIds;
   int OutputPointsPrecision;
 
+  // Description:
+  // Deprecated. The regions are now labeled by vtkConnectivityHelper, and
+  // RequestData() no longer calls TraverseAndMark() nor uses the members
+  // below. They are kept for subclasses and will be removed in a future
+  // release.
+  VTK_LEGACY(void TraverseAndMark());
+  vtkDataArray *CellScalars;
+  vtkIdList *NeighborCellPointIds;
+  vtkIdType PointNumber;
+  vtkIdType NumCellsInRegion;
+  std::vector<vtkIdType> Wave;
+  std::vector<vtkIdType> Wave2;
+  vtkIdList *CellIds;
+
 private:
+  class vtkCellScalarConnects;
+  friend class vtkCellScalarConnects;
+
   vtkPolyDataConnectivityFilter(const vtkPolyDataConnectivityFilter&);  // Not implemented.
   void operator=(const vtkPolyDataConnectivityFilter&);  // Not implemented.
 };
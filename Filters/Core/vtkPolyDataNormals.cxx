@@ -24,9 +24,16 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkTriangleStrip.h"
 #include "vtkPriorityQueue.h"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 vtkStandardNewMacro(vtkPolyDataNormals);
 
 // Construct with feature angle=30, splitting and consistency turned on,
@@ -58,6 +65,453 @@ vtkPolyDataNormals::vtkPolyDataNormals()
 #define VTK_CELL_NOT_VISITED     0
 #define VTK_CELL_VISITED         1
 
+namespace
+{
+// Number of polygons in the blocks of vtkPolyDataNormalsConnectRegions.
+const vtkIdType VTK_POLYGON_BLOCK_SIZE = 8192;
+
+// Root of c in a union-find forest where parents have smaller ids than
+// their children, so that roots are the smallest ids of their sets.
+vtkIdType vtkPolyDataNormalsFind(vtkIdType *parent, vtkIdType c)
+{
+  while ( parent[c] != c )
+    {
+    parent[c] = parent[parent[c]];
+    c = parent[c];
+    }
+  return c;
+}
+
+void vtkPolyDataNormalsJoin(vtkIdType *parent, vtkIdType a, vtkIdType b)
+{
+  a = vtkPolyDataNormalsFind(parent, a);
+  b = vtkPolyDataNormalsFind(parent, b);
+  if ( a < b )
+    {
+    parent[b] = a;
+    }
+  else if ( b < a )
+    {
+    parent[a] = b;
+    }
+}
+
+typedef std::vector<std::pair<vtkIdType, vtkIdType> > vtkPolyDataNormalsJoins;
+}
+
+// Join each polygon with the neighbors TraverseAndOrder() can reach from
+// it. Neighbors in the same block are joined in Parent, the others are
+// collected in Joins to be joined once all blocks are done.
+struct vtkPolyDataNormalsConnectRegions
+{
+  vtkPolyDataNormals *Self;
+  vtkIdType NumberOfPolys;
+  vtkIdType *Parent;
+  vtkPolyDataNormalsJoins *Joins;
+  vtkSMPThreadLocalObject<vtkIdList> CellIds;
+
+  void operator()(vtkIdType block, vtkIdType endBlock)
+    {
+    vtkIdList *&cellIds = this->CellIds.Local();
+    vtkIdType npts, *pts, k;
+    int j, j1;
+    for ( ; block < endBlock; ++block)
+      {
+      vtkIdType begin = block * VTK_POLYGON_BLOCK_SIZE;
+      vtkIdType end =
+        std::min(begin + VTK_POLYGON_BLOCK_SIZE, this->NumberOfPolys);
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+        {
+        this->Self->NewMesh->GetCellPoints(cellId, npts, pts);
+        for (j = 0, j1 = 1; j < npts; ++j, (j1 = (++j1 < npts) ? j1 : 0))
+          {
+          this->Self->OldMesh->GetCellEdgeNeighbors(cellId, pts[j], pts[j1],
+                                                    cellIds);
+          if ( cellIds->GetNumberOfIds() == 1 ||
+               this->Self->NonManifoldTraversal )
+            {
+            for (k=0; k < cellIds->GetNumberOfIds(); k++)
+              {
+              vtkIdType neighbor = cellIds->GetId(k);
+              if ( neighbor >= begin && neighbor < end )
+                {
+                vtkPolyDataNormalsJoin(this->Parent, cellId, neighbor);
+                }
+              else
+                {
+                this->Joins[block].push_back(
+                  std::make_pair(cellId, neighbor));
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+};
+
+// Order the polygons of each region as the serial traversal does: seed a
+// wave at each polygon not visited yet, in the order of their ids.
+struct vtkPolyDataNormalsOrderRegions
+{
+  vtkPolyDataNormals *Self;
+  const vtkIdType *Offsets;
+  const vtkIdType *Polys;
+  vtkSMPThreadLocalObject<vtkIdList> Wave;
+  vtkSMPThreadLocalObject<vtkIdList> Wave2;
+  vtkSMPThreadLocalObject<vtkIdList> CellIds;
+  vtkSMPThreadLocal<int> NumFlips;
+
+  vtkPolyDataNormalsOrderRegions() : NumFlips(0) {}
+
+  void operator()(vtkIdType region, vtkIdType endRegion)
+    {
+    vtkIdList *&wave = this->Wave.Local();
+    vtkIdList *&wave2 = this->Wave2.Local();
+    vtkIdList *&cellIds = this->CellIds.Local();
+    int &numFlips = this->NumFlips.Local();
+    for ( ; region < endRegion; ++region)
+      {
+      for (vtkIdType i = this->Offsets[region]; i < this->Offsets[region+1];
+           ++i)
+        {
+        vtkIdType cellId = this->Polys[i];
+        if ( this->Self->Visited[cellId] == VTK_CELL_NOT_VISITED )
+          {
+          if ( this->Self->FlipNormals )
+            {
+            numFlips++;
+            this->Self->NewMesh->ReverseCell(cellId);
+            }
+          wave->InsertNextId(cellId);
+          this->Self->Visited[cellId] = VTK_CELL_VISITED;
+          this->Self->TraverseAndOrder(wave, wave2, cellIds, numFlips);
+          }
+        wave->Reset();
+        wave2->Reset();
+        }
+      }
+    }
+};
+
+namespace
+{
+// Compute the normal of each polygon.
+struct vtkPolyDataNormalsComputePolyNormals
+{
+  vtkPolyData *Mesh;
+  vtkPoints *Points;
+  float *Normals;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+    {
+    vtkIdType npts, *pts;
+    double n[3];
+    for ( ; cellId < endCellId; ++cellId)
+      {
+      this->Mesh->GetCellPoints(cellId, npts, pts);
+      vtkPolygon::ComputeNormal(this->Points, npts, pts, n);
+      this->Normals[3 * cellId] = static_cast<float>(n[0]);
+      this->Normals[3 * cellId + 1] = static_cast<float>(n[1]);
+      this->Normals[3 * cellId + 2] = static_cast<float>(n[2]);
+      }
+    }
+};
+
+// Mark the polygons around each point with the region they are in. Start
+// moving around the "cycle" of points using the point, and label each
+// subregion of cells connected to this point that are connected (and not
+// separated by a feature edge) with a given region number. For each N
+// regions, N-1 duplicate (split) points are created. Regions hold the
+// region of each link of the point, and Positions the place of the point
+// in the polygons of the regions after the first, where it is replaced.
+struct vtkPolyDataNormalsMarkRegions
+{
+  vtkPolyData *OldMesh;
+  vtkPolyData *NewMesh;
+  const float *PolyNormals;
+  double CosAngle;
+  const vtkIdType *LinkOffsets;
+  int *Regions;
+  int *Positions;
+  vtkIdType *NumberOfSplits;
+  vtkSMPThreadLocalObject<vtkIdList> CellIds;
+
+  // Region of cellId, one of the cells of a point.
+  static int &Region(int *regions, vtkIdType *cells, unsigned short ncells,
+                     vtkIdType cellId)
+    {
+    return regions[std::lower_bound(cells, cells + ncells, cellId) - cells];
+    }
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+    {
+    vtkIdList *&cellIds = this->CellIds.Local();
+    for ( ; ptId < endPtId; ++ptId)
+      {
+      this->NumberOfSplits[ptId] = 0;
+      int *regions = this->Regions + this->LinkOffsets[ptId];
+      unsigned short ncells;
+      vtkIdType *cells;
+      this->OldMesh->GetPointCells(ptId,ncells,cells);
+      std::fill_n(regions, ncells, 0);
+      if ( ncells <= 1 )
+        {
+        continue; //point does not need to be further disconnected
+        }
+
+      // Start by initializing the cells as unvisited. A cell using the
+      // point more than once is marked at its first link.
+      int i, j;
+      for (i=0; i<ncells; i++)
+        {
+        regions[i] = -1;
+        }
+
+      vtkIdType numPts;
+      vtkIdType *pts;
+      int numRegions = 0;
+      vtkIdType spot, neiPt[2], nei, cellId, neiCellId;
+      double thisNormal[3], neiNormal[3];
+      for (j=0; j<ncells; j++) //for all cells connected to point
+        {
+        if ( Region(regions, cells, ncells, cells[j]) < 0 )
+          {
+          Region(regions, cells, ncells, cells[j]) = numRegions;
+          this->OldMesh->GetCellPoints(cells[j],numPts,pts);
+
+          //find the two edges
+          for (spot=0; spot < numPts; spot++)
+            {
+            if ( pts[spot] == ptId )
+              {
+              break;
+              }
+            }
+
+          if ( spot == 0 )
+            {
+            neiPt[0] = pts[spot+1];
+            neiPt[1] = pts[numPts-1];
+            }
+          else if ( spot == (numPts-1) )
+            {
+            neiPt[0] = pts[spot-1];
+            neiPt[1] = pts[0];
+            }
+          else
+            {
+            neiPt[0] = pts[spot+1];
+            neiPt[1] = pts[spot-1];
+            }
+
+          for (i=0; i<2; i++) //for each of the two edges of the seed cell
+            {
+            cellId = cells[j];
+            nei = neiPt[i];
+            while ( cellId >= 0 ) //while we can grow this region
+              {
+              this->OldMesh->GetCellEdgeNeighbors(cellId,ptId,nei,cellIds);
+              if ( cellIds->GetNumberOfIds() == 1 &&
+                   Region(regions, cells, ncells,
+                          (neiCellId=cellIds->GetId(0))) < 0 )
+                {
+                for (int c=0; c < 3; c++)
+                  {
+                  thisNormal[c] = this->PolyNormals[3*cellId+c];
+                  neiNormal[c] = this->PolyNormals[3*neiCellId+c];
+                  }
+
+                if ( vtkMath::Dot(thisNormal,neiNormal) > this->CosAngle )
+                  {
+                  //visit and arrange to visit next edge neighbor
+                  Region(regions, cells, ncells, neiCellId) = numRegions;
+                  cellId = neiCellId;
+                  this->OldMesh->GetCellPoints(cellId,numPts,pts);
+
+                  for (spot=0; spot < numPts; spot++)
+                    {
+                    if ( pts[spot] == ptId )
+                      {
+                      break;
+                      }
+                    }
+
+                  if (spot == 0)
+                    {
+                    nei = (pts[spot+1] != nei ? pts[spot+1] : pts[numPts-1]);
+                    }
+                  else if (spot == (numPts-1))
+                    {
+                    nei = (pts[spot-1] != nei ? pts[spot-1] : pts[0]);
+                    }
+                  else
+                    {
+                    nei = (pts[spot+1] != nei ? pts[spot+1] : pts[spot-1]);
+                    }
+
+                  }//if not separated by edge angle
+                else
+                  {
+                  cellId = -1; //separated by edge angle
+                  }
+                }//if can move to edge neighbor
+              else
+                {
+                cellId = -1;//separated by previous visit, boundary, or non-manifold
+                }
+              }//while visit wave is propagating
+            }//for each of the two edges of the starting cell
+          numRegions++;
+          }//if cell is unvisited
+        }//for all cells connected to point ptId
+
+      if ( numRegions <= 1 )
+        {
+        std::fill_n(regions, ncells, 0);
+        continue; //a single region, no splitting ever required
+        }
+      this->NumberOfSplits[ptId] = numRegions - 1;
+
+      // In the cells not in the first region, ptId will be replaced with a
+      // duplicate of the point. Find where, the nth link of a cell
+      // replacing the nth use of the point.
+      int *positions = this->Positions + this->LinkOffsets[ptId];
+      int use = 0;
+      for (j=0; j<ncells; j++)
+        {
+        regions[j] = Region(regions, cells, ncells, cells[j]);
+        use = (j > 0 && cells[j-1] == cells[j]) ? use + 1 : 0;
+        if ( regions[j] > 0 )
+          {
+          this->NewMesh->GetCellPoints(cells[j],numPts,pts);
+          int n = use;
+          for (i=0; i < numPts; i++)
+            {
+            if ( pts[i] == ptId && n-- == 0 )
+              {
+              break;
+              }
+            }
+          positions[j] = i;
+          }
+        }
+      }
+    }
+};
+
+// Replace the points in the polygons of the regions after the first with
+// their duplicates, numbered after the input points in the order of the
+// points they duplicate, and map the duplicates to the input points.
+struct vtkPolyDataNormalsSplitPoints
+{
+  vtkPolyData *OldMesh;
+  vtkPolyData *NewMesh;
+  vtkIdType NumberOfPoints;
+  const vtkIdType *LinkOffsets;
+  const int *Regions;
+  const int *Positions;
+  const vtkIdType *SplitOffsets;
+  vtkIdType *Map;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+    {
+    for ( ; ptId < endPtId; ++ptId)
+      {
+      this->Map[ptId] = ptId;
+      vtkIdType lastId = this->NumberOfPoints + this->SplitOffsets[ptId];
+      vtkIdType numSplits = this->SplitOffsets[ptId+1] - this->SplitOffsets[ptId];
+      for (vtkIdType i=0; i < numSplits; i++)
+        {
+        this->Map[lastId + i] = ptId;
+        }
+      if ( numSplits == 0 )
+        {
+        continue;
+        }
+
+      unsigned short ncells;
+      vtkIdType *cells, numPts, *pts;
+      this->OldMesh->GetPointCells(ptId,ncells,cells);
+      const int *regions = this->Regions + this->LinkOffsets[ptId];
+      const int *positions = this->Positions + this->LinkOffsets[ptId];
+      for (int j=0; j<ncells; j++)
+        {
+        if ( regions[j] > 0 )
+          {
+          this->NewMesh->GetCellPoints(cells[j],numPts,pts);
+          pts[positions[j]] = lastId + regions[j] - 1;
+          }
+        }
+      }
+    }
+};
+
+// Sum the normals of the polygons using each output point, polygon after
+// polygon. The polygons using a point are found from the links of the
+// point it duplicates, so that each point is summed by one thread.
+struct vtkPolyDataNormalsAccumulate
+{
+  vtkPolyData *OldMesh;
+  vtkIdType NumberOfPoints;
+  const vtkIdType *LinkOffsets;
+  const int *Regions;
+  const vtkIdType *SplitOffsets;
+  const float *PolyNormals;
+  float *Normals;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+    {
+    for ( ; ptId < endPtId; ++ptId)
+      {
+      unsigned short ncells;
+      vtkIdType *cells;
+      this->OldMesh->GetPointCells(ptId,ncells,cells);
+      const int *regions =
+        this->Regions ? this->Regions + this->LinkOffsets[ptId] : 0;
+      for (int j=0; j<ncells; j++)
+        {
+        vtkIdType newId = ptId;
+        if ( regions && regions[j] > 0 )
+          {
+          newId = this->NumberOfPoints + this->SplitOffsets[ptId] +
+            regions[j] - 1;
+          }
+        const float *polyNormal = this->PolyNormals + 3 * cells[j];
+        this->Normals[3 * newId] += polyNormal[0];
+        this->Normals[3 * newId + 1] += polyNormal[1];
+        this->Normals[3 * newId + 2] += polyNormal[2];
+        }
+      }
+    }
+};
+
+// Normalize the point normals.
+struct vtkPolyDataNormalsNormalize
+{
+  float *Normals;
+  double FlipDirection;
+
+  void operator()(vtkIdType i, vtkIdType end)
+    {
+    float *fNormals = this->Normals;
+    for ( ; i < end; ++i)
+      {
+      const double length = sqrt(fNormals[3 * i] * fNormals[3 * i] +
+                                 fNormals[3 * i + 1] * fNormals[3 * i + 1] +
+                                 fNormals[3 * i + 2] * fNormals[3 * i + 2]
+                                 ) * this->FlipDirection;
+      if (length != 0.0)
+        {
+        fNormals[3 * i] /= length;
+        fNormals[3 * i + 1] /= length;
+        fNormals[3 * i + 2] /= length;
+        }
+      }
+    }
+};
+}
+
 // Generate normals for polygon meshes
 int vtkPolyDataNormals::RequestData(
   vtkInformation *vtkNotUsed(request),
@@ -75,12 +529,10 @@ int vtkPolyDataNormals::RequestData(
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
   vtkIdType npts = 0;
-  vtkIdType i;
   vtkIdType *pts = 0;
   vtkIdType numNewPts;
   double flipDirection=1.0;
   vtkIdType numPolys, numStrips;
-  vtkIdType cellId;
   vtkIdType numPts;
   vtkPoints *inPts;
   vtkCellArray *inPolys, *inStrips, *polys;
@@ -167,7 +619,7 @@ int vtkPolyDataNormals::RequestData(
 
   // The visited array keeps track of which polygons have been visited.
   //
-  if ( this->Consistency || this->Splitting || this->AutoOrientNormals )
+  if ( this->Consistency || this->AutoOrientNormals )
     {
     this->Visited = new int[numPolys];
     memset(this->Visited, VTK_CELL_NOT_VISITED, numPolys*sizeof(int));
@@ -285,30 +737,7 @@ int vtkPolyDataNormals::RequestData(
     {
     if ( this->Consistency )
       {
-      this->Wave = vtkIdList::New();
-      this->Wave->Allocate(numPolys/4+1,numPolys);
-      this->Wave2 = vtkIdList::New();
-      this->Wave2->Allocate(numPolys/4+1,numPolys);
-      for (cellId=0; cellId < numPolys; cellId++)
-        {
-        if ( this->Visited[cellId] == VTK_CELL_NOT_VISITED)
-          {
-          if ( this->FlipNormals )
-            {
-            this->NumFlips++;
-            this->NewMesh->ReverseCell(cellId);
-            }
-          this->Wave->InsertNextId(cellId);
-          this->Visited[cellId] = VTK_CELL_VISITED;
-          this->TraverseAndOrder();
-          }
-
-        this->Wave->Reset();
-        this->Wave2->Reset();
-        }
-
-      this->Wave->Delete();
-      this->Wave2->Delete();
+      this->OrderRegions(numPolys);
       vtkDebugMacro(<<"Reversed ordering of " << this->NumFlips << " polygons");
       }//Consistent ordering
     } // don't automatically orient normals
@@ -319,24 +748,30 @@ int vtkPolyDataNormals::RequestData(
   //
   this->PolyNormals = vtkFloatArray::New();
   this->PolyNormals->SetNumberOfComponents(3);
-  this->PolyNormals->Allocate(3*numPolys);
   this->PolyNormals->SetName("Normals");
   this->PolyNormals->SetNumberOfTuples(numPolys);
+  float *fPolyNormals = this->PolyNormals->WritePointer(0, 3 * numPolys);
 
-  for (cellId=0, newPolys->InitTraversal(); newPolys->GetNextCell(npts,pts);
-       cellId++ )
+  vtkPolyDataNormalsComputePolyNormals computePolyNormals;
+  computePolyNormals.Mesh = this->NewMesh;
+  computePolyNormals.Points = inPts;
+  computePolyNormals.Normals = fPolyNormals;
+  if ( inPts->GetData()->HasStandardMemoryLayout() )
     {
-    if ((cellId % 1000) == 0)
-      {
-      this->UpdateProgress (0.333 + 0.333 * (double) cellId / (double) numPolys);
-      if (this->GetAbortExecute())
-        {
-        break;
-        }
-      }
-    vtkPolygon::ComputeNormal(inPts, npts, pts, n);
-    this->PolyNormals->SetTuple(cellId,n);
+    vtkSMPTools::For(0, numPolys, computePolyNormals);
     }
+  else
+    {
+    // reading other arrays may not be thread safe
+    computePolyNormals(0, numPolys);
+    }
+  this->UpdateProgress(0.5);
+
+  // Links of the input points are in OldMesh. When points are split,
+  // regions holds the region of each link, numbered around the point.
+  std::vector<vtkIdType> linkOffsets;
+  std::vector<int> regions;
+  std::vector<vtkIdType> splitOffsets;
 
   // Split mesh if sharp features
   if ( this->Splitting )
@@ -349,19 +784,53 @@ int vtkPolyDataNormals::RequestData(
     //  Splitting will create new points.  We have to create index array
     // to map new points into old points.
     //
-    this->Map = vtkIdList::New();
-    this->Map->SetNumberOfIds(numPts);
-    for (i=0; i < numPts; i++)
+    linkOffsets.resize(numPts + 1);
+    linkOffsets[0] = 0;
+    for (ptId=0; ptId < numPts; ptId++)
       {
-      this->Map->SetId(i,i);
+      unsigned short ncells;
+      vtkIdType *cells;
+      this->OldMesh->GetPointCells(ptId, ncells, cells);
+      linkOffsets[ptId+1] = linkOffsets[ptId] + ncells;
       }
-
-    for (ptId=0; ptId < numPts; ptId++)
+    regions.resize(linkOffsets[numPts]);
+    std::vector<int> positions(linkOffsets[numPts]);
+    splitOffsets.resize(numPts + 1);
+
+    vtkPolyDataNormalsMarkRegions markRegions;
+    markRegions.OldMesh = this->OldMesh;
+    markRegions.NewMesh = this->NewMesh;
+    markRegions.PolyNormals = fPolyNormals;
+    markRegions.CosAngle = this->CosAngle;
+    markRegions.LinkOffsets = &linkOffsets[0];
+    markRegions.Regions = regions.empty() ? 0 : &regions[0];
+    markRegions.Positions = positions.empty() ? 0 : &positions[0];
+    markRegions.NumberOfSplits = &splitOffsets[0];
+    vtkSMPTools::For(0, numPts, markRegions);
+
+    // The duplicates of each point follow the duplicates of the points
+    // before it.
+    numNewPts = numPts;
+    for (ptId=0; ptId <= numPts; ptId++)
       {
-      this->MarkAndSplit(ptId);
-      }//for all input points
+      vtkIdType numSplits = ptId < numPts ? splitOffsets[ptId] : 0;
+      splitOffsets[ptId] = numNewPts - numPts;
+      numNewPts += numSplits;
+      }
 
-    numNewPts = this->Map->GetNumberOfIds();
+    this->Map = vtkIdList::New();
+    this->Map->SetNumberOfIds(numNewPts);
+
+    vtkPolyDataNormalsSplitPoints splitPoints;
+    splitPoints.OldMesh = this->OldMesh;
+    splitPoints.NewMesh = this->NewMesh;
+    splitPoints.NumberOfPoints = numPts;
+    splitPoints.LinkOffsets = &linkOffsets[0];
+    splitPoints.Regions = markRegions.Regions;
+    splitPoints.Positions = markRegions.Positions;
+    splitPoints.SplitOffsets = &splitOffsets[0];
+    splitPoints.Map = this->Map->GetPointer(0);
+    vtkSMPTools::For(0, numPts, splitPoints);
 
     vtkDebugMacro(<<"Created " << numNewPts-numPts << " new points");
 
@@ -411,7 +880,7 @@ int vtkPolyDataNormals::RequestData(
     outPD->PassData(pd);
     }
 
-  if ( this->Consistency || this->Splitting )
+  if ( this->Consistency || this->AutoOrientNormals )
     {
     delete [] this->Visited;
     this->CellIds->Delete();
@@ -434,34 +903,22 @@ int vtkPolyDataNormals::RequestData(
   float *fNormals = newNormals->WritePointer(0, 3 * numNewPts);
   std::fill_n(fNormals, 3 * numNewPts, 0);
 
-  float *fPolyNormals = this->PolyNormals->WritePointer(0, 3 * numPolys);
-
   if (this->ComputePointNormals)
     {
-    for (cellId=0, newPolys->InitTraversal(); newPolys->GetNextCell(npts, pts);
-         ++cellId)
-      {
-      for (i = 0; i < npts; ++i)
-        {
-        fNormals[3 * pts[i]] += fPolyNormals[3 * cellId];
-        fNormals[3 * pts[i] + 1] += fPolyNormals[3 * cellId + 1];
-        fNormals[3 * pts[i] + 2] += fPolyNormals[3 * cellId + 2];
-        }
-      }
-
-    for (i = 0; i < numNewPts; ++i)
-      {
-      const double length = sqrt(fNormals[3 * i] * fNormals[3 * i] +
-                                 fNormals[3 * i + 1] * fNormals[3 * i + 1] +
-                                 fNormals[3 * i + 2] * fNormals[3 * i + 2]
-                                 ) * flipDirection;
-      if (length != 0.0)
-        {
-        fNormals[3 * i] /= length;
-        fNormals[3 * i + 1] /= length;
-        fNormals[3 * i + 2] /= length;
-        }
-      }
+    vtkPolyDataNormalsAccumulate accumulate;
+    accumulate.OldMesh = this->OldMesh;
+    accumulate.NumberOfPoints = numPts;
+    accumulate.LinkOffsets = linkOffsets.empty() ? 0 : &linkOffsets[0];
+    accumulate.Regions = regions.empty() ? 0 : &regions[0];
+    accumulate.SplitOffsets = splitOffsets.empty() ? 0 : &splitOffsets[0];
+    accumulate.PolyNormals = fPolyNormals;
+    accumulate.Normals = fNormals;
+    vtkSMPTools::For(0, numPts, accumulate);
+
+    vtkPolyDataNormalsNormalize normalize;
+    normalize.Normals = fNormals;
+    normalize.FlipDirection = flipDirection;
+    vtkSMPTools::For(0, numNewPts, normalize);
     }
 
   //  Update ourselves.  If no new nodes have been created (i.e., no
@@ -505,9 +962,96 @@ int vtkPolyDataNormals::RequestData(
   return 1;
 }
 
+//  Order polygons consistently, traversing the regions of polygons
+//  connected to each other in parallel. Regions are found first, joining
+//  the polygons with the neighbors the traversal reaches. The polygons of
+//  a region are then traversed as if by the serial loop over all
+//  polygons, so that the output does not depend on the number of threads.
+//
+void vtkPolyDataNormals::OrderRegions(vtkIdType numPolys)
+{
+  vtkIdType cellId;
+  std::vector<vtkIdType> parent(numPolys);
+  for (cellId=0; cellId < numPolys; cellId++)
+    {
+    parent[cellId] = cellId;
+    }
+
+  vtkIdType numBlocks =
+    (numPolys + VTK_POLYGON_BLOCK_SIZE - 1) / VTK_POLYGON_BLOCK_SIZE;
+  std::vector<vtkPolyDataNormalsJoins> joins(numBlocks);
+  vtkPolyDataNormalsConnectRegions connect;
+  connect.Self = this;
+  connect.NumberOfPolys = numPolys;
+  connect.Parent = numPolys ? &parent[0] : 0;
+  connect.Joins = numBlocks ? &joins[0] : 0;
+  vtkSMPTools::For(0, numBlocks, 1, connect);
+
+  for (vtkIdType block=0; block < numBlocks; block++)
+    {
+    for (size_t i=0; i < joins[block].size(); i++)
+      {
+      vtkPolyDataNormalsJoin(&parent[0], joins[block][i].first,
+                             joins[block][i].second);
+      }
+    vtkPolyDataNormalsJoins().swap(joins[block]);
+    }
+
+  // Number the regions in the order of their first polygon. Parents come
+  // before their children, so each parent is numbered before them.
+  vtkIdType numRegions = 0;
+  for (cellId=0; cellId < numPolys; cellId++)
+    {
+    parent[cellId] = ( parent[cellId] == cellId ) ? numRegions++ :
+      parent[parent[cellId]];
+    }
+
+  // List the polygons of each region in order.
+  std::vector<vtkIdType> offsets(numRegions + 1, 0);
+  for (cellId=0; cellId < numPolys; cellId++)
+    {
+    offsets[parent[cellId] + 1]++;
+    }
+  for (vtkIdType region=0; region < numRegions; region++)
+    {
+    offsets[region + 1] += offsets[region];
+    }
+  std::vector<vtkIdType> polys(numPolys);
+  for (cellId=0; cellId < numPolys; cellId++)
+    {
+    polys[offsets[parent[cellId]]++] = cellId;
+    }
+  for (vtkIdType region=numRegions; region > 0; region--)
+    {
+    offsets[region] = offsets[region - 1];
+    }
+  offsets[0] = 0;
+
+  vtkPolyDataNormalsOrderRegions order;
+  order.Self = this;
+  order.Offsets = &offsets[0];
+  order.Polys = numPolys ? &polys[0] : 0;
+  vtkSMPTools::For(0, numRegions, order);
+
+  for (vtkSMPThreadLocal<int>::iterator iter = order.NumFlips.begin();
+       iter != order.NumFlips.end(); ++iter)
+    {
+    this->NumFlips += *iter;
+    }
+}
+
 //  Propagate wave of consistently ordered polygons.
 //
 void vtkPolyDataNormals::TraverseAndOrder (void)
+{
+  this->TraverseAndOrder(this->Wave, this->Wave2, this->CellIds,
+                         this->NumFlips);
+}
+
+//  Propagate wave of consistently ordered polygons with the given lists.
+//
+void vtkPolyDataNormals::TraverseAndOrder (vtkIdList *wave, vtkIdList *wave2,
+                                           vtkIdList *cellIds, int &numFlips)
 {
   vtkIdType i, k;
   int j, l, j1;
@@ -517,29 +1061,29 @@ void vtkPolyDataNormals::TraverseAndOrder (void)
   vtkIdList *tmpWave;
 
   // propagate wave until nothing left in wave
-  while ( (numIds=this->Wave->GetNumberOfIds()) > 0 )
+  while ( (numIds=wave->GetNumberOfIds()) > 0 )
     {
     for ( i=0; i < numIds; i++ )
       {
-      cellId = this->Wave->GetId(i);
+      cellId = wave->GetId(i);
 
       this->NewMesh->GetCellPoints(cellId, npts, pts);
 
       for (j = 0, j1 = 1; j < npts; ++j, (j1 = (++j1 < npts) ? j1 : 0)) //for each edge neighbor
         {
-        this->OldMesh->GetCellEdgeNeighbors(cellId, pts[j], pts[j1], this->CellIds);
+        this->OldMesh->GetCellEdgeNeighbors(cellId, pts[j], pts[j1], cellIds);
 
         //  Check the direction of the neighbor ordering.  Should be
         //  consistent with us (i.e., if we are n1->n2,
         // neighbor should be n2->n1).
-        if ( this->CellIds->GetNumberOfIds() == 1 ||
+        if ( cellIds->GetNumberOfIds() == 1 ||
              this->NonManifoldTraversal )
           {
-          for (k=0; k < this->CellIds->GetNumberOfIds(); k++)
+          for (k=0; k < cellIds->GetNumberOfIds(); k++)
             {
-            if (this->Visited[this->CellIds->GetId(k)]==VTK_CELL_NOT_VISITED)
+            if (this->Visited[cellIds->GetId(k)]==VTK_CELL_NOT_VISITED)
               {
-              neighbor = this->CellIds->GetId(k);
+              neighbor = cellIds->GetId(k);
               this->NewMesh->GetCellPoints(neighbor,numNeiPts,neiPts);
               for (l=0; l < numNeiPts; l++)
                 {
@@ -553,11 +1097,11 @@ void vtkPolyDataNormals::TraverseAndOrder (void)
               //
               if ( neiPts[(l+1)%numNeiPts] != pts[j] )
                 {
-                this->NumFlips++;
+                numFlips++;
                 this->NewMesh->ReverseCell(neighbor);
                 }
               this->Visited[neighbor] = VTK_CELL_VISITED;
-              this->Wave2->InsertNextId(neighbor);
+              wave2->InsertNextId(neighbor);
               }// if cell not visited
             } // for each edge neighbor
           } //for manifold or non-manifold traversal allowed
@@ -565,176 +1109,15 @@ void vtkPolyDataNormals::TraverseAndOrder (void)
       } //for all cells in wave
 
     //swap wave and proceed with propagation
-    tmpWave = this->Wave;
-    this->Wave = this->Wave2;
-    this->Wave2 = tmpWave;
-    this->Wave2->Reset();
+    tmpWave = wave;
+    wave = wave2;
+    wave2 = tmpWave;
+    wave2->Reset();
     } //while wave still propagating
 
   return;
 }
 
-//
-//  Mark polygons around vertex.  Create new vertex (if necessary) and
-//  replace (i.e., split mesh).
-//
-void vtkPolyDataNormals::MarkAndSplit (vtkIdType ptId)
-{
-  int i,j;
-
-  // Get the cells using this point and make sure that we have to do something
-  unsigned short ncells;
-  vtkIdType *cells;
-  this->OldMesh->GetPointCells(ptId,ncells,cells);
-  if ( ncells <= 1 )
-    {
-    return; //point does not need to be further disconnected
-    }
-
-  // Start moving around the "cycle" of points using the point. Label
-  // each point as requiring a visit. Then label each subregion of cells
-  // connected to this point that are connected (and not separated by
-  // a feature edge) with a given region number. For each N regions
-  // created, N-1 duplicate (split) points are created. The split point
-  // replaces the current point ptId in the polygons connectivity array.
-  //
-  // Start by initializing the cells as unvisited
-  for (i=0; i<ncells; i++)
-    {
-    this->Visited[cells[i]] = -1;
-    }
-
-  // Loop over all cells and mark the region that each is in.
-  //
-  vtkIdType numPts;
-  vtkIdType *pts;
-  int numRegions = 0;
-  vtkIdType spot, neiPt[2], nei, cellId, neiCellId;
-  double thisNormal[3], neiNormal[3];
-  for (j=0; j<ncells; j++) //for all cells connected to point
-    {
-    if ( this->Visited[cells[j]] < 0 ) //for all unvisited cells
-      {
-      this->Visited[cells[j]] = numRegions;
-      //okay, mark all the cells connected to this seed cell and using ptId
-      this->OldMesh->GetCellPoints(cells[j],numPts,pts);
-
-      //find the two edges
-      for (spot=0; spot < numPts; spot++)
-        {
-        if ( pts[spot] == ptId )
-          {
-          break;
-          }
-        }
-
-      if ( spot == 0 )
-        {
-        neiPt[0] = pts[spot+1];
-        neiPt[1] = pts[numPts-1];
-        }
-      else if ( spot == (numPts-1) )
-        {
-        neiPt[0] = pts[spot-1];
-        neiPt[1] = pts[0];
-        }
-      else
-        {
-        neiPt[0] = pts[spot+1];
-        neiPt[1] = pts[spot-1];
-        }
-
-      for (i=0; i<2; i++) //for each of the two edges of the seed cell
-        {
-        cellId = cells[j];
-        nei = neiPt[i];
-        while ( cellId >= 0 ) //while we can grow this region
-          {
-          this->OldMesh->GetCellEdgeNeighbors(cellId,ptId,nei,this->CellIds);
-          if ( this->CellIds->GetNumberOfIds() == 1 &&
-               this->Visited[(neiCellId=this->CellIds->GetId(0))] < 0 )
-            {
-            this->PolyNormals->GetTuple(cellId, thisNormal);
-            this->PolyNormals->GetTuple(neiCellId, neiNormal);
-
-            if ( vtkMath::Dot(thisNormal,neiNormal) > CosAngle )
-              {
-              //visit and arrange to visit next edge neighbor
-              this->Visited[neiCellId] = numRegions;
-              cellId = neiCellId;
-              this->OldMesh->GetCellPoints(cellId,numPts,pts);
-
-              for (spot=0; spot < numPts; spot++)
-                {
-                if ( pts[spot] == ptId )
-                  {
-                  break;
-                  }
-                }
-
-              if (spot == 0)
-                {
-                nei = (pts[spot+1] != nei ? pts[spot+1] : pts[numPts-1]);
-                }
-              else if (spot == (numPts-1))
-                {
-                nei = (pts[spot-1] != nei ? pts[spot-1] : pts[0]);
-                }
-              else
-                {
-                nei = (pts[spot+1] != nei ? pts[spot+1] : pts[spot-1]);
-                }
-
-              }//if not separated by edge angle
-            else
-              {
-              cellId = -1; //separated by edge angle
-              }
-            }//if can move to edge neighbor
-          else
-            {
-            cellId = -1;//separated by previous visit, boundary, or non-manifold
-            }
-          }//while visit wave is propagating
-        }//for each of the two edges of the starting cell
-      numRegions++;
-      }//if cell is unvisited
-    }//for all cells connected to point ptId
-
-  if ( numRegions <=1 )
-    {
-    return; //a single region, no splitting ever required
-    }
-
-  // Okay, for all cells not in the first region, the ptId is
-  // replaced with a new ptId, which is a duplicate of the first
-  // point, but disconnected topologically.
-  //
-  vtkIdType lastId = this->Map->GetNumberOfIds();
-  vtkIdType replacementPoint;
-  for (j=0; j<ncells; j++)
-    {
-    if (this->Visited[cells[j]] > 0 ) //replace point if splitting needed
-      {
-      replacementPoint = lastId + this->Visited[cells[j]] - 1;
-
-      this->Map->InsertId(replacementPoint, ptId);
-
-      this->NewMesh->GetCellPoints(cells[j],numPts,pts);
-      for (i=0; i < numPts; i++)
-        {
-        if ( pts[i] == ptId )
-          {
-          pts[i] = replacementPoint; // this is very nasty! direct write!
-          break;
-          }
-        }//replace ptId with split point
-      }//if not in first regions and requiring splitting
-    }//for all cells connected to ptId
-
-  return;
-}
-
 void vtkPolyDataNormals::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
@@ -43,6 +43,11 @@
 //
 // Triangle strips are broken up into triangle polygons. You may want to
 // restrip the triangles.
+//
+// Polygon normals, splitting and point normals are computed in parallel
+// with vtkSMPTools, and so is the consistent ordering of polygons, one
+// connected region at a time. The output is the same as with a single
+// thread. The ordering of AutoOrientNormals is serial.
 
 #ifndef vtkPolyDataNormals_h
 #define vtkPolyDataNormals_h
@@ -168,10 +173,20 @@ private:
   // checked and properly ordered polygons.
   void TraverseAndOrder(void);
 
-  // Check the point id give to see whether it lies on a feature
-  // edge. If so, split the point (i.e., duplicate it) to topologically
-  // separate the mesh.
-  void MarkAndSplit(vtkIdType ptId);
+  // Same as above with the given lists, adding the number of reversed
+  // polygons to numFlips. Several threads may propagate waves at once in
+  // regions of polygons not connected to each other.
+  void TraverseAndOrder(vtkIdList *wave, vtkIdList *wave2,
+                        vtkIdList *cellIds, int &numFlips);
+
+  // Order the polygons consistently in each connected region, the regions
+  // being traversed in parallel.
+  void OrderRegions(vtkIdType numPolys);
+
+  //BTX
+  friend struct vtkPolyDataNormalsOrderRegions;
+  friend struct vtkPolyDataNormalsConnectRegions;
+  //ETX
 
 private:
   vtkPolyDataNormals(const vtkPolyDataNormals&);  // Not implemented.
@@ -14,18 +14,25 @@
 =========================================================================*/
 #include "vtkProbeFilter.h"
 
+#include "vtkArrayListTemplate.h"
 #include "vtkCell.h"
 #include "vtkCellData.h"
 #include "vtkCharArray.h"
+#include "vtkGenericCell.h"
 #include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+#include <algorithm>
 #include <vector>
 
 vtkStandardNewMacro(vtkProbeFilter);
@@ -35,6 +42,190 @@ class vtkProbeFilter::vtkVectorOfArrays :
 {
 };
 
+namespace
+{
+// Points are located by batches, whose attributes are then interpolated
+// one array at a time.
+const vtkIdType VTK_PROBE_BATCH_SIZE = 1024;
+
+// The cells found for the points of a batch, with the points and weights
+// to interpolate from. Cell ids are -1 for points outside the source and
+// -2 for points probed already.
+struct vtkProbeFilterBatch
+{
+  std::vector<vtkIdType> CellIds;
+  std::vector<int> NumberOfCellPoints;
+  std::vector<vtkIdType> PointIds;
+  std::vector<double> Weights;
+};
+
+bool vtkProbeFilterIsThreadSafe(vtkArrayList &arrays)
+{
+  for (size_t i = 0; i < arrays.Pairs.size(); ++i)
+    {
+    if (!vtkArrayList::IsThreadSafe(arrays.Pairs[i]->Input) ||
+        !vtkArrayList::IsThreadSafe(arrays.Pairs[i]->Output))
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+// Probe the points not probed yet, batch by batch. Each batch collects the
+// points it found in ValidPoints.
+struct vtkProbeFilterProbePoints
+{
+  vtkDataSet *Input;
+  vtkDataSet *Source;
+  vtkIdType NumberOfPoints;
+  int MaxCellSize;
+  double Tol2;
+  char *Mask;
+  vtkArrayList *PointData;
+  vtkArrayList *CellData;
+  std::vector<vtkDataArray*> NullArrays;
+  std::vector<double> NullTuple;
+  std::vector<vtkIdType> *ValidPoints;
+  vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+  vtkSMPThreadLocal<vtkProbeFilterBatch> Batch;
+
+  void operator()(vtkIdType batch, vtkIdType endBatch)
+    {
+    vtkGenericCell *&cell = this->Cell.Local();
+    vtkProbeFilterBatch &local = this->Batch.Local();
+    int mcs = this->MaxCellSize;
+    if (local.CellIds.empty())
+      {
+      local.CellIds.resize(VTK_PROBE_BATCH_SIZE);
+      local.NumberOfCellPoints.resize(VTK_PROBE_BATCH_SIZE);
+      local.PointIds.resize(VTK_PROBE_BATCH_SIZE * mcs);
+      local.Weights.resize(VTK_PROBE_BATCH_SIZE * mcs);
+      }
+    double x[3], pcoords[3], closestPoint[3], dist2;
+    int subId;
+    size_t i;
+    vtkIdType k;
+    for ( ; batch < endBatch; ++batch)
+      {
+      vtkIdType begin = batch * VTK_PROBE_BATCH_SIZE;
+      vtkIdType numPts =
+        std::min(VTK_PROBE_BATCH_SIZE, this->NumberOfPoints - begin);
+      const vtkIdType *cellIds = &local.CellIds[0];
+      const int *numCellPts = &local.NumberOfCellPoints[0];
+      const vtkIdType *ptIds = &local.PointIds[0];
+      const double *weights = &local.Weights[0];
+
+      // Find the cell of each point.
+      for (k = 0; k < numPts; ++k)
+        {
+        vtkIdType &cellId = local.CellIds[k];
+        if (this->Mask[begin + k] == static_cast<char>(1))
+          {
+          // skip points which have already been probed with success.
+          // This is helpful for multiblock dataset probing.
+          cellId = -2;
+          continue;
+          }
+        double *w = &local.Weights[k * mcs];
+        this->Input->GetPoint(begin + k, x);
+        cellId = this->Source->FindCell(x, NULL, cell, -1, this->Tol2,
+                                        subId, pcoords, w);
+        if (cellId >= 0)
+          {
+          this->Source->GetCell(cellId, cell);
+          // If we found a cell, let's make sure that the point is within
+          // a certain size of the cell when it is slightly outside.
+          // The tolerance check above is based on the bounds of the whole
+          // dataset which may be significantly larger than the cell. When
+          // that happens, even a small tolerance may lead to finding a cell
+          // when the point is significantly outside that cell. This check
+          // is based on the cell's size. The tolerance here is significantly
+          // larger, 1/10 the size of the cell.
+          cell->EvaluatePosition(x, closestPoint, subId, pcoords, dist2, w);
+          if (dist2 > cell->GetLength2() * 0.01)
+            {
+            cellId = -1;
+            }
+          else
+            {
+            vtkIdList *cellPtIds = cell->GetPointIds();
+            local.NumberOfCellPoints[k] =
+              static_cast<int>(cellPtIds->GetNumberOfIds());
+            std::copy(cellPtIds->GetPointer(0),
+                      cellPtIds->GetPointer(0) + cellPtIds->GetNumberOfIds(),
+                      &local.PointIds[k * mcs]);
+            }
+          }
+        }
+
+      // Interpolate the point data and copy the cell data of the points
+      // found, and null the others.
+      for (i = 0; i < this->PointData->Pairs.size(); ++i)
+        {
+        vtkArrayListPair *pair = this->PointData->Pairs[i];
+        for (k = 0; k < numPts; ++k)
+          {
+          if (cellIds[k] >= 0)
+            {
+            pair->Interpolate(numCellPts[k], ptIds + k * mcs,
+                              weights + k * mcs, begin + k);
+            }
+          }
+        }
+      for (i = 0; i < this->CellData->Pairs.size(); ++i)
+        {
+        vtkArrayListPair *pair = this->CellData->Pairs[i];
+        for (k = 0; k < numPts; ++k)
+          {
+          if (cellIds[k] >= 0)
+            {
+            pair->Copy(cellIds[k], begin + k);
+            }
+          }
+        }
+      for (i = 0; i < this->NullArrays.size(); ++i)
+        {
+        vtkDataArray *array = this->NullArrays[i];
+        for (k = 0; k < numPts; ++k)
+          {
+          if (cellIds[k] == -1)
+            {
+            array->SetTuple(begin + k, &this->NullTuple[0]);
+            }
+          }
+        }
+      for (k = 0; k < numPts; ++k)
+        {
+        if (cellIds[k] >= 0)
+          {
+          this->Mask[begin + k] = static_cast<char>(1);
+          this->ValidPoints[batch].push_back(begin + k);
+          }
+        }
+      }
+    }
+};
+
+// Append the points found by each batch to the valid points.
+struct vtkProbeFilterAppendValidPoints
+{
+  const std::vector<vtkIdType> *ValidPoints;
+  const vtkIdType *Offsets;
+  vtkIdType *Output;
+
+  void operator()(vtkIdType batch, vtkIdType endBatch)
+    {
+    for ( ; batch < endBatch; ++batch)
+      {
+      std::copy(this->ValidPoints[batch].begin(),
+                this->ValidPoints[batch].end(),
+                this->Output + this->Offsets[batch]);
+      }
+    }
+};
+}
+
 //----------------------------------------------------------------------------
 vtkProbeFilter::vtkProbeFilter()
 {
@@ -271,36 +462,19 @@ void vtkProbeFilter::ProbeEmptyPoints(vtkDataSet *input,
   int srcIdx,
   vtkDataSet *source, vtkDataSet *output)
 {
-  vtkIdType ptId, numPts;
-  double x[3], tol2;
-  vtkCell *cell;
+  vtkIdType numPts;
+  double tol2;
   vtkPointData *pd, *outPD;
   vtkCellData* cd;
-  int subId;
-  double pcoords[3], *weights;
-  double fastweights[256];
 
   vtkDebugMacro(<<"Probing data");
 
   pd = source->GetPointData();
   cd = source->GetCellData();
 
-  // lets use a stack allocated array if possible for performance reasons
-  int mcs = source->GetMaxCellSize();
-  if (mcs<=256)
-    {
-    weights = fastweights;
-    }
-  else
-    {
-    weights = new double[mcs];
-    }
-
   numPts = input->GetNumberOfPoints();
   outPD = output->GetPointData();
 
-  char* maskArray = this->MaskPoints->GetPointer(0);
-
   if (this->ComputeTolerance)
     {
     // Use tolerance as a function of size of source data
@@ -333,86 +507,105 @@ void vtkProbeFilter::ProbeEmptyPoints(vtkDataSet *input,
     tol2 = this->Tolerance * this->Tolerance;
     }
 
-  // Loop over all input points, interpolating source data
-  //
-  int abort=0;
-  vtkIdType progressInterval=numPts/20 + 1;
-  for (ptId=0; ptId < numPts && !abort; ptId++)
+  if (numPts < 1)
     {
-    if ( !(ptId % progressInterval) )
-      {
-      this->UpdateProgress(static_cast<double>(ptId)/numPts);
-      abort = GetAbortExecute();
-      }
-
-    if (maskArray[ptId] == static_cast<char>(1))
-      {
-      // skip points which have already been probed with success.
-      // This is helpful for multiblock dataset probing.
-      continue;
-      }
-
-    // Get the xyz coordinate of the point in the input dataset
-    input->GetPoint(ptId, x);
+    return;
+    }
 
-    // Find the cell that contains xyz and get it
-    vtkIdType cellId = source->FindCell(x,NULL,-1,tol2,subId,pcoords,weights);
-    if (cellId >= 0)
+  // Pair the arrays to interpolate and copy, and size them and the arrays
+  // nulled for points outside the source.
+  vtkArrayList pointData;
+  for (int i = 0; i < this->PointList->GetNumberOfFields(); ++i)
+    {
+    int outIdx = this->PointList->GetFieldIndex(i);
+    int inIdx = this->PointList->GetDSAIndex(srcIdx, i);
+    if (outIdx >= 0 && inIdx >= 0)
       {
-      cell = source->GetCell(cellId);
-      // If we found a cell, let's make sure that the point is within
-      // a certain size of the cell when it is slightly outside.
-      // The tolerance check above is based on the bounds of the whole
-      // dataset which may be significantly larger than the cell. When
-      // that happens, even a small tolerance may lead to finding a cell
-      // when the point is significantly outside that cell. This check
-      // is based on the cell's size. The tolerance here is significantly
-      // larger, 1/10 the size of the cell.
-      double dist2;
-      double closestPoint[3];
-      cell->EvaluatePosition(x, closestPoint, subId,
-                             pcoords, dist2, weights);
-      if (dist2 > cell->GetLength2() * 0.01)
-        {
-        cell = 0;
-        }
+      pointData.AddArray(numPts, pd->GetAbstractArray(inIdx),
+                         outPD->GetAbstractArray(outIdx));
       }
-    else
+    }
+  vtkArrayList cellData;
+  vtkVectorOfArrays::iterator iter;
+  for (iter = this->CellArrays->begin(); iter != this->CellArrays->end();
+    ++iter)
+    {
+    vtkDataArray* inArray = cd->GetArray((*iter)->GetName());
+    if (inArray && inArray->GetDataType() == (*iter)->GetDataType())
       {
-      cell = 0;
+      cellData.AddArray(numPts, inArray, *iter);
       }
-    if (cell)
-      {
-      // Interpolate the point data
-      outPD->InterpolatePoint((*this->PointList), pd, srcIdx, ptId,
-        cell->PointIds, weights);
-      this->ValidPoints->InsertNextValue(ptId);
-      this->NumberOfValidPoints++;
-      vtkVectorOfArrays::iterator iter;
-      for (iter = this->CellArrays->begin(); iter != this->CellArrays->end();
-        ++iter)
-        {
-        vtkDataArray* inArray = cd->GetArray((*iter)->GetName());
-        if (inArray)
-          {
-          outPD->CopyTuple(inArray, *iter, cellId, ptId);
-          }
-        }
-      maskArray[ptId] = static_cast<char>(1);
-      }
-    else
+    }
+
+  vtkProbeFilterProbePoints probe;
+  bool threadSafe = vtkProbeFilterIsThreadSafe(pointData) &&
+    vtkProbeFilterIsThreadSafe(cellData);
+  if (this->UseNullPoint)
+    {
+    int maxComps = 1;
+    for (int i = 0; i < outPD->GetNumberOfArrays(); ++i)
       {
-      if (this->UseNullPoint)
+      vtkDataArray *array = outPD->GetArray(i);
+      if (array && array != this->MaskPoints)
         {
-        outPD->NullPoint(ptId);
+        array->SetNumberOfTuples(numPts);
+        probe.NullArrays.push_back(array);
+        maxComps = std::max(maxComps, array->GetNumberOfComponents());
+        threadSafe = threadSafe && vtkArrayList::IsThreadSafe(array);
         }
       }
+    probe.NullTuple.resize(maxComps, 0.0);
+    }
+
+  vtkIdType numBatches = (numPts - 1) / VTK_PROBE_BATCH_SIZE + 1;
+  std::vector<std::vector<vtkIdType> > validPoints(numBatches);
+  probe.Input = input;
+  probe.Source = source;
+  probe.NumberOfPoints = numPts;
+  probe.MaxCellSize = std::max(source->GetMaxCellSize(), 1);
+  probe.Tol2 = tol2;
+  probe.Mask = this->MaskPoints->GetPointer(0);
+  probe.PointData = &pointData;
+  probe.CellData = &cellData;
+  probe.ValidPoints = &validPoints[0];
+
+  // FindCell() and GetPoint() are thread safe once called from a single
+  // thread, which builds the locators and links they use.
+  double x[3], pcoords[3];
+  int subId;
+  input->GetPoint(0, x);
+  if (source->GetNumberOfPoints() > 0)
+    {
+    std::vector<double> weights(probe.MaxCellSize);
+    vtkNew<vtkGenericCell> cell;
+    source->GetPoint(0, x);
+    source->FindCell(x, NULL, cell.GetPointer(), -1, tol2, subId, pcoords,
+                     &weights[0]);
+    }
+  if (threadSafe)
+    {
+    vtkSMPTools::For(0, numBatches, probe);
+    }
+  else
+    {
+    probe(0, numBatches);
     }
 
-  if (mcs>256)
+  // Append the points found in the order of their ids.
+  std::vector<vtkIdType> offsets(numBatches + 1);
+  offsets[0] = this->ValidPoints->GetNumberOfTuples();
+  for (vtkIdType batch = 0; batch < numBatches; ++batch)
     {
-    delete [] weights;
+    offsets[batch + 1] =
+      offsets[batch] + static_cast<vtkIdType>(validPoints[batch].size());
     }
+  this->NumberOfValidPoints += static_cast<int>(offsets[numBatches] - offsets[0]);
+  this->ValidPoints->SetNumberOfValues(offsets[numBatches]);
+  vtkProbeFilterAppendValidPoints append;
+  append.ValidPoints = &validPoints[0];
+  append.Offsets = &offsets[0];
+  append.Output = this->ValidPoints->GetPointer(0);
+  vtkSMPTools::For(0, numBatches, append);
 }
 
 static void GetPointIdsInRange(double rangeMin, double rangeMax, double start,
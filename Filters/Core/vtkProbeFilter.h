@@ -31,6 +31,11 @@
 // rendering techniques can be used to visualize the results. Another example:
 // a line or curve can be used to probe data to produce x-y plots along
 // that line or curve.
+//
+// Points are probed in parallel with vtkSMPTools, by batches whose
+// attributes are interpolated one array at a time. Source data with bit
+// arrays, or arrays without the standard memory layout, is probed from a
+// single thread. Image data inputs are probed cell by cell, serially.
 
 #ifndef vtkProbeFilter_h
 #define vtkProbeFilter_h
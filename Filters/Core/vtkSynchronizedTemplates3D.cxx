@@ -21,6 +21,7 @@
 #include "vtkFloatArray.h"
 #include "vtkIdListCollection.h"
 #include "vtkInformation.h"
+#include "vtkInformationIntegerKey.h"
 #include "vtkInformationIntegerVectorKey.h"
 #include "vtkInformationVector.h"
 #include "vtkIntArray.h"
@@ -34,6 +35,7 @@
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredPoints.h"
+#include "vtkThreadedCompositeDataPipeline.h"
 #include "vtkUnsignedCharArray.h"
 #include "vtkUnsignedIntArray.h"
 #include "vtkUnsignedLongArray.h"
@@ -60,6 +62,10 @@ vtkSynchronizedTemplates3D::vtkSynchronizedTemplates3D()
   // by default process active point scalars
   this->SetInputArrayToProcess(0,0,0,vtkDataObject::FIELD_ASSOCIATION_POINTS,
                                vtkDataSetAttributes::SCALARS);
+
+  // All the state of an execution lives in the information objects.
+  this->GetInformation()->Set(
+    vtkThreadedCompositeDataPipeline::ALGORITHM_IS_REENTRANT(), 1);
 }
 
 //----------------------------------------------------------------------------
@@ -14,21 +14,162 @@
 =========================================================================*/
 #include "vtkThreshold.h"
 
+#include "vtkArrayListTemplate.h"
 #include "vtkCell.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkMath.h"
 
 #include <algorithm>
+#include <vector>
 
 vtkStandardNewMacro(vtkThreshold);
 
+namespace
+{
+// Number of cells in a block. Blocks are classified and filled by one
+// thread each, and the output is sized with a prefix sum over blocks.
+const vtkIdType VTK_THRESHOLD_BLOCK_SIZE = 8192;
+}
+
+// Evaluate the criterion for each cell, and count the kept cells and their
+// connectivity size in each block.
+struct vtkThresholdClassifyCells
+{
+  vtkThreshold *Self;
+  vtkDataSet *Input;
+  vtkDataArray *Scalars;
+  bool UsePointScalars;
+  vtkIdType NumberOfCells;
+  // Number of points of each cell, 0 for cells that are not kept.
+  int *CellSizes;
+  vtkIdType *BlockCells;
+  vtkIdType *BlockConnectivity;
+  vtkSMPThreadLocalObject<vtkIdList> CellPoints;
+
+  void operator()(vtkIdType block, vtkIdType endBlock)
+    {
+    vtkIdList *&cellPts = this->CellPoints.Local();
+    for ( ; block < endBlock; ++block)
+      {
+      vtkIdType cellId = block * VTK_THRESHOLD_BLOCK_SIZE;
+      vtkIdType endCellId =
+        std::min(cellId + VTK_THRESHOLD_BLOCK_SIZE, this->NumberOfCells);
+      vtkIdType numCells = 0, connectivitySize = 0;
+      for ( ; cellId < endCellId; ++cellId)
+        {
+        int numCellPts = 0;
+        if (this->Input->GetCellType(cellId) != VTK_EMPTY_CELL)
+          {
+          this->Input->GetCellPoints(cellId, cellPts);
+          numCellPts = static_cast<int>(cellPts->GetNumberOfIds());
+          }
+        if (numCellPts > 0 &&
+            !this->Self->EvaluateCriterion(this->Scalars, this->UsePointScalars,
+                                           cellId, cellPts, numCellPts))
+          {
+          numCellPts = 0;
+          }
+        this->CellSizes[cellId] = numCellPts;
+        if (numCellPts > 0)
+          {
+          ++numCells;
+          connectivitySize += numCellPts + 1;
+          }
+        }
+      this->BlockCells[block] = numCells;
+      this->BlockConnectivity[block] = connectivitySize;
+      }
+    }
+};
+
+namespace
+{
+// Copy the kept cells of each block at the offsets of the block, with the
+// input point ids, and their cell data.
+struct vtkThresholdFillCells
+{
+  vtkDataSet *Input;
+  vtkIdType NumberOfCells;
+  const int *CellSizes;
+  const vtkIdType *BlockCells;
+  const vtkIdType *BlockConnectivity;
+  unsigned char *Types;
+  vtkIdType *Locations;
+  vtkIdType *Connectivity;
+  vtkArrayList *CellData;
+  vtkSMPThreadLocalObject<vtkIdList> CellPoints;
+
+  void operator()(vtkIdType block, vtkIdType endBlock)
+    {
+    vtkIdList *&cellPts = this->CellPoints.Local();
+    for ( ; block < endBlock; ++block)
+      {
+      vtkIdType newCellId = this->BlockCells[block];
+      vtkIdType location = this->BlockConnectivity[block];
+      vtkIdType cellId = block * VTK_THRESHOLD_BLOCK_SIZE;
+      vtkIdType endCellId =
+        std::min(cellId + VTK_THRESHOLD_BLOCK_SIZE, this->NumberOfCells);
+      for ( ; cellId < endCellId; ++cellId)
+        {
+        int numCellPts = this->CellSizes[cellId];
+        if (numCellPts == 0)
+          {
+          continue;
+          }
+        this->Input->GetCellPoints(cellId, cellPts);
+        this->Types[newCellId] =
+          static_cast<unsigned char>(this->Input->GetCellType(cellId));
+        this->Locations[newCellId] = location;
+        vtkIdType *conn = this->Connectivity + location;
+        *conn++ = numCellPts;
+        for (int i = 0; i < numCellPts; ++i)
+          {
+          *conn++ = cellPts->GetId(i);
+          }
+        this->CellData->Copy(cellId, newCellId);
+        location += numCellPts + 1;
+        ++newCellId;
+        }
+      }
+    }
+};
+
+// Copy the points, and their point data, to the output. PointIds holds the
+// input id of each output point, or is NULL when all are kept.
+struct vtkThresholdFillPoints
+{
+  vtkDataSet *Input;
+  const vtkIdType *PointIds;
+  vtkPoints *Points;
+  vtkArrayList *PointData;
+
+  void operator()(vtkIdType newId, vtkIdType endId)
+    {
+    double x[3];
+    for ( ; newId < endId; ++newId)
+      {
+      vtkIdType ptId = this->PointIds ? this->PointIds[newId] : newId;
+      this->Input->GetPoint(ptId, x);
+      this->Points->SetPoint(newId, x);
+      this->PointData->Copy(ptId, newId);
+      }
+    }
+};
+}
+
 // Construct with lower threshold=0, upper threshold=1, and threshold
 // function=upper AllScalars=1.
 vtkThreshold::vtkThreshold()
@@ -47,6 +188,7 @@ vtkThreshold::vtkThreshold()
                                vtkDataSetAttributes::SCALARS);
 
   this->UseContinuousCellRange = 0;
+  this->CompactPoints = 1;
 }
 
 vtkThreshold::~vtkThreshold()
@@ -134,12 +276,9 @@ int vtkThreshold::RequestData(
     }
 
   outPD->CopyGlobalIdsOn();
-  outPD->CopyAllocate(pd);
   outCD->CopyGlobalIdsOn();
-  outCD->CopyAllocate(cd);
 
   numPts = input->GetNumberOfPoints();
-  output->Allocate(input->GetNumberOfCells());
 
   newPoints = vtkPoints::New();
 
@@ -165,6 +304,26 @@ int vtkThreshold::RequestData(
     newPoints->SetDataType(VTK_DOUBLE);
     }
 
+  // are we using pointScalars?
+  int fieldAssociation = this->GetInputArrayAssociation(0, inputVector);
+  bool usePointScalars = fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS;
+
+  if (this->CanProcessInParallel(input, inScalars))
+    {
+    this->ExtractCellsInParallel(input, inScalars, usePointScalars, output,
+                                 newPoints);
+    output->SetPoints(newPoints);
+    newPoints->Delete();
+    vtkDebugMacro(<< "Extracted " << output->GetNumberOfCells()
+                  << " number of cells.");
+    return 1;
+    }
+
+  outPD->CopyAllocate(pd);
+  outCD->CopyAllocate(cd);
+
+  output->Allocate(input->GetNumberOfCells());
+
   newPoints->Allocate(numPts);
 
   pointMap = vtkIdList::New(); //maps old point ids into new
@@ -174,11 +333,19 @@ int vtkThreshold::RequestData(
     pointMap->SetId(i,-1);
     }
 
-  newCellPts = vtkIdList::New();
+  // without compaction, all the points are kept with their ids
+  if (!this->CompactPoints)
+    {
+    for (i=0; i < numPts; i++)
+      {
+      input->GetPoint(i, x);
+      newPoints->InsertNextPoint(x);
+      pointMap->SetId(i,i);
+      outPD->CopyData(pd,i,i);
+      }
+    }
 
-  // are we using pointScalars?
-  int fieldAssociation = this->GetInputArrayAssociation(0, inputVector);
-  bool usePointScalars = fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS;
+  newCellPts = vtkIdList::New();
 
   // Check that the scalars of each cell satisfy the threshold criterion
   for (cellId=0; cellId < input->GetNumberOfCells(); cellId++)
@@ -187,38 +354,8 @@ int vtkThreshold::RequestData(
     cellPts = cell->GetPointIds();
     numCellPts = cell->GetNumberOfPoints();
 
-    if ( usePointScalars )
-      {
-      if (this->AllScalars)
-        {
-        keepCell = 1;
-        for ( i=0; keepCell && (i < numCellPts); i++)
-          {
-          ptId = cellPts->GetId(i);
-          keepCell = this->EvaluateComponents( inScalars, ptId );
-          }
-        }
-      else
-        {
-        if(!this->UseContinuousCellRange)
-          {
-          keepCell = 0;
-          for ( i=0; (!keepCell) && (i < numCellPts); i++)
-            {
-            ptId = cellPts->GetId(i);
-            keepCell = this->EvaluateComponents( inScalars, ptId );
-            }
-          }
-        else
-          {
-          keepCell = this->EvaluateCell(inScalars, cellPts, numCellPts);
-          }
-        }
-      }
-    else //use cell scalars
-      {
-      keepCell = this->EvaluateComponents( inScalars, cellId );
-      }
+    keepCell = this->EvaluateCriterion(inScalars, usePointScalars, cellId,
+                                       cellPts, numCellPts);
 
     if (  numCellPts > 0 && keepCell )
       {
@@ -266,6 +403,183 @@ int vtkThreshold::RequestData(
   return 1;
 }
 
+int vtkThreshold::EvaluateCriterion( vtkDataArray *scalars, bool usePointScalars,
+                                     vtkIdType cellId, vtkIdList* cellPts,
+                                     int numCellPts )
+{
+  int keepCell;
+  if ( usePointScalars )
+    {
+    if (this->AllScalars)
+      {
+      keepCell = 1;
+      for ( int i=0; keepCell && (i < numCellPts); i++)
+        {
+        keepCell = this->EvaluateComponents( scalars, cellPts->GetId(i) );
+        }
+      }
+    else
+      {
+      if(!this->UseContinuousCellRange)
+        {
+        keepCell = 0;
+        for ( int i=0; (!keepCell) && (i < numCellPts); i++)
+          {
+          keepCell = this->EvaluateComponents( scalars, cellPts->GetId(i) );
+          }
+        }
+      else
+        {
+        keepCell = this->EvaluateCell(scalars, cellPts, numCellPts);
+        }
+      }
+    }
+  else //use cell scalars
+    {
+    keepCell = this->EvaluateComponents( scalars, cellId );
+    }
+  return keepCell;
+}
+
+bool vtkThreshold::CanProcessInParallel( vtkDataSet *input, vtkDataArray *scalars )
+{
+  // Dataset types whose GetCellPoints(), GetCellType() and GetPoint() can
+  // be called from several threads.
+  switch (input->GetDataObjectType())
+    {
+    case VTK_UNSTRUCTURED_GRID:
+      // polyhedra need the face streams
+      if (static_cast<vtkUnstructuredGrid*>(input)->GetFaces())
+        {
+        return false;
+        }
+      break;
+    case VTK_POLY_DATA:
+    case VTK_IMAGE_DATA:
+    case VTK_STRUCTURED_POINTS:
+    case VTK_RECTILINEAR_GRID:
+    case VTK_STRUCTURED_GRID:
+      break;
+    default:
+      return false;
+    }
+  return vtkArrayList::IsThreadSafe(scalars) &&
+    vtkArrayList::IsThreadSafe(input->GetPointData()) &&
+    vtkArrayList::IsThreadSafe(input->GetCellData());
+}
+
+void vtkThreshold::ExtractCellsInParallel( vtkDataSet *input, vtkDataArray *scalars,
+                                           bool usePointScalars,
+                                           vtkUnstructuredGrid *output,
+                                           vtkPoints *newPoints )
+{
+  vtkIdType numCells = input->GetNumberOfCells();
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkIdType numBlocks =
+    (numCells + VTK_THRESHOLD_BLOCK_SIZE - 1) / VTK_THRESHOLD_BLOCK_SIZE;
+  if (numCells > 0)
+    {
+    // builds the cells of polydata before threads query them
+    input->GetCellType(0);
+    }
+
+  // Evaluate the criterion for every cell.
+  std::vector<int> cellSizes(numCells);
+  std::vector<vtkIdType> blockCells(numBlocks + 1, 0);
+  std::vector<vtkIdType> blockConnectivity(numBlocks + 1, 0);
+  vtkThresholdClassifyCells classify;
+  classify.Self = this;
+  classify.Input = input;
+  classify.Scalars = scalars;
+  classify.UsePointScalars = usePointScalars;
+  classify.NumberOfCells = numCells;
+  classify.CellSizes = numCells ? &cellSizes[0] : 0;
+  classify.BlockCells = &blockCells[0];
+  classify.BlockConnectivity = &blockConnectivity[0];
+  vtkSMPTools::For(0, numBlocks, 1, classify);
+
+  // The offsets of the blocks in the output.
+  vtkIdType numNewCells = 0, connectivitySize = 0;
+  for (vtkIdType block = 0; block <= numBlocks; ++block)
+    {
+    vtkIdType blockSize = blockCells[block];
+    vtkIdType blockConnectivitySize = blockConnectivity[block];
+    blockCells[block] = numNewCells;
+    blockConnectivity[block] = connectivitySize;
+    numNewCells += blockSize;
+    connectivitySize += blockConnectivitySize;
+    }
+
+  // Copy the cells and the cell data.
+  vtkCellData *cd = input->GetCellData(), *outCD = output->GetCellData();
+  outCD->CopyAllocate(cd, numNewCells);
+  vtkArrayList cellData;
+  cellData.AddArrays(numNewCells, cd, outCD);
+
+  vtkNew<vtkUnsignedCharArray> types;
+  types->SetNumberOfTuples(numNewCells);
+  vtkNew<vtkIdTypeArray> locations;
+  locations->SetNumberOfTuples(numNewCells);
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->SetNumberOfTuples(connectivitySize);
+  vtkIdType *conn = connectivity->GetPointer(0);
+
+  vtkThresholdFillCells fill;
+  fill.Input = input;
+  fill.NumberOfCells = numCells;
+  fill.CellSizes = classify.CellSizes;
+  fill.BlockCells = &blockCells[0];
+  fill.BlockConnectivity = &blockConnectivity[0];
+  fill.Types = types->GetPointer(0);
+  fill.Locations = locations->GetPointer(0);
+  fill.Connectivity = conn;
+  fill.CellData = &cellData;
+  vtkSMPTools::For(0, numBlocks, 1, fill);
+
+  // Number the points in the order the cells use them, as the serial
+  // algorithm does. This single pass over the connectivity is sequential.
+  std::vector<vtkIdType> pointIds;
+  vtkIdType numNewPts = numPts;
+  if (this->CompactPoints)
+    {
+    std::vector<vtkIdType> pointMap(numPts, -1);
+    for (vtkIdType loc = 0; loc < connectivitySize; )
+      {
+      vtkIdType numCellPts = conn[loc++];
+      for (vtkIdType *end = conn + loc + numCellPts; conn + loc < end; ++loc)
+        {
+        vtkIdType &newId = pointMap[conn[loc]];
+        if (newId < 0)
+          {
+          newId = static_cast<vtkIdType>(pointIds.size());
+          pointIds.push_back(conn[loc]);
+          }
+        conn[loc] = newId;
+        }
+      }
+    numNewPts = static_cast<vtkIdType>(pointIds.size());
+    }
+
+  // Copy the points and the point data.
+  vtkPointData *pd = input->GetPointData(), *outPD = output->GetPointData();
+  outPD->CopyAllocate(pd, numNewPts);
+  vtkArrayList pointData;
+  pointData.AddArrays(numNewPts, pd, outPD);
+  newPoints->SetNumberOfPoints(numNewPts);
+
+  vtkThresholdFillPoints fillPoints;
+  fillPoints.Input = input;
+  fillPoints.PointIds = this->CompactPoints && numNewPts ? &pointIds[0] : 0;
+  fillPoints.Points = newPoints;
+  fillPoints.PointData = &pointData;
+  vtkSMPTools::For(0, numNewPts, fillPoints);
+
+  vtkNew<vtkCellArray> cells;
+  cells->SetCells(numNewCells, connectivity.GetPointer());
+  output->SetCells(types.GetPointer(), locations.GetPointer(),
+                   cells.GetPointer());
+}
+
 int vtkThreshold::EvaluateCell( vtkDataArray *scalars,vtkIdList* cellPts, int numCellPts )
 {
   int c(0);
@@ -450,4 +764,5 @@ void vtkThreshold::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Precision of the output points: "
      << this->OutputPointsPrecision << "\n";
   os << indent << "Use Continuous Cell Range: "<<this->UseContinuousCellRange<<endl;
+  os << indent << "Compact Points: " << this->CompactPoints << endl;
 }
@@ -27,6 +27,13 @@
 //
 // By default only the first scalar value is used in the decision. Use the ComponentMode
 // and SelectedComponent ivars to control this behavior.
+//
+// Inputs of the usual dataset types are processed in parallel with
+// vtkSMPTools: the criterion is evaluated for every cell, the output is
+// sized with a prefix sum over blocks of cells, and the cells, points and
+// attribute data are copied in parallel. The output is the same as the one
+// of the serial algorithm, which is used for polyhedra, for other dataset
+// types, and for bit or mapped arrays.
 
 // .SECTION See Also
 // vtkThresholdPoints vtkThresholdTextureCoords
@@ -47,7 +54,10 @@
 #define VTK_COMPONENT_MODE_USE_ANY         2
 
 class vtkDataArray;
+class vtkDataSet;
 class vtkIdList;
+class vtkPoints;
+class vtkUnstructuredGrid;
 
 class VTKFILTERSCORE_EXPORT vtkThreshold : public vtkUnstructuredGridAlgorithm
 {
@@ -135,6 +145,14 @@ public:
   vtkGetMacro(UseContinuousCellRange,int);
   vtkBooleanMacro(UseContinuousCellRange,int);
 
+  // Description:
+  // When on (the default), the output only has the points used by the
+  // extracted cells, numbered in the order the cells use them. When off,
+  // the output has all the points of the input, with the same ids.
+  vtkSetMacro(CompactPoints,int);
+  vtkGetMacro(CompactPoints,int);
+  vtkBooleanMacro(CompactPoints,int);
+
   // Description:
   // Set the data type of the output points (See the data types defined in
   // vtkType.h). The default data type is float.
@@ -171,6 +189,7 @@ protected:
   int    SelectedComponent;
   int OutputPointsPrecision;
   int UseContinuousCellRange;
+  int CompactPoints;
 
   //BTX
   int (vtkThreshold::*ThresholdFunction)(double s);
@@ -184,6 +203,22 @@ protected:
   int EvaluateComponents( vtkDataArray *scalars, vtkIdType id );
   int EvaluateCell( vtkDataArray *scalars, vtkIdList* cellPts, int numCellPts );
   int EvaluateCell( vtkDataArray *scalars, int c, vtkIdList* cellPts, int numCellPts );
+
+  // Evaluate the criterion for a cell, with point or cell scalars.
+  int EvaluateCriterion( vtkDataArray *scalars, bool usePointScalars,
+                         vtkIdType cellId, vtkIdList* cellPts, int numCellPts );
+
+  // Whether the input and its arrays can be processed in parallel.
+  bool CanProcessInParallel( vtkDataSet *input, vtkDataArray *scalars );
+
+  // Extract the cells in parallel into output, with newPoints as points.
+  void ExtractCellsInParallel( vtkDataSet *input, vtkDataArray *scalars,
+                               bool usePointScalars, vtkUnstructuredGrid *output,
+                               vtkPoints *newPoints );
+
+  //BTX
+  friend struct vtkThresholdClassifyCells;
+  //ETX
 private:
   vtkThreshold(const vtkThreshold&);  // Not implemented.
   void operator=(const vtkThreshold&);  // Not implemented.
@@ -17,7 +17,7 @@
 #include "vtkCell.h"
 #include "vtkCellData.h"
 #include "vtkCellIterator.h"
-#include "vtkFloatArray.h"
+#include "vtkDoubleArray.h"
 #include "vtkIdList.h"
 #include "vtkImplicitFunction.h"
 #include "vtkInformation.h"
@@ -25,6 +25,8 @@
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPointSet.h"
 #include "vtkSmartPointer.h"
 #include "vtkUnstructuredGrid.h"
 
@@ -144,33 +146,45 @@ int vtkExtractGeometry::RequestData(
   newPts->Allocate(numPts/4,numPts);
   outputPD->CopyAllocate(pd);
   outputCD->CopyAllocate(cd);
-  vtkFloatArray *newScalars = NULL;
 
-  if ( ! this->ExtractBoundaryCells )
+  // Evaluate the implicit function at all the points in one pass. Explicit
+  // points are handed to the implicit function as a whole array.
+  vtkDoubleArray *newScalars = vtkDoubleArray::New();
+  vtkPointSet *pointSet = vtkPointSet::SafeDownCast(input);
+  if ( pointSet && pointSet->GetPoints() )
+    {
+    this->ImplicitFunction->FunctionValue(pointSet->GetPoints()->GetData(),
+                                          newScalars);
+    }
+  else
     {
+    newScalars->SetNumberOfValues(numPts);
     for ( ptId=0; ptId < numPts; ptId++ )
       {
       input->GetPoint(ptId, x);
-      if ( (this->ImplicitFunction->FunctionValue(x)*multiplier) < 0.0 )
-        {
-        newId = newPts->InsertNextPoint(x);
-        pointMap[ptId] = newId;
-        outputPD->CopyData(pd,ptId,newId);
-        }
+      newScalars->SetValue(ptId, this->ImplicitFunction->FunctionValue(x));
       }
     }
-  else
+  double *scalars = newScalars->GetPointer(0);
+  if ( multiplier != 1.0 )
     {
-    // To extract boundary cells, we have to create supplemental information
-    double val;
-    newScalars = vtkFloatArray::New();
-    newScalars->SetNumberOfValues(numPts);
+    for ( ptId=0; ptId < numPts; ptId++ )
+      {
+      scalars[ptId] *= multiplier;
+      }
+    }
 
-    for (ptId=0; ptId < numPts; ptId++ )
+  if ( ! this->ExtractBoundaryCells )
+    {
+    for ( ptId=0; ptId < numPts; ptId++ )
       {
-      input->GetPoint(ptId, x);
-      val = this->ImplicitFunction->FunctionValue(x) * multiplier;
-      newScalars->SetValue(ptId, val);
+      if ( scalars[ptId] < 0.0 )
+        {
+        input->GetPoint(ptId, x);
+        newId = newPts->InsertNextPoint(x);
+        pointMap[ptId] = newId;
+        outputPD->CopyData(pd,ptId,newId);
+        }
       }
     }
 
@@ -206,7 +220,7 @@ int vtkExtractGeometry::RequestData(
       for ( npts=0, i=0; i < numCellPts; i++ )
         {
         ptId = pointIdList->GetId(i);
-        if ( newScalars->GetValue(ptId) <= 0.0 )
+        if ( scalars[ptId] <= 0.0 )
           {
           npts++;
           }
@@ -279,10 +293,7 @@ int vtkExtractGeometry::RequestData(
   output->SetPoints(newPts);
   newPts->Delete();
 
-  if ( this->ExtractBoundaryCells )
-    {
-    newScalars->Delete();
-    }
+  newScalars->Delete();
 
   output->Squeeze();
 
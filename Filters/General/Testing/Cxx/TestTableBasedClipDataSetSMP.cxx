@@ -0,0 +1,200 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestTableBasedClipDataSetSMP.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Clips a linear field on image data and on its tetrahedra, which are cut
+// into several blocks of cells, and checks that the points of the blocks
+// are merged, that the attributes are interpolated, and that the serial
+// path used for bit arrays gives the same output.
+
+#include "vtkBitArray.h"
+#include "vtkCellData.h"
+#include "vtkDataSetTriangleFilter.h"
+#include "vtkFloatArray.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkTableBasedClipDataSet.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cmath>
+#include <set>
+#include <vector>
+
+#define CHECK(cond)                                                    \
+  do                                                                   \
+    {                                                                  \
+    if (!(cond))                                                       \
+      {                                                                \
+      cerr << "Line " << __LINE__ << ": check failed: " #cond << endl; \
+      return EXIT_FAILURE;                                             \
+      }                                                                \
+    }                                                                  \
+  while (0)
+
+namespace
+{
+double Field(const double x[3])
+{
+  return x[0] + 2.0 * x[1] - 3.0 * x[2];
+}
+
+// Checks that the points of output are distinct, that the field is
+// interpolated and on the side of value given by insideOut, and that the
+// cell ids of the input cells are copied.
+int CheckClip(vtkUnstructuredGrid *output, double value, bool insideOut,
+              vtkIdType numInputCells)
+{
+  vtkFloatArray *field = vtkFloatArray::SafeDownCast(
+    output->GetPointData()->GetArray("Field"));
+  vtkIdTypeArray *cellIds = vtkIdTypeArray::SafeDownCast(
+    output->GetCellData()->GetArray("CellIds"));
+  CHECK(field && cellIds);
+  CHECK(output->GetNumberOfPoints() > 0 && output->GetNumberOfCells() > 0);
+  CHECK(field->GetNumberOfTuples() == output->GetNumberOfPoints());
+  CHECK(cellIds->GetNumberOfTuples() == output->GetNumberOfCells());
+
+  std::set<std::vector<double> > points;
+  double x[3];
+  for (vtkIdType i = 0; i < output->GetNumberOfPoints(); ++i)
+    {
+    output->GetPoint(i, x);
+    points.insert(std::vector<double>(x, x + 3));
+    CHECK(std::fabs(field->GetValue(i) - Field(x)) < 1e-4);
+    CHECK(insideOut ? Field(x) < value + 1e-4 : Field(x) > value - 1e-4);
+    }
+  CHECK(static_cast<vtkIdType>(points.size()) == output->GetNumberOfPoints());
+
+  for (vtkIdType i = 0; i < output->GetNumberOfCells(); ++i)
+    {
+    CHECK(cellIds->GetValue(i) >= 0 && cellIds->GetValue(i) < numInputCells);
+    }
+  return EXIT_SUCCESS;
+}
+
+bool SameOutput(vtkUnstructuredGrid *a, vtkUnstructuredGrid *b)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      a->GetNumberOfCells() != b->GetNumberOfCells())
+    {
+    return false;
+    }
+  double x[3], y[3];
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); ++i)
+    {
+    a->GetPoint(i, x);
+    b->GetPoint(i, y);
+    if (x[0] != y[0] || x[1] != y[1] || x[2] != y[2] ||
+        a->GetPointData()->GetArray("Field")->GetComponent(i, 0) !=
+        b->GetPointData()->GetArray("Field")->GetComponent(i, 0))
+      {
+      return false;
+      }
+    }
+  vtkNew<vtkIdList> p;
+  vtkNew<vtkIdList> q;
+  for (vtkIdType i = 0; i < a->GetNumberOfCells(); ++i)
+    {
+    a->GetCellPoints(i, p.GetPointer());
+    b->GetCellPoints(i, q.GetPointer());
+    if (a->GetCellType(i) != b->GetCellType(i) ||
+        p->GetNumberOfIds() != q->GetNumberOfIds())
+      {
+      return false;
+      }
+    for (vtkIdType j = 0; j < p->GetNumberOfIds(); ++j)
+      {
+      if (p->GetId(j) != q->GetId(j))
+        {
+        return false;
+        }
+      }
+    }
+  return true;
+}
+}
+
+int TestTableBasedClipDataSetSMP(int, char *[])
+{
+  // A linear field on a grid, with the ids of its cells.
+  vtkNew<vtkImageData> image;
+  image->SetOrigin(-5.0, -5.0, -5.0);
+  image->SetSpacing(0.5, 0.5, 0.5);
+  image->SetDimensions(21, 21, 21);
+  vtkNew<vtkFloatArray> field;
+  field->SetName("Field");
+  field->SetNumberOfTuples(image->GetNumberOfPoints());
+  double x[3];
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+    {
+    image->GetPoint(i, x);
+    field->SetValue(i, Field(x));
+    }
+  image->GetPointData()->SetScalars(field.GetPointer());
+  vtkNew<vtkIdTypeArray> cellIds;
+  cellIds->SetName("CellIds");
+  cellIds->SetNumberOfTuples(image->GetNumberOfCells());
+  for (vtkIdType i = 0; i < image->GetNumberOfCells(); ++i)
+    {
+    cellIds->SetValue(i, i);
+    }
+  image->GetCellData()->AddArray(cellIds.GetPointer());
+
+  vtkNew<vtkTableBasedClipDataSet> clip;
+  clip->SetInputData(image.GetPointer());
+  clip->SetValue(1.3);
+  clip->GenerateClippedOutputOn();
+  clip->Update();
+  CHECK(CheckClip(clip->GetOutput(), 1.3, false,
+                  image->GetNumberOfCells()) == EXIT_SUCCESS);
+  CHECK(CheckClip(clip->GetClippedOutput(), 1.3, true,
+                  image->GetNumberOfCells()) == EXIT_SUCCESS);
+
+  vtkNew<vtkDataSetTriangleFilter> tetrahedra;
+  tetrahedra->SetInputData(image.GetPointer());
+  tetrahedra->Update();
+  vtkUnstructuredGrid *grid = tetrahedra->GetOutput();
+  vtkNew<vtkTableBasedClipDataSet> gridClip;
+  gridClip->SetInputData(grid);
+  gridClip->SetValue(1.3);
+  gridClip->InsideOutOn();
+  gridClip->Update();
+  CHECK(CheckClip(gridClip->GetOutput(), 1.3, true,
+                  grid->GetNumberOfCells()) == EXIT_SUCCESS);
+
+  // Bit arrays are interpolated serially, with the same output.
+  vtkNew<vtkBitArray> bits;
+  bits->SetName("Bits");
+  bits->SetNumberOfTuples(grid->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < grid->GetNumberOfPoints(); ++i)
+    {
+    bits->SetValue(i, 1);
+    }
+  grid->GetPointData()->AddArray(bits.GetPointer());
+  vtkNew<vtkTableBasedClipDataSet> serialClip;
+  serialClip->SetInputData(grid);
+  serialClip->SetValue(1.3);
+  serialClip->InsideOutOn();
+  serialClip->Update();
+  CHECK(SameOutput(serialClip->GetOutput(), gridClip->GetOutput()));
+  vtkBitArray *outBits = vtkBitArray::SafeDownCast(
+    serialClip->GetOutput()->GetPointData()->GetArray("Bits"));
+  CHECK(outBits &&
+        outBits->GetNumberOfTuples() ==
+        serialClip->GetOutput()->GetNumberOfPoints());
+
+  return EXIT_SUCCESS;
+}
@@ -30,6 +30,8 @@
 #include "vtkObjectFactory.h"
 #include "vtkPlane.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPointSet.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkUnsignedCharArray.h"
@@ -321,10 +323,19 @@ int vtkClipDataSet::RequestData(
       {
       inPD->SetScalars(tmpScalars);
       }
-    for ( i=0; i < numPts; i++ )
+    vtkPointSet *pointSet = vtkPointSet::SafeDownCast(input);
+    if ( pointSet && pointSet->GetPoints() )
       {
-      s = this->ClipFunction->FunctionValue(input->GetPoint(i));
-      tmpScalars->SetTuple1(i,s);
+      this->ClipFunction->FunctionValue(pointSet->GetPoints()->GetData(),
+                                        tmpScalars);
+      }
+    else
+      {
+      for ( i=0; i < numPts; i++ )
+        {
+        s = this->ClipFunction->FunctionValue(input->GetPoint(i));
+        tmpScalars->SetTuple1(i,s);
+        }
       }
     clipScalars = tmpScalars;
     }
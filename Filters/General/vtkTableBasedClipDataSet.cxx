@@ -49,6 +49,8 @@
 #include "vtkPolyData.h"
 #include "vtkCellData.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPointSet.h"
 #include "vtkCellArray.h"
 #include "vtkImageData.h"
 #include "vtkDoubleArray.h"
@@ -57,9 +59,14 @@
 #include "vtkRectilinearGrid.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkGenericCell.h"
+#include "vtkArrayListTemplate.h"
+#include "vtkSMPTools.h"
 
 #include "vtkTableBasedClipCases.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro( vtkTableBasedClipDataSet );
 vtkCxxSetObjectMacro( vtkTableBasedClipDataSet, ClipFunction, vtkImplicitFunction );
 
@@ -212,7 +219,7 @@ class  vtkTableBasedClipperDataSetFromVolume
 
 vtkTableBasedClipperPointList::vtkTableBasedClipperPointList()
 {
-  listSize      = 4096;
+  listSize      = 64;
   pointsPerList = 1024;
 
   list = new TableBasedClipperPointEntry * [ listSize ];
@@ -605,11 +612,15 @@ class  vtkTableBasedClipperVolumeFromVolume :
               ( int precision, int nPts, int ptSizeGuess );
     virtual  ~vtkTableBasedClipperVolumeFromVolume() { }
 
-    void      ConstructDataSet( vtkDataSet *,
-                                vtkUnstructuredGrid *, double * );
-    void      ConstructDataSet( vtkDataSet *,
-                                vtkUnstructuredGrid *, int *, double *,
-                                double *, double * );
+    // Build the output from the buckets filled by consecutive blocks of
+    // cells, as if a single bucket had been filled by all the cells.
+    static void ConstructDataSet( vtkTableBasedClipperVolumeFromVolume **,
+                                  int, vtkDataSet *,
+                                  vtkUnstructuredGrid *, double * );
+    static void ConstructDataSet( vtkTableBasedClipperVolumeFromVolume **,
+                                  int, vtkDataSet *,
+                                  vtkUnstructuredGrid *, int *, double *,
+                                  double *, double * );
 
     int      AddCentroidPoint( int n, int * p )
              { return -1 - centroid_list.AddPoint( n, p ); }
@@ -633,6 +644,13 @@ class  vtkTableBasedClipperVolumeFromVolume :
     void     AddVertex(int z, int v0)
              { this->vertices.AddVertex( z, v0 ); }
 
+    const vtkTableBasedClipperPointList & GetPointList() const
+             { return this->pt_list; }
+    const vtkTableBasedClipperCentroidPointList & GetCentroidList() const
+             { return this->centroid_list; }
+    const vtkTableBasedClipperShapeList * GetShapeList( int i ) const
+             { return this->shapes[i]; }
+
   protected:
     vtkTableBasedClipperCentroidPointList centroid_list;
     vtkTableBasedClipperHexList     hexes;
@@ -648,8 +666,9 @@ class  vtkTableBasedClipperVolumeFromVolume :
     const int    nshapes;
     int OutputPointsPrecision;
 
-    void         ConstructDataSet
-                 ( vtkDataSet *, vtkUnstructuredGrid *,
+    static void  ConstructDataSet
+                 ( vtkTableBasedClipperVolumeFromVolume **, int,
+                   vtkDataSet *, vtkUnstructuredGrid *,
                    TableBasedClipperCommonPointsStructure & );
 };
 
@@ -671,7 +690,7 @@ vtkTableBasedClipperVolumeFromVolume( int precision, int nPts, int ptSizeGuess )
 
 vtkTableBasedClipperCentroidPointList::vtkTableBasedClipperCentroidPointList()
 {
-  listSize      = 4096;
+  listSize      = 64;
   pointsPerList = 1024;
 
   list    = new TableBasedClipperCentroidPointEntry * [ listSize ];
@@ -771,7 +790,7 @@ int  vtkTableBasedClipperCentroidPointList::AddPoint( int npts, int * pts )
 vtkTableBasedClipperShapeList::vtkTableBasedClipperShapeList( int size )
 {
   shapeSize     = size;
-  listSize      = 4096;
+  listSize      = 64;
   shapesPerList = 1024;
 
   list    = new int * [ listSize ];
@@ -1199,18 +1218,404 @@ void vtkTableBasedClipperVertexList::AddVertex( int cellId, int v1 )
   currentShape ++;
 }
 
+// ---- vtkTableBasedClipperMerge (begin)
+// An edge point of a bucket, keyed by its edge. Once sorted, the points of
+// all the buckets that lie on the same edge follow each other, the one with
+// the lowest index (the first created) leading.
+struct TableBasedClipperEdgeEntry
+{
+  int      ptIds[2];
+  int      index;
+
+  bool     operator < ( const TableBasedClipperEdgeEntry & e ) const
+           {
+           return ( ptIds[0] != e.ptIds[0] ? ptIds[0] < e.ptIds[0] :
+                    ptIds[1] != e.ptIds[1] ? ptIds[1] < e.ptIds[1] :
+                                             index    < e.index );
+           }
+};
+
+
+// What the functors that build the output from the buckets share: where
+// the points of every bucket go, and the attribute arrays to fill.
+struct vtkTableBasedClipperMerge
+{
+  vtkTableBasedClipperVolumeFromVolume   ** Buckets;
+  int                                       NumberOfBuckets;
+  TableBasedClipperCommonPointsStructure  * Points;
+  int            NumberOfInputPoints;
+  const int    * PointLookup;    // output ids of the input points, or -1
+  const int    * FirstEdges;     // first point created on each edge
+  const int    * EdgeIds;        // output ids of the edge points
+  const int    * EdgeStarts;     // first edge point of each bucket
+  const int    * CentroidStarts; // output id of the first centroid of a bucket
+  vtkArrayList   PointArrays;
+  vtkArrayList   CentroidArrays;
+  vtkArrayList   CellArrays;
+  const int    * OrigNodes;
+  int          * NewOrigNodes;
+  int            NumberOfOrigComponents;
+  bool           Parallel;       // whether the attributes allow threads
+
+  // Output id of point pt of a shape or centroid of the given bucket.
+  int      GetOutputId( int bucket, int pt ) const
+           {
+           if ( pt < 0 )
+             {
+             return this->CentroidStarts[ bucket ] - 1 - pt;
+             }
+           if ( pt >= this->NumberOfInputPoints )
+             {
+             return this->EdgeIds
+                    [ this->EdgeStarts[ bucket ] + pt - this->NumberOfInputPoints ];
+             }
+           return this->PointLookup[ pt ];
+           }
+
+  void     GetInputPoint( int id, double * pt ) const
+           {
+           if ( this->Points->hasPtsList )
+             {
+             const double * x = this->Points->pts_ptr + 3 * id;
+             pt[0] = x[0];
+             pt[1] = x[1];
+             pt[2] = x[2];
+             }
+           else
+             {
+             const int * dims = this->Points->dims;
+             pt[0] = this->Points->X[ id % dims[0] ];
+             pt[1] = this->Points->Y[ ( id / dims[0] ) % dims[1] ];
+             pt[2] = this->Points->Z[ id / ( dims[0] * dims[1] ) ];
+             }
+           }
+
+  void     CopyOrigNodes( int inId, int outId )
+           {
+           for ( int i = 0; i < this->NumberOfOrigComponents; i ++ )
+             {
+             this->NewOrigNodes[ outId * this->NumberOfOrigComponents + i ] =
+               this->OrigNodes[ inId * this->NumberOfOrigComponents + i ];
+             }
+           }
+};
+
+
+template < class T >
+inline void vtkTableBasedClipperSetPoint( T * points, int id, const double * pt )
+{
+  T * x = points + 3 * id;
+  x[0] = static_cast < T > ( pt[0] );
+  x[1] = static_cast < T > ( pt[1] );
+  x[2] = static_cast < T > ( pt[2] );
+}
+
+
+// Gather the edge points of a range of buckets.
+struct vtkTableBasedClipperGatherEdges
+{
+  const vtkTableBasedClipperMerge * Merge;
+  TableBasedClipperEdgeEntry      * Edges;
+
+  void operator () ( vtkIdType bucket, vtkIdType endBucket )
+  {
+    for ( ; bucket < endBucket; bucket ++ )
+      {
+      const vtkTableBasedClipperPointList & pt_list =
+        this->Merge->Buckets[ bucket ]->GetPointList();
+      int idx    = this->Merge->EdgeStarts[ bucket ];
+      int nLists = pt_list.GetNumberOfLists();
+      for ( int i = 0; i < nLists; i ++ )
+        {
+        const TableBasedClipperPointEntry * pe_list = NULL;
+        int nPts = pt_list.GetList( i, pe_list );
+        for ( int j = 0; j < nPts; j ++, idx ++ )
+          {
+          this->Edges[ idx ].ptIds[0] = pe_list[j].ptIds[0];
+          this->Edges[ idx ].ptIds[1] = pe_list[j].ptIds[1];
+          this->Edges[ idx ].index    = idx;
+          }
+        }
+      }
+  }
+};
+
+
+// Find the first point created on the edge of each of a range of sorted
+// edge points.
+struct vtkTableBasedClipperFindFirstEdges
+{
+  const TableBasedClipperEdgeEntry * Edges;
+  int                              * FirstEdges;
+
+  void operator () ( vtkIdType i, vtkIdType end )
+  {
+    for ( ; i < end; i ++ )
+      {
+      const TableBasedClipperEdgeEntry & e = this->Edges[i];
+      vtkIdType first = i;
+      while ( first > 0 && this->Edges[ first - 1 ].ptIds[0] == e.ptIds[0] &&
+                           this->Edges[ first - 1 ].ptIds[1] == e.ptIds[1] )
+        {
+        first --;
+        }
+      this->FirstEdges[ e.index ] = this->Edges[ first ].index;
+      }
+  }
+};
+
+
+// Copy a range of the input points, and their attributes, to the output.
+template < class T >
+struct vtkTableBasedClipperCopyPoints
+{
+  vtkTableBasedClipperMerge * Merge;
+  T                         * OutPoints;
+
+  void operator () ( vtkIdType ptId, vtkIdType endPtId )
+  {
+    vtkTableBasedClipperMerge & merge = *this->Merge;
+    for ( ; ptId < endPtId; ptId ++ )
+      {
+      int outId = merge.PointLookup[ ptId ];
+      if ( outId == -1 )
+        {
+        continue;
+        }
+
+      double pt[3];
+      merge.GetInputPoint( ptId, pt );
+      vtkTableBasedClipperSetPoint( this->OutPoints, outId, pt );
+      merge.PointArrays.Copy( ptId, outId );
+      if ( merge.NewOrigNodes )
+        {
+        merge.CopyOrigNodes( ptId, outId );
+        }
+      }
+  }
+};
+
+
+// Construct the edge points of a range of buckets, skipping those another
+// point was created for first.
+template < class T >
+struct vtkTableBasedClipperEdgePoints
+{
+  vtkTableBasedClipperMerge * Merge;
+  T                         * OutPoints;
+
+  void operator () ( vtkIdType bucket, vtkIdType endBucket )
+  {
+    vtkTableBasedClipperMerge & merge = *this->Merge;
+    for ( ; bucket < endBucket; bucket ++ )
+      {
+      const vtkTableBasedClipperPointList & pt_list =
+        merge.Buckets[ bucket ]->GetPointList();
+      int idx    = merge.EdgeStarts[ bucket ];
+      int nLists = pt_list.GetNumberOfLists();
+      for ( int i = 0; i < nLists; i ++ )
+        {
+        const TableBasedClipperPointEntry * pe_list = NULL;
+        int nPts = pt_list.GetList( i, pe_list );
+        for ( int j = 0; j < nPts; j ++, idx ++ )
+          {
+          if ( merge.FirstEdges[ idx ] != idx )
+            {
+            continue;
+            }
+
+          const TableBasedClipperPointEntry & pe = pe_list[j];
+          double pt1[3], pt2[3], pt[3];
+          merge.GetInputPoint( pe.ptIds[0], pt1 );
+          merge.GetInputPoint( pe.ptIds[1], pt2 );
+
+          double p  = pe.percent;
+          double bp = 1.0 - p;
+          pt[0] = pt1[0] * p + pt2[0] * bp;
+          pt[1] = pt1[1] * p + pt2[1] * bp;
+          pt[2] = pt1[2] * p + pt2[2] * bp;
+
+          int outId = merge.EdgeIds[ idx ];
+          vtkTableBasedClipperSetPoint( this->OutPoints, outId, pt );
+          merge.PointArrays.InterpolateEdge
+                ( pe.ptIds[0], pe.ptIds[1], bp, outId );
+          if ( merge.NewOrigNodes )
+            {
+            merge.CopyOrigNodes
+                  ( bp <= 0.5 ? pe.ptIds[0] : pe.ptIds[1], outId );
+            }
+          }
+        }
+      }
+  }
+};
+
+
+// Construct the "centroid" points of a range of buckets. A centroid may
+// average earlier centroids of its bucket, so those of a bucket are
+// constructed in order, by one thread.
+template < class T >
+struct vtkTableBasedClipperCentroidPoints
+{
+  vtkTableBasedClipperMerge * Merge;
+  T                         * OutPoints;
+
+  void operator () ( vtkIdType bucket, vtkIdType endBucket )
+  {
+    vtkTableBasedClipperMerge & merge = *this->Merge;
+    for ( ; bucket < endBucket; bucket ++ )
+      {
+      const vtkTableBasedClipperCentroidPointList & centroid_list =
+        merge.Buckets[ bucket ]->GetCentroidList();
+      int outId  = merge.CentroidStarts[ bucket ];
+      int nLists = centroid_list.GetNumberOfLists();
+      for ( int i = 0; i < nLists; i ++ )
+        {
+        const TableBasedClipperCentroidPointEntry * ce_list = NULL;
+        int nPts = centroid_list.GetList( i, ce_list );
+        for ( int j = 0; j < nPts; j ++, outId ++ )
+          {
+          const TableBasedClipperCentroidPointEntry & ce = ce_list[j];
+          vtkIdType ids[8];
+          double    weights[8];
+          double    pt[3] = { 0.0, 0.0, 0.0 };
+          double    weight_factor = 1.0 / ce.nPts;
+          for ( int k = 0; k < ce.nPts; k ++ )
+            {
+            weights[k] = 1.0 * weight_factor;
+            ids[k]     = merge.GetOutputId( bucket, ce.ptIds[k] );
+
+            const T * x = this->OutPoints + 3 * ids[k];
+            pt[0] += static_cast < double > ( x[0] );
+            pt[1] += static_cast < double > ( x[1] );
+            pt[2] += static_cast < double > ( x[2] );
+            }
+          pt[0] *= weight_factor;
+          pt[1] *= weight_factor;
+          pt[2] *= weight_factor;
+
+          vtkTableBasedClipperSetPoint( this->OutPoints, outId, pt );
+          merge.CentroidArrays.Interpolate( ce.nPts, ids, weights, outId );
+          if ( merge.NewOrigNodes )
+            {
+            // these 'created' nodes have no original designation
+            for ( int z = 0; z < merge.NumberOfOrigComponents; z ++ )
+              {
+              merge.NewOrigNodes[ outId * merge.NumberOfOrigComponents + z ] =
+                -1;
+              }
+            }
+          }
+        }
+      }
+  }
+};
+
+
+template < class T >
+void vtkTableBasedClipperConstructPoints( vtkTableBasedClipperMerge & merge,
+                                          T * outPts )
+{
+  vtkTableBasedClipperCopyPoints< T > copyPoints;
+  copyPoints.Merge     = &merge;
+  copyPoints.OutPoints = outPts;
+
+  vtkTableBasedClipperEdgePoints< T > edgePoints;
+  edgePoints.Merge     = &merge;
+  edgePoints.OutPoints = outPts;
+
+  vtkTableBasedClipperCentroidPoints< T > centroidPoints;
+  centroidPoints.Merge     = &merge;
+  centroidPoints.OutPoints = outPts;
+
+  // Centroids average the other points, so they come last.
+  if ( merge.Parallel )
+    {
+    vtkSMPTools::For( 0, merge.NumberOfInputPoints, copyPoints );
+    vtkSMPTools::For( 0, merge.NumberOfBuckets, 1, edgePoints );
+    vtkSMPTools::For( 0, merge.NumberOfBuckets, 1, centroidPoints );
+    }
+  else
+    {
+    copyPoints( 0, merge.NumberOfInputPoints );
+    edgePoints( 0, merge.NumberOfBuckets );
+    centroidPoints( 0, merge.NumberOfBuckets );
+    }
+}
+
+
+// Write the cells of a range of shape lists, indexed by shape type and then
+// by bucket, and copy their cell data.
+struct vtkTableBasedClipperFillCells
+{
+  vtkTableBasedClipperMerge * Merge;
+  const vtkIdType           * CellStarts;     // first cell of each list
+  const vtkIdType           * LocationStarts; // first location of each list
+  vtkIdType                 * Connectivity;
+  vtkIdType                 * Locations;
+  unsigned char             * Types;
+
+  void operator () ( vtkIdType idx, vtkIdType endIdx )
+  {
+    vtkTableBasedClipperMerge & merge = *this->Merge;
+    for ( ; idx < endIdx; idx ++ )
+      {
+      int bucket = static_cast < int > ( idx % merge.NumberOfBuckets );
+      const vtkTableBasedClipperShapeList * shapes =
+        merge.Buckets[ bucket ]->GetShapeList
+                                 (  static_cast < int >
+                                    ( idx / merge.NumberOfBuckets )  );
+      int nlists    = shapes->GetNumberOfLists();
+      int shapesize = shapes->GetShapeSize();
+      int vtk_type  = shapes->GetVTKType();
+
+      vtkIdType   cellId        = this->CellStarts[ idx ];
+      vtkIdType   current_index = this->LocationStarts[ idx ];
+      vtkIdType * nl = this->Connectivity + current_index;
+      vtkIdType * cl = this->Locations + cellId;
+      unsigned char * ct = this->Types + cellId;
+
+      for ( int j = 0; j < nlists; j ++ )
+        {
+        const int * list;
+        int listSize = shapes->GetList( j, list );
+
+        for ( int k = 0; k < listSize; k ++ )
+          {
+          merge.CellArrays.Copy( list[0], cellId );
+
+          *nl ++ = shapesize;
+          *cl ++ = current_index;
+          *ct ++ = vtk_type;
+          for ( int l = 0; l < shapesize; l ++ )
+            {
+            *nl ++ = merge.GetOutputId( bucket, list[ l + 1 ] );
+            }
+          list += shapesize + 1;
+
+          current_index += shapesize + 1;
+          cellId ++;
+          }
+        }
+      }
+  }
+};
+// ---- vtkTableBasedClipperMerge (end)
+
 void vtkTableBasedClipperVolumeFromVolume::
-     ConstructDataSet( vtkDataSet * input,
+     ConstructDataSet( vtkTableBasedClipperVolumeFromVolume ** buckets,
+                       int numBuckets, vtkDataSet * input,
                        vtkUnstructuredGrid * output, double * pts_ptr )
 {
   TableBasedClipperCommonPointsStructure cps;
   cps.hasPtsList = true;
   cps.pts_ptr    = pts_ptr;
-  ConstructDataSet( input, output, cps );
+  ConstructDataSet( buckets, numBuckets, input, output, cps );
 }
 
 void vtkTableBasedClipperVolumeFromVolume::
-     ConstructDataSet( vtkDataSet * input,
+     ConstructDataSet( vtkTableBasedClipperVolumeFromVolume ** buckets,
+                       int numBuckets, vtkDataSet * input,
                        vtkUnstructuredGrid * output,
                        int * dims, double * X, double * Y, double * Z )
 {
@@ -1220,15 +1625,18 @@ void vtkTableBasedClipperVolumeFromVolume::
   cps.X          = X;
   cps.Y          = Y;
   cps.Z          = Z;
-  ConstructDataSet( input, output, cps );
+  ConstructDataSet( buckets, numBuckets, input, output, cps );
 }
 
 void vtkTableBasedClipperVolumeFromVolume::
-     ConstructDataSet( vtkDataSet * input,
+     ConstructDataSet( vtkTableBasedClipperVolumeFromVolume ** buckets,
+                       int numBuckets, vtkDataSet * input,
                        vtkUnstructuredGrid * output,
                        TableBasedClipperCommonPointsStructure & cps )
 {
-  int   i, j, k, l;
+  int   i, j, k, l, b;
+  int   numPrevPts = buckets[0]->numPrevPts;
+  int   nshapes    = buckets[0]->nshapes;
 
   vtkPointData * inPD = input->GetPointData();
   vtkCellData  * inCD = input->GetCellData();
@@ -1243,6 +1651,8 @@ void vtkTableBasedClipperVolumeFromVolume::
   // If the isovolume only affects a small part of the dataset, we can save
   // on memory by only bringing over the points from the original dataset
   // that are used with the output.  Determine which points those are here.
+  // The shapes are visited type by type, and bucket by bucket within a type,
+  // so the points are numbered as if a single bucket held all the shapes.
   //
   int * ptLookup = new int[ numPrevPts ];
   for ( i = 0; i < numPrevPts; i ++ )
@@ -1253,28 +1663,32 @@ void vtkTableBasedClipperVolumeFromVolume::
   int numUsed = 0;
   for ( i = 0; i < nshapes; i ++ )
     {
-    int nlists = shapes[i]->GetNumberOfLists();
-    int npts_per_shape = shapes[i]->GetShapeSize();
-
-    for ( j = 0; j < nlists; j ++ )
+    for ( b = 0; b < numBuckets; b ++ )
       {
-      const int * list;
-      int listSize = shapes[i]->GetList( j, list );
+      const vtkTableBasedClipperShapeList * shapes = buckets[b]->shapes[i];
+      int nlists = shapes->GetNumberOfLists();
+      int npts_per_shape = shapes->GetShapeSize();
 
-      for ( k = 0; k < listSize; k ++ )
+      for ( j = 0; j < nlists; j ++ )
         {
-        list ++; // skip the cell id entry
+        const int * list;
+        int listSize = shapes->GetList( j, list );
 
-        for ( l = 0; l < npts_per_shape; l ++ )
+        for ( k = 0; k < listSize; k ++ )
           {
-          int pt = *list;
-          list ++;
+          list ++; // skip the cell id entry
 
-          if ( pt >= 0 && pt < numPrevPts )
+          for ( l = 0; l < npts_per_shape; l ++ )
             {
-            if ( ptLookup[pt] == -1 )
+            int pt = *list;
+            list ++;
+
+            if ( pt >= 0 && pt < numPrevPts )
               {
-              ptLookup[pt] = numUsed ++;
+              if ( ptLookup[pt] == -1 )
+                {
+                ptLookup[pt] = numUsed ++;
+                }
               }
             }
           }
@@ -1282,13 +1696,69 @@ void vtkTableBasedClipperVolumeFromVolume::
       }
     }
 
+  //
+  // Cells of different blocks share the points on the edges between them,
+  // which several buckets may have created. Sort the edge points of all the
+  // buckets by edge and keep the first point created on each edge: they are
+  // numbered in the order a single bucket would have created them.
+  //
+  std::vector< int > edgeStarts( numBuckets + 1, 0 );
+  for ( b = 0; b < numBuckets; b ++ )
+    {
+    edgeStarts[ b + 1 ] = edgeStarts[b] +
+                          buckets[b]->pt_list.GetTotalNumberOfPoints();
+    }
+  int numEdges = edgeStarts[ numBuckets ];
+
+  vtkTableBasedClipperMerge merge;
+  merge.Buckets             = buckets;
+  merge.NumberOfBuckets     = numBuckets;
+  merge.Points              = &cps;
+  merge.NumberOfInputPoints = numPrevPts;
+  merge.PointLookup         = ptLookup;
+  merge.EdgeStarts          = &edgeStarts[0];
+
+  std::vector< TableBasedClipperEdgeEntry > edges( numEdges + 1 );
+  std::vector< int > firstEdges( numEdges + 1 );
+  std::vector< int > edgeIds( numEdges + 1 );
+
+  vtkTableBasedClipperGatherEdges gatherEdges;
+  gatherEdges.Merge = &merge;
+  gatherEdges.Edges = &edges[0];
+  vtkSMPTools::For( 0, numBuckets, 1, gatherEdges );
+
+  vtkSMPTools::Sort( &edges[0], &edges[0] + numEdges );
+
+  vtkTableBasedClipperFindFirstEdges findFirstEdges;
+  findFirstEdges.Edges      = &edges[0];
+  findFirstEdges.FirstEdges = &firstEdges[0];
+  vtkSMPTools::For( 0, numEdges, findFirstEdges );
+
+  int ptIdx = numUsed;
+  for ( i = 0; i < numEdges; i ++ )
+    {
+    edgeIds[i] = ( firstEdges[i] == i ? ptIdx ++ : edgeIds[ firstEdges[i] ] );
+    }
+  merge.FirstEdges = &firstEdges[0];
+  merge.EdgeIds    = &edgeIds[0];
+
+  // The centroids follow, bucket after bucket.
+  std::vector< int > centroidStarts( numBuckets + 1, ptIdx );
+  for ( b = 0; b < numBuckets; b ++ )
+    {
+    centroidStarts[ b + 1 ] = centroidStarts[b] +
+                              buckets[b]->centroid_list.GetTotalNumberOfPoints();
+    }
+  merge.CentroidStarts = &centroidStarts[0];
+
   //
   // Set up the output points and its point data.
   //
   vtkPoints * outPts = vtkPoints::New();
 
   // set precision for the points in the output
-  if(this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
+  int precision = buckets[0]->OutputPointsPrecision;
+  if(precision == vtkAlgorithm::DEFAULT_PRECISION)
     {
     vtkPointSet *inputPointSet = vtkPointSet::SafeDownCast(input);
     if(inputPointSet)
@@ -1300,183 +1770,78 @@ void vtkTableBasedClipperVolumeFromVolume::
       outPts->SetDataType(VTK_FLOAT);
       }
     }
-  else if(this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
+  else if(precision == vtkAlgorithm::SINGLE_PRECISION)
     {
     outPts->SetDataType(VTK_FLOAT);
     }
-  else if(this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+  else if(precision == vtkAlgorithm::DOUBLE_PRECISION)
     {
     outPts->SetDataType(VTK_DOUBLE);
     }
 
-  int centroidStart  = numUsed + pt_list.GetTotalNumberOfPoints();
-  int nOutPts        = centroidStart + centroid_list.GetTotalNumberOfPoints();
+  int nOutPts = centroidStarts[ numBuckets ];
   outPts->SetNumberOfPoints( nOutPts );
   outPD->CopyAllocate( inPD, nOutPts );
+  merge.PointArrays.AddArrays( nOutPts, inPD, outPD );
+  for ( i = 0; i < merge.PointArrays.GetNumberOfArrays(); i ++ )
+    {
+    vtkAbstractArray * outArray = merge.PointArrays.Pairs[i]->Output;
+    merge.CentroidArrays.AddArray( nOutPts, outArray, outArray );
+    }
 
+  merge.OrigNodes              = NULL;
+  merge.NewOrigNodes           = NULL;
+  merge.NumberOfOrigComponents = 0;
   if ( origNodes != NULL )
     {
     newOrigNodes = vtkIntArray::New();
     newOrigNodes->SetNumberOfComponents( origNodes->GetNumberOfComponents() );
     newOrigNodes->SetNumberOfTuples( nOutPts );
     newOrigNodes->SetName( origNodes->GetName() );
+    merge.OrigNodes              = origNodes->GetPointer( 0 );
+    merge.NewOrigNodes           = newOrigNodes->GetPointer( 0 );
+    merge.NumberOfOrigComponents = origNodes->GetNumberOfComponents();
     }
 
   //
-  // Copy over all the points from the input that are actually used in the
-  // output.
+  // Count the shapes of every type in every bucket to place their cells,
+  // and set up the cell data.
   //
-  for ( i = 0; i < numPrevPts; i ++ )
+  std::vector< vtkIdType > cellStarts( nshapes * numBuckets + 1, 0 );
+  std::vector< vtkIdType > locationStarts( nshapes * numBuckets + 1, 0 );
+  for ( i = 0; i < nshapes; i ++ )
     {
-    if ( ptLookup[i] == -1 )
-      {
-      continue;
-      }
-
-    if ( cps.hasPtsList )
-      {
-      outPts->SetPoint( ptLookup[i], cps.pts_ptr + 3 * i );
-      }
-    else
+    for ( b = 0; b < numBuckets; b ++ )
       {
-      int I = i % cps.dims[0];
-      int J = (i / cps.dims[0]) % cps.dims[1];
-      int K = i / ( cps.dims[0] * cps.dims[1] );
-      outPts->SetPoint( ptLookup[i], cps.X[I], cps.Y[J], cps.Z[K] );
-      }
-
-    outPD->CopyData( inPD, i, ptLookup[i] );
-    if ( newOrigNodes )
-      {
-      newOrigNodes->SetTuple(  ptLookup[i], origNodes->GetTuple( i )  );
+      int idx = i * numBuckets + b;
+      int ns  = buckets[b]->shapes[i]->GetTotalNumberOfShapes();
+      cellStarts[ idx + 1 ]     = cellStarts[ idx ] + ns;
+      locationStarts[ idx + 1 ] = locationStarts[ idx ] +
+        ( buckets[b]->shapes[i]->GetShapeSize() + 1 ) * ns;
       }
     }
+  vtkIdType ncells    = cellStarts[ nshapes * numBuckets ];
+  vtkIdType conn_size = locationStarts[ nshapes * numBuckets ];
 
-  int ptIdx = numUsed;
-
-  //
-  // Now construct all the points that are along edges and new and add
-  // them to the points list.
-  //
-  int nLists = pt_list.GetNumberOfLists();
-  for ( i = 0; i < nLists; i ++ )
-    {
-    const TableBasedClipperPointEntry * pe_list = NULL;
-    int nPts = pt_list.GetList( i, pe_list );
-    for ( j = 0; j < nPts; j ++ )
-      {
-      const TableBasedClipperPointEntry & pe = pe_list[j];
-      double pt[3];
-      int idx1 = pe.ptIds[0];
-      int idx2 = pe.ptIds[1];
-
-      // Construct the original points -- this will depend on whether
-      // or not we started with a rectilinear grid or a point set.
-      double * pt1 = NULL;
-      double * pt2 = NULL;
-      double pt1_storage[3];
-      double pt2_storage[3];
-      if ( cps.hasPtsList )
-        {
-        pt1 = cps.pts_ptr + 3 * idx1;
-        pt2 = cps.pts_ptr + 3 * idx2;
-        }
-      else
-        {
-        pt1 = pt1_storage;
-        pt2 = pt2_storage;
-        int I = idx1 % cps.dims[0];
-        int J = ( idx1 / cps.dims[0] ) % cps.dims[1];
-        int K = idx1 / ( cps.dims[0] * cps.dims[1] );
-        pt1[0] = cps.X[I];
-        pt1[1] = cps.Y[J];
-        pt1[2] = cps.Z[K];
-        I = idx2 % cps.dims[0];
-        J = ( idx2 / cps.dims[0] ) % cps.dims[1];
-        K = idx2 / ( cps.dims[0] * cps.dims[1] );
-        pt2[0] = cps.X[I];
-        pt2[1] = cps.Y[J];
-        pt2[2] = cps.Z[K];
-        }
-
-      // Now that we have the original points, calculate the new one.
-      double p  = pe.percent;
-      double bp = 1.0 - p;
-      pt[0] = pt1[0] * p + pt2[0] * bp;
-      pt[1] = pt1[1] * p + pt2[1] * bp;
-      pt[2] = pt1[2] * p + pt2[2] * bp;
-      outPts->SetPoint( ptIdx, pt );
-      outPD->InterpolateEdge( inPD, ptIdx, pe.ptIds[0], pe.ptIds[1], bp );
+  outCD->CopyAllocate( inCD, ncells );
+  merge.CellArrays.AddArrays( ncells, inCD, outCD );
 
-      if ( newOrigNodes )
-        {
-        int id = ( bp <= 0.5 ? pe.ptIds[0] : pe.ptIds[1] );
-        newOrigNodes->SetTuple(  ptIdx, origNodes->GetTuple( id )  );
-        }
-      ptIdx ++;
-      }
-    }
+  merge.Parallel = vtkArrayList::IsThreadSafe( inPD ) &&
+                   vtkArrayList::IsThreadSafe( outPD ) &&
+                   vtkArrayList::IsThreadSafe( inCD ) &&
+                   vtkArrayList::IsThreadSafe( outCD );
 
   //
-  // Now construct the new "centroid" points and add them to the points list.
+  // Copy over all the points from the input that are actually used in the
+  // output, then construct the points that are along edges and the new
+  // "centroid" points.
   //
-  nLists = centroid_list.GetNumberOfLists();
-  vtkIdList * idList = vtkIdList::New();
-  for ( i = 0; i < nLists; i ++ )
+  switch ( outPts->GetDataType() )
     {
-    const TableBasedClipperCentroidPointEntry * ce_list = NULL;
-    int nPts = centroid_list.GetList( i, ce_list );
-    for ( j = 0; j < nPts; j ++ )
-      {
-      const TableBasedClipperCentroidPointEntry & ce = ce_list[j];
-      idList->SetNumberOfIds( ce.nPts );
-      double pts[8][3];
-      double weights[8];
-      double pt[3] = { 0.0, 0.0, 0.0 };
-      double weight_factor = 1.0 / ce.nPts;
-      for ( k = 0; k < ce.nPts; k ++ )
-        {
-        weights[k] = 1.0 * weight_factor;
-        int id = 0;
-
-        if ( ce.ptIds[k] < 0 )
-          {
-          id = centroidStart - 1 - ce.ptIds[k];
-          }
-        else
-        if ( ce.ptIds[k] >= numPrevPts )
-          {
-          id = numUsed + ( ce.ptIds[k] - numPrevPts );
-          }
-        else
-          {
-          id = ptLookup[ ce.ptIds[k] ];
-          }
-
-        idList->SetId( k, id );
-        outPts->GetPoint( id, pts[k] );
-        pt[0] += pts[k][0];
-        pt[1] += pts[k][1];
-        pt[2] += pts[k][2];
-        }
-      pt[0] *= weight_factor;
-      pt[1] *= weight_factor;
-      pt[2] *= weight_factor;
-
-      outPts->SetPoint( ptIdx, pt );
-      outPD->InterpolatePoint( outPD, ptIdx, idList, weights );
-      if ( newOrigNodes )
-        {
-        // these 'created' nodes have no original designation
-        for ( int z = 0; z < newOrigNodes->GetNumberOfComponents(); z ++ )
-          {
-          newOrigNodes->SetComponent( ptIdx, z, -1 );
-          }
-        }
-      ptIdx ++;
-      }
+    vtkTemplateMacro( vtkTableBasedClipperConstructPoints
+                      ( merge, static_cast < VTK_TT * >
+                               (  outPts->GetVoidPointer( 0 )  ) ) );
     }
-  idList->Delete();
 
   //
   // We are finally done constructing the points list.  Set it with our
@@ -1496,78 +1861,29 @@ void vtkTableBasedClipperVolumeFromVolume::
   //
   // Now set up the shapes and the cell data.
   //
-  int cellId = 0;
-  int nlists;
-
-  int ncells    = 0;
-  int conn_size = 0;
-  for ( i = 0; i < nshapes; i ++ )
-    {
-    int ns     = shapes[i]->GetTotalNumberOfShapes();
-    ncells    += ns;
-    conn_size += ( shapes[i]->GetShapeSize() + 1 ) * ns;
-    }
-
-  outCD->CopyAllocate( inCD, ncells );
-
   vtkIdTypeArray * nlist = vtkIdTypeArray::New();
   nlist->SetNumberOfValues( conn_size );
-  vtkIdType * nl = nlist->GetPointer( 0 );
 
   vtkUnsignedCharArray * cellTypes = vtkUnsignedCharArray::New();
   cellTypes->SetNumberOfValues( ncells );
-  unsigned char * ct = cellTypes->GetPointer( 0 );
 
   vtkIdTypeArray * cellLocations = vtkIdTypeArray::New();
   cellLocations->SetNumberOfValues( ncells );
-  vtkIdType * cl = cellLocations->GetPointer( 0 );
 
-  vtkIdType ids[1024]; // 8 (for hex) should be max, but...
-  int current_index = 0;
-  for ( i = 0; i < nshapes; i ++ )
+  vtkTableBasedClipperFillCells fillCells;
+  fillCells.Merge          = &merge;
+  fillCells.CellStarts     = &cellStarts[0];
+  fillCells.LocationStarts = &locationStarts[0];
+  fillCells.Connectivity   = nlist->GetPointer( 0 );
+  fillCells.Locations      = cellLocations->GetPointer( 0 );
+  fillCells.Types          = cellTypes->GetPointer( 0 );
+  if ( merge.Parallel )
     {
-    const int * list;
-    nlists = shapes[i]->GetNumberOfLists();
-    int shapesize = shapes[i]->GetShapeSize();
-    int vtk_type = shapes[i]->GetVTKType();
-
-    for ( j = 0; j < nlists; j ++ )
-      {
-      int listSize = shapes[i]->GetList( j, list );
-
-      for ( k = 0; k < listSize; k ++ )
-        {
-        outCD->CopyData( inCD, list[0], cellId );
-
-        for ( l = 0; l < shapesize; l ++ )
-          {
-          if (  list[ l + 1 ] < 0  )
-            {
-            ids[l] = centroidStart - 1 - list[ l + 1 ];
-            }
-          else
-          if (  list[ l + 1 ] >= numPrevPts  )
-            {
-            ids[l] = numUsed + (  list[ l + 1 ] - numPrevPts  );
-            }
-          else
-            {
-            ids[l] = ptLookup[  list[ l + 1 ]  ];
-            }
-          }
-        list += shapesize + 1;
-        *nl ++ = shapesize;
-        *cl ++ = current_index;
-        *ct ++ = vtk_type;
-        for ( l = 0; l < shapesize; l ++ )
-          {
-          *nl ++ = ids[l];
-          }
-
-        current_index += shapesize + 1;
-        cellId ++;
-        }
-      }
+    vtkSMPTools::For( 0, nshapes * numBuckets, 1, fillCells );
+    }
+  else
+    {
+    fillCells( 0, nshapes * numBuckets );
     }
 
   vtkCellArray * cells = vtkCellArray::New();
@@ -1597,34 +1913,791 @@ inline void GetPoint( double * pt, const double * X, const double * Y,
 // ============================================================================
 
 
-//-----------------------------------------------------------------------------
-// Construct with user-specified implicit function; InsideOut turned off; value
-// set to 0.0; and generate clip scalars turned off.
-vtkTableBasedClipDataSet::vtkTableBasedClipDataSet( vtkImplicitFunction * cf )
-{
-  this->Locator      = NULL;
-  this->ClipFunction = cf;
+// ============================================================================
+// ================ vtkTableBasedClipperCellBlocks (begin) ====================
+// ============================================================================
 
-  // setup a callback to report progress
-  this->InternalProgressObserver = vtkCallbackCommand::New();
-  this->InternalProgressObserver->SetCallback
-        ( &vtkTableBasedClipDataSet::InternalProgressCallbackFunction );
-  this->InternalProgressObserver->SetClientData( this );
+// Fewest cells in a block. The cells are split into a few blocks per
+// thread, clipped into a bucket of their own.
+const int VTK_TABLE_BASED_CLIP_MIN_BLOCK_SIZE = 4096;
+
+// Blocks of cells, each clipped into a bucket of its own, by one thread.
+// ConstructDataSet() merges the buckets into the same output as a single
+// bucket would give, however the cells are split. The cells the tables
+// cannot clip are collected per block, in cell order.
+struct vtkTableBasedClipperCellBlocks
+{
+  vtkTableBasedClipDataSet * Self;
+  vtkDataArray             * ClipArray;
+  double                     IsoValue;
+  int                        InsideOut;
+  int                        OutputPointsPrecision;
+  int                        NumberOfPoints;
+  vtkIdType                  NumberOfCells;
+  vtkIdType                  BlockSize;
+  std::vector< vtkTableBasedClipperVolumeFromVolume * > Buckets;
+  std::vector< std::vector< vtkIdType > >               Specials;
+
+  vtkTableBasedClipperCellBlocks( vtkTableBasedClipDataSet * self,
+                                  vtkDataArray * clipAray, double isoValue,
+                                  int numPts, vtkIdType numCells )
+    : Self( self ), ClipArray( clipAray ), IsoValue( isoValue ),
+      InsideOut( self->GetInsideOut() ),
+      OutputPointsPrecision( self->GetOutputPointsPrecision() ),
+      NumberOfPoints( numPts ), NumberOfCells( numCells )
+  {
+    vtkIdType numBlocks = std::min < vtkIdType >
+      ( ( numCells + VTK_TABLE_BASED_CLIP_MIN_BLOCK_SIZE - 1 ) /
+          VTK_TABLE_BASED_CLIP_MIN_BLOCK_SIZE,
+        8 * vtkSMPTools::GetEstimatedNumberOfThreads() );
+    numBlocks = std::max < vtkIdType > ( numBlocks, 1 );
+    this->BlockSize = ( numCells + numBlocks - 1 ) / numBlocks;
+    this->Buckets.resize( numBlocks, NULL );
+    this->Specials.resize( numBlocks );
+  }
 
-  this->Value     = 0.0;
-  this->InsideOut = 0;
-  this->MergeTolerance        = 0.01;
-  this->UseValueAsOffset      = true;
-  this->GenerateClipScalars   = 0;
-  this->GenerateClippedOutput = 0;
+  ~vtkTableBasedClipperCellBlocks()
+  {
+    for ( size_t i = 0; i < this->Buckets.size(); i ++ )
+      {
+      delete this->Buckets[i];
+      }
+  }
 
-  this->OutputPointsPrecision = DEFAULT_PRECISION;
+  int      GetNumberOfBlocks() const
+           { return static_cast < int > ( this->Buckets.size() ); }
 
-  this->SetNumberOfOutputPorts( 2 );
-  vtkUnstructuredGrid * output2 = vtkUnstructuredGrid::New();
-  this->GetExecutive()->SetOutputData( 1, output2 );
-  output2->Delete();
-  output2 = NULL;
+  // Create the bucket of a block and get the range of its cells.
+  vtkTableBasedClipperVolumeFromVolume * NewBucket
+    ( vtkIdType block, vtkIdType & cellId, vtkIdType & endCellId )
+  {
+    cellId    = block * this->BlockSize;
+    endCellId = std::min( cellId + this->BlockSize, this->NumberOfCells );
+    this->Buckets[ block ] = new vtkTableBasedClipperVolumeFromVolume
+      ( this->OutputPointsPrecision, this->NumberOfPoints,
+        int(   pow(  double( endCellId - cellId ), double( 0.6667f )  )   ) *
+        5 + 100 );
+    return this->Buckets[ block ];
+  }
+
+  void     ConstructDataSet( vtkDataSet * input, vtkUnstructuredGrid * output,
+                             double * pts_ptr )
+           {
+           vtkTableBasedClipperVolumeFromVolume::ConstructDataSet
+             ( &this->Buckets[0], this->GetNumberOfBlocks(),
+               input, output, pts_ptr );
+           }
+  void     ConstructDataSet( vtkDataSet * input, vtkUnstructuredGrid * output,
+                             int * dims, double * X, double * Y, double * Z )
+           {
+           vtkTableBasedClipperVolumeFromVolume::ConstructDataSet
+             ( &this->Buckets[0], this->GetNumberOfBlocks(),
+               input, output, dims, X, Y, Z );
+           }
+
+private:
+  vtkTableBasedClipperCellBlocks
+    ( const vtkTableBasedClipperCellBlocks & ); // Not implemented.
+  void operator = ( const vtkTableBasedClipperCellBlocks & ); // Not implemented.
+};
+
+
+// Clip the blocks of cells, from several threads if the clip scalars can be
+// read concurrently.
+template < class TClipper >
+void vtkTableBasedClipperClipBlocks( TClipper & clipper )
+{
+  if ( vtkArrayList::IsThreadSafe( clipper.ClipArray ) )
+    {
+    vtkSMPTools::For( 0, clipper.GetNumberOfBlocks(), 1, clipper );
+    }
+  else
+    {
+    clipper( 0, clipper.GetNumberOfBlocks() );
+    }
+}
+
+
+// Clip the cells of a vtkUnstructuredGrid or a vtkPolyData. Polyhedra and
+// the cells without clip tables are left to vtkClipDataSet.
+template < class TGrid >
+struct vtkTableBasedClipperClipCells : public vtkTableBasedClipperCellBlocks
+{
+  TGrid * Grid;
+
+  vtkTableBasedClipperClipCells( vtkTableBasedClipDataSet * self,
+                                 TGrid * grid, vtkDataArray * clipAray,
+                                 double isoValue )
+    : vtkTableBasedClipperCellBlocks( self, clipAray, isoValue,
+                                      grid->GetNumberOfPoints(),
+                                      grid->GetNumberOfCells() ),
+      Grid( grid )
+  {
+  }
+
+  void operator () ( vtkIdType block, vtkIdType endBlock )
+  {
+    for ( ; block < endBlock; block ++ )
+      {
+      vtkIdType   i, j, endCell;
+      vtkIdType   numbPnts = 0;
+      vtkTableBasedClipperVolumeFromVolume * visItVFV =
+        this->NewBucket( block, i, endCell );
+
+      for ( ; i < endCell; i ++ )
+        {
+        int         cellType = this->Grid->GetCellType( i );
+        vtkIdType * pntIndxs = NULL;
+        this->Grid->GetCellPoints( i, numbPnts, pntIndxs );
+
+        bool     bCanClip = false;
+        switch ( cellType )
+          {
+          case VTK_TETRA:
+          case VTK_PYRAMID:
+          case VTK_WEDGE:
+          case VTK_HEXAHEDRON:
+          case VTK_VOXEL:
+          case VTK_TRIANGLE:
+          case VTK_QUAD:
+          case VTK_PIXEL:
+          case VTK_LINE:
+          case VTK_VERTEX:
+               bCanClip = true;
+               break;
+
+          default:
+               bCanClip = false;
+               break;
+          }
+
+        if ( bCanClip )
+          {
+          int    caseIndx = 0;
+          double grdDiffs[8];
+
+          for ( j = numbPnts-1; j >= 0; j -- )
+            {
+            grdDiffs[j] = this->ClipArray->GetComponent( pntIndxs[j], 0 ) - this->IsoValue;
+            caseIndx   += (  ( grdDiffs[j] >= 0.0 ) ? 1 : 0  );
+            caseIndx  <<= (  1 - ( !j )  );
+            }
+
+          int               startIdx = 0;
+          int               nOutputs = 0;
+          typedef const int EDGEIDXS[2];
+          EDGEIDXS        * edgeVtxs = NULL;
+          unsigned char   * thisCase = NULL;
+
+          // start index, split case, number of output, and vertices from edges
+          switch ( cellType )
+            {
+            case VTK_TETRA:
+              startIdx = vtkTableBasedClipperClipTables::StartClipShapesTet[ caseIndx ];
+              thisCase =&vtkTableBasedClipperClipTables::ClipShapesTet[ startIdx ];
+              nOutputs = vtkTableBasedClipperClipTables::NumClipShapesTet[ caseIndx ];
+              edgeVtxs = ( EDGEIDXS * )
+                         vtkTableBasedClipperTriangulationTables::TetVerticesFromEdges;
+              break;
+
+            case VTK_PYRAMID:
+              startIdx = vtkTableBasedClipperClipTables::StartClipShapesPyr[ caseIndx ];
+              thisCase =&vtkTableBasedClipperClipTables::ClipShapesPyr[ startIdx ];
+              nOutputs = vtkTableBasedClipperClipTables::NumClipShapesPyr[ caseIndx ];
+              edgeVtxs = ( EDGEIDXS * )
+                         vtkTableBasedClipperTriangulationTables::PyramidVerticesFromEdges;
+              break;
+
+            case VTK_WEDGE:
+              startIdx = vtkTableBasedClipperClipTables::StartClipShapesWdg[ caseIndx ];
+              thisCase =&vtkTableBasedClipperClipTables::ClipShapesWdg[ startIdx ];
+              nOutputs = vtkTableBasedClipperClipTables::NumClipShapesWdg[ caseIndx ];
+              edgeVtxs = ( EDGEIDXS * )
+                         vtkTableBasedClipperTriangulationTables::WedgeVerticesFromEdges;
+              break;
+
+            case VTK_HEXAHEDRON:
+              startIdx = vtkTableBasedClipperClipTables::StartClipShapesHex[ caseIndx ];
+              thisCase =&vtkTableBasedClipperClipTables::ClipShapesHex[ startIdx ];
+              nOutputs = vtkTableBasedClipperClipTables::NumClipShapesHex[ caseIndx ];
+              edgeVtxs = ( EDGEIDXS * )
+                         vtkTableBasedClipperTriangulationTables::HexVerticesFromEdges;
+              break;
+
+            case VTK_VOXEL:
+              startIdx = vtkTableBasedClipperClipTables::StartClipShapesVox[ caseIndx ];
+              thisCase =&vtkTableBasedClipperClipTables::ClipShapesVox[ startIdx ];
+              nOutputs = vtkTableBasedClipperClipTables::NumClipShapesVox[ caseIndx ];
+              edgeVtxs = ( EDGEIDXS * )
+                         vtkTableBasedClipperTriangulationTables::VoxVerticesFromEdges;
+              break;
+
+            case VTK_TRIANGLE:
+              startIdx = vtkTableBasedClipperClipTables::StartClipShapesTri[ caseIndx ];
+              thisCase =&vtkTableBasedClipperClipTables::ClipShapesTri[ startIdx ];
+              nOutputs = vtkTableBasedClipperClipTables::NumClipShapesTri[ caseIndx ];
+              edgeVtxs = ( EDGEIDXS * )
+                         vtkTableBasedClipperTriangulationTables::TriVerticesFromEdges;
+              break;
+
+            case VTK_QUAD:
+              startIdx = vtkTableBasedClipperClipTables::StartClipShapesQua[ caseIndx ];
+              thisCase =&vtkTableBasedClipperClipTables::ClipShapesQua[ startIdx ];
+              nOutputs = vtkTableBasedClipperClipTables::NumClipShapesQua[ caseIndx ];
+              edgeVtxs = ( EDGEIDXS * )
+                         vtkTableBasedClipperTriangulationTables::QuadVerticesFromEdges;
+              break;
+
+            case VTK_PIXEL:
+              startIdx = vtkTableBasedClipperClipTables::StartClipShapesPix[ caseIndx ];
+              thisCase =&vtkTableBasedClipperClipTables::ClipShapesPix[ startIdx ];
+              nOutputs = vtkTableBasedClipperClipTables::NumClipShapesPix[ caseIndx ];
+              edgeVtxs = ( EDGEIDXS * )
+                         vtkTableBasedClipperTriangulationTables::PixelVerticesFromEdges;
+              break;
+
+            case VTK_LINE:
+              startIdx = vtkTableBasedClipperClipTables::StartClipShapesLin[ caseIndx ];
+              thisCase =&vtkTableBasedClipperClipTables::ClipShapesLin[ startIdx ];
+              nOutputs = vtkTableBasedClipperClipTables::NumClipShapesLin[ caseIndx ];
+              edgeVtxs = ( EDGEIDXS * )
+                         vtkTableBasedClipperTriangulationTables::LineVerticesFromEdges;
+              break;
+
+            case VTK_VERTEX:
+              startIdx = vtkTableBasedClipperClipTables::StartClipShapesVtx[ caseIndx ];
+              thisCase =&vtkTableBasedClipperClipTables::ClipShapesVtx[ startIdx ];
+              nOutputs = vtkTableBasedClipperClipTables::NumClipShapesVtx[ caseIndx ];
+              edgeVtxs = NULL;
+              break;
+            }
+
+          int   intrpIds[4];
+          for ( j = 0; j < nOutputs; j ++ )
+            {
+            int      nCellPts = 0;
+            int      theColor = -1;
+            int      intrpIdx = -1;
+            unsigned char theShape = *thisCase ++;
+
+            // number of points and color
+            switch ( theShape )
+              {
+              case ST_HEX:
+                nCellPts = 8;
+                theColor = *thisCase ++;
+                break;
+
+              case ST_WDG:
+                nCellPts = 6;
+                theColor = *thisCase ++;
+                break;
+
+              case ST_PYR:
+                nCellPts = 5;
+                theColor = *thisCase ++;
+                break;
+
+              case ST_TET:
+                nCellPts = 4;
+                theColor = *thisCase ++;
+                break;
+
+              case ST_QUA:
+                nCellPts = 4;
+                theColor = *thisCase ++;
+                break;
+
+              case ST_TRI:
+                nCellPts = 3;
+                theColor = *thisCase ++;
+                break;
+
+              case ST_LIN:
+                nCellPts = 2;
+                theColor = *thisCase ++;
+                break;
+
+              case ST_VTX:
+                nCellPts = 1;
+                theColor = *thisCase ++;
+                break;
+
+              case ST_PNT:
+                intrpIdx = *thisCase ++;
+                theColor = *thisCase ++;
+                nCellPts = *thisCase ++;
+                break;
+
+              default:
+                vtkErrorWithObjectMacro( this->Self, << "An invalid output shape was found "
+                               << "in the ClipCases." << endl );
+              }
+
+            if ( (!this->InsideOut && theColor == COLOR0 ) ||
+                 ( this->InsideOut && theColor == COLOR1 )
+               )
+              {
+              // We don't want this one; it's the wrong side.
+              thisCase += nCellPts;
+              continue;
+              }
+
+            int   shapeIds[8];
+            for ( int p = 0; p < nCellPts; p ++ )
+              {
+              unsigned char pntIndex = *thisCase ++;
+
+              if ( pntIndex <= P7 )
+                {
+                // We know pt P0 must be >P0 since we already
+                // assume P0 == 0.  This is why we do not
+                // bother subtracting P0 from pt here.
+                shapeIds[p] = pntIndxs[ pntIndex ];
+                }
+              else
+              if ( pntIndex >= EA && pntIndex <= EL )
+                {
+                int  pt1Index = edgeVtxs[ pntIndex-EA ][0];
+                int  pt2Index = edgeVtxs[ pntIndex-EA ][1];
+                if ( pt2Index < pt1Index )
+                  {
+                  int temp = pt2Index;
+                  pt2Index = pt1Index;
+                  pt1Index = temp;
+                  }
+                double pt1ToPt2 = grdDiffs[ pt2Index ] - grdDiffs[ pt1Index ];
+                double pt1ToIso = 0.0 - grdDiffs[ pt1Index ];
+                double p1Weight = 1.0 - pt1ToIso / pt1ToPt2;
+
+                int    pntIndx1 = pntIndxs[ pt1Index ];
+                int    pntIndx2 = pntIndxs[ pt2Index ];
+
+                shapeIds[p] = visItVFV->AddPoint( pntIndx1, pntIndx2, p1Weight );
+                }
+              else
+              if ( pntIndex >= N0 && pntIndex <= N3 )
+                {
+                shapeIds[p] = intrpIds[ pntIndex - N0 ];
+                }
+              else
+                {
+                vtkErrorWithObjectMacro( this->Self, << "An invalid output point value was found "
+                               << "in the ClipCases." << endl );
+                }
+              }
+
+            switch ( theShape )
+              {
+              case ST_HEX:
+                visItVFV->AddHex( i, shapeIds[0], shapeIds[1],
+                                     shapeIds[2], shapeIds[3], shapeIds[4],
+                                     shapeIds[5], shapeIds[6], shapeIds[7] );
+                break;
+
+              case ST_WDG:
+                visItVFV->AddWedge( i, shapeIds[0], shapeIds[1], shapeIds[2],
+                                       shapeIds[3], shapeIds[4], shapeIds[5] );
+                break;
+
+              case ST_PYR:
+                visItVFV->AddPyramid( i, shapeIds[0], shapeIds[1],
+                                         shapeIds[2], shapeIds[3], shapeIds[4] );
+                break;
+
+              case ST_TET:
+                visItVFV->AddTet( i, shapeIds[0], shapeIds[1],
+                                     shapeIds[2], shapeIds[3] );
+                break;
+
+              case ST_QUA:
+                visItVFV->AddQuad( i, shapeIds[0], shapeIds[1],
+                                      shapeIds[2], shapeIds[3] );
+                break;
+
+              case ST_TRI:
+                visItVFV->AddTri( i, shapeIds[0], shapeIds[1], shapeIds[2] );
+                break;
+
+              case ST_LIN:
+                visItVFV->AddLine( i, shapeIds[0], shapeIds[1] );
+                break;
+
+              case ST_VTX:
+                visItVFV->AddVertex( i, shapeIds[0] );
+                break;
+
+              case ST_PNT:
+                intrpIds[ intrpIdx ] = visItVFV->AddCentroidPoint
+                                                 ( nCellPts, shapeIds );
+                break;
+              }
+            }
+
+          edgeVtxs = NULL;
+          thisCase = NULL;
+          }
+        else
+          {
+          this->Specials[ block ].push_back( i );
+          }
+
+        pntIndxs = NULL;
+        }
+      }
+  }
+};
+
+
+// Clip the hexahedra (quadrilaterals in 2D) of a vtkRectilinearGrid or a
+// vtkStructuredGrid.
+struct vtkTableBasedClipperClipStructuredCells :
+       public vtkTableBasedClipperCellBlocks
+{
+  int      IsTwoDim;
+  int      CellDims[3];
+  int      CyStride;
+  int      CzStride;
+  int      PyStride;
+  int      PzStride;
+  const int * ShiftLUT[3];
+
+  vtkTableBasedClipperClipStructuredCells( vtkTableBasedClipDataSet * self,
+                                           vtkDataSet * grid,
+                                           const int * gridDims,
+                                           vtkDataArray * clipAray,
+                                           double isoValue )
+    : vtkTableBasedClipperCellBlocks( self, clipAray, isoValue,
+                                      grid->GetNumberOfPoints(),
+                                      grid->GetNumberOfCells() )
+  {
+    static const int shiftLUTx[8] = { 0, 1, 1, 0, 0, 1, 1, 0 };
+    static const int shiftLUTy[8] = { 0, 0, 1, 1, 0, 0, 1, 1 };
+    static const int shiftLUTz[8] = { 0, 0, 0, 0, 1, 1, 1, 1 };
+
+    enum TwoDimType { XY, YZ, XZ };
+    TwoDimType twoDimType;
+    this->IsTwoDim = int( gridDims[0] <= 1 || gridDims[1] <= 1 ||
+                          gridDims[2] <= 1 );
+    if (gridDims[0] <= 1) twoDimType = YZ;
+    else if (gridDims[1] <= 1) twoDimType = XZ;
+    else twoDimType = XY;
+
+    if ( this->IsTwoDim && twoDimType == XZ )
+      {
+      this->ShiftLUT[0] = shiftLUTx;
+      this->ShiftLUT[1] = shiftLUTz;
+      this->ShiftLUT[2] = shiftLUTy;
+      }
+    else if ( this->IsTwoDim && twoDimType == YZ )
+      {
+      this->ShiftLUT[0] = shiftLUTy;
+      this->ShiftLUT[1] = shiftLUTz;
+      this->ShiftLUT[2] = shiftLUTx;
+      }
+    else
+      {
+      this->ShiftLUT[0] = shiftLUTx;
+      this->ShiftLUT[1] = shiftLUTy;
+      this->ShiftLUT[2] = shiftLUTz;
+      }
+
+    for ( int i = 0; i < 3; i ++ )
+      {
+      this->CellDims[i] = gridDims[i] - 1;
+      }
+    this->CyStride = ( this->CellDims[0] ? this->CellDims[0] : 1 );
+    this->CzStride = ( this->CellDims[0] ? this->CellDims[0] : 1 ) *
+                     ( this->CellDims[1] ? this->CellDims[1] : 1 );
+    this->PyStride = gridDims[0];
+    this->PzStride = gridDims[0] * gridDims[1];
+  }
+
+  void operator () ( vtkIdType block, vtkIdType endBlock )
+  {
+    for ( ; block < endBlock; block ++ )
+      {
+      vtkIdType   i, endCell;
+      int         j;
+      vtkTableBasedClipperVolumeFromVolume * visItVFV =
+        this->NewBucket( block, i, endCell );
+
+      for ( ; i < endCell; i ++ )
+        {
+        int    caseIndx = 0;
+        int    nCellPts = this->IsTwoDim ? 4 : 8;
+        int    theCellI = (this->CellDims[0] > 0 ? i % this->CellDims[0] : 0);
+        int    theCellJ = (this->CellDims[1] > 0 ? ( i / this->CyStride ) % this->CellDims[1] : 0);
+        int    theCellK = (this->CellDims[2] > 0 ? ( i / this->CzStride ) : 0);
+        double grdDiffs[8];
+
+        for ( j = nCellPts - 1; j >= 0; j -- )
+          {
+          grdDiffs[j] = this->ClipArray->GetComponent
+                                  (  ( theCellK + this->ShiftLUT[2][j] ) * this->PzStride +
+                                     ( theCellJ + this->ShiftLUT[1][j] ) * this->PyStride +
+                                     ( theCellI + this->ShiftLUT[0][j] ),  0
+                                  ) - this->IsoValue;
+          caseIndx   += (  ( grdDiffs[j] >= 0.0 ) ? 1 : 0  );
+          caseIndx  <<= (  1 - ( !j )  );
+          }
+
+        int             nOutputs;
+        int             intrpIds[4];
+        unsigned char * thisCase = NULL;
+
+        if ( this->IsTwoDim )
+          {
+          thisCase = &vtkTableBasedClipperClipTables::ClipShapesQua
+                   [  vtkTableBasedClipperClipTables::StartClipShapesQua[ caseIndx ]  ];
+          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesQua[ caseIndx ];
+          }
+        else
+          {
+          thisCase = &vtkTableBasedClipperClipTables::ClipShapesHex
+                   [  vtkTableBasedClipperClipTables::StartClipShapesHex[ caseIndx ]  ];
+          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesHex[ caseIndx ];
+          }
+
+        for ( j = 0; j < nOutputs; j++ )
+          {
+          int      intrpIdx = -1;
+          int      theColor = -1;
+          unsigned char theShape = *thisCase ++;
+
+          nCellPts = 0;
+          switch ( theShape )
+            {
+            case ST_HEX:
+              nCellPts = 8;
+              theColor = *thisCase ++;
+              break;
+
+            case ST_WDG:
+              nCellPts = 6;
+              theColor = *thisCase ++;
+              break;
+
+            case ST_PYR:
+              nCellPts = 5;
+              theColor = *thisCase ++;
+              break;
+
+            case ST_TET:
+              nCellPts = 4;
+              theColor = *thisCase ++;
+              break;
+
+            case ST_QUA:
+              nCellPts = 4;
+              theColor = *thisCase ++;
+              break;
+
+            case ST_TRI:
+              nCellPts = 3;
+              theColor = *thisCase ++;
+              break;
+
+            case ST_LIN:
+              nCellPts = 2;
+              theColor = *thisCase ++;
+              break;
+
+            case ST_VTX:
+              nCellPts = 1;
+              theColor = *thisCase ++;
+              break;
+
+            case ST_PNT:
+              intrpIdx = *thisCase ++;
+              theColor = *thisCase ++;
+              nCellPts = *thisCase ++;
+              break;
+
+            default:
+              vtkErrorWithObjectMacro( this->Self, << "An invalid output shape was found in "
+                             << "the ClipCases." << endl );
+            }
+
+          if ( (!this->InsideOut && theColor == COLOR0 ) ||
+               ( this->InsideOut && theColor == COLOR1 )
+             )
+            {
+            // We don't want this one; it's the wrong side.
+            thisCase += nCellPts;
+            continue;
+            }
+
+          int   shapeIds[8];
+          for ( int p = 0; p < nCellPts; p ++ )
+            {
+            unsigned char pntIndex = *thisCase ++;
+
+            if ( pntIndex <= P7 )
+              {
+              // We know pt P0 must be >P0 since we already
+              // assume P0 == 0.  This is why we do not
+              // bother subtracting P0 from pt here.
+              shapeIds[p] =
+                          (   (  theCellI + this->ShiftLUT[0][ pntIndex ]  ) +
+                              (  theCellJ + this->ShiftLUT[1][ pntIndex ]  ) * this->PyStride +
+                              (  theCellK + this->ShiftLUT[2][ pntIndex ]  ) * this->PzStride
+                          );
+              }
+            else
+            if ( pntIndex >= EA && pntIndex <= EL )
+              {
+              int pt1Index = vtkTableBasedClipperTriangulationTables::
+                             HexVerticesFromEdges[ pntIndex - EA ][0];
+              int pt2Index = vtkTableBasedClipperTriangulationTables::
+                             HexVerticesFromEdges[ pntIndex - EA ][1];
+
+              if ( pt2Index < pt1Index )
+                {
+                int temp = pt2Index;
+                pt2Index = pt1Index;
+                pt1Index = temp;
+                }
+
+              double pt1ToPt2 = grdDiffs[ pt2Index ] - grdDiffs[ pt1Index ];
+              double pt1ToIso = 0.0 - grdDiffs[ pt1Index ];
+              double p1Weight = 1.0 - pt1ToIso / pt1ToPt2;
+
+              int    pntIndx1 =
+                     (   (  theCellI + this->ShiftLUT[0][ pt1Index ]  ) +
+                         (  theCellJ + this->ShiftLUT[1][ pt1Index ]  ) * this->PyStride +
+                         (  theCellK + this->ShiftLUT[2][ pt1Index ]  ) * this->PzStride
+                     );
+              int    pntIndx2 =
+                     (   (  theCellI + this->ShiftLUT[0][ pt2Index ]  ) +
+                         (  theCellJ + this->ShiftLUT[1][ pt2Index ]  ) * this->PyStride +
+                         (  theCellK + this->ShiftLUT[2][ pt2Index ]  ) * this->PzStride
+                     );
+
+              /* We may have physically (though not logically) degenerate cells
+              // if p1Weight == 0 or p1Weight == 1. We could pretty easily and
+              // mostly safely clamp percent to the range [1e-4, 1 - 1e-4].
+              if( p1Weight == 1.0)
+                {
+                shapeIds[p] = pntIndx1;
+                }
+              else
+              if( p1Weight == 0.0 )
+                {
+                shapeIds[p] = pntIndx2;
+                }
+              else
+
+                {
+                shapeIds[p] = visItVFV->AddPoint( pntIndx1, pntIndx2, p1Weight );
+                }
+              */
+
+              // Turning on the above code segment, the alternative, would cause
+              // a bug with a synthetic Wavelet dataset (vtkImageData) when the
+              // the clipping plane (x/y/z axis) is positioned exactly at (0,0,0).
+              // The problem occurs in the form of an open 'box', as opposed to an
+              // expected closed one. This is due to the use of hash instead of a
+              // point-locator based detection of duplicate points.
+              shapeIds[p] = visItVFV->AddPoint( pntIndx1, pntIndx2, p1Weight );
+              }
+            else
+            if ( pntIndex >= N0 && pntIndex <= N3 )
+              {
+              shapeIds[p] = intrpIds[ pntIndex - N0 ];
+              }
+            else
+              {
+              vtkErrorWithObjectMacro( this->Self, << "An invalid output point value "
+                             << "was found in the ClipCases." << endl );
+              }
+            }
+
+          switch ( theShape )
+            {
+            case ST_HEX:
+              visItVFV->AddHex( i, shapeIds[0], shapeIds[1],
+                                   shapeIds[2], shapeIds[3], shapeIds[4],
+                                   shapeIds[5], shapeIds[6], shapeIds[7] );
+              break;
+
+            case ST_WDG:
+              visItVFV->AddWedge( i, shapeIds[0], shapeIds[1], shapeIds[2],
+                                     shapeIds[3], shapeIds[4], shapeIds[5] );
+              break;
+
+            case ST_PYR:
+              visItVFV->AddPyramid( i, shapeIds[0], shapeIds[1],
+                                       shapeIds[2], shapeIds[3], shapeIds[4] );
+              break;
+
+            case ST_TET:
+              visItVFV->AddTet( i, shapeIds[0], shapeIds[1],
+                                   shapeIds[2], shapeIds[3] );
+              break;
+
+            case ST_QUA:
+              visItVFV->AddQuad( i, shapeIds[0], shapeIds[1],
+                                    shapeIds[2], shapeIds[3] );
+              break;
+
+            case ST_TRI:
+              visItVFV->AddTri( i, shapeIds[0], shapeIds[1], shapeIds[2] );
+              break;
+
+            case ST_LIN:
+              visItVFV->AddLine( i, shapeIds[0], shapeIds[1] );
+              break;
+
+            case ST_VTX:
+              visItVFV->AddVertex( i, shapeIds[0] );
+              break;
+
+            case ST_PNT:
+              intrpIds[ intrpIdx ] = visItVFV->AddCentroidPoint
+                                               ( nCellPts, shapeIds );
+              break;
+            }
+          }
+
+        thisCase = NULL;
+        }
+      }
+  }
+};
+// ============================================================================
+// ================= vtkTableBasedClipperCellBlocks ( end ) ===================
+// ============================================================================
+
+
+//-----------------------------------------------------------------------------
+// Construct with user-specified implicit function; InsideOut turned off; value
+// set to 0.0; and generate clip scalars turned off.
+vtkTableBasedClipDataSet::vtkTableBasedClipDataSet( vtkImplicitFunction * cf )
+{
+  this->Locator      = NULL;
+  this->ClipFunction = cf;
+
+  // setup a callback to report progress
+  this->InternalProgressObserver = vtkCallbackCommand::New();
+  this->InternalProgressObserver->SetCallback
+        ( &vtkTableBasedClipDataSet::InternalProgressCallbackFunction );
+  this->InternalProgressObserver->SetClientData( this );
+
+  this->Value     = 0.0;
+  this->InsideOut = 0;
+  this->MergeTolerance        = 0.01;
+  this->UseValueAsOffset      = true;
+  this->GenerateClipScalars   = 0;
+  this->GenerateClippedOutput = 0;
+
+  this->OutputPointsPrecision = DEFAULT_PRECISION;
+
+  this->SetNumberOfOutputPorts( 2 );
+  vtkUnstructuredGrid * output2 = vtkUnstructuredGrid::New();
+  this->GetExecutive()->SetOutputData( 1, output2 );
+  output2->Delete();
+  output2 = NULL;
 
   // process active point scalars by default
   this->SetInputArrayToProcess
@@ -1810,10 +2883,19 @@ int vtkTableBasedClipDataSet::RequestData( vtkInformation * vtkNotUsed( request
       cpyInput->GetPointData()->SetScalars( pScalars );
       }
 
-    for ( i = 0; i < numbPnts; i ++ )
+    vtkPointSet * pointSet = vtkPointSet::SafeDownCast( cpyInput );
+    if ( pointSet && pointSet->GetPoints() )
       {
-      double s = this->ClipFunction->FunctionValue(  cpyInput->GetPoint( i )  );
-      pScalars->SetTuple1( i, s );
+      this->ClipFunction->FunctionValue
+        (  pointSet->GetPoints()->GetData(), pScalars  );
+      }
+    else
+      {
+      for ( i = 0; i < numbPnts; i ++ )
+        {
+        double s = this->ClipFunction->FunctionValue(  cpyInput->GetPoint( i )  );
+        pScalars->SetTuple1( i, s );
+        }
       }
 
     clipAray = pScalars;
@@ -2012,303 +3094,47 @@ void vtkTableBasedClipDataSet::ClipPolyData( vtkDataSet * inputGrd,
   vtkPolyData * polyData = vtkPolyData::SafeDownCast( inputGrd );
   int           numCells = polyData->GetNumberOfCells();
 
-  vtkTableBasedClipperVolumeFromVolume   * visItVFV = new
-  vtkTableBasedClipperVolumeFromVolume(
-     this->OutputPointsPrecision, polyData->GetNumberOfPoints(),
-     int(   pow(  double( numCells ),  double( 0.6667f )  )   ) * 5 + 100    );
+  // build the cells now, rather than from the threads
+  if ( numCells > 0 )
+    {
+    polyData->GetCellType( 0 );
+    }
+
+  vtkTableBasedClipperClipCells < vtkPolyData > clipper
+    ( this, polyData, clipAray, isoValue );
+  vtkTableBasedClipperClipBlocks( clipper );
 
   vtkUnstructuredGrid * specials = vtkUnstructuredGrid::New();
   specials->SetPoints( polyData->GetPoints() );
   specials->GetPointData()->ShallowCopy( polyData->GetPointData() );
   specials->Allocate( numCells );
 
-  vtkIdType   i, j;
+  vtkIdType   i, k;
   vtkIdType   numbPnts = 0;
   int         numCants = 0;  // number of cells not clipped by this filter
 
-  for ( i = 0; i < numCells; i ++ )
+  for ( k = 0; k < clipper.GetNumberOfBlocks(); k ++ )
     {
-    int         cellType = polyData->GetCellType( i );
-    bool        bCanClip = false;
-    vtkIdType * pntIndxs = NULL;
-    polyData->GetCellPoints( i, numbPnts, pntIndxs );
-
-    switch ( cellType )
-      {
-      case VTK_TETRA:
-      case VTK_PYRAMID:
-      case VTK_WEDGE:
-      case VTK_HEXAHEDRON:
-      case VTK_TRIANGLE:
-      case VTK_QUAD:
-      case VTK_LINE:
-      case VTK_VERTEX:
-           bCanClip = true;
-           break;
-
-      default:
-           bCanClip = false;
-           break;
-      }
-
-    if ( bCanClip )
+    for ( size_t s = 0; s < clipper.Specials[k].size(); s ++ )
       {
-      double    grdDiffs[8];
-      int       caseIndx = 0;
-
-      for ( j = numbPnts - 1; j >= 0; j -- )
-        {
-        grdDiffs[j] = clipAray->GetComponent( pntIndxs[j], 0 ) - isoValue;
-        caseIndx   += (  ( grdDiffs[j] >= 0.0 ) ? 1 : 0  );
-        caseIndx  <<= (  1 - ( !j )  );
-        }
-
-      int             startIdx = 0;
-      int             nOutputs = 0;
-      typedef int     EDGEIDXS[2];
-      EDGEIDXS      * edgeVtxs = NULL;
-      unsigned char * thisCase = NULL;
+      i = clipper.Specials[k][s];
+      vtkIdType * pntIndxs = NULL;
+      polyData->GetCellPoints( i, numbPnts, pntIndxs );
 
-      switch ( cellType )
-        {
-        case VTK_TETRA:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesTet[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesTet[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesTet[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::TetVerticesFromEdges;
-          break;
-
-        case VTK_PYRAMID:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesPyr[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesPyr[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesPyr[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::PyramidVerticesFromEdges;
-          break;
-
-        case VTK_WEDGE:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesWdg[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesWdg[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesWdg[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::WedgeVerticesFromEdges;
-          break;
-
-        case VTK_HEXAHEDRON:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesHex[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesHex[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesHex[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::HexVerticesFromEdges;
-          break;
-
-        case VTK_TRIANGLE:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesTri[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesTri[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesTri[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::TriVerticesFromEdges;
-          break;
-
-        case VTK_QUAD:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesQua[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesQua[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesQua[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::QuadVerticesFromEdges;
-          break;
-
-        case VTK_LINE:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesLin[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesLin[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesLin[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::LineVerticesFromEdges;
-          break;
-
-        case VTK_VERTEX:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesVtx[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesVtx[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesVtx[ caseIndx ];
-          edgeVtxs = NULL;
-          break;
-        }
-
-      int  intrpIds[4];
-      for ( j = 0; j < nOutputs; j ++ )
-        {
-        int      nCellPts = 0;
-        int      intrpIdx = -1;
-        int      theColor = -1;
-        unsigned char theShape = *thisCase ++;
-
-        switch ( theShape )
-          {
-          case ST_HEX:
-            nCellPts = 8;
-            theColor = *thisCase ++;
-            break;
-
-          case ST_WDG:
-            nCellPts = 6;
-            theColor = *thisCase ++;
-            break;
-
-          case ST_PYR:
-            nCellPts = 5;
-            theColor = *thisCase ++;
-            break;
-          case ST_TET:
-            nCellPts = 4;
-            theColor = *thisCase ++;
-            break;
-
-          case ST_QUA:
-            nCellPts = 4;
-            theColor = *thisCase ++;
-            break;
-
-          case ST_TRI:
-            nCellPts = 3;
-            theColor = *thisCase ++;
-            break;
-
-          case ST_LIN:
-            nCellPts = 2;
-            theColor = *thisCase ++;
-            break;
-
-          case ST_VTX:
-            nCellPts = 1;
-            theColor = *thisCase ++;
-            break;
-
-          case ST_PNT:
-            intrpIdx = *thisCase ++;
-            theColor = *thisCase ++;
-            nCellPts = *thisCase ++;
-            break;
-
-          default:
-            vtkErrorMacro( << "An invalid output shape was found in "
-                           << "the ClipCases." << endl );
-          }
-
-        if ( (!this->InsideOut && theColor == COLOR0 ) ||
-             ( this->InsideOut && theColor == COLOR1 )
-           )
-          {
-          // We don't want this one; it's the wrong side.
-          thisCase += nCellPts;
-          continue;
-          }
-
-        int   shapeIds[8];
-        for ( int p = 0; p < nCellPts; p ++ )
-          {
-          unsigned char pntIndex = *thisCase ++;
-
-          if ( pntIndex <= P7 )
-            {
-            shapeIds[p] = pntIndxs[ pntIndex ];
-            }
-          else
-          if ( pntIndex >= EA && pntIndex <= EL )
-            {
-            int pt1Index = edgeVtxs[ pntIndex - EA ][0];
-            int pt2Index = edgeVtxs[ pntIndex - EA ][1];
-            if ( pt2Index < pt1Index )
-              {
-              int temp = pt2Index;
-              pt2Index = pt1Index;
-              pt1Index = temp;
-              }
-            double pt1ToPt2 = grdDiffs[ pt2Index ] - grdDiffs[ pt1Index ];
-            double pt1ToIso = 0.0 - grdDiffs[ pt1Index ];
-            double p1Weight = 1.0 - pt1ToIso / pt1ToPt2;
-
-            int    pntIndx1 = pntIndxs[ pt1Index ];
-            int    pntIndx2 = pntIndxs[ pt2Index ];
-
-            shapeIds[p] = visItVFV->AddPoint( pntIndx1, pntIndx2, p1Weight );
-            }
-          else
-          if ( pntIndex >= N0 && pntIndex <= N3 )
-            {
-            shapeIds[p] = intrpIds[ pntIndex - N0 ];
-            }
-          else
-            {
-            vtkErrorMacro( << "An invalid output point value "
-                           << "was found in the ClipCases." << endl );
-            }
-          }
-
-        switch ( theShape )
-          {
-          case ST_HEX:
-            visItVFV->AddHex( i, shapeIds[0], shapeIds[1],
-                                 shapeIds[2], shapeIds[3], shapeIds[4],
-                                 shapeIds[5], shapeIds[6], shapeIds[7] );
-            break;
-
-          case ST_WDG:
-            visItVFV->AddWedge( i, shapeIds[0], shapeIds[1], shapeIds[2],
-                                   shapeIds[3], shapeIds[4], shapeIds[5] );
-            break;
-
-          case ST_PYR:
-            visItVFV->AddPyramid( i, shapeIds[0], shapeIds[1],
-                                     shapeIds[2], shapeIds[3], shapeIds[4] );
-            break;
-
-          case ST_TET:
-            visItVFV->AddTet( i, shapeIds[0], shapeIds[1],
-                                 shapeIds[2], shapeIds[3] );
-            break;
-
-          case ST_QUA:
-            visItVFV->AddQuad( i, shapeIds[0], shapeIds[1],
-                                  shapeIds[2], shapeIds[3] );
-            break;
-
-          case ST_TRI:
-            visItVFV->AddTri( i, shapeIds[0], shapeIds[1], shapeIds[2] );
-            break;
-
-          case ST_LIN:
-            visItVFV->AddLine( i, shapeIds[0], shapeIds[1] );
-            break;
-
-          case ST_VTX:
-            visItVFV->AddVertex( i, shapeIds[0] );
-            break;
-
-          case ST_PNT:
-            intrpIds[intrpIdx] = visItVFV->AddCentroidPoint( nCellPts, shapeIds );
-            break;
-          }
-        }
-
-      edgeVtxs = NULL;
-      thisCase = NULL;
-      }
-    else
-      {
       if ( numCants == 0 )
         {
         specials->GetCellData()
                 ->CopyAllocate( polyData->GetCellData(), numCells );
         }
 
-      specials->InsertNextCell( cellType, numbPnts, pntIndxs );
+      specials->InsertNextCell( polyData->GetCellType( i ), numbPnts,
+                                pntIndxs );
       specials->GetCellData()
               ->CopyData( polyData->GetCellData(), i, numCants );
       numCants ++;
-      }
 
-    pntIndxs = NULL;
+      pntIndxs = NULL;
+      }
     }
 
 
@@ -2338,7 +3164,7 @@ void vtkTableBasedClipDataSet::ClipPolyData( vtkDataSet * inputGrd,
     this->ClipDataSet( specials, clipAray, vtkUGrid );
 
     vtkUnstructuredGrid * visItGrd = vtkUnstructuredGrid::New();
-    visItVFV->ConstructDataSet( polyData, visItGrd, theCords );
+    clipper.ConstructDataSet( polyData, visItGrd, theCords );
 
     vtkAppendFilter * appender = vtkAppendFilter::New();
     appender->AddInputData( vtkUGrid );
@@ -2356,18 +3182,16 @@ void vtkTableBasedClipDataSet::ClipPolyData( vtkDataSet * inputGrd,
     }
   else
     {
-    visItVFV->ConstructDataSet( polyData, outputUG, theCords );
+    clipper.ConstructDataSet( polyData, outputUG, theCords );
     }
 
 
   specials->Delete();
-  delete visItVFV;
   if ( toDelete )
     {
     delete [] theCords;
     }
   specials = NULL;
-  visItVFV = NULL;
   theCords = NULL;
   polyData = NULL;
 }
@@ -2379,293 +3203,12 @@ void vtkTableBasedClipDataSet::ClipRectilinearGridData( vtkDataSet * inputGrd,
   vtkRectilinearGrid * rectGrid = vtkRectilinearGrid::SafeDownCast( inputGrd );
 
   int   i, j;
-  int   numCells = 0;
-  int   isTwoDim = 0;
-  enum TwoDimType { XY, YZ, XZ };
-  TwoDimType twoDimType;
   int   rectDims[3];
   rectGrid->GetDimensions( rectDims );
-  isTwoDim = int( rectDims[0] <= 1 || rectDims[1] <= 1 || rectDims[2] <= 1 );
-  if (rectDims[0] <= 1) twoDimType = YZ;
-  else if (rectDims[1] <= 1) twoDimType = XZ;
-  else twoDimType = XY;
-  numCells = rectGrid->GetNumberOfCells();
-
-  vtkTableBasedClipperVolumeFromVolume   * visItVFV = new
-  vtkTableBasedClipperVolumeFromVolume(
-      this->OutputPointsPrecision, rectGrid->GetNumberOfPoints(),
-      int(   pow(  double( numCells ), double( 0.6667f )  )   ) * 5 + 100    );
-
-  int shiftLUTx[8] = { 0, 1, 1, 0, 0, 1, 1, 0 };
-  int shiftLUTy[8] = { 0, 0, 1, 1, 0, 0, 1, 1 };
-  int shiftLUTz[8] = { 0, 0, 0, 0, 1, 1, 1, 1 };
-
-  int* shiftLUT[3];
-  if (isTwoDim && twoDimType == XZ)
-    {
-    shiftLUT[0] = shiftLUTx;
-    shiftLUT[1] = shiftLUTz;
-    shiftLUT[2] = shiftLUTy;
-    }
-  else if (isTwoDim && twoDimType == YZ)
-    {
-    shiftLUT[0] = shiftLUTy;
-    shiftLUT[1] = shiftLUTz;
-    shiftLUT[2] = shiftLUTx;
-    }
-  else
-    {
-    shiftLUT[0] = shiftLUTx;
-    shiftLUT[1] = shiftLUTy;
-    shiftLUT[2] = shiftLUTz;
-    }
-
-  int   cellDims[3] = { rectDims[0] - 1, rectDims[1] - 1, rectDims[2] - 1 };
-  int   cyStride    = (cellDims[0] ? cellDims[0] : 1);
-  int   czStride    = (cellDims[0] ? cellDims[0] : 1) * (cellDims[1] ? cellDims[1] : 1);
-  int   pyStride    = rectDims[0];
-  int   pzStride    = rectDims[0] * rectDims[1];
-
-  for ( i = 0; i < numCells; i ++ )
-    {
-    int    caseIndx = 0;
-    int    nCellPts = isTwoDim ? 4 : 8;
-    int    theCellI = (cellDims[0] > 0 ? i % cellDims[0] : 0);
-    int    theCellJ = (cellDims[1] > 0 ? ( i / cyStride ) % cellDims[1] : 0);
-    int    theCellK = (cellDims[2] > 0 ? ( i / czStride ) : 0);
-    double grdDiffs[8];
-
-    for ( j = nCellPts - 1; j >= 0; j -- )
-      {
-      grdDiffs[j] = clipAray->GetComponent
-                              (  ( theCellK + shiftLUT[2][j] ) * pzStride +
-                                 ( theCellJ + shiftLUT[1][j] ) * pyStride +
-                                 ( theCellI + shiftLUT[0][j] ),  0
-                              ) - isoValue;
-      caseIndx   += (  ( grdDiffs[j] >= 0.0 ) ? 1 : 0  );
-      caseIndx  <<= (  1 - ( !j )  );
-      }
 
-    int             nOutputs;
-    int             intrpIds[4];
-    unsigned char * thisCase = NULL;
-
-    if ( isTwoDim )
-      {
-      thisCase = &vtkTableBasedClipperClipTables::ClipShapesQua
-               [  vtkTableBasedClipperClipTables::StartClipShapesQua[ caseIndx ]  ];
-      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesQua[ caseIndx ];
-      }
-    else
-      {
-      thisCase = &vtkTableBasedClipperClipTables::ClipShapesHex
-               [  vtkTableBasedClipperClipTables::StartClipShapesHex[ caseIndx ]  ];
-      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesHex[ caseIndx ];
-      }
-
-    for ( j = 0; j < nOutputs; j++ )
-      {
-      int      intrpIdx = -1;
-      int      theColor = -1;
-      unsigned char theShape = *thisCase ++;
-
-      nCellPts = 0;
-      switch ( theShape )
-        {
-        case ST_HEX:
-          nCellPts = 8;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_WDG:
-          nCellPts = 6;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_PYR:
-          nCellPts = 5;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_TET:
-          nCellPts = 4;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_QUA:
-          nCellPts = 4;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_TRI:
-          nCellPts = 3;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_LIN:
-          nCellPts = 2;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_VTX:
-          nCellPts = 1;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_PNT:
-          intrpIdx = *thisCase ++;
-          theColor = *thisCase ++;
-          nCellPts = *thisCase ++;
-          break;
-
-        default:
-          vtkErrorMacro( << "An invalid output shape was found in "
-                         << "the ClipCases." << endl );
-        }
-
-      if ( (!this->InsideOut && theColor == COLOR0 ) ||
-           ( this->InsideOut && theColor == COLOR1 )
-         )
-        {
-        // We don't want this one; it's the wrong side.
-        thisCase += nCellPts;
-        continue;
-        }
-
-      int   shapeIds[8];
-      for ( int p = 0; p < nCellPts; p ++ )
-        {
-        unsigned char pntIndex = *thisCase ++;
-
-        if ( pntIndex <= P7 )
-          {
-          // We know pt P0 must be >P0 since we already
-          // assume P0 == 0.  This is why we do not
-          // bother subtracting P0 from pt here.
-          shapeIds[p] =
-                      (   (  theCellI + shiftLUT[0][ pntIndex ]  ) +
-                          (  theCellJ + shiftLUT[1][ pntIndex ]  ) * pyStride +
-                          (  theCellK + shiftLUT[2][ pntIndex ]  ) * pzStride
-                      );
-          }
-        else
-        if ( pntIndex >= EA && pntIndex <= EL )
-          {
-          int pt1Index = vtkTableBasedClipperTriangulationTables::
-                         HexVerticesFromEdges[ pntIndex - EA ][0];
-          int pt2Index = vtkTableBasedClipperTriangulationTables::
-                         HexVerticesFromEdges[ pntIndex - EA ][1];
-
-          if ( pt2Index < pt1Index )
-            {
-            int temp = pt2Index;
-            pt2Index = pt1Index;
-            pt1Index = temp;
-            }
-
-          double pt1ToPt2 = grdDiffs[ pt2Index ] - grdDiffs[ pt1Index ];
-          double pt1ToIso = 0.0 - grdDiffs[ pt1Index ];
-          double p1Weight = 1.0 - pt1ToIso / pt1ToPt2;
-
-          int    pntIndx1 =
-                 (   (  theCellI + shiftLUT[0][ pt1Index ]  ) +
-                     (  theCellJ + shiftLUT[1][ pt1Index ]  ) * pyStride +
-                     (  theCellK + shiftLUT[2][ pt1Index ]  ) * pzStride
-                 );
-          int    pntIndx2 =
-                 (   (  theCellI + shiftLUT[0][ pt2Index ]  ) +
-                     (  theCellJ + shiftLUT[1][ pt2Index ]  ) * pyStride +
-                     (  theCellK + shiftLUT[2][ pt2Index ]  ) * pzStride
-                 );
-
-          /* We may have physically (though not logically) degenerate cells
-          // if p1Weight == 0 or p1Weight == 1. We could pretty easily and
-          // mostly safely clamp percent to the range [1e-4, 1 - 1e-4].
-          if( p1Weight == 1.0)
-            {
-            shapeIds[p] = pntIndx1;
-            }
-          else
-          if( p1Weight == 0.0 )
-            {
-            shapeIds[p] = pntIndx2;
-            }
-          else
-
-            {
-            shapeIds[p] = visItVFV->AddPoint( pntIndx1, pntIndx2, p1Weight );
-            }
-          */
-
-          // Turning on the above code segment, the alternative, would cause
-          // a bug with a synthetic Wavelet dataset (vtkImageData) when the
-          // the clipping plane (x/y/z axis) is positioned exactly at (0,0,0).
-          // The problem occurs in the form of an open 'box', as opposed to an
-          // expected closed one. This is due to the use of hash instead of a
-          // point-locator based detection of duplicate points.
-          shapeIds[p] = visItVFV->AddPoint( pntIndx1, pntIndx2, p1Weight );
-          }
-        else
-        if ( pntIndex >= N0 && pntIndex <= N3 )
-          {
-          shapeIds[p] = intrpIds[ pntIndex - N0 ];
-          }
-        else
-          {
-          vtkErrorMacro( << "An invalid output point value "
-                         << "was found in the ClipCases." << endl );
-          }
-        }
-
-      switch ( theShape )
-        {
-        case ST_HEX:
-          visItVFV->AddHex( i, shapeIds[0], shapeIds[1],
-                               shapeIds[2], shapeIds[3], shapeIds[4],
-                               shapeIds[5], shapeIds[6], shapeIds[7] );
-          break;
-
-        case ST_WDG:
-          visItVFV->AddWedge( i, shapeIds[0], shapeIds[1], shapeIds[2],
-                                 shapeIds[3], shapeIds[4], shapeIds[5] );
-          break;
-
-        case ST_PYR:
-          visItVFV->AddPyramid( i, shapeIds[0], shapeIds[1],
-                                   shapeIds[2], shapeIds[3], shapeIds[4] );
-          break;
-
-        case ST_TET:
-          visItVFV->AddTet( i, shapeIds[0], shapeIds[1],
-                               shapeIds[2], shapeIds[3] );
-          break;
-
-        case ST_QUA:
-          visItVFV->AddQuad( i, shapeIds[0], shapeIds[1],
-                                shapeIds[2], shapeIds[3] );
-          break;
-
-        case ST_TRI:
-          visItVFV->AddTri( i, shapeIds[0], shapeIds[1], shapeIds[2] );
-          break;
-
-        case ST_LIN:
-          visItVFV->AddLine( i, shapeIds[0], shapeIds[1] );
-          break;
-
-        case ST_VTX:
-          visItVFV->AddVertex( i, shapeIds[0] );
-          break;
-
-        case ST_PNT:
-          intrpIds[ intrpIdx ] = visItVFV->AddCentroidPoint
-                                           ( nCellPts, shapeIds );
-          break;
-        }
-      }
-
-    thisCase = NULL;
-    }
+  vtkTableBasedClipperClipStructuredCells clipper
+    ( this, rectGrid, rectDims, clipAray, isoValue );
+  vtkTableBasedClipperClipBlocks( clipper );
 
 
   int            toDelete    = 0;
@@ -2701,12 +3244,10 @@ void vtkTableBasedClipDataSet::ClipRectilinearGridData( vtkDataSet * inputGrd,
       }
     }
 
-  visItVFV->ConstructDataSet
-            ( rectGrid,
-              outputUG, rectDims, theCords[0], theCords[1], theCords[2] );
+  clipper.ConstructDataSet
+           ( rectGrid,
+             outputUG, rectDims, theCords[0], theCords[1], theCords[2] );
 
-  delete visItVFV;
-  visItVFV = NULL;
   rectGrid = NULL;
 
   for ( i = 0; i < 3; i ++ )
@@ -2725,271 +3266,14 @@ void vtkTableBasedClipDataSet::ClipStructuredGridData( vtkDataSet * inputGrd,
 {
   vtkStructuredGrid * strcGrid = vtkStructuredGrid::SafeDownCast( inputGrd );
 
-  int   i, j;
-  int   isTwoDim    = 0;
-  enum TwoDimType { XY, YZ, XZ };
-  TwoDimType twoDimType;
-  int   numCells    = 0;
+  int   i;
+  int   numbPnts    = 0;
   int   gridDims[3] = { 0, 0, 0 };
   strcGrid->GetDimensions( gridDims );
-  isTwoDim = int( gridDims[0] <= 1 || gridDims[1] <= 1 || gridDims[2] <= 1 );
-  if (gridDims[0] <= 1) twoDimType = YZ;
-  else if (gridDims[1] <= 1) twoDimType = XZ;
-  else twoDimType = XY;
-  numCells = strcGrid->GetNumberOfCells();
-
-  vtkTableBasedClipperVolumeFromVolume  *  visItVFV = new
-  vtkTableBasedClipperVolumeFromVolume(
-      this->OutputPointsPrecision, strcGrid->GetNumberOfPoints(),
-      int(   pow(  double( numCells ), double( 0.6667f )  )   ) * 5 + 100    );
-
-  int shiftLUTx[8] = { 0, 1, 1, 0, 0, 1, 1, 0 };
-  int shiftLUTy[8] = { 0, 0, 1, 1, 0, 0, 1, 1 };
-  int shiftLUTz[8] = { 0, 0, 0, 0, 1, 1, 1, 1 };
-
-  int* shiftLUT[3];
-  if (isTwoDim && twoDimType == XZ)
-    {
-    shiftLUT[0] = shiftLUTx;
-    shiftLUT[1] = shiftLUTz;
-    shiftLUT[2] = shiftLUTy;
-    }
-  else if (isTwoDim && twoDimType == YZ)
-    {
-    shiftLUT[0] = shiftLUTy;
-    shiftLUT[1] = shiftLUTz;
-    shiftLUT[2] = shiftLUTx;
-    }
-  else
-    {
-    shiftLUT[0] = shiftLUTx;
-    shiftLUT[1] = shiftLUTy;
-    shiftLUT[2] = shiftLUTz;
-    }
-
-  int   numbPnts    = 0;
-  int   cellDims[3] = { gridDims[0] - 1, gridDims[1] - 1, gridDims[2] - 1 };
-  int   cyStride    = (cellDims[0] ? cellDims[0] : 1);
-  int   czStride    = (cellDims[0] ? cellDims[0] : 1) * (cellDims[1] ? cellDims[1] : 1);
-  int   pyStride    = gridDims[0];
-  int   pzStride    = gridDims[0] * gridDims[1];
-
-  for ( i = 0; i < numCells; i ++ )
-    {
-    int    caseIndx = 0;
-    int    theCellI = (cellDims[0] > 0 ? i % cellDims[0] : 0);
-    int    theCellJ = (cellDims[1] > 0 ? ( i / cyStride ) % cellDims[1] : 0);
-    int    theCellK = (cellDims[2] > 0 ? ( i / czStride ) : 0);
-    double grdDiffs[8];
-
-    numbPnts = isTwoDim ? 4 : 8;
 
-    for ( j = numbPnts - 1; j >= 0; j -- )
-      {
-      int pntIndex = ( theCellI + shiftLUT[0][j] ) +
-                     ( theCellJ + shiftLUT[1][j] ) * pyStride +
-                     ( theCellK + shiftLUT[2][j] ) * pzStride;
-
-      grdDiffs[j]  = clipAray->GetComponent( pntIndex, 0 ) - isoValue;
-      caseIndx    += (  ( grdDiffs[j] >= 0.0 ) ? 1 : 0  );
-      caseIndx   <<= (  1 - ( !j )  );
-      }
-
-    int             nOutputs;
-    int             intrpIds[4];
-    unsigned char * thisCase = NULL;
-
-    if ( isTwoDim )
-      {
-      thisCase = &vtkTableBasedClipperClipTables::ClipShapesQua
-               [  vtkTableBasedClipperClipTables::StartClipShapesQua[ caseIndx ]  ];
-      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesQua[ caseIndx ];
-      }
-    else
-      {
-      thisCase = &vtkTableBasedClipperClipTables::ClipShapesHex
-               [  vtkTableBasedClipperClipTables::StartClipShapesHex[ caseIndx ]  ];
-      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesHex[ caseIndx ];
-      }
-
-    for ( j = 0; j < nOutputs; j ++ )
-      {
-      int      nCellPts = 0;
-      int      intrpIdx = -1;
-      int      theColor = -1;
-      unsigned char theShape = *thisCase ++;
-
-      switch ( theShape )
-        {
-        case ST_HEX:
-          nCellPts = 8;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_WDG:
-          nCellPts = 6;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_PYR:
-          nCellPts = 5;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_TET:
-          nCellPts = 4;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_QUA:
-          nCellPts = 4;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_TRI:
-          nCellPts = 3;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_LIN:
-          nCellPts = 2;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_VTX:
-          nCellPts = 1;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_PNT:
-          intrpIdx = *thisCase ++;
-          theColor = *thisCase ++;
-          nCellPts = *thisCase ++;
-          break;
-
-        default:
-          vtkErrorMacro( << "An invalid output shape was found in "
-                         << "the ClipCases." << endl );
-        }
-
-      if ( (!this->InsideOut && theColor == COLOR0 ) ||
-           ( this->InsideOut && theColor == COLOR1 )
-         )
-        {
-        // We don't want this one; it's the wrong side.
-        thisCase += nCellPts;
-        continue;
-        }
-
-      int   shapeIds[8];
-      for ( int p = 0; p < nCellPts; p ++ )
-        {
-        unsigned char pntIndex = *thisCase ++;
-
-        if ( pntIndex <= P7 )
-          {
-          // We know pt P0 must be >P0 since we already
-          // assume P0 == 0.  This is why we do not
-          // bother subtracting P0 from pt here.
-          shapeIds[p] =
-                      (   (  theCellI + shiftLUT[0][ pntIndex ]  ) +
-                          (  theCellJ + shiftLUT[1][ pntIndex ]  ) * pyStride +
-                          (  theCellK + shiftLUT[2][ pntIndex ]  ) * pzStride
-                      );
-          }
-        else
-        if ( pntIndex >= EA && pntIndex <= EL )
-          {
-          int  pt1Index = vtkTableBasedClipperTriangulationTables::
-                          HexVerticesFromEdges[ pntIndex - EA ][0];
-          int  pt2Index = vtkTableBasedClipperTriangulationTables::
-                          HexVerticesFromEdges[ pntIndex - EA ][1];
-
-          if ( pt2Index < pt1Index )
-            {
-            int temp = pt2Index;
-            pt2Index = pt1Index;
-            pt1Index = temp;
-            }
-
-          double pt1ToPt2 = grdDiffs[ pt2Index] - grdDiffs[ pt1Index ];
-          double pt1ToIso = 0.0 - grdDiffs[ pt1Index ];
-          double p1Weight = 1.0 - pt1ToIso / pt1ToPt2;
-
-          int    pntIndx1 =
-                 (   (  theCellI + shiftLUT[0][ pt1Index ] ) +
-                     (  theCellJ + shiftLUT[1][ pt1Index ]  ) * pyStride +
-                     (  theCellK + shiftLUT[2][ pt1Index ]  ) * pzStride
-                 );
-          int    pntIndx2 =
-                 (   (  theCellI + shiftLUT[0][ pt2Index ]  ) +
-                     (  theCellJ + shiftLUT[1][ pt2Index ]  ) * pyStride +
-                     (  theCellK + shiftLUT[2][ pt2Index ]  ) * pzStride
-                 );
-
-          shapeIds[p] = visItVFV->AddPoint( pntIndx1, pntIndx2, p1Weight );
-          }
-        else
-        if ( pntIndex >= N0 && pntIndex <= N3 )
-          {
-          shapeIds[p] = intrpIds[ pntIndex - N0 ];
-          }
-        else
-          {
-          vtkErrorMacro( << "An invalid output point value "
-                         << "was found in the ClipCases." << endl );
-          }
-        }
-
-      switch ( theShape )
-        {
-        case ST_HEX:
-          visItVFV->AddHex( i, shapeIds[0], shapeIds[1],
-                               shapeIds[2], shapeIds[3], shapeIds[4],
-                               shapeIds[5], shapeIds[6], shapeIds[7] );
-          break;
-
-        case ST_WDG:
-          visItVFV->AddWedge( i, shapeIds[0], shapeIds[1], shapeIds[2],
-                                 shapeIds[3], shapeIds[4], shapeIds[5] );
-          break;
-
-        case ST_PYR:
-          visItVFV->AddPyramid( i, shapeIds[0], shapeIds[1],
-                                   shapeIds[2], shapeIds[3], shapeIds[4] );
-          break;
-
-        case ST_TET:
-          visItVFV->AddTet( i, shapeIds[0], shapeIds[1],
-                               shapeIds[2], shapeIds[3] );
-          break;
-
-        case ST_QUA:
-          visItVFV->AddQuad( i, shapeIds[0], shapeIds[1],
-                                shapeIds[2], shapeIds[3] );
-          break;
-
-        case ST_TRI:
-          visItVFV->AddTri( i, shapeIds[0], shapeIds[1], shapeIds[2] );
-          break;
-
-        case ST_LIN:
-          visItVFV->AddLine( i, shapeIds[0], shapeIds[1] );
-          break;
-
-        case ST_VTX:
-          visItVFV->AddVertex( i, shapeIds[0] );
-          break;
-
-        case ST_PNT:
-          intrpIds[ intrpIdx ] = visItVFV->AddCentroidPoint
-                                           ( nCellPts, shapeIds );
-          break;
-        }
-      }
-
-    thisCase = NULL;
-    }
+  vtkTableBasedClipperClipStructuredCells clipper
+    ( this, strcGrid, gridDims, clipAray, isoValue );
+  vtkTableBasedClipperClipBlocks( clipper );
 
   int         toDelete = 0;
   double    * theCords = NULL;
@@ -3010,15 +3294,12 @@ void vtkTableBasedClipDataSet::ClipStructuredGridData( vtkDataSet * inputGrd,
     }
   inputPts = NULL;
 
-  visItVFV->ConstructDataSet( strcGrid, outputUG, theCords );
-
+  clipper.ConstructDataSet( strcGrid, outputUG, theCords );
 
-  delete visItVFV;
   if ( toDelete )
     {
     delete [] theCords;
     }
-  visItVFV = NULL;
   theCords = NULL;
   strcGrid = NULL;
 }
@@ -3029,16 +3310,15 @@ void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
 {
   vtkUnstructuredGrid * unstruct = vtkUnstructuredGrid::SafeDownCast( inputGrd );
 
-  vtkIdType   i, j;
+  vtkIdType   i, k;
   vtkIdType   numbPnts = 0;
   int         numCants = 0; // number of cells not clipped by this filter
   int         numCells = unstruct->GetNumberOfCells();
 
-  // volume from volume
-  vtkTableBasedClipperVolumeFromVolume   * visItVFV = new
-  vtkTableBasedClipperVolumeFromVolume(
-      this->OutputPointsPrecision, unstruct->GetNumberOfPoints(),
-      int(   pow(  double( numCells ), double( 0.6667f )  )   ) * 5 + 100    );
+  // volume from volume, block by block
+  vtkTableBasedClipperClipCells < vtkUnstructuredGrid > clipper
+    ( this, unstruct, clipAray, isoValue );
+  vtkTableBasedClipperClipBlocks( clipper );
 
   // the stuffs that can not be clipped by this filter
   vtkUnstructuredGrid * specials = vtkUnstructuredGrid::New();
@@ -3046,327 +3326,35 @@ void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
   specials->GetPointData()->ShallowCopy( unstruct->GetPointData() );
   specials->Allocate( numCells );
 
-  for ( i = 0; i < numCells; i ++ )
+  for ( k = 0; k < clipper.GetNumberOfBlocks(); k ++ )
     {
-    int         cellType = unstruct->GetCellType( i );
-    vtkIdType * pntIndxs = NULL;
-    unstruct->GetCellPoints( i, numbPnts, pntIndxs );
-
-    bool     bCanClip = false;
-    switch ( cellType )
-      {
-      case VTK_TETRA:
-      case VTK_PYRAMID:
-      case VTK_WEDGE:
-      case VTK_HEXAHEDRON:
-      case VTK_VOXEL:
-      case VTK_TRIANGLE:
-      case VTK_QUAD:
-      case VTK_PIXEL:
-      case VTK_LINE:
-      case VTK_VERTEX:
-           bCanClip = true;
-           break;
-
-      default:
-           bCanClip = false;
-           break;
-      }
-
-    if ( bCanClip )
+    for ( size_t s = 0; s < clipper.Specials[k].size(); s ++ )
       {
-      int    caseIndx = 0;
-      double grdDiffs[8];
-
-      for ( j = numbPnts-1; j >= 0; j -- )
-        {
-        grdDiffs[j] = clipAray->GetComponent( pntIndxs[j], 0 ) - isoValue;
-        caseIndx   += (  ( grdDiffs[j] >= 0.0 ) ? 1 : 0  );
-        caseIndx  <<= (  1 - ( !j )  );
-        }
-
-      int               startIdx = 0;
-      int               nOutputs = 0;
-      typedef const int EDGEIDXS[2];
-      EDGEIDXS        * edgeVtxs = NULL;
-      unsigned char   * thisCase = NULL;
-
-      // start index, split case, number of output, and vertices from edges
-      switch ( cellType )
-        {
-        case VTK_TETRA:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesTet[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesTet[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesTet[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::TetVerticesFromEdges;
-          break;
-
-        case VTK_PYRAMID:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesPyr[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesPyr[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesPyr[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::PyramidVerticesFromEdges;
-          break;
-
-        case VTK_WEDGE:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesWdg[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesWdg[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesWdg[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::WedgeVerticesFromEdges;
-          break;
-
-        case VTK_HEXAHEDRON:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesHex[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesHex[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesHex[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::HexVerticesFromEdges;
-          break;
-
-        case VTK_VOXEL:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesVox[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesVox[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesVox[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::VoxVerticesFromEdges;
-          break;
-
-        case VTK_TRIANGLE:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesTri[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesTri[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesTri[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::TriVerticesFromEdges;
-          break;
-
-        case VTK_QUAD:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesQua[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesQua[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesQua[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::QuadVerticesFromEdges;
-          break;
-
-        case VTK_PIXEL:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesPix[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesPix[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesPix[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::PixelVerticesFromEdges;
-          break;
-
-        case VTK_LINE:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesLin[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesLin[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesLin[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::LineVerticesFromEdges;
-          break;
-
-        case VTK_VERTEX:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesVtx[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesVtx[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesVtx[ caseIndx ];
-          edgeVtxs = NULL;
-          break;
-        }
+      i = clipper.Specials[k][s];
+      int cellType = unstruct->GetCellType( i );
 
-      int   intrpIds[4];
-      for ( j = 0; j < nOutputs; j ++ )
-        {
-        int      nCellPts = 0;
-        int      theColor = -1;
-        int      intrpIdx = -1;
-        unsigned char theShape = *thisCase ++;
-
-        // number of points and color
-        switch ( theShape )
-          {
-          case ST_HEX:
-            nCellPts = 8;
-            theColor = *thisCase ++;
-            break;
-
-          case ST_WDG:
-            nCellPts = 6;
-            theColor = *thisCase ++;
-            break;
-
-          case ST_PYR:
-            nCellPts = 5;
-            theColor = *thisCase ++;
-            break;
-
-          case ST_TET:
-            nCellPts = 4;
-            theColor = *thisCase ++;
-            break;
-
-          case ST_QUA:
-            nCellPts = 4;
-            theColor = *thisCase ++;
-            break;
-
-          case ST_TRI:
-            nCellPts = 3;
-            theColor = *thisCase ++;
-            break;
-
-          case ST_LIN:
-            nCellPts = 2;
-            theColor = *thisCase ++;
-            break;
-
-          case ST_VTX:
-            nCellPts = 1;
-            theColor = *thisCase ++;
-            break;
-
-          case ST_PNT:
-            intrpIdx = *thisCase ++;
-            theColor = *thisCase ++;
-            nCellPts = *thisCase ++;
-            break;
-
-          default:
-            vtkErrorMacro( << "An invalid output shape was found "
-                           << "in the ClipCases." << endl );
-          }
-
-        if ( (!this->InsideOut && theColor == COLOR0 ) ||
-             ( this->InsideOut && theColor == COLOR1 )
-           )
-          {
-          // We don't want this one; it's the wrong side.
-          thisCase += nCellPts;
-          continue;
-          }
-
-        int   shapeIds[8];
-        for ( int p = 0; p < nCellPts; p ++ )
-          {
-          unsigned char pntIndex = *thisCase ++;
-
-          if ( pntIndex <= P7 )
-            {
-            // We know pt P0 must be >P0 since we already
-            // assume P0 == 0.  This is why we do not
-            // bother subtracting P0 from pt here.
-            shapeIds[p] = pntIndxs[ pntIndex ];
-            }
-          else
-          if ( pntIndex >= EA && pntIndex <= EL )
-            {
-            int  pt1Index = edgeVtxs[ pntIndex-EA ][0];
-            int  pt2Index = edgeVtxs[ pntIndex-EA ][1];
-            if ( pt2Index < pt1Index )
-              {
-              int temp = pt2Index;
-              pt2Index = pt1Index;
-              pt1Index = temp;
-              }
-            double pt1ToPt2 = grdDiffs[ pt2Index ] - grdDiffs[ pt1Index ];
-            double pt1ToIso = 0.0 - grdDiffs[ pt1Index ];
-            double p1Weight = 1.0 - pt1ToIso / pt1ToPt2;
-
-            int    pntIndx1 = pntIndxs[ pt1Index ];
-            int    pntIndx2 = pntIndxs[ pt2Index ];
-
-            shapeIds[p] = visItVFV->AddPoint( pntIndx1, pntIndx2, p1Weight );
-            }
-          else
-          if ( pntIndex >= N0 && pntIndex <= N3 )
-            {
-            shapeIds[p] = intrpIds[ pntIndex - N0 ];
-            }
-          else
-            {
-            vtkErrorMacro( << "An invalid output point value was found "
-                           << "in the ClipCases." << endl );
-            }
-          }
-
-        switch ( theShape )
-          {
-          case ST_HEX:
-            visItVFV->AddHex( i, shapeIds[0], shapeIds[1],
-                                 shapeIds[2], shapeIds[3], shapeIds[4],
-                                 shapeIds[5], shapeIds[6], shapeIds[7] );
-            break;
-
-          case ST_WDG:
-            visItVFV->AddWedge( i, shapeIds[0], shapeIds[1], shapeIds[2],
-                                   shapeIds[3], shapeIds[4], shapeIds[5] );
-            break;
-
-          case ST_PYR:
-            visItVFV->AddPyramid( i, shapeIds[0], shapeIds[1],
-                                     shapeIds[2], shapeIds[3], shapeIds[4] );
-            break;
-
-          case ST_TET:
-            visItVFV->AddTet( i, shapeIds[0], shapeIds[1],
-                                 shapeIds[2], shapeIds[3] );
-            break;
-
-          case ST_QUA:
-            visItVFV->AddQuad( i, shapeIds[0], shapeIds[1],
-                                  shapeIds[2], shapeIds[3] );
-            break;
-
-          case ST_TRI:
-            visItVFV->AddTri( i, shapeIds[0], shapeIds[1], shapeIds[2] );
-            break;
-
-          case ST_LIN:
-            visItVFV->AddLine( i, shapeIds[0], shapeIds[1] );
-            break;
-
-          case ST_VTX:
-            visItVFV->AddVertex( i, shapeIds[0] );
-            break;
-
-          case ST_PNT:
-            intrpIds[ intrpIdx ] = visItVFV->AddCentroidPoint
-                                             ( nCellPts, shapeIds );
-            break;
-          }
-        }
-
-      edgeVtxs = NULL;
-      thisCase = NULL;
-      }
-    else if (cellType == VTK_POLYHEDRON)
-      {
       if ( numCants == 0 )
         {
           specials->GetCellData()
                   ->CopyAllocate( unstruct->GetCellData(), numCells );
         }
-      vtkIdType nfaces, *facePtIds;
-      unstruct->GetFaceStream(i, nfaces, facePtIds);
-      specials->InsertNextCell(cellType, nfaces, facePtIds);
-      specials->GetCellData()
-              ->CopyData( unstruct->GetCellData(), i, numCants );
-      numCants ++;
-      }
-    else
-      {
-      if ( numCants == 0 )
+      if ( cellType == VTK_POLYHEDRON )
         {
-          specials->GetCellData()
-                  ->CopyAllocate( unstruct->GetCellData(), numCells );
+        vtkIdType nfaces, *facePtIds;
+        unstruct->GetFaceStream(i, nfaces, facePtIds);
+        specials->InsertNextCell(cellType, nfaces, facePtIds);
+        }
+      else
+        {
+        vtkIdType * pntIndxs = NULL;
+        unstruct->GetCellPoints( i, numbPnts, pntIndxs );
+        specials->InsertNextCell( cellType, numbPnts, pntIndxs );
+        pntIndxs = NULL;
         }
-      specials->InsertNextCell( cellType, numbPnts, pntIndxs );
       specials->GetCellData()
               ->CopyData( unstruct->GetCellData(), i, numCants );
       numCants ++;
       }
-
-    pntIndxs = NULL;
     }
 
   int         toDelete = 0;
@@ -3396,7 +3384,7 @@ void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
     this->ClipDataSet( specials, clipAray, vtkUGrid );
 
     vtkUnstructuredGrid * visItGrd = vtkUnstructuredGrid::New();
-    visItVFV->ConstructDataSet( unstruct, visItGrd, theCords );
+    clipper.ConstructDataSet( unstruct, visItGrd, theCords );
 
     vtkAppendFilter * appender = vtkAppendFilter::New();
     appender->AddInputData( vtkUGrid );
@@ -3414,17 +3402,15 @@ void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
     }
   else
     {
-    visItVFV->ConstructDataSet( unstruct, outputUG, theCords );
+    clipper.ConstructDataSet( unstruct, outputUG, theCords );
     }
 
   specials->Delete();
-  delete visItVFV;
   if ( toDelete )
     {
     delete [] theCords;
     }
   specials = NULL;
-  visItVFV = NULL;
   theCords = NULL;
   unstruct = NULL;
 }
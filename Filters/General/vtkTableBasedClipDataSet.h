@@ -68,6 +68,12 @@
 //  advantages are gained by adopting the unique clipping and triangulation tables
 //  proposed by VisIt.
 //
+//  The cells are clipped in parallel with vtkSMPTools, by blocks whose
+//  points are merged afterwards into the same output as a serial clip. Clip
+//  scalars in a bit array, or in an array without the standard memory
+//  layout, are clipped from a single thread, and so are the attributes of
+//  inputs with such arrays.
+//
 // .SECTION Caveats
 //  vtkTableBasedClipDataSet makes use of a hash table (that is provided by class
 //  maintained by internal class vtkTableBasedClipperDataSetFromVolume) to achieve
@@ -24,9 +24,62 @@
 #include "vtkInformationVector.h"
 #include "vtkCompositeDataSet.h"
 #include "vtkObjectFactory.h"
+#include "vtkPolyData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkThreadedCompositeDataPipeline.h"
+
+#include <map>
+#include <vector>
 
 vtkStandardNewMacro(vtkCompositeDataGeometryFilter);
 
+namespace
+{
+// Extract the surfaces of the blocks in parallel, largest first, each
+// thread with its own surface filter.
+class vtkCompositeDataGeometryFilterExtract
+{
+public:
+  vtkCompositeDataGeometryFilterExtract(
+    const std::vector<vtkDataObject*>& blocks,
+    const std::vector<vtkIdType>& order,
+    std::vector<vtkSmartPointer<vtkPolyData> >& surfaces)
+    : Blocks(blocks), Order(order), Surfaces(surfaces)
+  {
+  }
+
+  void Initialize()
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkDataSetSurfaceFilter* dssf = this->Filters.Local();
+    for (vtkIdType k = begin; k < end; ++k)
+      {
+      vtkIdType i = this->Order[k];
+      dssf->SetInputData(this->Blocks[i]);
+      dssf->Update();
+      this->Surfaces[i] = vtkSmartPointer<vtkPolyData>::New();
+      this->Surfaces[i]->ShallowCopy(dssf->GetOutput());
+      }
+    dssf->SetInputData(NULL);
+  }
+
+  void Reduce()
+  {
+  }
+
+private:
+  const std::vector<vtkDataObject*>& Blocks;
+  const std::vector<vtkIdType>& Order;
+  std::vector<vtkSmartPointer<vtkPolyData> >& Surfaces;
+  vtkSMPThreadLocalObject<vtkDataSetSurfaceFilter> Filters;
+};
+}
+
 //-----------------------------------------------------------------------------
 vtkCompositeDataGeometryFilter::vtkCompositeDataGeometryFilter()
 {
@@ -86,24 +139,47 @@ int vtkCompositeDataGeometryFilter::RequestCompositeData(
     return 0;
     }
 
-  bool added=false;
+  // Collect the data set blocks; a block that appears several times is
+  // extracted once.
+  std::vector<vtkDataObject*> blocks;
+  std::vector<vtkIdType> blockOfLeaf;
+  std::map<vtkDataObject*, vtkIdType> blockIds;
   vtkCompositeDataIterator* iter = input->NewIterator();
-  vtkAppendPolyData* append = vtkAppendPolyData::New();
   for(iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
     {
     vtkDataSet* ds = vtkDataSet::SafeDownCast(iter->GetCurrentDataObject());
     if (ds)
       {
-      vtkDataSetSurfaceFilter* dssf = vtkDataSetSurfaceFilter::New();
-      dssf->SetInputData(ds);
-      dssf->Update();
-      append->AddInputConnection(dssf->GetOutputPort());
-      dssf->Delete();
-      added = true;
+      std::map<vtkDataObject*, vtkIdType>::iterator found = blockIds.find(ds);
+      if (found == blockIds.end())
+        {
+        found = blockIds.insert(std::make_pair(
+          static_cast<vtkDataObject*>(ds),
+          static_cast<vtkIdType>(blocks.size()))).first;
+        blocks.push_back(ds);
+        }
+      blockOfLeaf.push_back(found->second);
       }
     }
   iter->Delete();
-  if (added)
+
+  vtkIdType numBlocks = static_cast<vtkIdType>(blocks.size());
+  std::vector<vtkIdType> order(numBlocks);
+  std::vector<vtkSmartPointer<vtkPolyData> > surfaces(numBlocks);
+  if (numBlocks > 0)
+    {
+    vtkThreadedCompositeDataPipeline::ComputeExecutionOrder(
+      &blocks[0], numBlocks, &order[0]);
+    vtkCompositeDataGeometryFilterExtract extract(blocks, order, surfaces);
+    vtkSMPTools::For(0, numBlocks, 1, extract);
+    }
+
+  vtkAppendPolyData* append = vtkAppendPolyData::New();
+  for (size_t i = 0; i < blockOfLeaf.size(); ++i)
+    {
+    append->AddInputData(surfaces[blockOfLeaf[i]]);
+    }
+  if (!blockOfLeaf.empty())
     {
     append->Update();
     output->ShallowCopy(append->GetOutput());
@@ -18,6 +18,7 @@
 // leaves in vtkCompositeDataSet. Place this filter at the end of a
 // pipeline before a polydata consumer such as a polydata mapper to extract
 // geometry from all blocks and append them to one polydata object.
+// The leaves are processed in parallel with vtkSMPTools, largest first.
 
 #ifndef vtkCompositeDataGeometryFilter_h
 #define vtkCompositeDataGeometryFilter_h
@@ -21,7 +21,9 @@
 #include "vtkCompositeDataPipeline.h"
 #include "vtkCompositeDataSet.h"
 #include "vtkCompositeDataIterator.h"
+#include "vtkDataObjectCache.h"
 #include "vtkSmartPointer.h"
+#include "vtkTimerLog.h"
 
 #include <vector>
 
@@ -34,6 +36,9 @@ vtkStandardNewMacro(vtkTemporalDataSetCache);
 vtkTemporalDataSetCache::vtkTemporalDataSetCache()
 {
   this->CacheSize = 10;
+  this->DataCache = vtkDataObjectCache::New();
+  this->PendingTime = 0.0;
+  this->RequestStartTime = 0.0;
   this->SetNumberOfInputPorts(1);
   this->SetNumberOfOutputPorts(1);
 }
@@ -41,12 +46,30 @@ vtkTemporalDataSetCache::vtkTemporalDataSetCache()
 //----------------------------------------------------------------------------
 vtkTemporalDataSetCache::~vtkTemporalDataSetCache()
 {
-  CacheType::iterator pos = this->Cache.begin();
-  for (; pos != this->Cache.end();)
+  this->DataCache->RemoveOwner(this);
+  this->DataCache->Delete();
+}
+
+//----------------------------------------------------------------------------
+void vtkTemporalDataSetCache::SetDataCache(vtkDataObjectCache* cache)
+{
+  if (cache == this->DataCache)
     {
-    pos->second.second->UnRegister(this);
-    this->Cache.erase(pos++);
+    return;
+    }
+  this->DataCache->RemoveOwner(this);
+  this->DataCache->Delete();
+  this->Cache.clear();
+  if (cache)
+    {
+    cache->Register(this);
+    this->DataCache = cache;
+    }
+  else
+    {
+    this->DataCache = vtkDataObjectCache::New();
     }
+  this->Modified();
 }
 
 int vtkTemporalDataSetCache::ProcessRequest(
@@ -103,6 +126,7 @@ void vtkTemporalDataSetCache::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os,indent);
 
   os << indent << "CacheSize: " << this->CacheSize << endl;
+  os << indent << "DataCache: " << this->DataCache << endl;
 }
 //----------------------------------------------------------------------------
 void vtkTemporalDataSetCache::SetCacheSize(int size)
@@ -126,7 +150,7 @@ void vtkTemporalDataSetCache::SetCacheSize(int size)
   CacheType::iterator pos = this->Cache.begin();
   for (; i > 0; --i)
     {
-    pos->second.second->UnRegister(this);
+    this->DataCache->Remove(this, pos->first);
     this->Cache.erase(pos++);
     }
 }
@@ -187,12 +211,19 @@ int vtkTemporalDataSetCache
     }
 
 
+  // Time steps evicted from the shared cache to honor its memory budget
+  // are forgotten too.
   unsigned long pmt = ddp->GetPipelineMTime();
   for (pos = this->Cache.begin(); pos != this->Cache.end();)
     {
-    if (pos->second.first < pmt)
+    pos->second.second = NULL;
+    if (pos->second.first >= pmt)
+      {
+      pos->second.second = this->DataCache->Peek(this, pos->first);
+      }
+    if (!pos->second.second)
       {
-      pos->second.second->Delete();
+      this->DataCache->Remove(this, pos->first);
       this->Cache.erase(pos++);
       }
     else
@@ -200,6 +231,7 @@ int vtkTemporalDataSetCache
       ++pos;
       }
     }
+  this->PendingData = NULL;
 
 
   // are there any times that we are missing from the request? e.g. times
@@ -230,11 +262,14 @@ int vtkTemporalDataSetCache
     double upTime =
       outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP());
 
-    // do we have this time step?
-    pos = this->Cache.find(upTime);
-    if (pos == this->Cache.end())
+    // do we have this time step? Hold on to it until RequestData, so
+    // that the shared cache does not evict it while the input updates.
+    this->PendingData = this->DataCache->Find(this, upTime);
+    this->PendingTime = upTime;
+    if (!this->PendingData)
       {
       reqTimeSteps.push_back(upTime);
+      this->RequestStartTime = vtkTimerLog::GetUniversalTime();
       }
 
     // if we need any data
@@ -289,12 +324,21 @@ int vtkTemporalDataSetCache::RequestData(
 
   // a time should either be in the Cache or in the input
   CacheType::iterator pos = this->Cache.find(upTime);
+  vtkSmartPointer<vtkDataObject> cachedData;
   if (pos != this->Cache.end())
     {
-    vtkDataObject* cachedData = pos->second.second;
+    cachedData = (this->PendingData && this->PendingTime == upTime) ?
+      this->PendingData : this->DataCache->Peek(this, upTime);
+    pos->second.second = cachedData;
+    if (!cachedData)
+      {
+      this->Cache.erase(pos);
+      }
+    }
+  if (cachedData)
+    {
     output = cachedData->NewInstance();
     output->ShallowCopy(cachedData);
-//  outData->SetTimeStep(0, pos->second.second);
     // update the m time in the cache
     pos->second.first = outputUpdateTime;
     }
@@ -329,15 +373,21 @@ int vtkTemporalDataSetCache::RequestData(
     CacheType::iterator pos1 = this->Cache.find(inTime);
     if (pos1 == this->Cache.end())
       {
-      // if we have room in the Cache then just add the new data
+      // if we have room in the Cache then just add the new data. The time
+      // the input took to update is the cost of recomputing it.
       if (this->Cache.size() < static_cast<unsigned long>(this->CacheSize))
         {
-        vtkDataObject* cachedData  = input->NewInstance();
-        cachedData->ShallowCopy(input);
-
-        this->Cache[inTime] =
-          std::pair<unsigned long, vtkDataObject *>
-          (outputUpdateTime, cachedData);
+        vtkDataObject* newData = input->NewInstance();
+        newData->ShallowCopy(input);
+        double cost = vtkTimerLog::GetUniversalTime() - this->RequestStartTime;
+        if (this->DataCache->Insert(this, inTime, newData,
+                                    outputUpdateTime, cost > 0.0 ? cost : 0.0))
+          {
+          this->Cache[inTime] =
+            std::pair<unsigned long, vtkDataObject *>
+            (outputUpdateTime, newData);
+          }
+        newData->Delete();
         }
       // no room in the cache, we need to get rid of something
       else
@@ -355,12 +405,15 @@ int vtkTemporalDataSetCache::RequestData(
         //was there old data?
         if (oldestpos->second.first < outputUpdateTime)
           {
-          oldestpos->second.second->UnRegister(this);
+          this->DataCache->Remove(this, oldestpos->first);
           this->Cache.erase(oldestpos);
           }
         // if no old data and no room then we are done
         }
       }
     }
+
+  this->PendingData = NULL;
+  this->DataCache->ReportCounters(this, outInfo);
   return 1;
 }
@@ -16,6 +16,10 @@
 // .SECTION Description
 // vtkTemporalDataSetCache cache time step requests of a temporal dataset,
 // when cached data is requested it is returned using a shallow copy.
+// The cached time steps are stored in a vtkDataObjectCache, which can be
+// shared with other caches to bound the memory they use together. Its
+// hit, miss and eviction counters for this filter are reported in the
+// output information.
 // .SECTION Thanks
 // Ken Martin (Kitware) and John Bidiscombe of
 // CSCS - Swiss National Supercomputing Centre
@@ -31,8 +35,11 @@
 #include "vtkFiltersHybridModule.h" // For export macro
 
 #include "vtkAlgorithm.h"
+#include "vtkSmartPointer.h" // For PendingData
 #include <map> // used for the cache
 
+class vtkDataObjectCache;
+
 class VTKFILTERSHYBRID_EXPORT vtkTemporalDataSetCache : public vtkAlgorithm
 {
 public:
@@ -46,6 +53,14 @@ public:
   void SetCacheSize(int size);
   vtkGetMacro(CacheSize,int);
 
+  // Description:
+  // Store for the cached time steps. Each filter creates its own by
+  // default, without memory budget. Setting the same cache on several
+  // filters makes them share its memory budget. Setting NULL goes back to
+  // a private cache.
+  void SetDataCache(vtkDataObjectCache* cache);
+  vtkGetObjectMacro(DataCache, vtkDataObjectCache);
+
 protected:
   vtkTemporalDataSetCache();
   ~vtkTemporalDataSetCache();
@@ -53,11 +68,26 @@ protected:
   int CacheSize;
 
 //BTX
+  // Time steps stored in DataCache, which owns the data, with the update
+  // time they were stored or last used at. The data pointers are refreshed
+  // at each request; time steps evicted from DataCache are dropped then.
   typedef std::map<double,std::pair<unsigned long,vtkDataObject *> >
   CacheType;
   CacheType Cache;
 //ETX
 
+  vtkDataObjectCache* DataCache;
+
+  // Description:
+  // Cached time step found by RequestUpdateExtent(), held until
+  // RequestData() so that it cannot be evicted in between.
+  vtkSmartPointer<vtkDataObject> PendingData;
+  double PendingTime;
+
+  // Description:
+  // Time RequestUpdateExtent() asked the input for a time step.
+  double RequestStartTime;
+
 
   // Description:
   // see vtkAlgorithm for details
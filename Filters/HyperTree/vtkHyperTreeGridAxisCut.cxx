@@ -14,19 +14,88 @@
 =========================================================================*/
 #include "vtkHyperTreeGridAxisCut.h"
 
+#include "vtkArrayListTemplate.h"
 #include "vtkBitArray.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkDataSetAttributes.h"
+#include "vtkFloatArray.h"
 #include "vtkHyperTreeGrid.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+
+#include <vector>
 
 vtkStandardNewMacro(vtkHyperTreeGridAxisCut);
 
+// Quads cut from one root tree. While Points is null the quads are only
+// counted. Otherwise they are written to the preallocated output from
+// FirstFace on, along with the data of the input cell each one comes from.
+class vtkHyperTreeGridAxisCutFaces
+{
+public:
+  vtkIdType NumberOfFaces;
+  vtkIdType FirstFace;
+  float* Points;
+  vtkIdType* Connectivity;
+  vtkArrayList* CellData;
+
+  vtkHyperTreeGridAxisCutFaces()
+    : NumberOfFaces( 0 ), FirstFace( 0 ),
+      Points( 0 ), Connectivity( 0 ), CellData( 0 )
+  {
+  }
+
+  void AddFace( vtkIdType inId, const double pts[4][3] )
+  {
+    if ( this->Points )
+      {
+      vtkIdType face = this->FirstFace + this->NumberOfFaces;
+      float* x = this->Points + 12 * face;
+      vtkIdType* cell = this->Connectivity + 5 * face;
+      *cell ++ = 4;
+      for ( int p = 0; p < 4; ++ p )
+        {
+        *x ++ = static_cast<float>( pts[p][0] );
+        *x ++ = static_cast<float>( pts[p][1] );
+        *x ++ = static_cast<float>( pts[p][2] );
+        *cell ++ = 4 * face + p;
+        }
+      this->CellData->Copy( inId, face );
+      }
+    ++ this->NumberOfFaces;
+  }
+};
+
+// Cut a range of root trees.
+class vtkHyperTreeGridAxisCutFunctor
+{
+public:
+  vtkHyperTreeGridAxisCut* Filter;
+  const vtkIdType* TreeIds;
+  vtkHyperTreeGridAxisCutFaces* Faces;
+
+  vtkHyperTreeGridAxisCutFunctor( vtkHyperTreeGridAxisCut* filter,
+                                  const vtkIdType* treeIds,
+                                  vtkHyperTreeGridAxisCutFaces* faces )
+    : Filter( filter ), TreeIds( treeIds ), Faces( faces )
+  {
+  }
+
+  void operator()( vtkIdType begin, vtkIdType end )
+  {
+    for ( vtkIdType i = begin; i < end; ++ i )
+      {
+      this->Filter->ProcessTree( this->TreeIds[i], this->Faces + i );
+      }
+  }
+};
+
 //-----------------------------------------------------------------------------
 vtkHyperTreeGridAxisCut::vtkHyperTreeGridAxisCut()
 {
@@ -133,25 +202,64 @@ void vtkHyperTreeGridAxisCut::ProcessTrees()
   // TODO: MTime on generation of this table.
   this->Input->GenerateSuperCursorTraversalTable();
 
-  // Primal corner points
-  this->Points = vtkPoints::New();
-  this->Cells = vtkCellArray::New();
-
-  // Iterate over all hyper trees
+  // Collect all hyper trees so that they can be traversed concurrently
+  std::vector<vtkIdType> treeIds;
   vtkIdType index;
   vtkHyperTreeGrid::vtkHyperTreeIterator it;
   this->Input->InitializeTreeIterator( it );
   while ( it.GetNextTree( index ) )
     {
-    // Storage for super cursors
-    vtkHyperTreeGrid::vtkHyperTreeGridSuperCursor superCursor;
+    treeIds.push_back( index );
+    } // it
 
-    // Initialize center cursor
-    this->Input->InitializeSuperCursor( &superCursor, index );
+  // Count the faces of each tree first
+  vtkIdType numTrees = static_cast<vtkIdType>( treeIds.size() );
+  std::vector<vtkHyperTreeGridAxisCutFaces> faces( numTrees );
+  vtkHyperTreeGridAxisCutFunctor functor( this, numTrees ? &treeIds[0] : 0,
+                                          numTrees ? &faces[0] : 0 );
+  vtkSMPTools::For( 0, numTrees, functor );
 
-    // Traverse and populate dual recursively
-    this->RecursiveProcessTree( &superCursor );
-    } // it
+  // The faces of each tree follow those of the previous trees in the output
+  vtkIdType numFaces = 0;
+  for ( vtkIdType t = 0; t < numTrees; ++ t )
+    {
+    faces[t].FirstFace = numFaces;
+    numFaces += faces[t].NumberOfFaces;
+    }
+
+  // Primal corner points
+  vtkFloatArray* pointArray = vtkFloatArray::New();
+  pointArray->SetNumberOfComponents( 3 );
+  pointArray->SetNumberOfTuples( 4 * numFaces );
+  this->Points = vtkPoints::New();
+  this->Points->SetData( pointArray );
+  pointArray->Delete();
+
+  vtkIdTypeArray* connectivity = vtkIdTypeArray::New();
+  connectivity->SetNumberOfTuples( 5 * numFaces );
+  this->Cells = vtkCellArray::New();
+  this->Cells->SetCells( numFaces, connectivity );
+  connectivity->Delete();
+
+  vtkArrayList cellData;
+  cellData.AddArrays( numFaces, this->InData, this->OutData );
+
+  // Then write the faces of each tree at their place in the output
+  for ( vtkIdType t = 0; t < numTrees; ++ t )
+    {
+    faces[t].NumberOfFaces = 0;
+    faces[t].Points = pointArray->GetPointer( 0 );
+    faces[t].Connectivity = connectivity->GetPointer( 0 );
+    faces[t].CellData = &cellData;
+    }
+  if ( vtkArrayList::IsThreadSafe( this->InData ) )
+    {
+    vtkSMPTools::For( 0, numTrees, functor );
+    }
+  else
+    {
+    functor( 0, numTrees );
+    }
 
   // Set output geometry and topology
   this->Output->SetPoints( this->Points );
@@ -164,42 +272,62 @@ void vtkHyperTreeGridAxisCut::ProcessTrees()
 }
 
 //----------------------------------------------------------------------------
-void vtkHyperTreeGridAxisCut::AddFace( vtkIdType inId, double* origin,
+void vtkHyperTreeGridAxisCut::ProcessTree( vtkIdType index,
+                                           vtkHyperTreeGridAxisCutFaces* faces )
+{
+  // Storage for super cursors
+  vtkHyperTreeGrid::vtkHyperTreeGridSuperCursor superCursor;
+
+  // Initialize center cursor
+  this->Input->InitializeSuperCursor( &superCursor, index );
+
+  // Traverse and populate faces recursively
+  this->RecursiveProcessTree( &superCursor, faces );
+}
+
+//----------------------------------------------------------------------------
+void vtkHyperTreeGridAxisCut::AddFace( vtkHyperTreeGridAxisCutFaces* faces,
+                                       vtkIdType inId, double* origin,
                                        double* size, double offset0,
                                        int axis0, int axis1, int axis2 )
 {
   // Generate 4 points
-  double pt[3];
-  memcpy( pt, origin, 3 * sizeof(double) );
-  pt[axis0] += size[axis0] * offset0;
-
-  // Storage for cell IDs
-  vtkIdType ids[4];
-  ids[0] = this->Points->InsertNextPoint( pt );
-  pt[axis1] += size[axis1];
-  ids[1] = this->Points->InsertNextPoint( pt );
-  pt[axis2] += size[axis2];
-  ids[2] = this->Points->InsertNextPoint( pt );
-  pt[axis1] = origin[axis1];
-  ids[3] = this->Points->InsertNextPoint( pt );
-
-  vtkIdType outId = this->Cells->InsertNextCell( 4, ids );
-  this->OutData->CopyData( this->InData, inId, outId );
+  double pts[4][3];
+  memcpy( pts[0], origin, 3 * sizeof(double) );
+  pts[0][axis0] += size[axis0] * offset0;
+
+  memcpy( pts[1], pts[0], 3 * sizeof(double) );
+  pts[1][axis1] += size[axis1];
+  memcpy( pts[2], pts[1], 3 * sizeof(double) );
+  pts[2][axis2] += size[axis2];
+  memcpy( pts[3], pts[2], 3 * sizeof(double) );
+  pts[3][axis1] = origin[axis1];
+
+  faces->AddFace( inId, pts );
 }
 
 //----------------------------------------------------------------------------
-void vtkHyperTreeGridAxisCut::RecursiveProcessTree( void* sc )
+void vtkHyperTreeGridAxisCut::RecursiveProcessTree( void* sc,
+                                                    vtkHyperTreeGridAxisCutFaces* faces )
 {
   vtkHyperTreeGrid::vtkHyperTreeGridSuperCursor* superCursor =
     static_cast<vtkHyperTreeGrid::vtkHyperTreeGridSuperCursor*>( sc );
 
+  // Terminate if the node does not touch the plane.
+  if ( superCursor->Origin[this->PlaneNormalAxis] > this->PlanePosition ||
+    ( superCursor->Origin[this->PlaneNormalAxis] +
+    superCursor->Size[this->PlaneNormalAxis] < this->PlanePosition ) )
+    {
+    return;
+    }
+
   // Get cursor at super cursor center
   vtkHyperTreeGrid::vtkHyperTreeSimpleCursor* cursor0 = superCursor->GetCursor( 0 );
 
   if ( cursor0->IsLeaf() )
     {
     // Cursor is a leaf
-    ProcessLeaf3D( sc );
+    ProcessLeaf3D( sc, faces );
     }
   else
     {
@@ -209,13 +337,14 @@ void vtkHyperTreeGridAxisCut::RecursiveProcessTree( void* sc )
       {
       vtkHyperTreeGrid::vtkHyperTreeGridSuperCursor newSuperCursor;
       this->Input->InitializeSuperCursorChild( superCursor,&newSuperCursor, child );
-      this->RecursiveProcessTree( &newSuperCursor );
+      this->RecursiveProcessTree( &newSuperCursor, faces );
       }
     }
 }
 
 //----------------------------------------------------------------------------
-void vtkHyperTreeGridAxisCut::ProcessLeaf3D( void* sc )
+void vtkHyperTreeGridAxisCut::ProcessLeaf3D( void* sc,
+                                             vtkHyperTreeGridAxisCutFaces* faces )
 {
   // Get cursor at super cursor center
   vtkHyperTreeGrid::vtkHyperTreeGridSuperCursor* superCursor =
@@ -262,6 +391,6 @@ void vtkHyperTreeGridAxisCut::ProcessLeaf3D( void* sc )
       return;
     }
 
-  this->AddFace( inId, superCursor->Origin, superCursor->Size, k,
+  this->AddFace( faces, inId, superCursor->Origin, superCursor->Size, k,
     this->PlaneNormalAxis, axis1, axis2 );
 }
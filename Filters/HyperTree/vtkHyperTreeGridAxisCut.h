@@ -19,6 +19,9 @@
 // Produces disjoint (no point sharing) quads for now.
 // NB: If cut plane contains inter-cell boundaries, the output will contain
 // superimposed faces as a result.
+// The root trees are traversed concurrently with vtkSMPTools, once to count
+// their faces and once to write them into the preallocated output in tree
+// order.
 //
 // .SECTION See Also
 // vtkHyperTreeGrid
@@ -36,6 +39,7 @@
 class vtkCellArray;
 class vtkDataSetAttributes;
 class vtkHyperTreeGrid;
+class vtkHyperTreeGridAxisCutFaces;
 class vtkPoints;
 
 class VTKFILTERSHYPERTREE_EXPORT vtkHyperTreeGridAxisCut : public vtkPolyDataAlgorithm
@@ -63,9 +67,15 @@ protected:
   virtual int FillInputPortInformation( int, vtkInformation* );
 
   void ProcessTrees();
-  void RecursiveProcessTree( void* );
-  void ProcessLeaf3D( void* );
-  void AddFace( vtkIdType inId, double* origin, double* size,
+
+  // Description:
+  // Cut the root tree at the given index. Only reads the input so that
+  // several trees can be processed at once.
+  void ProcessTree( vtkIdType, vtkHyperTreeGridAxisCutFaces* );
+  void RecursiveProcessTree( void*, vtkHyperTreeGridAxisCutFaces* );
+  void ProcessLeaf3D( void*, vtkHyperTreeGridAxisCutFaces* );
+  void AddFace( vtkHyperTreeGridAxisCutFaces*, vtkIdType inId,
+                double* origin, double* size,
                 double offset0, int axis0, int axis1, int axis2 );
 
   int PlaneNormalAxis;
@@ -81,6 +91,8 @@ protected:
   vtkCellArray* Cells;
 
 private:
+  friend class vtkHyperTreeGridAxisCutFunctor;
+
   vtkHyperTreeGridAxisCut(const vtkHyperTreeGridAxisCut&);  // Not implemented.
   void operator=(const vtkHyperTreeGridAxisCut&);  // Not implemented.
 };
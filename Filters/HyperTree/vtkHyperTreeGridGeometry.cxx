@@ -14,21 +14,98 @@
 =========================================================================*/
 #include "vtkHyperTreeGridGeometry.h"
 
+#include "vtkArrayListTemplate.h"
 #include "vtkBitArray.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkDataSetAttributes.h"
 #include "vtkExtentTranslator.h"
+#include "vtkFloatArray.h"
 #include "vtkHyperTreeGrid.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+#include <vector>
+
 vtkStandardNewMacro(vtkHyperTreeGridGeometry);
 
+// Faces extracted from one root tree, two corner points per edge in 1D and
+// four per quad otherwise. While Points is null the faces are only counted.
+// Otherwise they are written to the preallocated output from FirstFace on,
+// along with the data of the input cell each one comes from.
+class vtkHyperTreeGridGeometryFaces
+{
+public:
+  vtkIdType NumberOfFaces;
+  vtkIdType FirstFace;
+  int FaceSize;
+  float* Points;
+  vtkIdType* Connectivity;
+  vtkArrayList* CellData;
+
+  vtkHyperTreeGridGeometryFaces()
+    : NumberOfFaces( 0 ), FirstFace( 0 ), FaceSize( 0 ),
+      Points( 0 ), Connectivity( 0 ), CellData( 0 )
+  {
+  }
+
+  void AddFace( vtkIdType inId, const double pts[][3] )
+  {
+    if ( this->Points )
+      {
+      vtkIdType face = this->FirstFace + this->NumberOfFaces;
+      vtkIdType ptId = face * this->FaceSize;
+      float* x = this->Points + 3 * ptId;
+      vtkIdType* cell = this->Connectivity + face * ( this->FaceSize + 1 );
+      *cell ++ = this->FaceSize;
+      for ( int p = 0; p < this->FaceSize; ++ p )
+        {
+        *x ++ = static_cast<float>( pts[p][0] );
+        *x ++ = static_cast<float>( pts[p][1] );
+        *x ++ = static_cast<float>( pts[p][2] );
+        *cell ++ = ptId + p;
+        }
+
+      // Copy face data from that of the cell from which it comes
+      if ( inId >= 0 && this->CellData )
+        {
+        this->CellData->Copy( inId, face );
+        }
+      }
+    ++ this->NumberOfFaces;
+  }
+};
+
+// Extract the faces of a range of root trees.
+class vtkHyperTreeGridGeometryFunctor
+{
+public:
+  vtkHyperTreeGridGeometry* Filter;
+  const vtkIdType* TreeIds;
+  vtkHyperTreeGridGeometryFaces* Faces;
+
+  vtkHyperTreeGridGeometryFunctor( vtkHyperTreeGridGeometry* filter,
+                                   const vtkIdType* treeIds,
+                                   vtkHyperTreeGridGeometryFaces* faces )
+    : Filter( filter ), TreeIds( treeIds ), Faces( faces )
+  {
+  }
+
+  void operator()( vtkIdType begin, vtkIdType end )
+  {
+    for ( vtkIdType i = begin; i < end; ++ i )
+      {
+      this->Filter->ProcessTree( this->TreeIds[i], this->Faces + i );
+      }
+  }
+};
+
 //-----------------------------------------------------------------------------
 vtkHyperTreeGridGeometry::vtkHyperTreeGridGeometry()
 {
@@ -102,25 +179,71 @@ void vtkHyperTreeGridGeometry::ProcessTrees()
   // TODO: MTime on generation of this table.
   this->Input->GenerateSuperCursorTraversalTable();
 
-  // Primal corner points
-  this->Points = vtkPoints::New();
-  this->Cells = vtkCellArray::New();
-
-  // Iterate over all hyper trees
+  // Collect all hyper trees so that they can be traversed concurrently
+  std::vector<vtkIdType> treeIds;
   vtkIdType index;
   vtkHyperTreeGrid::vtkHyperTreeIterator it;
   this->Input->InitializeTreeIterator( it );
   while ( it.GetNextTree( index ) )
     {
-    // Storage for super cursors
-    vtkHyperTreeGrid::vtkHyperTreeGridSuperCursor superCursor;
+    treeIds.push_back( index );
+    } // it
 
-    // Initialize center cursor
-    this->Input->InitializeSuperCursor( &superCursor, index );
+  // Count the faces of each tree first
+  vtkIdType numTrees = static_cast<vtkIdType>( treeIds.size() );
+  std::vector<vtkHyperTreeGridGeometryFaces> faces( numTrees );
+  vtkHyperTreeGridGeometryFunctor functor( this, numTrees ? &treeIds[0] : 0,
+                                           numTrees ? &faces[0] : 0 );
+  vtkSMPTools::For( 0, numTrees, functor );
+
+  // The faces of each tree follow those of the previous trees in the output
+  bool is1D = ( this->Input->GetDimension() == 1 );
+  int faceSize = is1D ? 2 : 4;
+  vtkIdType numFaces = 0;
+  for ( vtkIdType t = 0; t < numTrees; ++ t )
+    {
+    faces[t].FirstFace = numFaces;
+    numFaces += faces[t].NumberOfFaces;
+    }
 
-    // Traverse and populate dual recursively
-    this->RecursiveProcessTree( &superCursor );
-    } // it
+  // Primal corner points
+  vtkFloatArray* pointArray = vtkFloatArray::New();
+  pointArray->SetNumberOfComponents( 3 );
+  pointArray->SetNumberOfTuples( numFaces * faceSize );
+  this->Points = vtkPoints::New();
+  this->Points->SetData( pointArray );
+  pointArray->Delete();
+
+  vtkIdTypeArray* connectivity = vtkIdTypeArray::New();
+  connectivity->SetNumberOfTuples( numFaces * ( faceSize + 1 ) );
+  this->Cells = vtkCellArray::New();
+  this->Cells->SetCells( numFaces, connectivity );
+  connectivity->Delete();
+
+  // No data is copied to edges
+  vtkArrayList cellData;
+  if ( ! is1D )
+    {
+    cellData.AddArrays( numFaces, this->InData, this->OutData );
+    }
+
+  // Then write the faces of each tree at their place in the output
+  for ( vtkIdType t = 0; t < numTrees; ++ t )
+    {
+    faces[t].NumberOfFaces = 0;
+    faces[t].FaceSize = faceSize;
+    faces[t].Points = pointArray->GetPointer( 0 );
+    faces[t].Connectivity = connectivity->GetPointer( 0 );
+    faces[t].CellData = is1D ? 0 : &cellData;
+    }
+  if ( vtkArrayList::IsThreadSafe( this->InData ) )
+    {
+    vtkSMPTools::For( 0, numTrees, functor );
+    }
+  else
+    {
+    functor( 0, numTrees );
+    }
 
   // Set output geometry and topology
   this->Output->SetPoints( this->Points );
@@ -140,7 +263,22 @@ void vtkHyperTreeGridGeometry::ProcessTrees()
 }
 
 //----------------------------------------------------------------------------
-void vtkHyperTreeGridGeometry::RecursiveProcessTree( void* sc )
+void vtkHyperTreeGridGeometry::ProcessTree( vtkIdType index,
+                                            vtkHyperTreeGridGeometryFaces* faces )
+{
+  // Storage for super cursors
+  vtkHyperTreeGrid::vtkHyperTreeGridSuperCursor superCursor;
+
+  // Initialize center cursor
+  this->Input->InitializeSuperCursor( &superCursor, index );
+
+  // Traverse and populate faces recursively
+  this->RecursiveProcessTree( &superCursor, faces );
+}
+
+//----------------------------------------------------------------------------
+void vtkHyperTreeGridGeometry::RecursiveProcessTree( void* sc,
+                                                     vtkHyperTreeGridGeometryFaces* faces )
 {
   // Get cursor at super cursor center
   vtkHyperTreeGrid::vtkHyperTreeGridSuperCursor* superCursor =
@@ -151,13 +289,13 @@ void vtkHyperTreeGridGeometry::RecursiveProcessTree( void* sc )
     switch ( this->Input->GetDimension() )
       {
       case 1:
-        ProcessLeaf1D( sc );
+        ProcessLeaf1D( sc, faces );
         break;
       case 2:
-        ProcessLeaf2D( sc );
+        ProcessLeaf2D( sc, faces );
         break;
       case 3:
-        ProcessLeaf3D( sc );
+        ProcessLeaf3D( sc, faces );
         break;
       }
     }
@@ -169,30 +307,29 @@ void vtkHyperTreeGridGeometry::RecursiveProcessTree( void* sc )
       {
       vtkHyperTreeGrid::vtkHyperTreeGridSuperCursor newSuperCursor;
       this->Input->InitializeSuperCursorChild( superCursor, &newSuperCursor, child );
-      this->RecursiveProcessTree( &newSuperCursor );
+      this->RecursiveProcessTree( &newSuperCursor, faces );
       }
     }
 }
 
 //----------------------------------------------------------------------------
-void vtkHyperTreeGridGeometry::ProcessLeaf1D( void* sc )
+void vtkHyperTreeGridGeometry::ProcessLeaf1D( void* sc,
+                                              vtkHyperTreeGridGeometryFaces* faces )
 {
   vtkHyperTreeGrid::vtkHyperTreeGridSuperCursor* superCursor =
     static_cast<vtkHyperTreeGrid::vtkHyperTreeGridSuperCursor*>( sc );
 
   // In 1D the geometry is composed of edges
-  vtkIdType ids[2];
-  ids[0] = this->Points->InsertNextPoint( superCursor->Origin );
-  double pt[3];
-  pt[0] = superCursor->Origin[0] + superCursor->Size[0];
-  pt[1] = superCursor->Origin[1];
-  pt[2] = superCursor->Origin[2];
-  ids[1] = this->Points->InsertNextPoint( pt );
-  this->Cells->InsertNextCell( 2, ids );
+  double pts[2][3];
+  memcpy( pts[0], superCursor->Origin, 3 * sizeof(double) );
+  memcpy( pts[1], superCursor->Origin, 3 * sizeof(double) );
+  pts[1][0] += superCursor->Size[0];
+  faces->AddFace( -1, pts ); // No data is copied to edges
 }
 
 //----------------------------------------------------------------------------
-void vtkHyperTreeGridGeometry::ProcessLeaf2D( void* sc )
+void vtkHyperTreeGridGeometry::ProcessLeaf2D( void* sc,
+                                              vtkHyperTreeGridGeometryFaces* faces )
 {
   // Get cursor at super cursor center
   vtkHyperTreeGrid::vtkHyperTreeGridSuperCursor* superCursor =
@@ -204,12 +341,13 @@ void vtkHyperTreeGridGeometry::ProcessLeaf2D( void* sc )
   // In 2D all unmasked faces are generated
   if ( id0 >= 0 && ! this->Input->GetMaterialMask()->GetValue( id0 ) )
     {
-    this->AddFace( id0, superCursor->Origin, superCursor->Size, 0, 2 );
+    this->AddFace( faces, id0, superCursor->Origin, superCursor->Size, 0, 2 );
     }
 }
 
 //----------------------------------------------------------------------------
-void vtkHyperTreeGridGeometry::ProcessLeaf3D( void* sc )
+void vtkHyperTreeGridGeometry::ProcessLeaf3D( void* sc,
+                                              vtkHyperTreeGridGeometryFaces* faces )
 {
   // Get cursor at super cursor center
   vtkHyperTreeGrid::vtkHyperTreeGridSuperCursor* superCursor =
@@ -245,7 +383,8 @@ void vtkHyperTreeGridGeometry::ProcessLeaf3D( void* sc )
 
           if ( id >=0 && ! matMask->GetValue( id ) )
             {
-            this->AddFace( id0, superCursor->Origin, superCursor->Size, o, f );
+            this->AddFace( faces, id0, superCursor->Origin, superCursor->Size,
+                           o, f );
             }
           }
         }
@@ -256,7 +395,8 @@ void vtkHyperTreeGridGeometry::ProcessLeaf3D( void* sc )
           ||
           ( cursor->IsLeaf() && matMask->GetValue( id ) ) )
           {
-          this->AddFace( id0, superCursor->Origin, superCursor->Size, o, f );
+          this->AddFace( faces, id0, superCursor->Origin, superCursor->Size,
+                           o, f );
           }
         }
       } // o
@@ -264,39 +404,30 @@ void vtkHyperTreeGridGeometry::ProcessLeaf3D( void* sc )
 }
 
 //----------------------------------------------------------------------------
-void vtkHyperTreeGridGeometry::AddFace( vtkIdType inId,
+void vtkHyperTreeGridGeometry::AddFace( vtkHyperTreeGridGeometryFaces* faces,
+                                        vtkIdType inId,
                                         double* origin, double* size,
                                         int offset, int orientation )
 {
-  // Initialize point
-  double pt[3];
-  memcpy( pt, origin, 3 * sizeof(double) );
+  // Initialize points
+  double pts[4][3];
+  memcpy( pts[0], origin, 3 * sizeof(double) );
 
   if ( offset )
     {
-    pt[orientation] += size[orientation];
+    pts[0][orientation] += size[orientation];
     }
 
-  // Storage for face vertices
-  vtkIdType ids[4];
-
-  // Create origin vertex
-  ids[0] = this->Points->InsertNextPoint( pt );
-
   // Create other face vertices depending on orientation
   int axis1 = ( orientation == 0 ) ? 1 : 0;
   int axis2 = ( orientation == 2 ) ? 1 : 2;
 
-  pt[axis1] += size[axis1];
-  ids[1] = this->Points->InsertNextPoint( pt );
-  pt[axis2] += size[axis2];
-  ids[2] = this->Points->InsertNextPoint( pt );
-  pt[axis1] = origin[axis1];
-  ids[3] = this->Points->InsertNextPoint( pt );
-
-  // Insert face
-  vtkIdType outId = this->Cells->InsertNextCell( 4, ids );
+  memcpy( pts[1], pts[0], 3 * sizeof(double) );
+  pts[1][axis1] += size[axis1];
+  memcpy( pts[2], pts[1], 3 * sizeof(double) );
+  pts[2][axis2] += size[axis2];
+  memcpy( pts[3], pts[2], 3 * sizeof(double) );
+  pts[3][axis1] = origin[axis1];
 
-  // Copy face data from that of the cell from which it comes
-  this->OutData->CopyData( this->InData, inId, outId );
+  faces->AddFace( inId, pts );
 }
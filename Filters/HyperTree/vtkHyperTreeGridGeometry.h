@@ -14,6 +14,12 @@
 =========================================================================*/
 // .NAME vtkHyperTreeGridGeometry - Hyper tree grid outer surface
 //
+// .SECTION Description
+// The root trees are traversed concurrently with vtkSMPTools, twice: first
+// to count the faces of each tree, then to write them directly into the
+// preallocated output after those of the previous trees, so that the output
+// does not depend on the number of threads.
+//
 // .SECTION See Also
 // vtkHyperTreeGrid
 //
@@ -31,6 +37,7 @@
 class vtkCellArray;
 class vtkDataSetAttributes;
 class vtkHyperTreeGrid;
+class vtkHyperTreeGridGeometryFaces;
 class vtkPoints;
 
 class VTKFILTERSHYPERTREE_EXPORT vtkHyperTreeGridGeometry : public vtkPolyDataAlgorithm
@@ -49,12 +56,17 @@ protected:
   virtual int FillInputPortInformation( int, vtkInformation* );
 
   void ProcessTrees();
-  void RecursiveProcessTree( void* );
-  void ProcessLeaf1D( void* );
-  void ProcessLeaf2D( void* );
-  void ProcessLeaf3D( void* );
-  void AddFace( vtkIdType inId, double* origin, double* size,
-                int offset, int orientation );
+
+  // Description:
+  // Extract the faces of the root tree at the given index. Only reads the
+  // input so that several trees can be processed at once.
+  void ProcessTree( vtkIdType, vtkHyperTreeGridGeometryFaces* );
+  void RecursiveProcessTree( void*, vtkHyperTreeGridGeometryFaces* );
+  void ProcessLeaf1D( void*, vtkHyperTreeGridGeometryFaces* );
+  void ProcessLeaf2D( void*, vtkHyperTreeGridGeometryFaces* );
+  void ProcessLeaf3D( void*, vtkHyperTreeGridGeometryFaces* );
+  void AddFace( vtkHyperTreeGridGeometryFaces*, vtkIdType inId,
+                double* origin, double* size, int offset, int orientation );
 
   vtkHyperTreeGrid* Input;
   vtkPolyData* Output;
@@ -66,6 +78,8 @@ protected:
   vtkCellArray* Cells;
 
 private:
+  friend class vtkHyperTreeGridGeometryFunctor;
+
   vtkHyperTreeGridGeometry(const vtkHyperTreeGridGeometry&);  // Not implemented.
   void operator=(const vtkHyperTreeGridGeometry&);  // Not implemented.
 };
@@ -0,0 +1,165 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSMPCutter.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Cuts unstructured grids of tetrahedra, and of voxels, triangles and lines,
+// and the polydata of a sphere, by several values of a sphere function with
+// vtkSMPCutter, and checks the output against vtkCutter, that the cell data
+// of each output cell comes from an input cell of one more dimension, and
+// the cut scalars.
+
+#include "vtkAppendFilter.h"
+#include "vtkCellData.h"
+#include "vtkCutter.h"
+#include "vtkDataSetTriangleFilter.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkSMPCutter.h"
+#include "vtkSphere.h"
+#include "vtkSphereSource.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cmath>
+
+#define CHECK(cond)                                                    \
+  do                                                                   \
+    {                                                                  \
+    if (!(cond))                                                       \
+      {                                                                \
+      cerr << "Line " << __LINE__ << ": check failed: " #cond << endl; \
+      return EXIT_FAILURE;                                             \
+      }                                                                \
+    }                                                                  \
+  while (0)
+
+namespace
+{
+void AddCellIds(vtkDataSet *input)
+{
+  vtkNew<vtkIdTypeArray> cellIds;
+  cellIds->SetName("CellIds");
+  cellIds->SetNumberOfTuples(input->GetNumberOfCells());
+  for (vtkIdType i = 0; i < input->GetNumberOfCells(); ++i)
+    {
+    cellIds->SetValue(i, i);
+    }
+  input->GetCellData()->AddArray(cellIds.GetPointer());
+}
+
+int CheckCutter(vtkDataSet *input, vtkSphere *sphere, int generateTriangles)
+{
+  vtkNew<vtkCutter> cutter;
+  vtkNew<vtkSMPCutter> smpCutter;
+  vtkCutter *cutters[2] = { cutter.GetPointer(), smpCutter.GetPointer() };
+  for (int i = 0; i < 2; ++i)
+    {
+    cutters[i]->SetInputData(input);
+    cutters[i]->SetCutFunction(sphere);
+    cutters[i]->GenerateValues(4, -0.7, 0.8);
+    cutters[i]->SetGenerateCutScalars(1);
+    cutters[i]->SetGenerateTriangles(generateTriangles);
+    cutters[i]->Update();
+    }
+
+  vtkPolyData *expected = cutter->GetOutput();
+  vtkPolyData *output = smpCutter->GetOutput();
+  CHECK(output->GetNumberOfCells() > 0);
+  CHECK(output->GetNumberOfPoints() == expected->GetNumberOfPoints());
+  CHECK(output->GetNumberOfVerts() == expected->GetNumberOfVerts());
+  CHECK(output->GetNumberOfLines() == expected->GetNumberOfLines());
+  CHECK(output->GetNumberOfPolys() == expected->GetNumberOfPolys());
+
+  vtkIdTypeArray *cellIds = vtkIdTypeArray::SafeDownCast(
+    output->GetCellData()->GetArray("CellIds"));
+  CHECK(cellIds);
+  CHECK(cellIds->GetNumberOfTuples() == output->GetNumberOfCells());
+  for (vtkIdType i = 0; i < output->GetNumberOfCells(); ++i)
+    {
+    vtkIdType cellId = cellIds->GetValue(i);
+    CHECK(cellId >= 0 && cellId < input->GetNumberOfCells());
+    CHECK(input->GetCell(cellId)->GetCellDimension() ==
+          output->GetCell(i)->GetCellDimension() + 1);
+    }
+
+  vtkDataArray *scalars = output->GetPointData()->GetScalars();
+  CHECK(scalars && scalars->GetNumberOfTuples() == output->GetNumberOfPoints());
+  double x[3];
+  for (vtkIdType i = 0; i < output->GetNumberOfPoints(); ++i)
+    {
+    double value = scalars->GetComponent(i, 0);
+    CHECK(std::fabs(value + 0.7) < 1e-6 || std::fabs(value + 0.2) < 1e-6 ||
+          std::fabs(value - 0.3) < 1e-6 || std::fabs(value - 0.8) < 1e-6);
+    output->GetPoint(i, x);
+    // Linear interpolation across a cell is close to the quadratic function.
+    CHECK(std::fabs(sphere->EvaluateFunction(x) - value) < 0.1);
+    }
+  return EXIT_SUCCESS;
+}
+}
+
+int TestSMPCutter(int, char *[])
+{
+  vtkNew<vtkSphere> sphere;
+  sphere->SetCenter(2.0, 2.0, 2.0);
+  sphere->SetRadius(1.5);
+
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(21, 19, 17);
+  image->SetSpacing(0.2, 0.22, 0.25);
+
+  vtkNew<vtkDataSetTriangleFilter> tetrahedra;
+  tetrahedra->SetInputData(image.GetPointer());
+  tetrahedra->Update();
+  vtkNew<vtkUnstructuredGrid> tetGrid;
+  tetGrid->ShallowCopy(tetrahedra->GetOutput());
+  AddCellIds(tetGrid.GetPointer());
+  CHECK(CheckCutter(tetGrid.GetPointer(), sphere.GetPointer(), 1) ==
+        EXIT_SUCCESS);
+
+  // Voxels followed by triangles and lines, cut into polygons, lines and
+  // vertices.
+  vtkNew<vtkAppendFilter> append;
+  append->AddInputData(image.GetPointer());
+  append->Update();
+  vtkNew<vtkUnstructuredGrid> mixed;
+  mixed->DeepCopy(append->GetOutput());
+  for (vtkIdType i = 0; i < 300; ++i)
+    {
+    vtkIdType tri[3] = { 7 * i, 7 * i + 1, 7 * i + 21 };
+    mixed->InsertNextCell(VTK_TRIANGLE, 3, tri);
+    vtkIdType line[2] = { 11 * i, 11 * i + 22 };
+    mixed->InsertNextCell(VTK_LINE, 2, line);
+    }
+  AddCellIds(mixed.GetPointer());
+  CHECK(CheckCutter(mixed.GetPointer(), sphere.GetPointer(), 1) ==
+        EXIT_SUCCESS);
+  CHECK(CheckCutter(mixed.GetPointer(), sphere.GetPointer(), 0) ==
+        EXIT_SUCCESS);
+
+  vtkNew<vtkSphereSource> sphereSource;
+  sphereSource->SetCenter(2.5, 2.0, 2.0);
+  sphereSource->SetRadius(1.8);
+  sphereSource->SetThetaResolution(60);
+  sphereSource->SetPhiResolution(40);
+  sphereSource->Update();
+  vtkNew<vtkPolyData> polyData;
+  polyData->ShallowCopy(sphereSource->GetOutput());
+  AddCellIds(polyData.GetPointer());
+  CHECK(CheckCutter(polyData.GetPointer(), sphere.GetPointer(), 1) ==
+        EXIT_SUCCESS);
+
+  return EXIT_SUCCESS;
+}
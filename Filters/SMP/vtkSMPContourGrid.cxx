@@ -36,7 +36,7 @@
 #include "vtkSMPMergePolyDataHelper.h"
 #include "vtkInformationVector.h"
 #include "vtkDemandDrivenPipeline.h"
-#include "vtkSimpleScalarTree.h"
+#include "vtkScalarTree.h"
 
 #include "vtkTimerLog.h"
 
@@ -87,6 +87,7 @@ public:
 
   vtkUnstructuredGrid* Input;
   vtkDataArray* InScalars;
+  vtkScalarTree* ScalarTree;
 
   vtkDataObject* Output;
 
@@ -106,11 +107,13 @@ public:
   vtkContourGridFunctor(vtkSMPContourGrid* filter,
                         vtkUnstructuredGrid* input,
                         vtkDataArray* inScalars,
+                        vtkScalarTree* scalarTree,
                         int numValues,
                         double* values,
                         vtkDataObject* output) : Filter(filter),
                                                  Input(input),
                                                  InScalars(inScalars),
+                                                 ScalarTree(scalarTree),
                                                  Output(output),
                                                  NumValues(numValues),
                                                  Values(values)
@@ -269,9 +272,9 @@ public:
     T range[2];
     vtkIdType cellid;
 
-    // If UseScalarTree is enabled at this point, we assume that a scalar
-    // tree has been computed and thus the way cells are traversed changes.
-    if ( ! this->Filter->GetUseScalarTree() )
+    // If a scalar tree is given, we assume that it has been computed and
+    // thus the way cells are traversed changes.
+    if ( ! this->ScalarTree )
       {
       // This code assumes no scalar tree, thus it checks scalar range prior
       // to invoking contour.
@@ -361,7 +364,7 @@ public:
       // The begin / end parameters to this function represent batches of candidate
       // cells.
       vtkIdType numCellsContoured=0;
-      vtkScalarTree *scalarTree = this->Filter->GetScalarTree();
+      vtkScalarTree *scalarTree = this->ScalarTree;
       const vtkIdType *cellIds;
       vtkIdType numCells;
       for ( vtkIdType batchNum=begin; batchNum < end; ++batchNum)
@@ -467,19 +470,20 @@ void DoContour(vtkSMPContourGrid* filter,
                vtkUnstructuredGrid* input,
                vtkIdType numCells,
                vtkDataArray* inScalars,
+               vtkScalarTree* scalarTree,
                int numContours,
                double* values,
                vtkDataObject* output)
 {
   // Contour in parallel; create the processing functor
-  vtkContourGridFunctor<T> functor(filter, input, inScalars, numContours, values, output);
+  vtkContourGridFunctor<T> functor(filter, input, inScalars, scalarTree,
+                                   numContours, values, output);
 
   // If a scalar tree is used, then the way in which cells are iterated over changes.
   // With a scalar tree, batches of candidate cells are provided. Without one, then all
   // cells are iterated over one by one.
-  if ( filter->GetUseScalarTree() )
+  if ( scalarTree )
     {//process in threaded using scalar tree
-    vtkScalarTree *scalarTree = filter->GetScalarTree();
     vtkIdType numBatches;
     for (int i=0; i < numContours; ++i)
       {
@@ -587,28 +591,42 @@ int vtkSMPContourGrid::RequestData(
 
   vtkIdType numCells = input->GetNumberOfCells();
 
-  // Create scalar tree if necessary and if requested
-  int useScalarTree = this->GetUseScalarTree();
-  vtkScalarTree *scalarTree = this->ScalarTree;
-  if ( useScalarTree )
+  // Use the scalar tree if requested. Without one specified, use the tree
+  // cached on the input: it is built once and then feeds the candidate cells
+  // of each contour value, in batches, to the threads.
+  vtkScalarTree *scalarTree = NULL;
+  vtkScalarTree *cachedTree = NULL;
+  if ( this->GetUseScalarTree() )
     {
-    if ( scalarTree == NULL )
+    scalarTree = this->ScalarTree;
+    if ( scalarTree )
       {
-      scalarTree = vtkSimpleScalarTree::New();
+      scalarTree->SetDataSet(input);
+      scalarTree->SetScalars(inScalars);
+      }
+    else
+      {
+      scalarTree = cachedTree = vtkScalarTree::GetCachedTree(input, inScalars);
+      }
+    if ( scalarTree )
+      {
+      // Not thread safe so build first.
+      scalarTree->BuildTree();
       }
-    scalarTree->SetDataSet(input);
-    scalarTree->SetScalars(inScalars);
     }
 
   // Actually execute the contouring operation
   if (inScalars->GetDataType() == VTK_FLOAT)
     {
-    DoContour<float>(this, input, numCells, inScalars, numContours, values, output);
+    DoContour<float>(this, input, numCells, inScalars, scalarTree,
+                     numContours, values, output);
     }
   else if(inScalars->GetDataType() == VTK_DOUBLE)
     {
-    DoContour<double>(this, input, numCells, inScalars, numContours, values, output);
+    DoContour<double>(this, input, numCells, inScalars, scalarTree,
+                      numContours, values, output);
     }
+  vtkScalarTree::ReleaseCachedTree(cachedTree);
 
   return 1;
 }
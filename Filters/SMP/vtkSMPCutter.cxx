@@ -0,0 +1,411 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPCutter.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkSMPCutter.h"
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkContourHelper.h"
+#include "vtkContourValues.h"
+#include "vtkDoubleArray.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkImplicitFunction.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPointSet.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSMPMergePoints.h"
+#include "vtkSMPMergePolyDataHelper.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <math.h>
+#include <vector>
+
+vtkStandardNewMacro(vtkSMPCutter);
+
+//-----------------------------------------------------------------------------
+vtkSMPCutter::vtkSMPCutter(vtkImplicitFunction *cf) : vtkCutter(cf)
+{
+}
+
+//-----------------------------------------------------------------------------
+vtkSMPCutter::~vtkSMPCutter()
+{
+}
+
+//-----------------------------------------------------------------------------
+namespace
+{
+
+// The polydata a thread cuts cells into, the locator merging its points,
+// the offsets of its cells for vtkSMPMergePolyDataHelper, and the
+// temporaries it cuts cells with.
+struct vtkLocalCutData
+{
+  vtkPolyData* Output;
+  vtkSMPMergePoints* Locator;
+  vtkIdList* VertOffsets;
+  vtkIdList* LineOffsets;
+  vtkIdList* PolyOffsets;
+  vtkContourHelper* Helper;
+  vtkGenericCell* Cell;
+  vtkDoubleArray* CellScalars;
+  vtkIdList* PointIds;
+
+  vtkLocalCutData() : Output(0), Locator(0), VertOffsets(0), LineOffsets(0),
+                      PolyOffsets(0), Helper(0), Cell(0), CellScalars(0),
+                      PointIds(0)
+    {
+    }
+};
+
+//-----------------------------------------------------------------------------
+// Cut the cells of one dimension by all the cut values. The functor is run
+// once per dimension, in increasing order, so the cells, and the cell data,
+// of each thread are ordered verts, lines then polys. The thread local data
+// is initialized on first use rather than in Initialize(), which runs again
+// for every vtkSMPTools::For().
+class vtkCutterFunctor
+{
+public:
+  vtkSMPCutter* Filter;
+  vtkPointSet* Input;
+  vtkPointData* InPD;
+  vtkDoubleArray* CutScalars;
+  int NumValues;
+  const double* Values;
+  vtkIdType EstimatedSize;
+  double Bounds[6];
+  int Dimensionality;
+  unsigned char CellTypeDimensions[VTK_NUMBER_OF_CELL_TYPES];
+
+  vtkSMPThreadLocal<vtkLocalCutData> LocalData;
+
+  vtkCutterFunctor(vtkSMPCutter* filter, vtkPointSet* input,
+                   vtkPointData* inPD, vtkDoubleArray* cutScalars,
+                   int numValues, const double* values,
+                   vtkIdType estimatedSize) : Filter(filter),
+                                              Input(input),
+                                              InPD(inPD),
+                                              CutScalars(cutScalars),
+                                              NumValues(numValues),
+                                              Values(values),
+                                              EstimatedSize(estimatedSize),
+                                              Dimensionality(0)
+  {
+    // Not thread safe so calculate first.
+    input->GetBounds(this->Bounds);
+    vtkCutter::GetCellTypeDimensions(this->CellTypeDimensions);
+  }
+
+  ~vtkCutterFunctor()
+  {
+    vtkSMPThreadLocal<vtkLocalCutData>::iterator dataIter =
+      this->LocalData.begin();
+    while(dataIter != this->LocalData.end())
+      {
+      if ((*dataIter).Output)
+        {
+        delete (*dataIter).Helper;
+        (*dataIter).Output->Delete();
+        (*dataIter).Locator->Delete();
+        (*dataIter).VertOffsets->Delete();
+        (*dataIter).LineOffsets->Delete();
+        (*dataIter).PolyOffsets->Delete();
+        (*dataIter).Cell->Delete();
+        (*dataIter).CellScalars->Delete();
+        (*dataIter).PointIds->Delete();
+        }
+      ++dataIter;
+      }
+  }
+
+  void InitializeLocal(vtkLocalCutData& localData)
+  {
+    vtkIdType estimatedSize = this->EstimatedSize;
+
+    localData.Output = vtkPolyData::New();
+    vtkPolyData* output = localData.Output;
+
+    vtkNew<vtkPoints> newPts;
+    // set precision for the points in the output
+    if(this->Filter->GetOutputPointsPrecision() == vtkAlgorithm::DEFAULT_PRECISION)
+      {
+      newPts->SetDataType(this->Input->GetPoints()->GetDataType());
+      }
+    else if(this->Filter->GetOutputPointsPrecision() == vtkAlgorithm::SINGLE_PRECISION)
+      {
+      newPts->SetDataType(VTK_FLOAT);
+      }
+    else if(this->Filter->GetOutputPointsPrecision() == vtkAlgorithm::DOUBLE_PRECISION)
+      {
+      newPts->SetDataType(VTK_DOUBLE);
+      }
+    newPts->Allocate(estimatedSize, estimatedSize/2);
+    output->SetPoints(newPts.GetPointer());
+
+    // All the locators bin the same bounds, as vtkSMPMergePolyDataHelper
+    // requires.
+    localData.Locator = vtkSMPMergePoints::New();
+    localData.Locator->InitPointInsertion(newPts.GetPointer(), this->Bounds,
+                                          this->Input->GetNumberOfPoints());
+
+    localData.VertOffsets = vtkIdList::New();
+    localData.VertOffsets->Allocate(estimatedSize);
+    localData.LineOffsets = vtkIdList::New();
+    localData.LineOffsets->Allocate(estimatedSize);
+    localData.PolyOffsets = vtkIdList::New();
+    localData.PolyOffsets->Allocate(estimatedSize);
+
+    vtkNew<vtkCellArray> newVerts;
+    newVerts->Allocate(estimatedSize, estimatedSize/2);
+    output->SetVerts(newVerts.GetPointer());
+    vtkNew<vtkCellArray> newLines;
+    newLines->Allocate(estimatedSize, estimatedSize/2);
+    output->SetLines(newLines.GetPointer());
+    vtkNew<vtkCellArray> newPolys;
+    newPolys->Allocate(estimatedSize, estimatedSize/2);
+    output->SetPolys(newPolys.GetPointer());
+
+    vtkPointData* outPD = output->GetPointData();
+    vtkCellData* outCD = output->GetCellData();
+    vtkCellData* inCD = this->Input->GetCellData();
+    outPD->InterpolateAllocate(this->InPD, estimatedSize, estimatedSize/2);
+    outCD->CopyAllocate(inCD, estimatedSize, estimatedSize/2);
+
+    localData.Helper = new vtkContourHelper(
+      localData.Locator, newVerts.GetPointer(), newLines.GetPointer(),
+      newPolys.GetPointer(), this->InPD, inCD, outPD, outCD,
+      estimatedSize, this->Filter->GetGenerateTriangles() != 0);
+
+    localData.Cell = vtkGenericCell::New();
+    localData.CellScalars = vtkDoubleArray::New();
+    localData.CellScalars->Allocate(VTK_CELL_SIZE);
+    localData.PointIds = vtkIdList::New();
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkLocalCutData& localData = this->LocalData.Local();
+    if (!localData.Output)
+      {
+      this->InitializeLocal(localData);
+      }
+
+    vtkPointSet* input = this->Input;
+    vtkPolyData* output = localData.Output;
+    vtkCellArray* verts = output->GetVerts();
+    vtkCellArray* lines = output->GetLines();
+    vtkCellArray* polys = output->GetPolys();
+    vtkContourHelper* helper = localData.Helper;
+    vtkGenericCell* cell = localData.Cell;
+    vtkDoubleArray* cellScalars = localData.CellScalars;
+    vtkIdList* ptIds = localData.PointIds;
+    const double* scalars = this->CutScalars->GetPointer(0);
+    const double* values = this->Values;
+    int numValues = this->NumValues;
+    double range[2];
+
+    for (vtkIdType cellId = begin; cellId < end; cellId++)
+      {
+      // Unknown cell types are skipped, as vtkCutter does.
+      int cellType = input->GetCellType(cellId);
+      if (cellType >= VTK_NUMBER_OF_CELL_TYPES ||
+          this->CellTypeDimensions[cellType] != this->Dimensionality)
+        {
+        continue;
+        }
+
+      //find min and max values in scalar data
+      input->GetCellPoints(cellId, ptIds);
+      vtkIdType numCellPts = ptIds->GetNumberOfIds();
+      if (numCellPts < 1)
+        {
+        continue;
+        }
+      range[0] = range[1] = scalars[ptIds->GetId(0)];
+      for (vtkIdType i = 1; i < numCellPts; i++)
+        {
+        double s = scalars[ptIds->GetId(i)];
+        if (s < range[0])
+          {
+          range[0] = s;
+          }
+        if (s > range[1])
+          {
+          range[1] = s;
+          }
+        }
+
+      bool needCell = false;
+      for (int i = 0; i < numValues && !needCell; i++)
+        {
+        needCell = values[i] >= range[0] && values[i] <= range[1];
+        }
+      if (!needCell)
+        {
+        continue;
+        }
+
+      input->GetCell(cellId, cell);
+      cellScalars->SetNumberOfTuples(cell->GetPointIds()->GetNumberOfIds());
+      this->CutScalars->GetTuples(cell->GetPointIds(), cellScalars);
+
+      for (int i = 0; i < numValues; i++)
+        {
+        if (values[i] >= range[0] && values[i] <= range[1])
+          {
+          vtkIdType begVertSize = verts->GetNumberOfConnectivityEntries();
+          vtkIdType begLineSize = lines->GetNumberOfConnectivityEntries();
+          vtkIdType begPolySize = polys->GetNumberOfConnectivityEntries();
+          helper->Contour(cell, values[i], cellScalars, cellId);
+          // Keep track of where the cells of each cut start, for
+          // vtkSMPMergePolyDataHelper to merge them in parallel.
+          if (verts->GetNumberOfConnectivityEntries() > begVertSize)
+            {
+            localData.VertOffsets->InsertNextId(begVertSize);
+            }
+          if (lines->GetNumberOfConnectivityEntries() > begLineSize)
+            {
+            localData.LineOffsets->InsertNextId(begLineSize);
+            }
+          if (polys->GetNumberOfConnectivityEntries() > begPolySize)
+            {
+            localData.PolyOffsets->InsertNextId(begPolySize);
+            }
+          }
+        }
+      }
+  }
+};
+
+}//end namespace
+
+//-----------------------------------------------------------------------------
+int vtkSMPCutter::RequestData(
+  vtkInformation *request,
+  vtkInformationVector **inputVector,
+  vtkInformationVector *outputVector)
+{
+  // get the input and output
+  vtkDataSet *input = vtkDataSet::GetData(inputVector[0]);
+  vtkPolyData *output = vtkPolyData::GetData(outputVector);
+
+  vtkPointSet *pointSet = NULL;
+  if (vtkUnstructuredGrid::SafeDownCast(input) ||
+      vtkPolyData::SafeDownCast(input))
+    {
+    pointSet = vtkPointSet::SafeDownCast(input);
+    }
+  if (!this->CutFunction || !pointSet || !pointSet->GetPoints())
+    {
+    return this->Superclass::RequestData(request, inputVector, outputVector);
+    }
+
+  if ( input->GetNumberOfPoints() < 1 || this->GetNumberOfContours() < 1 )
+    {
+    return 1;
+    }
+
+  vtkDebugMacro(<< "Executing SMP Cutter");
+  this->PointSetCutter(pointSet, output);
+
+  return 1;
+}
+
+//-----------------------------------------------------------------------------
+void vtkSMPCutter::PointSetCutter(vtkPointSet *input, vtkPolyData *output)
+{
+  vtkIdType numCells = input->GetNumberOfCells();
+  int numContours = this->ContourValues->GetNumberOfContours();
+  if (numCells < 1)
+    {
+    return;
+    }
+
+  vtkIdType estimatedSize = static_cast<vtkIdType>(
+    pow(static_cast<double>(numCells), .75)) * numContours;
+  estimatedSize = estimatedSize / 1024 * 1024; //multiple of 1024
+  if (estimatedSize < 1024)
+    {
+    estimatedSize = 1024;
+    }
+
+  // Evaluate the cut function at all the points, in parallel for the
+  // implicit functions that support it.
+  vtkNew<vtkDoubleArray> cutScalars;
+  this->CutFunction->FunctionValue(input->GetPoints()->GetData(),
+                                   cutScalars.GetPointer());
+
+  // Interpolate data along edge. If generating cut scalars, do necessary setup
+  vtkSmartPointer<vtkPointData> inPD = input->GetPointData();
+  if ( this->GenerateCutScalars )
+    {
+    inPD = vtkSmartPointer<vtkPointData>::New();
+    inPD->ShallowCopy(input->GetPointData());//copies original attributes
+    inPD->SetScalars(cutScalars.GetPointer());
+    }
+
+  // vtkPolyData builds its cells on first access. Not thread safe so
+  // build first.
+  input->GetCellType(0);
+
+  vtkCutterFunctor functor(this, input, inPD, cutScalars.GetPointer(),
+                           numContours, this->ContourValues->GetValues(),
+                           estimatedSize);
+  // We skip 0d cells (points), because they cannot be cut (generate no data).
+  for (int dimensionality = 1; dimensionality <= 3; ++dimensionality)
+    {
+    functor.Dimensionality = dimensionality;
+    vtkSMPTools::For(0, numCells, functor);
+    this->UpdateProgress(dimensionality / 3.0);
+    }
+
+  std::vector<vtkSMPMergePolyDataHelper::InputData> mpData;
+  vtkSMPThreadLocal<vtkLocalCutData>::iterator itr = functor.LocalData.begin();
+  vtkSMPThreadLocal<vtkLocalCutData>::iterator end = functor.LocalData.end();
+  while(itr != end)
+    {
+    if ((*itr).Output)
+      {
+      mpData.push_back(vtkSMPMergePolyDataHelper::InputData((*itr).Output,
+                                                            (*itr).Locator,
+                                                            (*itr).VertOffsets,
+                                                            (*itr).LineOffsets,
+                                                            (*itr).PolyOffsets));
+      }
+    ++itr;
+    }
+  if (mpData.empty())
+    {
+    return;
+    }
+
+  vtkPolyData* moutput = vtkSMPMergePolyDataHelper::MergePolyData(mpData);
+  output->ShallowCopy(moutput);
+  moutput->Delete();
+  output->Squeeze();
+}
+
+//-----------------------------------------------------------------------------
+void vtkSMPCutter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+}
@@ -0,0 +1,67 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPCutter.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkSMPCutter - a subclass of vtkCutter that cuts unstructured
+// grids and polydata in parallel
+// .SECTION Description
+// vtkSMPCutter performs the same function as vtkCutter, but cuts the cells
+// of vtkUnstructuredGrid and vtkPolyData inputs with multiple threads. The
+// cut function is evaluated at all the points first, then each thread cuts
+// chunks of cells by all the cut values into its own polydata, merging
+// points with its own vtkSMPMergePoints. The pieces are merged with
+// vtkSMPMergePolyDataHelper.
+//
+// Cells are cut by dimension, as with the default VTK_SORT_BY_VALUE, so
+// cell data stays ordered. The output cells are grouped by thread rather
+// than by cut value, so SortBy is ignored, as is the Locator. Other inputs
+// are cut by vtkCutter.
+
+// .SECTION See Also
+// vtkCutter vtkSMPContourGrid vtkSMPMergePolyDataHelper
+
+#ifndef vtkSMPCutter_h
+#define vtkSMPCutter_h
+
+#include "vtkFiltersSMPModule.h" // For export macro
+#include "vtkCutter.h"
+
+class vtkPointSet;
+
+class VTKFILTERSSMP_EXPORT vtkSMPCutter : public vtkCutter
+{
+public:
+  vtkTypeMacro(vtkSMPCutter,vtkCutter);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Construct with user-specified implicit function; initial value of 0.0; and
+  // generating cut scalars turned off.
+  static vtkSMPCutter *New();
+
+protected:
+  vtkSMPCutter(vtkImplicitFunction *cf=NULL);
+  ~vtkSMPCutter();
+
+  virtual int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *);
+
+  // Description:
+  // Cut a vtkUnstructuredGrid or a vtkPolyData in parallel.
+  void PointSetCutter(vtkPointSet *input, vtkPolyData *output);
+
+private:
+  vtkSMPCutter(const vtkSMPCutter&);  // Not implemented.
+  void operator=(const vtkSMPCutter&);  // Not implemented.
+};
+
+#endif
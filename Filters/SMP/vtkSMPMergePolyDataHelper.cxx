@@ -125,7 +125,7 @@ void MergePoints(std::vector<vtkMergePointsData>& data,
     }
 
   vtkParallelMergePoints mergePoints;
-  mergePoints.BucketIds = &nonEmptyBuckets[0];
+  mergePoints.BucketIds = nonEmptyBuckets.empty() ? 0 : &nonEmptyBuckets[0];
   mergePoints.Merger = (*begin).Locator;
   mergePoints.OutputPointData = (*begin).Output->GetPointData();
   if (!idMaps.empty())
@@ -220,17 +220,19 @@ class vtkParallelCellDataCopier
 public:
   vtkDataSetAttributes* InputCellData;
   vtkDataSetAttributes* OutputCellData;
+  vtkIdType InputOffset;
   vtkIdType Offset;
 
   void operator()(vtkIdType begin, vtkIdType end)
   {
     vtkDataSetAttributes* inputCellData = this->InputCellData;
     vtkDataSetAttributes* outputCellData = this->OutputCellData;
+    vtkIdType inputOffset = this->InputOffset;
     vtkIdType offset = this->Offset;
 
     for (vtkIdType i=begin; i<end; i++)
       {
-      outputCellData->SetTuple(offset + i, i, inputCellData);
+      outputCellData->SetTuple(offset + i, inputOffset + i, inputCellData);
       }
   }
 };
@@ -240,9 +242,14 @@ struct vtkMergeCellsData
   vtkPolyData* Output;
   vtkIdList* CellOffsets;
   vtkCellArray* OutCellArray;
-
-  vtkMergeCellsData(vtkPolyData* output, vtkIdList* celloffsets, vtkCellArray* cellarray) :
-    Output(output), CellOffsets(celloffsets), OutCellArray(cellarray)
+  // Id of the first cell of OutCellArray in the cell data of Output,
+  // after the cells of the lower dimensional cell arrays.
+  vtkIdType CellDataOffset;
+
+  vtkMergeCellsData(vtkPolyData* output, vtkIdList* celloffsets, vtkCellArray* cellarray,
+                    vtkIdType cellDataOffset) :
+    Output(output), CellOffsets(celloffsets), OutCellArray(cellarray),
+    CellDataOffset(cellDataOffset)
     {
     }
 };
@@ -251,7 +258,8 @@ void MergeCells(std::vector<vtkMergeCellsData>& data,
                 const std::vector<vtkIdList*>& idMaps,
                 vtkIdType numCells,
                 vtkIdType cellDataOffset,
-                vtkCellArray* outCells)
+                vtkCellArray* outCells,
+                vtkCellData* outCellData)
 {
   std::vector<vtkMergeCellsData>::iterator begin = data.begin();
   std::vector<vtkMergeCellsData>::iterator itr;
@@ -295,24 +303,25 @@ void MergeCells(std::vector<vtkMergeCellsData>& data,
   outCellsArray->SetNumberOfTuples(outCellsOffset);
   outCells->SetNumberOfCells(numCells);
 
-  outCellsOffset = cellDataOffset + (*begin).OutCellArray->GetNumberOfCells();
+  outCellsOffset = cellDataOffset;
 
   // Now copy cell data in parallel
   vtkParallelCellDataCopier cellCopier;
-  cellCopier.OutputCellData = (*begin).Output->GetCellData();
+  cellCopier.OutputCellData = outCellData;
   int numCellArrays = cellCopier.OutputCellData->GetNumberOfArrays();
   if (numCellArrays > 0)
     {
-    for (itr = second; itr != end; ++itr)
+    for (itr = begin; itr != end; ++itr)
       {
       cellCopier.InputCellData = (*itr).Output->GetCellData();
+      cellCopier.InputOffset = (*itr).CellDataOffset;
       cellCopier.Offset = outCellsOffset;
       vtkCellArray* cells = (*itr).OutCellArray;
 
       vtkSMPTools::For(0,  cells->GetNumberOfCells(), cellCopier);
       //cellCopier.operator()(0, polys->GetNumberOfCells());
 
-      outCellsOffset += (*itr).Output->GetPolys()->GetNumberOfCells();
+      outCellsOffset += cells->GetNumberOfCells();
       }
     }
 }
@@ -359,12 +368,25 @@ vtkPolyData* vtkSMPMergePolyDataHelper::MergePolyData(std::vector<InputData>& in
 
   vtkIdType numOutCells = numVerts + numLines + numPolys;
 
-  vtkCellData* outCellData = (*begin).Input->GetCellData();
+  // The cells of each input are ordered verts, lines then polys, and so
+  // is their cell data. The merged cell data is a new one because the
+  // cells of the first input move when others have lower dimensional cells.
+  vtkCellData* inCellData = (*begin).Input->GetCellData();
+  vtkNew<vtkCellData> outCellData;
+  outCellData->CopyStructure(inCellData);
+  int attributeIndices[vtkDataSetAttributes::NUM_ATTRIBUTES];
+  inCellData->GetAttributeIndices(attributeIndices);
+  for (int i=0; i<vtkDataSetAttributes::NUM_ATTRIBUTES; i++)
+    {
+    if (attributeIndices[i] >= 0)
+      {
+      outCellData->SetActiveAttribute(attributeIndices[i], i);
+      }
+    }
   int numCellArrays = outCellData->GetNumberOfArrays();
   for (int i=0; i<numCellArrays; i++)
     {
-    outCellData->GetArray(i)->Resize(numOutCells);
-    outCellData->GetArray(i)->SetNumberOfTuples(numOutCells);
+    outCellData->GetAbstractArray(i)->SetNumberOfTuples(numOutCells);
     }
 
   // Now merge each cell type. Because vtkPolyData stores each
@@ -378,10 +400,12 @@ vtkPolyData* vtkSMPMergePolyDataHelper::MergePolyData(std::vector<InputData>& in
     itr = begin;
     while(itr != end)
     {
-    mcData.push_back(vtkMergeCellsData((*itr).Input, (*itr).VertOffsets, (*itr).Input->GetVerts()));
+    mcData.push_back(vtkMergeCellsData((*itr).Input, (*itr).VertOffsets, (*itr).Input->GetVerts(),
+                                       0));
     ++itr;
     }
-    MergeCells(mcData, idMaps, numVerts, 0, outVerts.GetPointer());
+    MergeCells(mcData, idMaps, numVerts, 0, outVerts.GetPointer(),
+               outCellData.GetPointer());
 
     outPolyData->SetVerts(outVerts.GetPointer());
 
@@ -396,10 +420,12 @@ vtkPolyData* vtkSMPMergePolyDataHelper::MergePolyData(std::vector<InputData>& in
     itr = begin;
     while(itr != end)
     {
-    mcData.push_back(vtkMergeCellsData((*itr).Input, (*itr).LineOffsets, (*itr).Input->GetLines()));
+    mcData.push_back(vtkMergeCellsData((*itr).Input, (*itr).LineOffsets, (*itr).Input->GetLines(),
+                                       (*itr).Input->GetVerts()->GetNumberOfCells()));
     ++itr;
     }
-    MergeCells(mcData, idMaps, numLines, vertSize, outLines.GetPointer());
+    MergeCells(mcData, idMaps, numLines, numVerts, outLines.GetPointer(),
+               outCellData.GetPointer());
 
     outPolyData->SetLines(outLines.GetPointer());
 
@@ -414,15 +440,18 @@ vtkPolyData* vtkSMPMergePolyDataHelper::MergePolyData(std::vector<InputData>& in
     itr = begin;
     while(itr != end)
       {
-      mcData.push_back(vtkMergeCellsData((*itr).Input, (*itr).PolyOffsets, (*itr).Input->GetPolys()));
+      mcData.push_back(vtkMergeCellsData((*itr).Input, (*itr).PolyOffsets, (*itr).Input->GetPolys(),
+                                         (*itr).Input->GetVerts()->GetNumberOfCells() +
+                                         (*itr).Input->GetLines()->GetNumberOfCells()));
       ++itr;
       }
-    MergeCells(mcData, idMaps, numPolys, vertSize + lineSize, outPolys.GetPointer());
+    MergeCells(mcData, idMaps, numPolys, numVerts + numLines, outPolys.GetPointer(),
+               outCellData.GetPointer());
 
     outPolyData->SetPolys(outPolys.GetPointer());
     }
 
-  outPolyData->GetCellData()->ShallowCopy(outCellData);
+  outPolyData->GetCellData()->ShallowCopy(outCellData.GetPointer());
 
   std::vector<vtkIdList*>::iterator mapIter = idMaps.begin();
   while (mapIter != idMaps.end())
@@ -479,11 +479,8 @@ int vtkHyperTreeGridSource::RequestData( vtkInformation*,
     cursor->UnRegister( this );
     } // it
 
-  // Squeeze output data arrays
-  for ( int a = 0; a < outData->GetNumberOfArrays(); ++ a )
-    {
-    outData->GetArray( a )->Squeeze();
-    }
+  // Squeeze output data arrays and pack the trees
+  this->Output->Squeeze();
 
   assert( "post: dataset_and_data_size_match" && this->Output->CheckAttributes() == 0 );
 
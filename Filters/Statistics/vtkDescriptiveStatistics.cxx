@@ -33,6 +33,7 @@
 #include "vtkStringArray.h"
 #include "vtkStdString.h"
 #include "vtkTable.h"
+#include "vtkTableColumnBatch.h"
 #include "vtkVariantArray.h"
 
 #include <set>
@@ -219,6 +220,80 @@ void vtkDescriptiveStatistics::Aggregate( vtkDataObjectCollection* inMetaColl,
   aggregatedTab->Delete();
 }
 
+// ----------------------------------------------------------------------
+// Update the extrema and centered moments of a variable with a chunk of
+// its values.
+class vtkDescriptiveStatisticsMoments
+{
+public:
+  vtkIdType Cardinality;
+  double Minimum;
+  double Maximum;
+  double Mean;
+  double M2;
+  double M3;
+  double M4;
+
+  vtkDescriptiveStatisticsMoments()
+    : Cardinality( 0 ), Minimum( 0. ), Maximum( 0. ), Mean( 0. ),
+      M2( 0. ), M3( 0. ), M4( 0. )
+  {
+  }
+
+  template <class T>
+  void operator()( const T* values, const unsigned char*,
+                   vtkIdType, vtkIdType count )
+  {
+    if ( ! this->Cardinality && count )
+      {
+      this->Minimum = this->Maximum = static_cast<double>( values[0] );
+      }
+
+    double minVal = this->Minimum;
+    double maxVal = this->Maximum;
+    double mean = this->Mean;
+    double mom2 = this->M2;
+    double mom3 = this->M3;
+    double mom4 = this->M4;
+
+    double n, inv_n, val, delta, A, B;
+    double r = static_cast<double>( this->Cardinality );
+    for ( vtkIdType i = 0; i < count; ++ i, r += 1. )
+      {
+      n = r + 1.;
+      inv_n = 1. / n;
+
+      val = static_cast<double>( values[i] );
+      delta = val - mean;
+
+      A = delta * inv_n;
+      mean += A;
+      mom4 += A * ( A * A * delta * r * ( n * ( n - 3. ) + 3. ) + 6. * A * mom2 - 4. * mom3  );
+
+      B = val - mean;
+      mom3 += A * ( B * delta * ( n - 2. ) - 3. * mom2 );
+      mom2 += delta * B;
+
+      if ( val < minVal )
+        {
+        minVal = val;
+        }
+      else if ( val > maxVal )
+        {
+        maxVal = val;
+        }
+      }
+
+    this->Cardinality += count;
+    this->Minimum = minVal;
+    this->Maximum = maxVal;
+    this->Mean = mean;
+    this->M2 = mom2;
+    this->M3 = mom3;
+    this->M4 = mom4;
+  }
+};
+
 // ----------------------------------------------------------------------
 void vtkDescriptiveStatistics::Learn( vtkTable* inData,
                                       vtkTable* vtkNotUsed( inParameters ),
@@ -293,39 +368,9 @@ void vtkDescriptiveStatistics::Learn( vtkTable* inData,
       continue;
       }
 
-    double minVal = inData->GetValueByName( 0, varName ).ToDouble();
-    double maxVal = minVal;
-    double mean = 0.;
-    double mom2 = 0.;
-    double mom3 = 0.;
-    double mom4 = 0.;
-
-    double n, inv_n, val, delta, A, B;
-    for ( vtkIdType r = 0; r < nRow; ++ r )
-      {
-      n = r + 1.;
-      inv_n = 1. / n;
-
-      val = inData->GetValueByName( r, varName ).ToDouble();
-      delta = val - mean;
-
-      A = delta * inv_n;
-      mean += A;
-      mom4 += A * ( A * A * delta * r * ( n * ( n - 3. ) + 3. ) + 6. * A * mom2 - 4. * mom3  );
-
-      B = val - mean;
-      mom3 += A * ( B * delta * ( n - 2. ) - 3. * mom2 );
-      mom2 += delta * B;
-
-      if ( val < minVal )
-        {
-        minVal = val;
-        }
-      else if ( val > maxVal )
-        {
-        maxVal = val;
-        }
-      }
+    // Accumulate the column values chunk by chunk
+    vtkDescriptiveStatisticsMoments moments;
+    vtkTableColumnBatchForEach( inData->GetColumnByName( varName ), moments );
 
     vtkVariantArray* row = vtkVariantArray::New();
 
@@ -333,12 +378,12 @@ void vtkDescriptiveStatistics::Learn( vtkTable* inData,
 
     row->SetValue( 0, varName );
     row->SetValue( 1, nRow );
-    row->SetValue( 2, minVal );
-    row->SetValue( 3, maxVal );
-    row->SetValue( 4, mean );
-    row->SetValue( 5, mom2 );
-    row->SetValue( 6, mom3 );
-    row->SetValue( 7, mom4 );
+    row->SetValue( 2, moments.Minimum );
+    row->SetValue( 3, moments.Maximum );
+    row->SetValue( 4, moments.Mean );
+    row->SetValue( 5, moments.M2 );
+    row->SetValue( 6, moments.M3 );
+    row->SetValue( 7, moments.M4 );
 
     primaryTab->InsertNextRow( row );
 
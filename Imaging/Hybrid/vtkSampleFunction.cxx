@@ -25,6 +25,7 @@
 #include "vtkObjectFactory.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkPointData.h"
+#include "vtkSMPThreadLocalObject.h"
 #include "vtkSMPTools.h"
 
 vtkStandardNewMacro(vtkSampleFunction);
@@ -55,34 +56,50 @@ public:
   // Cap the boundaries with the specified cap value (if requested).
   void Cap();
 
-  // Interface implicit function computation to SMP tools.
+  // Interface implicit function computation to SMP tools. The points of
+  // each k-slice are gathered and handed to the implicit function in one
+  // batch, avoiding a virtual call (and transform) per sample.
   template <class TT> class FunctionValueOp
     {
     public:
       FunctionValueOp(vtkSampleFunctionAlgorithm<TT> *algo)
         { this->Algo = algo;}
       vtkSampleFunctionAlgorithm *Algo;
+      vtkSMPThreadLocalObject<vtkDoubleArray> Points;
+      vtkSMPThreadLocalObject<vtkDoubleArray> Values;
 
       void  operator() (vtkIdType k, vtkIdType end)
         {
-        double x[3];
+        double *x, y, z;
+        const double *v;
         vtkIdType *extent=this->Algo->Extent;
-        vtkIdType i, j, jOffset, kOffset;
+        vtkIdType i, j, idx;
+        vtkDoubleArray *points = this->Points.Local();
+        vtkDoubleArray *values = this->Values.Local();
+        points->SetNumberOfComponents(3);
+        points->SetNumberOfTuples(this->Algo->SliceSize);
         for ( ; k < end; ++k)
           {
-          x[2] = this->Algo->Origin[2] + k*this->Algo->Spacing[2];
-          kOffset = (k-extent[4]) * this->Algo->SliceSize;
+          x = points->GetPointer(0);
+          z = this->Algo->Origin[2] + k*this->Algo->Spacing[2];
           for (j=extent[2]; j<=extent[3]; ++j)
             {
-            x[1] = this->Algo->Origin[1] + j*this->Algo->Spacing[1];
-            jOffset = (j-extent[2])*this->Algo->Dims[0];
+            y = this->Algo->Origin[1] + j*this->Algo->Spacing[1];
             for (i=extent[0]; i<=extent[1]; ++i)
               {
-              x[0] = this->Algo->Origin[0] + i*this->Algo->Spacing[0];
-              this->Algo->Scalars[(i-extent[0])+jOffset+kOffset] =
-                static_cast<TT>(this->Algo->ImplicitFunction->FunctionValue(x));
+              *x++ = this->Algo->Origin[0] + i*this->Algo->Spacing[0];
+              *x++ = y;
+              *x++ = z;
               }
             }
+          this->Algo->ImplicitFunction->FunctionValue(points, values);
+          v = values->GetPointer(0);
+          TT *scalars = this->Algo->Scalars +
+            (k-extent[4]) * this->Algo->SliceSize;
+          for (idx=0; idx < this->Algo->SliceSize; ++idx)
+            {
+            scalars[idx] = static_cast<TT>(v[idx]);
+            }
           }
         }
     };
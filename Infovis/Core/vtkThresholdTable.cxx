@@ -20,14 +20,14 @@
 
 #include "vtkThresholdTable.h"
 
-#include "vtkArrayIteratorIncludes.h"
+#include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
-#include "vtkStringArray.h"
 #include "vtkTable.h"
+#include "vtkTableColumnBatch.h"
 #include "vtkVariant.h"
-#include "vtkVariantArray.h"
 
 vtkStandardNewMacro(vtkThresholdTable);
 
@@ -66,42 +66,61 @@ void vtkThresholdTable::PrintSelf(ostream& os, vtkIndent indent)
   os << endl;
 }
 
-static bool vtkThresholdTableCompare(vtkVariant a, vtkVariant b)
+// Collect the rows whose value passes the threshold, one chunk of the
+// column at a time.
+class vtkThresholdTableAcceptRows
 {
-  return a.ToDouble() <= b.ToDouble();
-}
-
-template <typename iterT>
-void vtkThresholdTableThresholdRows(iterT* it, vtkTable* input, vtkTable* output, vtkVariant min, vtkVariant max, int mode)
-{
-  vtkIdType maxInd = it->GetNumberOfValues();
-  for (vtkIdType i = 0; i < maxInd; i++)
-    {
-    bool accept = false;
-    vtkVariant v(it->GetValue(i));
-    if (mode == vtkThresholdTable::ACCEPT_LESS_THAN)
-      {
-      accept = vtkThresholdTableCompare(v, max);
-      }
-    else if (mode == vtkThresholdTable::ACCEPT_GREATER_THAN)
-      {
-      accept = vtkThresholdTableCompare(min, v);
-      }
-    else if (mode == vtkThresholdTable::ACCEPT_BETWEEN)
+public:
+  double Min;
+  double Max;
+  int Mode;
+  vtkIdList* Rows;
+
+  template <class T>
+  void operator()(const T* values, const unsigned char*,
+                  vtkIdType first, vtkIdType count)
+  {
+    vtkIdType* accepted = this->Rows->WritePointer(
+      this->Rows->GetNumberOfIds(), count);
+    vtkIdType numAccepted = 0;
+    switch (this->Mode)
       {
-      accept = (vtkThresholdTableCompare(min, v) && vtkThresholdTableCompare(v, max));
+      case vtkThresholdTable::ACCEPT_LESS_THAN:
+        for (vtkIdType i = 0; i < count; ++i)
+          {
+          accepted[numAccepted] = first + i;
+          numAccepted += static_cast<double>(values[i]) <= this->Max;
+          }
+        break;
+      case vtkThresholdTable::ACCEPT_GREATER_THAN:
+        for (vtkIdType i = 0; i < count; ++i)
+          {
+          accepted[numAccepted] = first + i;
+          numAccepted += this->Min <= static_cast<double>(values[i]);
+          }
+        break;
+      case vtkThresholdTable::ACCEPT_BETWEEN:
+        for (vtkIdType i = 0; i < count; ++i)
+          {
+          double v = static_cast<double>(values[i]);
+          accepted[numAccepted] = first + i;
+          numAccepted += (this->Min <= v && v <= this->Max);
+          }
+        break;
+      case vtkThresholdTable::ACCEPT_OUTSIDE:
+        for (vtkIdType i = 0; i < count; ++i)
+          {
+          double v = static_cast<double>(values[i]);
+          accepted[numAccepted] = first + i;
+          numAccepted += (v <= this->Min || this->Max <= v);
+          }
+        break;
       }
-    else if (mode == vtkThresholdTable::ACCEPT_OUTSIDE)
-      {
-      accept = (vtkThresholdTableCompare(v, min) || vtkThresholdTableCompare(max, v));
-      }
-    if (accept)
-      {
-      vtkVariantArray* row = input->GetRow(i);
-      output->InsertNextRow(row);
-      }
-    }
-}
+    // Drop the unused end of the chunk.
+    this->Rows->SetNumberOfIds(this->Rows->GetNumberOfIds() - count +
+                               numAccepted);
+  }
+};
 
 void vtkThresholdTable::ThresholdBetween(vtkVariant lower, vtkVariant upper)
 {
@@ -140,14 +159,22 @@ int vtkThresholdTable::RequestData(
     ncol->Delete();
     }
 
-  vtkArrayIterator* iter = arr->NewIterator();
-  switch (arr->GetDataType())
+  // Find the accepted rows, then copy them column by column.
+  vtkNew<vtkIdList> rows;
+  rows->Allocate(arr->GetNumberOfTuples());
+  vtkThresholdTableAcceptRows accept;
+  accept.Min = this->MinValue.ToDouble();
+  accept.Max = this->MaxValue.ToDouble();
+  accept.Mode = this->Mode;
+  accept.Rows = rows.GetPointer();
+  vtkTableColumnBatchForEach(arr, accept);
+
+  for (int n = 0; n < input->GetNumberOfColumns(); n++)
     {
-    vtkArrayIteratorTemplateMacro(
-      vtkThresholdTableThresholdRows(static_cast<VTK_TT*>(iter), input, output,
-        this->MinValue, this->MaxValue, this->Mode));
+    vtkAbstractArray* ncol = output->GetColumn(n);
+    ncol->SetNumberOfTuples(rows->GetNumberOfIds());
+    input->GetColumn(n)->GetTuples(rows.GetPointer(), ncol);
     }
-  iter->Delete();
 
   return 1;
 }